@@ -8,6 +8,7 @@
 #include "crypto_p.h"
 #include "cryptorequestprocessor_p.h"
 #include "controller_p.h"
+#include "SecretsImpl/secrets_p.h"
 #include "logging_p.h"
 
 #include "Crypto/serialization_p.h"
@@ -20,6 +21,7 @@
 #include <QtCore/QString>
 #include <QtCore/QVector>
 #include <QtCore/QByteArray>
+#include <QtCore/QThread>
 
 #define MAP_PLUGIN_NAMES(variable) ::mapPluginNames(m_requestQueue->controller(), variable)
 
@@ -49,6 +51,17 @@ namespace {
         return retn;
     }
 
+    QVector<Sailfish::Crypto::Key> mapPluginNames(
+            Sailfish::Secrets::Daemon::Controller *controller,
+            const QVector<Sailfish::Crypto::Key> &keys) {
+        QVector<Sailfish::Crypto::Key> retn;
+        retn.reserve(keys.size());
+        for (const Sailfish::Crypto::Key &key : keys) {
+            retn.append(mapPluginNames(controller, key));
+        }
+        return retn;
+    }
+
     QString mapPluginNames(
             Sailfish::Secrets::Daemon::Controller *controller,
             const QString &pluginName) {
@@ -82,6 +95,20 @@ void Daemon::ApiImpl::CryptoDBusObject::getPluginInfo(
                                   result);
 }
 
+void Daemon::ApiImpl::CryptoDBusObject::getStatistics(
+        const QDBusMessage &message,
+        Result &result,
+        QVariantMap &statistics)
+{
+    Q_UNUSED(statistics);   // outparam, set in handlePendingRequest / handleFinishedRequest
+    QList<QVariant> inParams;
+    m_requestQueue->handleRequest(Daemon::ApiImpl::GetStatisticsRequest,
+                                  inParams,
+                                  connection(),
+                                  message,
+                                  result);
+}
+
 void Daemon::ApiImpl::CryptoDBusObject::generateRandomData(
         quint64 numberBytes,
         const QString &csprngEngineName,
@@ -449,6 +476,106 @@ void Daemon::ApiImpl::CryptoDBusObject::decrypt(
                                   result);
 }
 
+void Daemon::ApiImpl::CryptoDBusObject::encryptBatch(
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Key &key,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName,
+        const QDBusMessage &message,
+        Result &result,
+        QVector<QByteArray> &encrypted,
+        QVector<QByteArray> &authenticationTags)
+{
+    // outparams, set in handlePendingRequest / handleFinishedRequest
+    Q_UNUSED(encrypted);
+    Q_UNUSED(authenticationTags);
+
+    QList<QVariant> inParams;
+    inParams << QVariant::fromValue<QVector<QByteArray> >(data);
+    inParams << QVariant::fromValue<QVector<QByteArray> >(ivs);
+    inParams << QVariant::fromValue<Key>(MAP_PLUGIN_NAMES(key));
+    inParams << QVariant::fromValue<CryptoManager::BlockMode>(blockMode);
+    inParams << QVariant::fromValue<CryptoManager::EncryptionPadding>(padding);
+    inParams << QVariant::fromValue<QVector<QByteArray> >(authenticationData);
+    inParams << QVariant::fromValue<QVariantMap>(customParameters);
+    inParams << QVariant::fromValue<QString>(MAP_PLUGIN_NAMES(cryptosystemProviderName));
+    m_requestQueue->handleRequest(Daemon::ApiImpl::EncryptBatchRequest,
+                                  inParams,
+                                  connection(),
+                                  message,
+                                  result);
+}
+
+void Daemon::ApiImpl::CryptoDBusObject::decryptBatch(
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Key &key,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVector<QByteArray> &authenticationTags,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName,
+        const QDBusMessage &message,
+        Result &result,
+        QVector<QByteArray> &decrypted,
+        QVector<CryptoManager::VerificationStatus> &verificationStatuses)
+{
+    // outparams, set in handlePendingRequest / handleFinishedRequest
+    Q_UNUSED(decrypted);
+    Q_UNUSED(verificationStatuses);
+
+    QList<QVariant> inParams;
+    inParams << QVariant::fromValue<QVector<QByteArray> >(data);
+    inParams << QVariant::fromValue<QVector<QByteArray> >(ivs);
+    inParams << QVariant::fromValue<Key>(MAP_PLUGIN_NAMES(key));
+    inParams << QVariant::fromValue<CryptoManager::BlockMode>(blockMode);
+    inParams << QVariant::fromValue<CryptoManager::EncryptionPadding>(padding);
+    inParams << QVariant::fromValue<QVector<QByteArray> >(authenticationData);
+    inParams << QVariant::fromValue<QVector<QByteArray> >(authenticationTags);
+    inParams << QVariant::fromValue<QVariantMap>(customParameters);
+    inParams << QVariant::fromValue<QString>(MAP_PLUGIN_NAMES(cryptosystemProviderName));
+    m_requestQueue->handleRequest(Daemon::ApiImpl::DecryptBatchRequest,
+                                  inParams,
+                                  connection(),
+                                  message,
+                                  result);
+}
+
+void Daemon::ApiImpl::CryptoDBusObject::verifyBatch(
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Key> &keys,
+        CryptoManager::SignaturePadding padding,
+        CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName,
+        const QDBusMessage &message,
+        Result &result,
+        QVector<CryptoManager::VerificationStatus> &verificationStatuses)
+{
+    // outparams, set in handlePendingRequest / handleFinishedRequest
+    Q_UNUSED(verificationStatuses);
+
+    QList<QVariant> inParams;
+    inParams << QVariant::fromValue<QVector<QByteArray> >(signatures);
+    inParams << QVariant::fromValue<QVector<QByteArray> >(data);
+    inParams << QVariant::fromValue<QVector<Key> >(MAP_PLUGIN_NAMES(keys));
+    inParams << QVariant::fromValue<CryptoManager::SignaturePadding>(padding);
+    inParams << QVariant::fromValue<CryptoManager::DigestFunction>(digestFunction);
+    inParams << QVariant::fromValue<QVariantMap>(customParameters);
+    inParams << QVariant::fromValue<QString>(MAP_PLUGIN_NAMES(cryptosystemProviderName));
+    m_requestQueue->handleRequest(Daemon::ApiImpl::VerifyBatchRequest,
+                                  inParams,
+                                  connection(),
+                                  message,
+                                  result);
+}
+
 void Daemon::ApiImpl::CryptoDBusObject::initializeCipherSession(
         const QByteArray &initializationVector,
         const Sailfish::Crypto::Key &key,
@@ -619,6 +746,31 @@ void Daemon::ApiImpl::CryptoDBusObject::forgetLockCode(
                                   result);
 }
 
+void Daemon::ApiImpl::CryptoDBusObject::cancelRequest(
+        quint64 sequence,
+        const QString &method)
+{
+    // cancellation is not itself a request, so it is not queued.
+    m_requestQueue->cancelRequest(connection(), sequence, method);
+}
+
+void Daemon::ApiImpl::CryptoDBusObject::setNextRequestTimeout(int timeout)
+{
+    // the deadline is carried by the request which follows on the connection.
+    m_requestQueue->setNextRequestTimeout(connection(), timeout);
+}
+
+void Daemon::ApiImpl::CryptoDBusObject::setNextRequestPipeline(quint64 pipelineId)
+{
+    // like cancellation, this is not itself a request, so it is not queued.
+    m_requestQueue->setNextRequestPipeline(connection(), pipelineId);
+}
+
+void Daemon::ApiImpl::CryptoDBusObject::endPipeline(quint64 pipelineId)
+{
+    m_requestQueue->endPipeline(connection(), pipelineId);
+}
+
 //-----------------------------------
 
 Daemon::ApiImpl::CryptoRequestQueue::CryptoRequestQueue(
@@ -640,7 +792,31 @@ Daemon::ApiImpl::CryptoRequestQueue::CryptoRequestQueue(
     m_cryptoThreadPool->setExpiryTimeout(-1);
     m_requestProcessor = new Daemon::ApiImpl::RequestProcessor(secrets, autotestMode, this);
 
-    setDBusObject(new Daemon::ApiImpl::CryptoDBusObject(this));
+    // Each plugin performs its operations in order, on a thread of its own.
+    // Plugins which declare themselves to be thread-safe also perform the
+    // operations which do not depend on their state concurrently, in a
+    // separate pool, and so alongside the operations in the serial pool
+    // (see PluginBase::maxConcurrency()).
+    const QMap<QString, Sailfish::Crypto::CryptoPlugin*> cryptoPlugins = m_requestProcessor->plugins();
+    for (QMap<QString, Sailfish::Crypto::CryptoPlugin*>::const_iterator it = cryptoPlugins.constBegin();
+            it != cryptoPlugins.constEnd(); ++it) {
+        QSharedPointer<QThreadPool> pool = QSharedPointer<QThreadPool>::create();
+        pool->setMaxThreadCount(1);
+        pool->setExpiryTimeout(-1);
+        m_pluginThreadPools.insert(it.key(), pool);
+
+        const int maxConcurrency = qMin(it.value()->maxConcurrency(), QThread::idealThreadCount());
+        if (maxConcurrency > 1) {
+            QSharedPointer<QThreadPool> concurrentPool = QSharedPointer<QThreadPool>::create();
+            concurrentPool->setMaxThreadCount(maxConcurrency);
+            m_concurrentPluginThreadPools.insert(it.key(), concurrentPool);
+        }
+    }
+
+    Daemon::ApiImpl::CryptoDBusObject *dbusObject = new Daemon::ApiImpl::CryptoDBusObject(this);
+    connect(parent, &Sailfish::Secrets::Daemon::Controller::pluginInfoChanged,
+            dbusObject, &Daemon::ApiImpl::CryptoDBusObject::pluginInfoChanged);
+    setDBusObject(dbusObject);
     qCDebug(lcSailfishCryptoDaemon) << "Crypto: initialization succeeded, awaiting client connections.";
 }
 
@@ -659,37 +835,56 @@ QWeakPointer<QThreadPool> Daemon::ApiImpl::CryptoRequestQueue::cryptoThreadPool(
     return m_cryptoThreadPool.toWeakRef();
 }
 
+QWeakPointer<QThreadPool> Daemon::ApiImpl::CryptoRequestQueue::pluginThreadPool(
+        const QString &pluginName,
+        bool concurrent)
+{
+    if (concurrent) {
+        QHash<QString, QSharedPointer<QThreadPool> >::const_iterator it = m_concurrentPluginThreadPools.constFind(pluginName);
+        if (it != m_concurrentPluginThreadPools.constEnd()) {
+            return it->toWeakRef();
+        }
+    }
+
+    QHash<QString, QSharedPointer<QThreadPool> >::const_iterator it = m_pluginThreadPools.constFind(pluginName);
+    return it != m_pluginThreadPools.constEnd() ? it->toWeakRef() : m_cryptoThreadPool.toWeakRef();
+}
+
 QMap<QString, Sailfish::Crypto::CryptoPlugin*>
 Daemon::ApiImpl::CryptoRequestQueue::plugins() const
 {
     return m_requestProcessor->plugins();
 }
 
-LockCodeRequest::LockStatus Daemon::ApiImpl::CryptoRequestQueue::queryLockStatusPlugin(
-        const QString &pluginName)
+void Daemon::ApiImpl::CryptoRequestQueue::queryLockStatusPlugin(
+        const QString &pluginName,
+        const std::function<void (LockCodeRequest::LockStatus)> &completion)
 {
-    return m_requestProcessor->queryLockStatusPlugin(pluginName);
+    m_requestProcessor->queryLockStatusPlugin(pluginName, completion);
 }
 
-bool Daemon::ApiImpl::CryptoRequestQueue::lockPlugin(
-        const QString &pluginName)
+void Daemon::ApiImpl::CryptoRequestQueue::lockPlugin(
+        const QString &pluginName,
+        const std::function<void (bool)> &completion)
 {
-    return m_requestProcessor->lockPlugin(pluginName);
+    m_requestProcessor->lockPlugin(pluginName, completion);
 }
 
-bool Daemon::ApiImpl::CryptoRequestQueue::unlockPlugin(
+void Daemon::ApiImpl::CryptoRequestQueue::unlockPlugin(
         const QString &pluginName,
-        const QByteArray &lockCode)
+        const QByteArray &lockCode,
+        const std::function<void (bool)> &completion)
 {
-    return m_requestProcessor->unlockPlugin(pluginName, lockCode);
+    m_requestProcessor->unlockPlugin(pluginName, lockCode, completion);
 }
 
-bool Daemon::ApiImpl::CryptoRequestQueue::setLockCodePlugin(
+void Daemon::ApiImpl::CryptoRequestQueue::setLockCodePlugin(
         const QString &pluginName,
         const QByteArray &oldCode,
-        const QByteArray &newCode)
+        const QByteArray &newCode,
+        const std::function<void (bool)> &completion)
 {
-    return m_requestProcessor->setLockCodePlugin(pluginName, oldCode, newCode);
+    m_requestProcessor->setLockCodePlugin(pluginName, oldCode, newCode, completion);
 }
 
 QString Daemon::ApiImpl::CryptoRequestQueue::requestTypeToString(int type) const
@@ -712,6 +907,9 @@ QString Daemon::ApiImpl::CryptoRequestQueue::requestTypeToString(int type) const
         case VerifyRequest:                    return QLatin1String("VerifyRequest");
         case EncryptRequest:                   return QLatin1String("EncryptRequest");
         case DecryptRequest:                   return QLatin1String("DecryptRequest");
+        case EncryptBatchRequest:              return QLatin1String("EncryptBatchRequest");
+        case DecryptBatchRequest:              return QLatin1String("DecryptBatchRequest");
+        case VerifyBatchRequest:               return QLatin1String("VerifyBatchRequest");
         case InitializeCipherSessionRequest:   return QLatin1String("InitializeCipherSessionRequest");
         case UpdateCipherSessionAuthenticationRequest: return QLatin1String("UpdateCipherSessionAuthenticationRequest");
         case UpdateCipherSessionRequest:       return QLatin1String("UpdateCipherSessionRequest");
@@ -720,11 +918,125 @@ QString Daemon::ApiImpl::CryptoRequestQueue::requestTypeToString(int type) const
         case ModifyLockCodeRequest:            return QLatin1String("ModifyLockCodeRequest");
         case ProvideLockCodeRequest:           return QLatin1String("ProvideLockCodeRequest");
         case ForgetLockCodeRequest:            return QLatin1String("ForgetLockCodeRequest");
+        case GetStatisticsRequest:             return QLatin1String("GetStatisticsRequest");
         default: break;
     }
     return QLatin1String("Unknown Crypto Request!");
 }
 
+Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestPriority
+Daemon::ApiImpl::CryptoRequestQueue::requestPriority(int type) const
+{
+    switch (type) {
+        // requests which a user is (typically) waiting on,
+        // or which continue an operation which is already in progress.
+        case QueryLockStatusRequest:
+        case ProvideLockCodeRequest:
+        case GetStatisticsRequest:
+        case UpdateCipherSessionAuthenticationRequest:
+        case UpdateCipherSessionRequest:
+        case FinalizeCipherSessionRequest:
+            return Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::InteractivePriority;
+        // requests which are expensive to perform.
+        case GenerateKeyRequest:
+        case GenerateStoredKeyRequest:
+        case ImportKeyRequest:
+        case ImportStoredKeyRequest:
+        case SeedRandomDataGeneratorRequest:
+            return Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::BulkPriority;
+        default: break;
+    }
+    return Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::NormalPriority;
+}
+
+qint64 Daemon::ApiImpl::CryptoRequestQueue::parameterSize(const QVariant &parameter) const
+{
+    if (parameter.userType() == qMetaTypeId<Key>()) {
+        const Key key = parameter.value<Key>();
+        return key.secretKey().size() + key.privateKey().size() + key.publicKey().size();
+    }
+    if (parameter.userType() == qMetaTypeId<QVector<Key> >()) {
+        qint64 size = 0;
+        for (const Key &key : parameter.value<QVector<Key> >()) {
+            size += key.secretKey().size() + key.privateKey().size() + key.publicKey().size();
+        }
+        return size;
+    }
+    if (parameter.userType() == qMetaTypeId<QVector<QByteArray> >()) {
+        qint64 size = 0;
+        for (const QByteArray &data : parameter.value<QVector<QByteArray> >()) {
+            size += data.size();
+        }
+        return size;
+    }
+    return Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::parameterSize(parameter);
+}
+
+QVariant Daemon::ApiImpl::CryptoRequestQueue::timedOutResult() const
+{
+    return QVariant::fromValue<Result>(Result(Result::RequestTimedOutError,
+                                              QLatin1String("The request could not be performed before its deadline")));
+}
+
+QVariant Daemon::ApiImpl::CryptoRequestQueue::pipelineAbortedResult() const
+{
+    return QVariant::fromValue<Result>(Result(Result::PipelineAbortedError,
+                                              QLatin1String("A previous request of the pipeline failed")));
+}
+
+bool Daemon::ApiImpl::CryptoRequestQueue::isFailureResult(const QVariant &result) const
+{
+    return result.value<Result>().code() == Result::Failed;
+}
+
+QString Daemon::ApiImpl::CryptoRequestQueue::requestPluginName(int type, const QVariantList &inParams) const
+{
+    // requests which operate on a stored key are performed by its storage plugin.
+    const QVariant first = inParams.value(0);
+    if (first.userType() == qMetaTypeId<Key::Identifier>()) {
+        return first.value<Key::Identifier>().storagePluginName();
+    }
+
+    switch (type) {
+        case StoredKeyIdentifiersRequest:
+            return inParams.value(0).toString();
+        case QueryLockStatusRequest:
+        case ModifyLockCodeRequest:
+        case ProvideLockCodeRequest:
+        case ForgetLockCodeRequest:
+            return inParams.value(1).toString();
+        default: break;
+    }
+
+    // other requests are performed by the cryptosystem provider,
+    // whose name is the last string parameter of the request.
+    for (int i = inParams.size() - 1; i >= 0; --i) {
+        if (inParams.at(i).userType() == QMetaType::QString) {
+            return inParams.at(i).toString();
+        }
+    }
+    return QString();
+}
+
+void Daemon::ApiImpl::CryptoRequestQueue::clientConnected(pid_t pid)
+{
+    // the application ids of clients are resolved by the secrets API.
+    m_controller->secrets()->rememberApplication(pid);
+}
+
+void Daemon::ApiImpl::CryptoRequestQueue::clientDisconnected(pid_t pid)
+{
+    m_controller->secrets()->forgetApplication(pid);
+}
+
+void Daemon::ApiImpl::CryptoRequestQueue::resultReplied(const QVariant &result)
+{
+    // a plugin was found to be locked, which the reported state may not reflect.
+    if (result.value<Result>().errorCode() == Result::CryptoPluginIsLockedError) {
+        m_controller->invalidatePluginStates();
+    }
+}
+
 void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
         Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestData *request,
         bool *completed)
@@ -744,13 +1056,20 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QVector<PluginInfo> >(cryptoPlugins)
-                                                                        << QVariant::fromValue<QVector<PluginInfo> >(storagePlugins));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<PluginInfo> >(cryptoPlugins)
+                                                                  << QVariant::fromValue<QVector<PluginInfo> >(storagePlugins));
                 *completed = true;
             }
             break;
         }
+        case GetStatisticsRequest: {
+            qCDebug(lcSailfishCryptoDaemon) << "Handling GetStatisticsRequest from client:" << request->remotePid << ", request number:" << request->requestId;
+            sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(Result(Result::Succeeded))
+                                                              << QVariant::fromValue<QVariantMap>(statistics()));
+            *completed = true;
+            break;
+        }
         case GenerateRandomDataRequest: {
             qCDebug(lcSailfishCryptoDaemon) << "Handling GenerateRandomDataRequest from client:" << request->remotePid << ", request number:" << request->requestId;
             QByteArray randomData;
@@ -771,8 +1090,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(randomData));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(randomData));
                 *completed = true;
             }
             break;
@@ -797,7 +1116,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -825,8 +1144,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(generatedIV));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(generatedIV));
                 *completed = true;
             }
             break;
@@ -863,8 +1182,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(key));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(key));
                 *completed = true;
             }
             break;
@@ -905,8 +1224,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(key));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(key));
                 *completed = true;
             }
             break;
@@ -940,8 +1259,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(importedKey));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(importedKey));
                 *completed = true;
             }
             break;
@@ -978,8 +1297,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(importedKey));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(importedKey));
                 *completed = true;
             }
             break;
@@ -1008,8 +1327,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(key));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(key));
                 *completed = true;
             }
             break;
@@ -1028,7 +1347,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1057,8 +1376,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QVector<Key::Identifier> >(identifiers));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<Key::Identifier> >(identifiers));
                 *completed = true;
             }
             break;
@@ -1085,8 +1404,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(digest));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(digest));
                 *completed = true;
             }
             break;
@@ -1115,8 +1434,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(signature));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(signature));
                 *completed = true;
             }
             break;
@@ -1147,8 +1466,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<int>(verificationStatus));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<int>(verificationStatus));
                 *completed = true;
             }
             break;
@@ -1183,9 +1502,9 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(encrypted)
-                                                                        << QVariant::fromValue<QByteArray>(authenticationTag));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(encrypted)
+                                                                  << QVariant::fromValue<QByteArray>(authenticationTag));
                 *completed = true;
             }
             break;
@@ -1222,9 +1541,117 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(decrypted)
-                                                                        << QVariant::fromValue<int>(verificationStatus));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(decrypted)
+                                                                  << QVariant::fromValue<int>(verificationStatus));
+                *completed = true;
+            }
+            break;
+        }
+        case EncryptBatchRequest: {
+            qCDebug(lcSailfishCryptoDaemon) << "Handling EncryptBatchRequest from client:" << request->remotePid << ", request number:" << request->requestId;
+            QVector<QByteArray> encrypted;
+            QVector<QByteArray> authenticationTags;
+            QVector<QByteArray> data = request->inParams.size() ? request->inParams.takeFirst().value<QVector<QByteArray> >() : QVector<QByteArray>();
+            QVector<QByteArray> ivs = request->inParams.size() ? request->inParams.takeFirst().value<QVector<QByteArray> >() : QVector<QByteArray>();
+            Key key = request->inParams.size() ? request->inParams.takeFirst().value<Key>() : Key();
+            CryptoManager::BlockMode blockMode = request->inParams.size() ? request->inParams.takeFirst().value<CryptoManager::BlockMode>() : CryptoManager::BlockModeUnknown;
+            CryptoManager::EncryptionPadding padding = request->inParams.size() ? request->inParams.takeFirst().value<CryptoManager::EncryptionPadding>() : CryptoManager::EncryptionPaddingUnknown;
+            QVector<QByteArray> authenticationData = request->inParams.size() ? request->inParams.takeFirst().value<QVector<QByteArray> >() : QVector<QByteArray>();
+            QVariantMap customParameters = request->inParams.size() ? request->inParams.takeFirst().value<QVariantMap>() : QVariantMap();
+            QString cryptosystemProviderName = request->inParams.size() ? request->inParams.takeFirst().value<QString>() : QString();
+            Result result = m_requestProcessor->encryptBatch(
+                          request->remotePid,
+                          request->requestId,
+                          data,
+                          ivs,
+                          key,
+                          blockMode,
+                          padding,
+                          authenticationData,
+                          customParameters,
+                          cryptosystemProviderName,
+                          &encrypted,
+                          &authenticationTags);
+            // send the reply to the calling peer.
+            if (result.code() == Result::Pending) {
+                // waiting for asynchronous flow to complete
+                *completed = false;
+            } else {
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<QByteArray> >(encrypted)
+                                                                  << QVariant::fromValue<QVector<QByteArray> >(authenticationTags));
+                *completed = true;
+            }
+            break;
+        }
+        case DecryptBatchRequest: {
+            qCDebug(lcSailfishCryptoDaemon) << "Handling DecryptBatchRequest from client:" << request->remotePid << ", request number:" << request->requestId;
+            QVector<QByteArray> decrypted;
+            QVector<CryptoManager::VerificationStatus> verificationStatuses;
+            QVector<QByteArray> data = request->inParams.size() ? request->inParams.takeFirst().value<QVector<QByteArray> >() : QVector<QByteArray>();
+            QVector<QByteArray> ivs = request->inParams.size() ? request->inParams.takeFirst().value<QVector<QByteArray> >() : QVector<QByteArray>();
+            Key key = request->inParams.size() ? request->inParams.takeFirst().value<Key>() : Key();
+            CryptoManager::BlockMode blockMode = request->inParams.size() ? request->inParams.takeFirst().value<CryptoManager::BlockMode>() : CryptoManager::BlockModeUnknown;
+            CryptoManager::EncryptionPadding padding = request->inParams.size() ? request->inParams.takeFirst().value<CryptoManager::EncryptionPadding>() : CryptoManager::EncryptionPaddingUnknown;
+            QVector<QByteArray> authenticationData = request->inParams.size() ? request->inParams.takeFirst().value<QVector<QByteArray> >() : QVector<QByteArray>();
+            QVector<QByteArray> authenticationTags = request->inParams.size() ? request->inParams.takeFirst().value<QVector<QByteArray> >() : QVector<QByteArray>();
+            QVariantMap customParameters = request->inParams.size() ? request->inParams.takeFirst().value<QVariantMap>() : QVariantMap();
+            QString cryptosystemProviderName = request->inParams.size() ? request->inParams.takeFirst().value<QString>() : QString();
+            Result result = m_requestProcessor->decryptBatch(
+                        request->remotePid,
+                        request->requestId,
+                        data,
+                        ivs,
+                        key,
+                        blockMode,
+                        padding,
+                        authenticationData,
+                        authenticationTags,
+                        customParameters,
+                        cryptosystemProviderName,
+                        &decrypted,
+                        &verificationStatuses);
+            // send the reply to the calling peer.
+            if (result.code() == Result::Pending) {
+                // waiting for asynchronous flow to complete
+                *completed = false;
+            } else {
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<QByteArray> >(decrypted)
+                                                                  << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(verificationStatuses));
+                *completed = true;
+            }
+            break;
+        }
+        case VerifyBatchRequest: {
+            qCDebug(lcSailfishCryptoDaemon) << "Handling VerifyBatchRequest from client:" << request->remotePid << ", request number:" << request->requestId;
+            QVector<CryptoManager::VerificationStatus> verificationStatuses;
+            QVector<QByteArray> signatures = request->inParams.size() ? request->inParams.takeFirst().value<QVector<QByteArray> >() : QVector<QByteArray>();
+            QVector<QByteArray> data = request->inParams.size() ? request->inParams.takeFirst().value<QVector<QByteArray> >() : QVector<QByteArray>();
+            QVector<Key> keys = request->inParams.size() ? request->inParams.takeFirst().value<QVector<Key> >() : QVector<Key>();
+            CryptoManager::SignaturePadding padding = request->inParams.size() ? request->inParams.takeFirst().value<CryptoManager::SignaturePadding>() : CryptoManager::SignaturePaddingUnknown;
+            CryptoManager::DigestFunction digestFunction = request->inParams.size() ? request->inParams.takeFirst().value<CryptoManager::DigestFunction>() : CryptoManager::DigestUnknown;
+            QVariantMap customParameters = request->inParams.size() ? request->inParams.takeFirst().value<QVariantMap>() : QVariantMap();
+            QString cryptosystemProviderName = request->inParams.size() ? request->inParams.takeFirst().value<QString>() : QString();
+            Result result = m_requestProcessor->verifyBatch(
+                        request->remotePid,
+                        request->requestId,
+                        signatures,
+                        data,
+                        keys,
+                        padding,
+                        digestFunction,
+                        customParameters,
+                        cryptosystemProviderName,
+                        &verificationStatuses);
+            // send the reply to the calling peer.
+            if (result.code() == Result::Pending) {
+                // waiting for asynchronous flow to complete
+                *completed = false;
+            } else {
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(verificationStatuses));
                 *completed = true;
             }
             break;
@@ -1259,8 +1686,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<quint32>(cipherSessionToken));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<quint32>(cipherSessionToken));
                 *completed = true;
             }
             break;
@@ -1283,7 +1710,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1308,8 +1735,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(generatedData));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(generatedData));
                 *completed = true;
             }
             break;
@@ -1336,9 +1763,9 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(generatedData)
-                                                                        << QVariant::fromValue<int>(verificationStatus));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(generatedData)
+                                                                  << QVariant::fromValue<int>(verificationStatus));
                 *completed = true;
             }
             break;
@@ -1363,8 +1790,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
                 *completed = true;
             }
             break;
@@ -1391,7 +1818,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1418,7 +1845,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1445,7 +1872,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
                 // waiting for asynchronous flow to complete
                 *completed = false;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1457,6 +1884,13 @@ void Daemon::ApiImpl::CryptoRequestQueue::handlePendingRequest(
             break;
         }
     }
+
+    // plugins may have been locked or unlocked by a lock code request.
+    if (*completed && (request->type == ModifyLockCodeRequest
+                       || request->type == ProvideLockCodeRequest
+                       || request->type == ForgetLockCodeRequest)) {
+        m_controller->invalidatePluginStates();
+    }
 }
 
 void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
@@ -1480,13 +1914,25 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 QVector<PluginInfo> storagePlugins = request->outParams.size()
                         ? request->outParams.takeFirst().value<QVector<PluginInfo> >()
                         : QVector<PluginInfo>();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QVector<PluginInfo> >(cryptoPlugins)
-                                                                        << QVariant::fromValue<QVector<PluginInfo> >(storagePlugins));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<PluginInfo> >(cryptoPlugins)
+                                                                  << QVariant::fromValue<QVector<PluginInfo> >(storagePlugins));
                 *completed = true;
             }
             break;
         }
+        case GetStatisticsRequest: {
+            // The statistics are always returned synchronously by handlePendingRequest(),
+            // so this is only reached if the request could not be started in time.
+            Result result = request->outParams.size()
+                    ? request->outParams.takeFirst().value<Result>()
+                    : Result(Result::UnknownError,
+                             QLatin1String("Unable to determine result of GetStatisticsRequest request"));
+            sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                              << QVariant::fromValue<QVariantMap>(QVariantMap()));
+            *completed = true;
+            break;
+        }
         case GenerateRandomDataRequest: {
             Result result = request->outParams.size()
                     ? request->outParams.takeFirst().value<Result>()
@@ -1498,8 +1944,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 *completed = true;
             } else {
                 QByteArray randomData = request->outParams.size() ? request->outParams.takeFirst().value<QByteArray>() : QByteArray();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(randomData));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(randomData));
                 *completed = true;
             }
             break;
@@ -1514,7 +1960,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 qCWarning(lcSailfishCryptoDaemon) << "SeedRandomDataGeneratorRequest:" << request->requestId << "finished as pending!";
                 *completed = true;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1531,8 +1977,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 *completed = true;
             } else {
                 QByteArray generatedIV = request->outParams.size() ? request->outParams.takeFirst().value<QByteArray>() : QByteArray();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(generatedIV));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(generatedIV));
                 *completed = true;
             }
             break;
@@ -1550,8 +1996,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 Key key = request->outParams.size()
                         ? request->outParams.takeFirst().value<Key>()
                         : Key();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(key));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(key));
                 *completed = true;
             }
             break;
@@ -1569,8 +2015,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 Key key = request->outParams.size()
                         ? request->outParams.takeFirst().value<Key>()
                         : Key();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(key));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(key));
                 *completed = true;
             }
             break;
@@ -1588,8 +2034,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 Key key = request->outParams.size()
                         ? request->outParams.takeFirst().value<Key>()
                         : Key();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(key));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(key));
                 *completed = true;
             }
             break;
@@ -1607,8 +2053,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 Key key = request->outParams.size()
                         ? request->outParams.takeFirst().value<Key>()
                         : Key();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(key));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(key));
                 *completed = true;
             }
             break;
@@ -1626,8 +2072,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 Key key = request->outParams.size()
                         ? request->outParams.takeFirst().value<Key>()
                         : Key();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<Key>(key));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<Key>(key));
                 *completed = true;
             }
             break;
@@ -1642,7 +2088,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 qCWarning(lcSailfishCryptoDaemon) << "DeleteStoredKeyRequest:" << request->requestId << "finished as pending!";
                 *completed = true;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1660,8 +2106,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 QVector<Key::Identifier> identifiers = request->outParams.size()
                         ? request->outParams.takeFirst().value<QVector<Key::Identifier> >()
                         : QVector<Key::Identifier>();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QVector<Key::Identifier> >(identifiers));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<Key::Identifier> >(identifiers));
                 *completed = true;
             }
             break;
@@ -1679,8 +2125,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 QByteArray digest = request->outParams.size()
                         ? request->outParams.takeFirst().toByteArray()
                         : QByteArray();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(digest));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(digest));
                 *completed = true;
             }
             break;
@@ -1698,8 +2144,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 QByteArray signature = request->outParams.size()
                         ? request->outParams.takeFirst().toByteArray()
                         : QByteArray();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(signature));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(signature));
                 *completed = true;
             }
             break;
@@ -1717,8 +2163,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 CryptoManager::VerificationStatus verificationStatus = request->outParams.size()
                         ? request->outParams.takeFirst().value<CryptoManager::VerificationStatus>()
                         : CryptoManager::VerificationStatusUnknown;
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<CryptoManager::VerificationStatus>(verificationStatus));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<CryptoManager::VerificationStatus>(verificationStatus));
                 *completed = true;
             }
             break;
@@ -1739,9 +2185,9 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 QByteArray authenticationTag = request->outParams.size()
                         ? request->outParams.takeFirst().toByteArray()
                         : QByteArray();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(encrypted)
-                                                                        << QVariant::fromValue<QByteArray>(authenticationTag));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(encrypted)
+                                                                  << QVariant::fromValue<QByteArray>(authenticationTag));
                 *completed = true;
             }
             break;
@@ -1762,9 +2208,74 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 CryptoManager::VerificationStatus verificationStatus = request->outParams.size()
                         ? request->outParams.takeFirst().value<CryptoManager::VerificationStatus>()
                         : CryptoManager::VerificationStatusUnknown;
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(decrypted)
-                                                                        << QVariant::fromValue<CryptoManager::VerificationStatus>(verificationStatus));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(decrypted)
+                                                                  << QVariant::fromValue<CryptoManager::VerificationStatus>(verificationStatus));
+                *completed = true;
+            }
+            break;
+        }
+        case EncryptBatchRequest: {
+            Result result = request->outParams.size()
+                    ? request->outParams.takeFirst().value<Result>()
+                    : Result(Result::UnknownError,
+                             QLatin1String("Unable to determine result of EncryptBatchRequest request"));
+            if (result.code() == Result::Pending) {
+                // shouldn't happen!
+                qCWarning(lcSailfishCryptoDaemon) << "EncryptBatchRequest:" << request->requestId << "finished as pending!";
+                *completed = true;
+            } else {
+                QVector<QByteArray> encrypted = request->outParams.size()
+                        ? request->outParams.takeFirst().value<QVector<QByteArray> >()
+                        : QVector<QByteArray>();
+                QVector<QByteArray> authenticationTags = request->outParams.size()
+                        ? request->outParams.takeFirst().value<QVector<QByteArray> >()
+                        : QVector<QByteArray>();
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<QByteArray> >(encrypted)
+                                                                  << QVariant::fromValue<QVector<QByteArray> >(authenticationTags));
+                *completed = true;
+            }
+            break;
+        }
+        case DecryptBatchRequest: {
+            Result result = request->outParams.size()
+                    ? request->outParams.takeFirst().value<Result>()
+                    : Result(Result::UnknownError,
+                             QLatin1String("Unable to determine result of DecryptBatchRequest request"));
+            if (result.code() == Result::Pending) {
+                // shouldn't happen!
+                qCWarning(lcSailfishCryptoDaemon) << "DecryptBatchRequest:" << request->requestId << "finished as pending!";
+                *completed = true;
+            } else {
+                QVector<QByteArray> decrypted = request->outParams.size()
+                        ? request->outParams.takeFirst().value<QVector<QByteArray> >()
+                        : QVector<QByteArray>();
+                QVector<CryptoManager::VerificationStatus> verificationStatuses = request->outParams.size()
+                        ? request->outParams.takeFirst().value<QVector<CryptoManager::VerificationStatus> >()
+                        : QVector<CryptoManager::VerificationStatus>();
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<QByteArray> >(decrypted)
+                                                                  << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(verificationStatuses));
+                *completed = true;
+            }
+            break;
+        }
+        case VerifyBatchRequest: {
+            Result result = request->outParams.size()
+                    ? request->outParams.takeFirst().value<Result>()
+                    : Result(Result::UnknownError,
+                             QLatin1String("Unable to determine result of VerifyBatchRequest request"));
+            if (result.code() == Result::Pending) {
+                // shouldn't happen!
+                qCWarning(lcSailfishCryptoDaemon) << "VerifyBatchRequest:" << request->requestId << "finished as pending!";
+                *completed = true;
+            } else {
+                QVector<CryptoManager::VerificationStatus> verificationStatuses = request->outParams.size()
+                        ? request->outParams.takeFirst().value<QVector<CryptoManager::VerificationStatus> >()
+                        : QVector<CryptoManager::VerificationStatus>();
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(verificationStatuses));
                 *completed = true;
             }
             break;
@@ -1785,9 +2296,9 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 QByteArray generatedIV = request->outParams.size()
                         ? request->outParams.takeFirst().toByteArray()
                         : QByteArray();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<quint32>(cipherSessionToken)
-                                                                        << QVariant::fromValue<QByteArray>(generatedIV));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<quint32>(cipherSessionToken)
+                                                                  << QVariant::fromValue<QByteArray>(generatedIV));
                 *completed = true;
             }
             break;
@@ -1802,7 +2313,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 qCWarning(lcSailfishCryptoDaemon) << "UpdateCipherSessionAuthenticationRequest:" << request->requestId << "finished as pending!";
                 *completed = true;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1820,8 +2331,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 QByteArray generatedData = request->outParams.size()
                         ? request->outParams.takeFirst().toByteArray()
                         : QByteArray();
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(generatedData));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(generatedData));
                 *completed = true;
             }
             break;
@@ -1842,9 +2353,9 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 CryptoManager::VerificationStatus verificationStatus = request->outParams.size()
                         ? request->outParams.takeFirst().value<CryptoManager::VerificationStatus>()
                         : CryptoManager::VerificationStatusUnknown;
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<QByteArray>(generatedData)
-                                                                        << QVariant::fromValue<CryptoManager::VerificationStatus>(verificationStatus));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QByteArray>(generatedData)
+                                                                  << QVariant::fromValue<CryptoManager::VerificationStatus>(verificationStatus));
                 *completed = true;
             }
             break;
@@ -1862,8 +2373,8 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 LockCodeRequest::LockStatus lockStatus = request->outParams.size()
                         ? request->outParams.takeFirst().value<LockCodeRequest::LockStatus>()
                         : LockCodeRequest::Unknown;
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                        << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
             }
             break;
         }
@@ -1877,7 +2388,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 qCWarning(lcSailfishCryptoDaemon) << "ModifyLockCodeRequest:" << request->requestId << "finished as pending!";
                 *completed = true;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1892,7 +2403,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 qCWarning(lcSailfishCryptoDaemon) << "ProvideLockCodeRequest:" << request->requestId << "finished as pending!";
                 *completed = true;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1907,7 +2418,7 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
                 qCWarning(lcSailfishCryptoDaemon) << "ForgetLockCodeRequest:" << request->requestId << "finished as pending!";
                 *completed = true;
             } else {
-                request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 *completed = true;
             }
             break;
@@ -1918,4 +2429,11 @@ void Daemon::ApiImpl::CryptoRequestQueue::handleFinishedRequest(
             break;
         }
     }
+
+    // plugins may have been locked or unlocked by a lock code request.
+    if (*completed && (request->type == ModifyLockCodeRequest
+                       || request->type == ProvideLockCodeRequest
+                       || request->type == ForgetLockCodeRequest)) {
+        m_controller->invalidatePluginStates();
+    }
 }
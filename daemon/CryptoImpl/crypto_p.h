@@ -26,9 +26,12 @@
 #include <QtCore/QByteArray>
 #include <QtCore/QString>
 #include <QtCore/QThreadPool>
+#include <QtCore/QHash>
 #include <QtCore/QSharedPointer>
 #include <QtDBus/QDBusContext>
 
+#include <functional>
+
 namespace Sailfish {
 
 namespace Secrets {
@@ -53,19 +56,25 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     Q_CLASSINFO("D-Bus Introspection", ""
     "  <interface name=\"org.sailfishos.crypto\">\n"
     "      <method name=\"getPluginInfo\">\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"cryptoPlugins\" type=\"a(ssi)\" direction=\"out\" />\n"
     "          <arg name=\"storagePlugins\" type=\"a(ssi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVector<Sailfish::Crypto::PluginInfo>\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out2\" value=\"QVector<Sailfish::Crypto::PluginInfo>\" />\n"
     "      </method>\n"
+    "      <method name=\"getStatistics\">\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
+    "          <arg name=\"statistics\" type=\"a{sv}\" direction=\"out\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVariantMap\" />\n"
+    "      </method>\n"
     "      <method name=\"generateRandomData\">\n"
     "          <arg name=\"numberBytes\" type=\"t\" direction=\"in\" />\n"
     "          <arg name=\"csprngEngineName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"randomData\" type=\"ay\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
     "      </method>\n"
@@ -75,7 +84,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"csprngEngineName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
     "      </method>\n"
     "      <method name=\"generateKey\">\n"
@@ -84,7 +93,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"skdfParameters\" type=\"(ayay(i)(i)(i)(i)xiiia{sv})\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"key\" type=\"(ay)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Crypto::Key\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Crypto::KeyPairGenerationParameters\" />\n"
@@ -99,7 +108,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"uiParams\" type=\"(sss(i)sss(i)(i))\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"key\" type=\"(ay)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Crypto::Key\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Crypto::KeyPairGenerationParameters\" />\n"
@@ -113,7 +122,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"uiParams\" type=\"(ssss(i)ssa{is}(i)(i))\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"importedKey\" type=\"(ay)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Crypto::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
@@ -125,7 +134,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"uiParams\" type=\"(ssss(i)ssa{is}(i)(i))\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"importedKeyReference\" type=\"(ay)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Crypto::Key\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::InteractionParameters\" />\n"
@@ -136,7 +145,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"identifier\" type=\"(sss)\" direction=\"in\" />\n"
     "          <arg name=\"keyComponents\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"key\" type=\"(ay)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Crypto::Key::Identifier\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Crypto::Key::Components\" />\n"
@@ -145,7 +154,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "      </method>\n"
     "      <method name=\"deleteStoredKey\">\n"
     "          <arg name=\"identifier\" type=\"(sss)\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Crypto::Key::Identifier\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
     "      </method>\n"
@@ -153,7 +162,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"storagePluginName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"collectionName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"identifiers\" type=\"a(sss)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVector<Sailfish::Crypto::Key::Identifier>\" />\n"
@@ -164,7 +173,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"digestFunction\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"digest\" type=\"ay\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Crypto::CryptoManager::SignaturePadding\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::CryptoManager::Digest\" />\n"
@@ -177,7 +186,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"digest\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"signature\" type=\"ay\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Crypto::Key\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::CryptoManager::SignaturePadding\" />\n"
@@ -192,7 +201,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"digest\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"verificationStatus\" type=\"(i)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::Key\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Crypto::CryptoManager::SignaturePadding\" />\n"
@@ -209,7 +218,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"authenticationData\" type=\"ay\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"encrypted\" type=\"ay\" direction=\"out\" />\n"
     "          <arg name=\"authenticationTag\" type=\"ay\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::Key\" />\n"
@@ -227,7 +236,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"authenticationTag\" type=\"ay\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"decrypted\" type=\"ay\" direction=\"out\" />\n"
     "          <arg name=\"verificationStatus\" type=\"(i)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::Key\" />\n"
@@ -236,6 +245,70 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"Sailfish::Crypto::CryptoManager::VerificationStatus\" />\n"
     "      </method>\n"
+    "      <method name=\"encryptBatch\">\n"
+    "          <arg name=\"data\" type=\"aay\" direction=\"in\" />\n"
+    "          <arg name=\"ivs\" type=\"aay\" direction=\"in\" />\n"
+    "          <arg name=\"key\" type=\"(ay)\" direction=\"in\" />\n"
+    "          <arg name=\"blockMode\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"padding\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"authenticationData\" type=\"aay\" direction=\"in\" />\n"
+    "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
+    "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
+    "          <arg name=\"encrypted\" type=\"aay\" direction=\"out\" />\n"
+    "          <arg name=\"authenticationTags\" type=\"aay\" direction=\"out\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::Key\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Crypto::CryptoManager::BlockMode\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In4\" value=\"Sailfish::Crypto::CryptoManager::EncryptionPadding\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In5\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out2\" value=\"QVector<QByteArray>\" />\n"
+    "      </method>\n"
+    "      <method name=\"decryptBatch\">\n"
+    "          <arg name=\"data\" type=\"aay\" direction=\"in\" />\n"
+    "          <arg name=\"ivs\" type=\"aay\" direction=\"in\" />\n"
+    "          <arg name=\"key\" type=\"(ay)\" direction=\"in\" />\n"
+    "          <arg name=\"blockMode\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"padding\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"authenticationData\" type=\"aay\" direction=\"in\" />\n"
+    "          <arg name=\"authenticationTags\" type=\"aay\" direction=\"in\" />\n"
+    "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
+    "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
+    "          <arg name=\"decrypted\" type=\"aay\" direction=\"out\" />\n"
+    "          <arg name=\"verificationStatuses\" type=\"a(i)\" direction=\"out\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::Key\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Crypto::CryptoManager::BlockMode\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In4\" value=\"Sailfish::Crypto::CryptoManager::EncryptionPadding\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In5\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In6\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out2\" value=\"QVector<Sailfish::Crypto::CryptoManager::VerificationStatus>\" />\n"
+    "      </method>\n"
+    "      <method name=\"verifyBatch\">\n"
+    "          <arg name=\"signatures\" type=\"aay\" direction=\"in\" />\n"
+    "          <arg name=\"data\" type=\"aay\" direction=\"in\" />\n"
+    "          <arg name=\"keys\" type=\"a(ay)\" direction=\"in\" />\n"
+    "          <arg name=\"padding\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"digest\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
+    "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
+    "          <arg name=\"verificationStatuses\" type=\"a(i)\" direction=\"out\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"QVector<QByteArray>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"QVector<Sailfish::Crypto::Key>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Crypto::CryptoManager::SignaturePadding\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In4\" value=\"Sailfish::Crypto::CryptoManager::Digest\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVector<Sailfish::Crypto::CryptoManager::VerificationStatus>\" />\n"
+    "      </method>\n"
     "      <method name=\"initializeCipherSession\">\n"
     "          <arg name=\"initializationVector\" type=\"ay\" direction=\"in\" />\n"
     "          <arg name=\"key\" type=\"(ay)\" direction=\"in\" />\n"
@@ -246,7 +319,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"digest\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"cipherSessionToken\" type=\"u\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Crypto::Key\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::CryptoManager::Operation\" />\n"
@@ -261,7 +334,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"cipherSessionToken\" type=\"u\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
     "      </method>\n"
     "      <method name=\"updateCipherSession\">\n"
@@ -269,7 +342,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"cipherSessionToken\" type=\"u\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"generatedData\" type=\"ay\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
     "      </method>\n"
@@ -278,7 +351,7 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"customParameters\" type=\"a{sv}\" direction=\"in\" />\n"
     "          <arg name=\"cryptosystemProviderName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"cipherSessionToken\" type=\"u\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iiis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iiisi)\" direction=\"out\" />\n"
     "          <arg name=\"generatedData\" type=\"ay\" direction=\"out\" />\n"
     "          <arg name=\"verificationStatus\" type=\"(i)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
@@ -320,6 +393,20 @@ class CryptoDBusObject : public QObject, protected QDBusContext
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Crypto::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Crypto::Result\" />\n"
     "      </method>\n"
+    "      <method name=\"cancelRequest\">\n"
+    "          <arg name=\"sequence\" type=\"t\" direction=\"in\" />\n"
+    "          <arg name=\"method\" type=\"s\" direction=\"in\" />\n"
+    "      </method>\n"
+    "      <method name=\"setNextRequestTimeout\">\n"
+    "          <arg name=\"timeout\" type=\"i\" direction=\"in\" />\n"
+    "      </method>\n"
+    "      <method name=\"setNextRequestPipeline\">\n"
+    "          <arg name=\"pipelineId\" type=\"t\" direction=\"in\" />\n"
+    "      </method>\n"
+    "      <method name=\"endPipeline\">\n"
+    "          <arg name=\"pipelineId\" type=\"t\" direction=\"in\" />\n"
+    "      </method>\n"
+    "      <signal name=\"pluginInfoChanged\" />\n"
     "  </interface>\n"
     "")
 
@@ -333,6 +420,11 @@ public Q_SLOTS:
             QVector<Sailfish::Crypto::PluginInfo> &cryptoPlugins,
             QVector<Sailfish::Crypto::PluginInfo> &storagePlugins);
 
+    void getStatistics(
+            const QDBusMessage &message,
+            Sailfish::Crypto::Result &result,
+            QVariantMap &statistics);
+
     void generateRandomData(
             quint64 numberBytes,
             const QString &csprngEngineName,
@@ -484,6 +576,47 @@ public Q_SLOTS:
             QByteArray &decrypted,
             Sailfish::Crypto::CryptoManager::VerificationStatus &verificationStatus);
 
+    void encryptBatch(
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVariantMap &customParameters,
+            const QString &cryptosystemProviderName,
+            const QDBusMessage &message,
+            Sailfish::Crypto::Result &result,
+            QVector<QByteArray> &encrypted,
+            QVector<QByteArray> &authenticationTags);
+
+    void decryptBatch(
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVector<QByteArray> &authenticationTags,
+            const QVariantMap &customParameters,
+            const QString &cryptosystemProviderName,
+            const QDBusMessage &message,
+            Sailfish::Crypto::Result &result,
+            QVector<QByteArray> &decrypted,
+            QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> &verificationStatuses);
+
+    void verifyBatch(
+            const QVector<QByteArray> &signatures,
+            const QVector<QByteArray> &data,
+            const QVector<Sailfish::Crypto::Key> &keys,
+            Sailfish::Crypto::CryptoManager::SignaturePadding padding,
+            Sailfish::Crypto::CryptoManager::DigestFunction digestFunction,
+            const QVariantMap &customParameters,
+            const QString &cryptosystemProviderName,
+            const QDBusMessage &message,
+            Sailfish::Crypto::Result &result,
+            QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> &verificationStatuses);
+
     void initializeCipherSession(
             const QByteArray &initializationVector,
             const Sailfish::Crypto::Key &key,
@@ -553,6 +686,25 @@ public Q_SLOTS:
             const QDBusMessage &message,
             Sailfish::Crypto::Result &result);
 
+    // cancel a request previously sent via the client connection
+    void cancelRequest(
+            quint64 sequence,
+            const QString &method);
+
+    // set the deadline of the next request sent via the client connection
+    void setNextRequestTimeout(int timeout);
+
+    // run the next request sent via the client connection as a stage of
+    // the given pipeline, once the previous stages have succeeded
+    void setNextRequestPipeline(quint64 pipelineId);
+
+    // no more requests will be sent as stages of the given pipeline
+    void endPipeline(quint64 pipelineId);
+
+Q_SIGNALS:
+    // the availability or lock state of a plugin may have changed
+    void pluginInfoChanged();
+
 private:
     Sailfish::Crypto::Daemon::ApiImpl::CryptoRequestQueue *m_requestQueue;
 };
@@ -570,19 +722,31 @@ public:
 
     Sailfish::Secrets::Daemon::Controller *controller();
     QWeakPointer<QThreadPool> cryptoThreadPool();
+    QWeakPointer<QThreadPool> pluginThreadPool(const QString &pluginName, bool concurrent);
     QMap<QString, Sailfish::Crypto::CryptoPlugin*> plugins() const;
 
-    Sailfish::Crypto::LockCodeRequest::LockStatus queryLockStatusPlugin(const QString &pluginName);
-    bool lockPlugin(const QString &pluginName);
-    bool unlockPlugin(const QString &pluginName, const QByteArray &lockCode);
-    bool setLockCodePlugin(const QString &pluginName, const QByteArray &oldCode, const QByteArray &newCode);
+    void queryLockStatusPlugin(const QString &pluginName, const std::function<void (Sailfish::Crypto::LockCodeRequest::LockStatus)> &completion);
+    void lockPlugin(const QString &pluginName, const std::function<void (bool)> &completion);
+    void unlockPlugin(const QString &pluginName, const QByteArray &lockCode, const std::function<void (bool)> &completion);
+    void setLockCodePlugin(const QString &pluginName, const QByteArray &oldCode, const QByteArray &newCode, const std::function<void (bool)> &completion);
 
     void handlePendingRequest(Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestData *request, bool *completed) Q_DECL_OVERRIDE;
     void handleFinishedRequest(Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestData *request, bool *completed) Q_DECL_OVERRIDE;
     QString requestTypeToString(int type) const Q_DECL_OVERRIDE;
+    Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestPriority requestPriority(int type) const Q_DECL_OVERRIDE;
+    qint64 parameterSize(const QVariant &parameter) const Q_DECL_OVERRIDE;
+    QVariant timedOutResult() const Q_DECL_OVERRIDE;
+    QVariant pipelineAbortedResult() const Q_DECL_OVERRIDE;
+    bool isFailureResult(const QVariant &result) const Q_DECL_OVERRIDE;
+    QString requestPluginName(int type, const QVariantList &inParams) const Q_DECL_OVERRIDE;
+    void clientConnected(pid_t pid) Q_DECL_OVERRIDE;
+    void clientDisconnected(pid_t pid) Q_DECL_OVERRIDE;
+    void resultReplied(const QVariant &result) Q_DECL_OVERRIDE;
 
 private:
     QSharedPointer<QThreadPool> m_cryptoThreadPool;
+    QHash<QString, QSharedPointer<QThreadPool> > m_pluginThreadPools;           // serial, indexed by plugin name.
+    QHash<QString, QSharedPointer<QThreadPool> > m_concurrentPluginThreadPools; // for thread-safe plugins only.
     Sailfish::Crypto::Daemon::ApiImpl::RequestProcessor *m_requestProcessor;
     Sailfish::Secrets::Daemon::Controller *m_controller;
 };
@@ -605,6 +769,9 @@ enum RequestType {
     VerifyRequest,
     EncryptRequest,
     DecryptRequest,
+    EncryptBatchRequest,
+    DecryptBatchRequest,
+    VerifyBatchRequest,
     InitializeCipherSessionRequest,
     UpdateCipherSessionAuthenticationRequest,
     UpdateCipherSessionRequest,
@@ -612,7 +779,8 @@ enum RequestType {
     QueryLockStatusRequest,
     ModifyLockCodeRequest,
     ProvideLockCodeRequest,
-    ForgetLockCodeRequest
+    ForgetLockCodeRequest,
+    GetStatisticsRequest
 };
 
 } // ApiImpl
@@ -13,6 +13,8 @@
 using namespace Sailfish::Crypto;
 using namespace Sailfish::Crypto::Daemon::ApiImpl;
 using namespace Sailfish::Secrets::Daemon::Util;
+using Sailfish::Secrets::Daemon::ApiImpl::TraceContextScope;
+using Sailfish::Secrets::Daemon::ApiImpl::TraceSpan;
 
 namespace {
     Sailfish::Secrets::Result unlockCollection(CryptoStoragePluginWrapper *w,
@@ -54,12 +56,14 @@ namespace {
 bool CryptoPluginFunctionWrapper::isLocked(
         CryptoPlugin *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->isLocked();
 }
 
 bool CryptoPluginFunctionWrapper::lock(
         CryptoPlugin *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->lock();
 }
 
@@ -67,6 +71,7 @@ bool CryptoPluginFunctionWrapper::unlock(
         CryptoPlugin *plugin,
         const QByteArray &lockCode)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->unlock(lockCode);
 }
 
@@ -75,6 +80,7 @@ bool CryptoPluginFunctionWrapper::setLockCode(
         const QByteArray &oldLockCode,
         const QByteArray &newLockCode)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->setLockCode(oldLockCode, newLockCode);
 }
 
@@ -84,6 +90,8 @@ DataResult CryptoPluginFunctionWrapper::generateRandomData(
         const QString &csprngEngineName,
         quint64 numberBytes)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     QByteArray randomData;
     Result result = pluginAndCustomParams.plugin->generateRandomData(
                 callerIdent,
@@ -101,6 +109,8 @@ Result CryptoPluginFunctionWrapper::seedRandomDataGenerator(
         const QByteArray &seedData,
         double entropyEstimate)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     return pluginAndCustomParams.plugin->seedRandomDataGenerator(
                 callerIdent,
                 csprngEngineName,
@@ -115,6 +125,8 @@ DataResult CryptoPluginFunctionWrapper::generateInitializationVector(
         CryptoManager::BlockMode blockMode,
         int keySize)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     QByteArray iv;
     Result result = pluginAndCustomParams.plugin->generateInitializationVector(
                 algorithm, blockMode, keySize,
@@ -128,6 +140,8 @@ KeyResult CryptoPluginFunctionWrapper::importKey(
         const QByteArray &keyData,
         const QByteArray &passphrase)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     Key key;
     Result result = pluginAndCustomParams.plugin->importKey(
                 keyData, passphrase,
@@ -143,6 +157,8 @@ KeyResult CryptoPluginFunctionWrapper::importAndStoreKey(
         const QByteArray &passphrase,
         const QByteArray &collectionDecryptionKey)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     Sailfish::Secrets::Daemon::ApiImpl::CollectionMetadata collectionMetadata;
     Sailfish::Secrets::Result sresult = pluginAndCustomParams.wrapper->collectionMetadata(
                 keyTemplate.identifier().collectionName(),
@@ -181,6 +197,8 @@ KeyResult CryptoPluginFunctionWrapper::generateKey(
         const KeyPairGenerationParameters &kpgParams,
         const KeyDerivationParameters &skdfParams)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     Key key(keyTemplate);
     Result result = pluginAndCustomParams.plugin->generateKey(
                 keyTemplate, kpgParams, skdfParams,
@@ -195,6 +213,7 @@ KeyResult CryptoPluginFunctionWrapper::storedKey(
         Key::Components keyComponents,
         const QVariantMap &customParameters)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     Key key;
     key.setIdentifier(identifier);
     Result result = plugin->storedKey(
@@ -207,6 +226,7 @@ IdentifiersResult CryptoPluginFunctionWrapper::storedKeyIdentifiers(
         const QString &collectionName,
         const QVariantMap &customParameters)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QVector<Key::Identifier> identifiers;
     Result result = plugin->storedKeyIdentifiers(collectionName, customParameters, &identifiers);
     return IdentifiersResult(result, identifiers);
@@ -217,6 +237,8 @@ DataResult CryptoPluginFunctionWrapper::calculateDigest(
         const QByteArray &data,
         const SignatureOptions &options)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     QByteArray digest;
     Result result = pluginAndCustomParams.plugin->calculateDigest(
                 data,
@@ -233,6 +255,8 @@ DataResult CryptoPluginFunctionWrapper::sign(
         const KeyAndCollectionKey &keyAndCollectionKey,
         const SignatureOptions &options)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     QByteArray signature;
     Result result(Result::Succeeded);
 
@@ -290,6 +314,8 @@ ValidatedResult CryptoPluginFunctionWrapper::verify(
         const KeyAndCollectionKey &keyAndCollectionKey,
         const SignatureOptions &options)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     Sailfish::Crypto::CryptoManager::VerificationStatus verificationStatus = Sailfish::Crypto::CryptoManager::VerificationStatusUnknown;
     Result result(Result::Succeeded);
 
@@ -342,6 +368,46 @@ ValidatedResult CryptoPluginFunctionWrapper::verify(
     return ValidatedResult(result, verificationStatus);
 }
 
+ValidatedListResult CryptoPluginFunctionWrapper::verifyBatch(
+        const PluginWrapperAndCustomParams &pluginAndCustomParams,
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Key> &keys,
+        const SignatureOptions &options)
+{
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
+    QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> verificationStatuses;
+    Result result(Result::Succeeded);
+
+    // the keys have already been read from storage by the daemon, so we
+    // never need to unlock a collection in order to access them.
+    if (CryptoStoragePluginWrapper *w = pluginAndCustomParams.wrapper) {
+        result = w->cryptoPlugin()->verifyBatch(
+                    signatures, data, keys,
+                    options.signaturePadding,
+                    options.digestFunction,
+                    pluginAndCustomParams.customParameters,
+                    &verificationStatuses);
+    } else if (pluginAndCustomParams.plugin) {
+        result = pluginAndCustomParams.plugin->verifyBatch(
+                    signatures, data, keys,
+                    options.signaturePadding,
+                    options.digestFunction,
+                    pluginAndCustomParams.customParameters,
+                    &verificationStatuses);
+    } else {
+        result = Result(Result::InvalidCryptographicServiceProvider,
+                        QLatin1String("Internal error: wrapper and plugin null"));
+    }
+
+    if (result.code() != Result::Succeeded) {
+        verificationStatuses.clear();
+    }
+
+    return ValidatedListResult(result, verificationStatuses);
+}
+
 TagDataResult CryptoPluginFunctionWrapper::encrypt(
         const PluginWrapperAndCustomParams &pluginAndCustomParams,
         const DataAndIV &dataAndIv,
@@ -349,6 +415,8 @@ TagDataResult CryptoPluginFunctionWrapper::encrypt(
         const EncryptionOptions &options,
         const QByteArray &authenticationData)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     QByteArray ciphertext;
     QByteArray authenticationTag;
     Result result(Result::Succeeded);
@@ -415,6 +483,8 @@ VerifiedDataResult CryptoPluginFunctionWrapper::decrypt(
         const EncryptionOptions &options,
         const AuthDataAndTag &authDataAndTag)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     QByteArray plaintext;
     Sailfish::Crypto::CryptoManager::VerificationStatus verificationStatus = Sailfish::Crypto::CryptoManager::VerificationStatusUnknown;
     Result result(Result::Succeeded);
@@ -474,6 +544,155 @@ VerifiedDataResult CryptoPluginFunctionWrapper::decrypt(
     return VerifiedDataResult(result, plaintext, verificationStatus);
 }
 
+TagDataListResult CryptoPluginFunctionWrapper::encryptBatch(
+        const PluginWrapperAndCustomParams &pluginAndCustomParams,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const KeyAndCollectionKey &keyAndCollectionKey,
+        const EncryptionOptions &options,
+        const QVector<QByteArray> &authenticationData)
+{
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
+    QVector<QByteArray> ciphertexts;
+    QVector<QByteArray> authenticationTags;
+    Result result(Result::Succeeded);
+
+    if (CryptoStoragePluginWrapper *w = pluginAndCustomParams.wrapper) {
+        const QString collectionName = keyAndCollectionKey.key.identifier().collectionName();
+        const QByteArray collectionKey = keyAndCollectionKey.collectionKey;
+        bool wasLocked = false;
+
+        // check to see if we need to unlock the collection in order to access the key.
+        // we don't need to do this if the given key has the appropriate components already.
+        if (keyAndCollectionKey.key.publicKey().isEmpty()
+                && keyAndCollectionKey.key.privateKey().isEmpty()
+                && keyAndCollectionKey.key.secretKey().isEmpty()) {
+            Sailfish::Secrets::Result lockedResult = unlockCollection(
+                        w, collectionName, collectionKey, &wasLocked);
+
+            if (lockedResult.code() == Sailfish::Secrets::Result::Failed) {
+                result = transformSecretsResult(lockedResult);
+            }
+        }
+
+        if (result.code() == Result::Succeeded) {
+            result = w->cryptoPlugin()->encryptBatch(
+                        data,
+                        ivs,
+                        keyAndCollectionKey.key,
+                        options.blockMode,
+                        options.encryptionPadding,
+                        authenticationData,
+                        pluginAndCustomParams.customParameters,
+                        &ciphertexts, &authenticationTags);
+        }
+
+        if (wasLocked) {
+            // relock.
+            Sailfish::Secrets::Result r = w->setEncryptionKey(
+                        collectionName,
+                        QByteArray());
+            Q_UNUSED(r);
+        }
+    } else if (pluginAndCustomParams.plugin) {
+        result = pluginAndCustomParams.plugin->encryptBatch(
+                    data,
+                    ivs,
+                    keyAndCollectionKey.key,
+                    options.blockMode,
+                    options.encryptionPadding,
+                    authenticationData,
+                    pluginAndCustomParams.customParameters,
+                    &ciphertexts, &authenticationTags);
+    } else {
+        result = Result(Result::InvalidCryptographicServiceProvider,
+                        QLatin1String("Internal error: wrapper and plugin null"));
+    }
+
+    if (result.code() != Result::Succeeded) {
+        ciphertexts.clear();
+        authenticationTags.clear();
+    }
+
+    return TagDataListResult(result, ciphertexts, authenticationTags);
+}
+
+VerifiedDataListResult CryptoPluginFunctionWrapper::decryptBatch(
+        const PluginWrapperAndCustomParams &pluginAndCustomParams,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const KeyAndCollectionKey &keyAndCollectionKey,
+        const EncryptionOptions &options,
+        const QVector<QByteArray> &authenticationData,
+        const QVector<QByteArray> &authenticationTags)
+{
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
+    QVector<QByteArray> plaintexts;
+    QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> verificationStatuses;
+    Result result(Result::Succeeded);
+
+    if (CryptoStoragePluginWrapper *w = pluginAndCustomParams.wrapper) {
+        const QString collectionName = keyAndCollectionKey.key.identifier().collectionName();
+        const QByteArray collectionKey = keyAndCollectionKey.collectionKey;
+        bool wasLocked = false;
+
+        // check to see if we need to unlock the collection in order to access the key.
+        // we don't need to do this if the given key has the appropriate components already.
+        if (keyAndCollectionKey.key.privateKey().isEmpty()
+                && keyAndCollectionKey.key.secretKey().isEmpty()) {
+            Sailfish::Secrets::Result lockedResult = unlockCollection(
+                        w, collectionName, collectionKey, &wasLocked);
+            if (lockedResult.code() == Sailfish::Secrets::Result::Failed) {
+                result = transformSecretsResult(lockedResult);
+            }
+        }
+
+        if (result.code() == Result::Succeeded) {
+            result = w->cryptoPlugin()->decryptBatch(
+                        data,
+                        ivs,
+                        keyAndCollectionKey.key,
+                        options.blockMode,
+                        options.encryptionPadding,
+                        authenticationData,
+                        authenticationTags,
+                        pluginAndCustomParams.customParameters,
+                        &plaintexts, &verificationStatuses);
+        }
+
+        if (wasLocked) {
+            // relock.
+            Sailfish::Secrets::Result r = w->setEncryptionKey(
+                        collectionName,
+                        QByteArray());
+            Q_UNUSED(r);
+        }
+    } else if (pluginAndCustomParams.plugin) {
+        result = pluginAndCustomParams.plugin->decryptBatch(
+                    data,
+                    ivs,
+                    keyAndCollectionKey.key,
+                    options.blockMode,
+                    options.encryptionPadding,
+                    authenticationData,
+                    authenticationTags,
+                    pluginAndCustomParams.customParameters,
+                    &plaintexts, &verificationStatuses);
+    } else {
+        result = Result(Result::InvalidCryptographicServiceProvider,
+                        QLatin1String("Internal error: wrapper and plugin null"));
+    }
+
+    if (result.code() != Result::Succeeded) {
+        plaintexts.clear();
+        verificationStatuses.clear();
+    }
+
+    return VerifiedDataListResult(result, plaintexts, verificationStatuses);
+}
+
 CipherSessionTokenResult CryptoPluginFunctionWrapper::initializeCipherSession(
         const PluginWrapperAndCustomParams &pluginAndCustomParams,
         quint64 clientId,
@@ -481,6 +700,8 @@ CipherSessionTokenResult CryptoPluginFunctionWrapper::initializeCipherSession(
         const KeyAndCollectionKey &keyAndCollectionKey,
         const CipherSessionOptions &options)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     quint32 cipherSessionToken = 0;
     Result result(Result::Succeeded);
 
@@ -554,6 +775,8 @@ Result CryptoPluginFunctionWrapper::updateCipherSessionAuthentication(
         const QByteArray &authenticationData,
         quint32 cipherSessionToken)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     return pluginAndCustomParams.plugin->updateCipherSessionAuthentication(
                 clientId, authenticationData,
                 pluginAndCustomParams.customParameters,
@@ -566,6 +789,8 @@ DataResult CryptoPluginFunctionWrapper::updateCipherSession(
         const QByteArray &data,
         quint32 cipherSessionToken)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     QByteArray generatedData;
     Result result = pluginAndCustomParams.plugin->updateCipherSession(
                 clientId, data,
@@ -581,6 +806,8 @@ VerifiedDataResult CryptoPluginFunctionWrapper::finalizeCipherSession(
         const QByteArray &data,
         quint32 cipherSessionToken)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     Sailfish::Crypto::CryptoManager::VerificationStatus verificationStatus = Sailfish::Crypto::CryptoManager::VerificationStatusUnknown;
     QByteArray generatedData;
     Result result = pluginAndCustomParams.plugin->finalizeCipherSession(
@@ -598,6 +825,8 @@ KeyResult CryptoPluginFunctionWrapper::generateAndStoreKey(
         const Sailfish::Crypto::KeyDerivationParameters &skdfParams,
         const QByteArray &collectionUnlockCode)
 {
+    const TraceContextScope traceContext(pluginAndCustomParams.traceContext);
+    const TraceSpan traceSpan(__func__, pluginAndCustomParams.plugin);
     Sailfish::Secrets::Daemon::ApiImpl::CollectionMetadata collectionMetadata;
     Sailfish::Secrets::Result sresult = pluginAndCustomParams.wrapper->collectionMetadata(
                 keyTemplate.identifier().collectionName(),
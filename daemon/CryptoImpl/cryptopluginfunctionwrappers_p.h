@@ -10,6 +10,8 @@
 
 #include "CryptoImpl/cryptopluginwrapper_p.h"
 
+#include "tracing_p.h"
+
 #include "Crypto/Plugins/extensionplugins.h"
 
 #include "Crypto/key.h"
@@ -36,6 +38,18 @@ struct TagDataResult {
     QByteArray tag;
 };
 
+struct TagDataListResult {
+    TagDataListResult(const Sailfish::Crypto::Result &r = Sailfish::Crypto::Result(),
+                      const QVector<QByteArray> &d = QVector<QByteArray>(),
+                      const QVector<QByteArray> &t = QVector<QByteArray>())
+        : result(r), data(d), tags(t) {}
+    TagDataListResult(const TagDataListResult &other)
+        : result(other.result), data(other.data), tags(other.tags) {}
+    Sailfish::Crypto::Result result;
+    QVector<QByteArray> data;
+    QVector<QByteArray> tags;
+};
+
 struct DataResult {
     DataResult(const Sailfish::Crypto::Result &r = Sailfish::Crypto::Result(),
                const QByteArray &d = QByteArray())
@@ -57,6 +71,18 @@ struct VerifiedDataResult {
     Sailfish::Crypto::CryptoManager::VerificationStatus verificationStatus;
 };
 
+struct VerifiedDataListResult {
+    VerifiedDataListResult(const Sailfish::Crypto::Result &r = Sailfish::Crypto::Result(),
+                           const QVector<QByteArray> &d = QVector<QByteArray>(),
+                           const QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> &v = QVector<Sailfish::Crypto::CryptoManager::VerificationStatus>())
+        : result(r), data(d), verificationStatuses(v) {}
+    VerifiedDataListResult(const VerifiedDataListResult &other)
+        : result(other.result), data(other.data), verificationStatuses(other.verificationStatuses) {}
+    Sailfish::Crypto::Result result;
+    QVector<QByteArray> data;
+    QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> verificationStatuses;
+};
+
 struct ValidatedResult {
     ValidatedResult(const Sailfish::Crypto::Result &r = Sailfish::Crypto::Result(),
                     Sailfish::Crypto::CryptoManager::VerificationStatus v = Sailfish::Crypto::CryptoManager::VerificationStatusUnknown)
@@ -67,6 +93,16 @@ struct ValidatedResult {
     Sailfish::Crypto::CryptoManager::VerificationStatus verificationStatus;
 };
 
+struct ValidatedListResult {
+    ValidatedListResult(const Sailfish::Crypto::Result &r = Sailfish::Crypto::Result(),
+                        const QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> &v = QVector<Sailfish::Crypto::CryptoManager::VerificationStatus>())
+        : result(r), verificationStatuses(v) {}
+    ValidatedListResult(const ValidatedListResult &other)
+        : result(other.result), verificationStatuses(other.verificationStatuses) {}
+    Sailfish::Crypto::Result result;
+    QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> verificationStatuses;
+};
+
 struct KeyResult {
     KeyResult(const Sailfish::Crypto::Result &r = Sailfish::Crypto::Result(),
               const Sailfish::Crypto::Key &k = Sailfish::Crypto::Key())
@@ -172,28 +208,36 @@ struct AuthDataAndTag {
     QByteArray tag;
 };
 
+// These are constructed on the main thread while a request is handled,
+// so they carry the trace context of that request to the plugin call.
 struct PluginAndCustomParams {
     PluginAndCustomParams(CryptoPlugin *p = Q_NULLPTR, const QVariantMap &cp = QVariantMap())
-        : plugin(p), customParameters(cp) {}
+        : plugin(p), customParameters(cp)
+        , traceContext(Sailfish::Secrets::Daemon::ApiImpl::Tracer::currentContext()) {}
     PluginAndCustomParams(const PluginAndCustomParams &other)
         : plugin(other.plugin)
-        , customParameters(other.customParameters) {}
+        , customParameters(other.customParameters)
+        , traceContext(other.traceContext) {}
     CryptoPlugin *plugin;
     QVariantMap customParameters;
+    Sailfish::Secrets::Daemon::ApiImpl::TraceContext traceContext;
 };
 
 struct PluginWrapperAndCustomParams {
     PluginWrapperAndCustomParams(CryptoPlugin *p = Q_NULLPTR,
                                  Daemon::ApiImpl::CryptoStoragePluginWrapper *w = Q_NULLPTR,
                                  const QVariantMap &cp = QVariantMap())
-        : plugin(p), wrapper(w), customParameters(cp) {}
+        : plugin(p), wrapper(w), customParameters(cp)
+        , traceContext(Sailfish::Secrets::Daemon::ApiImpl::Tracer::currentContext()) {}
     PluginWrapperAndCustomParams(const PluginWrapperAndCustomParams &other)
         : plugin(other.plugin)
         , wrapper(other.wrapper)
-        , customParameters(other.customParameters) {}
+        , customParameters(other.customParameters)
+        , traceContext(other.traceContext) {}
     CryptoPlugin *plugin;
     Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper;
     QVariantMap customParameters;
+    Sailfish::Secrets::Daemon::ApiImpl::TraceContext traceContext;
 };
 
 namespace Daemon {
@@ -278,6 +322,13 @@ ValidatedResult verify(
         const KeyAndCollectionKey &keyAndCollectionKey,
         const SignatureOptions &options);
 
+ValidatedListResult verifyBatch(
+        const PluginWrapperAndCustomParams &pluginAndCustomParams,
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Sailfish::Crypto::Key> &keys,
+        const SignatureOptions &options);
+
 TagDataResult encrypt(
         const PluginWrapperAndCustomParams &pluginAndCustomParams,
         const DataAndIV &dataAndIv,
@@ -292,6 +343,23 @@ VerifiedDataResult decrypt(
         const EncryptionOptions &options,
         const AuthDataAndTag &authDataAndTag);
 
+TagDataListResult encryptBatch(
+        const PluginWrapperAndCustomParams &pluginAndCustomParams,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const KeyAndCollectionKey &keyAndCollectionKey,
+        const EncryptionOptions &options,
+        const QVector<QByteArray> &authenticationData);
+
+VerifiedDataListResult decryptBatch(
+        const PluginWrapperAndCustomParams &pluginAndCustomParams,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const KeyAndCollectionKey &keyAndCollectionKey,
+        const EncryptionOptions &options,
+        const QVector<QByteArray> &authenticationData,
+        const QVector<QByteArray> &authenticationTags);
+
 CipherSessionTokenResult initializeCipherSession(
         const PluginWrapperAndCustomParams &pluginAndCustomParams,
         quint64 clientId,
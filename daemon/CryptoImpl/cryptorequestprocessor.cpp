@@ -26,10 +26,11 @@
 #include <QtCore/QPluginLoader>
 #include <QtCore/QObject>
 #include <QtCore/QCoreApplication>
-#include <QtCore/QFuture>
-#include <QtCore/QFutureWatcher>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 
-#include <QtConcurrent>
+#include <algorithm>
+#include <functional>
 
 namespace {
     void nullifyKeyFields(Sailfish::Crypto::Key *key, Sailfish::Crypto::Key::Components keep) {
@@ -61,6 +62,28 @@ namespace {
         }
     }
 
+    // Each element of a batch may be given its own parameter (such as an
+    // initialization vector), or the parameter may be omitted for all of them.
+    bool expandBatchParameters(QVector<QByteArray> *parameters, int count) {
+        if (parameters->isEmpty()) {
+            parameters->resize(count);
+            return true;
+        }
+        return parameters->size() == count;
+    }
+
+    // A key reference identifies a stored key, whose data must be read
+    // from storage before it can be used.
+    bool isKeyReference(const Sailfish::Crypto::Key &key) {
+        return key.publicKey().isEmpty()
+                && key.privateKey().isEmpty()
+                && key.secretKey().isEmpty();
+    }
+
+    // Batches smaller than this are not divided between threads, as the
+    // overhead of scheduling the tasks would outweigh the benefit.
+    const int MinimumVerifyBatchChunkSize = 16;
+
     class SecretsPromptText : public Sailfish::Secrets::InteractionParameters::PromptText
     {
     public:
@@ -111,76 +134,79 @@ Daemon::ApiImpl::RequestProcessor::plugins() const
     return m_cryptoPlugins;
 }
 
-LockCodeRequest::LockStatus Daemon::ApiImpl::RequestProcessor::queryLockStatusPlugin(
-        const QString &pluginName)
+void Daemon::ApiImpl::RequestProcessor::queryLockStatusPlugin(
+        const QString &pluginName,
+        const std::function<void (LockCodeRequest::LockStatus)> &completion)
 {
-    if (m_cryptoPlugins.contains(pluginName)) {
-        return LockCodeRequest::Unknown;
+    if (!m_cryptoPlugins.contains(pluginName)) {
+        completion(LockCodeRequest::Unknown);
+        return;
     } else if (!m_cryptoPlugins.value(pluginName)->supportsLocking()) {
-        return LockCodeRequest::Unsupported;
+        completion(LockCodeRequest::Unsupported);
+        return;
     }
 
-    QFuture<bool> future
-            = QtConcurrent::run(
-                    m_requestQueue->controller()->threadPoolForPlugin(pluginName).data(),
-                    CryptoPluginFunctionWrapper::isLocked,
-                    m_cryptoPlugins[pluginName]);
-    future.waitForFinished();
-    return future.result() ? LockCodeRequest::Locked : LockCodeRequest::Unlocked;
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(pluginName).data(),
+                std::bind(CryptoPluginFunctionWrapper::isLocked,
+                          m_cryptoPlugins[pluginName]),
+                [=] (bool locked) {
+        completion(locked ? LockCodeRequest::Locked : LockCodeRequest::Unlocked);
+    });
 }
 
-bool Daemon::ApiImpl::RequestProcessor::lockPlugin(
-        const QString &pluginName)
+void Daemon::ApiImpl::RequestProcessor::lockPlugin(
+        const QString &pluginName,
+        const std::function<void (bool)> &completion)
 {
-    if (m_cryptoPlugins.contains(pluginName)) {
-        return false;
+    if (!m_cryptoPlugins.contains(pluginName)) {
+        completion(false);
+        return;
     }
 
-    QFuture<bool> future
-            = QtConcurrent::run(
-                    m_requestQueue->controller()->threadPoolForPlugin(pluginName).data(),
-                    CryptoPluginFunctionWrapper::lock,
-                    m_cryptoPlugins[pluginName]);
-    future.waitForFinished();
-    return future.result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(pluginName).data(),
+                std::bind(CryptoPluginFunctionWrapper::lock,
+                          m_cryptoPlugins[pluginName]),
+                completion);
 }
 
-bool Daemon::ApiImpl::RequestProcessor::unlockPlugin(
+void Daemon::ApiImpl::RequestProcessor::unlockPlugin(
         const QString &pluginName,
-        const QByteArray &lockCode)
+        const QByteArray &lockCode,
+        const std::function<void (bool)> &completion)
 {
-    if (m_cryptoPlugins.contains(pluginName)) {
-        return false;
+    if (!m_cryptoPlugins.contains(pluginName)) {
+        completion(false);
+        return;
     }
 
-    QFuture<bool> future
-            = QtConcurrent::run(
-                    m_requestQueue->controller()->threadPoolForPlugin(pluginName).data(),
-                    CryptoPluginFunctionWrapper::unlock,
-                    m_cryptoPlugins[pluginName],
-                    lockCode);
-    future.waitForFinished();
-    return future.result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(pluginName).data(),
+                std::bind(CryptoPluginFunctionWrapper::unlock,
+                          m_cryptoPlugins[pluginName],
+                          lockCode),
+                completion);
 }
 
-bool Daemon::ApiImpl::RequestProcessor::setLockCodePlugin(
+void Daemon::ApiImpl::RequestProcessor::setLockCodePlugin(
         const QString &pluginName,
         const QByteArray &oldCode,
-        const QByteArray &newCode)
+        const QByteArray &newCode,
+        const std::function<void (bool)> &completion)
 {
-    if (m_cryptoPlugins.contains(pluginName)) {
-        return false;
+    if (!m_cryptoPlugins.contains(pluginName)) {
+        completion(false);
+        return;
     }
 
-    QFuture<bool> future
-            = QtConcurrent::run(
-                    m_requestQueue->controller()->threadPoolForPlugin(pluginName).data(),
-                    CryptoPluginFunctionWrapper::setLockCode,
-                    m_cryptoPlugins[pluginName],
-                    oldCode,
-                    newCode);
-    future.waitForFinished();
-    return future.result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(pluginName).data(),
+                std::bind(CryptoPluginFunctionWrapper::setLockCode,
+                          m_cryptoPlugins[pluginName],
+                          oldCode,
+                          newCode),
+                completion);
 }
 
 Result
@@ -190,35 +216,53 @@ Daemon::ApiImpl::RequestProcessor::getPluginInfo(
         QVector<PluginInfo> *cryptoPlugins,
         QVector<PluginInfo> *storagePlugins)
 {
-    QVector<Sailfish::Secrets::PluginInfo> storagePluginInfos;
-    Result retn(transformSecretsResult(m_secrets->storagePluginInfo(callerPid, requestId, &storagePluginInfos)));
-    if (retn.code() == Result::Failed) {
-        return retn;
-    }
-
-    for (const Sailfish::Secrets::PluginInfo &plugin : storagePluginInfos) {
-        storagePlugins->append(PluginInfo(plugin.displayName(),
-                                          plugin.name(),
-                                          plugin.version(),
-                                          static_cast<PluginInfo::StatusFlags>(
-                                              static_cast<int>(plugin.statusFlags()))));
-    }
+    Q_UNUSED(cryptoPlugins); // asynchronous out-parameter.
+    Q_UNUSED(storagePlugins); // asynchronous out-parameter.
 
     QList<Sailfish::Secrets::PluginBase*> cplugins;
     for (CryptoPlugin *plugin : m_cryptoPlugins.values()) {
         cplugins.append(plugin);
     }
-    const QMap<QString, Sailfish::Secrets::PluginInfo> cryptoPluginInfos
-            = m_requestQueue->controller()->pluginInfoForPlugins(cplugins, m_secrets->masterLocked());
-    for (const Sailfish::Secrets::PluginInfo &plugin : cryptoPluginInfos) {
-        cryptoPlugins->append(PluginInfo(plugin.displayName(),
-                                         plugin.name(),
-                                         plugin.version(),
-                                         static_cast<PluginInfo::StatusFlags>(
-                                             static_cast<int>(plugin.statusFlags()))));
+
+    // the storage plugin info is reported first, and then the crypto plugin info.
+    Sailfish::Secrets::Daemon::Controller *controller = m_requestQueue->controller();
+    const bool masterLocked = m_secrets->masterLocked();
+    Result retn(transformSecretsResult(m_secrets->storagePluginInfo(
+            callerPid, requestId,
+            [=] (const QVector<Sailfish::Secrets::PluginInfo> &storagePluginInfos) {
+        QVector<PluginInfo> storageInfos;
+        for (const Sailfish::Secrets::PluginInfo &plugin : storagePluginInfos) {
+            storageInfos.append(PluginInfo(plugin.displayName(),
+                                           plugin.name(),
+                                           plugin.version(),
+                                           static_cast<PluginInfo::StatusFlags>(
+                                               static_cast<int>(plugin.statusFlags()))));
+        }
+
+        controller->pluginInfoForPlugins(
+                    cplugins, masterLocked,
+                    [=] (const QMap<QString, Sailfish::Secrets::PluginInfo> &cryptoPluginInfos) {
+            QVector<PluginInfo> cryptoInfos;
+            for (const Sailfish::Secrets::PluginInfo &plugin : cryptoPluginInfos) {
+                cryptoInfos.append(PluginInfo(plugin.displayName(),
+                                              plugin.name(),
+                                              plugin.version(),
+                                              static_cast<PluginInfo::StatusFlags>(
+                                                  static_cast<int>(plugin.statusFlags()))));
+            }
+
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(Result(Result::Succeeded));
+            outParams << QVariant::fromValue<QVector<PluginInfo> >(cryptoInfos);
+            outParams << QVariant::fromValue<QVector<PluginInfo> >(storageInfos);
+            m_requestQueue->requestFinished(requestId, outParams);
+        });
+    })));
+    if (retn.code() == Result::Failed) {
+        return retn;
     }
 
-    return retn;
+    return Result(Result::Pending);
 }
 
 Result
@@ -239,24 +283,19 @@ Daemon::ApiImpl::RequestProcessor::generateRandomData(
                       QLatin1String("No such cryptographic service provider plugin exists"));
     }
 
-    QFutureWatcher<DataResult> *watcher = new QFutureWatcher<DataResult>(this);
-    QFuture<DataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::generateRandomData,
-                PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
-                static_cast<quint64>(callerPid),
-                csprngEngineName,
-                numberBytes);
-
-    connect(watcher, &QFutureWatcher<DataResult>::finished, [=] {
-        watcher->deleteLater();
-        DataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::generateRandomData,
+                          PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
+                          static_cast<quint64>(callerPid),
+                          csprngEngineName,
+                          numberBytes),
+                [=] (DataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -279,23 +318,19 @@ Daemon::ApiImpl::RequestProcessor::seedRandomDataGenerator(
                       QLatin1String("No such cryptographic service provider plugin exists"));
     }
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future = QtConcurrent::run(
+    m_taskExecutor.run(
                 m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::seedRandomDataGenerator,
-                PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
-                static_cast<quint64>(callerPid),
-                csprngEngineName,
-                seedData,
-                entropyEstimate);
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
+                std::bind(CryptoPluginFunctionWrapper::seedRandomDataGenerator,
+                          PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
+                          static_cast<quint64>(callerPid),
+                          csprngEngineName,
+                          seedData,
+                          entropyEstimate),
+                [=] (Result result) {
         QVariantList outParams;
-        outParams << QVariant::fromValue<Result>(watcher->future().result());
+        outParams << QVariant::fromValue<Result>(result);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -320,24 +355,19 @@ Daemon::ApiImpl::RequestProcessor::generateInitializationVector(
                       QLatin1String("No such cryptographic service provider plugin exists"));
     }
 
-    QFutureWatcher<DataResult> *watcher = new QFutureWatcher<DataResult>(this);
-    QFuture<DataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::generateInitializationVector,
-                PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
-                algorithm,
-                blockMode,
-                keySize);
-
-    connect(watcher, &QFutureWatcher<DataResult>::finished, [=] {
-        watcher->deleteLater();
-        DataResult vr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::generateInitializationVector,
+                          PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
+                          algorithm,
+                          blockMode,
+                          keySize),
+                [=] (DataResult vr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(vr.result);
         outParams << QVariant::fromValue<QByteArray>(vr.data);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -371,24 +401,19 @@ Daemon::ApiImpl::RequestProcessor::generateKey(
     // Thus, the key pair generation parameters or key derivation parameters
     // will be fully specified with input key data.
 
-    QFutureWatcher<KeyResult> *watcher = new QFutureWatcher<KeyResult>(this);
-    QFuture<KeyResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::generateKey,
-                PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
-                keyTemplate,
-                kpgParams,
-                skdfParams);
-
-    connect(watcher, &QFutureWatcher<KeyResult>::finished, [=] {
-        watcher->deleteLater();
-        KeyResult kr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::generateKey,
+                          PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
+                          keyTemplate,
+                          kpgParams,
+                          skdfParams),
+                [=] (KeyResult kr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(kr.result);
         outParams << QVariant::fromValue<Key>(kr.key);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -473,6 +498,10 @@ Daemon::ApiImpl::RequestProcessor::generateStoredKey_afterPreCheck(
         const Result &preCheckResult,
         const QByteArray &collectionDecryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     Result result(preCheckResult);
     if (result.code() == Result::Succeeded) {
         // check to see if we need a user interaction flow to get a passphrase/PIN.
@@ -557,6 +586,10 @@ Daemon::ApiImpl::RequestProcessor::generateStoredKey_withInputData(
         const QString &cryptosystemProviderName,
         const QByteArray &collectionDecryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     // This method is invoked after the user input has been retrieved
     // from the user, but before the key has been generated or stored.
     // If the user input was retrieved successfully, continue with
@@ -606,18 +639,14 @@ Daemon::ApiImpl::RequestProcessor::generateStoredKey_withKdfData(
                                          collectionDecryptionKey);
     } else {
         // generate the key, then store it separately in the storage plugin
-        QFutureWatcher<KeyResult> *watcher = new QFutureWatcher<KeyResult>(this);
-        QFuture<KeyResult> future = QtConcurrent::run(
-                    m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                    CryptoPluginFunctionWrapper::generateKey,
-                    PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
-                    keyTemplate,
-                    kpgParams,
-                    skdfParams);
-
-        connect(watcher, &QFutureWatcher<KeyResult>::finished, [=] {
-            watcher->deleteLater();
-            KeyResult kr = watcher->future().result();
+        m_taskExecutor.run(
+                    m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                    std::bind(CryptoPluginFunctionWrapper::generateKey,
+                              PluginAndCustomParams(m_cryptoPlugins[cryptosystemProviderName], customParameters),
+                              keyTemplate,
+                              kpgParams,
+                              skdfParams),
+                    [=] (KeyResult kr) {
             if (kr.result.code() == Result::Failed) {
                 QVariantList outParams;
                 outParams << QVariant::fromValue<Result>(kr.result);
@@ -646,7 +675,6 @@ Daemon::ApiImpl::RequestProcessor::generateStoredKey_withKdfData(
                 }
             }
         });
-        watcher->setFuture(future);
     }
 
     return Result(Result::Pending);
@@ -686,19 +714,15 @@ Daemon::ApiImpl::RequestProcessor::generateStoredKey_inCryptoPlugin(
     Q_UNUSED(requestId);
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptosystemProviderName));
-    QFutureWatcher<KeyResult> *watcher = new QFutureWatcher<KeyResult>(this);
-    QFuture<KeyResult> future = QtConcurrent::run(
+    m_taskExecutor.run(
                 m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::generateAndStoreKey,
-                PluginWrapperAndCustomParams(wrapper->cryptoPlugin(), wrapper, customParameters),
-                keyTemplate,
-                kpgParams,
-                skdfParams,
-                collectionDecryptionKey);
-
-    connect(watcher, &QFutureWatcher<KeyResult>::finished, [=] {
-        watcher->deleteLater();
-        KeyResult kr = watcher->future().result();
+                std::bind(CryptoPluginFunctionWrapper::generateAndStoreKey,
+                          PluginWrapperAndCustomParams(wrapper->cryptoPlugin(), wrapper, customParameters),
+                          keyTemplate,
+                          kpgParams,
+                          skdfParams,
+                          collectionDecryptionKey),
+                [=] (KeyResult kr) {
         Key partialKey(kr.key);
         partialKey.setPrivateKey(QByteArray());
         partialKey.setSecretKey(QByteArray());
@@ -707,7 +731,6 @@ Daemon::ApiImpl::RequestProcessor::generateStoredKey_inCryptoPlugin(
         outParams << QVariant::fromValue<Key>(partialKey);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 Result Daemon::ApiImpl::RequestProcessor::promptForKeyPassphrase(
@@ -773,18 +796,14 @@ Daemon::ApiImpl::RequestProcessor::importKey(
                       QLatin1String("No such cryptographic service provider plugin exists"));
     }
 
-    QFutureWatcher<KeyResult> *watcher = new QFutureWatcher<KeyResult>(this);
-    QFuture<KeyResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::importKey,
-                PluginAndCustomParams(m_cryptoPlugins.value(cryptosystemProviderName),
-                                      customParameters),
-                data,
-                passphrase);
-
-    connect(watcher, &QFutureWatcher<KeyResult>::finished, [=] {
-        watcher->deleteLater();
-        KeyResult kr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::importKey,
+                          PluginAndCustomParams(m_cryptoPlugins.value(cryptosystemProviderName),
+                                                customParameters),
+                          data,
+                          passphrase),
+                [=] (KeyResult kr) {
         Result result = kr.result;
         Key outputKey = kr.key;
         if (result.code() == Result::Failed
@@ -813,7 +832,6 @@ Daemon::ApiImpl::RequestProcessor::importKey(
             m_requestQueue->requestFinished(requestId, outParams);
         }
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -829,6 +847,10 @@ Daemon::ApiImpl::RequestProcessor::importKey_withPassphrase(
         const Result &result,
         const QByteArray &passphrase)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     Result retn = result;
     Key importedKey;
 
@@ -921,6 +943,10 @@ Daemon::ApiImpl::RequestProcessor::importStoredKey_afterPreCheck(
         const Result &preCheckResult,
         const QByteArray &collectionDecryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (preCheckResult.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(preCheckResult);
@@ -956,6 +982,10 @@ Daemon::ApiImpl::RequestProcessor::importStoredKey_withPassphrase(
         const Result &passphraseResult,
         const QByteArray &passphrase)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (passphraseResult.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(passphraseResult);
@@ -966,21 +996,17 @@ Daemon::ApiImpl::RequestProcessor::importStoredKey_withPassphrase(
 
     if (cryptosystemProviderName == keyTemplate.identifier().storagePluginName()) {
         Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptosystemProviderName));
-        QFutureWatcher<KeyResult> *watcher = new QFutureWatcher<KeyResult>(this);
-        QFuture<KeyResult> future = QtConcurrent::run(
+        m_taskExecutor.run(
                     m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                    CryptoPluginFunctionWrapper::importAndStoreKey,
-                    PluginWrapperAndCustomParams(wrapper->cryptoPlugin(),
-                                                 wrapper,
-                                                 customParameters),
-                    data,
-                    keyTemplate,
-                    passphrase,
-                    collectionDecryptionKey);
-
-        connect(watcher, &QFutureWatcher<KeyResult>::finished, [=] {
-            watcher->deleteLater();
-            KeyResult kr = watcher->future().result();
+                    std::bind(CryptoPluginFunctionWrapper::importAndStoreKey,
+                              PluginWrapperAndCustomParams(wrapper->cryptoPlugin(),
+                                                           wrapper,
+                                                           customParameters),
+                              data,
+                              keyTemplate,
+                              passphrase,
+                              collectionDecryptionKey),
+                    [=] (KeyResult kr) {
             Result outputResult = kr.result;
             Key outputKey = kr.key;
             if (outputResult.code() != Result::Failed) {
@@ -1007,20 +1033,15 @@ Daemon::ApiImpl::RequestProcessor::importStoredKey_withPassphrase(
                 m_requestQueue->requestFinished(requestId, outParams);
             }
         });
-        watcher->setFuture(future);
     } else {
-        QFutureWatcher<KeyResult> *watcher = new QFutureWatcher<KeyResult>(this);
-        QFuture<KeyResult> future = QtConcurrent::run(
-                    m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                    CryptoPluginFunctionWrapper::importKey,
-                    PluginAndCustomParams(m_cryptoPlugins.value(cryptosystemProviderName),
-                                          customParameters),
-                    data,
-                    passphrase);
-
-        connect(watcher, &QFutureWatcher<KeyResult>::finished, [=] {
-            watcher->deleteLater();
-            KeyResult kr = watcher->future().result();
+        m_taskExecutor.run(
+                    m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                    std::bind(CryptoPluginFunctionWrapper::importKey,
+                              PluginAndCustomParams(m_cryptoPlugins.value(cryptosystemProviderName),
+                                                    customParameters),
+                              data,
+                              passphrase),
+                    [=] (KeyResult kr) {
             Result result = kr.result;
             Key outputKey = kr.key;
             if (result.code() == Result::Failed
@@ -1064,7 +1085,6 @@ Daemon::ApiImpl::RequestProcessor::importStoredKey_withPassphrase(
                 m_requestQueue->requestFinished(requestId, outParams);
             }
         });
-        watcher->setFuture(future);
     }
 }
 
@@ -1107,24 +1127,19 @@ Daemon::ApiImpl::RequestProcessor::storedKey(
     }
 
     if (m_cryptoPlugins.contains(identifier.storagePluginName())) {
-        QFutureWatcher<KeyResult> *watcher = new QFutureWatcher<KeyResult>(this);
-        QFuture<KeyResult> future = QtConcurrent::run(
+        m_taskExecutor.run(
                     m_requestQueue->controller()->threadPoolForPlugin(identifier.storagePluginName()).data(),
-                    CryptoPluginFunctionWrapper::storedKey,
-                    m_cryptoPlugins[identifier.storagePluginName()],
-                    identifier,
-                    keyComponents,
-                    customParameters);
-
-        connect(watcher, &QFutureWatcher<KeyResult>::finished, [=] {
-            watcher->deleteLater();
-            KeyResult kr = watcher->future().result();
+                    std::bind(CryptoPluginFunctionWrapper::storedKey,
+                              m_cryptoPlugins[identifier.storagePluginName()],
+                              identifier,
+                              keyComponents,
+                              customParameters),
+                    [=] (KeyResult kr) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(kr.result);
             outParams << QVariant::fromValue<Key>(kr.key);
             m_requestQueue->requestFinished(requestId, outParams);
         });
-        watcher->setFuture(future);
 
         return Result(Result::Pending);
     }
@@ -1266,23 +1281,18 @@ Daemon::ApiImpl::RequestProcessor::calculateDigest(
                       QLatin1String("No such cryptographic service provider plugin exists"));
     }
 
-    QFutureWatcher<DataResult> *watcher = new QFutureWatcher<DataResult>(this);
-    QFuture<DataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::calculateDigest,
-                PluginAndCustomParams(cryptoPlugin, customParameters),
-                data,
-                SignatureOptions(padding, digestFunction));
-
-    connect(watcher, &QFutureWatcher<DataResult>::finished, [=] {
-        watcher->deleteLater();
-        DataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::calculateDigest,
+                          PluginAndCustomParams(cryptoPlugin, customParameters),
+                          data,
+                          SignatureOptions(padding, digestFunction)),
+                [=] (DataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -1383,24 +1393,19 @@ Daemon::ApiImpl::RequestProcessor::sign(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptosystemProviderName));
-    QFutureWatcher<DataResult> *watcher = new QFutureWatcher<DataResult>(this);
-    QFuture<DataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::sign,
-                PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
-                data,
-                KeyAndCollectionKey(fullKey, QByteArray()),
-                SignatureOptions(padding, digestFunction));
-
-    connect(watcher, &QFutureWatcher<DataResult>::finished, [=] {
-        watcher->deleteLater();
-        DataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::sign,
+                          PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
+                          data,
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          SignatureOptions(padding, digestFunction)),
+                [=] (DataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -1416,6 +1421,10 @@ Daemon::ApiImpl::RequestProcessor::sign_withKey(
         const QVariantMap &customParameters,
         const QString &cryptoPluginName)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
@@ -1425,24 +1434,19 @@ Daemon::ApiImpl::RequestProcessor::sign_withKey(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<DataResult> *watcher = new QFutureWatcher<DataResult>(this);
-    QFuture<DataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::sign,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                data,
-                KeyAndCollectionKey(Key::deserialize(serializedKey), QByteArray()),
-                SignatureOptions(padding, digestFunction));
-
-    connect(watcher, &QFutureWatcher<DataResult>::finished, [=] {
-        watcher->deleteLater();
-        DataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::sign,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          data,
+                          KeyAndCollectionKey(Key::deserialize(serializedKey), QByteArray()),
+                          SignatureOptions(padding, digestFunction)),
+                [=] (DataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 void
@@ -1457,6 +1461,10 @@ Daemon::ApiImpl::RequestProcessor::sign_withCollectionKey(
         const Result &result,
         const QByteArray &collectionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
@@ -1466,24 +1474,19 @@ Daemon::ApiImpl::RequestProcessor::sign_withCollectionKey(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<DataResult> *watcher = new QFutureWatcher<DataResult>(this);
-    QFuture<DataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::sign,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                data,
-                KeyAndCollectionKey(key, collectionKey),
-                SignatureOptions(padding, digestFunction));
-
-    connect(watcher, &QFutureWatcher<DataResult>::finished, [=] {
-        watcher->deleteLater();
-        DataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::sign,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          data,
+                          KeyAndCollectionKey(key, collectionKey),
+                          SignatureOptions(padding, digestFunction)),
+                [=] (DataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 Result
@@ -1585,25 +1588,20 @@ Daemon::ApiImpl::RequestProcessor::verify(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptosystemProviderName));
-    QFutureWatcher<ValidatedResult> *watcher = new QFutureWatcher<ValidatedResult>(this);
-    QFuture<ValidatedResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::verify,
-                PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
-                signature,
-                data,
-                KeyAndCollectionKey(fullKey, QByteArray()),
-                SignatureOptions(padding, digestFunction));
-
-    connect(watcher, &QFutureWatcher<ValidatedResult>::finished, [=] {
-        watcher->deleteLater();
-        ValidatedResult vr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::verify,
+                          PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
+                          signature,
+                          data,
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          SignatureOptions(padding, digestFunction)),
+                [=] (ValidatedResult vr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(vr.result);
         outParams << QVariant::fromValue<CryptoManager::VerificationStatus>(vr.verificationStatus);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -1620,6 +1618,10 @@ Daemon::ApiImpl::RequestProcessor::verify_withKey(
         const QVariantMap &customParameters,
         const QString &cryptoPluginName)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
@@ -1629,25 +1631,20 @@ Daemon::ApiImpl::RequestProcessor::verify_withKey(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<ValidatedResult> *watcher = new QFutureWatcher<ValidatedResult>(this);
-    QFuture<ValidatedResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::verify,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                signature,
-                data,
-                KeyAndCollectionKey(Key::deserialize(serializedKey), QByteArray()),
-                SignatureOptions(padding, digestFunction));
-
-    connect(watcher, &QFutureWatcher<ValidatedResult>::finished, [=] {
-        watcher->deleteLater();
-        ValidatedResult vr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::verify,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          signature,
+                          data,
+                          KeyAndCollectionKey(Key::deserialize(serializedKey), QByteArray()),
+                          SignatureOptions(padding, digestFunction)),
+                [=] (ValidatedResult vr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(vr.result);
         outParams << QVariant::fromValue<CryptoManager::VerificationStatus>(vr.verificationStatus);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 void
@@ -1663,6 +1660,10 @@ Daemon::ApiImpl::RequestProcessor::verify_withCollectionKey(
         const Result &result,
         const QByteArray &collectionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
@@ -1672,25 +1673,20 @@ Daemon::ApiImpl::RequestProcessor::verify_withCollectionKey(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<ValidatedResult> *watcher = new QFutureWatcher<ValidatedResult>(this);
-    QFuture<ValidatedResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::verify,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                signature,
-                data,
-                KeyAndCollectionKey(key, collectionKey),
-                SignatureOptions(padding, digestFunction));
-
-    connect(watcher, &QFutureWatcher<ValidatedResult>::finished, [=] {
-        watcher->deleteLater();
-        ValidatedResult vr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::verify,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          signature,
+                          data,
+                          KeyAndCollectionKey(key, collectionKey),
+                          SignatureOptions(padding, digestFunction)),
+                [=] (ValidatedResult vr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(vr.result);
         outParams << QVariant::fromValue<CryptoManager::VerificationStatus>(vr.verificationStatus);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 Result
@@ -1799,26 +1795,21 @@ Daemon::ApiImpl::RequestProcessor::encrypt(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptosystemProviderName));
-    QFutureWatcher<TagDataResult> *watcher = new QFutureWatcher<TagDataResult>(this);
-    QFuture<TagDataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::encrypt,
-                PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
-                DataAndIV(data, iv),
-                KeyAndCollectionKey(fullKey, QByteArray()),
-                EncryptionOptions(blockMode, padding),
-                authenticationData);
-
-    connect(watcher, &QFutureWatcher<TagDataResult>::finished, [=] {
-        watcher->deleteLater();
-        TagDataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::encrypt,
+                          PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
+                          DataAndIV(data, iv),
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          EncryptionOptions(blockMode, padding),
+                          authenticationData),
+                [=] (TagDataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         outParams << QVariant::fromValue<QByteArray>(dr.tag);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -1836,6 +1827,10 @@ Daemon::ApiImpl::RequestProcessor::encrypt_withKey(
         const QVariantMap &customParameters,
         const QString &cryptoPluginName)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
@@ -1858,26 +1853,21 @@ Daemon::ApiImpl::RequestProcessor::encrypt_withKey(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<TagDataResult> *watcher = new QFutureWatcher<TagDataResult>(this);
-    QFuture<TagDataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::encrypt,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                DataAndIV(data, iv),
-                KeyAndCollectionKey(fullKey, QByteArray()),
-                EncryptionOptions(blockMode, padding),
-                authenticationData);
-
-    connect(watcher, &QFutureWatcher<TagDataResult>::finished, [=] {
-        watcher->deleteLater();
-        TagDataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::encrypt,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          DataAndIV(data, iv),
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          EncryptionOptions(blockMode, padding),
+                          authenticationData),
+                [=] (TagDataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         outParams << QVariant::fromValue<QByteArray>(dr.tag);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 
@@ -1895,6 +1885,10 @@ Daemon::ApiImpl::RequestProcessor::encrypt_withCollectionKey(
         const Result &result,
         const QByteArray &collectionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
@@ -1905,26 +1899,21 @@ Daemon::ApiImpl::RequestProcessor::encrypt_withCollectionKey(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<TagDataResult> *watcher = new QFutureWatcher<TagDataResult>(this);
-    QFuture<TagDataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::encrypt,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                DataAndIV(data, iv),
-                KeyAndCollectionKey(key, collectionKey),
-                EncryptionOptions(blockMode, padding),
-                authenticationData);
-
-    connect(watcher, &QFutureWatcher<TagDataResult>::finished, [=] {
-        watcher->deleteLater();
-        TagDataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::encrypt,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          DataAndIV(data, iv),
+                          KeyAndCollectionKey(key, collectionKey),
+                          EncryptionOptions(blockMode, padding),
+                          authenticationData),
+                [=] (TagDataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         outParams << QVariant::fromValue<QByteArray>(dr.tag);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 Sailfish::Crypto::Result
@@ -2036,26 +2025,21 @@ Daemon::ApiImpl::RequestProcessor::decrypt(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptosystemProviderName));
-    QFutureWatcher<VerifiedDataResult> *watcher = new QFutureWatcher<VerifiedDataResult>(this);
-    QFuture<VerifiedDataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::decrypt,
-                PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
-                DataAndIV(data, iv),
-                KeyAndCollectionKey(fullKey, QByteArray()),
-                EncryptionOptions(blockMode, padding),
-                AuthDataAndTag(authenticationData, authenticationTag));
-
-    connect(watcher, &QFutureWatcher<VerifiedDataResult>::finished, [=] {
-        watcher->deleteLater();
-        VerifiedDataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::decrypt,
+                          PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
+                          DataAndIV(data, iv),
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          EncryptionOptions(blockMode, padding),
+                          AuthDataAndTag(authenticationData, authenticationTag)),
+                [=] (VerifiedDataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         outParams << QVariant::fromValue<CryptoManager::VerificationStatus>(dr.verificationStatus);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -2074,6 +2058,10 @@ Daemon::ApiImpl::RequestProcessor::decrypt_withKey(
         const QVariantMap &customParameters,
         const QString &cryptoPluginName)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
@@ -2084,26 +2072,21 @@ Daemon::ApiImpl::RequestProcessor::decrypt_withKey(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<VerifiedDataResult> *watcher = new QFutureWatcher<VerifiedDataResult>(this);
-    QFuture<VerifiedDataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::decrypt,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                DataAndIV(data, iv),
-                KeyAndCollectionKey(Key::deserialize(serializedKey), QByteArray()),
-                EncryptionOptions(blockMode, padding),
-                AuthDataAndTag(authenticationData, authenticationTag));
-
-    connect(watcher, &QFutureWatcher<VerifiedDataResult>::finished, [=] {
-        watcher->deleteLater();
-        VerifiedDataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::decrypt,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          DataAndIV(data, iv),
+                          KeyAndCollectionKey(Key::deserialize(serializedKey), QByteArray()),
+                          EncryptionOptions(blockMode, padding),
+                          AuthDataAndTag(authenticationData, authenticationTag)),
+                [=] (VerifiedDataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         outParams << QVariant::fromValue<CryptoManager::VerificationStatus>(dr.verificationStatus);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 void
@@ -2121,6 +2104,10 @@ Daemon::ApiImpl::RequestProcessor::decrypt_withCollectionKey(
         const Result &result,
         const QByteArray &collectionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
@@ -2131,45 +2118,41 @@ Daemon::ApiImpl::RequestProcessor::decrypt_withCollectionKey(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<VerifiedDataResult> *watcher = new QFutureWatcher<VerifiedDataResult>(this);
-    QFuture<VerifiedDataResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::decrypt,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                DataAndIV(data, iv),
-                KeyAndCollectionKey(key, collectionKey),
-                EncryptionOptions(blockMode, padding),
-                AuthDataAndTag(authenticationData, authenticationTag));
-
-    connect(watcher, &QFutureWatcher<VerifiedDataResult>::finished, [=] {
-        watcher->deleteLater();
-        VerifiedDataResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::decrypt,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          DataAndIV(data, iv),
+                          KeyAndCollectionKey(key, collectionKey),
+                          EncryptionOptions(blockMode, padding),
+                          AuthDataAndTag(authenticationData, authenticationTag)),
+                [=] (VerifiedDataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         outParams << QVariant::fromValue<CryptoManager::VerificationStatus>(dr.verificationStatus);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::initializeCipherSession(
+Daemon::ApiImpl::RequestProcessor::encryptBatch(
         pid_t callerPid,
         quint64 requestId,
-        const QByteArray &iv,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
         const Key &key,
-        CryptoManager::Operation operation,
         CryptoManager::BlockMode blockMode,
-        CryptoManager::EncryptionPadding encryptionPadding,
-        CryptoManager::SignaturePadding signaturePadding,
-        CryptoManager::DigestFunction digestFunction,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
         const QVariantMap &customParameters,
         const QString &cryptosystemProviderName,
-        quint32 *cipherSessionToken)
+        QVector<QByteArray> *encrypted,
+        QVector<QByteArray> *authenticationTags)
 {
     // TODO: Access Control
-    Q_UNUSED(cipherSessionToken); // asynchronous out-param.
+    Q_UNUSED(encrypted); // asynchronous out-param.
+    Q_UNUSED(authenticationTags); // asynchronous out-param.
 
     CryptoPlugin* cryptoPlugin = m_cryptoPlugins.value(cryptosystemProviderName);
     if (cryptoPlugin == Q_NULLPTR) {
@@ -2177,8 +2160,21 @@ Daemon::ApiImpl::RequestProcessor::initializeCipherSession(
                       QLatin1String("No such cryptographic service provider plugin exists"));
     }
 
+    QVector<QByteArray> batchIvs(ivs);
+    QVector<QByteArray> batchAuthenticationData(authenticationData);
+    if (data.isEmpty()) {
+        return Result(Result::EmptyDataError,
+                      QLatin1String("No data given to encrypt"));
+    } else if (!expandBatchParameters(&batchIvs, data.size())) {
+        return Result(Result::InvalidInitializationVectorError,
+                      QLatin1String("The number of initialization vectors does not match the number of data"));
+    } else if (!expandBatchParameters(&batchAuthenticationData, data.size())) {
+        return Result(Result::OperationNotSupportedError,
+                      QLatin1String("The number of authentication data does not match the number of data"));
+    }
+
     Key fullKey;
-    if (key.privateKey().isEmpty() && key.secretKey().isEmpty()) {
+    if (key.publicKey().isEmpty() && key.privateKey().isEmpty() && key.secretKey().isEmpty()) { // can use public key to encrypt
         // the key is a key reference, we may need to read the full key from storage.
         if (key.identifier().name().isEmpty()) {
             return Result(Result::InvalidKeyIdentifier,
@@ -2195,60 +2191,56 @@ Daemon::ApiImpl::RequestProcessor::initializeCipherSession(
                           QLatin1String("Unknown storage plugin name specified in key reference identifier"));
         }
 
-        // find out if the key is stored in the crypto plugin.
-        // if so, we don't need to pull it into the daemon process address space.
+        // the key is resolved once, and then used for every element of the batch.
         if (key.identifier().storagePluginName() == cryptosystemProviderName) {
-            // yes, it is stored in the plugin.
-            // it may be that the collection the key is stored in is locked,
-            // and if so, we need to retrieve the collection key to unlock it.
+            // it is stored in the plugin, whose collection may need to be unlocked.
             Result retn = transformSecretsResult(m_secrets->useKeyPreCheck(callerPid,
                                                                            requestId,
                                                                            key.identifier(),
-                                                                           operation,
+                                                                           CryptoManager::OperationEncrypt,
                                                                            cryptosystemProviderName));
             if (retn.code() == Result::Failed) {
                 return retn;
             }
 
-            // asynchronous flow required, will call back to initializeCipherSession_withCollectionKey().
+            // asynchronous flow required, will call back to encryptBatch_withCollectionKey().
             m_pendingRequests.insert(requestId,
                                      Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                          callerPid,
                                          requestId,
-                                         Daemon::ApiImpl::InitializeCipherSessionRequest,
-                                         QVariantList() << QVariant::fromValue<QByteArray>(iv)
+                                         Daemon::ApiImpl::EncryptBatchRequest,
+                                         QVariantList() << QVariant::fromValue<QVector<QByteArray> >(data)
+                                                        << QVariant::fromValue<QVector<QByteArray> >(batchIvs)
                                                         << QVariant::fromValue<Key>(key)
-                                                        << QVariant::fromValue<CryptoManager::Operation>(operation)
                                                         << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
-                                                        << QVariant::fromValue<CryptoManager::EncryptionPadding>(encryptionPadding)
-                                                        << QVariant::fromValue<CryptoManager::SignaturePadding>(signaturePadding)
-                                                        << QVariant::fromValue<CryptoManager::DigestFunction>(digestFunction)
+                                                        << QVariant::fromValue<CryptoManager::EncryptionPadding>(padding)
+                                                        << QVariant::fromValue<QVector<QByteArray> >(batchAuthenticationData)
                                                         << QVariant::fromValue<QVariantMap>(customParameters)
                                                         << QVariant::fromValue<QString>(cryptosystemProviderName)));
             return retn;
         } else {
-            // no, it is stored in some other plugin
+            // it is stored in some other plugin
             QByteArray serializedKey;
             QMap<QString, QString> filterData;
             Result retn = transformSecretsResult(m_secrets->storedKey(callerPid, requestId, key.identifier(), &serializedKey, &filterData));
             if (retn.code() == Result::Failed) {
                 return retn;
             } else if (retn.code() == Result::Pending) {
-                // asynchronous flow required, will call back to initializeCipherSession_withKey().
+                // asynchronous flow required, will call back to encryptBatch_withKey().
+                QVariantList args;
+                args << QVariant::fromValue<QVector<QByteArray> >(data)
+                     << QVariant::fromValue<QVector<QByteArray> >(batchIvs)
+                     << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
+                     << QVariant::fromValue<CryptoManager::EncryptionPadding>(padding)
+                     << QVariant::fromValue<QVector<QByteArray> >(batchAuthenticationData)
+                     << QVariant::fromValue<QVariantMap>(customParameters)
+                     << QVariant::fromValue<QString>(cryptosystemProviderName);
                 m_pendingRequests.insert(requestId,
                                          Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                              callerPid,
                                              requestId,
-                                             Daemon::ApiImpl::InitializeCipherSessionRequest,
-                                             QVariantList() << QVariant::fromValue<pid_t>(callerPid)
-                                                            << QVariant::fromValue<QByteArray>(iv)
-                                                            << QVariant::fromValue<CryptoManager::Operation>(operation)
-                                                            << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
-                                                            << QVariant::fromValue<CryptoManager::EncryptionPadding>(encryptionPadding)
-                                                            << QVariant::fromValue<CryptoManager::SignaturePadding>(signaturePadding)
-                                                            << QVariant::fromValue<CryptoManager::DigestFunction>(digestFunction)
-                                                            << QVariant::fromValue<QVariantMap>(customParameters)
-                                                            << QVariant::fromValue<QString>(cryptosystemProviderName)));
+                                             Daemon::ApiImpl::EncryptBatchRequest,
+                                             args));
                 return retn;
             }
 
@@ -2259,145 +2251,148 @@ Daemon::ApiImpl::RequestProcessor::initializeCipherSession(
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptosystemProviderName));
-    QFutureWatcher<CipherSessionTokenResult> *watcher = new QFutureWatcher<CipherSessionTokenResult>(this);
-    QFuture<CipherSessionTokenResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::initializeCipherSession,
-                PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
-                callerPid,
-                iv,
-                KeyAndCollectionKey(fullKey, QByteArray()),
-                CipherSessionOptions(
-                    operation,
-                    blockMode,
-                    encryptionPadding,
-                    signaturePadding,
-                    digestFunction));
-
-    connect(watcher, &QFutureWatcher<CipherSessionTokenResult>::finished, [=] {
-        watcher->deleteLater();
-        CipherSessionTokenResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::encryptBatch,
+                          PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
+                          data,
+                          batchIvs,
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          EncryptionOptions(blockMode, padding),
+                          batchAuthenticationData),
+                [=] (TagDataListResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
-        outParams << QVariant::fromValue<quint32>(dr.cipherSessionToken);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(dr.data);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(dr.tags);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
 
 void
-Daemon::ApiImpl::RequestProcessor::initializeCipherSession_withKey(
+Daemon::ApiImpl::RequestProcessor::encryptBatch_withKey(
         quint64 requestId,
         const Result &result,
         const QByteArray &serializedKey,
-        pid_t callerPid,
-        const QByteArray &iv,
-        CryptoManager::Operation operation,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
         CryptoManager::BlockMode blockMode,
-        CryptoManager::EncryptionPadding encryptionPadding,
-        CryptoManager::SignaturePadding signaturePadding,
-        CryptoManager::DigestFunction digestFunction,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
         const QVariantMap &customParameters,
         const QString &cryptoPluginName)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
-        outParams << QVariant::fromValue<quint32>(0);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(QVector<QByteArray>());
+        outParams << QVariant::fromValue<QVector<QByteArray> >(QVector<QByteArray>());
+        m_requestQueue->requestFinished(requestId, outParams);
+        return;
+    }
+
+    bool ok = false;
+    Key fullKey = Key::deserialize(serializedKey, &ok);
+    if (!ok) {
+        QList<QVariant> outParams;
+        outParams << QVariant::fromValue<Result>(Result(Result::SerializationError,
+                                                        QLatin1String("Failed to deserialize key!")));
+        outParams << QVariant::fromValue<QVector<QByteArray> >(QVector<QByteArray>());
+        outParams << QVariant::fromValue<QVector<QByteArray> >(QVector<QByteArray>());
         m_requestQueue->requestFinished(requestId, outParams);
         return;
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<CipherSessionTokenResult> *watcher = new QFutureWatcher<CipherSessionTokenResult>(this);
-    QFuture<CipherSessionTokenResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::initializeCipherSession,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                callerPid,
-                iv,
-                KeyAndCollectionKey(Key::deserialize(serializedKey), QByteArray()),
-                CipherSessionOptions(
-                    operation,
-                    blockMode,
-                    encryptionPadding,
-                    signaturePadding,
-                    digestFunction));
-
-    connect(watcher, &QFutureWatcher<CipherSessionTokenResult>::finished, [=] {
-        watcher->deleteLater();
-        CipherSessionTokenResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::encryptBatch,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          data,
+                          ivs,
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          EncryptionOptions(blockMode, padding),
+                          authenticationData),
+                [=] (TagDataListResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
-        outParams << QVariant::fromValue<quint32>(dr.cipherSessionToken);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(dr.data);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(dr.tags);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 void
-Daemon::ApiImpl::RequestProcessor::initializeCipherSession_withCollectionKey(
+Daemon::ApiImpl::RequestProcessor::encryptBatch_withCollectionKey(
         quint64 requestId,
-        pid_t callerPid,
-        const QByteArray &iv,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
         const Key &key,
-        CryptoManager::Operation operation,
         CryptoManager::BlockMode blockMode,
-        CryptoManager::EncryptionPadding encryptionPadding,
-        CryptoManager::SignaturePadding signaturePadding,
-        CryptoManager::DigestFunction digestFunction,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
         const QVariantMap &customParameters,
         const QString &cryptoPluginName,
         const Result &result,
         const QByteArray &collectionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     if (result.code() != Result::Succeeded) {
         QList<QVariant> outParams;
         outParams << QVariant::fromValue<Result>(result);
-        outParams << QVariant::fromValue<quint32>(0);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(QVector<QByteArray>());
+        outParams << QVariant::fromValue<QVector<QByteArray> >(QVector<QByteArray>());
         m_requestQueue->requestFinished(requestId, outParams);
         return;
     }
 
     Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
-    QFutureWatcher<CipherSessionTokenResult> *watcher = new QFutureWatcher<CipherSessionTokenResult>(this);
-    QFuture<CipherSessionTokenResult> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
-                CryptoPluginFunctionWrapper::initializeCipherSession,
-                PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
-                callerPid,
-                iv,
-                KeyAndCollectionKey(key, collectionKey),
-                CipherSessionOptions(
-                    operation,
-                    blockMode,
-                    encryptionPadding,
-                    signaturePadding,
-                    digestFunction));
-
-    connect(watcher, &QFutureWatcher<CipherSessionTokenResult>::finished, [=] {
-        watcher->deleteLater();
-        CipherSessionTokenResult dr = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::encryptBatch,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          data,
+                          ivs,
+                          KeyAndCollectionKey(key, collectionKey),
+                          EncryptionOptions(blockMode, padding),
+                          authenticationData),
+                [=] (TagDataListResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
-        outParams << QVariant::fromValue<quint32>(dr.cipherSessionToken);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(dr.data);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(dr.tags);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::updateCipherSessionAuthentication(
+Daemon::ApiImpl::RequestProcessor::decryptBatch(
         pid_t callerPid,
         quint64 requestId,
-        const QByteArray &authenticationData,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Key &key,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVector<QByteArray> &authenticationTags,
         const QVariantMap &customParameters,
         const QString &cryptosystemProviderName,
-        quint32 cipherSessionToken)
+        QVector<QByteArray> *decrypted,
+        QVector<CryptoManager::VerificationStatus> *verificationStatuses)
 {
-    Q_UNUSED(requestId); // TODO: Access Control
+    // TODO: Access Control
+    Q_UNUSED(decrypted); // asynchronous out-param.
+    Q_UNUSED(verificationStatuses); // asynchronous out-param.
 
     CryptoPlugin* cryptoPlugin = m_cryptoPlugins.value(cryptosystemProviderName);
     if (cryptoPlugin == Q_NULLPTR) {
@@ -2405,33 +2400,738 @@ Daemon::ApiImpl::RequestProcessor::updateCipherSessionAuthentication(
                       QLatin1String("No such cryptographic service provider plugin exists"));
     }
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future = QtConcurrent::run(
-                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::updateCipherSessionAuthentication,
-                PluginAndCustomParams(cryptoPlugin, customParameters),
-                callerPid,
-                authenticationData,
-                cipherSessionToken);
+    QVector<QByteArray> batchIvs(ivs);
+    QVector<QByteArray> batchAuthenticationData(authenticationData);
+    QVector<QByteArray> batchAuthenticationTags(authenticationTags);
+    if (data.isEmpty()) {
+        return Result(Result::EmptyDataError,
+                      QLatin1String("No data given to decrypt"));
+    } else if (!expandBatchParameters(&batchIvs, data.size())) {
+        return Result(Result::InvalidInitializationVectorError,
+                      QLatin1String("The number of initialization vectors does not match the number of data"));
+    } else if (!expandBatchParameters(&batchAuthenticationData, data.size())) {
+        return Result(Result::OperationNotSupportedError,
+                      QLatin1String("The number of authentication data does not match the number of data"));
+    } else if (!expandBatchParameters(&batchAuthenticationTags, data.size())) {
+        return Result(Result::InvalidAuthenticationTagError,
+                      QLatin1String("The number of authentication tags does not match the number of data"));
+    }
 
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        QVariantList outParams;
-        outParams << QVariant::fromValue<Result>(watcher->future().result());
-        m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
+    Key fullKey;
+    if (key.privateKey().isEmpty() && key.secretKey().isEmpty()) {
+        // the key is a key reference, we may need to read the full key from storage.
+        if (key.identifier().name().isEmpty()) {
+            return Result(Result::InvalidKeyIdentifier,
+                          QLatin1String("Empty key name given in key reference identifier"));
+        } else if (key.identifier().collectionName().isEmpty()) {
+            return Result(Result::InvalidKeyIdentifier,
+                          QLatin1String("Empty collection name given in key reference identifier"));
+        } else if (key.identifier().storagePluginName().isEmpty()) {
+            return Result(Result::InvalidKeyIdentifier,
+                          QLatin1String("Empty storage plugin name given in key reference identifier"));
+        } else if (!m_secrets->encryptedStoragePluginNames().contains(key.identifier().storagePluginName())
+                   && !m_secrets->storagePluginNames().contains(key.identifier().storagePluginName())) {
+            return Result(Result::InvalidStorageProvider,
+                          QLatin1String("Unknown storage plugin name specified in key reference identifier"));
+        }
 
-    return Result(Result::Pending);
-}
+        // the key is resolved once, and then used for every element of the batch.
+        if (key.identifier().storagePluginName() == cryptosystemProviderName) {
+            // it is stored in the plugin, whose collection may need to be unlocked.
+            Result retn = transformSecretsResult(m_secrets->useKeyPreCheck(callerPid,
+                                                                           requestId,
+                                                                           key.identifier(),
+                                                                           CryptoManager::OperationDecrypt,
+                                                                           cryptosystemProviderName));
+            if (retn.code() == Result::Failed) {
+                return retn;
+            }
 
-Result
-Daemon::ApiImpl::RequestProcessor::updateCipherSession(
-        pid_t callerPid,
-        quint64 requestId,
-        const QByteArray &data,
-        const QVariantMap &customParameters,
-        const QString &cryptosystemProviderName,
+            // asynchronous flow required, will call back to decryptBatch_withCollectionKey().
+            m_pendingRequests.insert(requestId,
+                                     Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                         callerPid,
+                                         requestId,
+                                         Daemon::ApiImpl::DecryptBatchRequest,
+                                         QVariantList() << QVariant::fromValue<QVector<QByteArray> >(data)
+                                                        << QVariant::fromValue<QVector<QByteArray> >(batchIvs)
+                                                        << QVariant::fromValue<Key>(key)
+                                                        << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
+                                                        << QVariant::fromValue<CryptoManager::EncryptionPadding>(padding)
+                                                        << QVariant::fromValue<QVector<QByteArray> >(batchAuthenticationData)
+                                                        << QVariant::fromValue<QVector<QByteArray> >(batchAuthenticationTags)
+                                                        << QVariant::fromValue<QVariantMap>(customParameters)
+                                                        << QVariant::fromValue<QString>(cryptosystemProviderName)));
+            return retn;
+        } else {
+            // it is stored in some other plugin
+            QByteArray serializedKey;
+            QMap<QString, QString> filterData;
+            Result retn = transformSecretsResult(m_secrets->storedKey(callerPid, requestId, key.identifier(), &serializedKey, &filterData));
+            if (retn.code() == Result::Failed) {
+                return retn;
+            } else if (retn.code() == Result::Pending) {
+                // asynchronous flow required, will call back to decryptBatch_withKey().
+                QVariantList args;
+                args << QVariant::fromValue<QVector<QByteArray> >(data)
+                     << QVariant::fromValue<QVector<QByteArray> >(batchIvs)
+                     << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
+                     << QVariant::fromValue<CryptoManager::EncryptionPadding>(padding)
+                     << QVariant::fromValue<QVector<QByteArray> >(batchAuthenticationData)
+                     << QVariant::fromValue<QVector<QByteArray> >(batchAuthenticationTags)
+                     << QVariant::fromValue<QVariantMap>(customParameters)
+                     << QVariant::fromValue<QString>(cryptosystemProviderName);
+                m_pendingRequests.insert(requestId,
+                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                             callerPid,
+                                             requestId,
+                                             Daemon::ApiImpl::DecryptBatchRequest,
+                                             args));
+                return retn;
+            }
+
+            fullKey = Key::deserialize(serializedKey);
+        }
+    } else {
+        fullKey = key;
+    }
+
+    Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptosystemProviderName));
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::decryptBatch,
+                          PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
+                          data,
+                          batchIvs,
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          EncryptionOptions(blockMode, padding),
+                          batchAuthenticationData,
+                          batchAuthenticationTags),
+                [=] (VerifiedDataListResult dr) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(dr.result);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(dr.data);
+        outParams << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(dr.verificationStatuses);
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
+
+    return Result(Result::Pending);
+}
+
+void
+Daemon::ApiImpl::RequestProcessor::decryptBatch_withKey(
+        quint64 requestId,
+        const Result &result,
+        const QByteArray &serializedKey,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVector<QByteArray> &authenticationTags,
+        const QVariantMap &customParameters,
+        const QString &cryptoPluginName)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    if (result.code() != Result::Succeeded) {
+        QList<QVariant> outParams;
+        outParams << QVariant::fromValue<Result>(result);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(QVector<QByteArray>());
+        outParams << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(QVector<CryptoManager::VerificationStatus>());
+        m_requestQueue->requestFinished(requestId, outParams);
+        return;
+    }
+
+    bool ok = false;
+    Key fullKey = Key::deserialize(serializedKey, &ok);
+    if (!ok) {
+        QList<QVariant> outParams;
+        outParams << QVariant::fromValue<Result>(Result(Result::SerializationError,
+                                                        QLatin1String("Failed to deserialize key!")));
+        outParams << QVariant::fromValue<QVector<QByteArray> >(QVector<QByteArray>());
+        outParams << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(QVector<CryptoManager::VerificationStatus>());
+        m_requestQueue->requestFinished(requestId, outParams);
+        return;
+    }
+
+    Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::decryptBatch,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          data,
+                          ivs,
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          EncryptionOptions(blockMode, padding),
+                          authenticationData,
+                          authenticationTags),
+                [=] (VerifiedDataListResult dr) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(dr.result);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(dr.data);
+        outParams << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(dr.verificationStatuses);
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
+}
+
+void
+Daemon::ApiImpl::RequestProcessor::decryptBatch_withCollectionKey(
+        quint64 requestId,
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Key &key,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVector<QByteArray> &authenticationTags,
+        const QVariantMap &customParameters,
+        const QString &cryptoPluginName,
+        const Result &result,
+        const QByteArray &collectionKey)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    if (result.code() != Result::Succeeded) {
+        QList<QVariant> outParams;
+        outParams << QVariant::fromValue<Result>(result);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(QVector<QByteArray>());
+        outParams << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(QVector<CryptoManager::VerificationStatus>());
+        m_requestQueue->requestFinished(requestId, outParams);
+        return;
+    }
+
+    Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).data(),
+                std::bind(CryptoPluginFunctionWrapper::decryptBatch,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          data,
+                          ivs,
+                          KeyAndCollectionKey(key, collectionKey),
+                          EncryptionOptions(blockMode, padding),
+                          authenticationData,
+                          authenticationTags),
+                [=] (VerifiedDataListResult dr) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(dr.result);
+        outParams << QVariant::fromValue<QVector<QByteArray> >(dr.data);
+        outParams << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(dr.verificationStatuses);
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::verifyBatch(
+        pid_t callerPid,
+        quint64 requestId,
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Key> &keys,
+        CryptoManager::SignaturePadding padding,
+        CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName,
+        QVector<CryptoManager::VerificationStatus> *verificationStatuses)
+{
+    // TODO: Access Control
+    Q_UNUSED(verificationStatuses); // asynchronous out-param.
+
+    if (!m_cryptoPlugins.contains(cryptosystemProviderName)) {
+        return Result(Result::InvalidCryptographicServiceProvider,
+                      QLatin1String("No such cryptographic service provider plugin exists"));
+    }
+
+    QVector<Key> batchKeys(keys);
+    if (data.isEmpty()) {
+        return Result(Result::EmptyDataError,
+                      QLatin1String("No data given to verify"));
+    } else if (signatures.size() != data.size()) {
+        return Result(Result::EmptySignatureError,
+                      QLatin1String("The number of signatures does not match the number of data"));
+    } else if (batchKeys.size() == 1) {
+        // the same key is used to verify every signature.
+        batchKeys.fill(keys.first(), data.size());
+    } else if (batchKeys.size() != data.size()) {
+        return Result(Result::EmptyPublicKeyError,
+                      QLatin1String("The number of keys does not match the number of data"));
+    }
+
+    for (const Key &key : keys) {
+        if (isKeyReference(key)) {
+            if (key.identifier().name().isEmpty()) {
+                return Result(Result::InvalidKeyIdentifier,
+                              QLatin1String("Empty key name given in key reference identifier"));
+            } else if (key.identifier().collectionName().isEmpty()) {
+                return Result(Result::InvalidKeyIdentifier,
+                              QLatin1String("Empty collection name given in key reference identifier"));
+            } else if (key.identifier().storagePluginName().isEmpty()) {
+                return Result(Result::InvalidKeyIdentifier,
+                              QLatin1String("Empty storage plugin name given in key reference identifier"));
+            } else if (!m_secrets->encryptedStoragePluginNames().contains(key.identifier().storagePluginName())
+                       && !m_secrets->storagePluginNames().contains(key.identifier().storagePluginName())) {
+                return Result(Result::InvalidStorageProvider,
+                              QLatin1String("Unknown storage plugin name specified in key reference identifier"));
+            }
+        }
+    }
+
+    return verifyBatch_withKeys(callerPid, requestId, signatures, data, batchKeys,
+                                padding, digestFunction, customParameters,
+                                cryptosystemProviderName);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::verifyBatch_withKeys(
+        pid_t callerPid,
+        quint64 requestId,
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Key> &keys,
+        CryptoManager::SignaturePadding padding,
+        CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        const QString &cryptoPluginName)
+{
+    // Each distinct key reference is read from storage once, in turn,
+    // and then used for every signature which refers to it.
+    QVector<Key> fullKeys(keys);
+    for (int i = 0; i < fullKeys.size(); ++i) {
+        const Key key(fullKeys.at(i));
+        if (!isKeyReference(key)) {
+            continue;
+        }
+
+        const Key::Identifier identifier(key.identifier());
+        if (m_cryptoPlugins.contains(identifier.storagePluginName())) {
+            // the key is stored in a crypto plugin, which can return its public key.
+            m_taskExecutor.run(
+                        m_requestQueue->controller()->threadPoolForPlugin(identifier.storagePluginName()).data(),
+                        std::bind(CryptoPluginFunctionWrapper::storedKey,
+                                  m_cryptoPlugins[identifier.storagePluginName()],
+                                  identifier,
+                                  Key::PublicKeyData,
+                                  customParameters),
+                        [=] (KeyResult kr) {
+                verifyBatch_withKey(callerPid, requestId, kr.result, identifier, kr.key,
+                                    signatures, data, fullKeys,
+                                    padding, digestFunction, customParameters,
+                                    cryptoPluginName);
+            });
+            return Result(Result::Pending);
+        }
+
+        QByteArray serializedKey;
+        QMap<QString, QString> filterData;
+        Result retn = transformSecretsResult(m_secrets->storedKey(callerPid, requestId, identifier, &serializedKey, &filterData));
+        if (retn.code() == Result::Failed) {
+            return retn;
+        } else if (retn.code() == Result::Pending) {
+            // asynchronous flow required, will call back to verifyBatch_withKey().
+            QVariantList args;
+            args << QVariant::fromValue<Key::Identifier>(identifier)
+                 << QVariant::fromValue<QVector<QByteArray> >(signatures)
+                 << QVariant::fromValue<QVector<QByteArray> >(data)
+                 << QVariant::fromValue<QVector<Key> >(fullKeys)
+                 << QVariant::fromValue<CryptoManager::SignaturePadding>(padding)
+                 << QVariant::fromValue<CryptoManager::DigestFunction>(digestFunction)
+                 << QVariant::fromValue<QVariantMap>(customParameters)
+                 << QVariant::fromValue<QString>(cryptoPluginName);
+            m_pendingRequests.insert(requestId,
+                                     Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                         callerPid,
+                                         requestId,
+                                         Daemon::ApiImpl::VerifyBatchRequest,
+                                         args));
+            return retn;
+        }
+
+        const Key resolvedKey(Key::deserialize(serializedKey));
+        if (resolvedKey.publicKey().isEmpty()) {
+            return Result(Result::EmptyPublicKeyError,
+                          QLatin1String("The stored key has no public key with which to verify"));
+        }
+        for (Key &fullKey : fullKeys) {
+            if (isKeyReference(fullKey) && fullKey.identifier() == identifier) {
+                fullKey = resolvedKey;
+            }
+        }
+    }
+
+    // Every key is now available, so the signatures can be verified.
+    // If the plugin can be used concurrently, the batch is divided into
+    // chunks which are verified in parallel, and otherwise it is verified
+    // by a single task.
+    QSharedPointer<QThreadPool> threadPool = m_requestQueue->controller()->threadPoolForPlugin(
+                cryptoPluginName, Sailfish::Secrets::Daemon::Controller::StatelessPluginOperation).toStrongRef();
+    if (threadPool.isNull()) {
+        return Result(Result::InvalidCryptographicServiceProvider,
+                      QLatin1String("No such cryptographic service provider plugin exists"));
+    }
+
+    const int count = data.size();
+    const int chunks = qBound(1, count / MinimumVerifyBatchChunkSize, threadPool->maxThreadCount());
+    QSharedPointer<Result> result(new Result(Result::Succeeded));
+    QSharedPointer<QVector<CryptoManager::VerificationStatus> > verificationStatuses(
+                new QVector<CryptoManager::VerificationStatus>(count));
+    QSharedPointer<int> remaining(new int(chunks));
+
+    Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        const int begin = count * chunk / chunks;
+        const int length = count * (chunk + 1) / chunks - begin;
+        m_taskExecutor.run(
+                    threadPool.data(),
+                    std::bind(CryptoPluginFunctionWrapper::verifyBatch,
+                              PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                              signatures.mid(begin, length),
+                              data.mid(begin, length),
+                              fullKeys.mid(begin, length),
+                              SignatureOptions(padding, digestFunction)),
+                    [=] (ValidatedListResult vr) {
+            if (vr.result.code() != Result::Succeeded) {
+                if (result->code() == Result::Succeeded) {
+                    *result = vr.result;
+                }
+            } else {
+                std::copy(vr.verificationStatuses.constBegin(),
+                          vr.verificationStatuses.constEnd(),
+                          verificationStatuses->begin() + begin);
+            }
+
+            if (--(*remaining) == 0) {
+                QVariantList outParams;
+                outParams << QVariant::fromValue<Result>(*result);
+                outParams << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(
+                                 result->code() == Result::Succeeded
+                                         ? *verificationStatuses
+                                         : QVector<CryptoManager::VerificationStatus>());
+                m_requestQueue->requestFinished(requestId, outParams);
+            }
+        });
+    }
+
+    return Result(Result::Pending);
+}
+
+void
+Daemon::ApiImpl::RequestProcessor::verifyBatch_withKey(
+        pid_t callerPid,
+        quint64 requestId,
+        const Result &result,
+        const Key::Identifier &identifier,
+        const Key &key,
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Key> &keys,
+        CryptoManager::SignaturePadding padding,
+        CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        const QString &cryptoPluginName)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    Result retn(result);
+    if (retn.code() == Result::Succeeded && key.publicKey().isEmpty()) {
+        retn = Result(Result::EmptyPublicKeyError,
+                      QLatin1String("The stored key has no public key with which to verify"));
+    }
+
+    if (retn.code() == Result::Succeeded) {
+        QVector<Key> fullKeys(keys);
+        for (Key &fullKey : fullKeys) {
+            if (isKeyReference(fullKey) && fullKey.identifier() == identifier) {
+                fullKey = key;
+            }
+        }
+
+        retn = verifyBatch_withKeys(callerPid, requestId, signatures, data, fullKeys,
+                                    padding, digestFunction, customParameters,
+                                    cryptoPluginName);
+    }
+
+    if (retn.code() != Result::Pending) {
+        QList<QVariant> outParams;
+        outParams << QVariant::fromValue<Result>(retn);
+        outParams << QVariant::fromValue<QVector<CryptoManager::VerificationStatus> >(QVector<CryptoManager::VerificationStatus>());
+        m_requestQueue->requestFinished(requestId, outParams);
+    }
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::initializeCipherSession(
+        pid_t callerPid,
+        quint64 requestId,
+        const QByteArray &iv,
+        const Key &key,
+        CryptoManager::Operation operation,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding encryptionPadding,
+        CryptoManager::SignaturePadding signaturePadding,
+        CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName,
+        quint32 *cipherSessionToken)
+{
+    // TODO: Access Control
+    Q_UNUSED(cipherSessionToken); // asynchronous out-param.
+
+    CryptoPlugin* cryptoPlugin = m_cryptoPlugins.value(cryptosystemProviderName);
+    if (cryptoPlugin == Q_NULLPTR) {
+        return Result(Result::InvalidCryptographicServiceProvider,
+                      QLatin1String("No such cryptographic service provider plugin exists"));
+    }
+
+    Key fullKey;
+    if (key.privateKey().isEmpty() && key.secretKey().isEmpty()) {
+        // the key is a key reference, we may need to read the full key from storage.
+        if (key.identifier().name().isEmpty()) {
+            return Result(Result::InvalidKeyIdentifier,
+                          QLatin1String("Empty key name given in key reference identifier"));
+        } else if (key.identifier().collectionName().isEmpty()) {
+            return Result(Result::InvalidKeyIdentifier,
+                          QLatin1String("Empty collection name given in key reference identifier"));
+        } else if (key.identifier().storagePluginName().isEmpty()) {
+            return Result(Result::InvalidKeyIdentifier,
+                          QLatin1String("Empty storage plugin name given in key reference identifier"));
+        } else if (!m_secrets->encryptedStoragePluginNames().contains(key.identifier().storagePluginName())
+                   && !m_secrets->storagePluginNames().contains(key.identifier().storagePluginName())) {
+            return Result(Result::InvalidStorageProvider,
+                          QLatin1String("Unknown storage plugin name specified in key reference identifier"));
+        }
+
+        // find out if the key is stored in the crypto plugin.
+        // if so, we don't need to pull it into the daemon process address space.
+        if (key.identifier().storagePluginName() == cryptosystemProviderName) {
+            // yes, it is stored in the plugin.
+            // it may be that the collection the key is stored in is locked,
+            // and if so, we need to retrieve the collection key to unlock it.
+            Result retn = transformSecretsResult(m_secrets->useKeyPreCheck(callerPid,
+                                                                           requestId,
+                                                                           key.identifier(),
+                                                                           operation,
+                                                                           cryptosystemProviderName));
+            if (retn.code() == Result::Failed) {
+                return retn;
+            }
+
+            // asynchronous flow required, will call back to initializeCipherSession_withCollectionKey().
+            m_pendingRequests.insert(requestId,
+                                     Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                         callerPid,
+                                         requestId,
+                                         Daemon::ApiImpl::InitializeCipherSessionRequest,
+                                         QVariantList() << QVariant::fromValue<QByteArray>(iv)
+                                                        << QVariant::fromValue<Key>(key)
+                                                        << QVariant::fromValue<CryptoManager::Operation>(operation)
+                                                        << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
+                                                        << QVariant::fromValue<CryptoManager::EncryptionPadding>(encryptionPadding)
+                                                        << QVariant::fromValue<CryptoManager::SignaturePadding>(signaturePadding)
+                                                        << QVariant::fromValue<CryptoManager::DigestFunction>(digestFunction)
+                                                        << QVariant::fromValue<QVariantMap>(customParameters)
+                                                        << QVariant::fromValue<QString>(cryptosystemProviderName)));
+            return retn;
+        } else {
+            // no, it is stored in some other plugin
+            QByteArray serializedKey;
+            QMap<QString, QString> filterData;
+            Result retn = transformSecretsResult(m_secrets->storedKey(callerPid, requestId, key.identifier(), &serializedKey, &filterData));
+            if (retn.code() == Result::Failed) {
+                return retn;
+            } else if (retn.code() == Result::Pending) {
+                // asynchronous flow required, will call back to initializeCipherSession_withKey().
+                m_pendingRequests.insert(requestId,
+                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                             callerPid,
+                                             requestId,
+                                             Daemon::ApiImpl::InitializeCipherSessionRequest,
+                                             QVariantList() << QVariant::fromValue<pid_t>(callerPid)
+                                                            << QVariant::fromValue<QByteArray>(iv)
+                                                            << QVariant::fromValue<CryptoManager::Operation>(operation)
+                                                            << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
+                                                            << QVariant::fromValue<CryptoManager::EncryptionPadding>(encryptionPadding)
+                                                            << QVariant::fromValue<CryptoManager::SignaturePadding>(signaturePadding)
+                                                            << QVariant::fromValue<CryptoManager::DigestFunction>(digestFunction)
+                                                            << QVariant::fromValue<QVariantMap>(customParameters)
+                                                            << QVariant::fromValue<QString>(cryptosystemProviderName)));
+                return retn;
+            }
+
+            fullKey = Key::deserialize(serializedKey);
+        }
+    } else {
+        fullKey = key;
+    }
+
+    Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptosystemProviderName));
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
+                std::bind(CryptoPluginFunctionWrapper::initializeCipherSession,
+                          PluginWrapperAndCustomParams(cryptoPlugin, wrapper, customParameters),
+                          callerPid,
+                          iv,
+                          KeyAndCollectionKey(fullKey, QByteArray()),
+                          CipherSessionOptions(
+                              operation,
+                              blockMode,
+                              encryptionPadding,
+                              signaturePadding,
+                              digestFunction)),
+                [=] (CipherSessionTokenResult dr) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(dr.result);
+        outParams << QVariant::fromValue<quint32>(dr.cipherSessionToken);
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
+
+    return Result(Result::Pending);
+}
+
+void
+Daemon::ApiImpl::RequestProcessor::initializeCipherSession_withKey(
+        quint64 requestId,
+        const Result &result,
+        const QByteArray &serializedKey,
+        pid_t callerPid,
+        const QByteArray &iv,
+        CryptoManager::Operation operation,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding encryptionPadding,
+        CryptoManager::SignaturePadding signaturePadding,
+        CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        const QString &cryptoPluginName)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    if (result.code() != Result::Succeeded) {
+        QList<QVariant> outParams;
+        outParams << QVariant::fromValue<Result>(result);
+        outParams << QVariant::fromValue<quint32>(0);
+        m_requestQueue->requestFinished(requestId, outParams);
+        return;
+    }
+
+    Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
+                std::bind(CryptoPluginFunctionWrapper::initializeCipherSession,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          callerPid,
+                          iv,
+                          KeyAndCollectionKey(Key::deserialize(serializedKey), QByteArray()),
+                          CipherSessionOptions(
+                              operation,
+                              blockMode,
+                              encryptionPadding,
+                              signaturePadding,
+                              digestFunction)),
+                [=] (CipherSessionTokenResult dr) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(dr.result);
+        outParams << QVariant::fromValue<quint32>(dr.cipherSessionToken);
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
+}
+
+void
+Daemon::ApiImpl::RequestProcessor::initializeCipherSession_withCollectionKey(
+        quint64 requestId,
+        pid_t callerPid,
+        const QByteArray &iv,
+        const Key &key,
+        CryptoManager::Operation operation,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding encryptionPadding,
+        CryptoManager::SignaturePadding signaturePadding,
+        CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        const QString &cryptoPluginName,
+        const Result &result,
+        const QByteArray &collectionKey)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    if (result.code() != Result::Succeeded) {
+        QList<QVariant> outParams;
+        outParams << QVariant::fromValue<Result>(result);
+        outParams << QVariant::fromValue<quint32>(0);
+        m_requestQueue->requestFinished(requestId, outParams);
+        return;
+    }
+
+    Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(m_secrets->cryptoStoragePluginWrapper(cryptoPluginName));
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptoPluginName).data(),
+                std::bind(CryptoPluginFunctionWrapper::initializeCipherSession,
+                          PluginWrapperAndCustomParams(m_cryptoPlugins[cryptoPluginName], wrapper, customParameters),
+                          callerPid,
+                          iv,
+                          KeyAndCollectionKey(key, collectionKey),
+                          CipherSessionOptions(
+                              operation,
+                              blockMode,
+                              encryptionPadding,
+                              signaturePadding,
+                              digestFunction)),
+                [=] (CipherSessionTokenResult dr) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(dr.result);
+        outParams << QVariant::fromValue<quint32>(dr.cipherSessionToken);
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::updateCipherSessionAuthentication(
+        pid_t callerPid,
+        quint64 requestId,
+        const QByteArray &authenticationData,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName,
+        quint32 cipherSessionToken)
+{
+    Q_UNUSED(requestId); // TODO: Access Control
+
+    CryptoPlugin* cryptoPlugin = m_cryptoPlugins.value(cryptosystemProviderName);
+    if (cryptoPlugin == Q_NULLPTR) {
+        return Result(Result::InvalidCryptographicServiceProvider,
+                      QLatin1String("No such cryptographic service provider plugin exists"));
+    }
+
+    m_taskExecutor.run(
+                m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
+                std::bind(CryptoPluginFunctionWrapper::updateCipherSessionAuthentication,
+                          PluginAndCustomParams(cryptoPlugin, customParameters),
+                          callerPid,
+                          authenticationData,
+                          cipherSessionToken),
+                [=] (Result result) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(result);
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
+
+    return Result(Result::Pending);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::updateCipherSession(
+        pid_t callerPid,
+        quint64 requestId,
+        const QByteArray &data,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName,
         quint32 cipherSessionToken,
         QByteArray *generatedData)
 {
@@ -2444,24 +3144,19 @@ Daemon::ApiImpl::RequestProcessor::updateCipherSession(
                       QLatin1String("No such cryptographic service provider plugin exists"));
     }
 
-    QFutureWatcher<DataResult> *watcher = new QFutureWatcher<DataResult>(this);
-    QFuture<DataResult> future = QtConcurrent::run(
+    m_taskExecutor.run(
                 m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::updateCipherSession,
-                PluginAndCustomParams(cryptoPlugin, customParameters),
-                callerPid,
-                data,
-                cipherSessionToken);
-
-    connect(watcher, &QFutureWatcher<DataResult>::finished, [=] {
-        watcher->deleteLater();
-        DataResult dr = watcher->future().result();
+                std::bind(CryptoPluginFunctionWrapper::updateCipherSession,
+                          PluginAndCustomParams(cryptoPlugin, customParameters),
+                          callerPid,
+                          data,
+                          cipherSessionToken),
+                [=] (DataResult dr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(dr.result);
         outParams << QVariant::fromValue<QByteArray>(dr.data);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -2487,25 +3182,20 @@ Daemon::ApiImpl::RequestProcessor::finalizeCipherSession(
                       QLatin1String("No such cryptographic service provider plugin exists"));
     }
 
-    QFutureWatcher<VerifiedDataResult> *watcher = new QFutureWatcher<VerifiedDataResult>(this);
-    QFuture<VerifiedDataResult> future = QtConcurrent::run(
+    m_taskExecutor.run(
                 m_requestQueue->controller()->threadPoolForPlugin(cryptosystemProviderName).data(),
-                CryptoPluginFunctionWrapper::finalizeCipherSession,
-                PluginAndCustomParams(cryptoPlugin, customParameters),
-                callerPid,
-                data,
-                cipherSessionToken);
-
-    connect(watcher, &QFutureWatcher<VerifiedDataResult>::finished, [=] {
-        watcher->deleteLater();
-        VerifiedDataResult vdr = watcher->future().result();
+                std::bind(CryptoPluginFunctionWrapper::finalizeCipherSession,
+                          PluginAndCustomParams(cryptoPlugin, customParameters),
+                          callerPid,
+                          data,
+                          cipherSessionToken),
+                [=] (VerifiedDataResult vdr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(vdr.result);
         outParams << QVariant::fromValue<QByteArray>(vdr.data);
         outParams << QVariant::fromValue<CryptoManager::VerificationStatus>(vdr.verificationStatus);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 
     return Result(Result::Pending);
 }
@@ -2737,6 +3427,41 @@ void Daemon::ApiImpl::RequestProcessor::secretsStoredKeyCompleted(
                 decrypt_withKey(requestId, returnResult, serializedKey, data, iv, blockMode, padding, authenticationData, authenticationTag, customParameters, cryptoPluginName);
                 break;
             }
+            case EncryptBatchRequest: {
+                QVector<QByteArray> data = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVector<QByteArray> ivs = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                CryptoManager::BlockMode blockMode = pr.parameters.takeFirst().value<CryptoManager::BlockMode>();
+                CryptoManager::EncryptionPadding padding = pr.parameters.takeFirst().value<CryptoManager::EncryptionPadding>();
+                QVector<QByteArray> authenticationData = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVariantMap customParameters = pr.parameters.takeFirst().value<QVariantMap>();
+                QString cryptoPluginName = pr.parameters.takeFirst().value<QString>();
+                encryptBatch_withKey(requestId, returnResult, serializedKey, data, ivs, blockMode, padding, authenticationData, customParameters, cryptoPluginName);
+                break;
+            }
+            case DecryptBatchRequest: {
+                QVector<QByteArray> data = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVector<QByteArray> ivs = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                CryptoManager::BlockMode blockMode = pr.parameters.takeFirst().value<CryptoManager::BlockMode>();
+                CryptoManager::EncryptionPadding padding = pr.parameters.takeFirst().value<CryptoManager::EncryptionPadding>();
+                QVector<QByteArray> authenticationData = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVector<QByteArray> authenticationTags = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVariantMap customParameters = pr.parameters.takeFirst().value<QVariantMap>();
+                QString cryptoPluginName = pr.parameters.takeFirst().value<QString>();
+                decryptBatch_withKey(requestId, returnResult, serializedKey, data, ivs, blockMode, padding, authenticationData, authenticationTags, customParameters, cryptoPluginName);
+                break;
+            }
+            case VerifyBatchRequest: {
+                Key::Identifier identifier = pr.parameters.takeFirst().value<Key::Identifier>();
+                QVector<QByteArray> signatures = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVector<QByteArray> data = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVector<Key> keys = pr.parameters.takeFirst().value<QVector<Key> >();
+                CryptoManager::SignaturePadding padding = pr.parameters.takeFirst().value<CryptoManager::SignaturePadding>();
+                CryptoManager::DigestFunction digestFunction = pr.parameters.takeFirst().value<CryptoManager::DigestFunction>();
+                QVariantMap customParameters = pr.parameters.takeFirst().value<QVariantMap>();
+                QString cryptoPluginName = pr.parameters.takeFirst().value<QString>();
+                verifyBatch_withKey(pr.callerPid, requestId, returnResult, identifier, Key::deserialize(serializedKey), signatures, data, keys, padding, digestFunction, customParameters, cryptoPluginName);
+                break;
+            }
             case InitializeCipherSessionRequest: {
                 pid_t callerPid = pr.parameters.takeFirst().value<pid_t>();
                 QByteArray iv = pr.parameters.takeFirst().value<QByteArray>();
@@ -2861,6 +3586,52 @@ void Daemon::ApiImpl::RequestProcessor::secretsUseKeyPreCheckCompleted(
                                           collectionDecryptionKey);
                 break;
             }
+            case EncryptBatchRequest: {
+                QVector<QByteArray> data = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVector<QByteArray> ivs = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                Key key = pr.parameters.takeFirst().value<Key>();
+                CryptoManager::BlockMode blockMode = pr.parameters.takeFirst().value<CryptoManager::BlockMode>();
+                CryptoManager::EncryptionPadding padding = pr.parameters.takeFirst().value<CryptoManager::EncryptionPadding>();
+                QVector<QByteArray> authenticationData = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVariantMap customParameters = pr.parameters.takeFirst().value<QVariantMap>();
+                QString cryptosystemProviderName = pr.parameters.takeFirst().value<QString>();
+                encryptBatch_withCollectionKey(requestId,
+                                               data,
+                                               ivs,
+                                               key,
+                                               blockMode,
+                                               padding,
+                                               authenticationData,
+                                               customParameters,
+                                               cryptosystemProviderName,
+                                               returnResult,
+                                               collectionDecryptionKey);
+                break;
+            }
+            case DecryptBatchRequest: {
+                QVector<QByteArray> data = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVector<QByteArray> ivs = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                Key key = pr.parameters.takeFirst().value<Key>();
+                CryptoManager::BlockMode blockMode = pr.parameters.takeFirst().value<CryptoManager::BlockMode>();
+                CryptoManager::EncryptionPadding padding = pr.parameters.takeFirst().value<CryptoManager::EncryptionPadding>();
+                QVector<QByteArray> authenticationData = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVector<QByteArray> authenticationTags = pr.parameters.takeFirst().value<QVector<QByteArray> >();
+                QVariantMap customParameters = pr.parameters.takeFirst().value<QVariantMap>();
+                QString cryptosystemProviderName = pr.parameters.takeFirst().value<QString>();
+                decryptBatch_withCollectionKey(requestId,
+                                               data,
+                                               ivs,
+                                               key,
+                                               blockMode,
+                                               padding,
+                                               authenticationData,
+                                               authenticationTags,
+                                               customParameters,
+                                               cryptosystemProviderName,
+                                               returnResult,
+                                               collectionDecryptionKey);
+                break;
+            }
             case InitializeCipherSessionRequest: {
                 QByteArray iv = pr.parameters.takeFirst().value<QByteArray>();
                 Key key = pr.parameters.takeFirst().value<Key>();
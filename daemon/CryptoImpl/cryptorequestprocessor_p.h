@@ -26,6 +26,7 @@
 #include "Secrets/lockcoderequest.h"
 
 #include "requestqueue_p.h"
+#include "taskexecutor_p.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QVariantList>
@@ -39,6 +40,8 @@
 
 #include <sys/types.h>
 
+#include <functional>
+
 namespace Sailfish {
 
 namespace Secrets {
@@ -70,10 +73,10 @@ public:
                      Sailfish::Crypto::Daemon::ApiImpl::CryptoRequestQueue *parent = Q_NULLPTR);
 
     QMap<QString, Sailfish::Crypto::CryptoPlugin*> plugins() const;
-    Sailfish::Crypto::LockCodeRequest::LockStatus queryLockStatusPlugin(const QString &pluginName);
-    bool lockPlugin(const QString &pluginName);
-    bool unlockPlugin(const QString &pluginName, const QByteArray &lockCode);
-    bool setLockCodePlugin(const QString &pluginName, const QByteArray &oldCode, const QByteArray &newCode);
+    void queryLockStatusPlugin(const QString &pluginName, const std::function<void (Sailfish::Crypto::LockCodeRequest::LockStatus)> &completion);
+    void lockPlugin(const QString &pluginName, const std::function<void (bool)> &completion);
+    void unlockPlugin(const QString &pluginName, const QByteArray &lockCode, const std::function<void (bool)> &completion);
+    void setLockCodePlugin(const QString &pluginName, const QByteArray &oldCode, const QByteArray &newCode, const std::function<void (bool)> &completion);
 
     Sailfish::Crypto::Result getPluginInfo(
             pid_t callerPid,
@@ -233,6 +236,47 @@ public:
             QByteArray *decrypted,
             Sailfish::Crypto::CryptoManager::VerificationStatus *verificationStatus);
 
+    Sailfish::Crypto::Result encryptBatch(
+            pid_t callerPid,
+            quint64 requestId,
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVariantMap &customParameters,
+            const QString &cryptosystemProviderName,
+            QVector<QByteArray> *encrypted,
+            QVector<QByteArray> *authenticationTags);
+
+    Sailfish::Crypto::Result decryptBatch(
+            pid_t callerPid,
+            quint64 requestId,
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVector<QByteArray> &authenticationTags,
+            const QVariantMap &customParameters,
+            const QString &cryptosystemProviderName,
+            QVector<QByteArray> *decrypted,
+            QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses);
+
+    Sailfish::Crypto::Result verifyBatch(
+            pid_t callerPid,
+            quint64 requestId,
+            const QVector<QByteArray> &signatures,
+            const QVector<QByteArray> &data,
+            const QVector<Sailfish::Crypto::Key> &keys,
+            Sailfish::Crypto::CryptoManager::SignaturePadding padding,
+            Sailfish::Crypto::CryptoManager::DigestFunction digestFunction,
+            const QVariantMap &customParameters,
+            const QString &cryptosystemProviderName,
+            QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses);
+
     Sailfish::Crypto::Result initializeCipherSession(
             pid_t callerPid,
             quint64 requestId,
@@ -571,6 +615,83 @@ private:
             const Sailfish::Crypto::Result &result,
             const QByteArray &collectionKey);
 
+    void encryptBatch_withKey(
+            quint64 requestId,
+            const Sailfish::Crypto::Result &result,
+            const QByteArray &serializedKey,
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVariantMap &customParameters,
+            const QString &cryptoPluginName);
+
+    void encryptBatch_withCollectionKey(
+            quint64 requestId,
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVariantMap &customParameters,
+            const QString &cryptoPluginName,
+            const Sailfish::Crypto::Result &result,
+            const QByteArray &collectionKey);
+
+    void decryptBatch_withKey(
+            quint64 requestId,
+            const Sailfish::Crypto::Result &result,
+            const QByteArray &serializedKey,
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVector<QByteArray> &authenticationTags,
+            const QVariantMap &customParameters,
+            const QString &cryptoPluginName);
+
+    void decryptBatch_withCollectionKey(
+            quint64 requestId,
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVector<QByteArray> &authenticationTags,
+            const QVariantMap &customParameters,
+            const QString &cryptoPluginName,
+            const Sailfish::Crypto::Result &result,
+            const QByteArray &collectionKey);
+
+    Sailfish::Crypto::Result verifyBatch_withKeys(
+            pid_t callerPid,
+            quint64 requestId,
+            const QVector<QByteArray> &signatures,
+            const QVector<QByteArray> &data,
+            const QVector<Sailfish::Crypto::Key> &keys,
+            Sailfish::Crypto::CryptoManager::SignaturePadding padding,
+            Sailfish::Crypto::CryptoManager::DigestFunction digestFunction,
+            const QVariantMap &customParameters,
+            const QString &cryptoPluginName);
+
+    void verifyBatch_withKey(
+            pid_t callerPid,
+            quint64 requestId,
+            const Sailfish::Crypto::Result &result,
+            const Sailfish::Crypto::Key::Identifier &identifier,
+            const Sailfish::Crypto::Key &key,
+            const QVector<QByteArray> &signatures,
+            const QVector<QByteArray> &data,
+            const QVector<Sailfish::Crypto::Key> &keys,
+            Sailfish::Crypto::CryptoManager::SignaturePadding padding,
+            Sailfish::Crypto::CryptoManager::DigestFunction digestFunction,
+            const QVariantMap &customParameters,
+            const QString &cryptoPluginName);
+
     void initializeCipherSession_withKey(
             quint64 requestId,
             const Sailfish::Crypto::Result &result,
@@ -605,6 +726,7 @@ private:
     Sailfish::Secrets::Daemon::ApiImpl::SecretsRequestQueue *m_secrets;
     QMap<QString, Sailfish::Crypto::CryptoPlugin*> m_cryptoPlugins;
     QMap<quint64, Sailfish::Crypto::Daemon::ApiImpl::RequestProcessor::PendingRequest> m_pendingRequests;
+    Sailfish::Secrets::Daemon::ApiImpl::TaskExecutor m_taskExecutor;
     bool m_autotestMode;
 };
 
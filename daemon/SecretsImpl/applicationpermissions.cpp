@@ -93,19 +93,39 @@ namespace {
             return QString();
         }
 
-        QByteArray contents;
-        char data;
-        while (file.read(&data, 1)) {
-            if (data == '\0') {
-                data = ' ';
-            }
-            contents.append(data);
-        }
+        QByteArray contents(file.readAll());
+        contents.replace('\0', ' ');
 
         const QString retn(QString::fromUtf8(contents).trimmed());
         qCDebug(lcSailfishSecretsDaemon) << "caller with pid" << pid << "has cmdline applicationId:" << retn;
         return retn;
     }
+
+    QString resolveApplicationId(pid_t pid)
+    {
+        QString retn = readBoosterCgroup(pid);
+        if (retn.isEmpty()) {
+            retn = readExeSymlink(pid);
+        }
+        if (retn.isEmpty()) {
+            retn = readCmdline(pid);
+        }
+        if (retn.isEmpty()) {
+            qCWarning(lcSailfishSecretsDaemon) << "Unable to determine application id for process" << pid;
+        }
+        return retn;
+    }
+
+    bool resolveIsPlatformApplication(pid_t pid)
+    {
+        // TODO: implement a real ACL?  This implementation just checks that the pid is privileged egid.
+        QFileInfo info(QString("/proc/%1").arg(pid));
+        if (info.group() != "privileged" && info.group() != "disk" && info.owner() != "root") {
+            return false;
+        }
+
+        return true;
+    }
 }
 
 QString Sailfish::Secrets::Daemon::ApiImpl::ApplicationPermissions::applicationId(pid_t pid) const
@@ -115,38 +135,40 @@ QString Sailfish::Secrets::Daemon::ApiImpl::ApplicationPermissions::applicationI
         return platformApplicationId();
     }
 
-    const QString cgroupName = readBoosterCgroup(pid);
-    if (!cgroupName.isEmpty()) {
-        return cgroupName;
-    }
-
-    const QString linkName = readExeSymlink(pid);
-    if (!linkName.isEmpty()) {
-        return linkName;
-    }
-
-    const QString cmdLine = readCmdline(pid);
-    if (!cmdLine.isEmpty()) {
-        return cmdLine;
-    }
-
-    qCWarning(lcSailfishSecretsDaemon) << "Unable to determine application id for process" << pid;
-    return QString();
+    QHash<pid_t, ClientIdentity>::const_iterator it = m_clients.constFind(pid);
+    return it != m_clients.constEnd() ? it->applicationId : resolveApplicationId(pid);
 }
 
 bool Sailfish::Secrets::Daemon::ApiImpl::ApplicationPermissions::applicationIsPlatformApplication(pid_t pid) const
 {
-    // TODO: implement a real ACL?  This implementation just checks that the pid is privileged egid.
-
     if (pid == 0) {
         qCDebug(lcSailfishSecretsDaemon) << "zero pid, assuming privileged!";
         return true;
     }
 
-    QFileInfo info(QString("/proc/%1").arg(pid));
-    if (info.group() != "privileged" && info.group() != "disk" && info.owner() != "root") {
-        return false;
+    QHash<pid_t, ClientIdentity>::const_iterator it = m_clients.constFind(pid);
+    return it != m_clients.constEnd() ? it->isPlatformApplication : resolveIsPlatformApplication(pid);
+}
+
+void Sailfish::Secrets::Daemon::ApiImpl::ApplicationPermissions::rememberApplication(pid_t pid)
+{
+    if (pid == 0) {
+        return;
     }
 
-    return true;
+    // the identity is resolved again for every new connection, in case
+    // the connection of an exited process with the same pid has not yet
+    // been noticed as closed.
+    ClientIdentity &client(m_clients[pid]);
+    client.applicationId = resolveApplicationId(pid);
+    client.isPlatformApplication = resolveIsPlatformApplication(pid);
+    client.connections += 1;
+}
+
+void Sailfish::Secrets::Daemon::ApiImpl::ApplicationPermissions::forgetApplication(pid_t pid)
+{
+    QHash<pid_t, ClientIdentity>::iterator it = m_clients.find(pid);
+    if (it != m_clients.end() && --it->connections <= 0) {
+        m_clients.erase(it);
+    }
 }
@@ -12,6 +12,7 @@
 #include <QtCore/QVariant>
 #include <QtCore/QString>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
 #include <QtCore/QList>
 #include <QtCore/QSet>
 
@@ -36,6 +37,22 @@ public:
     QString applicationId(pid_t pid) const;
     QString platformApplicationId() const { return QLatin1String("Sailfish OS"); }
     bool applicationIsPlatformApplication(pid_t pid) const;
+
+    void rememberApplication(pid_t pid);
+    void forgetApplication(pid_t pid);
+
+private:
+    // The identity of a client process is resolved once, when one of its
+    // connections sends its first request, and is remembered until every
+    // connection from that process has been closed.  A process cannot be
+    // replaced by another with the same pid while its connection is open.
+    struct ClientIdentity {
+        ClientIdentity() : isPlatformApplication(false), connections(0) {}
+        QString applicationId;
+        bool isPlatformApplication;
+        int connections;
+    };
+    QHash<pid_t, ClientIdentity> m_clients;
 };
 
 } // namespace ApiImpl
@@ -106,6 +106,7 @@ bool Daemon::ApiImpl::MetadataDatabase::openDatabase(const QByteArray &hexKey)
 {
     const QByteArray setupKeyStatement = QString::fromLatin1(setupEncryptionKey).arg(QString::fromLatin1(hexKey)).toLatin1();
     const char *setupKeyStatementData = setupKeyStatement.constData();
+    // the key must remain the first statement, see setSetupStatement().
     const char *setupStatements[] = {
         setupKeyStatementData,
         setupEnforceForeignKeys,
@@ -247,6 +248,8 @@ Daemon::ApiImpl::MetadataDatabase::unlock(
                 m_db.rollbackTransaction();
                 retn = Result(Result::DatabaseTransactionError,
                               QString::fromUtf8("Unable to commit setup key transaction"));
+            } else {
+                m_db.setSetupStatement(0, setupKeyStatement.toLatin1());
             }
         }
     }
@@ -297,6 +300,9 @@ Daemon::ApiImpl::MetadataDatabase::reencrypt(
         m_db.rollbackTransaction();
         retn = Result(Result::DatabaseTransactionError,
                       QString::fromUtf8("Unable to commit setup rekey transaction"));
+    } else {
+        // the reader connections must be keyed with the new key.
+        m_db.setSetupStatement(0, QString::fromLatin1(setupEncryptionKey).arg(QString::fromLatin1(newHexKey)).toLatin1());
     }
 
     return retn;
@@ -352,6 +358,8 @@ Daemon::ApiImpl::MetadataDatabase::collectionNames(
         QStringList *names,
         bool removeStandalone)
 {
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
+
     const QString selectCollectionNamesQuery = QStringLiteral(
                  "SELECT CollectionName"
                  " FROM Collections;"
@@ -386,6 +394,8 @@ Daemon::ApiImpl::MetadataDatabase::collectionAlreadyExists(
         const QString &collectionName,
         bool *exists)
 {
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
+
     const QString selectCollectionsCountQuery = QStringLiteral(
                  "SELECT"
                     " Count(*)"
@@ -424,6 +434,8 @@ Daemon::ApiImpl::MetadataDatabase::collectionMetadata(
         CollectionMetadata *metadata,
         bool *exists)
 {
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
+
     const QString selectCollectionQuery = QStringLiteral(
                  "SELECT"
                     " ApplicationId,"
@@ -499,6 +511,8 @@ Daemon::ApiImpl::MetadataDatabase::secretAlreadyExists(
         const QString &secretName,
         bool *exists)
 {
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
+
     const QString selectSecretsCountQuery = QStringLiteral(
                  "SELECT"
                     " Count(*)"
@@ -656,6 +670,38 @@ Daemon::ApiImpl::MetadataDatabase::deleteSecretMetadata(
     return Result(Result::Succeeded);
 }
 
+Result
+Daemon::ApiImpl::MetadataDatabase::deleteSecretsMetadata(
+        const QString &collectionName,
+        const QStringList &secretNames)
+{
+    const QString deleteSecretQuery = QStringLiteral(
+                "DELETE FROM Secrets"
+                " WHERE CollectionName = ?"
+                " AND SecretName = ?;");
+
+    QString errorText;
+    Daemon::Sqlite::Database::Query dq = m_db.prepare(deleteSecretQuery, &errorText);
+    if (!errorText.isEmpty()) {
+        return Result(Result::DatabaseQueryError,
+                      QString::fromLatin1("Unable to prepare delete secret query: %1").arg(errorText));
+    }
+
+    for (const QString &secretName : secretNames) {
+        QVariantList values;
+        values << QVariant::fromValue<QString>(collectionName);
+        values << QVariant::fromValue<QString>(secretName);
+        dq.bindValues(values);
+
+        if (!m_db.execute(dq, &errorText)) {
+            return Result(Result::DatabaseQueryError,
+                          QString::fromLatin1("Unable to execute delete secret query: %1").arg(errorText));
+        }
+    }
+
+    return Result(Result::Succeeded);
+}
+
 Result
 Daemon::ApiImpl::MetadataDatabase::secretMetadata(
         const QString &collectionName,
@@ -663,6 +709,8 @@ Daemon::ApiImpl::MetadataDatabase::secretMetadata(
         SecretMetadata *metadata,
         bool *exists)
 {
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
+
     const QString selectSecretsQuery = QStringLiteral(
                  "SELECT"
                     " ApplicationId,"
@@ -712,6 +760,8 @@ Daemon::ApiImpl::MetadataDatabase::secretNames(
         const QString &collectionName,
         QStringList *names)
 {
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
+
     const QString selectSecretNamesQuery = QStringLiteral(
                  "SELECT SecretName"
                  " FROM Secrets"
@@ -747,6 +797,8 @@ Daemon::ApiImpl::MetadataDatabase::keyNames(
         const QString &collectionName,
         QStringList *names)
 {
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
+
     const QString selectKeyNamesQuery = QStringLiteral(
                  "SELECT SecretName"
                  " FROM Secrets"
@@ -123,6 +123,10 @@ public:
             const QString &collectionName,
             const QString &secretName);
 
+    Sailfish::Secrets::Result deleteSecretsMetadata(
+            const QString &collectionName,
+            const QStringList &secretNames);
+
     Sailfish::Secrets::Result secretMetadata(
             const QString &collectionName,
             const QString &secretName,
@@ -6,11 +6,39 @@
  */
 
 #include "pluginfunctionwrappers_p.h"
+#include "tracing_p.h"
 #include "logging_p.h"
 
 using namespace Sailfish::Secrets;
 using namespace Sailfish::Secrets::Daemon::ApiImpl;
 
+namespace {
+
+    // The re-encryption of the device-locked data is canceled between
+    // batches, once the request which performs it has been canceled.
+    bool isCanceled(const QSharedPointer<QAtomicInt> &canceled)
+    {
+        return canceled && canceled->loadAcquire() != 0;
+    }
+
+    Result canceledResult()
+    {
+        return Result(Result::OperationCanceledError,
+                      QStringLiteral("The re-encryption was canceled"));
+    }
+
+    // The re-encryption was canceled, but some of the data which had already
+    // been re-encrypted could not be restored to the old key.
+    Result rollbackFailedResult(const QStringList &failures)
+    {
+        return Result(Result::SecretsPluginEncryptionError,
+                      QStringLiteral("The re-encryption was canceled but could not be rolled back for: %1. "
+                                     "The device-locked data is in a mixed state")
+                      .arg(failures.join(QStringLiteral(", "))));
+    }
+
+}
+
 /* These methods are to be called via QtConcurrent */
 
 PluginState Daemon::ApiImpl::pluginState(PluginBase *plugin)
@@ -282,6 +310,99 @@ bool Daemon::ApiImpl::modifyMasterLockPlugins(
     return allSucceeded;
 }
 
+ReencryptionResult Daemon::ApiImpl::reencryptDeviceLockedPlugins(
+        const QList<StoragePluginWrapper*> &storagePlugins,
+        const QList<EncryptedStoragePluginWrapper*> &encryptedStoragePlugins,
+        const QMap<QString, EncryptionPlugin*> &encryptionPlugins,
+        const QByteArray &oldDeviceLockKey,
+        const QByteArray &newDeviceLockKey,
+        const QSharedPointer<QAtomicInt> &canceled)
+{
+    // if the re-encryption is canceled, the plugins which were already
+    // re-encrypted are restored, so that all data remains under the old key.
+    // Any plugin which cannot be restored (including any which failed to be
+    // re-encrypted in the first place) leaves the data in a mixed state.
+    QList<EncryptedStoragePluginWrapper*> reencryptedEncryptedStoragePlugins;
+    QList<StoragePluginWrapper*> reencryptedStoragePlugins;
+    QStringList rollbackFailures;
+    auto rollback = [&] () -> ReencryptionResult {
+        for (EncryptedStoragePluginWrapper *plugin : reencryptedEncryptedStoragePlugins) {
+            const Result rresult = EncryptedStoragePluginFunctionWrapper::unlockDeviceLockedCollectionsAndReencrypt(
+                        plugin, newDeviceLockKey, oldDeviceLockKey);
+            if (rresult.code() != Result::Succeeded) {
+                qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to restore encrypted storage device-locked collections:"
+                                                   << plugin->name() << rresult.errorMessage();
+                rollbackFailures.append(plugin->name());
+            }
+        }
+        for (StoragePluginWrapper *plugin : reencryptedStoragePlugins) {
+            const Result rresult = StoragePluginFunctionWrapper::reencryptDeviceLockedCollectionsAndSecrets(
+                        plugin, encryptionPlugins, newDeviceLockKey, oldDeviceLockKey);
+            if (rresult.code() != Result::Succeeded) {
+                qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to restore stored device-locked collections and secrets:"
+                                                   << plugin->name() << rresult.errorMessage();
+                rollbackFailures.append(plugin->name());
+            }
+        }
+        return ReencryptionResult(rollbackFailures.isEmpty() ? canceledResult()
+                                                             : rollbackFailedResult(rollbackFailures),
+                                  true);
+    };
+
+    Result result(Result::Succeeded);
+    for (EncryptedStoragePluginWrapper *plugin : encryptedStoragePlugins) {
+        if (isCanceled(canceled)) {
+            return rollback();
+        }
+        // We don't allow storing device-locked standalone secrets in encryptedStoragePlugins,
+        // so we just need to ensure that we re-encrypt collections here.
+        Result reencryptCollectionResult = EncryptedStoragePluginFunctionWrapper::unlockDeviceLockedCollectionsAndReencrypt(
+                    plugin, oldDeviceLockKey, newDeviceLockKey, canceled);
+        if (reencryptCollectionResult.errorCode() == Result::OperationCanceledError) {
+            return rollback();
+        } else if (reencryptCollectionResult.code() != Result::Succeeded && isCanceled(canceled)) {
+            // the plugin could not restore its own partially re-encrypted data.
+            rollbackFailures.append(plugin->name());
+            return rollback();
+        } else if (reencryptCollectionResult.code() != Result::Succeeded) {
+            // TODO: FIXME: how do we recover from this?
+            qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to re-encrypt encrypted storage device-locked collections:"
+                                               << plugin->name()
+                                               << reencryptCollectionResult.code()
+                                               << reencryptCollectionResult.errorMessage();
+            result = reencryptCollectionResult;
+            rollbackFailures.append(plugin->name());
+        } else {
+            reencryptedEncryptedStoragePlugins.append(plugin);
+        }
+    }
+    for (StoragePluginWrapper *plugin : storagePlugins) {
+        if (isCanceled(canceled)) {
+            return rollback();
+        }
+        Result reencryptResult = StoragePluginFunctionWrapper::reencryptDeviceLockedCollectionsAndSecrets(
+                    plugin, encryptionPlugins, oldDeviceLockKey, newDeviceLockKey, canceled);
+        if (reencryptResult.errorCode() == Result::OperationCanceledError) {
+            return rollback();
+        } else if (reencryptResult.code() != Result::Succeeded && isCanceled(canceled)) {
+            // the plugin could not restore its own partially re-encrypted data.
+            rollbackFailures.append(plugin->name());
+            return rollback();
+        } else if (reencryptResult.code() != Result::Succeeded) {
+            // TODO: FIXME: how do we recover from this?
+            qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to re-encrypt stored device-locked collections and secrets:"
+                                               << plugin->name()
+                                               << reencryptResult.code()
+                                               << reencryptResult.errorMessage();
+            result = reencryptResult;
+            rollbackFailures.append(plugin->name());
+        } else {
+            reencryptedStoragePlugins.append(plugin);
+        }
+    }
+    return ReencryptionResult(result, false);
+}
+
 IdentifiersResult Daemon::ApiImpl::storedKeyIdentifiers(
         StoragePluginWrapper *storagePlugin,
         EncryptedStoragePluginWrapper *encryptedStoragePlugin,
@@ -430,17 +551,20 @@ IdentifiersResult Daemon::ApiImpl::storedKeyIdentifiersFromCollection(
 
 bool EncryptionPluginFunctionWrapper::isLocked(EncryptionPlugin *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->isLocked();
 }
 
 bool EncryptionPluginFunctionWrapper::lock(EncryptionPlugin *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->lock();
 }
 
 bool EncryptionPluginFunctionWrapper::unlock(EncryptionPlugin *plugin,
                                      const QByteArray &lockCode)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->unlock(lockCode);
 }
 
@@ -448,6 +572,7 @@ bool setLockCode(EncryptionPlugin *plugin,
                  const QByteArray &oldLockCode,
                  const QByteArray &newLockCode)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->setLockCode(oldLockCode, newLockCode);
 }
 
@@ -457,6 +582,7 @@ EncryptionPluginFunctionWrapper::deriveKeyFromCode(
         const QByteArray &authenticationCode,
         const QByteArray &salt)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QByteArray key;
     Result result = plugin->deriveKeyFromCode(authenticationCode, salt, &key);
     return DerivedKeyResult(result, key);
@@ -468,6 +594,7 @@ EncryptionPluginFunctionWrapper::encryptSecret(
         const QByteArray &plaintext,
         const QByteArray &key)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QByteArray ciphertext;
     Result result = plugin->encryptSecret(plaintext, key, &ciphertext);
     return EncryptionPluginFunctionWrapper::DataResult(result, ciphertext);
@@ -479,6 +606,7 @@ EncryptionPluginFunctionWrapper::decryptSecret(
         const QByteArray &encrypted,
         const QByteArray &key)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QByteArray plaintext;
     Result result = plugin->decryptSecret(encrypted, key, &plaintext);
     return EncryptionPluginFunctionWrapper::DataResult(result, plaintext);
@@ -486,11 +614,13 @@ EncryptionPluginFunctionWrapper::decryptSecret(
 
 bool StoragePluginFunctionWrapper::isLocked(StoragePluginWrapper *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->isLocked();
 }
 
 bool StoragePluginFunctionWrapper::lock(StoragePluginWrapper *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->lock();
 }
 
@@ -498,6 +628,7 @@ bool StoragePluginFunctionWrapper::unlock(
         StoragePluginWrapper *plugin,
         const QByteArray &lockCode)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->unlock(lockCode);
 }
 
@@ -506,6 +637,7 @@ bool StoragePluginFunctionWrapper::setLockCode(
         const QByteArray &oldLockCode,
         const QByteArray &newLockCode)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->setLockCode(oldLockCode, newLockCode);
 }
 
@@ -513,6 +645,7 @@ CollectionMetadataResult StoragePluginFunctionWrapper::collectionMetadata(
         StoragePluginWrapper *plugin,
         const QString &collectionName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     CollectionMetadata metadata;
     Result result = plugin->collectionMetadata(collectionName, &metadata);
     return CollectionMetadataResult(result, metadata);
@@ -523,6 +656,7 @@ SecretMetadataResult StoragePluginFunctionWrapper::secretMetadata(
         const QString &collectionName,
         const QString &secretName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     SecretMetadata metadata;
     Result result = plugin->secretMetadata(collectionName, secretName, &metadata);
     return SecretMetadataResult(result, metadata);
@@ -531,6 +665,7 @@ SecretMetadataResult StoragePluginFunctionWrapper::secretMetadata(
 CollectionNamesResult StoragePluginFunctionWrapper::collectionNames(
         StoragePluginWrapper *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QVariantMap cnamesMap;
     Result result = plugin->collectionNames(&cnamesMap);
     return CollectionNamesResult(result, cnamesMap);
@@ -540,6 +675,7 @@ Result StoragePluginFunctionWrapper::createCollection(
         StoragePluginWrapper *plugin,
         const CollectionMetadata &metadata)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->createCollection(metadata);
 }
 
@@ -547,6 +683,7 @@ Result StoragePluginFunctionWrapper::removeCollection(
         StoragePluginWrapper *plugin,
         const QString &collectionName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->removeCollection(collectionName);
 }
 
@@ -556,6 +693,7 @@ Result StoragePluginFunctionWrapper::setSecret(
         const QByteArray &secret,
         const Secret::FilterData &filterData)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->setSecret(secretMetadata,
                              secret,
                              filterData);
@@ -567,6 +705,7 @@ StoragePluginFunctionWrapper::getSecret(
         const QString &collectionName,
         const QString &secretName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QByteArray secret;
     Secret::FilterData filterData;
     Result result = plugin->getSecret(collectionName,
@@ -582,10 +721,28 @@ Result StoragePluginFunctionWrapper::removeSecret(
         const QString &collectionName,
         const QString &secretName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->removeSecret(collectionName,
                                 secretName);
 }
 
+IdentifiersResult StoragePluginFunctionWrapper::removeSecrets(
+        StoragePluginWrapper *plugin,
+        const QString &collectionName,
+        const Secret::FilterData &filter,
+        StoragePlugin::FilterOperator filterOperator)
+{
+    const TraceSpan traceSpan(__func__, plugin);
+    QVector<Secret::Identifier> identifiers;
+    QStringList secretNames;
+    Result pluginResult = plugin->removeSecrets(collectionName, filter, filterOperator, &secretNames);
+    for (const QString &secretName : secretNames) {
+        identifiers.append(Secret::Identifier(secretName, collectionName, plugin->name()));
+    }
+
+    return IdentifiersResult(pluginResult, identifiers);
+}
+
 Result StoragePluginFunctionWrapper::reencrypt(
         StoragePluginWrapper *plugin,
         const QString &collectionName,
@@ -594,6 +751,7 @@ Result StoragePluginFunctionWrapper::reencrypt(
         const QByteArray &newkey,
         EncryptionPlugin *encryptionPlugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->reencrypt(collectionName,
                              secretNames,
                              oldkey,
@@ -608,6 +766,7 @@ Result StoragePluginFunctionWrapper::encryptAndStoreSecret(
         const Secret &secret,
         const QByteArray &encryptionKey)
 {
+    const TraceSpan traceSpan(__func__, storagePlugin);
     QByteArray encrypted;
     Result pluginResult = encryptionPlugin->encryptSecret(
                 secret.data(), encryptionKey, &encrypted);
@@ -620,12 +779,46 @@ Result StoragePluginFunctionWrapper::encryptAndStoreSecret(
     return pluginResult;
 }
 
+StoreSecretsResult StoragePluginFunctionWrapper::encryptAndStoreSecrets(
+        EncryptionPlugin *encryptionPlugin,
+        StoragePluginWrapper *storagePlugin,
+        const QVector<SecretMetadata> &secretsMetadata,
+        const QVector<Secret> &secrets,
+        const QByteArray &encryptionKey)
+{
+    const TraceSpan traceSpan(__func__, storagePlugin);
+    QVector<Result> results(secrets.size());
+    QVector<QByteArray> encryptedSecrets;
+    QVector<Secret::FilterData> filterData;
+    encryptedSecrets.reserve(secrets.size());
+    filterData.reserve(secrets.size());
+    for (int i = 0; i < secrets.size(); ++i) {
+        QByteArray encrypted;
+        Result pluginResult = encryptionPlugin->encryptSecret(
+                    secrets.at(i).data(), encryptionKey, &encrypted);
+        if (pluginResult.code() != Result::Succeeded) {
+            results[i] = pluginResult;
+            return StoreSecretsResult(pluginResult, results);
+        }
+        encryptedSecrets.append(encrypted);
+        filterData.append(secrets.at(i).filterData());
+    }
+
+    Result pluginResult = storagePlugin->setSecrets(
+                secretsMetadata,
+                encryptedSecrets,
+                filterData,
+                &results);
+    return StoreSecretsResult(pluginResult, results);
+}
+
 SecretResult StoragePluginFunctionWrapper::getAndDecryptSecret(
         EncryptionPlugin *encryptionPlugin,
         StoragePluginWrapper *storagePlugin,
         const Secret::Identifier &identifier,
         const QByteArray &encryptionKey)
 {
+    const TraceSpan traceSpan(__func__, storagePlugin);
     Secret secret;
     QByteArray encrypted;
     Secret::FilterData filterData;
@@ -645,6 +838,40 @@ SecretResult StoragePluginFunctionWrapper::getAndDecryptSecret(
     return SecretResult(pluginResult, secret);
 }
 
+SecretsResult StoragePluginFunctionWrapper::getAndDecryptSecrets(
+        EncryptionPlugin *encryptionPlugin,
+        StoragePluginWrapper *storagePlugin,
+        const QVector<Secret::Identifier> &identifiers,
+        const QByteArray &encryptionKey)
+{
+    const TraceSpan traceSpan(__func__, storagePlugin);
+    QStringList secretNames;
+    for (const Secret::Identifier &identifier : identifiers) {
+        secretNames.append(identifier.name());
+    }
+
+    QVector<Secret> secrets;
+    QVector<QByteArray> encrypted;
+    QVector<Secret::FilterData> filterData;
+    Result pluginResult = storagePlugin->getSecrets(
+                identifiers.isEmpty() ? QString() : identifiers.first().collectionName(),
+                secretNames,
+                &encrypted,
+                &filterData);
+    secrets.reserve(encrypted.size());
+    for (int i = 0; pluginResult.code() == Result::Succeeded && i < encrypted.size(); ++i) {
+        QByteArray decrypted;
+        pluginResult = encryptionPlugin->decryptSecret(encrypted.at(i), encryptionKey, &decrypted);
+        Secret secret(identifiers.at(i));
+        secret.setData(decrypted);
+        secret.setFilterData(filterData.at(i));
+        secrets.append(secret);
+    }
+
+    return SecretsResult(pluginResult,
+                         pluginResult.code() == Result::Succeeded ? secrets : QVector<Secret>());
+}
+
 IdentifiersResult
 StoragePluginFunctionWrapper::findSecrets(
         StoragePluginWrapper *storagePlugin,
@@ -652,6 +879,7 @@ StoragePluginFunctionWrapper::findSecrets(
         const Sailfish::Secrets::Secret::FilterData &filter,
         Sailfish::Secrets::StoragePlugin::FilterOperator filterOp)
 {
+    const TraceSpan traceSpan(__func__, storagePlugin);
     QVector<Secret::Identifier> identifiers;
     QStringList secretNames;
     Result pluginResult = storagePlugin->findSecrets(collectionName, filter, filterOp, &secretNames);
@@ -667,8 +895,10 @@ StoragePluginFunctionWrapper::reencryptDeviceLockedCollectionsAndSecrets(
         StoragePluginWrapper *plugin,
         const QMap<QString, EncryptionPlugin*> encryptionPlugins,
         const QByteArray &oldEncryptionKey,
-        const QByteArray &newEncryptionKey)
+        const QByteArray &newEncryptionKey,
+        const QSharedPointer<QAtomicInt> &canceled)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     // get collection names
     // foreach collection, get metadata
     // if usesDeviceLockKey, re-encrypt
@@ -725,26 +955,64 @@ StoragePluginFunctionWrapper::reencryptDeviceLockedCollectionsAndSecrets(
         }
     }
 
-    // Now re-encrypt the collections and secrets.
+    // Now re-encrypt the collections and secrets, one at a time.
+    // If the re-encryption is canceled, those which were already
+    // re-encrypted are restored to the old key.
+    QStringList reencryptedCollections, reencryptedSecrets;
+    auto rollback = [&] () -> Result {
+        QStringList failures;
+        for (const QString &cname : reencryptedCollections) {
+            const Result rresult = plugin->reencrypt(cname, QString(), newEncryptionKey, oldEncryptionKey,
+                                                     reencryptCollections.value(cname));
+            if (rresult.code() != Result::Succeeded) {
+                qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to restore collection:" << cname
+                                                   << "in plugin:" << plugin->name()
+                                                   << rresult.errorMessage();
+                failures.append(QStringLiteral("collection %1").arg(cname));
+            }
+        }
+        for (const QString &sname : reencryptedSecrets) {
+            const Result rresult = plugin->reencrypt(QString(), sname, newEncryptionKey, oldEncryptionKey,
+                                                     reencryptSecrets.value(sname));
+            if (rresult.code() != Result::Succeeded) {
+                qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to restore standalone secret:" << sname
+                                                   << "in plugin:" << plugin->name()
+                                                   << rresult.errorMessage();
+                failures.append(QStringLiteral("secret %1").arg(sname));
+            }
+        }
+        return failures.isEmpty() ? canceledResult() : rollbackFailedResult(failures);
+    };
+
     for (const QString &cname : reencryptCollections.keys()) {
+        if (isCanceled(canceled)) {
+            return rollback();
+        }
         Result cresult =  plugin->reencrypt(
                     cname,
                     QString(),
                     oldEncryptionKey,
                     newEncryptionKey,
                     reencryptCollections.value(cname));
-        if (!cresult.code() == Result::Succeeded) {
+        if (cresult.code() != Result::Succeeded) {
             result = cresult;
+        } else {
+            reencryptedCollections.append(cname);
         }
     }
     for (const QString &sname : reencryptSecrets.keys()) {
+        if (isCanceled(canceled)) {
+            return rollback();
+        }
         Result sresult = plugin->reencrypt(QString(),
                     sname,
                     oldEncryptionKey,
                     newEncryptionKey,
                     reencryptSecrets.value(sname));
-        if (!sresult.code() == Result::Succeeded) {
+        if (sresult.code() != Result::Succeeded) {
             result = sresult;
+        } else {
+            reencryptedSecrets.append(sname);
         }
     }
     return result;
@@ -757,6 +1025,7 @@ StoragePluginFunctionWrapper::collectionSecretPreCheck(
         const QString &secretName,
         bool newSecret)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QStringList cnames;
     QVariantMap cnamesMap;
     Result result = plugin->collectionNames(&cnamesMap);
@@ -800,11 +1069,13 @@ StoragePluginFunctionWrapper::collectionSecretPreCheck(
 
 bool EncryptedStoragePluginFunctionWrapper::isLocked(EncryptedStoragePluginWrapper *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->isLocked();
 }
 
 bool EncryptedStoragePluginFunctionWrapper::lock(EncryptedStoragePluginWrapper *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->lock();
 }
 
@@ -812,6 +1083,7 @@ bool EncryptedStoragePluginFunctionWrapper::unlock(
         EncryptedStoragePluginWrapper *plugin,
         const QByteArray &lockCode)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->unlock(lockCode);
 }
 
@@ -820,6 +1092,7 @@ bool EncryptedStoragePluginFunctionWrapper::setLockCode(
         const QByteArray &oldLockCode,
         const QByteArray &newLockCode)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->setLockCode(oldLockCode, newLockCode);
 }
 
@@ -827,6 +1100,7 @@ CollectionMetadataResult EncryptedStoragePluginFunctionWrapper::collectionMetada
         EncryptedStoragePluginWrapper *plugin,
         const QString &collectionName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     CollectionMetadata metadata;
     Result result = plugin->collectionMetadata(collectionName, &metadata);
     metadata.collectionName = collectionName;
@@ -838,6 +1112,7 @@ SecretMetadataResult EncryptedStoragePluginFunctionWrapper::secretMetadata(
         const QString &collectionName,
         const QString &secretName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     SecretMetadata metadata;
     Result result = plugin->secretMetadata(collectionName, secretName, &metadata);
     metadata.collectionName = collectionName;
@@ -848,6 +1123,7 @@ SecretMetadataResult EncryptedStoragePluginFunctionWrapper::secretMetadata(
 CollectionNamesResult EncryptedStoragePluginFunctionWrapper::collectionNames(
         EncryptedStoragePluginWrapper *plugin)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QVariantMap cnamesMap;
     Result result = plugin->collectionNames(&cnamesMap);
     return CollectionNamesResult(result, cnamesMap);
@@ -858,6 +1134,7 @@ Result EncryptedStoragePluginFunctionWrapper::createCollection(
         const CollectionMetadata &metadata,
         const QByteArray &key)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->createCollection(metadata, key);
 }
 
@@ -865,6 +1142,7 @@ Result EncryptedStoragePluginFunctionWrapper::removeCollection(
         EncryptedStoragePluginWrapper *plugin,
         const QString &collectionName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->removeCollection(collectionName);
 }
 
@@ -873,6 +1151,7 @@ EncryptedStoragePluginFunctionWrapper::isCollectionLocked(
         EncryptedStoragePluginWrapper *plugin,
         const QString &collectionName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     bool locked = false;
     Result result = plugin->isCollectionLocked(collectionName, &locked);
     return LockedResult(result, locked);
@@ -884,6 +1163,7 @@ EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode(
         const QByteArray &authenticationCode,
         const QByteArray &salt)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QByteArray key;
     Result result = plugin->deriveKeyFromCode(authenticationCode, salt, &key);
     return DerivedKeyResult(result, key);
@@ -894,6 +1174,7 @@ Result EncryptedStoragePluginFunctionWrapper::setEncryptionKey(
         const QString &collectionName,
         const QByteArray &key)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->setEncryptionKey(collectionName, key);
 }
 
@@ -903,6 +1184,7 @@ Result EncryptedStoragePluginFunctionWrapper::reencrypt(
         const QByteArray &oldkey,
         const QByteArray &newkey)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->reencrypt(collectionName,
                              oldkey,
                              newkey);
@@ -914,6 +1196,7 @@ Result EncryptedStoragePluginFunctionWrapper::setSecret(
         const QByteArray &secret,
         const Secret::FilterData &filterData)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->setSecret(secretMetadata,
                              secret,
                              filterData);
@@ -925,6 +1208,7 @@ EncryptedStoragePluginFunctionWrapper::getSecret(
         const QString &collectionName,
         const QString &secretName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QByteArray secret;
     Secret::FilterData filterData;
     Result result = plugin->getSecret(collectionName,
@@ -942,6 +1226,7 @@ EncryptedStoragePluginFunctionWrapper::findSecrets(
         const Secret::FilterData &filter,
         StoragePlugin::FilterOperator filterOperator)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QVector<Secret::Identifier> identifiers;
     Result result = plugin->findSecrets(collectionName,
                                         filter,
@@ -955,6 +1240,7 @@ Result EncryptedStoragePluginFunctionWrapper::removeSecret(
         const QString &collectionName,
         const QString &secretName)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->removeSecret(collectionName,
                                 secretName);
 }
@@ -965,6 +1251,7 @@ Result EncryptedStoragePluginFunctionWrapper::setStandaloneSecret(
         const Secret &secret,
         const QByteArray &key)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     return plugin->setSecret(secretMetadata,
                              secret.data(),
                              secret.filterData(),
@@ -977,6 +1264,7 @@ EncryptedStoragePluginFunctionWrapper::accessStandaloneSecret(
         const QString &secretName,
         const QByteArray &key)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QByteArray secret;
     Secret::FilterData filterData;
     Result result = plugin->accessSecret(secretName,
@@ -993,6 +1281,7 @@ Result EncryptedStoragePluginFunctionWrapper::unlockCollectionAndStoreSecret(
         const Secret &secret,
         const QByteArray &encryptionKey)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     bool originallyLocked = false;
     bool locked = false;
     Result pluginResult = plugin->isCollectionLocked(secret.identifier().collectionName(), &locked);
@@ -1039,12 +1328,77 @@ Result EncryptedStoragePluginFunctionWrapper::unlockCollectionAndStoreSecret(
     return pluginResult;
 }
 
+StoreSecretsResult EncryptedStoragePluginFunctionWrapper::unlockCollectionAndStoreSecrets(
+        EncryptedStoragePluginWrapper *plugin,
+        const QVector<SecretMetadata> &secretsMetadata,
+        const QVector<Secret> &secrets,
+        const QByteArray &encryptionKey)
+{
+    const TraceSpan traceSpan(__func__, plugin);
+    const SecretMetadata &secretMetadata(secretsMetadata.first());
+    bool originallyLocked = false;
+    bool locked = false;
+    Result pluginResult = plugin->isCollectionLocked(secretMetadata.collectionName, &locked);
+    if (pluginResult.code() != Result::Succeeded) {
+        return StoreSecretsResult(pluginResult);
+    }
+
+    originallyLocked = locked;
+    if (locked) {
+        pluginResult = plugin->setEncryptionKey(secretMetadata.collectionName, encryptionKey);
+        if (pluginResult.code() != Result::Succeeded) {
+            // unable to apply the new encryptionKey.
+            plugin->setEncryptionKey(secretMetadata.collectionName, QByteArray());
+            return StoreSecretsResult(Result(Result::SecretsPluginDecryptionError,
+                                             QString::fromLatin1("Unable to decrypt collection %1 with the entered authentication key").arg(secretMetadata.collectionName)));
+        }
+        pluginResult = plugin->isCollectionLocked(secretMetadata.collectionName, &locked);
+        if (pluginResult.code() != Result::Succeeded) {
+            plugin->setEncryptionKey(secretMetadata.collectionName, QByteArray());
+            return StoreSecretsResult(Result(Result::SecretsPluginDecryptionError,
+                                             QString::fromLatin1("Unable to check lock state of collection %1 after setting the entered authentication key").arg(secretMetadata.collectionName)));
+        }
+    }
+    if (locked) {
+        // still locked, even after applying the new encryptionKey?  The authenticationCode was wrong.
+        plugin->setEncryptionKey(secretMetadata.collectionName, QByteArray());
+        return StoreSecretsResult(Result(Result::IncorrectAuthenticationCodeError,
+                                         QString::fromLatin1("The authentication code entered for collection %1 was incorrect").arg(secretMetadata.collectionName)));
+    }
+
+    // successfully unlocked the encrypted storage collection.  write the secrets.
+    QVector<Result> results;
+    QVector<QByteArray> secretsData;
+    QVector<Secret::FilterData> filterData;
+    secretsData.reserve(secrets.size());
+    filterData.reserve(secrets.size());
+    for (const Secret &secret : secrets) {
+        secretsData.append(secret.data());
+        filterData.append(secret.filterData());
+    }
+    pluginResult = plugin->setSecrets(secretsMetadata, secretsData, filterData, &results);
+
+    // relock the collection if we need to.
+    if (originallyLocked
+            && ((secretMetadata.usesDeviceLockKey && secretMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked)
+                || (!secretMetadata.usesDeviceLockKey && secretMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked))) {
+        Result relockResult = plugin->setEncryptionKey(secretMetadata.collectionName, QByteArray());
+        if (relockResult.code() != Result::Succeeded) {
+            qCWarning(lcSailfishSecretsDaemon) << "Error relocking collection:" << secretMetadata.collectionName
+                                               << relockResult.errorMessage();
+        }
+    }
+
+    return StoreSecretsResult(pluginResult, results);
+}
+
 SecretResult EncryptedStoragePluginFunctionWrapper::unlockCollectionAndReadSecret(
         EncryptedStoragePluginWrapper *plugin,
         const CollectionMetadata &collectionMetadata,
         const Secret::Identifier &identifier,
         const QByteArray &encryptionKey)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     Secret secret;
     bool originallyLocked = false;
     bool locked = false;
@@ -1108,12 +1462,94 @@ SecretResult EncryptedStoragePluginFunctionWrapper::unlockCollectionAndReadSecre
     return SecretResult(pluginResult, secret);
 }
 
+SecretsResult EncryptedStoragePluginFunctionWrapper::unlockCollectionAndReadSecrets(
+        EncryptedStoragePluginWrapper *plugin,
+        const CollectionMetadata &collectionMetadata,
+        const QVector<Secret::Identifier> &identifiers,
+        const QByteArray &encryptionKey)
+{
+    const TraceSpan traceSpan(__func__, plugin);
+    const QString collectionName = identifiers.isEmpty() ? QString() : identifiers.first().collectionName();
+    QVector<Secret> secrets;
+    bool originallyLocked = false;
+    bool locked = false;
+    Result pluginResult = plugin->isCollectionLocked(collectionName, &locked);
+    if (pluginResult.code() != Result::Succeeded) {
+        return SecretsResult(pluginResult, secrets);
+    }
+
+    // if it's locked, attempt to unlock it
+    originallyLocked = locked;
+    if (locked) {
+        pluginResult = plugin->setEncryptionKey(collectionName, encryptionKey);
+        if (pluginResult.code() != Result::Succeeded) {
+            // unable to apply the new encryptionKey.
+            plugin->setEncryptionKey(collectionName, QByteArray());
+            return SecretsResult(Result(Result::SecretsPluginDecryptionError,
+                                        QString::fromLatin1("Unable to decrypt collection %1 with the entered authentication key")
+                                        .arg(collectionName)),
+                                 secrets);
+
+        }
+        pluginResult = plugin->isCollectionLocked(collectionName, &locked);
+        if (pluginResult.code() != Result::Succeeded) {
+            plugin->setEncryptionKey(collectionName, QByteArray());
+            return SecretsResult(Result(Result::SecretsPluginDecryptionError,
+                                        QString::fromLatin1("Unable to check lock state of collection %1 after setting the entered authentication key")
+                                        .arg(collectionName)),
+                                 secrets);
+
+        }
+    }
+
+    if (locked) {
+        // still locked, even after applying the new encryptionKey?  The authenticationCode was wrong.
+        plugin->setEncryptionKey(collectionName, QByteArray());
+        return SecretsResult(Result(Result::IncorrectAuthenticationCodeError,
+                                    QString::fromLatin1("The authentication code entered for collection %1 was incorrect")
+                                    .arg(collectionName)),
+                             secrets);
+    }
+
+    // successfully unlocked the encrypted storage collection.  read the secrets.
+    QStringList secretNames;
+    for (const Secret::Identifier &identifier : identifiers) {
+        secretNames.append(identifier.name());
+    }
+    QVector<QByteArray> secretsData;
+    QVector<Secret::FilterData> secretsFilterData;
+    pluginResult = plugin->getSecrets(collectionName, secretNames, &secretsData, &secretsFilterData);
+    if (pluginResult.code() == Result::Succeeded) {
+        secrets.reserve(secretsData.size());
+        for (int i = 0; i < secretsData.size(); ++i) {
+            Secret secret(identifiers.at(i));
+            secret.setData(secretsData.at(i));
+            secret.setFilterData(secretsFilterData.at(i));
+            secrets.append(secret);
+        }
+    }
+
+    // relock the collection if we need to.
+    if (originallyLocked
+            && ((collectionMetadata.usesDeviceLockKey && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked)
+                || (!collectionMetadata.usesDeviceLockKey && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked))) {
+        Result relockResult = plugin->setEncryptionKey(collectionName, QByteArray());
+        if (relockResult.code() != Result::Succeeded) {
+            qCWarning(lcSailfishSecretsDaemon) << "Error relocking collection:" << collectionName
+                                               << relockResult.errorMessage();
+        }
+    }
+
+    return SecretsResult(pluginResult, secrets);
+}
+
 Result EncryptedStoragePluginFunctionWrapper::unlockCollectionAndRemoveSecret(
         EncryptedStoragePluginWrapper *plugin,
         const CollectionMetadata &collectionMetadata,
         const Secret::Identifier &identifier,
         const QByteArray &encryptionKey)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     bool originallyLocked = false;
     bool locked = false;
     Result pluginResult = plugin->isCollectionLocked(identifier.collectionName(), &locked);
@@ -1172,6 +1608,7 @@ EncryptedStoragePluginFunctionWrapper::unlockAndFindSecrets(
         StoragePlugin::FilterOperator filterOperator,
         const QByteArray &encryptionKey)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QVector<Secret::Identifier> identifiers;
     bool originallyLocked = false;
     bool locked = false;
@@ -1230,11 +1667,84 @@ EncryptedStoragePluginFunctionWrapper::unlockAndFindSecrets(
     return IdentifiersResult(pluginResult, identifiers);
 }
 
+IdentifiersResult
+EncryptedStoragePluginFunctionWrapper::unlockCollectionAndRemoveSecrets(
+        EncryptedStoragePluginWrapper *plugin,
+        const CollectionMetadata &collectionMetadata,
+        const Secret::FilterData &filter,
+        StoragePlugin::FilterOperator filterOperator,
+        const QByteArray &encryptionKey)
+{
+    const TraceSpan traceSpan(__func__, plugin);
+    QVector<Secret::Identifier> identifiers;
+    bool originallyLocked = false;
+    bool locked = false;
+    Result pluginResult = plugin->isCollectionLocked(collectionMetadata.collectionName, &locked);
+    if (pluginResult.code() != Result::Succeeded) {
+        return IdentifiersResult(pluginResult, identifiers);
+    }
+
+    // if it's locked, attempt to unlock it
+    originallyLocked = locked;
+    if (locked) {
+        pluginResult = plugin->setEncryptionKey(collectionMetadata.collectionName, encryptionKey);
+        if (pluginResult.code() != Result::Succeeded) {
+            // unable to apply the new encryptionKey.
+            plugin->setEncryptionKey(collectionMetadata.collectionName, QByteArray());
+            return IdentifiersResult(Result(Result::SecretsPluginDecryptionError,
+                                            QString::fromLatin1("Unable to decrypt collection %1 with the entered authentication key")
+                                            .arg(collectionMetadata.collectionName)),
+                                     identifiers);
+
+        }
+        pluginResult = plugin->isCollectionLocked(collectionMetadata.collectionName, &locked);
+        if (pluginResult.code() != Result::Succeeded) {
+            plugin->setEncryptionKey(collectionMetadata.collectionName, QByteArray());
+            return IdentifiersResult(Result(Result::SecretsPluginDecryptionError,
+                                            QString::fromLatin1("Unable to check lock state of collection %1 after setting the entered authentication key")
+                                            .arg(collectionMetadata.collectionName)),
+                                     identifiers);
+
+        }
+    }
+
+    if (locked) {
+        // still locked, even after applying the new encryptionKey?  The authenticationCode was wrong.
+        plugin->setEncryptionKey(collectionMetadata.collectionName, QByteArray());
+        return IdentifiersResult(Result(Result::IncorrectAuthenticationCodeError,
+                                        QString::fromLatin1("The authentication code entered for collection %1 was incorrect")
+                                        .arg(collectionMetadata.collectionName)),
+                                 identifiers);
+    }
+
+    // successfully unlocked the encrypted storage collection.  remove the matching secrets.
+    QStringList secretNames;
+    pluginResult = plugin->removeSecrets(collectionMetadata.collectionName, filter, filterOperator, &secretNames);
+    for (const QString &secretName : secretNames) {
+        identifiers.append(Secret::Identifier(secretName, collectionMetadata.collectionName, plugin->name()));
+    }
+
+    // relock the collection if we need to.
+    if (originallyLocked
+            && ((collectionMetadata.usesDeviceLockKey && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked)
+                || (!collectionMetadata.usesDeviceLockKey && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked))) {
+        Result relockResult = plugin->setEncryptionKey(collectionMetadata.collectionName, QByteArray());
+        if (relockResult.code() != Result::Succeeded) {
+            qCWarning(lcSailfishSecretsDaemon) << "Error relocking collection:" << collectionMetadata.collectionName
+                                               << relockResult.errorMessage();
+        }
+    }
+
+    return IdentifiersResult(pluginResult, identifiers);
+}
+
 Result EncryptedStoragePluginFunctionWrapper::unlockDeviceLockedCollectionsAndReencrypt(
         EncryptedStoragePluginWrapper *plugin,
         const QByteArray &oldEncryptionKey,
-        const QByteArray &newEncryptionKey)
+        const QByteArray &newEncryptionKey,
+        const QSharedPointer<QAtomicInt> &canceled)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     // find out which collections are device-locked
     QStringList cnames;
     QVariantMap cnamesMap;
@@ -1256,8 +1766,23 @@ Result EncryptedStoragePluginFunctionWrapper::unlockDeviceLockedCollectionsAndRe
         }
     }
 
-    // re-encrypt every device-locked collection
+    // re-encrypt every device-locked collection, one at a time.
+    // If the re-encryption is canceled, the collections which were
+    // already re-encrypted are restored to the old key.
+    QStringList reencryptedCNames;
     for (const QString &collectionName : reencryptCNames) {
+        if (isCanceled(canceled)) {
+            QStringList failures;
+            for (const QString &reencryptedName : reencryptedCNames) {
+                const Result rresult = plugin->reencrypt(reencryptedName, newEncryptionKey, oldEncryptionKey);
+                if (rresult.code() != Result::Succeeded) {
+                    qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to restore encrypted storage collection:"
+                                                       << reencryptedName << rresult.errorMessage();
+                    failures.append(QStringLiteral("collection %1").arg(reencryptedName));
+                }
+            }
+            return failures.isEmpty() ? canceledResult() : rollbackFailedResult(failures);
+        }
         bool collectionLocked = true;
         plugin->isCollectionLocked(collectionName, &collectionLocked);
         if (collectionLocked) {
@@ -1279,6 +1804,8 @@ Result EncryptedStoragePluginFunctionWrapper::unlockDeviceLockedCollectionsAndRe
                                                << collectionReencryptResult.code()
                                                << collectionReencryptResult.errorMessage();
             result = collectionReencryptResult;
+        } else {
+            reencryptedCNames.append(collectionName);
         }
     }
 
@@ -1290,6 +1817,7 @@ Result EncryptedStoragePluginFunctionWrapper::unlockAndRemoveCollection(
         const QString &collectionName,
         const QByteArray &encryptionKey)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     bool locked = false;
     Result result = plugin->isCollectionLocked(collectionName, &locked);
     if (result.code() != Result::Succeeded) {
@@ -1321,6 +1849,7 @@ Result EncryptedStoragePluginFunctionWrapper::deriveKeyUnlockAndRemoveCollection
         const QByteArray &lockCode,
         const QByteArray &salt)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     bool locked = false;
     Result result = plugin->isCollectionLocked(collectionName, &locked);
     if (result.code() != Result::Succeeded) {
@@ -1358,6 +1887,7 @@ Result EncryptedStoragePluginFunctionWrapper::collectionSecretPreCheck(
         const QString &secretName,
         bool newSecret)
 {
+    const TraceSpan traceSpan(__func__, plugin);
     QStringList cnames;
     QVariantMap cnamesMap;
     Result result = plugin->collectionNames(&cnamesMap);
@@ -22,6 +22,8 @@
 
 #include <QtCore/QString>
 #include <QtCore/QByteArray>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QAtomicInt>
 
 namespace Sailfish {
 
@@ -41,6 +43,26 @@ struct SecretResult {
     Sailfish::Secrets::Secret secret;
 };
 
+struct SecretsResult {
+    SecretsResult(const Sailfish::Secrets::Result &r = Sailfish::Secrets::Result(),
+                  const QVector<Sailfish::Secrets::Secret> &s = QVector<Sailfish::Secrets::Secret>())
+        : result(r), secrets(s) {}
+    SecretsResult(const SecretsResult &other)
+        : result(other.result), secrets(other.secrets) {}
+    Sailfish::Secrets::Result result;
+    QVector<Sailfish::Secrets::Secret> secrets;
+};
+
+struct StoreSecretsResult {
+    StoreSecretsResult(const Sailfish::Secrets::Result &r = Sailfish::Secrets::Result(),
+                       const QVector<Sailfish::Secrets::Result> &rs = QVector<Sailfish::Secrets::Result>())
+        : result(r), results(rs) {}
+    StoreSecretsResult(const StoreSecretsResult &other)
+        : result(other.result), results(other.results) {}
+    Sailfish::Secrets::Result result;
+    QVector<Sailfish::Secrets::Result> results; // per secret
+};
+
 struct SecretMetadataResult {
     SecretMetadataResult(const Sailfish::Secrets::Result &r = Sailfish::Secrets::Result(),
                          const SecretMetadata &s = SecretMetadata())
@@ -168,6 +190,15 @@ struct PluginState {
     bool locked;
 };
 
+struct ReencryptionResult {
+    ReencryptionResult(const Sailfish::Secrets::Result &r = Sailfish::Secrets::Result(), bool rb = false)
+        : result(r), rolledBack(rb) {}
+    ReencryptionResult(const ReencryptionResult &other)
+        : result(other.result), rolledBack(other.rolledBack) {}
+    Sailfish::Secrets::Result result;
+    bool rolledBack; // true if the re-encryption was canceled and (at least partially) rolled back.
+};
+
 PluginState pluginState(PluginBase *plugin);
 
 FoundLockStatusResult queryLockSpecificPlugin(
@@ -211,6 +242,14 @@ bool modifyMasterLockPlugins(
         const QByteArray &oldEncryptionKey,
         const QByteArray &newEncryptionKey);
 
+ReencryptionResult reencryptDeviceLockedPlugins(
+        const QList<StoragePluginWrapper*> &storagePlugins,
+        const QList<EncryptedStoragePluginWrapper*> &encryptedStoragePlugins,
+        const QMap<QString, Sailfish::Secrets::EncryptionPlugin*> &encryptionPlugins,
+        const QByteArray &oldDeviceLockKey,
+        const QByteArray &newDeviceLockKey,
+        const QSharedPointer<QAtomicInt> &canceled = QSharedPointer<QAtomicInt>());
+
 IdentifiersResult storedKeyIdentifiers(
         StoragePluginWrapper *storagePlugin,
         EncryptedStoragePluginWrapper *encryptedStoragePlugin,
@@ -313,6 +352,11 @@ namespace StoragePluginFunctionWrapper {
             StoragePluginWrapper *plugin,
             const QString &collectionName,
             const QString &secretName);
+    IdentifiersResult removeSecrets(
+            StoragePluginWrapper *plugin,
+            const QString &collectionName,
+            const Sailfish::Secrets::Secret::FilterData &filter,
+            Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator);
 
     Sailfish::Secrets::Result reencrypt(
             StoragePluginWrapper *plugin,
@@ -330,17 +374,33 @@ namespace StoragePluginFunctionWrapper {
             const Secret &secret,
             const QByteArray &encryptionKey);
 
+    // the secrets must all be stored in the same collection.
+    StoreSecretsResult encryptAndStoreSecrets(
+            Sailfish::Secrets::EncryptionPlugin *encryptionPlugin,
+            StoragePluginWrapper *storagePlugin,
+            const QVector<SecretMetadata> &secretsMetadata,
+            const QVector<Sailfish::Secrets::Secret> &secrets,
+            const QByteArray &encryptionKey);
+
     SecretResult getAndDecryptSecret(
             Sailfish::Secrets::EncryptionPlugin *encryptionPlugin,
             StoragePluginWrapper *storagePlugin,
             const Sailfish::Secrets::Secret::Identifier &identifier,
             const QByteArray &encryptionKey);
 
+    // the identified secrets must all be stored in the same collection.
+    SecretsResult getAndDecryptSecrets(
+            Sailfish::Secrets::EncryptionPlugin *encryptionPlugin,
+            StoragePluginWrapper *storagePlugin,
+            const QVector<Sailfish::Secrets::Secret::Identifier> &identifiers,
+            const QByteArray &encryptionKey);
+
     Sailfish::Secrets::Result reencryptDeviceLockedCollectionsAndSecrets(
             StoragePluginWrapper *plugin,
             const QMap<QString, EncryptionPlugin*> encryptionPlugins,
             const QByteArray &oldEncryptionKey,
-            const QByteArray &newEncryptionKey);
+            const QByteArray &newEncryptionKey,
+            const QSharedPointer<QAtomicInt> &canceled = QSharedPointer<QAtomicInt>());
 
     Sailfish::Secrets::Result collectionSecretPreCheck(
             StoragePluginWrapper *plugin,
@@ -435,12 +495,26 @@ namespace EncryptedStoragePluginFunctionWrapper {
             const Sailfish::Secrets::Secret &secret,
             const QByteArray &encryptionKey);
 
+    // the secrets must all be stored in the same collection.
+    StoreSecretsResult unlockCollectionAndStoreSecrets(
+            EncryptedStoragePluginWrapper *plugin,
+            const QVector<SecretMetadata> &secretsMetadata,
+            const QVector<Sailfish::Secrets::Secret> &secrets,
+            const QByteArray &encryptionKey);
+
     SecretResult unlockCollectionAndReadSecret(
             EncryptedStoragePluginWrapper *plugin,
             const CollectionMetadata &collectionMetadata,
             const Sailfish::Secrets::Secret::Identifier &identifier,
             const QByteArray &encryptionKey);
 
+    // the identified secrets must all be stored in the collection described by the metadata.
+    SecretsResult unlockCollectionAndReadSecrets(
+            EncryptedStoragePluginWrapper *plugin,
+            const CollectionMetadata &collectionMetadata,
+            const QVector<Sailfish::Secrets::Secret::Identifier> &identifiers,
+            const QByteArray &encryptionKey);
+
     Sailfish::Secrets::Result unlockCollectionAndRemoveSecret(
             EncryptedStoragePluginWrapper *plugin,
             const CollectionMetadata &collectionMetadata,
@@ -454,10 +528,18 @@ namespace EncryptedStoragePluginFunctionWrapper {
             Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator,
             const QByteArray &encryptionKey);
 
+    IdentifiersResult unlockCollectionAndRemoveSecrets(
+            EncryptedStoragePluginWrapper *plugin,
+            const CollectionMetadata &collectionMetadata,
+            const Sailfish::Secrets::Secret::FilterData &filter,
+            Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator,
+            const QByteArray &encryptionKey);
+
     Sailfish::Secrets::Result unlockDeviceLockedCollectionsAndReencrypt(
             EncryptedStoragePluginWrapper *plugin,
             const QByteArray &oldEncryptionKey,
-            const QByteArray &newEncryptionKey);
+            const QByteArray &newEncryptionKey,
+            const QSharedPointer<QAtomicInt> &canceled = QSharedPointer<QAtomicInt>());
 
     Sailfish::Secrets::Result unlockAndRemoveCollection(
             EncryptedStoragePluginWrapper *plugin,
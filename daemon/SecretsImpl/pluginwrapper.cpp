@@ -8,6 +8,8 @@
 #include "pluginwrapper_p.h"
 #include "logging_p.h"
 
+#include <QtCore/QMutexLocker>
+
 using namespace Sailfish::Secrets;
 using namespace Sailfish::Secrets::Daemon::ApiImpl;
 
@@ -23,6 +25,8 @@ PluginWrapper::PluginWrapper(const QString &defaultEncryptionPluginName,
                    autotestMode)
     , m_initialized(false)
     , m_plugin(plugin)
+    , m_metadataCacheGeneration(0)
+    , m_metadataCacheEnabled(false)
 {
 }
 
@@ -66,12 +70,17 @@ bool PluginWrapper::isMasterLocked() const
 
 bool PluginWrapper::masterLock()
 {
+    // Nothing is served from or added to the cache from here on, and
+    // anything read while the metadata db was being locked is dropped.
+    setMetadataCacheEnabled(false);
     Result result = m_metadataDb.lock();
+    clearMetadataCache();
     if (result.code() != Result::Succeeded) {
         qCWarning(lcSailfishSecretsDaemon) << "Unable to lock metadata for plugin"
                                            << m_plugin->name()
                                            << result.errorCode()
                                            << result.errorMessage();
+        setMetadataCacheEnabled(!isMasterLocked());
         return false;
     }
     return true;
@@ -79,6 +88,7 @@ bool PluginWrapper::masterLock()
 
 bool PluginWrapper::masterUnlock(const QByteArray &masterLockKey)
 {
+    clearMetadataCache();
     Result result = m_metadataDb.unlock(masterLockKey);
     if (result.code() == Result::Failed) {
         qCWarning(lcSailfishSecretsDaemon) << "Unable to unlock metadata for plugin"
@@ -87,11 +97,13 @@ bool PluginWrapper::masterUnlock(const QByteArray &masterLockKey)
                                            << result.errorMessage();
         return false;
     }
+    setMetadataCacheEnabled(true);
     return initialize(masterLockKey); // may need to synchronize data between metadataDb and plugin.
 }
 
 bool PluginWrapper::setMasterLockKey(const QByteArray &oldMasterLockKey, const QByteArray &newMasterLockKey)
 {
+    clearMetadataCache();
     Result result = m_metadataDb.reencrypt(oldMasterLockKey, newMasterLockKey);
     if (result.code() == Result::Failed) {
         qCWarning(lcSailfishSecretsDaemon) << "Unable to reencrypt metadata for plugin"
@@ -145,6 +157,157 @@ Sailfish::Secrets::PluginInfo::StatusFlags PluginWrapper::status() const
     return s;
 }
 
+bool PluginWrapper::cachedCollectionMetadata(
+        const QString &collectionName,
+        CollectionMetadata *metadata)
+{
+    QMutexLocker locker(&m_metadataCacheMutex);
+    if (!m_metadataCacheEnabled) {
+        return false;
+    }
+    QHash<QString, CollectionMetadata>::const_iterator it = m_collectionMetadataCache.constFind(collectionName);
+    if (it == m_collectionMetadataCache.constEnd()) {
+        return false;
+    }
+    *metadata = it.value();
+    return true;
+}
+
+bool PluginWrapper::cachedSecretMetadata(
+        const QString &collectionName,
+        const QString &secretName,
+        SecretMetadata *metadata)
+{
+    QMutexLocker locker(&m_metadataCacheMutex);
+    if (!m_metadataCacheEnabled) {
+        return false;
+    }
+    QHash<QPair<QString, QString>, SecretMetadata>::const_iterator it
+            = m_secretMetadataCache.constFind(qMakePair(collectionName, secretName));
+    if (it == m_secretMetadataCache.constEnd()) {
+        return false;
+    }
+    *metadata = it.value();
+    return true;
+}
+
+Result PluginWrapper::readCollectionMetadata(
+        const QString &collectionName,
+        CollectionMetadata *metadata,
+        bool *exists)
+{
+    if (cachedCollectionMetadata(collectionName, metadata)) {
+        *exists = true;
+        return Result(Result::Succeeded);
+    }
+
+    m_metadataCacheMutex.lock();
+    const quint64 generation = m_metadataCacheGeneration;
+    m_metadataCacheMutex.unlock();
+
+    Result result = m_metadataDb.collectionMetadata(collectionName, metadata, exists);
+    if (result.code() == Result::Succeeded && *exists) {
+        QMutexLocker locker(&m_metadataCacheMutex);
+        if (m_metadataCacheEnabled && generation == m_metadataCacheGeneration) {
+            m_collectionMetadataCache.insert(collectionName, *metadata);
+        }
+    }
+    return result;
+}
+
+Result PluginWrapper::readSecretMetadata(
+        const QString &collectionName,
+        const QString &secretName,
+        SecretMetadata *metadata,
+        bool *exists)
+{
+    if (cachedSecretMetadata(collectionName, secretName, metadata)) {
+        *exists = true;
+        return Result(Result::Succeeded);
+    }
+
+    m_metadataCacheMutex.lock();
+    const quint64 generation = m_metadataCacheGeneration;
+    m_metadataCacheMutex.unlock();
+
+    Result result = m_metadataDb.secretMetadata(collectionName, secretName, metadata, exists);
+    if (result.code() == Result::Succeeded && *exists) {
+        QMutexLocker locker(&m_metadataCacheMutex);
+        if (m_metadataCacheEnabled && generation == m_metadataCacheGeneration) {
+            m_secretMetadataCache.insert(qMakePair(collectionName, secretName), *metadata);
+        }
+    }
+    return result;
+}
+
+void PluginWrapper::cacheCollectionMetadata(
+        const CollectionMetadata &metadata)
+{
+    QMutexLocker locker(&m_metadataCacheMutex);
+    ++m_metadataCacheGeneration;
+    if (m_metadataCacheEnabled) {
+        m_collectionMetadataCache.insert(metadata.collectionName, metadata);
+    }
+}
+
+void PluginWrapper::cacheSecretMetadata(
+        const QVector<SecretMetadata> &metadata)
+{
+    QMutexLocker locker(&m_metadataCacheMutex);
+    ++m_metadataCacheGeneration;
+    if (!m_metadataCacheEnabled) {
+        return;
+    }
+    for (const SecretMetadata &secretMetadata : metadata) {
+        m_secretMetadataCache.insert(qMakePair(secretMetadata.collectionName, secretMetadata.secretName),
+                                     secretMetadata);
+    }
+}
+
+void PluginWrapper::uncacheCollectionMetadata(
+        const QString &collectionName)
+{
+    QMutexLocker locker(&m_metadataCacheMutex);
+    ++m_metadataCacheGeneration;
+    m_collectionMetadataCache.remove(collectionName);
+    QHash<QPair<QString, QString>, SecretMetadata>::iterator it = m_secretMetadataCache.begin();
+    while (it != m_secretMetadataCache.end()) {
+        if (it.key().first == collectionName) {
+            it = m_secretMetadataCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void PluginWrapper::uncacheSecretMetadata(
+        const QString &collectionName,
+        const QStringList &secretNames)
+{
+    QMutexLocker locker(&m_metadataCacheMutex);
+    ++m_metadataCacheGeneration;
+    for (const QString &secretName : secretNames) {
+        m_secretMetadataCache.remove(qMakePair(collectionName, secretName));
+    }
+}
+
+void PluginWrapper::clearMetadataCache()
+{
+    QMutexLocker locker(&m_metadataCacheMutex);
+    ++m_metadataCacheGeneration;
+    m_collectionMetadataCache.clear();
+    m_secretMetadataCache.clear();
+}
+
+void PluginWrapper::setMetadataCacheEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_metadataCacheMutex);
+    ++m_metadataCacheGeneration;
+    m_collectionMetadataCache.clear();
+    m_secretMetadataCache.clear();
+    m_metadataCacheEnabled = enabled;
+}
+
 // ---------------------------------------------------------------------------
 
 StoragePluginWrapper::StoragePluginWrapper(
@@ -227,6 +390,7 @@ bool StoragePluginWrapper::initialize(const QByteArray &masterLockKey)
         qCWarning(lcSailfishSecretsDaemon) << "cannot commit changes:"
                                            << m_metadataDb.errorMessage();
     }
+    clearMetadataCache();
 
     m_initialized = initCollections && initSecrets;
     return true;
@@ -274,6 +438,15 @@ Result StoragePluginWrapper::getSecret(
     return m_storagePlugin->getSecret(collectionName, secretName, secret, filterData);
 }
 
+Result StoragePluginWrapper::getSecrets(
+        const QString &collectionName,
+        const QStringList &secretNames,
+        QVector<QByteArray> *secrets,
+        QVector<Secret::FilterData> *filterData)
+{
+    return m_storagePlugin->getSecrets(collectionName, secretNames, secrets, filterData);
+}
+
 Result StoragePluginWrapper::findSecrets(
         const QString &collectionName,
         const Secret::FilterData &filter,
@@ -301,13 +474,18 @@ Result StoragePluginWrapper::collectionMetadata(
         const QString &collectionName,
         CollectionMetadata *metadata)
 {
+    // metadata is only cached while the metadata db is master-unlocked.
+    if (cachedCollectionMetadata(collectionName, metadata)) {
+        return Result(Result::Succeeded);
+    }
+
     if (isMasterLocked()) {
         return Result(Result::SecretsPluginIsLockedError,
                       QStringLiteral("Plugin %1 is master-locked").arg(m_storagePlugin->name()));
     }
 
     bool exists = false;
-    Result result = m_metadataDb.collectionMetadata(collectionName, metadata, &exists);
+    Result result = readCollectionMetadata(collectionName, metadata, &exists);
     return exists ? result
                   : Result(Result::InvalidCollectionError,
                            QStringLiteral("Collection %1 does not exist").arg(collectionName));
@@ -318,13 +496,17 @@ Result StoragePluginWrapper::secretMetadata(
         const QString &secretName,
         SecretMetadata *metadata)
 {
+    if (cachedSecretMetadata(collectionName, secretName, metadata)) {
+        return Result(Result::Succeeded);
+    }
+
     if (isMasterLocked()) {
         return Result(Result::SecretsPluginIsLockedError,
                       QStringLiteral("Plugin %1 is master-locked").arg(m_storagePlugin->name()));
     }
 
     bool exists = false;
-    Result result = m_metadataDb.secretMetadata(collectionName, secretName, metadata, &exists);
+    Result result = readSecretMetadata(collectionName, secretName, metadata, &exists);
     return exists ? result
                   : Result(Result::InvalidSecretError,
                            QStringLiteral("Secret %1 does not exist in collection %2").arg(secretName, collectionName));
@@ -345,7 +527,7 @@ Result StoragePluginWrapper::createCollection(
 
     bool exists = false;
     CollectionMetadata existingMetadata;
-    Result result = m_metadataDb.collectionMetadata(metadata.collectionName, &existingMetadata, &exists);
+    Result result = readCollectionMetadata(metadata.collectionName, &existingMetadata, &exists);
     if (exists) {
         return Result(Result::CollectionAlreadyExistsError,
                       QStringLiteral("Collection %1 already exists").arg(metadata.collectionName));
@@ -370,7 +552,12 @@ Result StoragePluginWrapper::createCollection(
         return result;
     }
 
-    m_metadataDb.commitTransaction();
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for createCollection"));
+    }
+    cacheCollectionMetadata(metadata);
     return Result(Result::Succeeded);
 }
 
@@ -404,7 +591,12 @@ Result StoragePluginWrapper::removeCollection(
         return result;
     }
 
-    m_metadataDb.commitTransaction();
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for removeCollection"));
+    }
+    uncacheCollectionMetadata(collectionName);
     return Result(Result::Succeeded);
 }
 
@@ -425,9 +617,9 @@ Result StoragePluginWrapper::setSecret(
 
     bool exists = false;
     CollectionMetadata collectionMetadata;
-    Result result = m_metadataDb.collectionMetadata(metadata.collectionName,
-                                                    &collectionMetadata,
-                                                    &exists);
+    Result result = readCollectionMetadata(metadata.collectionName,
+                                           &collectionMetadata,
+                                           &exists);
     if (result.code() != Result::Succeeded) {
         return result;
     } else if (!exists) {
@@ -437,10 +629,10 @@ Result StoragePluginWrapper::setSecret(
 
     exists = false;
     SecretMetadata currentMetadata;
-    result = m_metadataDb.secretMetadata(metadata.collectionName,
-                                         metadata.secretName,
-                                         &currentMetadata,
-                                         &exists);
+    result = readSecretMetadata(metadata.collectionName,
+                                metadata.secretName,
+                                &currentMetadata,
+                                &exists);
     if (result.code() != Result::Succeeded) {
         return result;
     }
@@ -472,7 +664,103 @@ Result StoragePluginWrapper::setSecret(
         return result;
     }
 
-    m_metadataDb.commitTransaction();
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for setSecret"));
+    }
+    cacheSecretMetadata(QVector<SecretMetadata>() << metadata);
+    return Result(Result::Succeeded);
+}
+
+Result StoragePluginWrapper::setSecrets(
+        const QVector<SecretMetadata> &metadata,
+        const QVector<QByteArray> &secrets,
+        const QVector<Secret::FilterData> &filterData,
+        QVector<Result> *results)
+{
+    if (m_storagePlugin->isLocked()) {
+        return Result(Result::SecretsPluginIsLockedError,
+                      QStringLiteral("Plugin %1 is locked").arg(m_storagePlugin->name()));
+    }
+
+    if (isMasterLocked()) {
+        return Result(Result::SecretsPluginIsLockedError,
+                      QStringLiteral("Plugin %1 is master-locked").arg(m_storagePlugin->name()));
+    }
+
+    // all of the secrets are stored in the same collection.
+    const QString collectionName = metadata.isEmpty() ? QString() : metadata.first().collectionName;
+    bool exists = false;
+    CollectionMetadata collectionMetadata;
+    Result result = readCollectionMetadata(collectionName,
+                                           &collectionMetadata,
+                                           &exists);
+    if (result.code() != Result::Succeeded) {
+        return result;
+    } else if (!exists) {
+        return Result(Result::InvalidCollectionError,
+                      QStringLiteral("Collection %1 does not exist").arg(collectionName));
+    }
+
+    // the secrets are stored all together or not at all, so report each
+    // secret which already exists before starting to write any of them.
+    results->fill(Result(Result::Succeeded), metadata.size());
+    bool alreadyExists = false;
+    for (int i = 0; i < metadata.size(); ++i) {
+        bool secretExists = false;
+        SecretMetadata currentMetadata;
+        result = readSecretMetadata(collectionName,
+                                    metadata.at(i).secretName,
+                                    &currentMetadata,
+                                    &secretExists);
+        if (result.code() != Result::Succeeded) {
+            results->clear();
+            return result;
+        } else if (secretExists) {
+            // don't allow overwriting existing secrets.
+            (*results)[i] = Result(Result::SecretAlreadyExistsError,
+                                   QStringLiteral("Cannot overwrite existing secret %1").arg(metadata.at(i).secretName));
+            alreadyExists = true;
+        }
+    }
+    if (alreadyExists) {
+        return Result(Result::SecretAlreadyExistsError,
+                      QStringLiteral("Cannot overwrite existing secrets"));
+    }
+
+    if (!m_metadataDb.beginTransaction()) {
+        results->clear();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to start metadata db transaction for setSecrets"));
+    }
+
+    QStringList secretNames;
+    secretNames.reserve(metadata.size());
+    for (int i = 0; i < metadata.size(); ++i) {
+        result = m_metadataDb.insertSecretMetadata(metadata.at(i));
+        if (result.code() != Result::Succeeded) {
+            m_metadataDb.rollbackTransaction();
+            (*results)[i] = result;
+            return result;
+        }
+        secretNames.append(metadata.at(i).secretName);
+    }
+
+    result = m_storagePlugin->setSecrets(collectionName, secretNames, secrets, filterData);
+    if (result.code() != Result::Succeeded) {
+        m_metadataDb.rollbackTransaction();
+        results->clear();
+        return result;
+    }
+
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        results->clear();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for setSecrets"));
+    }
+    cacheSecretMetadata(metadata);
     return Result(Result::Succeeded);
 }
 
@@ -507,10 +795,60 @@ Result StoragePluginWrapper::removeSecret(
         return result;
     }
 
-    m_metadataDb.commitTransaction();
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for removeSecret"));
+    }
+    uncacheSecretMetadata(collectionName, QStringList() << secretName);
     return Result(Result::Succeeded);
 }
 
+Result StoragePluginWrapper::removeSecrets(
+        const QString &collectionName,
+        const Secret::FilterData &filter,
+        StoragePlugin::FilterOperator filterOperator,
+        QStringList *secretNames)
+{
+    secretNames->clear();
+
+    if (m_storagePlugin->isLocked()) {
+        return Result(Result::SecretsPluginIsLockedError,
+                      QStringLiteral("Plugin %1 is locked").arg(m_storagePlugin->name()));
+    }
+
+    if (isMasterLocked()) {
+        return Result(Result::SecretsPluginIsLockedError,
+                      QStringLiteral("Plugin %1 is master-locked").arg(m_storagePlugin->name()));
+    }
+
+    if (!m_metadataDb.beginTransaction()) {
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to start metadata db transaction for removeSecrets"));
+    }
+
+    // the matching secrets are only known once the plugin has removed them,
+    // so their metadata is deleted afterwards, within the same transaction.
+    // If the plugin failed, the names of any secrets which it nonetheless
+    // removed are reported, and their metadata must be deleted also.
+    Result pluginResult = m_storagePlugin->removeSecrets(collectionName, filter, filterOperator, secretNames);
+    if (!secretNames->isEmpty()) {
+        Result metadataResult = m_metadataDb.deleteSecretsMetadata(collectionName, *secretNames);
+        if (metadataResult.code() != Result::Succeeded) {
+            m_metadataDb.rollbackTransaction();
+            return metadataResult;
+        }
+    }
+
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for removeSecrets"));
+    }
+    uncacheSecretMetadata(collectionName, *secretNames);
+    return pluginResult;
+}
+
 // ---------------------------------------------------------------------------
 
 EncryptedStoragePluginWrapper::EncryptedStoragePluginWrapper(
@@ -594,6 +932,7 @@ bool EncryptedStoragePluginWrapper::initialize(const QByteArray &masterLockKey)
             qCWarning(lcSailfishSecretsDaemon) << "cannot commit changes:"
                                                << m_metadataDb.errorMessage();
         }
+        clearMetadataCache();
         m_initialized = initCollections && initSecrets && lockedCollections.isEmpty();
     }
 
@@ -701,6 +1040,15 @@ Result EncryptedStoragePluginWrapper::getSecret(
     return m_encryptedStoragePlugin->getSecret(collectionName, secretName, secret, filterData);
 }
 
+Result EncryptedStoragePluginWrapper::getSecrets(
+        const QString &collectionName,
+        const QStringList &secretNames,
+        QVector<QByteArray> *secrets,
+        QVector<Secret::FilterData> *filterData)
+{
+    return m_encryptedStoragePlugin->getSecrets(collectionName, secretNames, secrets, filterData);
+}
+
 Result EncryptedStoragePluginWrapper::findSecrets(
         const QString &collectionName,
         const Secret::FilterData &filter,
@@ -723,6 +1071,11 @@ Result EncryptedStoragePluginWrapper::collectionMetadata(
         const QString &collectionName,
         CollectionMetadata *metadata)
 {
+    // metadata is only cached while the metadata db is master-unlocked.
+    if (cachedCollectionMetadata(collectionName, metadata)) {
+        return Result(Result::Succeeded);
+    }
+
     if (isMasterLocked()) {
         return Result(Result::SecretsPluginIsLockedError,
                       QStringLiteral("Plugin %1 is master-locked")
@@ -730,7 +1083,7 @@ Result EncryptedStoragePluginWrapper::collectionMetadata(
     }
 
     bool exists = false;
-    Result result = m_metadataDb.collectionMetadata(collectionName, metadata, &exists);
+    Result result = readCollectionMetadata(collectionName, metadata, &exists);
     return exists ? result
                   : Result(Result::InvalidCollectionError,
                            QStringLiteral("Collection %1 does not exist")
@@ -742,6 +1095,10 @@ Result EncryptedStoragePluginWrapper::secretMetadata(
         const QString &secretName,
         SecretMetadata *metadata)
 {
+    if (cachedSecretMetadata(collectionName, secretName, metadata)) {
+        return Result(Result::Succeeded);
+    }
+
     if (isMasterLocked()) {
         return Result(Result::SecretsPluginIsLockedError,
                       QStringLiteral("Plugin %1 is master-locked")
@@ -749,7 +1106,7 @@ Result EncryptedStoragePluginWrapper::secretMetadata(
     }
 
     bool exists = false;
-    Result result = m_metadataDb.secretMetadata(collectionName, secretName, metadata, &exists);
+    Result result = readSecretMetadata(collectionName, secretName, metadata, &exists);
     return exists ? result
                   : Result(Result::InvalidSecretError,
                            QStringLiteral("Secret %1 does not exist in collection %2")
@@ -774,7 +1131,7 @@ Result EncryptedStoragePluginWrapper::createCollection(
 
     bool exists = false;
     CollectionMetadata existingMetadata;
-    Result result = m_metadataDb.collectionMetadata(
+    Result result = readCollectionMetadata(
                 metadata.collectionName, &existingMetadata, &exists);
     if (exists) {
         return Result(Result::CollectionAlreadyExistsError,
@@ -801,7 +1158,12 @@ Result EncryptedStoragePluginWrapper::createCollection(
         return result;
     }
 
-    m_metadataDb.commitTransaction();
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for createCollection"));
+    }
+    cacheCollectionMetadata(metadata);
 
     // if the collection should be relocked, relock it.
     if ((metadata.usesDeviceLockKey && metadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked)
@@ -844,7 +1206,12 @@ Result EncryptedStoragePluginWrapper::removeCollection(
         return result;
     }
 
-    m_metadataDb.commitTransaction();
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for removeCollection"));
+    }
+    uncacheCollectionMetadata(collectionName);
     return Result(Result::Succeeded);
 }
 
@@ -893,7 +1260,103 @@ Result EncryptedStoragePluginWrapper::setSecret(
         return result;
     }
 
-    m_metadataDb.commitTransaction();
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for setSecret"));
+    }
+    cacheSecretMetadata(QVector<SecretMetadata>() << metadata);
+    return Result(Result::Succeeded);
+}
+
+Result EncryptedStoragePluginWrapper::setSecrets(
+        const QVector<SecretMetadata> &metadata,
+        const QVector<QByteArray> &secrets,
+        const QVector<Secret::FilterData> &filterData,
+        QVector<Result> *results)
+{
+    if (m_encryptedStoragePlugin->isLocked()) {
+        return Result(Result::SecretsPluginIsLockedError,
+                      QStringLiteral("Plugin %1 is locked")
+                      .arg(m_encryptedStoragePlugin->name()));
+    }
+
+    if (isMasterLocked()) {
+        return Result(Result::SecretsPluginIsLockedError,
+                      QStringLiteral("Plugin %1 is master-locked")
+                      .arg(m_encryptedStoragePlugin->name()));
+    }
+
+    // all of the secrets are stored in the same collection.
+    const QString collectionName = metadata.isEmpty() ? QString() : metadata.first().collectionName;
+    bool locked = false;
+    Result result = m_encryptedStoragePlugin->isCollectionLocked(collectionName, &locked);
+    if (locked) {
+        return Result(Result::CollectionIsLockedError,
+                      QStringLiteral("Collection %1 from plugin %2 is locked")
+                      .arg(collectionName, m_encryptedStoragePlugin->name()));
+    } else if (result.code() != Result::Succeeded) {
+        return result;
+    }
+
+    // the secrets are stored all together or not at all, so report each
+    // secret which already exists before starting to write any of them.
+    results->fill(Result(Result::Succeeded), metadata.size());
+    bool alreadyExists = false;
+    for (int i = 0; i < metadata.size(); ++i) {
+        bool secretExists = false;
+        SecretMetadata currentMetadata;
+        result = readSecretMetadata(collectionName,
+                                    metadata.at(i).secretName,
+                                    &currentMetadata,
+                                    &secretExists);
+        if (result.code() != Result::Succeeded) {
+            results->clear();
+            return result;
+        } else if (secretExists) {
+            // don't allow overwriting existing secrets.
+            (*results)[i] = Result(Result::SecretAlreadyExistsError,
+                                   QStringLiteral("Cannot overwrite existing secret %1").arg(metadata.at(i).secretName));
+            alreadyExists = true;
+        }
+    }
+    if (alreadyExists) {
+        return Result(Result::SecretAlreadyExistsError,
+                      QStringLiteral("Cannot overwrite existing secrets"));
+    }
+
+    if (!m_metadataDb.beginTransaction()) {
+        results->clear();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to start metadata db transaction for setSecrets"));
+    }
+
+    QStringList secretNames;
+    secretNames.reserve(metadata.size());
+    for (int i = 0; i < metadata.size(); ++i) {
+        result = m_metadataDb.insertSecretMetadata(metadata.at(i));
+        if (result.code() != Result::Succeeded) {
+            m_metadataDb.rollbackTransaction();
+            (*results)[i] = result;
+            return result;
+        }
+        secretNames.append(metadata.at(i).secretName);
+    }
+
+    result = m_encryptedStoragePlugin->setSecrets(collectionName, secretNames, secrets, filterData);
+    if (result.code() != Result::Succeeded) {
+        m_metadataDb.rollbackTransaction();
+        results->clear();
+        return result;
+    }
+
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        results->clear();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for setSecrets"));
+    }
+    cacheSecretMetadata(metadata);
     return Result(Result::Succeeded);
 }
 
@@ -940,10 +1403,72 @@ Result EncryptedStoragePluginWrapper::removeSecret(
         return result;
     }
 
-    m_metadataDb.commitTransaction();
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for removeSecret"));
+    }
+    uncacheSecretMetadata(collectionName, QStringList() << secretName);
     return Result(Result::Succeeded);
 }
 
+Result EncryptedStoragePluginWrapper::removeSecrets(
+        const QString &collectionName,
+        const Secret::FilterData &filter,
+        StoragePlugin::FilterOperator filterOperator,
+        QStringList *secretNames)
+{
+    secretNames->clear();
+
+    if (m_encryptedStoragePlugin->isLocked()) {
+        return Result(Result::SecretsPluginIsLockedError,
+                      QStringLiteral("Plugin %1 is locked")
+                      .arg(m_encryptedStoragePlugin->name()));
+    }
+
+    if (isMasterLocked()) {
+        return Result(Result::SecretsPluginIsLockedError,
+                      QStringLiteral("Plugin %1 is master-locked")
+                      .arg(m_encryptedStoragePlugin->name()));
+    }
+
+    bool locked = false;
+    Result result = m_encryptedStoragePlugin->isCollectionLocked(collectionName, &locked);
+    if (locked) {
+        return Result(Result::CollectionIsLockedError,
+                      QStringLiteral("Collection %1 in plugin %2 is locked")
+                      .arg(collectionName, m_encryptedStoragePlugin->name()));
+    } else if (result.code() != Result::Succeeded) {
+        return result;
+    }
+
+    if (!m_metadataDb.beginTransaction()) {
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to start metadata db transaction for removeSecrets"));
+    }
+
+    // the matching secrets are only known once the plugin has removed them,
+    // so their metadata is deleted afterwards, within the same transaction.
+    // If the plugin failed, the names of any secrets which it nonetheless
+    // removed are reported, and their metadata must be deleted also.
+    Result pluginResult = m_encryptedStoragePlugin->removeSecrets(collectionName, filter, filterOperator, secretNames);
+    if (!secretNames->isEmpty()) {
+        Result metadataResult = m_metadataDb.deleteSecretsMetadata(collectionName, *secretNames);
+        if (metadataResult.code() != Result::Succeeded) {
+            m_metadataDb.rollbackTransaction();
+            return metadataResult;
+        }
+    }
+
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for removeSecrets"));
+    }
+    uncacheSecretMetadata(collectionName, *secretNames);
+    return pluginResult;
+}
+
 Result EncryptedStoragePluginWrapper::setSecret(
         const SecretMetadata &metadata,
         const QByteArray &secret,
@@ -964,9 +1489,9 @@ Result EncryptedStoragePluginWrapper::setSecret(
 
     bool exists = false;
     CollectionMetadata collectionMetadata;
-    Result result = m_metadataDb.collectionMetadata(metadata.collectionName,
-                                                    &collectionMetadata,
-                                                    &exists);
+    Result result = readCollectionMetadata(metadata.collectionName,
+                                           &collectionMetadata,
+                                           &exists);
     if (result.code() != Result::Succeeded) {
         return result;
     } else if (!exists) {
@@ -976,10 +1501,10 @@ Result EncryptedStoragePluginWrapper::setSecret(
 
     exists = false;
     SecretMetadata currentMetadata;
-    result = m_metadataDb.secretMetadata(metadata.collectionName,
-                                         metadata.secretName,
-                                         &currentMetadata,
-                                         &exists);
+    result = readSecretMetadata(metadata.collectionName,
+                                metadata.secretName,
+                                &currentMetadata,
+                                &exists);
     if (result.code() != Result::Succeeded) {
         return result;
     }
@@ -1009,6 +1534,11 @@ Result EncryptedStoragePluginWrapper::setSecret(
         return result;
     }
 
-    m_metadataDb.commitTransaction();
+    if (!m_metadataDb.commitTransaction()) {
+        m_metadataDb.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QStringLiteral("Unable to commit metadata db transaction for setSecret"));
+    }
+    cacheSecretMetadata(QVector<SecretMetadata>() << metadata);
     return Result(Result::Succeeded);
 }
@@ -18,7 +18,12 @@
 #include "Secrets/result.h"
 
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 #include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtCore/QVector>
 
 namespace Sailfish {
 
@@ -68,11 +73,33 @@ public:
     bool setMasterLockKey(const QByteArray &oldMasterLockKey, const QByteArray &newMasterLockKey);
 
 protected:
+    // the metadata is cached in memory, and the cache is written through
+    // by the insert and delete operations once they have been committed.
+    // The cache is cleared whenever the metadata db is master-locked or
+    // resynchronized with the plugin, so cached metadata is only ever
+    // returned while the metadata db is master-unlocked.
+    bool cachedCollectionMetadata(const QString &collectionName, CollectionMetadata *metadata);
+    bool cachedSecretMetadata(const QString &collectionName, const QString &secretName, SecretMetadata *metadata);
+    Sailfish::Secrets::Result readCollectionMetadata(const QString &collectionName, CollectionMetadata *metadata, bool *exists);
+    Sailfish::Secrets::Result readSecretMetadata(const QString &collectionName, const QString &secretName, SecretMetadata *metadata, bool *exists);
+    void cacheCollectionMetadata(const CollectionMetadata &metadata);
+    void cacheSecretMetadata(const QVector<SecretMetadata> &metadata);
+    void uncacheCollectionMetadata(const QString &collectionName);
+    void uncacheSecretMetadata(const QString &collectionName, const QStringList &secretNames);
+    void clearMetadataCache();
+    void setMetadataCacheEnabled(bool enabled);
+
     MetadataDatabase m_metadataDb;
     bool m_initialized;
 
 private:
     Sailfish::Secrets::PluginBase *m_plugin;
+
+    QMutex m_metadataCacheMutex;
+    QHash<QString, CollectionMetadata> m_collectionMetadataCache;
+    QHash<QPair<QString, QString>, SecretMetadata> m_secretMetadataCache;
+    quint64 m_metadataCacheGeneration; // advanced by every change, so that stale reads are not cached.
+    bool m_metadataCacheEnabled; // only while the metadata db is master-unlocked.
 };
 
 class StoragePluginWrapper : public PluginWrapper
@@ -96,9 +123,12 @@ public:
     Sailfish::Secrets::Result createCollection(const CollectionMetadata &metadata);
     Sailfish::Secrets::Result removeCollection(const QString &collectionName);
     Sailfish::Secrets::Result setSecret(const SecretMetadata &metadata, const QByteArray &secret, const Sailfish::Secrets::Secret::FilterData &filterData);
+    Sailfish::Secrets::Result setSecrets(const QVector<SecretMetadata> &metadata, const QVector<QByteArray> &secrets, const QVector<Sailfish::Secrets::Secret::FilterData> &filterData, QVector<Sailfish::Secrets::Result> *results);
     Sailfish::Secrets::Result getSecret(const QString &collectionName, const QString &secretName, QByteArray *secret, Sailfish::Secrets::Secret::FilterData *filterData);
+    Sailfish::Secrets::Result getSecrets(const QString &collectionName, const QStringList &secretNames, QVector<QByteArray> *secrets, QVector<Sailfish::Secrets::Secret::FilterData> *filterData);
     Sailfish::Secrets::Result findSecrets(const QString &collectionName, const Sailfish::Secrets::Secret::FilterData &filter, Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator, QStringList *secretNames);
     Sailfish::Secrets::Result removeSecret(const QString &collectionName, const QString &secretName);
+    Sailfish::Secrets::Result removeSecrets(const QString &collectionName, const Sailfish::Secrets::Secret::FilterData &filter, Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator, QStringList *secretNames);
 
     Sailfish::Secrets::Result reencrypt(
             const QString &collectionName,  // if non-empty, all secrets in this collection will be re-encrypted
@@ -139,9 +169,12 @@ public:
     Sailfish::Secrets::Result reencrypt(const QString &collectionName, const QByteArray &oldkey, const QByteArray &newkey);
 
     Sailfish::Secrets::Result setSecret(const SecretMetadata &metadata, const QByteArray &secret, const Sailfish::Secrets::Secret::FilterData &filterData);
+    Sailfish::Secrets::Result setSecrets(const QVector<SecretMetadata> &metadata, const QVector<QByteArray> &secrets, const QVector<Sailfish::Secrets::Secret::FilterData> &filterData, QVector<Sailfish::Secrets::Result> *results);
     Sailfish::Secrets::Result getSecret(const QString &collectionName, const QString &secretName, QByteArray *secret, Sailfish::Secrets::Secret::FilterData *filterData);
+    Sailfish::Secrets::Result getSecrets(const QString &collectionName, const QStringList &secretNames, QVector<QByteArray> *secrets, QVector<Sailfish::Secrets::Secret::FilterData> *filterData);
     Sailfish::Secrets::Result findSecrets(const QString &collectionName, const Sailfish::Secrets::Secret::FilterData &filter, Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator, QVector<Sailfish::Secrets::Secret::Identifier> *identifiers);
     Sailfish::Secrets::Result removeSecret(const QString &collectionName, const QString &secretName);
+    Sailfish::Secrets::Result removeSecrets(const QString &collectionName, const Sailfish::Secrets::Secret::FilterData &filter, Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator, QStringList *secretNames);
 
     Sailfish::Secrets::Result setSecret(const SecretMetadata &metadata, const QByteArray &secret, const Sailfish::Secrets::Secret::FilterData &filterData, const QByteArray &key);
     Sailfish::Secrets::Result accessSecret(const QString &secretName, const QByteArray &key, QByteArray *secret, Sailfish::Secrets::Secret::FilterData *filterData);
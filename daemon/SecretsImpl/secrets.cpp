@@ -8,6 +8,7 @@
 #include "secrets_p.h"
 #include "secretsrequestprocessor_p.h"
 #include "logging_p.h"
+#include "plugin_p.h"
 
 #include "../CryptoImpl/crypto_p.h"
 #include "../CryptoImpl/cryptopluginfunctionwrappers_p.h"
@@ -31,8 +32,6 @@
 #include <QtCore/QDir>
 #include <QtCore/QCryptographicHash>
 
-#include <QtConcurrent>
-
 #include <sys/mman.h>
 
 #if defined(HAS_NEMO_NOTIFICATIONS)
@@ -79,6 +78,17 @@ namespace {
         return retn;
     }
 
+    QVector<Sailfish::Secrets::Secret> mapPluginNames(
+            Sailfish::Secrets::Daemon::Controller *controller,
+            const QVector<Sailfish::Secrets::Secret> &secrets) {
+        QVector<Sailfish::Secrets::Secret> retn;
+        retn.reserve(secrets.size());
+        for (const Sailfish::Secrets::Secret &secret : secrets) {
+            retn.append(mapPluginNames(controller, secret));
+        }
+        return retn;
+    }
+
     Sailfish::Secrets::Secret::Identifier mapPluginNames(
             Sailfish::Secrets::Daemon::Controller *controller,
             const Sailfish::Secrets::Secret::Identifier &ident) {
@@ -87,6 +97,17 @@ namespace {
         return retn;
     }
 
+    QVector<Sailfish::Secrets::Secret::Identifier> mapPluginNames(
+            Sailfish::Secrets::Daemon::Controller *controller,
+            const QVector<Sailfish::Secrets::Secret::Identifier> &idents) {
+        QVector<Sailfish::Secrets::Secret::Identifier> retn;
+        retn.reserve(idents.size());
+        for (const Sailfish::Secrets::Secret::Identifier &ident : idents) {
+            retn.append(mapPluginNames(controller, ident));
+        }
+        return retn;
+    }
+
     Sailfish::Secrets::InteractionParameters mapPluginNames(
             Sailfish::Secrets::Daemon::Controller *controller,
             const Sailfish::Secrets::InteractionParameters &uiParams) {
@@ -151,6 +172,21 @@ void Daemon::ApiImpl::SecretsDBusObject::getHealthInfo(
                                   result);
 }
 
+// retrieve the request latency statistics of the daemon
+void Daemon::ApiImpl::SecretsDBusObject::getStatistics(
+        const QDBusMessage &message,
+        Result &result,
+        QVariantMap &statistics)
+{
+    Q_UNUSED(statistics);   // outparam, set in handlePendingRequest / handleFinishedRequest
+    QList<QVariant> inParams;
+    m_requestQueue->handleRequest(Daemon::ApiImpl::GetStatisticsRequest,
+                                  inParams,
+                                  connection(),
+                                  message,
+                                  result);
+}
+
 // retrieve user input for the client (daemon)
 void Daemon::ApiImpl::SecretsDBusObject::userInput(
         const InteractionParameters &uiParams,
@@ -294,6 +330,27 @@ void Daemon::ApiImpl::SecretsDBusObject::setSecret(
                                   result);
 }
 
+// set multiple secrets in a collection
+void Daemon::ApiImpl::SecretsDBusObject::setSecrets(
+        const QVector<Secret> &secrets,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const QDBusMessage &message,
+        Result &result,
+        QVector<Result> &results)
+{
+    Q_UNUSED(results); // outparam, set in handlePendingRequest / handleFinishedRequest
+    QList<QVariant> inParams;
+    inParams << QVariant::fromValue<QVector<Secret> >(MAP_PLUGIN_NAMES(secrets))
+             << QVariant::fromValue<SecretManager::UserInteractionMode>(userInteractionMode)
+             << QVariant::fromValue<QString>(interactionServiceAddress);
+    m_requestQueue->handleRequest(Daemon::ApiImpl::SetCollectionSecretsRequest,
+                                  inParams,
+                                  connection(),
+                                  message,
+                                  result);
+}
+
 // set a standalone DeviceLock-protected secret
 void Daemon::ApiImpl::SecretsDBusObject::setSecret(
         const Secret &secret,
@@ -373,6 +430,27 @@ void Daemon::ApiImpl::SecretsDBusObject::getSecret(
                                   result);
 }
 
+// get multiple collection secrets
+void Daemon::ApiImpl::SecretsDBusObject::getSecrets(
+        const QVector<Secret::Identifier> &identifiers,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const QDBusMessage &message,
+        Result &result,
+        QVector<Secret> &secrets)
+{
+    Q_UNUSED(secrets); // outparam, set in handlePendingRequest / handleFinishedRequest
+    QList<QVariant> inParams;
+    inParams << QVariant::fromValue<QVector<Secret::Identifier> >(MAP_PLUGIN_NAMES(identifiers))
+             << QVariant::fromValue<SecretManager::UserInteractionMode>(userInteractionMode)
+             << QVariant::fromValue<QString>(interactionServiceAddress);
+    m_requestQueue->handleRequest(Daemon::ApiImpl::GetCollectionSecretsRequest,
+                                  inParams,
+                                  connection(),
+                                  message,
+                                  result);
+}
+
 // find secrets via filter
 void Daemon::ApiImpl::SecretsDBusObject::findSecrets(
         const QString &collectionName,
@@ -425,6 +503,33 @@ void Daemon::ApiImpl::SecretsDBusObject::deleteSecret(
                                   result);
 }
 
+// delete the secrets in a collection which match a filter
+void Daemon::ApiImpl::SecretsDBusObject::deleteSecrets(
+        const QString &collectionName,
+        const QString &storagePluginName,
+        const Secret::FilterData &filter,
+        SecretManager::FilterOperator filterOperator,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const QDBusMessage &message,
+        Result &result,
+        QVector<Secret::Identifier> &identifiers)
+{
+    Q_UNUSED(identifiers); // outparam, set in handlePendingRequest / handleFinishedRequest
+    QList<QVariant> inParams;
+    inParams << QVariant::fromValue<QString>(collectionName)
+             << QVariant::fromValue<QString>(MAP_PLUGIN_NAMES(storagePluginName))
+             << QVariant::fromValue<Secret::FilterData>(filter)
+             << QVariant::fromValue<SecretManager::FilterOperator>(filterOperator)
+             << QVariant::fromValue<SecretManager::UserInteractionMode>(userInteractionMode)
+             << QVariant::fromValue<QString>(interactionServiceAddress);
+    m_requestQueue->handleRequest(Daemon::ApiImpl::DeleteCollectionSecretsRequest,
+                                  inParams,
+                                  connection(),
+                                  message,
+                                  result);
+}
+
 // query lock status of a plugin or metadata db
 void Daemon::ApiImpl::SecretsDBusObject::queryLockStatus(
         LockCodeRequest::LockCodeTargetType lockCodeTargetType,
@@ -513,6 +618,31 @@ void Daemon::ApiImpl::SecretsDBusObject::forgetLockCode(
                                   result);
 }
 
+void Daemon::ApiImpl::SecretsDBusObject::cancelRequest(
+        quint64 sequence,
+        const QString &method)
+{
+    // cancellation is not itself a request, so it is not queued.
+    m_requestQueue->cancelRequest(connection(), sequence, method);
+}
+
+void Daemon::ApiImpl::SecretsDBusObject::setNextRequestTimeout(int timeout)
+{
+    // the deadline is carried by the request which follows on the connection.
+    m_requestQueue->setNextRequestTimeout(connection(), timeout);
+}
+
+void Daemon::ApiImpl::SecretsDBusObject::setNextRequestPipeline(quint64 pipelineId)
+{
+    // like cancellation, this is not itself a request, so it is not queued.
+    m_requestQueue->setNextRequestPipeline(connection(), pipelineId);
+}
+
+void Daemon::ApiImpl::SecretsDBusObject::endPipeline(quint64 pipelineId)
+{
+    m_requestQueue->endPipeline(connection(), pipelineId);
+}
+
 //-----------------------------------
 
 Daemon::ApiImpl::SecretsRequestQueue::SecretsRequestQueue(
@@ -539,10 +669,21 @@ Daemon::ApiImpl::SecretsRequestQueue::SecretsRequestQueue(
     m_secretsThreadPool = QSharedPointer<QThreadPool>::create();
     m_secretsThreadPool->setMaxThreadCount(1);
     m_secretsThreadPool->setExpiryTimeout(-1);
+
+    // each plugin is given a thread of its own.
+    const QStringList pluginNames = Daemon::ApiImpl::PluginManager::instance()->getPlugins<StoragePlugin>().keys()
+                                  + Daemon::ApiImpl::PluginManager::instance()->getPlugins<EncryptedStoragePlugin>().keys()
+                                  + Daemon::ApiImpl::PluginManager::instance()->getPlugins<EncryptionPlugin>().keys();
+    for (const QString &pluginName : pluginNames) {
+        m_pluginThreadPools.addPlugin(pluginName);
+    }
     m_appPermissions = new Daemon::ApiImpl::ApplicationPermissions(this);
     m_requestProcessor = new Daemon::ApiImpl::RequestProcessor(m_appPermissions, autotestMode, this);
 
-    setDBusObject(new Daemon::ApiImpl::SecretsDBusObject(this));
+    Daemon::ApiImpl::SecretsDBusObject *dbusObject = new Daemon::ApiImpl::SecretsDBusObject(this);
+    connect(parent, &Daemon::Controller::pluginInfoChanged,
+            dbusObject, &Daemon::ApiImpl::SecretsDBusObject::pluginInfoChanged);
+    setDBusObject(dbusObject);
     qCDebug(lcSailfishSecretsDaemon) << "Secrets: initialization succeeded, awaiting client connections.";
 }
 
@@ -561,39 +702,27 @@ QWeakPointer<QThreadPool> Daemon::ApiImpl::SecretsRequestQueue::secretsThreadPoo
     return m_secretsThreadPool.toWeakRef();
 }
 
-bool Daemon::ApiImpl::SecretsRequestQueue::generateKeyData(
-        const QByteArray &lockCode,
-        const QString &cipherPluginName,
-        QByteArray *bkdbKey,
-        QByteArray *deviceLockKey,
-        QByteArray *testCipherText,
-        QString *usedCipherPluginName) const
+QWeakPointer<QThreadPool> Daemon::ApiImpl::SecretsRequestQueue::pluginThreadPool(const QString &pluginName)
 {
-    QByteArray salt = saltData();
-    if (salt.isEmpty()) {
-        return false;
-    }
+    // operations on unknown plugins fail without touching any plugin,
+    // so they can be performed by the secrets thread pool.
+    const QWeakPointer<QThreadPool> pool = m_pluginThreadPools.pool(pluginName);
+    return pool ? pool : m_secretsThreadPool.toWeakRef();
+}
 
-    Sailfish::Crypto::Key bookkeepingdbKey, devicelockKey;
-    Sailfish::Crypto::Key keyTemplate;
-    keyTemplate.setAlgorithm(Sailfish::Crypto::CryptoManager::AlgorithmAes);
-    keyTemplate.setSize(256);
-    Sailfish::Crypto::KeyDerivationParameters kdfParams;
-    kdfParams.setKeyDerivationFunction(Sailfish::Crypto::CryptoManager::KdfPkcs5Pbkdf2);
-    kdfParams.setKeyDerivationMac(Sailfish::Crypto::CryptoManager::MacHmac);
-    kdfParams.setKeyDerivationDigestFunction(Sailfish::Crypto::CryptoManager::DigestSha512);
-    kdfParams.setIterations(12000);
-    if (lockCode.isEmpty()) {
-        kdfParams.setInputData(QByteArray(1, '\0'));
-    } else {
-        kdfParams.setInputData(lockCode);
-    }
-    kdfParams.setSalt(salt);
-    kdfParams.setOutputKeySize(256);
+QSharedPointer<Daemon::ApiImpl::PluginThreadPoolBarrier>
+Daemon::ApiImpl::SecretsRequestQueue::pluginThreadPoolBarrier()
+{
+    return m_pluginThreadPools.barrier();
+}
 
+bool Daemon::ApiImpl::SecretsRequestQueue::keyDerivationPlugins(
+        const QString &cipherPluginName,
+        QList<Sailfish::Crypto::CryptoPlugin*> *cplugins) const
+{
     // attempt to find the crypto plugin to use to perform key derivation.
-    const QMap<QString, Sailfish::Crypto::CryptoPlugin*> cplugins = m_controller->crypto()->plugins();
-    Sailfish::Crypto::CryptoPlugin *cplugin = cipherPluginName.isEmpty() ? Q_NULLPTR : cplugins.value(cipherPluginName);
+    const QMap<QString, Sailfish::Crypto::CryptoPlugin*> allPlugins = m_controller->crypto()->plugins();
+    Sailfish::Crypto::CryptoPlugin *cplugin = cipherPluginName.isEmpty() ? Q_NULLPTR : allPlugins.value(cipherPluginName);
     if (cplugin == Q_NULLPTR && !cipherPluginName.isEmpty()) {
         qCWarning(lcSailfishSecretsDaemon) << "Unable to find parameter cipher plugin to generate keys:" << cipherPluginName;
         return false;
@@ -602,9 +731,9 @@ bool Daemon::ApiImpl::SecretsRequestQueue::generateKeyData(
     // attempt to use the plugin specified in the environment variable
     const QString envCPluginName = QString::fromLocal8Bit(qgetenv(ENV_MASTERLOCK_CRYPTOPLUGIN));
     if (!envCPluginName.isEmpty()) {
-        cplugin = m_controller->crypto()->plugins().value(envCPluginName);
+        cplugin = allPlugins.value(envCPluginName);
         if (cplugin == Q_NULLPTR && m_autotestMode) {
-            cplugin = m_controller->crypto()->plugins().value(envCPluginName + QLatin1String(".test"));
+            cplugin = allPlugins.value(envCPluginName + QLatin1String(".test"));
         }
         if (cplugin == Q_NULLPTR) {
             qCWarning(lcSailfishSecretsDaemon) << "Unable to find env-specified cipher plugin to generate keys:" << envCPluginName;
@@ -615,92 +744,72 @@ bool Daemon::ApiImpl::SecretsRequestQueue::generateKeyData(
     // if no plugin was specified in the environment variable, attempt to use the default plugin
     if (cplugin == Q_NULLPTR) {
         cplugin = m_autotestMode
-                ? m_controller->crypto()->plugins().value(
+                ? allPlugins.value(
                         m_controller->mappedPluginName(
                                 Sailfish::Crypto::CryptoManager::DefaultCryptoPluginName + QLatin1String(".test")))
-                : m_controller->crypto()->plugins().value(
+                : allPlugins.value(
                         m_controller->mappedPluginName(
                                 Sailfish::Crypto::CryptoManager::DefaultCryptoPluginName));
     }
 
-    // otherwise, select the first available crypto plugin which can generate the key.
-    if (cplugin == Q_NULLPTR) {
-        for (auto it = cplugins.constBegin(); it != cplugins.constEnd(); ++it) {
-            const QString &currPluginName = it.key();
-            // attempt to generate the bookkeeping db key
-            QFuture<Sailfish::Crypto::KeyResult> future = QtConcurrent::run(
-                    controller()->threadPoolForPlugin(currPluginName).data(),
-                    Sailfish::Crypto::Daemon::ApiImpl::CryptoPluginFunctionWrapper::generateKey,
-                    Sailfish::Crypto::PluginAndCustomParams(it.value(), QVariantMap()),
-                    keyTemplate,
-                    Sailfish::Crypto::KeyPairGenerationParameters(),
-                    kdfParams);
-            future.waitForFinished();
-            Sailfish::Crypto::KeyResult kr = future.result();
-            if (kr.result.code() == Sailfish::Crypto::Result::Succeeded) {
-                Sailfish::Crypto::Key tempKey = kr.key;
-                // attempt to generate the devicelock key
-                kdfParams.setIterations(16000);
-                future = QtConcurrent::run(
-                    controller()->threadPoolForPlugin(currPluginName).data(),
-                    Sailfish::Crypto::Daemon::ApiImpl::CryptoPluginFunctionWrapper::generateKey,
-                    Sailfish::Crypto::PluginAndCustomParams(it.value(), QVariantMap()),
-                    keyTemplate,
-                    Sailfish::Crypto::KeyPairGenerationParameters(),
-                    kdfParams);
-                future.waitForFinished();
-                kr = future.result();
-                if (kr.result.code() == Sailfish::Crypto::Result::Succeeded) {
-                    // successfully found a plugin to generate both keys.
-                    cplugin = it.value();
-                    bookkeepingdbKey = tempKey;
-                    devicelockKey = kr.key;
-                    break;
-                }
-            }
-        }
+    // otherwise, try each available crypto plugin in turn until one can generate the keys.
+    *cplugins = cplugin == Q_NULLPTR
+            ? allPlugins.values()
+            : QList<Sailfish::Crypto::CryptoPlugin*>() << cplugin;
+    return true;
+}
+
+// Performed in a thread of the crypto plugin, as the key derivation is
+// deliberately expensive.
+Daemon::ApiImpl::SecretsRequestQueue::KeyData
+Daemon::ApiImpl::SecretsRequestQueue::deriveKeyData(
+        Sailfish::Crypto::CryptoPlugin *cplugin,
+        Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper,
+        const QByteArray &lockCode,
+        const QByteArray &salt)
+{
+    Daemon::ApiImpl::SecretsRequestQueue::KeyData keyData;
+
+    Sailfish::Crypto::Key keyTemplate;
+    keyTemplate.setAlgorithm(Sailfish::Crypto::CryptoManager::AlgorithmAes);
+    keyTemplate.setSize(256);
+    Sailfish::Crypto::KeyDerivationParameters kdfParams;
+    kdfParams.setKeyDerivationFunction(Sailfish::Crypto::CryptoManager::KdfPkcs5Pbkdf2);
+    kdfParams.setKeyDerivationMac(Sailfish::Crypto::CryptoManager::MacHmac);
+    kdfParams.setKeyDerivationDigestFunction(Sailfish::Crypto::CryptoManager::DigestSha512);
+    kdfParams.setIterations(12000);
+    if (lockCode.isEmpty()) {
+        kdfParams.setInputData(QByteArray(1, '\0'));
     } else {
-        // attempt to generate the bookkeeping db key
-        QFuture<Sailfish::Crypto::KeyResult> future = QtConcurrent::run(
-                controller()->threadPoolForPlugin(cplugin->name()).data(),
-                Sailfish::Crypto::Daemon::ApiImpl::CryptoPluginFunctionWrapper::generateKey,
+        kdfParams.setInputData(lockCode);
+    }
+    kdfParams.setSalt(salt);
+    kdfParams.setOutputKeySize(256);
+
+    // attempt to generate the bookkeeping db key
+    Sailfish::Crypto::KeyResult kr = Sailfish::Crypto::Daemon::ApiImpl::CryptoPluginFunctionWrapper::generateKey(
                 Sailfish::Crypto::PluginAndCustomParams(cplugin, QVariantMap()),
                 keyTemplate,
                 Sailfish::Crypto::KeyPairGenerationParameters(),
                 kdfParams);
-        future.waitForFinished();
-        Sailfish::Crypto::KeyResult kr = future.result();
-        if (kr.result.code() == Sailfish::Crypto::Result::Succeeded) {
-            Sailfish::Crypto::Key tempKey = kr.key;
-            // attempt to generate the devicelock key
-            kdfParams.setIterations(16000);
-            future = QtConcurrent::run(
-                controller()->threadPoolForPlugin(cplugin->name()).data(),
-                Sailfish::Crypto::Daemon::ApiImpl::CryptoPluginFunctionWrapper::generateKey,
+    if (kr.result.code() != Sailfish::Crypto::Result::Succeeded) {
+        qCWarning(lcSailfishSecretsDaemon) << "Unable to generate bookkeeping database key:" << kr.result.errorMessage();
+        return keyData;
+    }
+    const Sailfish::Crypto::Key bookkeepingdbKey = kr.key;
+
+    // attempt to generate the devicelock key
+    kdfParams.setIterations(16000);
+    kr = Sailfish::Crypto::Daemon::ApiImpl::CryptoPluginFunctionWrapper::generateKey(
                 Sailfish::Crypto::PluginAndCustomParams(cplugin, QVariantMap()),
                 keyTemplate,
                 Sailfish::Crypto::KeyPairGenerationParameters(),
                 kdfParams);
-            future.waitForFinished();
-            kr = future.result();
-            if (kr.result.code() == Sailfish::Crypto::Result::Succeeded) {
-                // successfully generated both keys.
-                bookkeepingdbKey = tempKey;
-                devicelockKey = kr.key;
-            } else {
-                qCWarning(lcSailfishSecretsDaemon) << "Unable to generate device lock key:" << kr.result.errorMessage();
-                return false;
-            }
-        } else {
-            qCWarning(lcSailfishSecretsDaemon) << "Unable to generate bookkeeping database key:" << kr.result.errorMessage();
-            return false;
-        }
-    }
-
-    if (cplugin == Q_NULLPTR) {
-        qCWarning(lcSailfishSecretsDaemon) << "Unable to find a valid crypto plugin for key initialization";
-        return false;
+    if (kr.result.code() != Sailfish::Crypto::Result::Succeeded) {
+        qCWarning(lcSailfishSecretsDaemon) << "Unable to generate device lock key:" << kr.result.errorMessage();
+        return keyData;
     }
+    const Sailfish::Crypto::Key devicelockKey = kr.key;
 
     // now generate the test cipher text with the new bkdbKey.
     // we will compare this to one stored on device, to see if
@@ -711,56 +820,144 @@ bool Daemon::ApiImpl::SecretsRequestQueue::generateKeyData(
                 salt + bookkeepingdbKey.secretKey(),
                 QCryptographicHash::Sha512).mid(0, 16);
 
-    Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper(cryptoStoragePluginWrapper(cplugin->name()));
-    QFuture<Sailfish::Crypto::TagDataResult> future = QtConcurrent::run(
-            controller()->threadPoolForPlugin(cplugin->name()).data(),
-            Sailfish::Crypto::Daemon::ApiImpl::CryptoPluginFunctionWrapper::encrypt,
-            Sailfish::Crypto::PluginWrapperAndCustomParams(cplugin, wrapper, QVariantMap()),
-            Sailfish::Crypto::DataAndIV(plaintext, iv),
-            Sailfish::Crypto::KeyAndCollectionKey(bookkeepingdbKey, QByteArray()),
-            Sailfish::Crypto::EncryptionOptions(Sailfish::Crypto::CryptoManager::BlockModeCbc,
-                                                Sailfish::Crypto::CryptoManager::EncryptionPaddingNone),
-            QByteArray());
-
-    future.waitForFinished();
-    Sailfish::Crypto::TagDataResult tdr = future.result();
+    const Sailfish::Crypto::TagDataResult tdr = Sailfish::Crypto::Daemon::ApiImpl::CryptoPluginFunctionWrapper::encrypt(
+                Sailfish::Crypto::PluginWrapperAndCustomParams(cplugin, wrapper, QVariantMap()),
+                Sailfish::Crypto::DataAndIV(plaintext, iv),
+                Sailfish::Crypto::KeyAndCollectionKey(bookkeepingdbKey, QByteArray()),
+                Sailfish::Crypto::EncryptionOptions(Sailfish::Crypto::CryptoManager::BlockModeCbc,
+                                                    Sailfish::Crypto::CryptoManager::EncryptionPaddingNone),
+                QByteArray());
     if (tdr.result.code() != Sailfish::Crypto::Result::Succeeded) {
         qCWarning(lcSailfishSecretsDaemon) << "Unable to generate key test data:"
                                            << tdr.result.errorMessage();
-        return false;
+        return keyData;
     }
 
-    // return the cipher plugin which was used.
-    *usedCipherPluginName = cplugin->name();
-    // return the cipher text which will be used for validation.
-    *testCipherText = tdr.data;
+    keyData.valid = true;
+    // the cipher plugin which was used.
+    keyData.cipherPluginName = cplugin->name();
+    // the cipher text which will be used for validation.
+    keyData.testCipherText = tdr.data;
     // we will use the first key as the bookkeeping database lock
     // (after we hex-encode it as required by sqlcipher).
-    *bkdbKey = bookkeepingdbKey.secretKey().toHex();
+    keyData.bkdbKey = bookkeepingdbKey.secretKey().toHex();
     // The second key will be used as the "device lock code" for
     // collections/secrets using DeviceLock semantics.
     // That one we don't hex encode, because we pass it to plugins
     // in raw form.
-    *deviceLockKey = devicelockKey.secretKey();
-    return true;
+    keyData.deviceLockKey = devicelockKey.secretKey();
+    return keyData;
+}
+
+void Daemon::ApiImpl::SecretsRequestQueue::generateKeyData(
+        const QByteArray &lockCode,
+        const QString &cipherPluginName,
+        const std::function<void (const KeyData &)> &completion)
+{
+    const QByteArray salt = saltData();
+    QList<Sailfish::Crypto::CryptoPlugin*> cplugins;
+    if (salt.isEmpty() || !keyDerivationPlugins(cipherPluginName, &cplugins)) {
+        completion(KeyData());
+        return;
+    }
+
+    generateKeyDataWithPlugins(cplugins, lockCode, salt, completion);
+}
+
+void Daemon::ApiImpl::SecretsRequestQueue::generateKeyDataWithPlugins(
+        const QList<Sailfish::Crypto::CryptoPlugin*> &cplugins,
+        const QByteArray &lockCode,
+        const QByteArray &salt,
+        const std::function<void (const KeyData &)> &completion)
+{
+    if (cplugins.isEmpty()) {
+        qCWarning(lcSailfishSecretsDaemon) << "Unable to find a valid crypto plugin for key initialization";
+        completion(KeyData());
+        return;
+    }
+
+    // the keys are derived in the thread of the plugin, so that the
+    // main thread is not blocked, and the plugin is not used concurrently.
+    Sailfish::Crypto::CryptoPlugin *cplugin = cplugins.first();
+    const QList<Sailfish::Crypto::CryptoPlugin*> remainingPlugins = cplugins.mid(1);
+    m_taskExecutor.run(
+                controller()->threadPoolForPlugin(cplugin->name()).data(),
+                std::bind(&Daemon::ApiImpl::SecretsRequestQueue::deriveKeyData,
+                          cplugin,
+                          cryptoStoragePluginWrapper(cplugin->name()),
+                          lockCode,
+                          salt),
+                [this, remainingPlugins, lockCode, salt, completion] (const KeyData &keyData) {
+        if (keyData.valid) {
+            completion(keyData);
+        } else {
+            generateKeyDataWithPlugins(remainingPlugins, lockCode, salt, completion);
+        }
+    });
 }
 
 bool Daemon::ApiImpl::SecretsRequestQueue::initialize(
         const QByteArray &lockCode,
         SecretsRequestQueue::InitializationMode mode)
 {
-    QByteArray bkdbKey, deviceLockKey, testCipherText;
-    QString cipherPluginName, usedCipherPluginName;
-    bool firstTimeInitialization = false;
+    // No request can have been received yet, so the keys are derived
+    // in this thread, and the plugins are initialized with them before
+    // the first request is handled.
+    QString cipherPluginName;
     // check to see if we have successfully initialized keys before
-    if (!determineTestCipherPlugin(&cipherPluginName) || cipherPluginName.isEmpty()) {
+    const bool firstTimeInitialization = !determineTestCipherPlugin(&cipherPluginName) || cipherPluginName.isEmpty();
+    KeyData keyData;
+    QList<Sailfish::Crypto::CryptoPlugin*> cplugins;
+    const QByteArray salt = saltData();
+    if (cipherPluginName != QStringLiteral("no-key-derivation-cipher-plugin")
+            && !salt.isEmpty()
+            && keyDerivationPlugins(cipherPluginName, &cplugins)) {
+        for (Sailfish::Crypto::CryptoPlugin *cplugin : cplugins) {
+            keyData = deriveKeyData(cplugin, cryptoStoragePluginWrapper(cplugin->name()), lockCode, salt);
+            if (keyData.valid) {
+                break;
+            }
+        }
+    }
+    return applyKeyData(lockCode, mode, cipherPluginName, firstTimeInitialization, keyData);
+}
+
+void Daemon::ApiImpl::SecretsRequestQueue::initialize(
+        const QByteArray &lockCode,
+        SecretsRequestQueue::InitializationMode mode,
+        const std::function<void (bool)> &completion)
+{
+    QString cipherPluginName;
+    // check to see if we have successfully initialized keys before
+    const bool firstTimeInitialization = !determineTestCipherPlugin(&cipherPluginName) || cipherPluginName.isEmpty();
+    if (cipherPluginName == QStringLiteral("no-key-derivation-cipher-plugin")) {
+        completion(applyKeyData(lockCode, mode, cipherPluginName, firstTimeInitialization, KeyData()));
+        return;
+    }
+
+    generateKeyData(lockCode, cipherPluginName, [=] (const KeyData &keyData) {
+        completion(applyKeyData(lockCode, mode, cipherPluginName, firstTimeInitialization, keyData));
+    });
+}
+
+bool Daemon::ApiImpl::SecretsRequestQueue::applyKeyData(
+        const QByteArray &lockCode,
+        SecretsRequestQueue::InitializationMode mode,
+        const QString &cipherPluginName,
+        bool firstTimeInitialization,
+        const KeyData &keyData)
+{
+    // keys read while the previous lock code was in effect are not reused.
+    m_storedKeyCache.clear();
+
+    QByteArray bkdbKey(keyData.bkdbKey), deviceLockKey(keyData.deviceLockKey), testCipherText(keyData.testCipherText);
+    QString usedCipherPluginName(keyData.cipherPluginName);
+    if (firstTimeInitialization) {
         qCDebug(lcSailfishSecretsDaemon) << "Secrets: unable to determine previous lock code key derivation plugin!";
         // assume that this is the first time initialization has occurred.
-        firstTimeInitialization = true;
     }
-    // generate the keys and test cipher text
-    if (cipherPluginName != QStringLiteral("no-key-derivation-cipher-plugin")
-            && !generateKeyData(lockCode, cipherPluginName, &bkdbKey, &deviceLockKey, &testCipherText, &usedCipherPluginName)) {
+    // check the generated keys and test cipher text
+    if (cipherPluginName != QStringLiteral("no-key-derivation-cipher-plugin") && !keyData.valid) {
         qCDebug(lcSailfishSecretsDaemon) << "Secrets: unable to generate keys from the lock code!";
         if (!firstTimeInitialization) {
             // the plugin we used to generate the keys was removed.
@@ -790,6 +987,7 @@ bool Daemon::ApiImpl::SecretsRequestQueue::initialize(
         return false;
     }
 
+    const bool wasLocked = m_locked;
     if (mode == SecretsRequestQueue::UnlockMode || mode == SecretsRequestQueue::ModifyLockMode) {
         m_locked = false;
         if (lockCode.isEmpty()) {
@@ -801,12 +999,17 @@ bool Daemon::ApiImpl::SecretsRequestQueue::initialize(
         m_locked = true;
     }
 
+    // the reported lock state of the plugins depends on the master lock.
+    if (m_locked != wasLocked && m_controller) {
+        m_controller->invalidatePluginStates();
+    }
+
     return true;
 }
 
-bool Daemon::ApiImpl::SecretsRequestQueue::initializePlugins()
+void Daemon::ApiImpl::SecretsRequestQueue::initializePlugins()
 {
-    return m_requestProcessor->initializePlugins();
+    m_requestProcessor->initializePlugins();
 }
 
 bool Daemon::ApiImpl::SecretsRequestQueue::masterLocked() const
@@ -814,27 +1017,42 @@ bool Daemon::ApiImpl::SecretsRequestQueue::masterLocked() const
     return m_locked;
 }
 
-bool Daemon::ApiImpl::SecretsRequestQueue::testLockCode(
-        const QByteArray &lockCode) const
+void Daemon::ApiImpl::SecretsRequestQueue::testLockCode(
+        const QByteArray &lockCode,
+        const std::function<void (bool)> &completion)
 {
-    QByteArray bkdbKey, deviceLockKey, testCipherText;
-    QString cipherPluginName, usedCipherPluginName;
+    QString cipherPluginName;
     if (!determineTestCipherPlugin(&cipherPluginName)) {
         qCWarning(lcSailfishSecretsDaemon) << "Secrets: unable to determine cipher plugin for lock code!";
-        return false;
+        completion(false);
+        return;
     }
+
+    const std::function<void (const QByteArray &)> compare = [this, cipherPluginName, completion] (const QByteArray &testCipherText) {
+        if (!compareTestCipherText(testCipherText, false, cipherPluginName)) {
+            qCWarning(lcSailfishSecretsDaemon) << "Secrets: the given master lock code is incorrect!";
+            completion(false);
+        } else {
+            completion(true);
+        }
+    };
+
     // if there is no valid key derivation crypto plugin, specify dummy keys, otherwise generate key data.
     if (cipherPluginName == QStringLiteral("no-key-derivation-cipher-plugin")) {
+        QByteArray bkdbKey, deviceLockKey, testCipherText;
         specifyDummyMasterlockKeys(lockCode, &testCipherText, &bkdbKey, &deviceLockKey);
-    } else if (!generateKeyData(lockCode, cipherPluginName, &bkdbKey, &deviceLockKey, &testCipherText, &usedCipherPluginName)) {
-        qCWarning(lcSailfishSecretsDaemon) << "Secrets: unable to generate keys from the lock code!";
-        return false;
+        compare(testCipherText);
+        return;
     }
-    if (!compareTestCipherText(testCipherText, false, cipherPluginName)) {
-        qCWarning(lcSailfishSecretsDaemon) << "Secrets: the given master lock code is incorrect!";
-        return false;
-    }
-    return true;
+
+    generateKeyData(lockCode, cipherPluginName, [completion, compare] (const KeyData &keyData) {
+        if (!keyData.valid) {
+            qCWarning(lcSailfishSecretsDaemon) << "Secrets: unable to generate keys from the lock code!";
+            completion(false);
+        } else {
+            compare(keyData.testCipherText);
+        }
+    });
 }
 
 bool Daemon::ApiImpl::SecretsRequestQueue::writeTestCipherText(
@@ -1053,8 +1271,14 @@ const QByteArray Daemon::ApiImpl::SecretsRequestQueue::deviceLockKey() const
     return QByteArray::fromRawData(m_deviceLockKeyData, m_deviceLockKeyLen);
 }
 
-Result Daemon::ApiImpl::SecretsRequestQueue::lockCryptoPlugin(
-        const QString &pluginName)
+Daemon::ApiImpl::StoredKeyCache *Daemon::ApiImpl::SecretsRequestQueue::storedKeyCache()
+{
+    return &m_storedKeyCache;
+}
+
+void Daemon::ApiImpl::SecretsRequestQueue::lockCryptoPlugin(
+        const QString &pluginName,
+        const std::function<void (const Result &)> &completion)
 {
     QMap<QString, Sailfish::Crypto::CryptoPlugin*> cryptoPlugins
             = m_controller && m_controller->crypto()
@@ -1062,31 +1286,29 @@ Result Daemon::ApiImpl::SecretsRequestQueue::lockCryptoPlugin(
             : QMap<QString, Sailfish::Crypto::CryptoPlugin*>();
     Sailfish::Crypto::CryptoPlugin *cryptoPlugin = cryptoPlugins.value(pluginName);
     if (!cryptoPlugin) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QStringLiteral("No such extension plugin exists: %1").arg(pluginName));
+        completion(Result(Result::InvalidExtensionPluginError,
+                          QStringLiteral("No such extension plugin exists: %1").arg(pluginName)));
+        return;
     }
 
     if (!cryptoPlugin->supportsLocking()) {
-        return Result(Result::OperationNotSupportedError,
-                      QStringLiteral("Crypto plugin %1 does not support locking").arg(pluginName));
+        completion(Result(Result::OperationNotSupportedError,
+                          QStringLiteral("Crypto plugin %1 does not support locking").arg(pluginName)));
+        return;
     }
 
-    if (!m_controller || !m_controller->crypto()) {
-        return Result(Result::UnknownError,
-                      QStringLiteral("Unable to lock crypto plugin"));
-    }
-
-    if (!m_controller->crypto()->lockPlugin(pluginName)) {
-        return Result(Result::UnknownError,
-                      QStringLiteral("Failed to lock crypto plugin %1").arg(pluginName));
-    }
-
-    return Result(Result::Succeeded);
+    m_controller->crypto()->lockPlugin(pluginName, [=] (bool locked) {
+        completion(locked
+                   ? Result(Result::Succeeded)
+                   : Result(Result::UnknownError,
+                            QStringLiteral("Failed to lock crypto plugin %1").arg(pluginName)));
+    });
 }
 
-Result Daemon::ApiImpl::SecretsRequestQueue::unlockCryptoPlugin(
+void Daemon::ApiImpl::SecretsRequestQueue::unlockCryptoPlugin(
         const QString &pluginName,
-        const QByteArray &lockCode)
+        const QByteArray &lockCode,
+        const std::function<void (const Result &)> &completion)
 {
     QMap<QString, Sailfish::Crypto::CryptoPlugin*> cryptoPlugins
             = m_controller && m_controller->crypto()
@@ -1094,31 +1316,28 @@ Result Daemon::ApiImpl::SecretsRequestQueue::unlockCryptoPlugin(
             : QMap<QString, Sailfish::Crypto::CryptoPlugin*>();
     Sailfish::Crypto::CryptoPlugin *cryptoPlugin = cryptoPlugins.value(pluginName);
     if (!cryptoPlugin) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QStringLiteral("No such extension plugin exists: %1").arg(pluginName));
+        completion(Result(Result::InvalidExtensionPluginError,
+                          QStringLiteral("No such extension plugin exists: %1").arg(pluginName)));
+        return;
     }
 
     if (!cryptoPlugin->supportsLocking()) {
-        return Result(Result::OperationNotSupportedError,
-                      QStringLiteral("Crypto plugin %1 does not support locking").arg(pluginName));
-    }
-
-    if (!m_controller || !m_controller->crypto()) {
-        return Result(Result::UnknownError,
-                      QStringLiteral("Unable to unlock crypto plugin"));
-    }
-
-    if (!m_controller->crypto()->unlockPlugin(pluginName, lockCode)) {
-        return Result(Result::UnknownError,
-                      QStringLiteral("Failed to unlock crypto plugin %1").arg(pluginName));
+        completion(Result(Result::OperationNotSupportedError,
+                          QStringLiteral("Crypto plugin %1 does not support locking").arg(pluginName)));
+        return;
     }
 
-    return Result(Result::Succeeded);
+    m_controller->crypto()->unlockPlugin(pluginName, lockCode, [=] (bool unlocked) {
+        completion(unlocked
+                   ? Result(Result::Succeeded)
+                   : Result(Result::UnknownError,
+                            QStringLiteral("Failed to unlock crypto plugin %1").arg(pluginName)));
+    });
 }
 
-Result Daemon::ApiImpl::SecretsRequestQueue::queryLockStatusCryptoPlugin(
+void Daemon::ApiImpl::SecretsRequestQueue::queryLockStatusCryptoPlugin(
         const QString &pluginName,
-        LockCodeRequest::LockStatus *lockStatus)
+        const std::function<void (const Result &, LockCodeRequest::LockStatus)> &completion)
 {
     QMap<QString, Sailfish::Crypto::CryptoPlugin*> cryptoPlugins
             = m_controller && m_controller->crypto()
@@ -1126,31 +1345,29 @@ Result Daemon::ApiImpl::SecretsRequestQueue::queryLockStatusCryptoPlugin(
             : QMap<QString, Sailfish::Crypto::CryptoPlugin*>();
     Sailfish::Crypto::CryptoPlugin *cryptoPlugin = cryptoPlugins.value(pluginName);
     if (!cryptoPlugin) {
-        *lockStatus = LockCodeRequest::Unknown;
-        return Result(Result::InvalidExtensionPluginError,
-                      QStringLiteral("No such extension plugin exists: %1").arg(pluginName));
+        completion(Result(Result::InvalidExtensionPluginError,
+                          QStringLiteral("No such extension plugin exists: %1").arg(pluginName)),
+                   LockCodeRequest::Unknown);
+        return;
     }
     if (!cryptoPlugin->supportsLocking()) {
-        *lockStatus = LockCodeRequest::Unsupported;
-        return Result(Result::Succeeded);
+        completion(Result(Result::Succeeded), LockCodeRequest::Unsupported);
+        return;
     }
 
-    if (!m_controller || !m_controller->crypto()) {
-        *lockStatus = LockCodeRequest::Unknown;
-        return Result(Result::UnknownError,
-                      QStringLiteral("Unable to query lock code for crypto plugin"));
-    }
-
-    *lockStatus = static_cast<LockCodeRequest::LockStatus>(
-                    static_cast<int>(
-                        m_controller->crypto()->queryLockStatusPlugin(pluginName)));
-    return Result(Result::Succeeded);
+    m_controller->crypto()->queryLockStatusPlugin(
+                pluginName,
+                [=] (Sailfish::Crypto::LockCodeRequest::LockStatus lockStatus) {
+        completion(Result(Result::Succeeded),
+                   static_cast<LockCodeRequest::LockStatus>(static_cast<int>(lockStatus)));
+    });
 }
 
-Result Daemon::ApiImpl::SecretsRequestQueue::setLockCodeCryptoPlugin(
+void Daemon::ApiImpl::SecretsRequestQueue::setLockCodeCryptoPlugin(
         const QString &pluginName,
         const QByteArray &oldCode,
-        const QByteArray &newCode)
+        const QByteArray &newCode,
+        const std::function<void (const Result &)> &completion)
 {
     QMap<QString, Sailfish::Crypto::CryptoPlugin*> cryptoPlugins
             = m_controller && m_controller->crypto()
@@ -1158,26 +1375,23 @@ Result Daemon::ApiImpl::SecretsRequestQueue::setLockCodeCryptoPlugin(
             : QMap<QString, Sailfish::Crypto::CryptoPlugin*>();
     Sailfish::Crypto::CryptoPlugin *cryptoPlugin = cryptoPlugins.value(pluginName);
     if (!cryptoPlugin) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QStringLiteral("No such extension plugin exists: %1").arg(pluginName));
+        completion(Result(Result::InvalidExtensionPluginError,
+                          QStringLiteral("No such extension plugin exists: %1").arg(pluginName)));
+        return;
     }
 
     if (!cryptoPlugin->supportsLocking()) {
-        return Result(Result::OperationNotSupportedError,
-                      QStringLiteral("Crypto plugin %1 does not support locking").arg(pluginName));
-    }
-
-    if (!m_controller || !m_controller->crypto()) {
-        return Result(Result::UnknownError,
-                      QStringLiteral("Unable to set lock code for crypto plugin"));
-    }
-
-    if (!m_controller->crypto()->setLockCodePlugin(pluginName, oldCode, newCode)) {
-        return Result(Result::UnknownError,
-                      QStringLiteral("Failed to set lock code for crypto plugin %1").arg(pluginName));
+        completion(Result(Result::OperationNotSupportedError,
+                          QStringLiteral("Crypto plugin %1 does not support locking").arg(pluginName)));
+        return;
     }
 
-    return Result(Result::Succeeded);
+    m_controller->crypto()->setLockCodePlugin(pluginName, oldCode, newCode, [=] (bool set) {
+        completion(set
+                   ? Result(Result::Succeeded)
+                   : Result(Result::UnknownError,
+                            QStringLiteral("Failed to set lock code for crypto plugin %1").arg(pluginName)));
+    });
 }
 
 QString Daemon::ApiImpl::SecretsRequestQueue::requestTypeToString(int type) const
@@ -1204,6 +1418,10 @@ QString Daemon::ApiImpl::SecretsRequestQueue::requestTypeToString(int type) cons
         case ModifyLockCodeRequest:                 return QLatin1String("ModifyLockCodeRequest");
         case ProvideLockCodeRequest:                return QLatin1String("ProvideLockCodeRequest");
         case ForgetLockCodeRequest:                 return QLatin1String("ForgetLockCodeRequest");
+        case GetStatisticsRequest:                  return QLatin1String("GetStatisticsRequest");
+        case GetCollectionSecretsRequest:           return QLatin1String("GetCollectionSecretsRequest");
+        case SetCollectionSecretsRequest:           return QLatin1String("SetCollectionSecretsRequest");
+        case DeleteCollectionSecretsRequest:        return QLatin1String("DeleteCollectionSecretsRequest");
         case UseCollectionKeyPreCheckRequest:       return QLatin1String("UseCollectionKeyPreCheckRequest");
         case SetCollectionKeyPreCheckRequest:       return QLatin1String("SetCollectionKeyPreCheckRequest");
         case SetCollectionKeyRequest:               return QLatin1String("SetCollectionKeyRequest");
@@ -1213,6 +1431,114 @@ QString Daemon::ApiImpl::SecretsRequestQueue::requestTypeToString(int type) cons
     return QLatin1String("Unknown Secrets Request!");
 }
 
+Daemon::ApiImpl::RequestQueue::RequestPriority
+Daemon::ApiImpl::SecretsRequestQueue::requestPriority(int type) const
+{
+    switch (type) {
+        // requests which a user is (typically) waiting on.
+        case UserInputRequest:
+        case GetCollectionSecretRequest:
+        case GetStandaloneSecretRequest:
+        case QueryLockStatusRequest:
+        case ProvideLockCodeRequest:
+        case GetStatisticsRequest:
+        case SetCollectionUserInputSecretRequest:
+        case SetStandaloneDeviceLockUserInputSecretRequest:
+        case SetStandaloneCustomLockUserInputSecretRequest:
+            return Daemon::ApiImpl::RequestQueue::InteractivePriority;
+        // requests which may touch many secrets.
+        case FindCollectionSecretsRequest:
+        case FindStandaloneSecretsRequest:
+        case DeleteCollectionRequest:
+        case GetCollectionSecretsRequest:
+        case SetCollectionSecretsRequest:
+        case DeleteCollectionSecretsRequest:
+            return Daemon::ApiImpl::RequestQueue::BulkPriority;
+        default: break;
+    }
+    return Daemon::ApiImpl::RequestQueue::NormalPriority;
+}
+
+qint64 Daemon::ApiImpl::SecretsRequestQueue::parameterSize(const QVariant &parameter) const
+{
+    if (parameter.userType() == qMetaTypeId<Secret>()) {
+        return parameter.value<Secret>().data().size();
+    } else if (parameter.userType() == qMetaTypeId<QVector<Secret> >()) {
+        qint64 size = 0;
+        for (const Secret &secret : parameter.value<QVector<Secret> >()) {
+            size += secret.data().size();
+        }
+        return size;
+    }
+    return Daemon::ApiImpl::RequestQueue::parameterSize(parameter);
+}
+
+QString Daemon::ApiImpl::SecretsRequestQueue::requestPluginName(int type, const QVariantList &inParams) const
+{
+    // requests which operate on a secret are performed by its storage plugin.
+    const QVariant first = inParams.value(0);
+    if (first.userType() == qMetaTypeId<Secret>()) {
+        return first.value<Secret>().identifier().storagePluginName();
+    } else if (first.userType() == qMetaTypeId<Secret::Identifier>()) {
+        return first.value<Secret::Identifier>().storagePluginName();
+    } else if (first.userType() == qMetaTypeId<QVector<Secret> >()) {
+        // every secret is stored in the same collection.
+        const QVector<Secret> secrets = first.value<QVector<Secret> >();
+        return secrets.isEmpty() ? QString() : secrets.first().identifier().storagePluginName();
+    } else if (first.userType() == qMetaTypeId<QVector<Secret::Identifier> >()) {
+        // only attributed to a plugin if every secret is stored by it.
+        const QVector<Secret::Identifier> identifiers = first.value<QVector<Secret::Identifier> >();
+        const QString pluginName = identifiers.isEmpty() ? QString() : identifiers.first().storagePluginName();
+        for (const Secret::Identifier &identifier : identifiers) {
+            if (identifier.storagePluginName() != pluginName) {
+                return QString();
+            }
+        }
+        return pluginName;
+    }
+
+    switch (type) {
+        case CollectionNamesRequest:
+        case FindStandaloneSecretsRequest:
+            return inParams.value(0).toString();
+        case CreateDeviceLockCollectionRequest:
+        case CreateCustomLockCollectionRequest:
+        case DeleteCollectionRequest:
+        case FindCollectionSecretsRequest:
+        case DeleteCollectionSecretsRequest:
+        case QueryLockStatusRequest:
+        case ModifyLockCodeRequest:
+        case ProvideLockCodeRequest:
+        case ForgetLockCodeRequest:
+            return inParams.value(1).toString();
+        default: break;
+    }
+    return QString();
+}
+
+void Daemon::ApiImpl::SecretsRequestQueue::clientConnected(pid_t pid)
+{
+    rememberApplication(pid);
+}
+
+void Daemon::ApiImpl::SecretsRequestQueue::clientDisconnected(pid_t pid)
+{
+    forgetApplication(pid);
+}
+
+void Daemon::ApiImpl::SecretsRequestQueue::requestRemoved(quint64 requestId)
+{
+    m_requestProcessor->requestRemoved(requestId);
+}
+
+void Daemon::ApiImpl::SecretsRequestQueue::resultReplied(const QVariant &result)
+{
+    // a plugin was found to be locked, which the reported state may not reflect.
+    if (result.value<Result>().errorCode() == Result::SecretsPluginIsLockedError) {
+        m_controller->invalidatePluginStates();
+    }
+}
+
 void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
         Daemon::ApiImpl::RequestQueue::RequestData *request,
         bool *completed)
@@ -1239,11 +1565,11 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<QVector<PluginInfo> >(storagePlugins)
-                                                                            << QVariant::fromValue<QVector<PluginInfo> >(encryptionPlugins)
-                                                                            << QVariant::fromValue<QVector<PluginInfo> >(encryptedStoragePlugins)
-                                                                            << QVariant::fromValue<QVector<PluginInfo> >(authenticationPlugins));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QVector<PluginInfo> >(storagePlugins)
+                                                                      << QVariant::fromValue<QVector<PluginInfo> >(encryptionPlugins)
+                                                                      << QVariant::fromValue<QVector<PluginInfo> >(encryptedStoragePlugins)
+                                                                      << QVariant::fromValue<QVector<PluginInfo> >(authenticationPlugins));
                 }
                 *completed = true;
             }
@@ -1261,13 +1587,20 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                         &saltDataHealth,
                         &masterlockHealth);
 
-            request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                    << QVariant::fromValue<HealthCheckRequest::Health>(saltDataHealth)
-                                                                    << QVariant::fromValue<HealthCheckRequest::Health>(masterlockHealth));
+            sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                              << QVariant::fromValue<HealthCheckRequest::Health>(saltDataHealth)
+                                                              << QVariant::fromValue<HealthCheckRequest::Health>(masterlockHealth));
             *completed = true;
             break;
 
         }
+        case GetStatisticsRequest: {
+            qCDebug(lcSailfishSecretsDaemon) << "Handling GetStatisticsRequest from client:" << request->remotePid << ", request number:" << request->requestId;
+            sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(Result(Result::Succeeded))
+                                                              << QVariant::fromValue<QVariantMap>(statistics()));
+            *completed = true;
+            break;
+        }
         case CollectionNamesRequest: {
             qCDebug(lcSailfishSecretsDaemon) << "Handling CollectionNamesRequest from client:" << request->remotePid << ", request number:" << request->requestId;
             QString storagePluginName = request->inParams.size() ? request->inParams.takeFirst().value<QString>() : QString();
@@ -1288,8 +1621,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<QVariantMap>(names));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<QVariantMap>(names));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QVariantMap>(names));
                 }
                 *completed = true;
             }
@@ -1325,7 +1658,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -1371,7 +1704,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -1405,7 +1738,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -1443,7 +1776,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -1493,7 +1826,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -1547,7 +1880,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -1581,8 +1914,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<Secret>(secret));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<Secret>(secret));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<Secret>(secret));
                 }
                 *completed = true;
             }
@@ -1616,13 +1949,75 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<Secret>(secret));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<Secret>(secret));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<Secret>(secret));
                 }
                 *completed = true;
             }
             break;
         }
+        case GetCollectionSecretsRequest: {
+            qCDebug(lcSailfishSecretsDaemon) << "Handling GetCollectionSecretsRequest from client:" << request->remotePid << ", request number:" << request->requestId;
+            QVector<Secret::Identifier> identifiers = request->inParams.size()
+                    ? request->inParams.takeFirst().value<QVector<Secret::Identifier> >()
+                    : QVector<Secret::Identifier>();
+            SecretManager::UserInteractionMode userInteractionMode = request->inParams.size()
+                    ? request->inParams.takeFirst().value<SecretManager::UserInteractionMode>()
+                    : SecretManager::PreventInteraction;
+            QString interactionServiceAddress = request->inParams.size() ? request->inParams.takeFirst().value<QString>() : QString();
+            QVector<Secret> secrets;
+            Result result = masterLocked()
+                    ? Result(Result::SecretsDaemonLockedError,
+                             QLatin1String("The secrets database is locked"))
+                    : m_requestProcessor->getCollectionSecrets(
+                                      request->remotePid,
+                                      request->requestId,
+                                      identifiers,
+                                      userInteractionMode,
+                                      interactionServiceAddress,
+                                      &secrets);
+            // send the reply to the calling peer.
+            if (result.code() == Result::Pending) {
+                // waiting for asynchronous flow to complete
+                *completed = false;
+            } else {
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<Secret> >(secrets));
+                *completed = true;
+            }
+            break;
+        }
+        case SetCollectionSecretsRequest: {
+            qCDebug(lcSailfishSecretsDaemon) << "Handling SetCollectionSecretsRequest from client:" << request->remotePid << ", request number:" << request->requestId;
+            QVector<Secret> secrets = request->inParams.size()
+                    ? request->inParams.takeFirst().value<QVector<Secret> >()
+                    : QVector<Secret>();
+            SecretManager::UserInteractionMode userInteractionMode = request->inParams.size()
+                    ? request->inParams.takeFirst().value<SecretManager::UserInteractionMode>()
+                    : SecretManager::PreventInteraction;
+            QString interactionServiceAddress = request->inParams.size() ? request->inParams.takeFirst().value<QString>() : QString();
+            QVector<Result> results;
+            Result result = masterLocked()
+                    ? Result(Result::SecretsDaemonLockedError,
+                             QLatin1String("The secrets database is locked"))
+                    : m_requestProcessor->setCollectionSecrets(
+                                      request->remotePid,
+                                      request->requestId,
+                                      secrets,
+                                      userInteractionMode,
+                                      interactionServiceAddress,
+                                      &results);
+            // send the reply to the calling peer.
+            if (result.code() == Result::Pending) {
+                // waiting for asynchronous flow to complete
+                *completed = false;
+            } else {
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<Result> >(results));
+                *completed = true;
+            }
+            break;
+        }
         case FindCollectionSecretsRequest: {
             qCDebug(lcSailfishSecretsDaemon) << "Handling FindCollectionSecretsRequest from client:" << request->remotePid << ", request number:" << request->requestId;
             QString collectionName = request->inParams.size()
@@ -1663,8 +2058,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 }
                 *completed = true;
             }
@@ -1706,8 +2101,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 }
                 *completed = true;
             }
@@ -1741,7 +2136,54 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
+                }
+                *completed = true;
+            }
+            break;
+        }
+        case DeleteCollectionSecretsRequest: {
+            qCDebug(lcSailfishSecretsDaemon) << "Handling DeleteCollectionSecretsRequest from client:" << request->remotePid << ", request number:" << request->requestId;
+            QString collectionName = request->inParams.size()
+                    ? request->inParams.takeFirst().value<QString>()
+                    : QString();
+            QString storagePluginName = request->inParams.size()
+                    ? request->inParams.takeFirst().value<QString>()
+                    : QString();
+            Secret::FilterData filter = request->inParams.size()
+                    ? request->inParams.takeFirst().value<Secret::FilterData >()
+                    : Secret::FilterData();
+            SecretManager::FilterOperator filterOperator = request->inParams.size()
+                    ? request->inParams.takeFirst().value<SecretManager::FilterOperator>()
+                    : SecretManager::OperatorOr;
+            SecretManager::UserInteractionMode userInteractionMode = request->inParams.size()
+                    ? request->inParams.takeFirst().value<SecretManager::UserInteractionMode>()
+                    : SecretManager::PreventInteraction;
+            QString interactionServiceAddress = request->inParams.size() ? request->inParams.takeFirst().value<QString>() : QString();
+            QVector<Secret::Identifier> identifiers;
+            Result result = masterLocked()
+                    ? Result(Result::SecretsDaemonLockedError,
+                             QLatin1String("The secrets database is locked"))
+                    : m_requestProcessor->deleteCollectionSecrets(
+                                      request->remotePid,
+                                      request->requestId,
+                                      collectionName,
+                                      storagePluginName,
+                                      filter,
+                                      filterOperator,
+                                      userInteractionMode,
+                                      interactionServiceAddress,
+                                      &identifiers);
+            // send the reply to the calling peer.
+            if (result.code() == Result::Pending) {
+                // waiting for asynchronous flow to complete
+                *completed = false;
+            } else {
+                if (request->isSecretsCryptoRequest) {
+                    asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
+                } else {
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 }
                 *completed = true;
             }
@@ -1771,7 +2213,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -1804,8 +2246,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result,
                                                        QVariantList() << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
                 }
                 *completed = true;
             }
@@ -1847,7 +2289,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -1889,7 +2331,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -1931,7 +2373,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2099,8 +2541,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<QByteArray>(QByteArray()));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QByteArray>(QByteArray()));
                 }
                 *completed = true;
             }
@@ -2113,6 +2555,13 @@ void Daemon::ApiImpl::SecretsRequestQueue::handlePendingRequest(
             break;
         }
     }
+
+    // plugins may have been locked or unlocked by a lock code request.
+    if (*completed && (request->type == ModifyLockCodeRequest
+                       || request->type == ProvideLockCodeRequest
+                       || request->type == ForgetLockCodeRequest)) {
+        m_controller->invalidatePluginStates();
+    }
 }
 
 void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
@@ -2149,11 +2598,12 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                                                                       << QVariant::fromValue<QVector<PluginInfo> >(encryptedStoragePlugins)
                                                                       << QVariant::fromValue<QVector<PluginInfo> >(authenticationPlugins));
                 } else {
-                    request->connection.send(request->message.createReply()
-                                                << QVariant::fromValue<QVector<PluginInfo> >(storagePlugins)
-                                                << QVariant::fromValue<QVector<PluginInfo> >(encryptionPlugins)
-                                                << QVariant::fromValue<QVector<PluginInfo> >(encryptedStoragePlugins)
-                                                << QVariant::fromValue<QVector<PluginInfo> >(authenticationPlugins));
+                    sendReply(request, request->message.createReply()
+                                          << QVariant::fromValue<Result>(result)
+                                          << QVariant::fromValue<QVector<PluginInfo> >(storagePlugins)
+                                          << QVariant::fromValue<QVector<PluginInfo> >(encryptionPlugins)
+                                          << QVariant::fromValue<QVector<PluginInfo> >(encryptedStoragePlugins)
+                                          << QVariant::fromValue<QVector<PluginInfo> >(authenticationPlugins));
                 }
                 *completed = true;
             }
@@ -2164,6 +2614,18 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
             // and always completes, so we do not need to handle this request here.
             break;
         }
+        case GetStatisticsRequest: {
+            // The statistics are always returned synchronously by handlePendingRequest(),
+            // so this is only reached if the request could not be started in time.
+            Result result = request->outParams.size()
+                    ? request->outParams.takeFirst().value<Result>()
+                    : Result(Result::UnknownError,
+                             QLatin1String("Unable to determine result of GetStatisticsRequest request"));
+            sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                              << QVariant::fromValue<QVariantMap>(QVariantMap()));
+            *completed = true;
+            break;
+        }
         case CollectionNamesRequest: {
             Result result = request->outParams.size()
                     ? request->outParams.takeFirst().value<Result>()
@@ -2180,8 +2642,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << names);
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<QVariantMap>(names));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QVariantMap>(names));
                 }
                 *completed = true;
             }
@@ -2200,7 +2662,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2219,7 +2681,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2238,7 +2700,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2257,7 +2719,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2276,7 +2738,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2295,7 +2757,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2315,10 +2777,15 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                         ? request->outParams.takeFirst().value<Secret>()
                         : Secret();
                 if (request->isSecretsCryptoRequest) {
-                    asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<Secret>(secret));
+                    // the key may be cached if its collection stays unlocked.
+                    const bool keepsUnlocked = request->outParams.size()
+                            ? request->outParams.takeFirst().toBool()
+                            : false;
+                    asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<Secret>(secret)
+                                                                                                        << QVariant::fromValue<bool>(keepsUnlocked));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<Secret>(secret));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<Secret>(secret));
                 }
                 *completed = true;
             }
@@ -2340,13 +2807,51 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<Secret>(secret));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<Secret>(secret));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<Secret>(secret));
                 }
                 *completed = true;
             }
             break;
         }
+        case GetCollectionSecretsRequest: {
+            Result result = request->outParams.size()
+                    ? request->outParams.takeFirst().value<Result>()
+                    : Result(Result::UnknownError,
+                             QLatin1String("Unable to determine result of GetCollectionSecretsRequest request"));
+            if (result.code() == Result::Pending) {
+                // shouldn't happen!
+                qCWarning(lcSailfishSecretsDaemon) << "GetCollectionSecretsRequest:" << request->requestId << "finished as pending!";
+                *completed = true;
+            } else {
+                QVector<Secret> secrets = request->outParams.size()
+                        ? request->outParams.takeFirst().value<QVector<Secret> >()
+                        : QVector<Secret>();
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<Secret> >(secrets));
+                *completed = true;
+            }
+            break;
+        }
+        case SetCollectionSecretsRequest: {
+            Result result = request->outParams.size()
+                    ? request->outParams.takeFirst().value<Result>()
+                    : Result(Result::UnknownError,
+                             QLatin1String("Unable to determine result of SetCollectionSecretsRequest request"));
+            if (result.code() == Result::Pending) {
+                // shouldn't happen!
+                qCWarning(lcSailfishSecretsDaemon) << "SetCollectionSecretsRequest:" << request->requestId << "finished as pending!";
+                *completed = true;
+            } else {
+                QVector<Result> results = request->outParams.size()
+                        ? request->outParams.takeFirst().value<QVector<Result> >()
+                        : QVector<Result>();
+                sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                  << QVariant::fromValue<QVector<Result> >(results));
+                *completed = true;
+            }
+            break;
+        }
         case FindCollectionSecretsRequest: {
             Result result = request->outParams.size()
                     ? request->outParams.takeFirst().value<Result>()
@@ -2363,8 +2868,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 }
                 *completed = true;
             }
@@ -2386,8 +2891,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 }
                 *completed = true;
             }
@@ -2406,7 +2911,30 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
+                }
+                *completed = true;
+            }
+            break;
+        }
+        case DeleteCollectionSecretsRequest: {
+            Result result = request->outParams.size()
+                    ? request->outParams.takeFirst().value<Result>()
+                    : Result(Result::UnknownError,
+                             QLatin1String("Unable to determine result of DeleteCollectionSecretsRequest request"));
+            if (result.code() == Result::Pending) {
+                // shouldn't happen!
+                qCWarning(lcSailfishSecretsDaemon) << "DeleteCollectionSecretsRequest:" << request->requestId << "finished as pending!";
+                *completed = true;
+            } else {
+                QVector<Secret::Identifier> identifiers = request->outParams.size()
+                        ? request->outParams.takeFirst().value<QVector<Secret::Identifier> >()
+                        : QVector<Secret::Identifier>();
+                if (request->isSecretsCryptoRequest) {
+                    asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
+                } else {
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers));
                 }
                 *completed = true;
             }
@@ -2425,7 +2953,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2448,8 +2976,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result,
                                                        QVariantList() << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<LockCodeRequest::LockStatus>(lockStatus));
                 }
             }
             break;
@@ -2467,7 +2995,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2486,7 +3014,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2505,7 +3033,7 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList());
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result));
                 }
                 *completed = true;
             }
@@ -2527,8 +3055,8 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
                 if (request->isSecretsCryptoRequest) {
                     asynchronousCryptoRequestCompleted(request->cryptoRequestId, result, QVariantList() << userInput);
                 } else {
-                    request->connection.send(request->message.createReply() << QVariant::fromValue<Result>(result)
-                                                                            << QVariant::fromValue<QByteArray>(userInput));
+                    sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(result)
+                                                                      << QVariant::fromValue<QByteArray>(userInput));
                 }
                 *completed = true;
             }
@@ -2634,6 +3162,13 @@ void Daemon::ApiImpl::SecretsRequestQueue::handleFinishedRequest(
             break;
         }
     }
+
+    // plugins may have been locked or unlocked by a lock code request.
+    if (*completed && (request->type == ModifyLockCodeRequest
+                       || request->type == ProvideLockCodeRequest
+                       || request->type == ForgetLockCodeRequest)) {
+        m_controller->invalidatePluginStates();
+    }
 }
 
 void Daemon::ApiImpl::SecretsRequestQueue::dealWithDataCorruption() const
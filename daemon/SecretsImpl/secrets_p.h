@@ -8,8 +8,11 @@
 #ifndef SAILFISHSECRETS_APIIMPL_SECRETS_P_H
 #define SAILFISHSECRETS_APIIMPL_SECRETS_P_H
 
+#include "pluginthreadpools_p.h"
 #include "requestqueue_p.h"
+#include "storedkeycache_p.h"
 #include "applicationpermissions_p.h"
+#include "taskexecutor_p.h"
 
 #include "Secrets/secret.h"
 #include "Secrets/interactionparameters.h"
@@ -25,8 +28,12 @@
 #include <QtCore/QStringList>
 #include <QtCore/QThreadPool>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QSemaphore>
+#include <QtCore/QHash>
 #include <QtDBus/QDBusContext>
 
+#include <functional>
+
 // the environment variable which can be used to specify the name
 // of the crypto plugin to use when deriving the master lock keys.
 #define ENV_MASTERLOCK_CRYPTOPLUGIN "SAILFISH_SECRETSD_MASTERLOCK_CRYPTOPLUGIN"
@@ -35,6 +42,7 @@ namespace Sailfish {
 
 // forward declare the CryptoRequestQueue type
 namespace Crypto {
+    class CryptoPlugin;
     namespace Daemon {
         namespace ApiImpl {
             class CryptoRequestQueue;
@@ -57,7 +65,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     Q_CLASSINFO("D-Bus Introspection", ""
     "  <interface name=\"org.sailfishos.secrets\">\n"
     "      <method name=\"getPluginInfo\">\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <arg name=\"storagePlugins\" type=\"a(ssi)\" direction=\"out\" />\n"
     "          <arg name=\"encryptionPlugins\" type=\"a(ssi)\" direction=\"out\" />\n"
     "          <arg name=\"encryptedStoragePlugins\" type=\"a(ssi)\" direction=\"out\" />\n"
@@ -69,23 +77,29 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out4\" value=\"QVector<Sailfish::Secrets::PluginInfo>\" />\n"
     "      </method>\n"
     "      <method name=\"getHealthInfo\">\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <arg name=\"saltDataHealth\" type=\"(i)\" direction=\"out\" />\n"
     "          <arg name=\"masterlockHealth\" type=\"(i)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"Sailfish::Secrets::HealthCheckRequest::Health\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out2\" value=\"Sailfish::Secrets::HealthCheckRequest::Health\" />\n"
     "      </method>\n"
+    "      <method name=\"getStatistics\">\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
+    "          <arg name=\"statistics\" type=\"a{sv}\" direction=\"out\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVariantMap\" />\n"
+    "      </method>\n"
     "      <method name=\"userInput\">\n"
     "          <arg name=\"uiParams\" type=\"(sss(i)sss(i)(i))\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <arg name=\"data\" type=\"ay\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
     "      </method>\n"
     "      <method name=\"collectionNames\">\n"
     "          <arg name=\"storagePluginName\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <arg name=\"names\" type=\"a{sv}\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
     "      </method>\n"
@@ -95,7 +109,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"encryptionPluginName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"unlockSemantic\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"accessControlMode\" type=\"(i)\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Secrets::SecretManager::DeviceLockUnlockSemantic\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In4\" value=\"Sailfish::Secrets::SecretManager::AccessControlMode\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
@@ -109,7 +123,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"accessControlMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In4\" value=\"Sailfish::Secrets::SecretManager::CustomLockUnlockSemantic\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In5\" value=\"Sailfish::Secrets::SecretManager::AccessControlMode\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In6\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
@@ -120,7 +134,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"storagePluginName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
     "      </method>\n"
@@ -129,7 +143,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"uiParams\" type=\"(sss(i)sss(i)(i))\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::Secret\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Secrets::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
@@ -143,7 +157,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"accessControlMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::Secret\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Secrets::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Secrets::SecretManager::DeviceLockUnlockSemantic\" />\n"
@@ -160,7 +174,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"accessControlMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::Secret\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Secrets::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In4\" value=\"Sailfish::Secrets::SecretManager::CustomLockUnlockSemantic\" />\n"
@@ -172,13 +186,35 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"identifier\" type=\"(sss)\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <arg name=\"secret\" type=\"((sss)aya{sv})\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::Secret::Identifier\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"Sailfish::Secrets::Secret\" />\n"
     "      </method>\n"
+    "      <method name=\"setSecrets\">\n"
+    "          <arg name=\"secrets\" type=\"a((sss)aya{sv})\" direction=\"in\" />\n"
+    "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
+    "          <arg name=\"results\" type=\"a(iisi)\" direction=\"out\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"QVector<Sailfish::Secrets::Secret>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVector<Sailfish::Secrets::Result>\" />\n"
+    "      </method>\n"
+    "      <method name=\"getSecrets\">\n"
+    "          <arg name=\"identifiers\" type=\"a(sss)\" direction=\"in\" />\n"
+    "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
+    "          <arg name=\"secrets\" type=\"a((sss)aya{sv})\" direction=\"out\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"QVector<Sailfish::Secrets::Secret::Identifier>\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVector<Sailfish::Secrets::Secret>\" />\n"
+    "      </method>\n"
     "      <method name=\"findSecrets\">\n"
     "          <arg name=\"collectionName\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"storagePluginName\" type=\"s\" direction=\"in\" />\n"
@@ -186,7 +222,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"filterOperator\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <arg name=\"identifiers\" type=\"(a(sss))\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Secrets::Secret::FilterData\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Secrets::SecretManager::FilterOperator\" />\n"
@@ -198,15 +234,30 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"identifier\" type=\"(sss)\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::Secret::Identifier\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
     "      </method>\n"
+    "      <method name=\"deleteSecrets\">\n"
+    "          <arg name=\"collectionName\" type=\"s\" direction=\"in\" />\n"
+    "          <arg name=\"storagePluginName\" type=\"s\" direction=\"in\" />\n"
+    "          <arg name=\"filter\" type=\"a{ss}\" direction=\"in\" />\n"
+    "          <arg name=\"filterOperator\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
+    "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
+    "          <arg name=\"identifiers\" type=\"(a(sss))\" direction=\"out\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Secrets::Secret::FilterData\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Secrets::SecretManager::FilterOperator\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In4\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
+    "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out1\" value=\"QVector<Sailfish::Secrets::Secret::Identifier>\" />\n"
+    "      </method>\n"
     "      <method name=\"queryLockStatus\">\n"
     "          <arg name=\"lockCodeTargetType\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"lockCodeTarget\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <arg name=\"lockStatus\" type=\"(i)\" direction=\"in\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::LockCodeRequest::LockCodeTargetType\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
@@ -218,7 +269,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"interactionParameters\" type=\"(sss(i)sss(i)(i))\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::LockCodeRequest::LockCodeTargetType\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Secrets::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
@@ -230,7 +281,7 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"interactionParameters\" type=\"(sss(i)sss(i)(i))\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::LockCodeRequest::LockCodeTargetType\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Secrets::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
@@ -242,12 +293,26 @@ class SecretsDBusObject : public QObject, protected QDBusContext
     "          <arg name=\"interactionParameters\" type=\"(sss(i)sss(i)(i))\" direction=\"in\" />\n"
     "          <arg name=\"userInteractionMode\" type=\"(i)\" direction=\"in\" />\n"
     "          <arg name=\"interactionServiceAddress\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::LockCodeRequest::LockCodeTargetType\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In2\" value=\"Sailfish::Secrets::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In3\" value=\"Sailfish::Secrets::SecretManager::UserInteractionMode\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
     "      </method>\n"
+    "      <method name=\"cancelRequest\">\n"
+    "          <arg name=\"sequence\" type=\"t\" direction=\"in\" />\n"
+    "          <arg name=\"method\" type=\"s\" direction=\"in\" />\n"
+    "      </method>\n"
+    "      <method name=\"setNextRequestTimeout\">\n"
+    "          <arg name=\"timeout\" type=\"i\" direction=\"in\" />\n"
+    "      </method>\n"
+    "      <method name=\"setNextRequestPipeline\">\n"
+    "          <arg name=\"pipelineId\" type=\"t\" direction=\"in\" />\n"
+    "      </method>\n"
+    "      <method name=\"endPipeline\">\n"
+    "          <arg name=\"pipelineId\" type=\"t\" direction=\"in\" />\n"
+    "      </method>\n"
+    "      <signal name=\"pluginInfoChanged\" />\n"
     "  </interface>\n"
     "")
 
@@ -271,6 +336,12 @@ public Q_SLOTS:
             Sailfish::Secrets::HealthCheckRequest::Health &saltDataHealth,
             Sailfish::Secrets::HealthCheckRequest::Health &masterlockHealth);
 
+    // retrieve the request latency statistics of the daemon
+    void getStatistics(
+            const QDBusMessage &message,
+            Sailfish::Secrets::Result &result,
+            QVariantMap &statistics);
+
     // retrieve user input for the client (daemon)
     void userInput(
             const Sailfish::Secrets::InteractionParameters &uiParams,
@@ -360,6 +431,24 @@ public Q_SLOTS:
             Sailfish::Secrets::Result &result,
             Sailfish::Secrets::Secret &secret);
 
+    // set multiple secrets in a collection
+    void setSecrets(
+            const QVector<Sailfish::Secrets::Secret> &secrets,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const QDBusMessage &message,
+            Sailfish::Secrets::Result &result,
+            QVector<Sailfish::Secrets::Result> &results);
+
+    // get multiple collection secrets
+    void getSecrets(
+            const QVector<Sailfish::Secrets::Secret::Identifier> &identifiers,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const QDBusMessage &message,
+            Sailfish::Secrets::Result &result,
+            QVector<Sailfish::Secrets::Secret> &secrets);
+
     // find secrets via filter
     void findSecrets(
             const QString &collectionName,
@@ -380,6 +469,18 @@ public Q_SLOTS:
             const QDBusMessage &message,
             Sailfish::Secrets::Result &result);
 
+    // delete the secrets in a collection which match a filter
+    void deleteSecrets(
+            const QString &collectionName,
+            const QString &storagePluginName,
+            const Sailfish::Secrets::Secret::FilterData &filter,
+            Sailfish::Secrets::SecretManager::FilterOperator filterOperator,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const QDBusMessage &message,
+            Sailfish::Secrets::Result &result,
+            QVector<Sailfish::Secrets::Secret::Identifier> &identifiers);
+
     // query lock status of a plugin or metadata db
     void queryLockStatus(
             Sailfish::Secrets::LockCodeRequest::LockCodeTargetType lockCodeTargetType,
@@ -418,6 +519,25 @@ public Q_SLOTS:
             const QDBusMessage &message,
             Sailfish::Secrets::Result &result);
 
+    // cancel a request previously sent via the client connection
+    void cancelRequest(
+            quint64 sequence,
+            const QString &method);
+
+    // set the deadline of the next request sent via the client connection
+    void setNextRequestTimeout(int timeout);
+
+    // run the next request sent via the client connection as a stage of
+    // the given pipeline, once the previous stages have succeeded
+    void setNextRequestPipeline(quint64 pipelineId);
+
+    // no more requests will be sent as stages of the given pipeline
+    void endPipeline(quint64 pipelineId);
+
+Q_SIGNALS:
+    // the availability or lock state of a plugin may have changed
+    void pluginInfoChanged();
+
 private:
     Sailfish::Secrets::Daemon::ApiImpl::SecretsRequestQueue *m_requestQueue;
 };
@@ -434,17 +554,37 @@ public:
         LockMode
     };
 
+    // the keys derived from a lock code, and the cipher text used to check it.
+    struct KeyData {
+        KeyData() : valid(false) {}
+        bool valid;
+        QByteArray bkdbKey;
+        QByteArray deviceLockKey;
+        QByteArray testCipherText;
+        QString cipherPluginName;
+    };
+
     SecretsRequestQueue(Sailfish::Secrets::Daemon::Controller *parent, bool autotestMode);
     ~SecretsRequestQueue();
 
     Sailfish::Secrets::Daemon::Controller *controller() const;
     QWeakPointer<QThreadPool> secretsThreadPool();
-    bool initialize(const QByteArray &lockCode, InitializationMode mode);
-    bool initializePlugins();
+    QWeakPointer<QThreadPool> pluginThreadPool(const QString &pluginName);
+    QSharedPointer<PluginThreadPoolBarrier> pluginThreadPoolBarrier();
+    bool initialize(const QByteArray &lockCode, InitializationMode mode); // on startup only.
+    void initialize(const QByteArray &lockCode, InitializationMode mode, const std::function<void (bool)> &completion);
+    void initializePlugins();
 
     void handlePendingRequest(Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestData *request, bool *completed) Q_DECL_OVERRIDE;
     void handleFinishedRequest(Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestData *request, bool *completed) Q_DECL_OVERRIDE;
     QString requestTypeToString(int type) const Q_DECL_OVERRIDE;
+    Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestPriority requestPriority(int type) const Q_DECL_OVERRIDE;
+    qint64 parameterSize(const QVariant &parameter) const Q_DECL_OVERRIDE;
+    QString requestPluginName(int type, const QVariantList &inParams) const Q_DECL_OVERRIDE;
+    void clientConnected(pid_t pid) Q_DECL_OVERRIDE;
+    void clientDisconnected(pid_t pid) Q_DECL_OVERRIDE;
+    void requestRemoved(quint64 requestId) Q_DECL_OVERRIDE;
+    void resultReplied(const QVariant &result) Q_DECL_OVERRIDE;
 
 public: // helpers for crypto API: secretscryptohelpers.cpp
     QMap<QString, QObject*> potentialCryptoStoragePlugins() const;
@@ -452,9 +592,12 @@ public: // helpers for crypto API: secretscryptohelpers.cpp
     QStringList encryptedStoragePluginNames() const;
     QStringList storagePluginNames() const;
     QString displayNameForStoragePlugin(const QString &name) const;
+    void rememberApplication(pid_t pid);
+    void forgetApplication(pid_t pid);
 
 private:
-    QSharedPointer<QThreadPool> m_secretsThreadPool;
+    QSharedPointer<QThreadPool> m_secretsThreadPool;                    // for operations which span all plugins.
+    Sailfish::Secrets::Daemon::ApiImpl::PluginThreadPools m_pluginThreadPools;
     Sailfish::Secrets::Daemon::ApiImpl::ApplicationPermissions *m_appPermissions;
     Sailfish::Secrets::Daemon::ApiImpl::RequestProcessor *m_requestProcessor;
     Sailfish::Secrets::Daemon::Controller *m_controller;
@@ -468,13 +611,18 @@ private:
     bool m_noLockCode;
     bool m_locked;
     mutable QByteArray m_saltData;
-    bool generateKeyData(const QByteArray &lockCode, const QString &cipherPluginName, QByteArray *bkdbKey, QByteArray *deviceLockKey, QByteArray *testCipherText, QString *usedCipherPluginName) const;
+    Sailfish::Secrets::Daemon::ApiImpl::TaskExecutor m_taskExecutor;
+    bool keyDerivationPlugins(const QString &cipherPluginName, QList<Sailfish::Crypto::CryptoPlugin*> *cplugins) const;
+    static KeyData deriveKeyData(Sailfish::Crypto::CryptoPlugin *cplugin, Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *wrapper, const QByteArray &lockCode, const QByteArray &salt);
+    void generateKeyData(const QByteArray &lockCode, const QString &cipherPluginName, const std::function<void (const KeyData &)> &completion);
+    void generateKeyDataWithPlugins(const QList<Sailfish::Crypto::CryptoPlugin*> &cplugins, const QByteArray &lockCode, const QByteArray &salt, const std::function<void (const KeyData &)> &completion);
+    bool applyKeyData(const QByteArray &lockCode, InitializationMode mode, const QString &cipherPluginName, bool firstTimeInitialization, const KeyData &keyData);
     bool initializeKeyData(const QByteArray &bkdkKey, const QByteArray &deviceLockKey);
     void dealWithDataCorruption() const;
 
 public: // For use by the secrets request processor to handle device-locked collection/secret semantics
     bool masterLocked() const;
-    bool testLockCode(const QByteArray &lockCode) const;
+    void testLockCode(const QByteArray &lockCode, const std::function<void (bool)> &completion);
     bool compareTestCipherText(const QByteArray &testCipherText, bool writeIfNotExists, const QString &cipherPluginName) const;
     bool writeTestCipherText(const QByteArray &testCipherText, const QString &cipherPluginName) const; // the testCipherText file should be considered mutable.
     bool determineTestCipherPlugin(QString *cipherPluginName) const;
@@ -483,18 +631,19 @@ public: // For use by the secrets request processor to handle device-locked coll
     void setNoLockCode(bool value);
     const QByteArray bkdbLockKey() const;
     const QByteArray deviceLockKey() const;
+    Sailfish::Secrets::Daemon::ApiImpl::StoredKeyCache *storedKeyCache();
 
-    Sailfish::Secrets::Result queryLockStatusCryptoPlugin(const QString &pluginName, Sailfish::Secrets::LockCodeRequest::LockStatus *lockStatus);
-    Sailfish::Secrets::Result lockCryptoPlugin(const QString &pluginName);
-    Sailfish::Secrets::Result unlockCryptoPlugin(const QString &pluginName, const QByteArray &lockCode);
-    Sailfish::Secrets::Result setLockCodeCryptoPlugin(const QString &pluginName, const QByteArray &oldCode, const QByteArray &newCode);
+    void queryLockStatusCryptoPlugin(const QString &pluginName, const std::function<void (const Sailfish::Secrets::Result &, Sailfish::Secrets::LockCodeRequest::LockStatus)> &completion);
+    void lockCryptoPlugin(const QString &pluginName, const std::function<void (const Sailfish::Secrets::Result &)> &completion);
+    void unlockCryptoPlugin(const QString &pluginName, const QByteArray &lockCode, const std::function<void (const Sailfish::Secrets::Result &)> &completion);
+    void setLockCodeCryptoPlugin(const QString &pluginName, const QByteArray &oldCode, const QByteArray &newCode, const std::function<void (const Sailfish::Secrets::Result &)> &completion);
 
 public: // Crypto API helper methods.
     // these methods are provided in order to implement Crypto functionality
     // while using just one single database (for atomicity etc).
     void asynchronousCryptoRequestCompleted(quint64 cryptoRequestId, const Sailfish::Secrets::Result &result, const QVariantList &parameters);
     // the first methods are synchronous:
-    Sailfish::Secrets::Result storagePluginInfo(pid_t callerPid, quint64 cryptoRequestId, QVector<Sailfish::Secrets::PluginInfo> *info) const;
+    Sailfish::Secrets::Result storagePluginInfo(pid_t callerPid, quint64 cryptoRequestId, const std::function<void (const QVector<Sailfish::Secrets::PluginInfo> &)> &callback) const;
     // the others are asynchronous methods:
     Sailfish::Secrets::Result useKeyPreCheck(pid_t callerPid, quint64 cryptoRequestId, const Sailfish::Crypto::Key::Identifier &identifier, Sailfish::Crypto::CryptoManager::Operation operation, const QString &cryptoPluginName);
     Sailfish::Secrets::Result storedKey(pid_t callerPid, quint64 cryptoRequestId, const Sailfish::Crypto::Key::Identifier &identifier, QByteArray *serializedKey, QMap<QString, QString> *filterData);
@@ -537,6 +686,15 @@ private:
         ForgetLockCodeCryptoApiHelperRequest
     };
     QMap<quint64, CryptoApiHelperRequestType> m_cryptoApiHelperRequests; // crypto request id to crypto api call type.
+
+    // keys read for the crypto API are cached, if their collection stays unlocked.
+    struct StoredKeyCacheRequest {
+        QString applicationId;
+        Sailfish::Secrets::Secret::Identifier identifier;
+        quint64 generation;
+    };
+    Sailfish::Secrets::Daemon::ApiImpl::StoredKeyCache m_storedKeyCache;
+    QMap<quint64, StoredKeyCacheRequest> m_storedKeyCacheRequests; // crypto request id to the key being read.
 };
 
 enum RequestType {
@@ -561,6 +719,10 @@ enum RequestType {
     ModifyLockCodeRequest,
     ProvideLockCodeRequest,
     ForgetLockCodeRequest,
+    GetStatisticsRequest,
+    GetCollectionSecretsRequest,
+    SetCollectionSecretsRequest,
+    DeleteCollectionSecretsRequest,
     // Internal user input request types:
     SetCollectionUserInputSecretRequest,
     SetStandaloneDeviceLockUserInputSecretRequest,
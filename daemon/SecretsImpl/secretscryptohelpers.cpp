@@ -35,6 +35,19 @@ Daemon::ApiImpl::SecretsRequestQueue::displayNameForStoragePlugin(const QString
     return m_requestProcessor->displayNameForStoragePlugin(name);
 }
 
+void
+Daemon::ApiImpl::SecretsRequestQueue::rememberApplication(pid_t pid)
+{
+    // the application ids of crypto API clients are also resolved here.
+    m_appPermissions->rememberApplication(pid);
+}
+
+void
+Daemon::ApiImpl::SecretsRequestQueue::forgetApplication(pid_t pid)
+{
+    m_appPermissions->forgetApplication(pid);
+}
+
 QStringList
 Daemon::ApiImpl::SecretsRequestQueue::storagePluginNames() const
 {
@@ -94,10 +107,10 @@ Daemon::ApiImpl::RequestProcessor::encryptedStoragePluginNames() const
     return m_encryptedStoragePlugins.keys();
 }
 
-QVector<PluginInfo>
-Daemon::ApiImpl::RequestProcessor::storagePluginInfo() const
+void
+Daemon::ApiImpl::RequestProcessor::storagePluginInfo(
+        const std::function<void (const QVector<PluginInfo> &)> &callback) const
 {
-    QVector<PluginInfo> infos;
     QList<PluginBase*> storagePlugins;
     for (StoragePluginWrapper *plugin : m_storagePlugins.values()) {
         storagePlugins.append(plugin);
@@ -106,31 +119,28 @@ Daemon::ApiImpl::RequestProcessor::storagePluginInfo() const
         storagePlugins.append(plugin);
     }
 
-    QMap<QString, PluginInfo> pluginInfos
-            = m_requestQueue->controller()->pluginInfoForPlugins(
-                storagePlugins, m_requestQueue->masterLocked());
-
-    for (StoragePluginWrapper *plugin : m_storagePlugins) {
-        infos.append(pluginInfos.value(plugin->name()));
-    }
-    for (EncryptedStoragePluginWrapper *plugin : m_encryptedStoragePlugins) {
-        infos.append(pluginInfos.value(plugin->name()));
-    }
-
-    return infos;
+    m_requestQueue->controller()->pluginInfoForPlugins(
+                storagePlugins, m_requestQueue->masterLocked(),
+                [storagePlugins, callback] (const QMap<QString, PluginInfo> &pluginInfos) {
+        QVector<PluginInfo> infos;
+        for (PluginBase *plugin : storagePlugins) {
+            infos.append(pluginInfos.value(plugin->name()));
+        }
+        callback(infos);
+    });
 }
 
 Result
 Daemon::ApiImpl::SecretsRequestQueue::storagePluginInfo(
         pid_t callerPid,
         quint64 cryptoRequestId,
-        QVector<PluginInfo> *infos) const
+        const std::function<void (const QVector<PluginInfo> &)> &callback) const
 {
     // TODO: Access control
     Q_UNUSED(callerPid)
     Q_UNUSED(cryptoRequestId)
 
-    *infos = m_requestProcessor->storagePluginInfo();
+    m_requestProcessor->storagePluginInfo(callback);
     return Result(Result::Succeeded);
 }
 
@@ -289,14 +299,25 @@ Daemon::ApiImpl::SecretsRequestQueue::storedKey(
         QByteArray *serializedKey,
         QMap<QString, QString> *filterData)
 {
-    Q_UNUSED(serializedKey); // this request is always asynchronous
-    Q_UNUSED(filterData);
+    const Secret::Identifier secretIdentifier(identifier.name(),
+                                              identifier.collectionName(),
+                                              identifier.storagePluginName());
+    const QString callerApplicationId = m_appPermissions->applicationIsPlatformApplication(callerPid)
+                ? m_appPermissions->platformApplicationId()
+                : m_appPermissions->applicationId(callerPid);
+
+    // the key may have been read for this application already, in which case
+    // the access checks were performed then, and its collection is unlocked.
+    Secret::FilterData cachedFilterData;
+    if (!masterLocked()
+            && m_storedKeyCache.lookup(callerApplicationId, secretIdentifier, serializedKey, &cachedFilterData)) {
+        *filterData = cachedFilterData;
+        return Result(Result::Succeeded);
+    }
 
     // perform the "get collection secret" request, as a secrets-for-crypto request.
     QList<QVariant> inParams;
-    inParams << QVariant::fromValue<Secret::Identifier>(Secret::Identifier(identifier.name(),
-                                                                           identifier.collectionName(),
-                                                                           identifier.storagePluginName()))
+    inParams << QVariant::fromValue<Secret::Identifier>(secretIdentifier)
              << QVariant::fromValue<SecretManager::UserInteractionMode>(SecretManager::SystemInteraction)
              << QVariant::fromValue<QString>(QString());
     Result enqueueResult(Result::Succeeded);
@@ -310,6 +331,8 @@ Daemon::ApiImpl::SecretsRequestQueue::storedKey(
         return enqueueResult;
     }
     m_cryptoApiHelperRequests.insert(cryptoRequestId, Daemon::ApiImpl::SecretsRequestQueue::StoredKeyCryptoApiHelperRequest);
+    const StoredKeyCacheRequest cacheRequest = { callerApplicationId, secretIdentifier, m_storedKeyCache.generation() };
+    m_storedKeyCacheRequests.insert(cryptoRequestId, cacheRequest);
     return Result(Result::Pending);
 }
 
@@ -462,6 +485,15 @@ Daemon::ApiImpl::SecretsRequestQueue::asynchronousCryptoRequestCompleted(
     switch (type) {
         case StoredKeyCryptoApiHelperRequest: {
             Secret secret = parameters.size() ? parameters.first().value<Secret>() : Secret();
+            const StoredKeyCacheRequest cacheRequest = m_storedKeyCacheRequests.take(cryptoRequestId);
+            if (result.code() == Result::Succeeded && parameters.value(1).toBool()) {
+                // the collection of the key stays unlocked once unlocked.
+                m_storedKeyCache.insert(cacheRequest.applicationId,
+                                        cacheRequest.identifier,
+                                        secret.data(),
+                                        secret.filterData(),
+                                        cacheRequest.generation);
+            }
             emit storedKeyCompleted(cryptoRequestId, result, secret.data(), secret.filterData());
             break;
         }
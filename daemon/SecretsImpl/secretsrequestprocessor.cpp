@@ -29,7 +29,8 @@
 #include <QtCore/QSet>
 #include <QtCore/QDir>
 #include <QtCore/QCoreApplication>
-#include <QtConcurrent>
+
+#include <functional>
 
 using namespace Sailfish::Secrets;
 
@@ -170,23 +171,152 @@ Daemon::ApiImpl::RequestProcessor::RequestProcessor(
     }
 }
 
-bool Daemon::ApiImpl::RequestProcessor::initializePlugins()
+void Daemon::ApiImpl::RequestProcessor::initializePlugins()
+{
+    // the unlock holds every plugin thread pool, so plugin operations
+    // of requests handled in the meantime are performed after it.
+    masterUnlockAllPlugins(0);
+}
+
+// Master-unlocks the metadata databases of all of the storage plugins with
+// the current bookkeeping database lock key, with exclusive access to them.
+// The given request (if any) is finished once they have been unlocked.
+void Daemon::ApiImpl::RequestProcessor::masterUnlockAllPlugins(quint64 requestId)
+{
+    // the key data may be re-initialized before the plugins are unlocked.
+    const QByteArray bkdbShallowCopy = m_requestQueue->bkdbLockKey();
+    const QByteArray bkdbLockKey(bkdbShallowCopy.constData(), bkdbShallowCopy.size());
+    const QList<StoragePluginWrapper*> storagePlugins = m_storagePlugins.values();
+    const QList<EncryptedStoragePluginWrapper*> encryptedStoragePlugins = m_encryptedStoragePlugins.values();
+    const QSharedPointer<PluginThreadPoolBarrier> barrier = m_requestQueue->pluginThreadPoolBarrier();
+    m_taskExecutor.run(
+                m_requestQueue->secretsThreadPool().data(),
+                [barrier, storagePlugins, encryptedStoragePlugins, bkdbLockKey] () -> bool {
+        const PluginThreadPoolBarrier::Scope exclusive(barrier);
+        return Daemon::ApiImpl::masterUnlockPlugins(storagePlugins, encryptedStoragePlugins, bkdbLockKey);
+    }, [=] (bool succeeded) {
+        if (!succeeded) {
+            // TODO: FIXME: how can we recover from this?
+            // This is symptomatic of a power-loss halfway through previous re-encryption,
+            // meaning that some metadata databases will have been encrypted with
+            // the OLD lock code, and some with the NEW lock code...
+            qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to unlock metadata plugins";
+        }
+        if (requestId) {
+            // TODO: FIXME: how can we handle plugin metadata decryption failures?
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(Result(Result::Succeeded));
+            m_requestQueue->requestFinished(requestId, outParams);
+        }
+    });
+}
+
+void Daemon::ApiImpl::RequestProcessor::reencryptMasterLockedPlugins(
+        quint64 requestId,
+        const QByteArray &oldLockCode,
+        const QByteArray &oldBkdbLockKey,
+        const QByteArray &oldDeviceLockKey)
 {
-    QFuture<bool> future = QtConcurrent::run(
+    // pull the new keys into memory via deep copy, as the key data
+    // may be re-initialized before the plugins have been re-encrypted.
+    QByteArray bkdbLockKey, deviceLockKey;
+    {
+        QByteArray bkdbShallowCopy = m_requestQueue->bkdbLockKey();
+        bkdbLockKey = QByteArray(bkdbShallowCopy.constData(), bkdbShallowCopy.size());
+        QByteArray dlShallowCopy = m_requestQueue->deviceLockKey();
+        deviceLockKey = QByteArray(dlShallowCopy.constData(), dlShallowCopy.size());
+    }
+
+    // re-encrypt the metadata (bookkeeping) databases for each storage plugin,
+    // and then all device-locked collections and secrets.
+    const QList<StoragePluginWrapper*> storagePlugins = m_storagePlugins.values();
+    const QList<EncryptedStoragePluginWrapper*> encryptedStoragePlugins = m_encryptedStoragePlugins.values();
+    const QMap<QString, EncryptionPlugin*> encryptionPlugins = m_encryptionPlugins;
+    const QSharedPointer<PluginThreadPoolBarrier> barrier = m_requestQueue->pluginThreadPoolBarrier();
+    const QSharedPointer<QAtomicInt> canceled = m_requestQueue->cancellationFlag(requestId);
+    m_taskExecutor.run(
                 m_requestQueue->secretsThreadPool().data(),
-                &Daemon::ApiImpl::masterUnlockPlugins,
-                m_storagePlugins.values(),
-                m_encryptedStoragePlugins.values(),
-                m_requestQueue->bkdbLockKey());
-    future.waitForFinished();
-    if (!future.result()) {
-        // TODO: FIXME: how can we recover from this?
-        // This is symptomatic of a power-loss halfway through previous re-encryption,
-        // meaning that some metadata databases will have been encrypted with
-        // the OLD lock code, and some with the NEW lock code...
-        qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to initialize metadata plugins";
-    }
-    return future.result();
+                [barrier, canceled, storagePlugins, encryptedStoragePlugins, encryptionPlugins,
+                 oldBkdbLockKey, bkdbLockKey, oldDeviceLockKey, deviceLockKey] () -> ReencryptionResult {
+        const PluginThreadPoolBarrier::Scope exclusive(barrier);
+        // the request may have been canceled while waiting for the plugins.
+        if (canceled->loadAcquire()) {
+            return ReencryptionResult(Result(Result::OperationCanceledError,
+                                             QLatin1String("The re-encryption was canceled")),
+                                      true);
+        }
+        if (!Daemon::ApiImpl::modifyMasterLockPlugins(storagePlugins, encryptedStoragePlugins, oldBkdbLockKey, bkdbLockKey)) {
+            // TODO: FIXME: how do we recover from this?  (Each plugin is modified serially, cannot be atomic...)
+            qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to re-encrypt all metadata databases successfully!";
+        }
+        const ReencryptionResult reencryptionResult = Daemon::ApiImpl::reencryptDeviceLockedPlugins(
+                    storagePlugins, encryptedStoragePlugins, encryptionPlugins,
+                    oldDeviceLockKey, deviceLockKey, canceled);
+        if (reencryptionResult.rolledBack) {
+            // the device-locked data has been restored to the old key (as far
+            // as was possible), so the metadata databases must be restored also.
+            if (!Daemon::ApiImpl::modifyMasterLockPlugins(storagePlugins, encryptedStoragePlugins, bkdbLockKey, oldBkdbLockKey)) {
+                qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to restore all metadata databases successfully!";
+            }
+        }
+        return reencryptionResult;
+    }, [=] (const ReencryptionResult &reencryptionResult) {
+        if (reencryptionResult.rolledBack) {
+            // the re-encryption was undone: the old lock code remains in effect.
+            // If the rollback failed, the client is told that the data is in a mixed state.
+            m_requestQueue->initialize(oldLockCode, SecretsRequestQueue::ModifyLockMode, [=] (bool) {
+                QVariantList outParams;
+                outParams << QVariant::fromValue<Result>(reencryptionResult.result);
+                m_requestQueue->requestFinished(requestId, outParams);
+            });
+            return;
+        }
+        // TODO: FIXME: handle per-plugin errors in a robust way?
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(Result(Result::Succeeded));
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
+}
+
+// A request which is removed from the queue before the invocation it
+// joined has finished (e.g. because it was canceled or expired) must not
+// be finished with the shared result.
+void Daemon::ApiImpl::RequestProcessor::requestRemoved(quint64 requestId)
+{
+    m_coalescedCalls.requestRemoved(requestId);
+}
+
+// Queries whether the given collection is locked in the thread of its
+// encrypted storage plugin, and then passes the lock state to the given
+// continuation in the main thread.  If the query fails, or the continuation
+// does not return Pending, the request is finished with that result,
+// followed by the given out-parameters.
+Result
+Daemon::ApiImpl::RequestProcessor::withCollectionLockState(
+        quint64 requestId,
+        const QString &storagePluginName,
+        const QString &collectionName,
+        const QVariantList &outParams,
+        const std::function<Result (bool)> &continuation)
+{
+    m_taskExecutor.run(
+                m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                std::bind(EncryptedStoragePluginFunctionWrapper::isCollectionLocked,
+                          m_encryptedStoragePlugins.value(storagePluginName),
+                          collectionName),
+                [=] (LockedResult lr) {
+        Result result = lr.result.code() != Result::Succeeded
+                ? lr.result
+                : continuation(lr.locked);
+        if (result.code() != Result::Pending) {
+            QVariantList finishedOutParams;
+            finishedOutParams << QVariant::fromValue<Result>(result);
+            finishedOutParams << outParams;
+            m_requestQueue->requestFinished(requestId, finishedOutParams);
+        }
+    });
+
+    return Result(Result::Pending);
 }
 
 // retrieve information about available plugins
@@ -200,7 +330,17 @@ Daemon::ApiImpl::RequestProcessor::getPluginInfo(
         QVector<PluginInfo> *authenticationPlugins)
 {
     Q_UNUSED(callerPid); // TODO: perform access control request to see if the application has permission to read secure storage metadata.
-    Q_UNUSED(requestId); // The request is synchronous, so don't need the requestId.
+    Q_UNUSED(storagePlugins); // asynchronous out-parameter.
+    Q_UNUSED(encryptionPlugins); // asynchronous out-parameter.
+    Q_UNUSED(encryptedStoragePlugins); // asynchronous out-parameter.
+    Q_UNUSED(authenticationPlugins); // asynchronous out-parameter.
+
+    const QString coalesceKey(QStringLiteral("GetPluginInfo"));
+    bool joined = false;
+    const QSharedPointer<CoalescedCalls::Call> call = m_coalescedCalls.join(coalesceKey, requestId, &joined);
+    if (joined) {
+        return Result(Result::Pending);
+    }
 
     QList<PluginBase*> allPlugins;
     for (StoragePluginWrapper *plugin : m_storagePlugins.values()) {
@@ -216,23 +356,84 @@ Daemon::ApiImpl::RequestProcessor::getPluginInfo(
         allPlugins.append(plugin);
     }
 
-    QMap<QString, PluginInfo> pluginInfos = m_requestQueue->controller()->pluginInfoForPlugins(
-                allPlugins, m_requestQueue->masterLocked());
+    const auto finish = [=] (const QMap<QString, PluginState> &states) {
+        const bool masterLocked = m_requestQueue->masterLocked();
+        QMap<QString, PluginInfo> pluginInfos;
+        for (PluginBase *plugin : allPlugins) {
+            const PluginState state = states.value(plugin->name());
+            pluginInfos.insert(plugin->name(),
+                               Daemon::Controller::pluginInfoForPlugin(
+                                   plugin, masterLocked, state.available, state.locked));
+        }
+
+        QVector<PluginInfo> storagePluginInfos;
+        QVector<PluginInfo> encryptionPluginInfos;
+        QVector<PluginInfo> encryptedStoragePluginInfos;
+        QVector<PluginInfo> authenticationPluginInfos;
+        for (const QString &pluginName : m_storagePlugins.keys()) {
+            storagePluginInfos.append(pluginInfos.value(pluginName));
+        }
+        for (const QString &pluginName : m_encryptionPlugins.keys()) {
+            encryptionPluginInfos.append(pluginInfos.value(pluginName));
+        }
+        for (const QString &pluginName : m_encryptedStoragePlugins.keys()) {
+            encryptedStoragePluginInfos.append(pluginInfos.value(pluginName));
+        }
+        for (const QString &pluginName : m_authenticationPlugins.keys()) {
+            authenticationPluginInfos.append(pluginInfos.value(pluginName));
+        }
 
-    for (const QString &pluginName : m_storagePlugins.keys()) {
-        storagePlugins->append(pluginInfos.value(pluginName));
-    }
-    for (const QString &pluginName : m_encryptionPlugins.keys()) {
-        encryptionPlugins->append(pluginInfos.value(pluginName));
-    }
-    for (const QString &pluginName : m_encryptedStoragePlugins.keys()) {
-        encryptedStoragePlugins->append(pluginInfos.value(pluginName));
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(Result(Result::Succeeded));
+        outParams << QVariant::fromValue<QVector<PluginInfo> >(storagePluginInfos);
+        outParams << QVariant::fromValue<QVector<PluginInfo> >(encryptionPluginInfos);
+        outParams << QVariant::fromValue<QVector<PluginInfo> >(encryptedStoragePluginInfos);
+        outParams << QVariant::fromValue<QVector<PluginInfo> >(authenticationPluginInfos);
+        for (quint64 coalescedRequestId : m_coalescedCalls.finish(coalesceKey, call)) {
+            m_requestQueue->requestFinished(coalescedRequestId, outParams);
+        }
+    };
+
+    // The state of the plugins is reported from memory if it is known.
+    Daemon::Controller *controller = m_requestQueue->controller();
+    QMap<QString, PluginState> cachedStates;
+    bool cached = true;
+    for (PluginBase *plugin : allPlugins) {
+        bool available = false;
+        bool locked = false;
+        cached = controller->cachedPluginState(plugin->name(), &available, &locked);
+        if (!cached) {
+            break;
+        }
+        cachedStates.insert(plugin->name(), PluginState(available, locked));
     }
-    for (const QString &pluginName : m_authenticationPlugins.keys()) {
-        authenticationPlugins->append(pluginInfos.value(pluginName));
+    if (cached) {
+        finish(cachedStates);
+        return Result(Result::Pending);
     }
 
-    return Result(Result::Succeeded);
+    // Otherwise the state of all of these plugins is queried in a single trip,
+    // while no other operation is being performed by any plugin.
+    const quint64 generation = controller->pluginStateGeneration();
+    const QSharedPointer<PluginThreadPoolBarrier> barrier = m_requestQueue->pluginThreadPoolBarrier();
+    m_taskExecutor.run(
+                m_requestQueue->secretsThreadPool().data(),
+                [call, barrier, allPlugins] () -> QMap<QString, PluginState> {
+        const PluginThreadPoolBarrier::Scope exclusive(barrier);
+        call->started.storeRelease(1);
+        QMap<QString, PluginState> states;
+        for (PluginBase *plugin : allPlugins) {
+            states.insert(plugin->name(), Daemon::ApiImpl::pluginState(plugin));
+        }
+        return states;
+    }, [=] (QMap<QString, PluginState> states) {
+        for (QMap<QString, PluginState>::const_iterator it = states.constBegin(); it != states.constEnd(); ++it) {
+            controller->cachePluginState(it.key(), it->available, it->locked, generation);
+        }
+        finish(states);
+    });
+
+    return Result(Result::Pending);
 }
 
 Result
@@ -297,29 +498,40 @@ Daemon::ApiImpl::RequestProcessor::collectionNames(
                       QStringLiteral("Unknown storage plugin name given"));
     }
 
-    QFutureWatcher<CollectionNamesResult> *watcher = new QFutureWatcher<CollectionNamesResult>(this);
-    QFuture<CollectionNamesResult> future;
-    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionNames,
-                    m_encryptedStoragePlugins[storagePluginName]);
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionNames,
-                    m_storagePlugins[storagePluginName]);
+    // Identical requests from other callers which arrive before the
+    // plugin is invoked share the result of that single invocation.
+    const QString coalesceKey = QStringLiteral("CollectionNames:") + storagePluginName;
+    bool joined = false;
+    const QSharedPointer<CoalescedCalls::Call> call = m_coalescedCalls.join(coalesceKey, requestId, &joined);
+    if (joined) {
+        return Result(Result::Pending);
     }
 
-    connect(watcher, &QFutureWatcher<CollectionNamesResult>::finished, [=] {
-        watcher->deleteLater();
-        CollectionNamesResult cnr = watcher->future().result();
+    const auto completion = [=] (CollectionNamesResult cnr) {
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(cnr.result);
         outParams << QVariant::fromValue<QVariantMap>(cnr.collectionNames);
-        m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
+        for (quint64 coalescedRequestId : m_coalescedCalls.finish(coalesceKey, call)) {
+            m_requestQueue->requestFinished(coalescedRequestId, outParams);
+        }
+    };
+    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
+        EncryptedStoragePluginWrapper *plugin = m_encryptedStoragePlugins[storagePluginName];
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    [call, plugin] () -> CollectionNamesResult {
+            call->started.storeRelease(1);
+            return EncryptedStoragePluginFunctionWrapper::collectionNames(plugin);
+        }, completion);
+    } else {
+        StoragePluginWrapper *plugin = m_storagePlugins[storagePluginName];
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    [call, plugin] () -> CollectionNamesResult {
+            call->started.storeRelease(1);
+            return StoragePluginFunctionWrapper::collectionNames(plugin);
+        }, completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -368,26 +580,7 @@ Daemon::ApiImpl::RequestProcessor::createDeviceLockCollection(
     metadata.unlockSemantic = static_cast<int>(unlockSemantic);
     metadata.accessControlMode = accessControlMode;
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
-    if (storagePluginName == encryptionPluginName) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::createCollection,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    metadata,
-                    m_requestQueue->deviceLockKey());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::createCollection,
-                    m_storagePlugins[storagePluginName],
-                    metadata);
-    }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result pluginResult = watcher->future().result();
+    const auto completion = [=] (Result pluginResult) {
         if (pluginResult.code() == Result::Succeeded) {
             if (storagePluginName != encryptionPluginName && unlockSemantic == SecretManager::DeviceLockKeepUnlocked) {
                 const QString hashedCollectionName = calculateSecretNameHash(Secret::Identifier(QString(), collectionName, storagePluginName));
@@ -402,8 +595,23 @@ Daemon::ApiImpl::RequestProcessor::createDeviceLockCollection(
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(pluginResult);
         m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
+    };
+    if (storagePluginName == encryptionPluginName) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::createCollection,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              metadata,
+                              m_requestQueue->deviceLockKey()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::createCollection,
+                              m_storagePlugins[storagePluginName],
+                              metadata),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -511,28 +719,11 @@ Daemon::ApiImpl::RequestProcessor::createCustomLockCollectionWithAuthenticationC
         const QString &interactionServiceAddress,
         const QByteArray &authenticationCode)
 {
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (storagePluginName == encryptionPluginName) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
     }
 
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
@@ -551,8 +742,24 @@ Daemon::ApiImpl::RequestProcessor::createCustomLockCollectionWithAuthenticationC
                         interactionServiceAddress,
                         dkr.key);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (storagePluginName == encryptionPluginName) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(encryptionPluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -571,6 +778,10 @@ Daemon::ApiImpl::RequestProcessor::createCustomLockCollectionWithEncryptionKey(
         const QString &interactionServiceAddress,
         const QByteArray &encryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
 
@@ -589,26 +800,7 @@ Daemon::ApiImpl::RequestProcessor::createCustomLockCollectionWithEncryptionKey(
     metadata.unlockSemantic = static_cast<int>(unlockSemantic);
     metadata.accessControlMode = accessControlMode;
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
-    if (storagePluginName == encryptionPluginName) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::createCollection,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    metadata,
-                    encryptionKey);
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::createCollection,
-                    m_storagePlugins[storagePluginName],
-                    metadata);
-    }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result pluginResult = watcher->future().result();
+    const auto completion = [=] (Result pluginResult) {
         if (pluginResult.code() == Result::Succeeded) {
             if (storagePluginName != encryptionPluginName && unlockSemantic == SecretManager::CustomLockKeepUnlocked) {
                 const QString hashedCollectionName = calculateSecretNameHash(
@@ -625,8 +817,23 @@ Daemon::ApiImpl::RequestProcessor::createCustomLockCollectionWithEncryptionKey(
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(pluginResult);
         m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
+    };
+    if (storagePluginName == encryptionPluginName) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::createCollection,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              metadata,
+                              encryptionKey),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::createCollection,
+                              m_storagePlugins[storagePluginName],
+                              metadata),
+                    completion);
+    }
 }
 
 // delete a collection
@@ -657,26 +864,7 @@ Daemon::ApiImpl::RequestProcessor::deleteCollection(
     }
 
     // Read the metadata about the target collection
-    QFutureWatcher<CollectionMetadataResult> *watcher
-            = new QFutureWatcher<CollectionMetadataResult>(this);
-    QFuture<CollectionMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionMetadata,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    collectionName);
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionMetadata,
-                    m_storagePlugins[storagePluginName],
-                    collectionName);
-    }
-
-    connect(watcher, &QFutureWatcher<CollectionMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        CollectionMetadataResult cmr = watcher->future().result();
+    const auto completion = [=] (CollectionMetadataResult cmr) {
         Result result = cmr.result.code() != Result::Succeeded
                 ? cmr.result
                 : deleteCollectionWithMetadata(
@@ -692,8 +880,22 @@ Daemon::ApiImpl::RequestProcessor::deleteCollection(
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -708,6 +910,10 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionWithMetadata(
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // TODO: perform access control request to see if the application has permission to delete the collection.
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
@@ -729,66 +935,91 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionWithMetadata(
                       .arg(collectionMetadata.authenticationPluginName));
     }
 
-    bool locked = false;
-    Result result(Result::Succeeded);
-    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
-        // TODO: make this asynchronous instead of blocking the main thread!
-        QFuture<LockedResult> future
-                = QtConcurrent::run(
-                        m_requestQueue->secretsThreadPool().data(),
-                        EncryptedStoragePluginFunctionWrapper::isCollectionLocked,
-                        m_encryptedStoragePlugins[storagePluginName],
-                        collectionName);
-        future.waitForFinished();
-        LockedResult lr = future.result();
-        result = lr.result;
-        locked = lr.locked;
-        if (result.code() != Result::Succeeded) {
-            return result;
-        }
-    }
+    // Continues once the lock state of the collection is known.
+    const std::function<Result (bool)> continuation = [=] (bool locked) -> Result {
+        if (locked) {
+            const QString authPluginName = determineAuthPlugin(
+                        m_requestQueue->controller(),
+                        collectionMetadata.ownerApplicationId,
+                        callerApplicationId,
+                        applicationIsPlatformApplication,
+                        collectionMetadata.authenticationPluginName,
+                        interactionServiceAddress,
+                        m_autotestMode);
 
-    if (locked) {
-        const QString authPluginName = determineAuthPlugin(
-                    m_requestQueue->controller(),
-                    collectionMetadata.ownerApplicationId,
-                    callerApplicationId,
-                    applicationIsPlatformApplication,
-                    collectionMetadata.authenticationPluginName,
-                    interactionServiceAddress,
-                    m_autotestMode);
-
-        Sailfish::Secrets::InteractionParameters::PromptText promptText({
-             //: This will be displayed to the user, prompting them to enter a lock code which will be used to unlock a collection for deletion. %1 is the application name, %2 is the collection name, %3 is the plugin name.
-             //% "%1 wants to delete collection %2 in plugin %3."
-             { InteractionParameters::Message, qtTrId("sailfish_secrets-delete_collection-la-message")
-                         .arg(callerApplicationId, collectionName, m_requestQueue->controller()->displayNameForPlugin(storagePluginName)) },
-            //% "Enter the lock code which will be used to unlock the collection for deletion."
-            { InteractionParameters::Instruction, qtTrId("sailfish_secrets-delete_collection-la-enter_collection_lock_code") }
-        });
+            Sailfish::Secrets::InteractionParameters::PromptText promptText({
+                 //: This will be displayed to the user, prompting them to enter a lock code which will be used to unlock a collection for deletion. %1 is the application name, %2 is the collection name, %3 is the plugin name.
+                 //% "%1 wants to delete collection %2 in plugin %3."
+                 { InteractionParameters::Message, qtTrId("sailfish_secrets-delete_collection-la-message")
+                             .arg(callerApplicationId, collectionName, m_requestQueue->controller()->displayNameForPlugin(storagePluginName)) },
+                //% "Enter the lock code which will be used to unlock the collection for deletion."
+                { InteractionParameters::Instruction, qtTrId("sailfish_secrets-delete_collection-la-enter_collection_lock_code") }
+            });
 
-        if (collectionMetadata.usesDeviceLockKey) {
-            // Perform a "verify" UI flow (if the user interaction mode allows).
-            // If that succeeds, unlock the collection with the stored devicelock key and continue.
-            if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
-                return Result(Result::CollectionIsLockedError,
-                              QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                              .arg(collectionName));
+            if (collectionMetadata.usesDeviceLockKey) {
+                // Perform a "verify" UI flow (if the user interaction mode allows).
+                // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                    return Result(Result::CollectionIsLockedError,
+                                  QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                  .arg(collectionName));
+                }
+
+                // always use the system authentication plugin for device lock authentication requests.
+                const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                        m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                       : SecretManager::DefaultAuthenticationPluginName);
+                Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                            callerPid,
+                            requestId,
+                            promptText);
+                if (result.code() == Result::Failed) {
+                    return result;
+                }
+
+                // calls deleteCollectionWithEncryptionKey when finished
+                m_pendingRequests.insert(requestId,
+                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                             callerPid,
+                                             requestId,
+                                             Daemon::ApiImpl::DeleteCollectionRequest,
+                                             QVariantList() << collectionName
+                                                            << storagePluginName
+                                                            << userInteractionMode
+                                                            << interactionServiceAddress
+                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                return result;
+            } else if (userInteractionMode == SecretManager::PreventInteraction) {
+                return Result(Result::OperationRequiresUserInteraction,
+                              QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                              .arg(authPluginName));
+            } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                // TODO: stale data in metadata db?
+                return Result(Result::InvalidExtensionPluginError,
+                              QStringLiteral("Unknown collection authentication plugin %1")
+                              .arg(authPluginName));
             }
 
-            // always use the system authentication plugin for device lock authentication requests.
-            const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
-                    m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                                   : SecretManager::DefaultAuthenticationPluginName);
-            Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+            // perform the user input flow required to get the input key data which will be used
+            // to unlock this collection.
+            InteractionParameters promptParams;
+            promptParams.setApplicationId(callerApplicationId);
+            promptParams.setPluginName(storagePluginName);
+            promptParams.setCollectionName(collectionName);
+            promptParams.setOperation(InteractionParameters::DeleteCollection);
+            promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+            promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+            promptParams.setPromptText(promptText);
+            Result result = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
                         callerPid,
                         requestId,
-                        promptText);
+                        promptParams,
+                        interactionServiceAddress);
             if (result.code() == Result::Failed) {
                 return result;
             }
 
-            // calls deleteCollectionWithEncryptionKey when finished
+            // calls deleteCollectionWithLockCode when finished
             m_pendingRequests.insert(requestId,
                                      Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                          callerPid,
@@ -799,61 +1030,31 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionWithMetadata(
                                                         << userInteractionMode
                                                         << interactionServiceAddress
                                                         << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-            return result;
-        } else if (userInteractionMode == SecretManager::PreventInteraction) {
-            return Result(Result::OperationRequiresUserInteraction,
-                          QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                          .arg(authPluginName));
-        } else if (!m_authenticationPlugins.contains(authPluginName)) {
-            // TODO: stale data in metadata db?
-            return Result(Result::InvalidExtensionPluginError,
-                          QStringLiteral("Unknown collection authentication plugin %1")
-                          .arg(authPluginName));
+        } else {
+            deleteCollectionWithLockCode(
+                        callerPid,
+                        requestId,
+                        collectionName,
+                        storagePluginName,
+                        userInteractionMode,
+                        interactionServiceAddress,
+                        collectionMetadata,
+                        QByteArray());
         }
 
-        // perform the user input flow required to get the input key data which will be used
-        // to unlock this collection.
-        InteractionParameters promptParams;
-        promptParams.setApplicationId(callerApplicationId);
-        promptParams.setPluginName(storagePluginName);
-        promptParams.setCollectionName(collectionName);
-        promptParams.setOperation(InteractionParameters::DeleteCollection);
-        promptParams.setInputType(InteractionParameters::AlphaNumericInput);
-        promptParams.setEchoMode(InteractionParameters::PasswordEcho);
-        promptParams.setPromptText(promptText);
-        Result result = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
-                    callerPid,
-                    requestId,
-                    promptParams,
-                    interactionServiceAddress);
-        if (result.code() == Result::Failed) {
-            return result;
-        }
+        return Result(Result::Pending);
+    };
 
-        // calls deleteCollectionWithLockCode when finished
-        m_pendingRequests.insert(requestId,
-                                 Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                     callerPid,
-                                     requestId,
-                                     Daemon::ApiImpl::DeleteCollectionRequest,
-                                     QVariantList() << collectionName
-                                                    << storagePluginName
-                                                    << userInteractionMode
-                                                    << interactionServiceAddress
-                                                    << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-    } else {
-        deleteCollectionWithLockCode(
-                    callerPid,
+    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
+        return withCollectionLockState(
                     requestId,
-                    collectionName,
                     storagePluginName,
-                    userInteractionMode,
-                    interactionServiceAddress,
-                    collectionMetadata,
-                    QByteArray());
+                    collectionName,
+                    QVariantList(),
+                    continuation);
     }
 
-    return Result(Result::Pending);
+    return continuation(false);
 }
 
 void
@@ -867,31 +1068,16 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionWithLockCode(
         const CollectionMetadata &collectionMetadata,
         const QByteArray &lockCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     Q_UNUSED(callerPid);
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
-    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyUnlockAndRemoveCollection,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    collectionName,
-                    lockCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::removeCollection,
-                    m_storagePlugins[storagePluginName],
-                    collectionName);
-    }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result pluginResult = watcher->future().result();
+    const auto completion = [=] (Result pluginResult) {
+        m_requestQueue->storedKeyCache()->invalidate(Secret::Identifier(QString(), collectionName, storagePluginName));
         if (pluginResult.code() == Result::Succeeded) {
             const QString hashedCollectionName = calculateSecretNameHash(
                         Secret::Identifier(QString(), collectionName, storagePluginName));
@@ -904,8 +1090,24 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionWithLockCode(
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(pluginResult);
         m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyUnlockAndRemoveCollection,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              collectionName,
+                              lockCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::removeCollection,
+                              m_storagePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    }
 }
 
 void
@@ -919,30 +1121,16 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionWithEncryptionKey(
         const CollectionMetadata &collectionMetadata,
         const QByteArray &encryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     Q_UNUSED(callerPid);
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
-    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::unlockAndRemoveCollection,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    collectionName,
-                    encryptionKey);
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::removeCollection,
-                    m_storagePlugins[storagePluginName],
-                    collectionName);
-    }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result pluginResult = watcher->future().result();
+    const auto completion = [=] (Result pluginResult) {
+        m_requestQueue->storedKeyCache()->invalidate(Secret::Identifier(QString(), collectionName, storagePluginName));
         if (pluginResult.code() == Result::Succeeded) {
             const QString hashedCollectionName = calculateSecretNameHash(
                         Secret::Identifier(QString(), collectionName, storagePluginName));
@@ -955,8 +1143,23 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionWithEncryptionKey(
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(pluginResult);
         m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::unlockAndRemoveCollection,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              collectionName,
+                              encryptionKey),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::removeCollection,
+                              m_storagePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    }
 }
 
 // this method is a helper for the crypto API.
@@ -988,40 +1191,42 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiers(
     if (collectionName.isEmpty()) {
         // return key identifiers from all collections in the plugin.
         // note that collections which are locked will NOT be represented.
-        // TODO: make this one asynchronous.
-        QFuture<IdentifiersResult> future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    &Daemon::ApiImpl::storedKeyIdentifiers,
-                    m_storagePlugins.value(storagePluginName),
-                    m_encryptedStoragePlugins.value(storagePluginName),
-                    m_cryptoStoragePlugins.value(storagePluginName),
-                    customParameters);
-        future.waitForFinished();
-        *identifiers = future.result().identifiers;
-        return future.result().result;
-    }
+        // Identical requests which arrive before the plugin is invoked
+        // share the result; custom parameters may change the result,
+        // so requests with custom parameters are never coalesced.
+        Q_UNUSED(identifiers); // asynchronous out-parameter.
+        const QString coalesceKey = customParameters.isEmpty()
+                ? QStringLiteral("StoredKeyIdentifiers:") + storagePluginName
+                : QString();
+        bool joined = false;
+        const QSharedPointer<CoalescedCalls::Call> call = m_coalescedCalls.join(coalesceKey, requestId, &joined);
+        if (joined) {
+            return Result(Result::Pending);
+        }
 
-    // Read the metadata about the target collection
-    QFutureWatcher<CollectionMetadataResult> *watcher
-            = new QFutureWatcher<CollectionMetadataResult>(this);
-    QFuture<CollectionMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionMetadata,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    collectionName);
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionMetadata,
-                    m_storagePlugins[storagePluginName],
-                    collectionName);
+        StoragePluginWrapper *storagePlugin = m_storagePlugins.value(storagePluginName);
+        EncryptedStoragePluginWrapper *encryptedStoragePlugin = m_encryptedStoragePlugins.value(storagePluginName);
+        Sailfish::Crypto::Daemon::ApiImpl::CryptoStoragePluginWrapper *cryptoStoragePlugin = m_cryptoStoragePlugins.value(storagePluginName);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    [call, storagePlugin, encryptedStoragePlugin, cryptoStoragePlugin, customParameters] () -> IdentifiersResult {
+            call->started.storeRelease(1);
+            return Daemon::ApiImpl::storedKeyIdentifiers(
+                        storagePlugin, encryptedStoragePlugin, cryptoStoragePlugin, customParameters);
+        }, [=] (IdentifiersResult ir) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(ir.result);
+            outParams << QVariant::fromValue<QVector<Secret::Identifier> >(ir.identifiers);
+            for (quint64 coalescedRequestId : m_coalescedCalls.finish(coalesceKey, call)) {
+                m_requestQueue->requestFinished(coalescedRequestId, outParams);
+            }
+        });
+
+        return Result(Result::Pending);
     }
 
-    connect(watcher, &QFutureWatcher<CollectionMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        CollectionMetadataResult cmr = watcher->future().result();
+    // Read the metadata about the target collection
+    const auto completion = [=] (CollectionMetadataResult cmr) {
         Result result = cmr.result.code() != Result::Succeeded
                 ? cmr.result
                 : storedKeyIdentifiersWithMetadata(
@@ -1038,8 +1243,22 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiers(
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -1055,6 +1274,10 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiersWithMetadata(
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // TODO: perform access control request to see if the application has permission to delete the collection.
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
@@ -1076,66 +1299,92 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiersWithMetadata(
                       .arg(collectionMetadata.authenticationPluginName));
     }
 
-    bool locked = false;
-    Result result(Result::Succeeded);
-    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
-        // TODO: make this asynchronous instead of blocking the main thread!
-        QFuture<LockedResult> future
-                = QtConcurrent::run(
-                        m_requestQueue->secretsThreadPool().data(),
-                        EncryptedStoragePluginFunctionWrapper::isCollectionLocked,
-                        m_encryptedStoragePlugins[storagePluginName],
-                        collectionName);
-        future.waitForFinished();
-        LockedResult lr = future.result();
-        result = lr.result;
-        locked = lr.locked;
-        if (result.code() != Result::Succeeded) {
-            return result;
-        }
-    }
+    // Continues once the lock state of the collection is known.
+    const std::function<Result (bool)> continuation = [=] (bool locked) -> Result {
+        if (locked) {
+            const QString authPluginName = determineAuthPlugin(
+                        m_requestQueue->controller(),
+                        collectionMetadata.ownerApplicationId,
+                        callerApplicationId,
+                        applicationIsPlatformApplication,
+                        collectionMetadata.authenticationPluginName,
+                        interactionServiceAddress,
+                        m_autotestMode);
 
-    if (locked) {
-        const QString authPluginName = determineAuthPlugin(
-                    m_requestQueue->controller(),
-                    collectionMetadata.ownerApplicationId,
-                    callerApplicationId,
-                    applicationIsPlatformApplication,
-                    collectionMetadata.authenticationPluginName,
-                    interactionServiceAddress,
-                    m_autotestMode);
-
-        Sailfish::Secrets::InteractionParameters::PromptText promptText({
-            //: This will be displayed to the user, prompting them to enter a lock code which will be used to unlock a collection to read key identifiers. %1 is the application name, %2 is the collection name, %3 is the plugin name.
-            //% "%1 wants to read key identifiers from collection %2 in plugin %3."
-            { InteractionParameters::Message, qtTrId("sailfish_secrets-unlock_collection-la-message")
-                        .arg(callerApplicationId, collectionName, m_requestQueue->controller()->displayNameForPlugin(storagePluginName)) },
-            //% "Enter the lock code which will be used to unlock the collection."
-            { InteractionParameters::Instruction, qtTrId("sailfish_secrets-unlock_collection-la-enter_collection_lock_code") }
-        });
+            Sailfish::Secrets::InteractionParameters::PromptText promptText({
+                //: This will be displayed to the user, prompting them to enter a lock code which will be used to unlock a collection to read key identifiers. %1 is the application name, %2 is the collection name, %3 is the plugin name.
+                //% "%1 wants to read key identifiers from collection %2 in plugin %3."
+                { InteractionParameters::Message, qtTrId("sailfish_secrets-unlock_collection-la-message")
+                            .arg(callerApplicationId, collectionName, m_requestQueue->controller()->displayNameForPlugin(storagePluginName)) },
+                //% "Enter the lock code which will be used to unlock the collection."
+                { InteractionParameters::Instruction, qtTrId("sailfish_secrets-unlock_collection-la-enter_collection_lock_code") }
+            });
 
-        if (collectionMetadata.usesDeviceLockKey) {
-            // Perform a "verify" UI flow (if the user interaction mode allows).
-            // If that succeeds, unlock the collection with the stored devicelock key and continue.
-            if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
-                return Result(Result::CollectionIsLockedError,
-                              QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                              .arg(collectionName));
+            if (collectionMetadata.usesDeviceLockKey) {
+                // Perform a "verify" UI flow (if the user interaction mode allows).
+                // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                    return Result(Result::CollectionIsLockedError,
+                                  QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                  .arg(collectionName));
+                }
+
+                // always use the system authentication plugin for device lock authentication requests.
+                const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                        m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                       : SecretManager::DefaultAuthenticationPluginName);
+                Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                            callerPid,
+                            requestId,
+                            promptText);
+                if (result.code() == Result::Failed) {
+                    return result;
+                }
+
+                // calls storedKeyIdentifiersWithEncryptionKey when finished
+                m_pendingRequests.insert(requestId,
+                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                             callerPid,
+                                             requestId,
+                                             Daemon::ApiImpl::StoredKeyIdentifiersRequest,
+                                             QVariantList() << collectionName
+                                                            << storagePluginName
+                                                            << customParameters
+                                                            << userInteractionMode
+                                                            << interactionServiceAddress
+                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                return result;
+            } else if (userInteractionMode == SecretManager::PreventInteraction) {
+                return Result(Result::OperationRequiresUserInteraction,
+                              QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                              .arg(authPluginName));
+            } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                // TODO: stale data in metadata db?
+                return Result(Result::InvalidExtensionPluginError,
+                              QStringLiteral("Unknown collection authentication plugin %1")
+                              .arg(authPluginName));
             }
 
-            // always use the system authentication plugin for device lock authentication requests.
-            const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
-                    m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                                   : SecretManager::DefaultAuthenticationPluginName);
-            Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+            // perform the user input flow required to get the input key data which will be used
+            // to unlock this collection.
+            InteractionParameters promptParams;
+            promptParams.setApplicationId(callerApplicationId);
+            promptParams.setPluginName(storagePluginName);
+            promptParams.setCollectionName(collectionName);
+            promptParams.setOperation(InteractionParameters::UnlockCollection);
+            promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+            promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+            promptParams.setPromptText(promptText);
+            Result result = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
                         callerPid,
                         requestId,
-                        promptText);
+                        promptParams,
+                        interactionServiceAddress);
             if (result.code() == Result::Failed) {
                 return result;
             }
 
-            // calls storedKeyIdentifiersWithEncryptionKey when finished
+            // calls storedKeyIdentifiersWithAuthenticationCode when finished
             m_pendingRequests.insert(requestId,
                                      Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                          callerPid,
@@ -1147,64 +1396,33 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiersWithMetadata(
                                                         << userInteractionMode
                                                         << interactionServiceAddress
                                                         << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-            return result;
-        } else if (userInteractionMode == SecretManager::PreventInteraction) {
-            return Result(Result::OperationRequiresUserInteraction,
-                          QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                          .arg(authPluginName));
-        } else if (!m_authenticationPlugins.contains(authPluginName)) {
-            // TODO: stale data in metadata db?
-            return Result(Result::InvalidExtensionPluginError,
-                          QStringLiteral("Unknown collection authentication plugin %1")
-                          .arg(authPluginName));
+        } else {
+            storedKeyIdentifiersWithEncryptionKey(
+                        callerPid,
+                        requestId,
+                        collectionName,
+                        storagePluginName,
+                        customParameters,
+                        userInteractionMode,
+                        interactionServiceAddress,
+                        collectionMetadata,
+                        QByteArray(),
+                        false);
         }
 
-        // perform the user input flow required to get the input key data which will be used
-        // to unlock this collection.
-        InteractionParameters promptParams;
-        promptParams.setApplicationId(callerApplicationId);
-        promptParams.setPluginName(storagePluginName);
-        promptParams.setCollectionName(collectionName);
-        promptParams.setOperation(InteractionParameters::UnlockCollection);
-        promptParams.setInputType(InteractionParameters::AlphaNumericInput);
-        promptParams.setEchoMode(InteractionParameters::PasswordEcho);
-        promptParams.setPromptText(promptText);
-        Result result = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
-                    callerPid,
-                    requestId,
-                    promptParams,
-                    interactionServiceAddress);
-        if (result.code() == Result::Failed) {
-            return result;
-        }
+        return Result(Result::Pending);
+    };
 
-        // calls storedKeyIdentifiersWithAuthenticationCode when finished
-        m_pendingRequests.insert(requestId,
-                                 Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                     callerPid,
-                                     requestId,
-                                     Daemon::ApiImpl::StoredKeyIdentifiersRequest,
-                                     QVariantList() << collectionName
-                                                    << storagePluginName
-                                                    << customParameters
-                                                    << userInteractionMode
-                                                    << interactionServiceAddress
-                                                    << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-    } else {
-        storedKeyIdentifiersWithEncryptionKey(
-                    callerPid,
+    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
+        return withCollectionLockState(
                     requestId,
-                    collectionName,
                     storagePluginName,
-                    customParameters,
-                    userInteractionMode,
-                    interactionServiceAddress,
-                    collectionMetadata,
-                    QByteArray(),
-                    false);
+                    collectionName,
+                    QVariantList(),
+                    continuation);
     }
 
-    return Result(Result::Pending);
+    return continuation(false);
 }
 
 Result
@@ -1219,29 +1437,11 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiersWithAuthenticationCode(
         const CollectionMetadata &collectionMetadata,
         const QByteArray &authenticationCode)
 {
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (storagePluginName == collectionMetadata.encryptionPluginName
-            || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[collectionMetadata.encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
     }
 
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
@@ -1254,8 +1454,25 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiersWithAuthenticationCode(
                         userInteractionMode, interactionServiceAddress,
                         collectionMetadata, dkr.key, true);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -1273,6 +1490,10 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiersWithEncryptionKey(
         const QByteArray &collectionKey,
         bool collectionWasLocked)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     Q_UNUSED(callerPid);
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
@@ -1282,19 +1503,15 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiersWithEncryptionKey(
               && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
             || (collectionMetadata.usesDeviceLockKey
               && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
-    QFutureWatcher<IdentifiersResult> *watcher = new QFutureWatcher<IdentifiersResult>(this);
-    QFuture<IdentifiersResult> future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                &Daemon::ApiImpl::storedKeyIdentifiersFromCollection,
-                m_storagePlugins.value(storagePluginName),
-                m_encryptedStoragePlugins.value(storagePluginName),
-                m_cryptoStoragePlugins.value(storagePluginName),
-                CollectionInfo(collectionName, collectionKey, requiresRelock),
-                customParameters);
-
-    connect(watcher, &QFutureWatcher<IdentifiersResult>::finished, [=] {
-        watcher->deleteLater();
-        IdentifiersResult identResult = watcher->future().result();
+    m_taskExecutor.run(
+                m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                std::bind(&Daemon::ApiImpl::storedKeyIdentifiersFromCollection,
+                          m_storagePlugins.value(storagePluginName),
+                          m_encryptedStoragePlugins.value(storagePluginName),
+                          m_cryptoStoragePlugins.value(storagePluginName),
+                          CollectionInfo(collectionName, collectionKey, requiresRelock),
+                          customParameters),
+                [=] (IdentifiersResult identResult) {
         Result pluginResult = identResult.result;
         if (pluginResult.code() == Result::Succeeded && !requiresRelock) {
             const QString hashedCollectionName = calculateSecretNameHash(
@@ -1307,7 +1524,6 @@ Daemon::ApiImpl::RequestProcessor::storedKeyIdentifiersWithEncryptionKey(
         outParams << QVariant::fromValue<QVector<Secret::Identifier> >(identResult.identifiers);
         m_requestQueue->requestFinished(requestId, outParams);
     });
-    watcher->setFuture(future);
 }
 
 // this method is a helper for the crypto API.
@@ -1400,26 +1616,7 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecret(
     }
 
     // Read the metadata about the target collection
-    QFutureWatcher<CollectionMetadataResult> *watcher
-            = new QFutureWatcher<CollectionMetadataResult>(this);
-    QFuture<CollectionMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionMetadata,
-                    m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
-                    secret.identifier().collectionName());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionMetadata,
-                    m_storagePlugins[secret.identifier().storagePluginName()],
-                    secret.identifier().collectionName());
-    }
-
-    connect(watcher, &QFutureWatcher<CollectionMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        CollectionMetadataResult cmr = watcher->future().result();
+    const auto completion = [=] (CollectionMetadataResult cmr) {
         Result result = cmr.result.code() != Result::Succeeded
                 ? cmr.result
                 : setCollectionSecretWithMetadata(
@@ -1435,8 +1632,22 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecret(
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
+                              secret.identifier().collectionName()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[secret.identifier().storagePluginName()],
+                              secret.identifier().collectionName()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -1451,6 +1662,10 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecretWithMetadata(
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // TODO: perform access control request to see if the application has permission to write secure storage data.
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
@@ -1572,54 +1787,86 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecretGetAuthenticationCode(
     });
 
     if (m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
-        // TODO: make this asynchronous instead of blocking the main thread!
-        QFuture<LockedResult> future
-                = QtConcurrent::run(
-                        m_requestQueue->secretsThreadPool().data(),
-                        EncryptedStoragePluginFunctionWrapper::isCollectionLocked,
-                        m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
-                        secret.identifier().collectionName());
-        future.waitForFinished();
-        LockedResult lr = future.result();
-        Result pluginResult = lr.result;
-        bool locked = lr.locked;
-        if (pluginResult.code() != Result::Succeeded) {
-            return pluginResult;
-        }
-        if (!locked) {
-            setCollectionSecretWithEncryptionKey(
-                        callerPid,
-                        requestId,
-                        secret,
-                        userInteractionMode,
-                        interactionServiceAddress,
-                        collectionMetadata,
-                        QByteArray());
-            return Result(Result::Pending);
-        }
+        return withCollectionLockState(
+                    requestId,
+                    secret.identifier().storagePluginName(),
+                    secret.identifier().collectionName(),
+                    QVariantList(),
+                    [=] (bool locked) -> Result {
+            if (!locked) {
+                setCollectionSecretWithEncryptionKey(
+                            callerPid,
+                            requestId,
+                            secret,
+                            userInteractionMode,
+                            interactionServiceAddress,
+                            collectionMetadata,
+                            QByteArray());
+                return Result(Result::Pending);
+            }
 
-        if (collectionMetadata.usesDeviceLockKey) {
-            // Perform a "verify" UI flow (if the user interaction mode allows).
-            // If that succeeds, unlock the collection with the stored devicelock key and continue.
-            if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
-                return Result(Result::CollectionIsLockedError,
-                              QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                              .arg(secret.identifier().collectionName()));
+            if (collectionMetadata.usesDeviceLockKey) {
+                // Perform a "verify" UI flow (if the user interaction mode allows).
+                // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                    return Result(Result::CollectionIsLockedError,
+                                  QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                  .arg(secret.identifier().collectionName()));
+                }
+
+                // always use the system authentication plugin for device lock authentication requests.
+                const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                        m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                       : SecretManager::DefaultAuthenticationPluginName);
+                Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                            callerPid,
+                            requestId,
+                            promptText);
+                if (result.code() == Result::Failed) {
+                    return result;
+                }
+
+                // calls setCollectionSecretWithEncryptionKey when finished
+                m_pendingRequests.insert(requestId,
+                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                             callerPid,
+                                             requestId,
+                                             Daemon::ApiImpl::SetCollectionSecretRequest,
+                                             QVariantList() << QVariant::fromValue<Secret>(secret)
+                                                            << userInteractionMode
+                                                            << interactionServiceAddress
+                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                return result;
+            } else if (userInteractionMode == SecretManager::PreventInteraction) {
+                return Result(Result::OperationRequiresUserInteraction,
+                              QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                              .arg(authPluginName));
+            } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                return Result(Result::InvalidExtensionPluginError,
+                              QStringLiteral("Unknown collection authentication plugin: %1")
+                              .arg(authPluginName));
             }
 
-            // always use the system authentication plugin for device lock authentication requests.
-            const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
-                    m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                                   : SecretManager::DefaultAuthenticationPluginName);
-            Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+            // perform the user input flow required to get the input key data which will be used
+            // to unlock this collection.
+            InteractionParameters promptParams;
+            promptParams.setApplicationId(callerApplicationId);
+            promptParams.setPluginName(secret.identifier().storagePluginName());
+            promptParams.setCollectionName(secret.identifier().collectionName());
+            promptParams.setSecretName(secret.identifier().name());
+            promptParams.setOperation(InteractionParameters::StoreSecret);
+            promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+            promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+            promptParams.setPromptText(promptText);
+            Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
                         callerPid,
                         requestId,
-                        promptText);
-            if (result.code() == Result::Failed) {
-                return result;
+                        promptParams,
+                        interactionServiceAddress);
+            if (interactionResult.code() == Result::Failed) {
+                return interactionResult;
             }
 
-            // calls setCollectionSecretWithEncryptionKey when finished
             m_pendingRequests.insert(requestId,
                                      Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                          callerPid,
@@ -1629,53 +1876,14 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecretGetAuthenticationCode(
                                                         << userInteractionMode
                                                         << interactionServiceAddress
                                                         << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-            return result;
-        } else if (userInteractionMode == SecretManager::PreventInteraction) {
-            return Result(Result::OperationRequiresUserInteraction,
-                          QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                          .arg(authPluginName));
-        } else if (!m_authenticationPlugins.contains(authPluginName)) {
-            return Result(Result::InvalidExtensionPluginError,
-                          QStringLiteral("Unknown collection authentication plugin: %1")
-                          .arg(authPluginName));
-        }
+            return Result(Result::Pending);
+        });
+    }
 
-        // perform the user input flow required to get the input key data which will be used
-        // to unlock this collection.
-        InteractionParameters promptParams;
-        promptParams.setApplicationId(callerApplicationId);
-        promptParams.setPluginName(secret.identifier().storagePluginName());
-        promptParams.setCollectionName(secret.identifier().collectionName());
-        promptParams.setSecretName(secret.identifier().name());
-        promptParams.setOperation(InteractionParameters::StoreSecret);
-        promptParams.setInputType(InteractionParameters::AlphaNumericInput);
-        promptParams.setEchoMode(InteractionParameters::PasswordEcho);
-        promptParams.setPromptText(promptText);
-        Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
-                    callerPid,
-                    requestId,
-                    promptParams,
-                    interactionServiceAddress);
-        if (interactionResult.code() == Result::Failed) {
-            return interactionResult;
-        }
-
-        m_pendingRequests.insert(requestId,
-                                 Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                     callerPid,
-                                     requestId,
-                                     Daemon::ApiImpl::SetCollectionSecretRequest,
-                                     QVariantList() << QVariant::fromValue<Secret>(secret)
-                                                    << userInteractionMode
-                                                    << interactionServiceAddress
-                                                    << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-        return Result(Result::Pending);
-    }
-
-    const QString hashedCollectionName = calculateSecretNameHash(
-                Secret::Identifier(QString(), secret.identifier().collectionName(), secret.identifier().storagePluginName()));
-    if (m_collectionEncryptionKeys.contains(hashedCollectionName)) {
-        setCollectionSecretWithEncryptionKey(
+    const QString hashedCollectionName = calculateSecretNameHash(
+                Secret::Identifier(QString(), secret.identifier().collectionName(), secret.identifier().storagePluginName()));
+    if (m_collectionEncryptionKeys.contains(hashedCollectionName)) {
+        setCollectionSecretWithEncryptionKey(
                     callerPid,
                     requestId,
                     secret,
@@ -1771,6 +1979,10 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecretWithAuthenticationCode(
         const CollectionMetadata &collectionMetadata,
         const QByteArray &authenticationCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // generate the encryption key from the authentication code
     if (secret.identifier().storagePluginName() == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
@@ -1786,29 +1998,7 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecretWithAuthenticationCode(
                       QStringLiteral("Unknown collection encryption plugin: %1").arg(collectionMetadata.encryptionPluginName));
     }
 
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (secret.identifier().storagePluginName() == collectionMetadata.encryptionPluginName
-            || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[collectionMetadata.encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    }
-
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
@@ -1819,8 +2009,25 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecretWithAuthenticationCode(
                         userInteractionMode, interactionServiceAddress,
                         collectionMetadata, dkr.key);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (secret.identifier().storagePluginName() == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -1835,6 +2042,10 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecretWithEncryptionKey(
         const CollectionMetadata &collectionMetadata,
         const QByteArray &encryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     // In the future, we may need these for access control UI flows.
     Q_UNUSED(callerPid);
     Q_UNUSED(requestId);
@@ -1852,17 +2063,23 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecretWithEncryptionKey(
     secretMetadata.accessControlMode = collectionMetadata.accessControlMode;
     secretMetadata.secretType = secret.type();
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
+    const auto completion = [=] (Result pluginResult) {
+        // a cached copy of a key which was overwritten is stale.
+        m_requestQueue->storedKeyCache()->invalidate(secret.identifier());
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(pluginResult);
+        m_requestQueue->requestFinished(requestId, outParams);
+    };
     if (secret.identifier().storagePluginName() == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                EncryptedStoragePluginFunctionWrapper::unlockCollectionAndStoreSecret,
-                m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
-                secretMetadata,
-                secret,
-                encryptionKey);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::unlockCollectionAndStoreSecret,
+                              m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
+                              secretMetadata,
+                              secret,
+                              encryptionKey),
+                    completion);
     } else {
         bool requiresRelock =
                 ((!secretMetadata.usesDeviceLockKey
@@ -1876,273 +2093,450 @@ Daemon::ApiImpl::RequestProcessor::setCollectionSecretWithEncryptionKey(
             m_collectionEncryptionKeys.insert(hashedCollectionName, encryptionKey);
         }
 
-        future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                StoragePluginFunctionWrapper::encryptAndStoreSecret,
-                m_encryptionPlugins[secretMetadata.encryptionPluginName],
-                m_storagePlugins[secret.identifier().storagePluginName()],
-                secretMetadata,
-                secret,
-                encryptionKey);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::encryptAndStoreSecret,
+                              m_encryptionPlugins[secretMetadata.encryptionPluginName],
+                              m_storagePlugins[secret.identifier().storagePluginName()],
+                              secretMetadata,
+                              secret,
+                              encryptionKey),
+                    completion);
     }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result pluginResult = watcher->future().result();
-        QVariantList outParams;
-        outParams << QVariant::fromValue<Result>(pluginResult);
-        m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
 }
 
-// set a standalone DeviceLock-protected secret
+// set multiple secrets in a collection
 Result
-Daemon::ApiImpl::RequestProcessor::setStandaloneDeviceLockSecret(
+Daemon::ApiImpl::RequestProcessor::setCollectionSecrets(
         pid_t callerPid,
         quint64 requestId,
-        const Secret &secret,
-        const QString &encryptionPluginName,
-        const InteractionParameters &uiParams,
-        SecretManager::DeviceLockUnlockSemantic unlockSemantic,
-        SecretManager::AccessControlMode accessControlMode,
+        const QVector<Secret> &secrets,
         SecretManager::UserInteractionMode userInteractionMode,
-        const QString &interactionServiceAddress)
+        const QString &interactionServiceAddress,
+        QVector<Result> *results)
 {
-    // TODO: Access Control requests to see if the application is permitted to set the secret.
-    Q_UNUSED(userInteractionMode);
-
-    if (secret.identifier().name().isEmpty()) {
+    if (secrets.isEmpty()) {
         return Result(Result::InvalidSecretError,
-                      QLatin1String("Empty secret name given"));
-    } else if (secret.identifier().storagePluginName() == encryptionPluginName
-               && !m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QString::fromLatin1("No such encrypted storage plugin exists: %1")
-                      .arg(secret.identifier().storagePluginName()));
-    } else if (secret.identifier().storagePluginName() != encryptionPluginName
-               && !m_storagePlugins.contains(secret.identifier().storagePluginName())) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QString::fromLatin1("No such storage plugin exists: %1")
-                      .arg(secret.identifier().storagePluginName()));
-    } else if (secret.identifier().storagePluginName() != encryptionPluginName
-               && !m_encryptionPlugins.contains(encryptionPluginName)) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QString::fromLatin1("No such encryption plugin exists: %1").arg(encryptionPluginName));
-    } else if (accessControlMode == SecretManager::SystemAccessControlMode) {
-        // TODO: implement system access control mode.
-        // TODO: in the meantime, change SystemAccessControlMode to OwnerOnlyMode?
-        return Result(Result::OperationNotSupportedError,
-                      QStringLiteral("System access control mode is currently not supported. TODO!"));
-    } else if (uiParams.isValid() && userInteractionMode == SecretManager::PreventInteraction) {
-        return Result(Result::OperationRequiresUserInteraction,
-                      QStringLiteral("The specified interaction mode precludes requesting secret data from the user"));
-    } else if (secret.identifier().storagePluginName() == encryptionPluginName
-               || m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
-        // To support this use case, we'd need to add to the encrypted storage plugin:
-        // re-encryptStandaloneSecrets (for when the device lock key changes).
-        return Result(Result::OperationNotSupportedError,
-                      QStringLiteral("Device-locked standalone secrets cannot be stored in encrypted storage plugins currently"));
+                      QLatin1String("No secrets given"));
     }
 
-    // TODO: perform access control request to see if the application has permission to write secure storage data.
-    const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
-    const QString callerApplicationId = applicationIsPlatformApplication
-                ? m_appPermissions->platformApplicationId()
-                : m_appPermissions->applicationId(callerPid);
-
-    // this is the metadata which we want to store for the secret.
-    SecretMetadata secretMetadata;
-    secretMetadata.collectionName = QStringLiteral("standalone");
-    secretMetadata.secretName = secret.identifier().name();
-    secretMetadata.ownerApplicationId = callerApplicationId;
-    secretMetadata.usesDeviceLockKey = true;
-    secretMetadata.encryptionPluginName = encryptionPluginName;
-    secretMetadata.authenticationPluginName = m_requestQueue->controller()->mappedPluginName(
-            m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                           : SecretManager::DefaultAuthenticationPluginName);
-    secretMetadata.unlockSemantic = unlockSemantic;
-    secretMetadata.accessControlMode = accessControlMode;
-    secretMetadata.secretType = secret.type();
-
-    // Read the metadata about the target secret
-    QFutureWatcher<SecretMetadataResult> *watcher
-            = new QFutureWatcher<SecretMetadataResult>(this);
-    QFuture<SecretMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::secretMetadata,
-                    m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
-                    QStringLiteral("standalone"),
-                    secret.identifier().name());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::secretMetadata,
-                    m_storagePlugins[secret.identifier().storagePluginName()],
-                    QStringLiteral("standalone"),
-                    secret.identifier().name());
+    const Secret::Identifier &identifier(secrets.first().identifier());
+    if (identifier.collectionName().isEmpty()) {
+        return Result(Result::InvalidCollectionError,
+                      QLatin1String("Empty collection name given"));
+    } else if (identifier.collectionName().compare(QStringLiteral("standalone"), Qt::CaseInsensitive) == 0) {
+        return Result(Result::InvalidCollectionError,
+                      QLatin1String("Reserved collection name given"));
+    } else if (identifier.storagePluginName().isEmpty()) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QLatin1String("Empty storage plugin name given"));
+    } else if (!m_storagePlugins.contains(identifier.storagePluginName())
+               && !m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QLatin1String("Unknown storage plugin name given"));
     }
 
-    connect(watcher, &QFutureWatcher<SecretMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        SecretMetadataResult smr = watcher->future().result();
-        Result result;
-        if (smr.result.code() == Result::Failed
-                // invalid secret means that it doesn't yet exist, which is what we want.
-                && smr.result.errorCode() == Result::InvalidSecretError) {
-            result = setStandaloneDeviceLockSecretWithMetadata(
-                        callerPid,
-                        requestId,
-                        secret,
-                        uiParams,
-                        interactionServiceAddress,
-                        secretMetadata);
-        } else if (smr.result.code() == Result::Failed) {
-            result = smr.result;
+    // report every invalid secret, rather than only the first.
+    QVector<Result> secretResults(secrets.size());
+    QSet<QString> secretNames;
+    Result validationResult(Result::Succeeded);
+    for (int i = 0; i < secrets.size(); ++i) {
+        const Secret::Identifier &secretIdentifier(secrets.at(i).identifier());
+        if (secretIdentifier.name().isEmpty()) {
+            secretResults[i] = Result(Result::InvalidSecretError,
+                                      QLatin1String("Empty secret name given"));
+        } else if (secretIdentifier.collectionName() != identifier.collectionName()
+                   || secretIdentifier.storagePluginName() != identifier.storagePluginName()) {
+            secretResults[i] = Result(Result::InvalidCollectionError,
+                                      QString::fromLatin1("Secret %1 is not stored in collection %2 in plugin %3")
+                                      .arg(secretIdentifier.name(), identifier.collectionName(), identifier.storagePluginName()));
+        } else if (secretNames.contains(secretIdentifier.name())) {
+            secretResults[i] = Result(Result::SecretAlreadyExistsError,
+                                      QString::fromLatin1("Secret %1 was given more than once")
+                                      .arg(secretIdentifier.name()));
         } else {
-            // TODO: allow overwrite if:
-            //     - owner is the same
-            //     - usesDeviceLock is the same
-            //     - accessControlMode is the same
-            //     - the customLockKey provided matches / is able to unlock the old secret.
-            result = Result(Result::SecretAlreadyExistsError,
-                            QStringLiteral("Cannot overwrite existing standalone secret"));
+            secretNames.insert(secretIdentifier.name());
+            continue;
+        }
+        if (validationResult.code() == Result::Succeeded) {
+            validationResult = secretResults.at(i);
         }
+    }
+    if (validationResult.code() != Result::Succeeded) {
+        *results = secretResults;
+        return validationResult;
+    }
+
+    // Read the metadata about the target collection
+    const auto completion = [=] (CollectionMetadataResult cmr) {
+        Result result = cmr.result.code() != Result::Succeeded
+                ? cmr.result
+                : setCollectionSecretsWithMetadata(
+                      callerPid,
+                      requestId,
+                      secrets,
+                      userInteractionMode,
+                      interactionServiceAddress,
+                      cmr.metadata);
         if (result.code() != Result::Pending) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::setStandaloneDeviceLockSecretWithMetadata(
+Daemon::ApiImpl::RequestProcessor::setCollectionSecretsWithMetadata(
         pid_t callerPid,
         quint64 requestId,
-        const Secret &secret,
-        const InteractionParameters &uiParams,
+        const QVector<Secret> &secrets,
+        SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
-        const SecretMetadata &newMetadata)
+        const CollectionMetadata &collectionMetadata)
 {
-    // If the secret data is fully specified, we don't need to request it from the user.
-    if (!uiParams.isValid()) {
-        return writeStandaloneDeviceLockSecret(
-                    callerPid,
-                    requestId,
-                    secret,
-                    newMetadata);
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
     }
 
-    // otherwise, we need to perform another asynchronous request,
-    // to retrieve the secret data from the user.
-    QString userInputPlugin = uiParams.authenticationPluginName();
-    if (uiParams.authenticationPluginName().isEmpty()) {
-        // TODO: depending on type, choose the appropriate authentication plugin
-        userInputPlugin = m_autotestMode
-                        ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                        : SecretManager::DefaultAuthenticationPluginName;
-    }
-    userInputPlugin = m_requestQueue->controller()->mappedPluginName(userInputPlugin);
-    if (!m_authenticationPlugins.contains(userInputPlugin)) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QString::fromLatin1("Cannot get user input from invalid authentication plugin: %1")
-                      .arg(uiParams.authenticationPluginName()));
-    }
+    const Secret::Identifier &identifier(secrets.first().identifier());
 
-    // perform UI request to get the data for the secret
-    InteractionParameters modifiedUiParams(uiParams);
-    modifiedUiParams.setApplicationId(newMetadata.ownerApplicationId);
-    modifiedUiParams.setPluginName(secret.identifier().storagePluginName());
-    modifiedUiParams.setCollectionName(QStringLiteral("standalone"));
-    modifiedUiParams.setSecretName(secret.identifier().name());
-    modifiedUiParams.setOperation(InteractionParameters::RequestUserData);
-    modifiedUiParams.setPromptText({
-        //: This will be displayed to the user, prompting them to enter the standalone secret data which will be stored. %1 is the application name, %2 is the secret name, %3 is the plugin name.
-        //% "%1 wants to store a new standalone secret named %2 in plugin %3."
-        { InteractionParameters::Message, qtTrId("sailfish_secrets-set_standalone_secret-la-message")
-                    .arg(newMetadata.ownerApplicationId,
-                            secret.identifier().name(),
-                            m_requestQueue->controller()->displayNameForPlugin(secret.identifier().storagePluginName())) },
-        //% "Enter the confidential data which will be stored."
-        { InteractionParameters::Instruction, qtTrId("sailfish_secrets-set_standalone_secret-la-enter_secret_data") }
-    });
-    Result authenticationResult = m_authenticationPlugins[userInputPlugin]->beginUserInputInteraction(
-                callerPid,
-                requestId,
-                modifiedUiParams,
-                interactionServiceAddress); // in most cases this last parameter will be ignored by the plugin.
-    if (authenticationResult.code() == Result::Failed) {
-        return authenticationResult;
-    }
+    // TODO: perform access control request to see if the application has permission to write secure storage data.
+    const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
+    const QString callerApplicationId = applicationIsPlatformApplication
+                ? m_appPermissions->platformApplicationId()
+                : m_appPermissions->applicationId(callerPid);
 
-    m_pendingRequests.insert(requestId,
-                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                 callerPid,
-                                 requestId,
-                                 Daemon::ApiImpl::SetStandaloneDeviceLockUserInputSecretRequest,
-                                 QVariantList() << QVariant::fromValue<Secret>(secret)
-                                                << QVariant::fromValue<SecretMetadata>(newMetadata)));
-    return Result(Result::Pending);
-}
+    if (collectionMetadata.accessControlMode == SecretManager::SystemAccessControlMode) {
+        // TODO: perform access control request, to ask for permission to set the secrets in the collection.
+        return Result(Result::OperationNotSupportedError,
+                      QLatin1String("Access control requests are not currently supported. TODO!"));
+    } else if (collectionMetadata.accessControlMode == SecretManager::OwnerOnlyMode
+               && collectionMetadata.ownerApplicationId != callerApplicationId) {
+        return Result(Result::PermissionsError,
+                      QString::fromLatin1("Collection %1 in plugin %2 is owned by a different application")
+                      .arg(identifier.collectionName(), identifier.storagePluginName()));
+    }
 
-Result
-Daemon::ApiImpl::RequestProcessor::writeStandaloneDeviceLockSecret(
-        pid_t callerPid,
-        quint64 requestId,
-        const Secret &secret,
-        const SecretMetadata &secretMetadata)
-{
-    Q_UNUSED(callerPid) // may be required in future.
+    const QString authPluginName = determineAuthPlugin(
+                m_requestQueue->controller(),
+                collectionMetadata.ownerApplicationId,
+                callerApplicationId,
+                applicationIsPlatformApplication,
+                collectionMetadata.authenticationPluginName,
+                interactionServiceAddress,
+                m_autotestMode);
 
-    Secret identifiedSecret(secret);
-    identifiedSecret.setCollectionName(QStringLiteral("standalone"));
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future = QtConcurrent::run(
-            m_requestQueue->secretsThreadPool().data(),
-            StoragePluginFunctionWrapper::encryptAndStoreSecret,
-            m_encryptionPlugins[secretMetadata.encryptionPluginName],
-            m_storagePlugins[secret.identifier().storagePluginName()],
-            secretMetadata,
-            identifiedSecret,
-            m_requestQueue->deviceLockKey());
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result pluginResult = watcher->future().result();
-        if (pluginResult.code() == Result::Succeeded) {
-            const QString hashedSecretName = calculateSecretNameHash(
-                        Secret::Identifier(secret.identifier().name(), QStringLiteral("standalone"), secret.identifier().storagePluginName()));
-            m_standaloneSecretEncryptionKeys.insert(hashedSecretName, m_requestQueue->deviceLockKey());
+    Sailfish::Secrets::InteractionParameters::PromptText promptText({
+        //: This will be displayed to the user, prompting them to enter the lock code to unlock the collection in which some new secrets will be stored. %1 is the application name, %2 is the number of secrets, %3 is the collection name, %4 is the plugin name.
+        //% "%1 wants to store %2 new secrets into collection %3 in plugin %4."
+        { InteractionParameters::Message, qtTrId("sailfish_secrets-set_collection_secrets-la-collection_message")
+                    .arg(callerApplicationId,
+                            QString::number(secrets.size()),
+                            identifier.collectionName(),
+                            m_requestQueue->controller()->displayNameForPlugin(identifier.storagePluginName())) },
+        //% "Enter the collection lock code to unlock the collection."
+        { InteractionParameters::Instruction, qtTrId("sailfish_secrets-la-enter_collection_lock_code") }
+    });
+
+    // Obtain the key for the locked collection from the user, and continue
+    // with setCollectionSecretsWithAuthenticationCode or WithEncryptionKey.
+    const auto unlockCollection = [=] () -> Result {
+        const QVariantList pendingParameters = QVariantList()
+                << QVariant::fromValue<QVector<Secret> >(secrets)
+                << userInteractionMode
+                << interactionServiceAddress
+                << QVariant::fromValue<CollectionMetadata>(collectionMetadata);
+        if (collectionMetadata.usesDeviceLockKey) {
+            // Perform a "verify" UI flow (if the user interaction mode allows).
+            // If that succeeds, unlock the collection with the stored devicelock key and continue.
+            if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                return Result(Result::CollectionIsLockedError,
+                              QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                              .arg(identifier.collectionName()));
+            }
+
+            // always use the system authentication plugin for device lock authentication requests.
+            const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                    m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                   : SecretManager::DefaultAuthenticationPluginName);
+            Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                        callerPid,
+                        requestId,
+                        promptText);
+            if (result.code() == Result::Failed) {
+                return result;
+            }
+
+            // calls setCollectionSecretsWithEncryptionKey when finished
+            m_pendingRequests.insert(requestId,
+                                     Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                         callerPid,
+                                         requestId,
+                                         Daemon::ApiImpl::SetCollectionSecretsRequest,
+                                         pendingParameters));
+            return result;
+        }
+
+        if (userInteractionMode == SecretManager::PreventInteraction) {
+            return Result(Result::OperationRequiresUserInteraction,
+                          QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                          .arg(authPluginName));
+        } else if (!m_authenticationPlugins.contains(authPluginName)) {
+            // TODO: stale data in metadata db?
+            return Result(Result::InvalidExtensionPluginError,
+                          QStringLiteral("Unknown collection authentication plugin: %1")
+                          .arg(authPluginName));
+        }
+
+        // perform the user input flow required to get the input key data which will be used
+        // to unlock the collection.
+        InteractionParameters promptParams;
+        promptParams.setApplicationId(callerApplicationId);
+        promptParams.setPluginName(identifier.storagePluginName());
+        promptParams.setCollectionName(identifier.collectionName());
+        if (secrets.size() == 1) {
+            promptParams.setSecretName(identifier.name());
+        }
+        promptParams.setOperation(InteractionParameters::StoreSecret);
+        promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+        promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+        promptParams.setPromptText(promptText);
+        Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
+                    callerPid,
+                    requestId,
+                    promptParams,
+                    interactionServiceAddress);
+        if (interactionResult.code() == Result::Failed) {
+            return interactionResult;
+        }
+
+        // calls setCollectionSecretsWithAuthenticationCode when finished
+        m_pendingRequests.insert(requestId,
+                                 Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                     callerPid,
+                                     requestId,
+                                     Daemon::ApiImpl::SetCollectionSecretsRequest,
+                                     pendingParameters));
+        return Result(Result::Pending);
+    };
+
+    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        return withCollectionLockState(
+                    requestId,
+                    identifier.storagePluginName(),
+                    identifier.collectionName(),
+                    QVariantList(),
+                    [=] (bool locked) -> Result {
+            if (locked) {
+                return unlockCollection();
+            }
+            setCollectionSecretsWithEncryptionKey(
+                        callerPid,
+                        requestId,
+                        secrets,
+                        userInteractionMode,
+                        interactionServiceAddress,
+                        collectionMetadata,
+                        QByteArray()); // no key required, it's unlocked already
+            return Result(Result::Pending);
+        });
+    }
+
+    const QString hashedCollectionName = calculateSecretNameHash(
+                Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
+    if (!m_collectionEncryptionKeys.contains(hashedCollectionName)) {
+        return unlockCollection();
+    }
+
+    setCollectionSecretsWithEncryptionKey(
+                callerPid,
+                requestId,
+                secrets,
+                userInteractionMode,
+                interactionServiceAddress,
+                collectionMetadata,
+                m_collectionEncryptionKeys.value(hashedCollectionName));
+    return Result(Result::Pending);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::setCollectionSecretsWithAuthenticationCode(
+        pid_t callerPid,
+        quint64 requestId,
+        const QVector<Secret> &secrets,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const CollectionMetadata &collectionMetadata,
+        const QByteArray &authenticationCode)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
+    const QString storagePluginName = secrets.first().identifier().storagePluginName();
+
+    // generate the encryption key from the authentication code
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        if (!m_encryptedStoragePlugins.contains(storagePluginName)) {
+            // TODO: stale data in the database?
+            return Result(Result::InvalidExtensionPluginError,
+                          QStringLiteral("Unknown collection encrypted storage plugin: %1")
+                          .arg(storagePluginName));
+        }
+    } else if (!m_encryptionPlugins.contains(collectionMetadata.encryptionPluginName)) {
+        // TODO: stale data in the database?
+        return Result(Result::InvalidExtensionPluginError,
+                      QStringLiteral("Unknown collection encryption plugin: %1").arg(collectionMetadata.encryptionPluginName));
+    }
+
+    const auto completion = [=] (DerivedKeyResult dkr) {
+        if (dkr.result.code() != Result::Succeeded) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(dkr.result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        } else {
+            setCollectionSecretsWithEncryptionKey(
+                        callerPid, requestId, secrets,
+                        userInteractionMode, interactionServiceAddress,
+                        collectionMetadata, dkr.key);
         }
+    };
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
+
+    return Result(Result::Pending);
+}
+
+void
+Daemon::ApiImpl::RequestProcessor::setCollectionSecretsWithEncryptionKey(
+        pid_t callerPid,
+        quint64 requestId,
+        const QVector<Secret> &secrets,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const CollectionMetadata &collectionMetadata,
+        const QByteArray &encryptionKey)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    // In the future, we may need these for access control UI flows.
+    Q_UNUSED(callerPid);
+    Q_UNUSED(userInteractionMode);
+    Q_UNUSED(interactionServiceAddress);
+
+    const Secret::Identifier &identifier(secrets.first().identifier());
+    QVector<SecretMetadata> secretsMetadata;
+    secretsMetadata.reserve(secrets.size());
+    for (const Secret &secret : secrets) {
+        SecretMetadata secretMetadata;
+        secretMetadata.collectionName = secret.identifier().collectionName();
+        secretMetadata.secretName = secret.identifier().name();
+        secretMetadata.ownerApplicationId = collectionMetadata.ownerApplicationId;
+        secretMetadata.usesDeviceLockKey = collectionMetadata.usesDeviceLockKey;
+        secretMetadata.encryptionPluginName = collectionMetadata.encryptionPluginName;
+        secretMetadata.authenticationPluginName = collectionMetadata.authenticationPluginName;
+        secretMetadata.unlockSemantic = collectionMetadata.unlockSemantic;
+        secretMetadata.accessControlMode = collectionMetadata.accessControlMode;
+        secretMetadata.secretType = secret.type();
+        secretsMetadata.append(secretMetadata);
+    }
+
+    const auto completion = [=] (StoreSecretsResult ssr) {
+        m_requestQueue->storedKeyCache()->invalidate(Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
         QVariantList outParams;
-        outParams << QVariant::fromValue<Result>(pluginResult);
+        outParams << QVariant::fromValue<Result>(ssr.result);
+        outParams << QVariant::fromValue<QVector<Result> >(ssr.results);
         m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
+    };
+    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::unlockCollectionAndStoreSecrets,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              secretsMetadata,
+                              secrets,
+                              encryptionKey),
+                    completion);
+    } else {
+        bool requiresRelock =
+                ((!collectionMetadata.usesDeviceLockKey
+                  && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
+                || (collectionMetadata.usesDeviceLockKey
+                  && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
+        const QString hashedCollectionName = calculateSecretNameHash(
+                    Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
+        if (!m_collectionEncryptionKeys.contains(hashedCollectionName) && !requiresRelock) {
+            // TODO: some way to "test" the encryptionKey!
+            m_collectionEncryptionKeys.insert(hashedCollectionName, encryptionKey);
+        }
 
-    return Result(Result::Pending);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::encryptAndStoreSecrets,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              m_storagePlugins[identifier.storagePluginName()],
+                              secretsMetadata,
+                              secrets,
+                              encryptionKey),
+                    completion);
+    }
 }
 
-// set a standalone CustomLock-protected secret
+// set a standalone DeviceLock-protected secret
 Result
-Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecret(
+Daemon::ApiImpl::RequestProcessor::setStandaloneDeviceLockSecret(
         pid_t callerPid,
         quint64 requestId,
         const Secret &secret,
         const QString &encryptionPluginName,
-        const QString &authenticationPluginName,
         const InteractionParameters &uiParams,
-        SecretManager::CustomLockUnlockSemantic unlockSemantic,
+        SecretManager::DeviceLockUnlockSemantic unlockSemantic,
         SecretManager::AccessControlMode accessControlMode,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress)
 {
+    // TODO: Access Control requests to see if the application is permitted to set the secret.
+    Q_UNUSED(userInteractionMode);
+
     if (secret.identifier().name().isEmpty()) {
         return Result(Result::InvalidSecretError,
                       QLatin1String("Empty secret name given"));
@@ -2159,20 +2553,21 @@ Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecret(
     } else if (secret.identifier().storagePluginName() != encryptionPluginName
                && !m_encryptionPlugins.contains(encryptionPluginName)) {
         return Result(Result::InvalidExtensionPluginError,
-                      QString::fromLatin1("No such encryption plugin exists: %1")
-                      .arg(encryptionPluginName));
-    } else if (m_authenticationPlugins[authenticationPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
-               && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
-        return Result(Result::OperationRequiresApplicationUserInteraction,
-                      QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
-                      .arg(authenticationPluginName));
-    } else if (userInteractionMode == SecretManager::PreventInteraction) {
-        return Result(Result::OperationRequiresUserInteraction,
-                      QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                      .arg(authenticationPluginName));
+                      QString::fromLatin1("No such encryption plugin exists: %1").arg(encryptionPluginName));
     } else if (accessControlMode == SecretManager::SystemAccessControlMode) {
+        // TODO: implement system access control mode.
+        // TODO: in the meantime, change SystemAccessControlMode to OwnerOnlyMode?
         return Result(Result::OperationNotSupportedError,
                       QStringLiteral("System access control mode is currently not supported. TODO!"));
+    } else if (uiParams.isValid() && userInteractionMode == SecretManager::PreventInteraction) {
+        return Result(Result::OperationRequiresUserInteraction,
+                      QStringLiteral("The specified interaction mode precludes requesting secret data from the user"));
+    } else if (secret.identifier().storagePluginName() == encryptionPluginName
+               || m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
+        // To support this use case, we'd need to add to the encrypted storage plugin:
+        // re-encryptStandaloneSecrets (for when the device lock key changes).
+        return Result(Result::OperationNotSupportedError,
+                      QStringLiteral("Device-locked standalone secrets cannot be stored in encrypted storage plugins currently"));
     }
 
     // TODO: perform access control request to see if the application has permission to write secure storage data.
@@ -2186,46 +2581,26 @@ Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecret(
     secretMetadata.collectionName = QStringLiteral("standalone");
     secretMetadata.secretName = secret.identifier().name();
     secretMetadata.ownerApplicationId = callerApplicationId;
-    secretMetadata.usesDeviceLockKey = false;
+    secretMetadata.usesDeviceLockKey = true;
     secretMetadata.encryptionPluginName = encryptionPluginName;
-    secretMetadata.authenticationPluginName = authenticationPluginName;
+    secretMetadata.authenticationPluginName = m_requestQueue->controller()->mappedPluginName(
+            m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                           : SecretManager::DefaultAuthenticationPluginName);
     secretMetadata.unlockSemantic = unlockSemantic;
     secretMetadata.accessControlMode = accessControlMode;
     secretMetadata.secretType = secret.type();
 
     // Read the metadata about the target secret
-    QFutureWatcher<SecretMetadataResult> *watcher
-            = new QFutureWatcher<SecretMetadataResult>(this);
-    QFuture<SecretMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::secretMetadata,
-                    m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
-                    QStringLiteral("standalone"),
-                    secret.identifier().name());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::secretMetadata,
-                    m_storagePlugins[secret.identifier().storagePluginName()],
-                    QStringLiteral("standalone"),
-                    secret.identifier().name());
-    }
-
-    connect(watcher, &QFutureWatcher<SecretMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        SecretMetadataResult smr = watcher->future().result();
+    const auto completion = [=] (SecretMetadataResult smr) {
         Result result;
         if (smr.result.code() == Result::Failed
                 // invalid secret means that it doesn't yet exist, which is what we want.
                 && smr.result.errorCode() == Result::InvalidSecretError) {
-            result = setStandaloneCustomLockSecretWithMetadata(
+            result = setStandaloneDeviceLockSecretWithMetadata(
                         callerPid,
                         requestId,
                         secret,
                         uiParams,
-                        userInteractionMode,
                         interactionServiceAddress,
                         secretMetadata);
         } else if (smr.result.code() == Result::Failed) {
@@ -2244,30 +2619,47 @@ Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecret(
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::secretMetadata,
+                              m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
+                              QStringLiteral("standalone"),
+                              secret.identifier().name()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::secretMetadata,
+                              m_storagePlugins[secret.identifier().storagePluginName()],
+                              QStringLiteral("standalone"),
+                              secret.identifier().name()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecretWithMetadata(
+Daemon::ApiImpl::RequestProcessor::setStandaloneDeviceLockSecretWithMetadata(
         pid_t callerPid,
         quint64 requestId,
         const Secret &secret,
         const InteractionParameters &uiParams,
-        SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
         const SecretMetadata &newMetadata)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // If the secret data is fully specified, we don't need to request it from the user.
     if (!uiParams.isValid()) {
-        return setStandaloneCustomLockSecretGetAuthenticationCode(
+        return writeStandaloneDeviceLockSecret(
                     callerPid,
                     requestId,
                     secret,
-                    userInteractionMode,
-                    interactionServiceAddress,
                     newMetadata);
     }
 
@@ -2317,38 +2709,264 @@ Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecretWithMetadata(
                              Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                  callerPid,
                                  requestId,
-                                 Daemon::ApiImpl::SetStandaloneCustomLockUserInputSecretRequest,
+                                 Daemon::ApiImpl::SetStandaloneDeviceLockUserInputSecretRequest,
                                  QVariantList() << QVariant::fromValue<Secret>(secret)
-                                                << userInteractionMode
-                                                << interactionServiceAddress
                                                 << QVariant::fromValue<SecretMetadata>(newMetadata)));
     return Result(Result::Pending);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecretGetAuthenticationCode(
+Daemon::ApiImpl::RequestProcessor::writeStandaloneDeviceLockSecret(
         pid_t callerPid,
         quint64 requestId,
         const Secret &secret,
-        SecretManager::UserInteractionMode userInteractionMode,
-        const QString &interactionServiceAddress,
         const SecretMetadata &secretMetadata)
 {
-    // perform the user input flow required to get the input key data which will be used
-    // to encrypt the secret
-    InteractionParameters promptParams;
-    promptParams.setApplicationId(secretMetadata.ownerApplicationId);
-    promptParams.setPluginName(secret.identifier().storagePluginName());
-    promptParams.setCollectionName(QStringLiteral("standalone"));
-    promptParams.setSecretName(secret.identifier().name());
-    promptParams.setOperation(InteractionParameters::StoreSecret);
-    promptParams.setInputType(InteractionParameters::AlphaNumericInput);
-    promptParams.setEchoMode(InteractionParameters::PasswordEcho);
-    promptParams.setPromptText({
-        //: This will be displayed to the user, prompting them to enter the passphrase to encrypt a standalone secret. %1 is the application name, %2 is the secret name, %3 is the plugin name.
-        //% "%1 wants to store a new standalone secret named %2 into plugin %3"
-        { InteractionParameters::Message, qtTrId("sailfish_secrets-set_standalone_secret-la-message")
-                    .arg(secretMetadata.ownerApplicationId,
+    Q_UNUSED(callerPid) // may be required in future.
+
+    Secret identifiedSecret(secret);
+    identifiedSecret.setCollectionName(QStringLiteral("standalone"));
+    m_taskExecutor.run(
+                m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                std::bind(StoragePluginFunctionWrapper::encryptAndStoreSecret,
+                          m_encryptionPlugins[secretMetadata.encryptionPluginName],
+                          m_storagePlugins[secret.identifier().storagePluginName()],
+                          secretMetadata,
+                          identifiedSecret,
+                          m_requestQueue->deviceLockKey()),
+                [=] (Result pluginResult) {
+        if (pluginResult.code() == Result::Succeeded) {
+            const QString hashedSecretName = calculateSecretNameHash(
+                        Secret::Identifier(secret.identifier().name(), QStringLiteral("standalone"), secret.identifier().storagePluginName()));
+            m_standaloneSecretEncryptionKeys.insert(hashedSecretName, m_requestQueue->deviceLockKey());
+        }
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(pluginResult);
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
+
+    return Result(Result::Pending);
+}
+
+// set a standalone CustomLock-protected secret
+Result
+Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecret(
+        pid_t callerPid,
+        quint64 requestId,
+        const Secret &secret,
+        const QString &encryptionPluginName,
+        const QString &authenticationPluginName,
+        const InteractionParameters &uiParams,
+        SecretManager::CustomLockUnlockSemantic unlockSemantic,
+        SecretManager::AccessControlMode accessControlMode,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress)
+{
+    if (secret.identifier().name().isEmpty()) {
+        return Result(Result::InvalidSecretError,
+                      QLatin1String("Empty secret name given"));
+    } else if (secret.identifier().storagePluginName() == encryptionPluginName
+               && !m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QString::fromLatin1("No such encrypted storage plugin exists: %1")
+                      .arg(secret.identifier().storagePluginName()));
+    } else if (secret.identifier().storagePluginName() != encryptionPluginName
+               && !m_storagePlugins.contains(secret.identifier().storagePluginName())) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QString::fromLatin1("No such storage plugin exists: %1")
+                      .arg(secret.identifier().storagePluginName()));
+    } else if (secret.identifier().storagePluginName() != encryptionPluginName
+               && !m_encryptionPlugins.contains(encryptionPluginName)) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QString::fromLatin1("No such encryption plugin exists: %1")
+                      .arg(encryptionPluginName));
+    } else if (m_authenticationPlugins[authenticationPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
+               && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
+        return Result(Result::OperationRequiresApplicationUserInteraction,
+                      QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
+                      .arg(authenticationPluginName));
+    } else if (userInteractionMode == SecretManager::PreventInteraction) {
+        return Result(Result::OperationRequiresUserInteraction,
+                      QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                      .arg(authenticationPluginName));
+    } else if (accessControlMode == SecretManager::SystemAccessControlMode) {
+        return Result(Result::OperationNotSupportedError,
+                      QStringLiteral("System access control mode is currently not supported. TODO!"));
+    }
+
+    // TODO: perform access control request to see if the application has permission to write secure storage data.
+    const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
+    const QString callerApplicationId = applicationIsPlatformApplication
+                ? m_appPermissions->platformApplicationId()
+                : m_appPermissions->applicationId(callerPid);
+
+    // this is the metadata which we want to store for the secret.
+    SecretMetadata secretMetadata;
+    secretMetadata.collectionName = QStringLiteral("standalone");
+    secretMetadata.secretName = secret.identifier().name();
+    secretMetadata.ownerApplicationId = callerApplicationId;
+    secretMetadata.usesDeviceLockKey = false;
+    secretMetadata.encryptionPluginName = encryptionPluginName;
+    secretMetadata.authenticationPluginName = authenticationPluginName;
+    secretMetadata.unlockSemantic = unlockSemantic;
+    secretMetadata.accessControlMode = accessControlMode;
+    secretMetadata.secretType = secret.type();
+
+    // Read the metadata about the target secret
+    const auto completion = [=] (SecretMetadataResult smr) {
+        Result result;
+        if (smr.result.code() == Result::Failed
+                // invalid secret means that it doesn't yet exist, which is what we want.
+                && smr.result.errorCode() == Result::InvalidSecretError) {
+            result = setStandaloneCustomLockSecretWithMetadata(
+                        callerPid,
+                        requestId,
+                        secret,
+                        uiParams,
+                        userInteractionMode,
+                        interactionServiceAddress,
+                        secretMetadata);
+        } else if (smr.result.code() == Result::Failed) {
+            result = smr.result;
+        } else {
+            // TODO: allow overwrite if:
+            //     - owner is the same
+            //     - usesDeviceLock is the same
+            //     - accessControlMode is the same
+            //     - the customLockKey provided matches / is able to unlock the old secret.
+            result = Result(Result::SecretAlreadyExistsError,
+                            QStringLiteral("Cannot overwrite existing standalone secret"));
+        }
+        if (result.code() != Result::Pending) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        }
+    };
+    if (m_encryptedStoragePlugins.contains(secret.identifier().storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::secretMetadata,
+                              m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
+                              QStringLiteral("standalone"),
+                              secret.identifier().name()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::secretMetadata,
+                              m_storagePlugins[secret.identifier().storagePluginName()],
+                              QStringLiteral("standalone"),
+                              secret.identifier().name()),
+                    completion);
+    }
+
+    return Result(Result::Pending);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecretWithMetadata(
+        pid_t callerPid,
+        quint64 requestId,
+        const Secret &secret,
+        const InteractionParameters &uiParams,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const SecretMetadata &newMetadata)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
+    // If the secret data is fully specified, we don't need to request it from the user.
+    if (!uiParams.isValid()) {
+        return setStandaloneCustomLockSecretGetAuthenticationCode(
+                    callerPid,
+                    requestId,
+                    secret,
+                    userInteractionMode,
+                    interactionServiceAddress,
+                    newMetadata);
+    }
+
+    // otherwise, we need to perform another asynchronous request,
+    // to retrieve the secret data from the user.
+    QString userInputPlugin = uiParams.authenticationPluginName();
+    if (uiParams.authenticationPluginName().isEmpty()) {
+        // TODO: depending on type, choose the appropriate authentication plugin
+        userInputPlugin = m_autotestMode
+                        ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                        : SecretManager::DefaultAuthenticationPluginName;
+    }
+    userInputPlugin = m_requestQueue->controller()->mappedPluginName(userInputPlugin);
+    if (!m_authenticationPlugins.contains(userInputPlugin)) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QString::fromLatin1("Cannot get user input from invalid authentication plugin: %1")
+                      .arg(uiParams.authenticationPluginName()));
+    }
+
+    // perform UI request to get the data for the secret
+    InteractionParameters modifiedUiParams(uiParams);
+    modifiedUiParams.setApplicationId(newMetadata.ownerApplicationId);
+    modifiedUiParams.setPluginName(secret.identifier().storagePluginName());
+    modifiedUiParams.setCollectionName(QStringLiteral("standalone"));
+    modifiedUiParams.setSecretName(secret.identifier().name());
+    modifiedUiParams.setOperation(InteractionParameters::RequestUserData);
+    modifiedUiParams.setPromptText({
+        //: This will be displayed to the user, prompting them to enter the standalone secret data which will be stored. %1 is the application name, %2 is the secret name, %3 is the plugin name.
+        //% "%1 wants to store a new standalone secret named %2 in plugin %3."
+        { InteractionParameters::Message, qtTrId("sailfish_secrets-set_standalone_secret-la-message")
+                    .arg(newMetadata.ownerApplicationId,
+                            secret.identifier().name(),
+                            m_requestQueue->controller()->displayNameForPlugin(secret.identifier().storagePluginName())) },
+        //% "Enter the confidential data which will be stored."
+        { InteractionParameters::Instruction, qtTrId("sailfish_secrets-set_standalone_secret-la-enter_secret_data") }
+    });
+    Result authenticationResult = m_authenticationPlugins[userInputPlugin]->beginUserInputInteraction(
+                callerPid,
+                requestId,
+                modifiedUiParams,
+                interactionServiceAddress); // in most cases this last parameter will be ignored by the plugin.
+    if (authenticationResult.code() == Result::Failed) {
+        return authenticationResult;
+    }
+
+    m_pendingRequests.insert(requestId,
+                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                 callerPid,
+                                 requestId,
+                                 Daemon::ApiImpl::SetStandaloneCustomLockUserInputSecretRequest,
+                                 QVariantList() << QVariant::fromValue<Secret>(secret)
+                                                << userInteractionMode
+                                                << interactionServiceAddress
+                                                << QVariant::fromValue<SecretMetadata>(newMetadata)));
+    return Result(Result::Pending);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecretGetAuthenticationCode(
+        pid_t callerPid,
+        quint64 requestId,
+        const Secret &secret,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const SecretMetadata &secretMetadata)
+{
+    // perform the user input flow required to get the input key data which will be used
+    // to encrypt the secret
+    InteractionParameters promptParams;
+    promptParams.setApplicationId(secretMetadata.ownerApplicationId);
+    promptParams.setPluginName(secret.identifier().storagePluginName());
+    promptParams.setCollectionName(QStringLiteral("standalone"));
+    promptParams.setSecretName(secret.identifier().name());
+    promptParams.setOperation(InteractionParameters::StoreSecret);
+    promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+    promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+    promptParams.setPromptText({
+        //: This will be displayed to the user, prompting them to enter the passphrase to encrypt a standalone secret. %1 is the application name, %2 is the secret name, %3 is the plugin name.
+        //% "%1 wants to store a new standalone secret named %2 into plugin %3"
+        { InteractionParameters::Message, qtTrId("sailfish_secrets-set_standalone_secret-la-message")
+                    .arg(secretMetadata.ownerApplicationId,
                             secret.identifier().name(),
                             m_requestQueue->controller()->displayNameForPlugin(secret.identifier().storagePluginName())) },
         //% "Enter the passphrase which will be used to encrypt the secret."
@@ -2384,29 +3002,11 @@ Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecretWithAuthenticati
         const SecretMetadata &secretMetadata,
         const QByteArray &authenticationCode)
 {
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (secret.identifier().storagePluginName() == secretMetadata.encryptionPluginName
-            || secretMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[secretMetadata.encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
     }
 
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
@@ -2416,8 +3016,25 @@ Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecretWithAuthenticati
                         callerPid, requestId, secret,
                         secretMetadata, dkr.key);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (secret.identifier().storagePluginName() == secretMetadata.encryptionPluginName
+            || secretMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secretMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[secretMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -2430,38 +3047,16 @@ Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecretWithEncryptionKe
         const SecretMetadata &secretMetadata,
         const QByteArray &encryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     Q_UNUSED(callerPid);
 
     Secret identifiedSecret(secret);
     identifiedSecret.setCollectionName(QStringLiteral("standalone"));
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
-    if (secret.identifier().storagePluginName() == secretMetadata.encryptionPluginName
-            || secretMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                EncryptedStoragePluginFunctionWrapper::setStandaloneSecret,
-                m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
-                secretMetadata,
-                identifiedSecret,
-                encryptionKey);
-    } else {
-        Secret identifiedSecret(secret);
-        identifiedSecret.setCollectionName(QStringLiteral("standalone"));
-        future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                StoragePluginFunctionWrapper::encryptAndStoreSecret,
-                m_encryptionPlugins[secretMetadata.encryptionPluginName],
-                m_storagePlugins[secret.identifier().storagePluginName()],
-                secretMetadata,
-                identifiedSecret,
-                encryptionKey);
-    }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result pluginResult = watcher->future().result();
+    const auto completion = [=] (Result pluginResult) {
         if (pluginResult.code() == Result::Succeeded) {
             if (secret.identifier().storagePluginName() != secretMetadata.encryptionPluginName) {
                 const QString hashedSecretName = calculateSecretNameHash(
@@ -2475,8 +3070,30 @@ Daemon::ApiImpl::RequestProcessor::setStandaloneCustomLockSecretWithEncryptionKe
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(pluginResult);
         m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
+    };
+    if (secret.identifier().storagePluginName() == secretMetadata.encryptionPluginName
+            || secretMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::setStandaloneSecret,
+                              m_encryptedStoragePlugins[secret.identifier().storagePluginName()],
+                              secretMetadata,
+                              identifiedSecret,
+                              encryptionKey),
+                    completion);
+    } else {
+        Secret identifiedSecret(secret);
+        identifiedSecret.setCollectionName(QStringLiteral("standalone"));
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secret.identifier().storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::encryptAndStoreSecret,
+                              m_encryptionPlugins[secretMetadata.encryptionPluginName],
+                              m_storagePlugins[secret.identifier().storagePluginName()],
+                              secretMetadata,
+                              identifiedSecret,
+                              encryptionKey),
+                    completion);
+    }
 }
 
 // get a secret in a collection
@@ -2509,26 +3126,7 @@ Daemon::ApiImpl::RequestProcessor::getCollectionSecret(
     }
 
     // Read the metadata about the target collection
-    QFutureWatcher<CollectionMetadataResult> *watcher
-            = new QFutureWatcher<CollectionMetadataResult>(this);
-    QFuture<CollectionMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionMetadata,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    identifier.collectionName());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionMetadata,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    identifier.collectionName());
-    }
-
-    connect(watcher, &QFutureWatcher<CollectionMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        CollectionMetadataResult cmr = watcher->future().result();
+    const auto completion = [=] (CollectionMetadataResult cmr) {
         Result result = cmr.result.code() != Result::Succeeded
                 ? cmr.result
                 : getCollectionSecretWithMetadata(
@@ -2543,8 +3141,22 @@ Daemon::ApiImpl::RequestProcessor::getCollectionSecret(
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -2558,8 +3170,12 @@ Daemon::ApiImpl::RequestProcessor::getCollectionSecretWithMetadata(
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata)
 {
-    // TODO: perform access control request to see if the application has permission to write secure storage data.
-    const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
+    // TODO: perform access control request to see if the application has permission to write secure storage data.
+    const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
                 ? m_appPermissions->platformApplicationId()
                 : m_appPermissions->applicationId(callerPid);
@@ -2598,112 +3214,104 @@ Daemon::ApiImpl::RequestProcessor::getCollectionSecretWithMetadata(
 
     if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
-        // TODO: make this asynchronous instead of blocking the main thread!
-        QFuture<LockedResult> future
-                = QtConcurrent::run(
-                        m_requestQueue->secretsThreadPool().data(),
-                        EncryptedStoragePluginFunctionWrapper::isCollectionLocked,
-                        m_encryptedStoragePlugins[identifier.storagePluginName()],
-                        identifier.collectionName());
-        future.waitForFinished();
-        LockedResult lr = future.result();
-        Result pluginResult = lr.result;
-        bool locked = lr.locked;
-        if (pluginResult.code() != Result::Succeeded) {
-            return pluginResult;
-        }
+        return withCollectionLockState(
+                    requestId,
+                    identifier.storagePluginName(),
+                    identifier.collectionName(),
+                    QVariantList(),
+                    [=] (bool locked) -> Result {
+            if (locked) {
+                if (collectionMetadata.usesDeviceLockKey) {
+                    // Perform a "verify" UI flow (if the user interaction mode allows).
+                    // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                    if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                        return Result(Result::CollectionIsLockedError,
+                                      QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                      .arg(identifier.collectionName()));
+                    }
 
-        if (locked) {
-            if (collectionMetadata.usesDeviceLockKey) {
-                // Perform a "verify" UI flow (if the user interaction mode allows).
-                // If that succeeds, unlock the collection with the stored devicelock key and continue.
-                if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
-                    return Result(Result::CollectionIsLockedError,
-                                  QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                                  .arg(identifier.collectionName()));
-                }
+                    // always use the system authentication plugin for device lock authentication requests.
+                    const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                            m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                           : SecretManager::DefaultAuthenticationPluginName);
+                    Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                                callerPid,
+                                requestId,
+                                promptText);
+                    if (result.code() == Result::Failed) {
+                        return result;
+                    }
 
-                // always use the system authentication plugin for device lock authentication requests.
-                const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
-                        m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                                       : SecretManager::DefaultAuthenticationPluginName);
-                Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
-                            callerPid,
-                            requestId,
-                            promptText);
-                if (result.code() == Result::Failed) {
+                    // calls getCollectionSecretWithEncryptionKey when finished
+                    m_pendingRequests.insert(requestId,
+                                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                                 callerPid,
+                                                 requestId,
+                                                 Daemon::ApiImpl::GetCollectionSecretRequest,
+                                                 QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                                                << userInteractionMode
+                                                                << interactionServiceAddress
+                                                                << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
                     return result;
-                }
+                } else {
+                    if (userInteractionMode == SecretManager::PreventInteraction) {
+                        return Result(Result::OperationRequiresUserInteraction,
+                                      QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                                      .arg(authPluginName));
+                    } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                        // TODO: stale data in the database?
+                        return Result(Result::InvalidExtensionPluginError,
+                                      QString::fromLatin1("Authentication plugin %1 for collection %2 in storage plugin %3 does not exist")
+                                      .arg(authPluginName, collectionMetadata.collectionName, identifier.storagePluginName()));
+                    } else if (m_authenticationPlugins[authPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
+                                && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
+                        return Result(Result::OperationRequiresApplicationUserInteraction,
+                                      QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
+                                      .arg(authPluginName));
+                    }
 
-                // calls getCollectionSecretWithEncryptionKey when finished
-                m_pendingRequests.insert(requestId,
-                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                             callerPid,
-                                             requestId,
-                                             Daemon::ApiImpl::GetCollectionSecretRequest,
-                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
-                                                            << userInteractionMode
-                                                            << interactionServiceAddress
-                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-                return result;
-            } else {
-                if (userInteractionMode == SecretManager::PreventInteraction) {
-                    return Result(Result::OperationRequiresUserInteraction,
-                                  QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                                  .arg(authPluginName));
-                } else if (!m_authenticationPlugins.contains(authPluginName)) {
-                    // TODO: stale data in the database?
-                    return Result(Result::InvalidExtensionPluginError,
-                                  QString::fromLatin1("Authentication plugin %1 for collection %2 in storage plugin %3 does not exist")
-                                  .arg(authPluginName, collectionMetadata.collectionName, identifier.storagePluginName()));
-                } else if (m_authenticationPlugins[authPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
-                            && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
-                    return Result(Result::OperationRequiresApplicationUserInteraction,
-                                  QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
-                                  .arg(authPluginName));
-                }
+                    // perform the user input flow required to get the input key data which will be used
+                    // to unlock the collection.
+                    InteractionParameters promptParams;
+                    promptParams.setApplicationId(callerApplicationId);
+                    promptParams.setCollectionName(identifier.collectionName());
+                    promptParams.setSecretName(identifier.name());
+                    promptParams.setOperation(InteractionParameters::ReadSecret);
+                    promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+                    promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+                    promptParams.setPromptText(promptText);
+                    Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
+                                callerPid,
+                                requestId,
+                                promptParams,
+                                interactionServiceAddress);
+                    if (interactionResult.code() == Result::Failed) {
+                        return interactionResult;
+                    }
 
-                // perform the user input flow required to get the input key data which will be used
-                // to unlock the collection.
-                InteractionParameters promptParams;
-                promptParams.setApplicationId(callerApplicationId);
-                promptParams.setCollectionName(identifier.collectionName());
-                promptParams.setSecretName(identifier.name());
-                promptParams.setOperation(InteractionParameters::ReadSecret);
-                promptParams.setInputType(InteractionParameters::AlphaNumericInput);
-                promptParams.setEchoMode(InteractionParameters::PasswordEcho);
-                promptParams.setPromptText(promptText);
-                Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
+                    m_pendingRequests.insert(requestId,
+                                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                                 callerPid,
+                                                 requestId,
+                                                 Daemon::ApiImpl::GetCollectionSecretRequest,
+                                                 QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                                                << userInteractionMode
+                                                                << interactionServiceAddress
+                                                                << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                    return Result(Result::Pending);
+                }
+            } else {
+                getCollectionSecretWithEncryptionKey(
                             callerPid,
                             requestId,
-                            promptParams,
-                            interactionServiceAddress);
-                if (interactionResult.code() == Result::Failed) {
-                    return interactionResult;
-                }
-
-                m_pendingRequests.insert(requestId,
-                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                             callerPid,
-                                             requestId,
-                                             Daemon::ApiImpl::GetCollectionSecretRequest,
-                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
-                                                            << userInteractionMode
-                                                            << interactionServiceAddress
-                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                            identifier,
+                            userInteractionMode,
+                            interactionServiceAddress,
+                            collectionMetadata,
+                            QByteArray()); // no key required, it's unlocked already
                 return Result(Result::Pending);
             }
-        } else {
-            getCollectionSecretWithEncryptionKey(
-                        callerPid,
-                        requestId,
-                        identifier,
-                        userInteractionMode,
-                        interactionServiceAddress,
-                        collectionMetadata,
-                        QByteArray()); // no key required, it's unlocked already
-            return Result(Result::Pending);
-        }
+        });
     } else {
         const QString hashedCollectionName = calculateSecretNameHash(
                     Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
@@ -2811,6 +3419,10 @@ Daemon::ApiImpl::RequestProcessor::getCollectionSecretWithAuthenticationCode(
         const CollectionMetadata &collectionMetadata,
         const QByteArray &authenticationCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // generate the encryption key from the authentication code
     if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
@@ -2827,29 +3439,7 @@ Daemon::ApiImpl::RequestProcessor::getCollectionSecretWithAuthenticationCode(
                       .arg(collectionMetadata.encryptionPluginName));
     }
 
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
-            || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[collectionMetadata.encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    }
-
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
@@ -2860,8 +3450,25 @@ Daemon::ApiImpl::RequestProcessor::getCollectionSecretWithAuthenticationCode(
                         userInteractionMode, interactionServiceAddress,
                         collectionMetadata, dkr.key);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -2876,30 +3483,39 @@ Daemon::ApiImpl::RequestProcessor::getCollectionSecretWithEncryptionKey(
         const CollectionMetadata &collectionMetadata,
         const QByteArray &encryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     // might be required in future for access control requests.
     Q_UNUSED(callerPid);
     Q_UNUSED(requestId);
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
 
-    QFutureWatcher<SecretResult> *watcher
-            = new QFutureWatcher<SecretResult>(this);
-    QFuture<SecretResult> future;
+    const bool requiresRelock =
+            ((!collectionMetadata.usesDeviceLockKey
+              && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
+            || (collectionMetadata.usesDeviceLockKey
+              && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
+    const auto completion = [=] (SecretResult sr) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(sr.result);
+        outParams << QVariant::fromValue<Secret>(sr.secret);
+        outParams << QVariant::fromValue<bool>(!requiresRelock);
+        m_requestQueue->requestFinished(requestId, outParams);
+    };
     if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                EncryptedStoragePluginFunctionWrapper::unlockCollectionAndReadSecret,
-                m_encryptedStoragePlugins[identifier.storagePluginName()],
-                collectionMetadata,
-                identifier,
-                encryptionKey);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::unlockCollectionAndReadSecret,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              collectionMetadata,
+                              identifier,
+                              encryptionKey),
+                    completion);
     } else {
-        bool requiresRelock =
-                ((!collectionMetadata.usesDeviceLockKey
-                  && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
-                || (collectionMetadata.usesDeviceLockKey
-                  && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
         const QString hashedCollectionName = calculateSecretNameHash(
                     Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
         if (!m_collectionEncryptionKeys.contains(hashedCollectionName) && !requiresRelock) {
@@ -2907,105 +3523,141 @@ Daemon::ApiImpl::RequestProcessor::getCollectionSecretWithEncryptionKey(
             m_collectionEncryptionKeys.insert(hashedCollectionName, encryptionKey);
         }
 
-        future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                StoragePluginFunctionWrapper::getAndDecryptSecret,
-                m_encryptionPlugins[collectionMetadata.encryptionPluginName],
-                m_storagePlugins[identifier.storagePluginName()],
-                identifier,
-                encryptionKey);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::getAndDecryptSecret,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier,
+                              encryptionKey),
+                    completion);
     }
-
-    connect(watcher, &QFutureWatcher<SecretResult>::finished, [=] {
-        watcher->deleteLater();
-        SecretResult sr = watcher->future().result();
-        QVariantList outParams;
-        outParams << QVariant::fromValue<Result>(sr.result);
-        outParams << QVariant::fromValue<Secret>(sr.secret);
-        m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
 }
 
-// get a standalone secret
+// get secrets from one or more collections
 Result
-Daemon::ApiImpl::RequestProcessor::getStandaloneSecret(
+Daemon::ApiImpl::RequestProcessor::getCollectionSecrets(
         pid_t callerPid,
         quint64 requestId,
-        const Secret::Identifier &identifier,
+        const QVector<Secret::Identifier> &identifiers,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
-        Secret *secret)
+        QVector<Secret> *secrets)
 {
-    Q_UNUSED(secret); // asynchronous out param.
-    if (identifier.name().isEmpty()) {
+    Q_UNUSED(secrets); // asynchronous out param.
+    if (identifiers.isEmpty()) {
         return Result(Result::InvalidSecretError,
-                      QLatin1String("Empty secret name given"));
-    } else if (!identifier.collectionName().isEmpty()) {
-        return Result(Result::InvalidCollectionError,
-                      QLatin1String("Non-empty collection given for standalone secret request"));
-    } else if (identifier.storagePluginName().isEmpty()) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QLatin1String("Empty storage plugin name given"));
-    } else if (!m_encryptedStoragePlugins.contains(identifier.storagePluginName())
-               && !m_storagePlugins.contains(identifier.storagePluginName())) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QLatin1String("Unknown storage plugin name given"));
-    }
+                      QLatin1String("No secret identifiers given"));
+    }
+
+    // group the secrets by collection, so that each collection is only
+    // checked and unlocked once, and its secrets are read together.
+    CollectionSecretsBatch batch;
+    QHash<QPair<QString, QString>, int> collectionIndexes;
+    for (int i = 0; i < identifiers.size(); ++i) {
+        const Secret::Identifier &identifier(identifiers.at(i));
+        if (identifier.name().isEmpty()) {
+            return Result(Result::InvalidSecretError,
+                          QLatin1String("Empty secret name given"));
+        } else if (identifier.collectionName().isEmpty()) {
+            return Result(Result::InvalidCollectionError,
+                          QLatin1String("Empty collection name given"));
+        } else if (identifier.collectionName().compare(QStringLiteral("standalone"), Qt::CaseInsensitive) == 0) {
+            return Result(Result::InvalidCollectionError,
+                          QLatin1String("Reserved collection name given"));
+        } else if (identifier.storagePluginName().isEmpty()) {
+            return Result(Result::InvalidExtensionPluginError,
+                          QLatin1String("Empty storage plugin name given"));
+        } else if (!m_encryptedStoragePlugins.contains(identifier.storagePluginName())
+                   && !m_storagePlugins.contains(identifier.storagePluginName())) {
+            return Result(Result::InvalidExtensionPluginError,
+                          QLatin1String("Unknown storage plugin name given"));
+        }
 
-    // Read the metadata about the target secret
-    QFutureWatcher<SecretMetadataResult> *watcher
-            = new QFutureWatcher<SecretMetadataResult>(this);
-    QFuture<SecretMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::secretMetadata,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    QStringLiteral("standalone"),
-                    identifier.name());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::secretMetadata,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    QStringLiteral("standalone"),
-                    identifier.name());
+        const QPair<QString, QString> collection(identifier.storagePluginName(), identifier.collectionName());
+        int collectionIndex = collectionIndexes.value(collection, -1);
+        if (collectionIndex < 0) {
+            collectionIndex = batch.identifiers.size();
+            collectionIndexes.insert(collection, collectionIndex);
+            batch.identifiers.append(QVector<Secret::Identifier>());
+            batch.indexes.append(QVector<int>());
+        }
+        batch.identifiers[collectionIndex].append(identifier);
+        batch.indexes[collectionIndex].append(i);
     }
+    batch.secrets.resize(identifiers.size());
 
-    connect(watcher, &QFutureWatcher<SecretMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        SecretMetadataResult smr = watcher->future().result();
-        Result result = smr.result.code() != Result::Succeeded
-                ? smr.result
-                : getStandaloneSecretWithMetadata(
+    return getCollectionSecretsFromCollection(
+                callerPid,
+                requestId,
+                batch,
+                userInteractionMode,
+                interactionServiceAddress);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::getCollectionSecretsFromCollection(
+        pid_t callerPid,
+        quint64 requestId,
+        const CollectionSecretsBatch &batch,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress)
+{
+    const Secret::Identifier &identifier(batch.identifiers.at(batch.current).first());
+
+    // Read the metadata about the target collection
+    const auto completion = [=] (CollectionMetadataResult cmr) {
+        Result result = cmr.result.code() != Result::Succeeded
+                ? cmr.result
+                : getCollectionSecretsWithMetadata(
                       callerPid,
                       requestId,
-                      identifier,
+                      batch,
                       userInteractionMode,
                       interactionServiceAddress,
-                      smr.metadata);
+                      cmr.metadata);
         if (result.code() != Result::Pending) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::getStandaloneSecretWithMetadata(
+Daemon::ApiImpl::RequestProcessor::getCollectionSecretsWithMetadata(
         pid_t callerPid,
         quint64 requestId,
-        const Secret::Identifier &identifier,
+        const CollectionSecretsBatch &batch,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
-        const SecretMetadata &secretMetadata)
+        const CollectionMetadata &collectionMetadata)
 {
-    // TODO: perform access control request to see if the application has permission to write secure storage data.
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
+    const QVector<Secret::Identifier> &identifiers(batch.identifiers.at(batch.current));
+    const Secret::Identifier &identifier(identifiers.first());
+
+    // TODO: perform access control request to see if the application has permission to read secure storage data.
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
                 ? m_appPermissions->platformApplicationId()
@@ -3013,256 +3665,1104 @@ Daemon::ApiImpl::RequestProcessor::getStandaloneSecretWithMetadata(
 
     const QString authPluginName = determineAuthPlugin(
                 m_requestQueue->controller(),
-                secretMetadata.ownerApplicationId,
+                collectionMetadata.ownerApplicationId,
                 callerApplicationId,
                 applicationIsPlatformApplication,
-                secretMetadata.authenticationPluginName,
+                collectionMetadata.authenticationPluginName,
                 interactionServiceAddress,
                 m_autotestMode);
 
-    const QString hashedSecretName = calculateSecretNameHash(
-                Secret::Identifier(identifier.name(),
-                                   QStringLiteral("standalone"),
-                                   identifier.storagePluginName()));
-    if (m_standaloneSecretEncryptionKeys.contains(hashedSecretName)) {
-        getStandaloneSecretWithEncryptionKey(
-                    callerPid,
-                    requestId,
-                    identifier,
-                    userInteractionMode,
-                    interactionServiceAddress,
-                    secretMetadata,
-                    m_standaloneSecretEncryptionKeys.value(hashedSecretName));
-        return Result(Result::Pending);
+    if (collectionMetadata.accessControlMode == SecretManager::SystemAccessControlMode) {
+        // TODO: perform access control request, to ask for permission to read the secrets in the collection.
+        return Result(Result::OperationNotSupportedError,
+                      QLatin1String("Access control requests are not currently supported. TODO!"));
+    } else if (collectionMetadata.accessControlMode == SecretManager::OwnerOnlyMode
+               && collectionMetadata.ownerApplicationId != callerApplicationId) {
+        return Result(Result::PermissionsError,
+                      QString::fromLatin1("Collection %1 in plugin %2 is owned by a different application")
+                      .arg(identifier.collectionName(), identifier.storagePluginName()));
     }
 
     Sailfish::Secrets::InteractionParameters::PromptText promptText({
-        //: This will be displayed to the user, prompting them to enter the passphrase to unlock the standalone secret in order to retrieve it. %1 is the application name, %2 is the standalone secret name, %3 is the plugin name.
-        //% "%1 wants to retrieve standalone secret %2 from plugin %3."
-        { InteractionParameters::Message, qtTrId("sailfish_secrets-get_standalone_secret-la-message")
+        //: This will be displayed to the user, prompting them to enter the lock code to unlock the collection in order to retrieve some secrets. %1 is the application name, %2 is the number of secrets, %3 is the collection name, %4 is the plugin name.
+        //% "%1 wants to retrieve %2 secrets from collection %3 in plugin %4."
+        { InteractionParameters::Message, qtTrId("sailfish_secrets-get_collection_secrets-la-message")
                     .arg(callerApplicationId,
-                            identifier.name(),
+                            QString::number(identifiers.size()),
                             identifier.collectionName(),
                             m_requestQueue->controller()->displayNameForPlugin(identifier.storagePluginName())) },
-        //% "Enter the passphrase to unlock the secret."
-        { InteractionParameters::Instruction, qtTrId("sailfish_secrets-get_standalone_secret-la-enter_secret_passphrase") }
+        //% "Enter the collection lock code to unlock the collection."
+        { InteractionParameters::Instruction, qtTrId("sailfish_secrets-la-enter_collection_lock_code") }
     });
 
-    if (secretMetadata.usesDeviceLockKey) {
-        // Perform a "verify" UI flow (if the user interaction mode allows).
-        // If that succeeds, unlock the collection with the stored devicelock key and continue.
-        if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
-            return Result(Result::CollectionIsLockedError,
-                          QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                          .arg(identifier.collectionName()));
-        }
+    // Obtain the key for the locked collection from the user, and continue
+    // with getCollectionSecretsWithAuthenticationCode or WithEncryptionKey.
+    const auto unlockCollection = [=] () -> Result {
+        const QVariantList pendingParameters = QVariantList()
+                << QVariant::fromValue<CollectionSecretsBatch>(batch)
+                << userInteractionMode
+                << interactionServiceAddress
+                << QVariant::fromValue<CollectionMetadata>(collectionMetadata);
+        if (collectionMetadata.usesDeviceLockKey) {
+            // Perform a "verify" UI flow (if the user interaction mode allows).
+            // If that succeeds, unlock the collection with the stored devicelock key and continue.
+            if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                return Result(Result::CollectionIsLockedError,
+                              QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                              .arg(identifier.collectionName()));
+            }
 
-        // always use the system authentication plugin for device lock authentication requests.
-        const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
-                m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                               : SecretManager::DefaultAuthenticationPluginName);
-        Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
-                    callerPid,
-                    requestId,
-                    promptText);
-        if (result.code() == Result::Failed) {
-            return result;
-        }
+            // always use the system authentication plugin for device lock authentication requests.
+            const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                    m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                   : SecretManager::DefaultAuthenticationPluginName);
+            Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                        callerPid,
+                        requestId,
+                        promptText);
+            if (result.code() == Result::Failed) {
+                return result;
+            }
 
-        // calls getStandaloneSecretWithEncryptionKey when finished
+            // calls getCollectionSecretsWithEncryptionKey when finished
+            m_pendingRequests.insert(requestId,
+                                     Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                         callerPid,
+                                         requestId,
+                                         Daemon::ApiImpl::GetCollectionSecretsRequest,
+                                         pendingParameters));
+            return result;
+        }
+
+        if (userInteractionMode == SecretManager::PreventInteraction) {
+            return Result(Result::OperationRequiresUserInteraction,
+                          QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                          .arg(authPluginName));
+        } else if (!m_authenticationPlugins.contains(authPluginName)) {
+            // TODO: stale data in the database?
+            return Result(Result::InvalidExtensionPluginError,
+                          QString::fromLatin1("Authentication plugin %1 for collection %2 in storage plugin %3 does not exist")
+                          .arg(authPluginName, collectionMetadata.collectionName, identifier.storagePluginName()));
+        } else if (m_authenticationPlugins[authPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
+                   && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
+            return Result(Result::OperationRequiresApplicationUserInteraction,
+                          QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
+                          .arg(authPluginName));
+        }
+
+        // perform the user input flow required to get the input key data which will be used
+        // to unlock the collection.
+        InteractionParameters promptParams;
+        promptParams.setApplicationId(callerApplicationId);
+        promptParams.setCollectionName(identifier.collectionName());
+        if (identifiers.size() == 1) {
+            promptParams.setSecretName(identifier.name());
+        }
+        promptParams.setOperation(InteractionParameters::ReadSecret);
+        promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+        promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+        promptParams.setPromptText(promptText);
+        Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
+                    callerPid,
+                    requestId,
+                    promptParams,
+                    interactionServiceAddress);
+        if (interactionResult.code() == Result::Failed) {
+            return interactionResult;
+        }
+
+        // calls getCollectionSecretsWithAuthenticationCode when finished
         m_pendingRequests.insert(requestId,
                                  Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                      callerPid,
                                      requestId,
-                                     Daemon::ApiImpl::GetStandaloneSecretRequest,
-                                     QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
-                                                    << userInteractionMode
-                                                    << interactionServiceAddress
-                                                    << QVariant::fromValue<SecretMetadata>(secretMetadata)));
-        return result;
-    } else if (userInteractionMode == SecretManager::PreventInteraction) {
-        return Result(Result::OperationRequiresUserInteraction,
-                      QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                      .arg(authPluginName));
-    } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                                     Daemon::ApiImpl::GetCollectionSecretsRequest,
+                                     pendingParameters));
+        return Result(Result::Pending);
+    };
+
+    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        return withCollectionLockState(
+                    requestId,
+                    identifier.storagePluginName(),
+                    identifier.collectionName(),
+                    QVariantList(),
+                    [=] (bool locked) -> Result {
+            if (locked) {
+                return unlockCollection();
+            }
+            getCollectionSecretsWithEncryptionKey(
+                        callerPid,
+                        requestId,
+                        batch,
+                        userInteractionMode,
+                        interactionServiceAddress,
+                        collectionMetadata,
+                        QByteArray()); // no key required, it's unlocked already
+            return Result(Result::Pending);
+        });
+    }
+
+    const QString hashedCollectionName = calculateSecretNameHash(
+                Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
+    if (!m_collectionEncryptionKeys.contains(hashedCollectionName)) {
+        return unlockCollection();
+    }
+
+    getCollectionSecretsWithEncryptionKey(
+                callerPid,
+                requestId,
+                batch,
+                userInteractionMode,
+                interactionServiceAddress,
+                collectionMetadata,
+                m_collectionEncryptionKeys.value(hashedCollectionName));
+    return Result(Result::Pending);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::getCollectionSecretsWithAuthenticationCode(
+        pid_t callerPid,
+        quint64 requestId,
+        const CollectionSecretsBatch &batch,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const CollectionMetadata &collectionMetadata,
+        const QByteArray &authenticationCode)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
+    const QString storagePluginName = batch.identifiers.at(batch.current).first().storagePluginName();
+
+    // generate the encryption key from the authentication code
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        if (!m_encryptedStoragePlugins.contains(storagePluginName)) {
+            // TODO: stale data in the database?
+            return Result(Result::InvalidExtensionPluginError,
+                          QStringLiteral("Unknown collection encrypted storage plugin: %1")
+                          .arg(storagePluginName));
+        }
+    } else if (!m_encryptionPlugins.contains(collectionMetadata.encryptionPluginName)) {
+        // TODO: stale data in the database?
         return Result(Result::InvalidExtensionPluginError,
-                      QStringLiteral("Unknown secret authentication plugin %2")
-                      .arg(authPluginName));
+                      QStringLiteral("Unknown collection encryption plugin: %1")
+                      .arg(collectionMetadata.encryptionPluginName));
+    }
+
+    const auto completion = [=] (DerivedKeyResult dkr) {
+        if (dkr.result.code() != Result::Succeeded) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(dkr.result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        } else {
+            getCollectionSecretsWithEncryptionKey(
+                        callerPid, requestId, batch,
+                        userInteractionMode, interactionServiceAddress,
+                        collectionMetadata, dkr.key);
+        }
+    };
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
+
+    return Result(Result::Pending);
+}
+
+void
+Daemon::ApiImpl::RequestProcessor::getCollectionSecretsWithEncryptionKey(
+        pid_t callerPid,
+        quint64 requestId,
+        const CollectionSecretsBatch &batch,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const CollectionMetadata &collectionMetadata,
+        const QByteArray &encryptionKey)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    const QVector<Secret::Identifier> &identifiers(batch.identifiers.at(batch.current));
+    const QString storagePluginName = identifiers.first().storagePluginName();
+
+    // store the secrets which were read, and continue with the next collection.
+    const auto completion = [=] (SecretsResult sr) {
+        Result result = sr.result;
+        if (result.code() == Result::Succeeded) {
+            CollectionSecretsBatch nextBatch(batch);
+            const QVector<int> &indexes(batch.indexes.at(batch.current));
+            for (int i = 0; i < indexes.size() && i < sr.secrets.size(); ++i) {
+                nextBatch.secrets[indexes.at(i)] = sr.secrets.at(i);
+            }
+            if (++nextBatch.current < nextBatch.identifiers.size()) {
+                result = getCollectionSecretsFromCollection(
+                            callerPid,
+                            requestId,
+                            nextBatch,
+                            userInteractionMode,
+                            interactionServiceAddress);
+            } else {
+                QVariantList outParams;
+                outParams << QVariant::fromValue<Result>(result);
+                outParams << QVariant::fromValue<QVector<Secret> >(nextBatch.secrets);
+                m_requestQueue->requestFinished(requestId, outParams);
+                return;
+            }
+        }
+        if (result.code() != Result::Pending) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        }
+    };
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::unlockCollectionAndReadSecrets,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              collectionMetadata,
+                              identifiers,
+                              encryptionKey),
+                    completion);
+    } else {
+        bool requiresRelock =
+                ((!collectionMetadata.usesDeviceLockKey
+                  && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
+                || (collectionMetadata.usesDeviceLockKey
+                  && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
+        const QString hashedCollectionName = calculateSecretNameHash(
+                    Secret::Identifier(QString(), identifiers.first().collectionName(), storagePluginName));
+        if (!m_collectionEncryptionKeys.contains(hashedCollectionName) && !requiresRelock) {
+            // TODO: some way to "test" the encryptionKey!  also, if it's a custom lock, set the timeout, etc.
+            m_collectionEncryptionKeys.insert(hashedCollectionName, encryptionKey);
+        }
+
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::getAndDecryptSecrets,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              m_storagePlugins[storagePluginName],
+                              identifiers,
+                              encryptionKey),
+                    completion);
+    }
+}
+
+// get a standalone secret
+Result
+Daemon::ApiImpl::RequestProcessor::getStandaloneSecret(
+        pid_t callerPid,
+        quint64 requestId,
+        const Secret::Identifier &identifier,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        Secret *secret)
+{
+    Q_UNUSED(secret); // asynchronous out param.
+    if (identifier.name().isEmpty()) {
+        return Result(Result::InvalidSecretError,
+                      QLatin1String("Empty secret name given"));
+    } else if (!identifier.collectionName().isEmpty()) {
+        return Result(Result::InvalidCollectionError,
+                      QLatin1String("Non-empty collection given for standalone secret request"));
+    } else if (identifier.storagePluginName().isEmpty()) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QLatin1String("Empty storage plugin name given"));
+    } else if (!m_encryptedStoragePlugins.contains(identifier.storagePluginName())
+               && !m_storagePlugins.contains(identifier.storagePluginName())) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QLatin1String("Unknown storage plugin name given"));
     }
 
-    // perform the user input flow required to get the input key data
-    // (authentication code) which will be used to decrypt the secret.
-    InteractionParameters promptParams;
-    promptParams.setApplicationId(callerApplicationId);
-    promptParams.setPluginName(identifier.storagePluginName());
-    promptParams.setCollectionName(QString());
-    promptParams.setSecretName(identifier.name());
-    promptParams.setOperation(InteractionParameters::ReadSecret);
-    promptParams.setInputType(InteractionParameters::AlphaNumericInput);
-    promptParams.setEchoMode(InteractionParameters::PasswordEcho);
-    promptParams.setPromptText(promptText);
-    Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
-                callerPid,
-                requestId,
-                promptParams,
-                interactionServiceAddress);
-    if (interactionResult.code() == Result::Failed) {
-        return interactionResult;
+    // Read the metadata about the target secret
+    const auto completion = [=] (SecretMetadataResult smr) {
+        Result result = smr.result.code() != Result::Succeeded
+                ? smr.result
+                : getStandaloneSecretWithMetadata(
+                      callerPid,
+                      requestId,
+                      identifier,
+                      userInteractionMode,
+                      interactionServiceAddress,
+                      smr.metadata);
+        if (result.code() != Result::Pending) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        }
+    };
+    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::secretMetadata,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              QStringLiteral("standalone"),
+                              identifier.name()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::secretMetadata,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              QStringLiteral("standalone"),
+                              identifier.name()),
+                    completion);
+    }
+
+    return Result(Result::Pending);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::getStandaloneSecretWithMetadata(
+        pid_t callerPid,
+        quint64 requestId,
+        const Secret::Identifier &identifier,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const SecretMetadata &secretMetadata)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
+    // TODO: perform access control request to see if the application has permission to write secure storage data.
+    const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
+    const QString callerApplicationId = applicationIsPlatformApplication
+                ? m_appPermissions->platformApplicationId()
+                : m_appPermissions->applicationId(callerPid);
+
+    const QString authPluginName = determineAuthPlugin(
+                m_requestQueue->controller(),
+                secretMetadata.ownerApplicationId,
+                callerApplicationId,
+                applicationIsPlatformApplication,
+                secretMetadata.authenticationPluginName,
+                interactionServiceAddress,
+                m_autotestMode);
+
+    const QString hashedSecretName = calculateSecretNameHash(
+                Secret::Identifier(identifier.name(),
+                                   QStringLiteral("standalone"),
+                                   identifier.storagePluginName()));
+    if (m_standaloneSecretEncryptionKeys.contains(hashedSecretName)) {
+        getStandaloneSecretWithEncryptionKey(
+                    callerPid,
+                    requestId,
+                    identifier,
+                    userInteractionMode,
+                    interactionServiceAddress,
+                    secretMetadata,
+                    m_standaloneSecretEncryptionKeys.value(hashedSecretName));
+        return Result(Result::Pending);
+    }
+
+    Sailfish::Secrets::InteractionParameters::PromptText promptText({
+        //: This will be displayed to the user, prompting them to enter the passphrase to unlock the standalone secret in order to retrieve it. %1 is the application name, %2 is the standalone secret name, %3 is the plugin name.
+        //% "%1 wants to retrieve standalone secret %2 from plugin %3."
+        { InteractionParameters::Message, qtTrId("sailfish_secrets-get_standalone_secret-la-message")
+                    .arg(callerApplicationId,
+                            identifier.name(),
+                            identifier.collectionName(),
+                            m_requestQueue->controller()->displayNameForPlugin(identifier.storagePluginName())) },
+        //% "Enter the passphrase to unlock the secret."
+        { InteractionParameters::Instruction, qtTrId("sailfish_secrets-get_standalone_secret-la-enter_secret_passphrase") }
+    });
+
+    if (secretMetadata.usesDeviceLockKey) {
+        // Perform a "verify" UI flow (if the user interaction mode allows).
+        // If that succeeds, unlock the collection with the stored devicelock key and continue.
+        if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+            return Result(Result::CollectionIsLockedError,
+                          QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                          .arg(identifier.collectionName()));
+        }
+
+        // always use the system authentication plugin for device lock authentication requests.
+        const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                               : SecretManager::DefaultAuthenticationPluginName);
+        Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                    callerPid,
+                    requestId,
+                    promptText);
+        if (result.code() == Result::Failed) {
+            return result;
+        }
+
+        // calls getStandaloneSecretWithEncryptionKey when finished
+        m_pendingRequests.insert(requestId,
+                                 Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                     callerPid,
+                                     requestId,
+                                     Daemon::ApiImpl::GetStandaloneSecretRequest,
+                                     QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                                    << userInteractionMode
+                                                    << interactionServiceAddress
+                                                    << QVariant::fromValue<SecretMetadata>(secretMetadata)));
+        return result;
+    } else if (userInteractionMode == SecretManager::PreventInteraction) {
+        return Result(Result::OperationRequiresUserInteraction,
+                      QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                      .arg(authPluginName));
+    } else if (!m_authenticationPlugins.contains(authPluginName)) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QStringLiteral("Unknown secret authentication plugin %2")
+                      .arg(authPluginName));
+    }
+
+    // perform the user input flow required to get the input key data
+    // (authentication code) which will be used to decrypt the secret.
+    InteractionParameters promptParams;
+    promptParams.setApplicationId(callerApplicationId);
+    promptParams.setPluginName(identifier.storagePluginName());
+    promptParams.setCollectionName(QString());
+    promptParams.setSecretName(identifier.name());
+    promptParams.setOperation(InteractionParameters::ReadSecret);
+    promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+    promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+    promptParams.setPromptText(promptText);
+    Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
+                callerPid,
+                requestId,
+                promptParams,
+                interactionServiceAddress);
+    if (interactionResult.code() == Result::Failed) {
+        return interactionResult;
+    }
+
+    m_pendingRequests.insert(requestId,
+                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                 callerPid,
+                                 requestId,
+                                 Daemon::ApiImpl::GetStandaloneSecretRequest,
+                                 QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                                << userInteractionMode
+                                                << interactionServiceAddress
+                                                << QVariant::fromValue<SecretMetadata>(secretMetadata)));
+    return Result(Result::Pending);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::getStandaloneSecretWithAuthenticationCode(
+        pid_t callerPid,
+        quint64 requestId,
+        const Secret::Identifier &identifier,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const SecretMetadata &secretMetadata,
+        const QByteArray &authenticationCode)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
+    // generate the encryption key from the authentication code
+    if (identifier.storagePluginName() == secretMetadata.encryptionPluginName
+            || secretMetadata.encryptionPluginName.isEmpty()) {
+        if (!m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+            // TODO: stale data in the database?
+            return Result(Result::InvalidExtensionPluginError,
+                          QStringLiteral("Unknown collection encrypted storage plugin: %1")
+                          .arg(identifier.storagePluginName()));
+        }
+    } else if (!m_encryptionPlugins.contains(secretMetadata.encryptionPluginName)) {
+        // TODO: stale data in the database?
+        return Result(Result::InvalidExtensionPluginError,
+                      QStringLiteral("Unknown collection encryption plugin: %1")
+                      .arg(secretMetadata.encryptionPluginName));
+    }
+
+    const auto completion = [=] (DerivedKeyResult dkr) {
+        if (dkr.result.code() != Result::Succeeded) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(dkr.result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        } else {
+            getStandaloneSecretWithEncryptionKey(
+                            callerPid, requestId, identifier,
+                            userInteractionMode, interactionServiceAddress,
+                            secretMetadata, dkr.key);
+        }
+    };
+    if (identifier.storagePluginName() == secretMetadata.encryptionPluginName
+            || secretMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(secretMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[secretMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
+
+    return Result(Result::Pending);
+}
+
+void
+Daemon::ApiImpl::RequestProcessor::getStandaloneSecretWithEncryptionKey(
+        pid_t callerPid,
+        quint64 requestId,
+        const Secret::Identifier &identifier,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const SecretMetadata &secretMetadata,
+        const QByteArray &encryptionKey)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    // may be needed for access control requests in the future.
+    Q_UNUSED(callerPid);
+    Q_UNUSED(requestId);
+    Q_UNUSED(userInteractionMode);
+    Q_UNUSED(interactionServiceAddress);
+
+    if (identifier.storagePluginName() == secretMetadata.encryptionPluginName
+            || secretMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::accessStandaloneSecret,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              identifier.name(),
+                              encryptionKey),
+                    [=] (SecretDataResult sdr) {
+            Secret outputSecret(identifier.name(), QStringLiteral("standalone"), identifier.storagePluginName());
+            outputSecret.setData(sdr.secretData);
+            outputSecret.setFilterData(sdr.secretFilterData);
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(sdr.result);
+            outParams << QVariant::fromValue<Secret>(outputSecret);
+            m_requestQueue->requestFinished(requestId, outParams);
+        });
+    } else {
+        const QString hashedSecretName = calculateSecretNameHash(
+                    Secret::Identifier(identifier.name(), QStringLiteral("standalone"), identifier.storagePluginName()));
+        if (!m_standaloneSecretEncryptionKeys.contains(hashedSecretName)) {
+            m_standaloneSecretEncryptionKeys.insert(hashedSecretName, encryptionKey);
+        }
+
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::getAndDecryptSecret,
+                              m_encryptionPlugins[secretMetadata.encryptionPluginName],
+                              m_storagePlugins[identifier.storagePluginName()],
+                              Secret::Identifier(identifier.name(), QStringLiteral("standalone"), identifier.storagePluginName()),
+                              m_standaloneSecretEncryptionKeys.value(hashedSecretName)),
+                    [=] (SecretResult sr) {
+            sr.secret.setCollectionName(QString());
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(sr.result);
+            outParams << QVariant::fromValue<Secret>(sr.secret);
+            m_requestQueue->requestFinished(requestId, outParams);
+        });
+    }
+}
+
+// find collection secrets via filter
+Result
+Daemon::ApiImpl::RequestProcessor::findCollectionSecrets(
+        pid_t callerPid,
+        quint64 requestId,
+        const QString &collectionName,
+        const QString &storagePluginName,
+        const Secret::FilterData &filter,
+        SecretManager::FilterOperator filterOperator,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        QVector<Secret::Identifier> *identifiers)
+{
+    Q_UNUSED(identifiers); // asynchronous out-param.
+    if (storagePluginName.isEmpty()) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QStringLiteral("Empty storage plugin name given"));
+    } else if (!m_encryptedStoragePlugins.contains(storagePluginName)
+               && !m_storagePlugins.contains(storagePluginName)) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QStringLiteral("Unknown storage plugin name given"));
+    } else if (collectionName.isEmpty()) {
+        return Result(Result::InvalidCollectionError,
+                      QLatin1String("Empty collection name given"));
+    } else if (collectionName.compare(QStringLiteral("standalone"), Qt::CaseInsensitive) == 0) {
+        return Result(Result::InvalidCollectionError,
+                      QLatin1String("Reserved collection name given"));
+    } else if (filter.isEmpty()) {
+        return Result(Result::InvalidFilterError,
+                      QLatin1String("Empty filter given"));
+    }
+
+    // Read the metadata about the target collection
+    const auto completion = [=] (CollectionMetadataResult cmr) {
+        Result result = cmr.result.code() != Result::Succeeded
+                ? cmr.result
+                : findCollectionSecretsWithMetadata(
+                      callerPid,
+                      requestId,
+                      collectionName,
+                      storagePluginName,
+                      filter,
+                      filterOperator,
+                      userInteractionMode,
+                      interactionServiceAddress,
+                      cmr.metadata);
+        if (result.code() != Result::Pending) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        }
+    };
+    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    }
+
+    return Result(Result::Pending);
+}
+
+Result
+Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithMetadata(
+        pid_t callerPid,
+        quint64 requestId,
+        const QString &collectionName,
+        const QString &storagePluginName,
+        const Secret::FilterData &filter,
+        SecretManager::FilterOperator filterOperator,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress,
+        const CollectionMetadata &collectionMetadata)
+{
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
+    // TODO: perform access control request to see if the application has permission to read secure storage data.
+    const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
+    const QString callerApplicationId = applicationIsPlatformApplication
+                ? m_appPermissions->platformApplicationId()
+                : m_appPermissions->applicationId(callerPid);
+
+    const QString authPluginName = determineAuthPlugin(
+                m_requestQueue->controller(),
+                collectionMetadata.ownerApplicationId,
+                callerApplicationId,
+                applicationIsPlatformApplication,
+                collectionMetadata.authenticationPluginName,
+                interactionServiceAddress,
+                m_autotestMode);
+
+    if (collectionMetadata.accessControlMode == SecretManager::SystemAccessControlMode) {
+        // TODO: perform access control request, to ask for permission to set the secret in the collection.
+        return Result(Result::OperationNotSupportedError,
+                      QLatin1String("Access control requests are not currently supported. TODO!"));
+    } else if (collectionMetadata.accessControlMode == SecretManager::OwnerOnlyMode
+               && collectionMetadata.ownerApplicationId != callerApplicationId) {
+        return Result(Result::PermissionsError,
+                      QString::fromLatin1("Collection %1 is owned by a different application")
+                      .arg(collectionName));
+    } else if (!m_authenticationPlugins.contains(authPluginName)) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QString::fromLatin1("No such authentication plugin available: %1")
+                      .arg(authPluginName));
+    }
+
+    Sailfish::Secrets::InteractionParameters::PromptText promptText({
+        //: This will be displayed to the user, prompting them to enter the lock code to unlock the collection in order to filter secrets within it. %1 is the application name, %2 is the collection name, %3 is the plugin name.
+        //% "%1 wants to search for secrets within collection %2 from plugin %3."
+        { InteractionParameters::Message, qtTrId("sailfish_secrets-find_collection_secrets-la-app_search")
+                         .arg(callerApplicationId,
+                              collectionName,
+                              m_requestQueue->controller()->displayNameForPlugin(storagePluginName)) },
+        //% "Enter the collection lock code to unlock the collection."
+        { InteractionParameters::Instruction, qtTrId("sailfish_secrets-la-enter_collection_lock_code") }
+    });
+
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        return withCollectionLockState(
+                    requestId,
+                    storagePluginName,
+                    collectionName,
+                    QVariantList(),
+                    [=] (bool locked) -> Result {
+            if (locked) {
+                if (collectionMetadata.usesDeviceLockKey) {
+                    // Perform a "verify" UI flow (if the user interaction mode allows).
+                    // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                    if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                        return Result(Result::CollectionIsLockedError,
+                                      QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                      .arg(collectionName));
+                    }
+
+                    // always use the system authentication plugin for device lock authentication requests.
+                    const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                            m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                           : SecretManager::DefaultAuthenticationPluginName);
+                    Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                                callerPid,
+                                requestId,
+                                promptText);
+                    if (result.code() == Result::Failed) {
+                        return result;
+                    }
+
+                    // calls findCollectionSecretsWithEncryptionKey when finished
+                    m_pendingRequests.insert(requestId,
+                                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                                 callerPid,
+                                                 requestId,
+                                                 Daemon::ApiImpl::FindCollectionSecretsRequest,
+                                                 QVariantList() << collectionName
+                                                                << storagePluginName
+                                                                << QVariant::fromValue<Secret::FilterData >(filter)
+                                                                << filterOperator
+                                                                << userInteractionMode
+                                                                << interactionServiceAddress
+                                                                << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                    return result;
+                } else {
+                    if (userInteractionMode == SecretManager::PreventInteraction) {
+                        return Result(Result::OperationRequiresUserInteraction,
+                                      QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                                      .arg(authPluginName));
+                    } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                        // TODO: stale data in metadata db?
+                        return Result(Result::InvalidExtensionPluginError,
+                                      QStringLiteral("Unknown authentication plugin for collection %1 in plugin %2")
+                                      . arg(collectionName, storagePluginName));
+                    } else if (m_authenticationPlugins[authPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
+                                && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
+                        return Result(Result::OperationRequiresApplicationUserInteraction,
+                                      QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
+                                      .arg(authPluginName));
+                    }
+
+                    // perform the user input flow required to get the input key data which will be used
+                    // to unlock the collection.
+                    InteractionParameters promptParams;
+                    promptParams.setApplicationId(callerApplicationId);
+                    promptParams.setPluginName(storagePluginName);
+                    promptParams.setCollectionName(collectionName);
+                    promptParams.setSecretName(QString());
+                    promptParams.setOperation(InteractionParameters::UnlockCollection);
+                    promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+                    promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+                    promptParams.setPromptText(promptText);
+                    Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
+                                callerPid,
+                                requestId,
+                                promptParams,
+                                interactionServiceAddress);
+                    if (interactionResult.code() == Result::Failed) {
+                        return interactionResult;
+                    }
+
+                    m_pendingRequests.insert(requestId,
+                                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                                 callerPid,
+                                                 requestId,
+                                                 Daemon::ApiImpl::FindCollectionSecretsRequest,
+                                                 QVariantList() << collectionName
+                                                                << storagePluginName
+                                                                << QVariant::fromValue<Secret::FilterData >(filter)
+                                                                << filterOperator
+                                                                << userInteractionMode
+                                                                << interactionServiceAddress
+                                                                << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                    return Result(Result::Pending);
+                }
+            } else {
+                findCollectionSecretsWithEncryptionKey(
+                            callerPid,
+                            requestId,
+                            collectionName,
+                            storagePluginName,
+                            filter,
+                            filterOperator,
+                            userInteractionMode,
+                            interactionServiceAddress,
+                            collectionMetadata,
+                            QByteArray()); // no key required, it's unlocked already.
+                return Result(Result::Pending);
+            }
+        });
+    } else {
+        const QString hashedCollectionName = calculateSecretNameHash(
+                    Secret::Identifier(QString(), collectionName, storagePluginName));
+        if (!m_collectionEncryptionKeys.contains(hashedCollectionName)) {
+            if (collectionMetadata.usesDeviceLockKey) {
+                // Perform a "verify" UI flow (if the user interaction mode allows).
+                // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                    return Result(Result::CollectionIsLockedError,
+                                  QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                  .arg(collectionName));
+                }
+
+                // always use the system authentication plugin for device lock authentication requests.
+                const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                        m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                       : SecretManager::DefaultAuthenticationPluginName);
+                Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                            callerPid,
+                            requestId,
+                            promptText);
+                if (result.code() == Result::Failed) {
+                    return result;
+                }
+
+                // calls findCollectionSecretsWithEncryptionKey when finished
+                m_pendingRequests.insert(requestId,
+                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                             callerPid,
+                                             requestId,
+                                             Daemon::ApiImpl::FindCollectionSecretsRequest,
+                                             QVariantList() << collectionName
+                                                            << storagePluginName
+                                                            << QVariant::fromValue<Secret::FilterData >(filter)
+                                                            << filterOperator
+                                                            << userInteractionMode
+                                                            << interactionServiceAddress
+                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                return result;
+            } else {
+                if (userInteractionMode == SecretManager::PreventInteraction) {
+                    return Result(Result::OperationRequiresUserInteraction,
+                                  QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                                  .arg(authPluginName));
+                } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                    // TODO: stale data in metadata db?
+                    return Result(Result::InvalidExtensionPluginError,
+                                  QString::fromLatin1("Unknown authentication plugin %1 specified in collection metadata")
+                                  .arg(authPluginName));
+                } else if (m_authenticationPlugins[authPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
+                           && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
+                    return Result(Result::OperationRequiresApplicationUserInteraction,
+                                  QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
+                                  .arg(authPluginName));
+                }
+
+                // perform the user input flow required to get the input key data which will be used
+                // to decrypt the secret.
+                InteractionParameters promptParams;
+                promptParams.setApplicationId(callerApplicationId);
+                promptParams.setPluginName(storagePluginName);
+                promptParams.setCollectionName(collectionName);
+                promptParams.setSecretName(QString());
+                promptParams.setOperation(InteractionParameters::UnlockCollection);
+                promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+                promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+                promptParams.setPromptText(promptText);
+                Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
+                            callerPid,
+                            requestId,
+                            promptParams,
+                            interactionServiceAddress);
+                if (interactionResult.code() == Result::Failed) {
+                    return interactionResult;
+                }
+
+                m_pendingRequests.insert(requestId,
+                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                             callerPid,
+                                             requestId,
+                                             Daemon::ApiImpl::FindCollectionSecretsRequest,
+                                             QVariantList() << collectionName
+                                                            << storagePluginName
+                                                            << QVariant::fromValue<Secret::FilterData >(filter)
+                                                            << filterOperator
+                                                            << userInteractionMode
+                                                            << interactionServiceAddress
+                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                return Result(Result::Pending);
+            }
+        } else {
+            findCollectionSecretsWithEncryptionKey(
+                        callerPid,
+                        requestId,
+                        collectionName,
+                        storagePluginName,
+                        filter,
+                        filterOperator,
+                        userInteractionMode,
+                        interactionServiceAddress,
+                        collectionMetadata,
+                        m_collectionEncryptionKeys.value(hashedCollectionName));
+            return Result(Result::Pending);
+        }
     }
-
-    m_pendingRequests.insert(requestId,
-                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                 callerPid,
-                                 requestId,
-                                 Daemon::ApiImpl::GetStandaloneSecretRequest,
-                                 QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
-                                                << userInteractionMode
-                                                << interactionServiceAddress
-                                                << QVariant::fromValue<SecretMetadata>(secretMetadata)));
-    return Result(Result::Pending);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::getStandaloneSecretWithAuthenticationCode(
+Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithAuthenticationCode(
         pid_t callerPid,
         quint64 requestId,
-        const Secret::Identifier &identifier,
+        const QString &collectionName,
+        const QString &storagePluginName,
+        const Secret::FilterData &filter,
+        SecretManager::FilterOperator filterOperator,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
-        const SecretMetadata &secretMetadata,
+        const CollectionMetadata &collectionMetadata,
         const QByteArray &authenticationCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // generate the encryption key from the authentication code
-    if (identifier.storagePluginName() == secretMetadata.encryptionPluginName
-            || secretMetadata.encryptionPluginName.isEmpty()) {
-        if (!m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
-            // TODO: stale data in the database?
-            return Result(Result::InvalidExtensionPluginError,
-                          QStringLiteral("Unknown collection encrypted storage plugin: %1")
-                          .arg(identifier.storagePluginName()));
-        }
-    } else if (!m_encryptionPlugins.contains(secretMetadata.encryptionPluginName)) {
+    if (!collectionMetadata.encryptionPluginName.isEmpty()
+            && storagePluginName != collectionMetadata.encryptionPluginName
+            && !m_encryptionPlugins.contains(collectionMetadata.encryptionPluginName)) {
         // TODO: stale data in the database?
         return Result(Result::InvalidExtensionPluginError,
                       QStringLiteral("Unknown collection encryption plugin: %1")
-                      .arg(secretMetadata.encryptionPluginName));
-    }
-
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (identifier.storagePluginName() == secretMetadata.encryptionPluginName
-            || secretMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[secretMetadata.encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
+                      .arg(collectionMetadata.encryptionPluginName));
     }
 
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
             m_requestQueue->requestFinished(requestId, outParams);
         } else {
-            getStandaloneSecretWithEncryptionKey(
-                            callerPid, requestId, identifier,
-                            userInteractionMode, interactionServiceAddress,
-                            secretMetadata, dkr.key);
+            findCollectionSecretsWithEncryptionKey(
+                        callerPid, requestId,
+                        collectionName, storagePluginName,
+                        filter, filterOperator,
+                        userInteractionMode, interactionServiceAddress,
+                        collectionMetadata, dkr.key);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
 
 void
-Daemon::ApiImpl::RequestProcessor::getStandaloneSecretWithEncryptionKey(
+Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithEncryptionKey(
         pid_t callerPid,
         quint64 requestId,
-        const Secret::Identifier &identifier,
+        const QString &collectionName,
+        const QString &storagePluginName,
+        const Secret::FilterData &filter,
+        SecretManager::FilterOperator filterOperator,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
-        const SecretMetadata &secretMetadata,
+        const CollectionMetadata &collectionMetadata,
         const QByteArray &encryptionKey)
 {
-    // may be needed for access control requests in the future.
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    // might be required in future for access control requests.
     Q_UNUSED(callerPid);
     Q_UNUSED(requestId);
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
 
-    if (identifier.storagePluginName() == secretMetadata.encryptionPluginName
-            || secretMetadata.encryptionPluginName.isEmpty()) {
-        QFutureWatcher<SecretDataResult> *watcher
-                = new QFutureWatcher<SecretDataResult>(this);
-        QFuture<SecretDataResult> future
-                = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::accessStandaloneSecret,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    identifier.name(),
-                    encryptionKey);
-        connect(watcher, &QFutureWatcher<SecretDataResult>::finished, [=] {
-            watcher->deleteLater();
-            SecretDataResult sdr = watcher->future().result();
-            Secret outputSecret(identifier.name(), QStringLiteral("standalone"), identifier.storagePluginName());
-            outputSecret.setData(sdr.secretData);
-            outputSecret.setFilterData(sdr.secretFilterData);
-            QVariantList outParams;
-            outParams << QVariant::fromValue<Result>(sdr.result);
-            outParams << QVariant::fromValue<Secret>(outputSecret);
-            m_requestQueue->requestFinished(requestId, outParams);
-        });
-        watcher->setFuture(future);
+    const auto completion = [=] (IdentifiersResult ir) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(ir.result);
+        outParams << QVariant::fromValue<QVector<Secret::Identifier> >(ir.identifiers);
+        m_requestQueue->requestFinished(requestId, outParams);
+    };
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::unlockAndFindSecrets,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              collectionMetadata,
+                              filter,
+                              static_cast<StoragePlugin::FilterOperator>(filterOperator),
+                              encryptionKey),
+                    completion);
     } else {
-        const QString hashedSecretName = calculateSecretNameHash(
-                    Secret::Identifier(identifier.name(), QStringLiteral("standalone"), identifier.storagePluginName()));
-        if (!m_standaloneSecretEncryptionKeys.contains(hashedSecretName)) {
-            m_standaloneSecretEncryptionKeys.insert(hashedSecretName, encryptionKey);
+        bool requiresRelock =
+                ((!collectionMetadata.usesDeviceLockKey
+                  && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
+                || (collectionMetadata.usesDeviceLockKey
+                  && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
+        const QString hashedCollectionName = calculateSecretNameHash(Secret::Identifier(QString(), collectionName, storagePluginName));
+        if (!m_collectionEncryptionKeys.contains(hashedCollectionName) && !requiresRelock) {
+            // TODO: some way to "test" the encryptionKey!  also, if it's a custom lock, set the timeout, etc.
+            m_collectionEncryptionKeys.insert(hashedCollectionName, encryptionKey);
         }
 
-        QFutureWatcher<SecretResult> *watcher
-                = new QFutureWatcher<SecretResult>(this);
-        QFuture<SecretResult>
-        future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                StoragePluginFunctionWrapper::getAndDecryptSecret,
-                m_encryptionPlugins[secretMetadata.encryptionPluginName],
-                m_storagePlugins[identifier.storagePluginName()],
-                Secret::Identifier(identifier.name(), QStringLiteral("standalone"), identifier.storagePluginName()),
-                m_standaloneSecretEncryptionKeys.value(hashedSecretName));
-
-        connect(watcher, &QFutureWatcher<SecretResult>::finished, [=] {
-            watcher->deleteLater();
-            SecretResult sr = watcher->future().result();
-            sr.secret.setCollectionName(QString());
-            QVariantList outParams;
-            outParams << QVariant::fromValue<Result>(sr.result);
-            outParams << QVariant::fromValue<Secret>(sr.secret);
-            m_requestQueue->requestFinished(requestId, outParams);
-        });
-        watcher->setFuture(future);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::findSecrets,
+                              m_storagePlugins[storagePluginName],
+                              collectionName,
+                              filter,
+                              static_cast<StoragePlugin::FilterOperator>(filterOperator)),
+                    completion);
     }
 }
 
-// find collection secrets via filter
+// find standalone secrets via filter
 Result
-Daemon::ApiImpl::RequestProcessor::findCollectionSecrets(
+Daemon::ApiImpl::RequestProcessor::findStandaloneSecrets(
         pid_t callerPid,
         quint64 requestId,
-        const QString &collectionName,
         const QString &storagePluginName,
         const Secret::FilterData &filter,
         SecretManager::FilterOperator filterOperator,
@@ -3270,55 +4770,54 @@ Daemon::ApiImpl::RequestProcessor::findCollectionSecrets(
         const QString &interactionServiceAddress,
         QVector<Secret::Identifier> *identifiers)
 {
-    Q_UNUSED(identifiers); // asynchronous out-param.
-    if (storagePluginName.isEmpty()) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QStringLiteral("Empty storage plugin name given"));
-    } else if (!m_encryptedStoragePlugins.contains(storagePluginName)
-               && !m_storagePlugins.contains(storagePluginName)) {
-        return Result(Result::InvalidExtensionPluginError,
-                      QStringLiteral("Unknown storage plugin name given"));
-    } else if (collectionName.isEmpty()) {
+    // TODO!
+    Q_UNUSED(callerPid)
+    Q_UNUSED(requestId)
+    Q_UNUSED(storagePluginName)
+    Q_UNUSED(filter)
+    Q_UNUSED(filterOperator)
+    Q_UNUSED(userInteractionMode)
+    Q_UNUSED(interactionServiceAddress)
+    Q_UNUSED(identifiers)
+    return Result(Result::OperationNotSupportedError,
+                  QLatin1String("Filtering standalone secrets is not yet supported!"));
+}
+
+// delete a secret in a collection
+Result
+Daemon::ApiImpl::RequestProcessor::deleteCollectionSecret(
+        pid_t callerPid,
+        quint64 requestId,
+        const Secret::Identifier &identifier,
+        SecretManager::UserInteractionMode userInteractionMode,
+        const QString &interactionServiceAddress)
+{
+    if (identifier.name().isEmpty()) {
+        return Result(Result::InvalidSecretError,
+                      QLatin1String("Empty secret name given"));
+    } else if (identifier.collectionName().isEmpty()) {
         return Result(Result::InvalidCollectionError,
                       QLatin1String("Empty collection name given"));
-    } else if (collectionName.compare(QStringLiteral("standalone"), Qt::CaseInsensitive) == 0) {
+    } else if (identifier.collectionName().compare(QStringLiteral("standalone"), Qt::CaseInsensitive) == 0) {
         return Result(Result::InvalidCollectionError,
                       QLatin1String("Reserved collection name given"));
-    } else if (filter.isEmpty()) {
-        return Result(Result::InvalidFilterError,
-                      QLatin1String("Empty filter given"));
+    } else if (identifier.storagePluginName().isEmpty()) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QLatin1String("Empty storage plugin name given"));
+    } else if (!m_encryptedStoragePlugins.contains(identifier.storagePluginName())
+               && !m_storagePlugins.contains(identifier.storagePluginName())) {
+        return Result(Result::InvalidExtensionPluginError,
+                      QLatin1String("Unknown storage plugin name given"));
     }
 
     // Read the metadata about the target collection
-    QFutureWatcher<CollectionMetadataResult> *watcher
-            = new QFutureWatcher<CollectionMetadataResult>(this);
-    QFuture<CollectionMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionMetadata,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    collectionName);
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionMetadata,
-                    m_storagePlugins[storagePluginName],
-                    collectionName);
-    }
-
-    connect(watcher, &QFutureWatcher<CollectionMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        CollectionMetadataResult cmr = watcher->future().result();
+    const auto completion = [=] (CollectionMetadataResult cmr) {
         Result result = cmr.result.code() != Result::Succeeded
                 ? cmr.result
-                : findCollectionSecretsWithMetadata(
+                : deleteCollectionSecretWithMetadata(
                       callerPid,
                       requestId,
-                      collectionName,
-                      storagePluginName,
-                      filter,
-                      filterOperator,
+                      identifier,
                       userInteractionMode,
                       interactionServiceAddress,
                       cmr.metadata);
@@ -3327,25 +4826,40 @@ Daemon::ApiImpl::RequestProcessor::findCollectionSecrets(
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithMetadata(
+Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithMetadata(
         pid_t callerPid,
         quint64 requestId,
-        const QString &collectionName,
-        const QString &storagePluginName,
-        const Secret::FilterData &filter,
-        SecretManager::FilterOperator filterOperator,
+        const Secret::Identifier &identifier,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata)
 {
-    // TODO: perform access control request to see if the application has permission to read secure storage data.
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
+    // TODO: perform access control request to see if the application has permission to write secure storage data.
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
                 ? m_appPermissions->platformApplicationId()
@@ -3368,102 +4882,87 @@ Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithMetadata(
                && collectionMetadata.ownerApplicationId != callerApplicationId) {
         return Result(Result::PermissionsError,
                       QString::fromLatin1("Collection %1 is owned by a different application")
-                      .arg(collectionName));
-    } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                      .arg(identifier.collectionName()));
+    } else if (!collectionMetadata.encryptionPluginName.isEmpty()
+               && identifier.storagePluginName() != collectionMetadata.encryptionPluginName
+               && !m_encryptionPlugins.contains(collectionMetadata.encryptionPluginName)) {
+        // TODO: this means we have "stale" data in the database; what should we do in this case?
         return Result(Result::InvalidExtensionPluginError,
-                      QString::fromLatin1("No such authentication plugin available: %1")
-                      .arg(authPluginName));
-    }
-
-    Sailfish::Secrets::InteractionParameters::PromptText promptText({
-        //: This will be displayed to the user, prompting them to enter the lock code to unlock the collection in order to filter secrets within it. %1 is the application name, %2 is the collection name, %3 is the plugin name.
-        //% "%1 wants to search for secrets within collection %2 from plugin %3."
-        { InteractionParameters::Message, qtTrId("sailfish_secrets-find_collection_secrets-la-app_search")
-                         .arg(callerApplicationId,
-                              collectionName,
-                              m_requestQueue->controller()->displayNameForPlugin(storagePluginName)) },
+                      QString::fromLatin1("No such encryption plugin exists: %1")
+                      .arg(collectionMetadata.encryptionPluginName));
+    }
+
+    Sailfish::Secrets::InteractionParameters::PromptText promptText({
+        //: This will be displayed to the user, prompting them to enter the lock code to unlock the collection in order to delete a secret within it. %1 is the application name, %2 is the secret name, %3 is the collection name, %4 is the plugin name.
+        //% "%1 wants to delete secret %2 within collection %3 in plugin %4."
+        { InteractionParameters::Message, qtTrId("sailfish_secrets-delete_collection_secret-la-message")
+                    .arg(callerApplicationId,
+                            identifier.name(),
+                            identifier.collectionName(),
+                            m_requestQueue->controller()->displayNameForPlugin(identifier.storagePluginName())) },
         //% "Enter the collection lock code to unlock the collection."
         { InteractionParameters::Instruction, qtTrId("sailfish_secrets-la-enter_collection_lock_code") }
     });
 
-    if (storagePluginName == collectionMetadata.encryptionPluginName
+    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
-        // TODO: make this asynchronous instead of blocking the main thread!
-        QFuture<LockedResult> future
-                = QtConcurrent::run(
-                        m_requestQueue->secretsThreadPool().data(),
-                        EncryptedStoragePluginFunctionWrapper::isCollectionLocked,
-                        m_encryptedStoragePlugins[storagePluginName],
-                        collectionName);
-        future.waitForFinished();
-        LockedResult lr = future.result();
-        Result pluginResult = lr.result;
-        bool locked = lr.locked;
-        if (pluginResult.code() != Result::Succeeded) {
-            return pluginResult;
-        }
+        return withCollectionLockState(
+                    requestId,
+                    identifier.storagePluginName(),
+                    identifier.collectionName(),
+                    QVariantList(),
+                    [=] (bool locked) -> Result {
+            if (locked) {
+                if (collectionMetadata.usesDeviceLockKey) {
+                    // Perform a "verify" UI flow (if the user interaction mode allows).
+                    // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                    if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                        return Result(Result::CollectionIsLockedError,
+                                      QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                      .arg(identifier.collectionName()));
+                    }
 
-        if (locked) {
-            if (collectionMetadata.usesDeviceLockKey) {
-                // Perform a "verify" UI flow (if the user interaction mode allows).
-                // If that succeeds, unlock the collection with the stored devicelock key and continue.
-                if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
-                    return Result(Result::CollectionIsLockedError,
-                                  QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                                  .arg(collectionName));
-                }
+                    // always use the system authentication plugin for device lock authentication requests.
+                    const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                            m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                           : SecretManager::DefaultAuthenticationPluginName);
+                    Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                                callerPid,
+                                requestId,
+                                promptText);
+                    if (result.code() == Result::Failed) {
+                        return result;
+                    }
 
-                // always use the system authentication plugin for device lock authentication requests.
-                const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
-                        m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                                       : SecretManager::DefaultAuthenticationPluginName);
-                Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
-                            callerPid,
-                            requestId,
-                            promptText);
-                if (result.code() == Result::Failed) {
+                    // calls deleteCollectionSecretWithEncryptionKey when finished
+                    m_pendingRequests.insert(requestId,
+                                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                                 callerPid,
+                                                 requestId,
+                                                 Daemon::ApiImpl::DeleteCollectionSecretRequest,
+                                                 QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                                                << userInteractionMode
+                                                                << interactionServiceAddress
+                                                                << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
                     return result;
-                }
-
-                // calls findCollectionSecretsWithEncryptionKey when finished
-                m_pendingRequests.insert(requestId,
-                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                             callerPid,
-                                             requestId,
-                                             Daemon::ApiImpl::FindCollectionSecretsRequest,
-                                             QVariantList() << collectionName
-                                                            << storagePluginName
-                                                            << QVariant::fromValue<Secret::FilterData >(filter)
-                                                            << filterOperator
-                                                            << userInteractionMode
-                                                            << interactionServiceAddress
-                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-                return result;
-            } else {
-                if (userInteractionMode == SecretManager::PreventInteraction) {
-                    return Result(Result::OperationRequiresUserInteraction,
-                                  QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                                  .arg(authPluginName));
                 } else if (!m_authenticationPlugins.contains(authPluginName)) {
                     // TODO: stale data in metadata db?
                     return Result(Result::InvalidExtensionPluginError,
-                                  QStringLiteral("Unknown authentication plugin for collection %1 in plugin %2")
-                                  . arg(collectionName, storagePluginName));
-                } else if (m_authenticationPlugins[authPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
-                            && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
-                    return Result(Result::OperationRequiresApplicationUserInteraction,
-                                  QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
+                                  QStringLiteral("Unknown collection authentication plugin"));
+                } else if (userInteractionMode == SecretManager::PreventInteraction) {
+                    return Result(Result::OperationRequiresUserInteraction,
+                                  QString::fromLatin1("Authentication plugin %1 requires user interaction")
                                   .arg(authPluginName));
                 }
 
                 // perform the user input flow required to get the input key data which will be used
-                // to unlock the collection.
+                // to unlock the collection in order to delete the secret.
                 InteractionParameters promptParams;
                 promptParams.setApplicationId(callerApplicationId);
-                promptParams.setPluginName(storagePluginName);
-                promptParams.setCollectionName(collectionName);
-                promptParams.setSecretName(QString());
-                promptParams.setOperation(InteractionParameters::UnlockCollection);
+                promptParams.setPluginName(identifier.storagePluginName());
+                promptParams.setCollectionName(identifier.collectionName());
+                promptParams.setSecretName(identifier.name());
+                promptParams.setOperation(InteractionParameters::DeleteSecret);
                 promptParams.setInputType(InteractionParameters::AlphaNumericInput);
                 promptParams.setEchoMode(InteractionParameters::PasswordEcho);
                 promptParams.setPromptText(promptText);
@@ -3480,33 +4979,27 @@ Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithMetadata(
                                          Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                              callerPid,
                                              requestId,
-                                             Daemon::ApiImpl::FindCollectionSecretsRequest,
-                                             QVariantList() << collectionName
-                                                            << storagePluginName
-                                                            << QVariant::fromValue<Secret::FilterData >(filter)
-                                                            << filterOperator
+                                             Daemon::ApiImpl::DeleteCollectionSecretRequest,
+                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
                                                             << userInteractionMode
                                                             << interactionServiceAddress
                                                             << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-                return Result(Result::Pending);
+            } else {
+                deleteCollectionSecretWithEncryptionKey(
+                            callerPid,
+                            requestId,
+                            identifier,
+                            userInteractionMode,
+                            interactionServiceAddress,
+                            collectionMetadata,
+                            m_requestQueue->deviceLockKey());
             }
-        } else {
-            findCollectionSecretsWithEncryptionKey(
-                        callerPid,
-                        requestId,
-                        collectionName,
-                        storagePluginName,
-                        filter,
-                        filterOperator,
-                        userInteractionMode,
-                        interactionServiceAddress,
-                        collectionMetadata,
-                        QByteArray()); // no key required, it's unlocked already.
+
             return Result(Result::Pending);
-        }
+        });
     } else {
         const QString hashedCollectionName = calculateSecretNameHash(
-                    Secret::Identifier(QString(), collectionName, storagePluginName));
+                    Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
         if (!m_collectionEncryptionKeys.contains(hashedCollectionName)) {
             if (collectionMetadata.usesDeviceLockKey) {
                 // Perform a "verify" UI flow (if the user interaction mode allows).
@@ -3514,7 +5007,7 @@ Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithMetadata(
                 if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
                     return Result(Result::CollectionIsLockedError,
                                   QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                                  .arg(collectionName));
+                                  .arg(identifier.collectionName()));
                 }
 
                 // always use the system authentication plugin for device lock authentication requests.
@@ -3529,16 +5022,13 @@ Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithMetadata(
                     return result;
                 }
 
-                // calls findCollectionSecretsWithEncryptionKey when finished
+                // calls deleteCollectionSecretWithEncryptionKey when finished
                 m_pendingRequests.insert(requestId,
                                          Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                              callerPid,
                                              requestId,
-                                             Daemon::ApiImpl::FindCollectionSecretsRequest,
-                                             QVariantList() << collectionName
-                                                            << storagePluginName
-                                                            << QVariant::fromValue<Secret::FilterData >(filter)
-                                                            << filterOperator
+                                             Daemon::ApiImpl::DeleteCollectionSecretRequest,
+                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
                                                             << userInteractionMode
                                                             << interactionServiceAddress
                                                             << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
@@ -3549,25 +5039,19 @@ Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithMetadata(
                                   QString::fromLatin1("Authentication plugin %1 requires user interaction")
                                   .arg(authPluginName));
                 } else if (!m_authenticationPlugins.contains(authPluginName)) {
-                    // TODO: stale data in metadata db?
+                    // TODO: stale metadata db data?
                     return Result(Result::InvalidExtensionPluginError,
-                                  QString::fromLatin1("Unknown authentication plugin %1 specified in collection metadata")
-                                  .arg(authPluginName));
-                } else if (m_authenticationPlugins[authPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
-                           && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
-                    return Result(Result::OperationRequiresApplicationUserInteraction,
-                                  QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
-                                  .arg(authPluginName));
+                                  QStringLiteral("Unknown collection authentication plugin"));
                 }
 
                 // perform the user input flow required to get the input key data which will be used
-                // to decrypt the secret.
+                // to unlock the secret for deletion.
                 InteractionParameters promptParams;
                 promptParams.setApplicationId(callerApplicationId);
-                promptParams.setPluginName(storagePluginName);
-                promptParams.setCollectionName(collectionName);
-                promptParams.setSecretName(QString());
-                promptParams.setOperation(InteractionParameters::UnlockCollection);
+                promptParams.setPluginName(identifier.storagePluginName());
+                promptParams.setCollectionName(identifier.collectionName());
+                promptParams.setSecretName(identifier.name());
+                promptParams.setOperation(InteractionParameters::DeleteSecret);
                 promptParams.setInputType(InteractionParameters::AlphaNumericInput);
                 promptParams.setEchoMode(InteractionParameters::PasswordEcho);
                 promptParams.setPromptText(promptText);
@@ -3584,49 +5068,44 @@ Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithMetadata(
                                          Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                              callerPid,
                                              requestId,
-                                             Daemon::ApiImpl::FindCollectionSecretsRequest,
-                                             QVariantList() << collectionName
-                                                            << storagePluginName
-                                                            << QVariant::fromValue<Secret::FilterData >(filter)
-                                                            << filterOperator
+                                             Daemon::ApiImpl::DeleteCollectionSecretRequest,
+                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
                                                             << userInteractionMode
                                                             << interactionServiceAddress
                                                             << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-                return Result(Result::Pending);
             }
         } else {
-            findCollectionSecretsWithEncryptionKey(
+            deleteCollectionSecretWithEncryptionKey(
                         callerPid,
                         requestId,
-                        collectionName,
-                        storagePluginName,
-                        filter,
-                        filterOperator,
+                        identifier,
                         userInteractionMode,
                         interactionServiceAddress,
                         collectionMetadata,
                         m_collectionEncryptionKeys.value(hashedCollectionName));
-            return Result(Result::Pending);
         }
     }
+
+    return Result(Result::Pending);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithAuthenticationCode(
+Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithAuthenticationCode(
         pid_t callerPid,
         quint64 requestId,
-        const QString &collectionName,
-        const QString &storagePluginName,
-        const Secret::FilterData &filter,
-        SecretManager::FilterOperator filterOperator,
+        const Secret::Identifier &identifier,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata,
         const QByteArray &authenticationCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // generate the encryption key from the authentication code
     if (!collectionMetadata.encryptionPluginName.isEmpty()
-            && storagePluginName != collectionMetadata.encryptionPluginName
+            && collectionMetadata.encryptionPluginName != identifier.storagePluginName()
             && !m_encryptionPlugins.contains(collectionMetadata.encryptionPluginName)) {
         // TODO: stale data in the database?
         return Result(Result::InvalidExtensionPluginError,
@@ -3634,116 +5113,106 @@ Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithAuthenticationCode(
                       .arg(collectionMetadata.encryptionPluginName));
     }
 
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (storagePluginName == collectionMetadata.encryptionPluginName
-            || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[collectionMetadata.encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    }
-
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
             m_requestQueue->requestFinished(requestId, outParams);
         } else {
-            findCollectionSecretsWithEncryptionKey(
-                        callerPid, requestId,
-                        collectionName, storagePluginName,
-                        filter, filterOperator,
-                        userInteractionMode, interactionServiceAddress,
-                        collectionMetadata, dkr.key);
+            deleteCollectionSecretWithEncryptionKey(
+                            callerPid, requestId, identifier,
+                            userInteractionMode, interactionServiceAddress,
+                            collectionMetadata, dkr.key);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
 
 void
-Daemon::ApiImpl::RequestProcessor::findCollectionSecretsWithEncryptionKey(
+Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithEncryptionKey(
         pid_t callerPid,
         quint64 requestId,
-        const QString &collectionName,
-        const QString &storagePluginName,
-        const Secret::FilterData &filter,
-        SecretManager::FilterOperator filterOperator,
+        const Secret::Identifier &identifier,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata,
         const QByteArray &encryptionKey)
 {
-    // might be required in future for access control requests.
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    // may be needed for access control requests in the future.
     Q_UNUSED(callerPid);
     Q_UNUSED(requestId);
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
 
-    QFutureWatcher<IdentifiersResult> *watcher
-            = new QFutureWatcher<IdentifiersResult>(this);
-    QFuture<IdentifiersResult> future;
-    if (storagePluginName == collectionMetadata.encryptionPluginName
+    const auto completion = [=] (Result pluginResult) {
+        m_requestQueue->storedKeyCache()->invalidate(identifier);
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(pluginResult);
+        m_requestQueue->requestFinished(requestId, outParams);
+    };
+    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::unlockAndFindSecrets,
-                    m_encryptedStoragePlugins[storagePluginName],
-                    collectionMetadata,
-                    filter,
-                    static_cast<StoragePlugin::FilterOperator>(filterOperator),
-                    encryptionKey);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::unlockCollectionAndRemoveSecret,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              collectionMetadata,
+                              identifier,
+                              encryptionKey),
+                    completion);
     } else {
         bool requiresRelock =
                 ((!collectionMetadata.usesDeviceLockKey
                   && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
                 || (collectionMetadata.usesDeviceLockKey
                   && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
-        const QString hashedCollectionName = calculateSecretNameHash(Secret::Identifier(QString(), collectionName, storagePluginName));
+        const QString hashedCollectionName = calculateSecretNameHash(
+                    Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
         if (!m_collectionEncryptionKeys.contains(hashedCollectionName) && !requiresRelock) {
             // TODO: some way to "test" the encryptionKey!  also, if it's a custom lock, set the timeout, etc.
+            // FIXME: in this case, if the user entered the "wrong" password, we will be caching an incorrect key...
             m_collectionEncryptionKeys.insert(hashedCollectionName, encryptionKey);
         }
 
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::findSecrets,
-                    m_storagePlugins[storagePluginName],
-                    collectionName,
-                    filter,
-                    static_cast<StoragePlugin::FilterOperator>(filterOperator));
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::removeSecret,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier.collectionName(),
+                              identifier.name()),
+                    completion);
     }
-
-    connect(watcher, &QFutureWatcher<IdentifiersResult>::finished, [=] {
-        watcher->deleteLater();
-        IdentifiersResult ir = watcher->future().result();
-        QVariantList outParams;
-        outParams << QVariant::fromValue<Result>(ir.result);
-        outParams << QVariant::fromValue<QVector<Secret::Identifier> >(ir.identifiers);
-        m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
 }
 
-// find standalone secrets via filter
+// delete the secrets in a collection which match a filter
 Result
-Daemon::ApiImpl::RequestProcessor::findStandaloneSecrets(
+Daemon::ApiImpl::RequestProcessor::deleteCollectionSecrets(
         pid_t callerPid,
         quint64 requestId,
+        const QString &collectionName,
         const QString &storagePluginName,
         const Secret::FilterData &filter,
         SecretManager::FilterOperator filterOperator,
@@ -3751,73 +5220,36 @@ Daemon::ApiImpl::RequestProcessor::findStandaloneSecrets(
         const QString &interactionServiceAddress,
         QVector<Secret::Identifier> *identifiers)
 {
-    // TODO!
-    Q_UNUSED(callerPid)
-    Q_UNUSED(requestId)
-    Q_UNUSED(storagePluginName)
-    Q_UNUSED(filter)
-    Q_UNUSED(filterOperator)
-    Q_UNUSED(userInteractionMode)
-    Q_UNUSED(interactionServiceAddress)
-    Q_UNUSED(identifiers)
-    return Result(Result::OperationNotSupportedError,
-                  QLatin1String("Filtering standalone secrets is not yet supported!"));
-}
-
-// delete a secret in a collection
-Result
-Daemon::ApiImpl::RequestProcessor::deleteCollectionSecret(
-        pid_t callerPid,
-        quint64 requestId,
-        const Secret::Identifier &identifier,
-        SecretManager::UserInteractionMode userInteractionMode,
-        const QString &interactionServiceAddress)
-{
-    if (identifier.name().isEmpty()) {
-        return Result(Result::InvalidSecretError,
-                      QLatin1String("Empty secret name given"));
-    } else if (identifier.collectionName().isEmpty()) {
-        return Result(Result::InvalidCollectionError,
-                      QLatin1String("Empty collection name given"));
-    } else if (identifier.collectionName().compare(QStringLiteral("standalone"), Qt::CaseInsensitive) == 0) {
-        return Result(Result::InvalidCollectionError,
-                      QLatin1String("Reserved collection name given"));
-    } else if (identifier.storagePluginName().isEmpty()) {
+    Q_UNUSED(identifiers); // asynchronous out-param.
+    if (storagePluginName.isEmpty()) {
         return Result(Result::InvalidExtensionPluginError,
-                      QLatin1String("Empty storage plugin name given"));
-    } else if (!m_encryptedStoragePlugins.contains(identifier.storagePluginName())
-               && !m_storagePlugins.contains(identifier.storagePluginName())) {
+                      QStringLiteral("Empty storage plugin name given"));
+    } else if (!m_encryptedStoragePlugins.contains(storagePluginName)
+               && !m_storagePlugins.contains(storagePluginName)) {
         return Result(Result::InvalidExtensionPluginError,
-                      QLatin1String("Unknown storage plugin name given"));
+                      QStringLiteral("Unknown storage plugin name given"));
+    } else if (collectionName.isEmpty()) {
+        return Result(Result::InvalidCollectionError,
+                      QLatin1String("Empty collection name given"));
+    } else if (collectionName.compare(QStringLiteral("standalone"), Qt::CaseInsensitive) == 0) {
+        return Result(Result::InvalidCollectionError,
+                      QLatin1String("Reserved collection name given"));
+    } else if (filter.isEmpty()) {
+        return Result(Result::InvalidFilterError,
+                      QLatin1String("Empty filter given"));
     }
 
     // Read the metadata about the target collection
-    QFutureWatcher<CollectionMetadataResult> *watcher
-            = new QFutureWatcher<CollectionMetadataResult>(this);
-    QFuture<CollectionMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionMetadata,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    identifier.collectionName());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionMetadata,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    identifier.collectionName());
-    }
-
-    connect(watcher, &QFutureWatcher<CollectionMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        CollectionMetadataResult cmr = watcher->future().result();
+    const auto completion = [=] (CollectionMetadataResult cmr) {
         Result result = cmr.result.code() != Result::Succeeded
                 ? cmr.result
-                : deleteCollectionSecretWithMetadata(
+                : deleteCollectionSecretsWithMetadata(
                       callerPid,
                       requestId,
-                      identifier,
+                      collectionName,
+                      storagePluginName,
+                      filter,
+                      filterOperator,
                       userInteractionMode,
                       interactionServiceAddress,
                       cmr.metadata);
@@ -3826,21 +5258,42 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionSecret(
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(storagePluginName)) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[storagePluginName],
+                              collectionName),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithMetadata(
+Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretsWithMetadata(
         pid_t callerPid,
         quint64 requestId,
-        const Secret::Identifier &identifier,
+        const QString &collectionName,
+        const QString &storagePluginName,
+        const Secret::FilterData &filter,
+        SecretManager::FilterOperator filterOperator,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // TODO: perform access control request to see if the application has permission to write secure storage data.
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
@@ -3857,136 +5310,144 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithMetadata(
                 m_autotestMode);
 
     if (collectionMetadata.accessControlMode == SecretManager::SystemAccessControlMode) {
-        // TODO: perform access control request, to ask for permission to set the secret in the collection.
+        // TODO: perform access control request, to ask for permission to delete secrets in the collection.
         return Result(Result::OperationNotSupportedError,
                       QLatin1String("Access control requests are not currently supported. TODO!"));
     } else if (collectionMetadata.accessControlMode == SecretManager::OwnerOnlyMode
                && collectionMetadata.ownerApplicationId != callerApplicationId) {
         return Result(Result::PermissionsError,
                       QString::fromLatin1("Collection %1 is owned by a different application")
-                      .arg(identifier.collectionName()));
-    } else if (!collectionMetadata.encryptionPluginName.isEmpty()
-               && identifier.storagePluginName() != collectionMetadata.encryptionPluginName
-               && !m_encryptionPlugins.contains(collectionMetadata.encryptionPluginName)) {
-        // TODO: this means we have "stale" data in the database; what should we do in this case?
+                      .arg(collectionName));
+    } else if (!m_authenticationPlugins.contains(authPluginName)) {
         return Result(Result::InvalidExtensionPluginError,
-                      QString::fromLatin1("No such encryption plugin exists: %1")
-                      .arg(collectionMetadata.encryptionPluginName));
+                      QString::fromLatin1("No such authentication plugin available: %1")
+                      .arg(authPluginName));
     }
 
     Sailfish::Secrets::InteractionParameters::PromptText promptText({
-        //: This will be displayed to the user, prompting them to enter the lock code to unlock the collection in order to delete a secret within it. %1 is the application name, %2 is the secret name, %3 is the collection name, %4 is the plugin name.
-        //% "%1 wants to delete secret %2 within collection %3 in plugin %4."
-        { InteractionParameters::Message, qtTrId("sailfish_secrets-delete_collection_secret-la-message")
-                    .arg(callerApplicationId,
-                            identifier.name(),
-                            identifier.collectionName(),
-                            m_requestQueue->controller()->displayNameForPlugin(identifier.storagePluginName())) },
+        //: This will be displayed to the user, prompting them to enter the lock code to unlock the collection in order to delete the secrets within it which match a filter. %1 is the application name, %2 is the collection name, %3 is the plugin name.
+        //% "%1 wants to delete secrets matching a filter within collection %2 in plugin %3."
+        { InteractionParameters::Message, qtTrId("sailfish_secrets-delete_collection_secrets-la-message")
+                         .arg(callerApplicationId,
+                              collectionName,
+                              m_requestQueue->controller()->displayNameForPlugin(storagePluginName)) },
         //% "Enter the collection lock code to unlock the collection."
         { InteractionParameters::Instruction, qtTrId("sailfish_secrets-la-enter_collection_lock_code") }
     });
 
-    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
+    if (storagePluginName == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
-        // TODO: make this asynchronous instead of blocking the main thread!
-        QFuture<LockedResult> future
-                = QtConcurrent::run(
-                        m_requestQueue->secretsThreadPool().data(),
-                        EncryptedStoragePluginFunctionWrapper::isCollectionLocked,
-                        m_encryptedStoragePlugins[identifier.storagePluginName()],
-                        identifier.collectionName());
-        future.waitForFinished();
-        LockedResult lr = future.result();
-        Result pluginResult = lr.result;
-        bool locked = lr.locked;
-        if (pluginResult.code() != Result::Succeeded) {
-            return pluginResult;
-        }
-        if (locked) {
-            if (collectionMetadata.usesDeviceLockKey) {
-                // Perform a "verify" UI flow (if the user interaction mode allows).
-                // If that succeeds, unlock the collection with the stored devicelock key and continue.
-                if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
-                    return Result(Result::CollectionIsLockedError,
-                                  QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                                  .arg(identifier.collectionName()));
-                }
+        return withCollectionLockState(
+                    requestId,
+                    storagePluginName,
+                    collectionName,
+                    QVariantList(),
+                    [=] (bool locked) -> Result {
+            if (locked) {
+                if (collectionMetadata.usesDeviceLockKey) {
+                    // Perform a "verify" UI flow (if the user interaction mode allows).
+                    // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                    if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                        return Result(Result::CollectionIsLockedError,
+                                      QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                      .arg(collectionName));
+                    }
 
-                // always use the system authentication plugin for device lock authentication requests.
-                const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
-                        m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                                       : SecretManager::DefaultAuthenticationPluginName);
-                Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
-                            callerPid,
-                            requestId,
-                            promptText);
-                if (result.code() == Result::Failed) {
+                    // always use the system authentication plugin for device lock authentication requests.
+                    const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                            m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                           : SecretManager::DefaultAuthenticationPluginName);
+                    Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                                callerPid,
+                                requestId,
+                                promptText);
+                    if (result.code() == Result::Failed) {
+                        return result;
+                    }
+
+                    // calls deleteCollectionSecretsWithEncryptionKey when finished
+                    m_pendingRequests.insert(requestId,
+                                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                                 callerPid,
+                                                 requestId,
+                                                 Daemon::ApiImpl::DeleteCollectionSecretsRequest,
+                                                 QVariantList() << collectionName
+                                                                << storagePluginName
+                                                                << QVariant::fromValue<Secret::FilterData >(filter)
+                                                                << filterOperator
+                                                                << userInteractionMode
+                                                                << interactionServiceAddress
+                                                                << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
                     return result;
-                }
+                } else {
+                    if (userInteractionMode == SecretManager::PreventInteraction) {
+                        return Result(Result::OperationRequiresUserInteraction,
+                                      QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                                      .arg(authPluginName));
+                    } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                        // TODO: stale data in metadata db?
+                        return Result(Result::InvalidExtensionPluginError,
+                                      QStringLiteral("Unknown authentication plugin for collection %1 in plugin %2")
+                                      . arg(collectionName, storagePluginName));
+                    } else if (m_authenticationPlugins[authPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
+                                && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
+                        return Result(Result::OperationRequiresApplicationUserInteraction,
+                                      QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
+                                      .arg(authPluginName));
+                    }
 
-                // calls deleteCollectionSecretWithEncryptionKey when finished
-                m_pendingRequests.insert(requestId,
-                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                             callerPid,
-                                             requestId,
-                                             Daemon::ApiImpl::DeleteCollectionSecretRequest,
-                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
-                                                            << userInteractionMode
-                                                            << interactionServiceAddress
-                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-                return result;
-            } else if (!m_authenticationPlugins.contains(authPluginName)) {
-                // TODO: stale data in metadata db?
-                return Result(Result::InvalidExtensionPluginError,
-                              QStringLiteral("Unknown collection authentication plugin"));
-            } else if (userInteractionMode == SecretManager::PreventInteraction) {
-                return Result(Result::OperationRequiresUserInteraction,
-                              QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                              .arg(authPluginName));
-            }
+                    // perform the user input flow required to get the input key data which will be used
+                    // to unlock the collection in order to delete the secrets.
+                    InteractionParameters promptParams;
+                    promptParams.setApplicationId(callerApplicationId);
+                    promptParams.setPluginName(storagePluginName);
+                    promptParams.setCollectionName(collectionName);
+                    promptParams.setSecretName(QString());
+                    promptParams.setOperation(InteractionParameters::DeleteSecret);
+                    promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+                    promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+                    promptParams.setPromptText(promptText);
+                    Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
+                                callerPid,
+                                requestId,
+                                promptParams,
+                                interactionServiceAddress);
+                    if (interactionResult.code() == Result::Failed) {
+                        return interactionResult;
+                    }
 
-            // perform the user input flow required to get the input key data which will be used
-            // to unlock the collection in order to delete the secret.
-            InteractionParameters promptParams;
-            promptParams.setApplicationId(callerApplicationId);
-            promptParams.setPluginName(identifier.storagePluginName());
-            promptParams.setCollectionName(identifier.collectionName());
-            promptParams.setSecretName(identifier.name());
-            promptParams.setOperation(InteractionParameters::DeleteSecret);
-            promptParams.setInputType(InteractionParameters::AlphaNumericInput);
-            promptParams.setEchoMode(InteractionParameters::PasswordEcho);
-            promptParams.setPromptText(promptText);
-            Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
-                        callerPid,
-                        requestId,
-                        promptParams,
-                        interactionServiceAddress);
-            if (interactionResult.code() == Result::Failed) {
-                return interactionResult;
+                    m_pendingRequests.insert(requestId,
+                                             Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                                 callerPid,
+                                                 requestId,
+                                                 Daemon::ApiImpl::DeleteCollectionSecretsRequest,
+                                                 QVariantList() << collectionName
+                                                                << storagePluginName
+                                                                << QVariant::fromValue<Secret::FilterData >(filter)
+                                                                << filterOperator
+                                                                << userInteractionMode
+                                                                << interactionServiceAddress
+                                                                << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                    return Result(Result::Pending);
+                }
+            } else {
+                deleteCollectionSecretsWithEncryptionKey(
+                            callerPid,
+                            requestId,
+                            collectionName,
+                            storagePluginName,
+                            filter,
+                            filterOperator,
+                            userInteractionMode,
+                            interactionServiceAddress,
+                            collectionMetadata,
+                            QByteArray()); // no key required, it's unlocked already.
+                return Result(Result::Pending);
             }
-
-            m_pendingRequests.insert(requestId,
-                                     Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                         callerPid,
-                                         requestId,
-                                         Daemon::ApiImpl::DeleteCollectionSecretRequest,
-                                         QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
-                                                        << userInteractionMode
-                                                        << interactionServiceAddress
-                                                        << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-        } else {
-            deleteCollectionSecretWithEncryptionKey(
-                        callerPid,
-                        requestId,
-                        identifier,
-                        userInteractionMode,
-                        interactionServiceAddress,
-                        collectionMetadata,
-                        m_requestQueue->deviceLockKey());
-        }
+        });
     } else {
         const QString hashedCollectionName = calculateSecretNameHash(
-                    Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
+                    Secret::Identifier(QString(), collectionName, storagePluginName));
         if (!m_collectionEncryptionKeys.contains(hashedCollectionName)) {
             if (collectionMetadata.usesDeviceLockKey) {
                 // Perform a "verify" UI flow (if the user interaction mode allows).
@@ -3994,7 +5455,7 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithMetadata(
                 if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
                     return Result(Result::CollectionIsLockedError,
                                   QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                                  .arg(identifier.collectionName()));
+                                  .arg(collectionName));
                 }
 
                 // always use the system authentication plugin for device lock authentication requests.
@@ -4009,13 +5470,16 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithMetadata(
                     return result;
                 }
 
-                // calls deleteCollectionSecretWithEncryptionKey when finished
+                // calls deleteCollectionSecretsWithEncryptionKey when finished
                 m_pendingRequests.insert(requestId,
                                          Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                              callerPid,
                                              requestId,
-                                             Daemon::ApiImpl::DeleteCollectionSecretRequest,
-                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                             Daemon::ApiImpl::DeleteCollectionSecretsRequest,
+                                             QVariantList() << collectionName
+                                                            << storagePluginName
+                                                            << QVariant::fromValue<Secret::FilterData >(filter)
+                                                            << filterOperator
                                                             << userInteractionMode
                                                             << interactionServiceAddress
                                                             << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
@@ -4026,18 +5490,24 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithMetadata(
                                   QString::fromLatin1("Authentication plugin %1 requires user interaction")
                                   .arg(authPluginName));
                 } else if (!m_authenticationPlugins.contains(authPluginName)) {
-                    // TODO: stale metadata db data?
+                    // TODO: stale data in metadata db?
                     return Result(Result::InvalidExtensionPluginError,
-                                  QStringLiteral("Unknown collection authentication plugin"));
+                                  QString::fromLatin1("Unknown authentication plugin %1 specified in collection metadata")
+                                  .arg(authPluginName));
+                } else if (m_authenticationPlugins[authPluginName]->authenticationTypes() & AuthenticationPlugin::ApplicationSpecificAuthentication
+                           && (userInteractionMode != SecretManager::ApplicationInteraction || interactionServiceAddress.isEmpty())) {
+                    return Result(Result::OperationRequiresApplicationUserInteraction,
+                                  QString::fromLatin1("Authentication plugin %1 requires in-process user interaction")
+                                  .arg(authPluginName));
                 }
 
                 // perform the user input flow required to get the input key data which will be used
-                // to unlock the secret for deletion.
+                // to unlock the collection in order to delete the secrets.
                 InteractionParameters promptParams;
                 promptParams.setApplicationId(callerApplicationId);
-                promptParams.setPluginName(identifier.storagePluginName());
-                promptParams.setCollectionName(identifier.collectionName());
-                promptParams.setSecretName(identifier.name());
+                promptParams.setPluginName(storagePluginName);
+                promptParams.setCollectionName(collectionName);
+                promptParams.setSecretName(QString());
                 promptParams.setOperation(InteractionParameters::DeleteSecret);
                 promptParams.setInputType(InteractionParameters::AlphaNumericInput);
                 promptParams.setEchoMode(InteractionParameters::PasswordEcho);
@@ -4055,40 +5525,53 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithMetadata(
                                          Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                              callerPid,
                                              requestId,
-                                             Daemon::ApiImpl::DeleteCollectionSecretRequest,
-                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                             Daemon::ApiImpl::DeleteCollectionSecretsRequest,
+                                             QVariantList() << collectionName
+                                                            << storagePluginName
+                                                            << QVariant::fromValue<Secret::FilterData >(filter)
+                                                            << filterOperator
                                                             << userInteractionMode
                                                             << interactionServiceAddress
                                                             << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                return Result(Result::Pending);
             }
         } else {
-            deleteCollectionSecretWithEncryptionKey(
+            deleteCollectionSecretsWithEncryptionKey(
                         callerPid,
                         requestId,
-                        identifier,
+                        collectionName,
+                        storagePluginName,
+                        filter,
+                        filterOperator,
                         userInteractionMode,
                         interactionServiceAddress,
                         collectionMetadata,
                         m_collectionEncryptionKeys.value(hashedCollectionName));
+            return Result(Result::Pending);
         }
     }
-
-    return Result(Result::Pending);
 }
 
 Result
-Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithAuthenticationCode(
+Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretsWithAuthenticationCode(
         pid_t callerPid,
         quint64 requestId,
-        const Secret::Identifier &identifier,
+        const QString &collectionName,
+        const QString &storagePluginName,
+        const Secret::FilterData &filter,
+        SecretManager::FilterOperator filterOperator,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata,
         const QByteArray &authenticationCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // generate the encryption key from the authentication code
     if (!collectionMetadata.encryptionPluginName.isEmpty()
-            && collectionMetadata.encryptionPluginName != identifier.storagePluginName()
+            && storagePluginName != collectionMetadata.encryptionPluginName
             && !m_encryptionPlugins.contains(collectionMetadata.encryptionPluginName)) {
         // TODO: stale data in the database?
         return Result(Result::InvalidExtensionPluginError,
@@ -4096,102 +5579,104 @@ Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithAuthenticationCode(
                       .arg(collectionMetadata.encryptionPluginName));
     }
 
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
-            || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[collectionMetadata.encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    }
-
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
             m_requestQueue->requestFinished(requestId, outParams);
         } else {
-            deleteCollectionSecretWithEncryptionKey(
-                            callerPid, requestId, identifier,
-                            userInteractionMode, interactionServiceAddress,
-                            collectionMetadata, dkr.key);
+            deleteCollectionSecretsWithEncryptionKey(
+                        callerPid, requestId,
+                        collectionName, storagePluginName,
+                        filter, filterOperator,
+                        userInteractionMode, interactionServiceAddress,
+                        collectionMetadata, dkr.key);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (storagePluginName == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
 
 void
-Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretWithEncryptionKey(
+Daemon::ApiImpl::RequestProcessor::deleteCollectionSecretsWithEncryptionKey(
         pid_t callerPid,
         quint64 requestId,
-        const Secret::Identifier &identifier,
+        const QString &collectionName,
+        const QString &storagePluginName,
+        const Secret::FilterData &filter,
+        SecretManager::FilterOperator filterOperator,
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress,
         const CollectionMetadata &collectionMetadata,
         const QByteArray &encryptionKey)
 {
-    // may be needed for access control requests in the future.
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
+    // might be required in future for access control requests.
     Q_UNUSED(callerPid);
     Q_UNUSED(requestId);
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
-    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
+    const auto completion = [=] (IdentifiersResult ir) {
+        m_requestQueue->storedKeyCache()->invalidate(Secret::Identifier(QString(), collectionName, storagePluginName));
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(ir.result);
+        outParams << QVariant::fromValue<QVector<Secret::Identifier> >(ir.identifiers);
+        m_requestQueue->requestFinished(requestId, outParams);
+    };
+    if (storagePluginName == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::unlockCollectionAndRemoveSecret,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    collectionMetadata,
-                    identifier,
-                    encryptionKey);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::unlockCollectionAndRemoveSecrets,
+                              m_encryptedStoragePlugins[storagePluginName],
+                              collectionMetadata,
+                              filter,
+                              static_cast<StoragePlugin::FilterOperator>(filterOperator),
+                              encryptionKey),
+                    completion);
     } else {
         bool requiresRelock =
                 ((!collectionMetadata.usesDeviceLockKey
                   && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
                 || (collectionMetadata.usesDeviceLockKey
                   && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
-        const QString hashedCollectionName = calculateSecretNameHash(
-                    Secret::Identifier(QString(), identifier.collectionName(), identifier.storagePluginName()));
+        const QString hashedCollectionName = calculateSecretNameHash(Secret::Identifier(QString(), collectionName, storagePluginName));
         if (!m_collectionEncryptionKeys.contains(hashedCollectionName) && !requiresRelock) {
             // TODO: some way to "test" the encryptionKey!  also, if it's a custom lock, set the timeout, etc.
-            // FIXME: in this case, if the user entered the "wrong" password, we will be caching an incorrect key...
             m_collectionEncryptionKeys.insert(hashedCollectionName, encryptionKey);
         }
 
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::removeSecret,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    identifier.collectionName(),
-                    identifier.name());
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(storagePluginName).data(),
+                    std::bind(StoragePluginFunctionWrapper::removeSecrets,
+                              m_storagePlugins[storagePluginName],
+                              collectionName,
+                              filter,
+                              static_cast<StoragePlugin::FilterOperator>(filterOperator)),
+                    completion);
     }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result pluginResult = watcher->future().result();
-        QVariantList outParams;
-        outParams << QVariant::fromValue<Result>(pluginResult);
-        m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
 }
 
 // delete a standalone secret
@@ -4203,28 +5688,7 @@ Daemon::ApiImpl::RequestProcessor::deleteStandaloneSecret(
         SecretManager::UserInteractionMode userInteractionMode)
 {
     // Read the metadata about the target secret
-    QFutureWatcher<SecretMetadataResult> *watcher
-            = new QFutureWatcher<SecretMetadataResult>(this);
-    QFuture<SecretMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::secretMetadata,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    QStringLiteral("standalone"),
-                    identifier.name());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::secretMetadata,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    QStringLiteral("standalone"),
-                    identifier.name());
-    }
-
-    connect(watcher, &QFutureWatcher<SecretMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        SecretMetadataResult smr = watcher->future().result();
+    const auto completion = [=] (SecretMetadataResult smr) {
         Result result = smr.result.code() != Result::Succeeded
                 ? smr.result
                 : deleteStandaloneSecretWithMetadata(
@@ -4238,8 +5702,24 @@ Daemon::ApiImpl::RequestProcessor::deleteStandaloneSecret(
             outParams << QVariant::fromValue<Result>(result);
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::secretMetadata,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              QStringLiteral("standalone"),
+                              identifier.name()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::secretMetadata,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              QStringLiteral("standalone"),
+                              identifier.name()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -4252,6 +5732,10 @@ Daemon::ApiImpl::RequestProcessor::deleteStandaloneSecretWithMetadata(
         SecretManager::UserInteractionMode userInteractionMode,
         const SecretMetadata &secretMetadata)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // TODO: perform access control request to see if the application has permission to write secure storage data.
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
@@ -4276,28 +5760,7 @@ Daemon::ApiImpl::RequestProcessor::deleteStandaloneSecretWithMetadata(
                       .arg(secretMetadata.encryptionPluginName));
     }
 
-    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
-    if (identifier.storagePluginName() == secretMetadata.encryptionPluginName
-            || secretMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::removeSecret,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    identifier.collectionName(),
-                    identifier.name());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::removeSecret,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    QStringLiteral("standalone"),
-                    identifier.name());
-    }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result pluginResult = watcher->future().result();
+    const auto completion = [=] (Result pluginResult) {
         if (pluginResult.code() == Result::Succeeded) {
             if (identifier.storagePluginName() != secretMetadata.encryptionPluginName
                     && !secretMetadata.encryptionPluginName.isEmpty()) {
@@ -4310,8 +5773,25 @@ Daemon::ApiImpl::RequestProcessor::deleteStandaloneSecretWithMetadata(
         QVariantList outParams;
         outParams << QVariant::fromValue<Result>(pluginResult);
         m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
+    };
+    if (identifier.storagePluginName() == secretMetadata.encryptionPluginName
+            || secretMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::removeSecret,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              identifier.collectionName(),
+                              identifier.name()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::removeSecret,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              QStringLiteral("standalone"),
+                              identifier.name()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -4325,7 +5805,6 @@ Daemon::ApiImpl::RequestProcessor::queryLockStatus(
         LockCodeRequest::LockStatus *lockStatus)
 {
     Q_UNUSED(callerPid);
-    Q_UNUSED(requestId);
 
     if (lockCodeTargetType == LockCodeRequest::MetadataDatabase) {
         *lockStatus = m_requestQueue->masterLocked()
@@ -4334,33 +5813,45 @@ Daemon::ApiImpl::RequestProcessor::queryLockStatus(
         return Result(Result::Succeeded);
     }
 
-    // TODO: make this asynchronous.
-    QFuture<FoundLockStatusResult> future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                &Daemon::ApiImpl::queryLockSpecificPlugin,
-                m_encryptionPlugins,
-                m_storagePlugins,
-                m_encryptedStoragePlugins,
-                lockCodeTarget);
-    future.waitForFinished();
-    FoundLockStatusResult fr = future.result();
-    if (fr.found) {
+    m_taskExecutor.run(
+                m_requestQueue->pluginThreadPool(lockCodeTarget).data(),
+                std::bind(&Daemon::ApiImpl::queryLockSpecificPlugin,
+                          m_encryptionPlugins,
+                          m_storagePlugins,
+                          m_encryptedStoragePlugins,
+                          lockCodeTarget),
+                [=] (FoundLockStatusResult fr) {
         // if the lock target was a plugin from the encryption/storage/encryptedStorage
         // maps, then return the lock result from the threaded plugin operation.
-        *lockStatus = fr.lockStatus;
-        return fr.result;
-    } else if (AuthenticationPlugin *p = m_authenticationPlugins.value(lockCodeTarget)) {
-        if (!p->supportsLocking()) {
-            *lockStatus = LockCodeRequest::Unsupported;
-        } else {
-            *lockStatus = p->isLocked()
-                        ? LockCodeRequest::Locked
-                        : LockCodeRequest::Unlocked;
+        LockCodeRequest::LockStatus status = fr.lockStatus;
+        Result result = fr.result;
+        if (!fr.found) {
+            if (AuthenticationPlugin *p = m_authenticationPlugins.value(lockCodeTarget)) {
+                status = !p->supportsLocking()
+                       ? LockCodeRequest::Unsupported
+                       : p->isLocked() ? LockCodeRequest::Locked
+                                       : LockCodeRequest::Unlocked;
+                result = Result(Result::Succeeded);
+            } else {
+                // the crypto plugin is queried asynchronously.
+                m_requestQueue->queryLockStatusCryptoPlugin(
+                            lockCodeTarget,
+                            [=] (const Result &cryptoResult, LockCodeRequest::LockStatus cryptoStatus) {
+                    QVariantList outParams;
+                    outParams << QVariant::fromValue<Result>(cryptoResult);
+                    outParams << QVariant::fromValue<LockCodeRequest::LockStatus>(cryptoStatus);
+                    m_requestQueue->requestFinished(requestId, outParams);
+                });
+                return;
+            }
         }
-        return Result(Result::Succeeded);
-    }
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(result);
+        outParams << QVariant::fromValue<LockCodeRequest::LockStatus>(status);
+        m_requestQueue->requestFinished(requestId, outParams);
+    });
 
-    return m_requestQueue->queryLockStatusCryptoPlugin(lockCodeTarget, lockStatus);
+    return Result(Result::Pending);
 }
 
 Result
@@ -4481,6 +5972,10 @@ Daemon::ApiImpl::RequestProcessor::modifyLockCodeWithLockCode(
         const QString &interactionServiceAddress,
         const QByteArray &oldLockCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // TODO: access control, check the application is allowed to modify plugin locks.
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
@@ -4564,117 +6059,97 @@ Daemon::ApiImpl::RequestProcessor::modifyLockCodeWithLockCodes(
         const QByteArray &oldLockCode,
         const QByteArray &newLockCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // TODO: support secret/collection flows
     Q_UNUSED(callerPid);
-    Q_UNUSED(requestId);
     Q_UNUSED(interactionParams);
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
 
     // see if the client is attempting to set the lock code for a plugin
     if (lockCodeTargetType == LockCodeRequest::ExtensionPlugin) {
-        QFuture<FoundResult> future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    &Daemon::ApiImpl::modifyLockSpecificPlugin,
-                    m_encryptionPlugins,
-                    m_storagePlugins,
-                    m_encryptedStoragePlugins,
-                    lockCodeTarget,
-                    LockCodes(oldLockCode, newLockCode));
-        future.waitForFinished();
-        FoundResult fr = future.result();
-        if (fr.found) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(lockCodeTarget).data(),
+                    std::bind(&Daemon::ApiImpl::modifyLockSpecificPlugin,
+                              m_encryptionPlugins,
+                              m_storagePlugins,
+                              m_encryptedStoragePlugins,
+                              lockCodeTarget,
+                              LockCodes(oldLockCode, newLockCode)),
+                    [=] (FoundResult fr) {
+            // the plugin may store or encrypt any cached key, so none are reused.
+            m_requestQueue->storedKeyCache()->clear();
             // if the lock target was a plugin from the encryption/storage/encryptedStorage
             // maps, then return the lock result from the threaded plugin operation.
-            return fr.result;
-        } else if (m_authenticationPlugins.contains(lockCodeTarget)) {
-            AuthenticationPlugin *p = m_authenticationPlugins.value(lockCodeTarget);
-            if (!p->supportsLocking()) {
-                return Result(Result::OperationNotSupportedError,
-                              QStringLiteral("Authentication plugin %1 does not support locking").arg(lockCodeTarget));
-            } else if (!p->setLockCode(oldLockCode, newLockCode)) {
-                return Result(Result::UnknownError,
-                              QStringLiteral("Failed to set the lock code for authentication plugin %1").arg(lockCodeTarget));
+            Result result = fr.result;
+            if (!fr.found && m_authenticationPlugins.contains(lockCodeTarget)) {
+                AuthenticationPlugin *p = m_authenticationPlugins.value(lockCodeTarget);
+                if (!p->supportsLocking()) {
+                    result = Result(Result::OperationNotSupportedError,
+                                    QStringLiteral("Authentication plugin %1 does not support locking").arg(lockCodeTarget));
+                } else if (!p->setLockCode(oldLockCode, newLockCode)) {
+                    result = Result(Result::UnknownError,
+                                    QStringLiteral("Failed to set the lock code for authentication plugin %1").arg(lockCodeTarget));
+                } else {
+                    result = Result(Result::Succeeded);
+                }
+            } else if (!fr.found) {
+                // the crypto plugin is called asynchronously.
+                m_requestQueue->setLockCodeCryptoPlugin(lockCodeTarget, oldLockCode, newLockCode, [=] (const Result &cryptoResult) {
+                    QVariantList outParams;
+                    outParams << QVariant::fromValue<Result>(cryptoResult);
+                    m_requestQueue->requestFinished(requestId, outParams);
+                });
+                return;
             }
-            return Result(Result::Succeeded);
-        } else {
-            return m_requestQueue->setLockCodeCryptoPlugin(lockCodeTarget, oldLockCode, newLockCode);
-        }
-    }
-
-    // otherwise, we are modifying the "master" lock code for the bookkeeping database.
-    if (!m_requestQueue->testLockCode(oldLockCode)) {
-        return Result(Result::IncorrectAuthenticationCodeError,
-                      QLatin1String("The given old lock code was incorrect"));
-    }
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        });
 
-    // pull the old bookkeeping database lock key and device lock key into memory via deep copy.
-    QByteArray oldBkdbLockKey, oldDeviceLockKey;
-    {
-        QByteArray bkdbShallowCopy = m_requestQueue->bkdbLockKey();
-        oldBkdbLockKey = QByteArray(bkdbShallowCopy.constData(), bkdbShallowCopy.size());
-        QByteArray dlShallowCopy = m_requestQueue->deviceLockKey();
-        oldDeviceLockKey = QByteArray(dlShallowCopy.constData(), dlShallowCopy.size());
+        return Result(Result::Pending);
     }
 
-    // the old lock code was correct, initialize the new lock code.
-    m_requestQueue->initialize(newLockCode, SecretsRequestQueue::ModifyLockMode);
-
-    // re-encrypt the metadata (bookkeeping) databases for each storage plugin.
-    QFuture<bool> reencryptMetadata = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                &Daemon::ApiImpl::modifyMasterLockPlugins,
-                m_storagePlugins.values(),
-                m_encryptedStoragePlugins.values(),
-                oldBkdbLockKey,
-                m_requestQueue->bkdbLockKey());
-    reencryptMetadata.waitForFinished();
-    if (!reencryptMetadata.result()) {
-        // TODO: FIXME: how do we recover from this?  (Each plugin is modified serially, cannot be atomic...)
-        qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to re-encrypt all metadata databases successfully!";
-    }
-
-    // Now re-encrypt all device-locked collections and secrets.
-    for (EncryptedStoragePluginWrapper *plugin : m_encryptedStoragePlugins.values()) {
-        // We don't allow storing device-locked standalone secrets in encryptedStoragePlugins,
-        // so we just need to ensure that we re-encrypt collections here.
-        QFuture<Result> future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::unlockDeviceLockedCollectionsAndReencrypt,
-                    plugin,
-                    oldDeviceLockKey,
-                    m_requestQueue->deviceLockKey());
-        future.waitForFinished();
-        Result reencryptCollectionResult = future.result();
-        if (reencryptCollectionResult.code() != Result::Succeeded) {
-            // TODO: FIXME: how do we recover from this?
-            qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to re-encrypt encrypted storage device-locked collections:"
-                                               << plugin->name()
-                                               << reencryptCollectionResult.code()
-                                               << reencryptCollectionResult.errorMessage();
+    // otherwise, we are modifying the "master" lock code for the bookkeeping database.
+    // The keys are derived from the lock codes in the thread of the crypto plugin.
+    m_requestQueue->testLockCode(oldLockCode, [=] (bool correct) {
+        if (!correct) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(Result(Result::IncorrectAuthenticationCodeError,
+                                                            QLatin1String("The given old lock code was incorrect")));
+            m_requestQueue->requestFinished(requestId, outParams);
+            return;
         }
-    }
-    for (StoragePluginWrapper *plugin : m_storagePlugins.values()) {
-        QFuture<Result> future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::reencryptDeviceLockedCollectionsAndSecrets,
-                    plugin,
-                    m_encryptionPlugins,
-                    oldDeviceLockKey,
-                    m_requestQueue->deviceLockKey());
-        future.waitForFinished();
-        Result reencryptResult = future.result();
-        if (reencryptResult.code() != Result::Succeeded) {
-            // TODO: FIXME: how do we recover from this?
-            qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to re-encrypt stored device-locked collections and secrets:"
-                                               << plugin->name()
-                                               << reencryptResult.code()
-                                               << reencryptResult.errorMessage();
+        if (m_requestQueue->expireInProgressRequest(requestId)) {
+            return;
         }
-    }
 
-    // TODO: FIXME: handle per-plugin errors in a robust way?
-    return Result(Result::Succeeded);
+        // pull the old bookkeeping database lock key and device lock key into memory via deep copy.
+        QByteArray oldBkdbLockKey, oldDeviceLockKey;
+        {
+            QByteArray bkdbShallowCopy = m_requestQueue->bkdbLockKey();
+            oldBkdbLockKey = QByteArray(bkdbShallowCopy.constData(), bkdbShallowCopy.size());
+            QByteArray dlShallowCopy = m_requestQueue->deviceLockKey();
+            oldDeviceLockKey = QByteArray(dlShallowCopy.constData(), dlShallowCopy.size());
+        }
+
+        // the old lock code was correct, initialize the new lock code.
+        m_requestQueue->initialize(newLockCode, SecretsRequestQueue::ModifyLockMode, [=] (bool initialized) {
+            if (!initialized) {
+                QVariantList outParams;
+                outParams << QVariant::fromValue<Result>(Result(Result::UnknownError,
+                                                                QLatin1String("Unable to initialize key data from the new lock code")));
+                m_requestQueue->requestFinished(requestId, outParams);
+                return;
+            }
+            reencryptMasterLockedPlugins(requestId, oldLockCode, oldBkdbLockKey, oldDeviceLockKey);
+        });
+    });
+
+    return Result(Result::Pending);
 }
 
 Result
@@ -4726,31 +6201,19 @@ Daemon::ApiImpl::RequestProcessor::provideLockCode(
             // on startup, and the lock code hasn't been modified since
             // then (but may have been deliberately forgotten).
             // So, we can unlock the database with a null lock code.
-            if (!m_requestQueue->initialize(
-                        QByteArray(),
-                        SecretsRequestQueue::UnlockMode)) {
-                return Result(Result::UnknownError,
-                              QLatin1String("Unable to initialize key data from null lock code"));
-            }
-
-            // unlock all of our plugins
-            QFuture<bool> future = QtConcurrent::run(
-                        m_requestQueue->secretsThreadPool().data(),
-                        &Daemon::ApiImpl::masterUnlockPlugins,
-                        m_storagePlugins.values(),
-                        m_encryptedStoragePlugins.values(),
-                        m_requestQueue->bkdbLockKey());
-            future.waitForFinished();
-            if (!future.result()) {
-                // TODO: FIXME: how can we recover from this?
-                // This is symptomatic of a power-loss halfway through previous re-encryption,
-                // meaning that some metadata databases will have been encrypted with
-                // the OLD lock code, and some with the NEW lock code...
-                qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to unlock metadata plugins";
-            }
+            m_requestQueue->initialize(QByteArray(), SecretsRequestQueue::UnlockMode, [=] (bool initialized) {
+                if (!initialized) {
+                    QVariantList outParams;
+                    outParams << QVariant::fromValue<Result>(Result(Result::UnknownError,
+                                                                    QLatin1String("Unable to initialize key data from null lock code")));
+                    m_requestQueue->requestFinished(requestId, outParams);
+                    return;
+                }
 
-            // TODO: FIXME: how can we handle plugin metadata decryption failures?
-            return Result(Result::Succeeded);
+                // unlock all of our plugins
+                masterUnlockAllPlugins(requestId);
+            });
+            return Result(Result::Pending);
         }
     }
 
@@ -4828,73 +6291,87 @@ Daemon::ApiImpl::RequestProcessor::provideLockCodeWithLockCode(
         const QString &interactionServiceAddress,
         const QByteArray &lockCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // TODO: support the secret/collection flows.
     Q_UNUSED(callerPid);
-    Q_UNUSED(requestId);
     Q_UNUSED(interactionParams);
     Q_UNUSED(userInteractionMode);
     Q_UNUSED(interactionServiceAddress);
 
     // check if the client is attempting to unlock an extension plugin
     if (lockCodeTargetType == LockCodeRequest::ExtensionPlugin) {
-        QFuture<FoundResult> future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    &Daemon::ApiImpl::unlockSpecificPlugin,
-                    m_encryptionPlugins,
-                    m_storagePlugins,
-                    m_encryptedStoragePlugins,
-                    lockCodeTarget,
-                    lockCode);
-        future.waitForFinished();
-        FoundResult fr = future.result();
-        if (fr.found) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(lockCodeTarget).data(),
+                    std::bind(&Daemon::ApiImpl::unlockSpecificPlugin,
+                              m_encryptionPlugins,
+                              m_storagePlugins,
+                              m_encryptedStoragePlugins,
+                              lockCodeTarget,
+                              lockCode),
+                    [=] (FoundResult fr) {
             // if the lock target was a plugin from the encryption/storage/encryptedStorage
             // maps, then return the lock result from the threaded plugin operation.
-            return fr.result;
-        } else if (m_authenticationPlugins.contains(lockCodeTarget)) {
-            AuthenticationPlugin *p = m_authenticationPlugins.value(lockCodeTarget);
-            if (!p->supportsLocking()) {
-                return Result(Result::OperationNotSupportedError,
-                              QStringLiteral("Authentication plugin %1 does not support locking").arg(lockCodeTarget));
-            } else if (!p->unlock(lockCode)) {
-                return Result(Result::UnknownError,
-                              QStringLiteral("Failed to unlock authentication plugin %1").arg(lockCodeTarget));
+            Result result = fr.result;
+            if (!fr.found && m_authenticationPlugins.contains(lockCodeTarget)) {
+                AuthenticationPlugin *p = m_authenticationPlugins.value(lockCodeTarget);
+                if (!p->supportsLocking()) {
+                    result = Result(Result::OperationNotSupportedError,
+                                    QStringLiteral("Authentication plugin %1 does not support locking").arg(lockCodeTarget));
+                } else if (!p->unlock(lockCode)) {
+                    result = Result(Result::UnknownError,
+                                    QStringLiteral("Failed to unlock authentication plugin %1").arg(lockCodeTarget));
+                } else {
+                    result = Result(Result::Succeeded);
+                }
+            } else if (!fr.found) {
+                // the crypto plugin is called asynchronously.
+                m_requestQueue->unlockCryptoPlugin(lockCodeTarget, lockCode, [=] (const Result &cryptoResult) {
+                    QVariantList outParams;
+                    outParams << QVariant::fromValue<Result>(cryptoResult);
+                    m_requestQueue->requestFinished(requestId, outParams);
+                });
+                return;
             }
-            return Result(Result::Succeeded);
-        } else {
-            return m_requestQueue->unlockCryptoPlugin(lockCodeTarget, lockCode);
-        }
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        });
+
+        return Result(Result::Pending);
     }
 
     // otherwise, the client is attempting to provide the "master" lock for the metadata (bookkeeping) databases.
-    if (!m_requestQueue->testLockCode(lockCode)) {
-        return Result(Result::IncorrectAuthenticationCodeError,
-                      QLatin1String("The given lock code was incorrect"));
-    }
-    if (!m_requestQueue->initialize(
-                lockCode, SecretsRequestQueue::UnlockMode)) {
-        return Result(Result::UnknownError,
-                      QLatin1String("Unable to initialize key data to unlock metadata databases"));
-    }
+    // The keys are derived from the lock code in the thread of the crypto plugin.
+    m_requestQueue->testLockCode(lockCode, [=] (bool correct) {
+        if (!correct) {
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(Result(Result::IncorrectAuthenticationCodeError,
+                                                            QLatin1String("The given lock code was incorrect")));
+            m_requestQueue->requestFinished(requestId, outParams);
+            return;
+        }
+        if (m_requestQueue->expireInProgressRequest(requestId)) {
+            return;
+        }
 
-    // unlock all of our plugins
-    QFuture<bool> future = QtConcurrent::run(
-                m_requestQueue->secretsThreadPool().data(),
-                &Daemon::ApiImpl::masterUnlockPlugins,
-                m_storagePlugins.values(),
-                m_encryptedStoragePlugins.values(),
-                m_requestQueue->bkdbLockKey());
-    future.waitForFinished();
-    if (!future.result()) {
-        // TODO: FIXME: how can we recover from this?
-        // This is symptomatic of a power-loss halfway through previous re-encryption,
-        // meaning that some metadata databases will have been encrypted with
-        // the OLD lock code, and some with the NEW lock code...
-        qCWarning(lcSailfishSecretsDaemon) << "Critical Error! Failed to unlock metadata plugins";
-    }
-
-    // TODO: FIXME: how can we handle plugin metadata decryption failures?
-    return Result(Result::Succeeded);
+        m_requestQueue->initialize(lockCode, SecretsRequestQueue::UnlockMode, [=] (bool initialized) {
+            if (!initialized) {
+                QVariantList outParams;
+                outParams << QVariant::fromValue<Result>(Result(Result::UnknownError,
+                                                                QLatin1String("Unable to initialize key data to unlock metadata databases")));
+                m_requestQueue->requestFinished(requestId, outParams);
+                return;
+            }
+
+            // unlock all of our plugins
+            masterUnlockAllPlugins(requestId);
+        });
+    });
+
+    return Result(Result::Pending);
 }
 
 Result
@@ -4907,7 +6384,6 @@ Daemon::ApiImpl::RequestProcessor::forgetLockCode(
         SecretManager::UserInteractionMode userInteractionMode,
         const QString &interactionServiceAddress)
 {
-    Q_UNUSED(requestId)
     Q_UNUSED(interactionParams)
     Q_UNUSED(userInteractionMode)
     Q_UNUSED(interactionServiceAddress)
@@ -4928,32 +6404,45 @@ Daemon::ApiImpl::RequestProcessor::forgetLockCode(
                           QLatin1String("Only the system settings application can unlock the plugin"));
         }
 
-        QFuture<FoundResult> future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    &Daemon::ApiImpl::lockSpecificPlugin,
-                    m_encryptionPlugins,
-                    m_storagePlugins,
-                    m_encryptedStoragePlugins,
-                    lockCodeTarget);
-        future.waitForFinished();
-        FoundResult fr = future.result();
-        if (fr.found) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(lockCodeTarget).data(),
+                    std::bind(&Daemon::ApiImpl::lockSpecificPlugin,
+                              m_encryptionPlugins,
+                              m_storagePlugins,
+                              m_encryptedStoragePlugins,
+                              lockCodeTarget),
+                    [=] (FoundResult fr) {
+            // the plugin may store or encrypt any cached key, so none are reused.
+            m_requestQueue->storedKeyCache()->clear();
             // if the lock target was a plugin from the encryption/storage/encryptedStorage
             // maps, then return the lock result from the threaded plugin operation.
-            return fr.result;
-        } else if (m_authenticationPlugins.contains(lockCodeTarget)) {
-            AuthenticationPlugin *p = m_authenticationPlugins.value(lockCodeTarget);
-            if (!p->supportsLocking()) {
-                return Result(Result::OperationNotSupportedError,
-                              QStringLiteral("Authentication plugin %1 does not support locking").arg(lockCodeTarget));
-            } else if (!p->lock()) {
-                return Result(Result::UnknownError,
-                              QStringLiteral("Failed to lock authentication plugin %1").arg(lockCodeTarget));
+            Result result = fr.result;
+            if (!fr.found && m_authenticationPlugins.contains(lockCodeTarget)) {
+                AuthenticationPlugin *p = m_authenticationPlugins.value(lockCodeTarget);
+                if (!p->supportsLocking()) {
+                    result = Result(Result::OperationNotSupportedError,
+                                    QStringLiteral("Authentication plugin %1 does not support locking").arg(lockCodeTarget));
+                } else if (!p->lock()) {
+                    result = Result(Result::UnknownError,
+                                    QStringLiteral("Failed to lock authentication plugin %1").arg(lockCodeTarget));
+                } else {
+                    result = Result(Result::Succeeded);
+                }
+            } else if (!fr.found) {
+                // the crypto plugin is called asynchronously.
+                m_requestQueue->lockCryptoPlugin(lockCodeTarget, [=] (const Result &cryptoResult) {
+                    QVariantList outParams;
+                    outParams << QVariant::fromValue<Result>(cryptoResult);
+                    m_requestQueue->requestFinished(requestId, outParams);
+                });
+                return;
             }
-            return Result(Result::Succeeded);
-        } else {
-            return m_requestQueue->lockCryptoPlugin(lockCodeTarget);
-        }
+            QVariantList outParams;
+            outParams << QVariant::fromValue<Result>(result);
+            m_requestQueue->requestFinished(requestId, outParams);
+        });
+
+        return Result(Result::Pending);
     } else {
         // TODO: only allow system settings application or device lock daemon!
         if (!applicationIsPlatformApplication) {
@@ -4967,25 +6456,38 @@ Daemon::ApiImpl::RequestProcessor::forgetLockCode(
                           QLatin1String("Invalid target name specified"));
         }
 
-        if (!m_requestQueue->initialize(
+        m_requestQueue->initialize(
                     QByteArray("ffffffffffffffff"
                                "ffffffffffffffff"
                                "ffffffffffffffff"
                                "ffffffffffffffff"),
-                    SecretsRequestQueue::LockMode)) {
-            return Result(Result::UnknownError,
-                          QLatin1String("Unable to re-initialize key data to lock the secrets service"));
-        }
+                    SecretsRequestQueue::LockMode,
+                    [=] (bool initialized) {
+            if (!initialized) {
+                QVariantList outParams;
+                outParams << QVariant::fromValue<Result>(Result(Result::UnknownError,
+                                                                QLatin1String("Unable to re-initialize key data to lock the secrets service")));
+                m_requestQueue->requestFinished(requestId, outParams);
+                return;
+            }
 
-        // lock all of our plugins' metadata databases
-        QFuture<bool> future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    &Daemon::ApiImpl::masterLockPlugins,
-                    m_storagePlugins.values(),
-                    m_encryptedStoragePlugins.values());
-        future.waitForFinished();
+            // lock all of our plugins' metadata databases
+            const QList<StoragePluginWrapper*> storagePlugins = m_storagePlugins.values();
+            const QList<EncryptedStoragePluginWrapper*> encryptedStoragePlugins = m_encryptedStoragePlugins.values();
+            const QSharedPointer<PluginThreadPoolBarrier> barrier = m_requestQueue->pluginThreadPoolBarrier();
+            m_taskExecutor.run(
+                        m_requestQueue->secretsThreadPool().data(),
+                        [barrier, storagePlugins, encryptedStoragePlugins] () -> bool {
+                const PluginThreadPoolBarrier::Scope exclusive(barrier);
+                return Daemon::ApiImpl::masterLockPlugins(storagePlugins, encryptedStoragePlugins);
+            }, [=] (bool) {
+                QVariantList outParams;
+                outParams << QVariant::fromValue<Result>(Result(Result::Succeeded));
+                m_requestQueue->requestFinished(requestId, outParams);
+            });
+        });
 
-        return Result(Result::Succeeded);
+        return Result(Result::Pending);
     }
 }
 
@@ -5019,26 +6521,7 @@ Daemon::ApiImpl::RequestProcessor::useCollectionKeyPreCheck(
     }
 
     // Read the metadata about the target collection
-    QFutureWatcher<CollectionMetadataResult> *watcher
-            = new QFutureWatcher<CollectionMetadataResult>(this);
-    QFuture<CollectionMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionMetadata,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    identifier.collectionName());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionMetadata,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    identifier.collectionName());
-    }
-
-    connect(watcher, &QFutureWatcher<CollectionMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        CollectionMetadataResult cmr = watcher->future().result();
+    const auto completion = [=] (CollectionMetadataResult cmr) {
         Result result = cmr.result.code() != Result::Succeeded
                 ? cmr.result
                 : useCollectionKeyPreCheckWithMetadata(
@@ -5055,8 +6538,22 @@ Daemon::ApiImpl::RequestProcessor::useCollectionKeyPreCheck(
             outParams << QVariant::fromValue<QByteArray>(QByteArray());
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -5071,6 +6568,10 @@ Daemon::ApiImpl::RequestProcessor::useCollectionKeyPreCheckWithMetadata(
         SecretManager::UserInteractionMode userInteractionMode,
         const CollectionMetadata &collectionMetadata)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
                 ? m_appPermissions->platformApplicationId()
@@ -5147,102 +6648,95 @@ Daemon::ApiImpl::RequestProcessor::useCollectionKeyPreCheckWithMetadata(
     });
 
     if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
-        // TODO: make this asynchronous instead of blocking the main thread!
-        QFuture<LockedResult> future
-                = QtConcurrent::run(
-                        m_requestQueue->secretsThreadPool().data(),
-                        EncryptedStoragePluginFunctionWrapper::isCollectionLocked,
-                        m_encryptedStoragePlugins[identifier.storagePluginName()],
-                        identifier.collectionName());
-        future.waitForFinished();
-        LockedResult lr = future.result();
-        Result pluginResult = lr.result;
-        bool locked = lr.locked;
-        if (pluginResult.code() != Result::Succeeded) {
-            return pluginResult;
-        }
-        if (!locked) {
-            useCollectionKeyPreCheckWithEncryptionKey(
-                        callerPid,
-                        requestId,
-                        identifier,
-                        collectionMetadata,
-                        QByteArray());
-            return Result(Result::Pending);
-        }
+        return withCollectionLockState(
+                    requestId,
+                    identifier.storagePluginName(),
+                    identifier.collectionName(),
+                    QVariantList() << QVariant::fromValue<QByteArray>(QByteArray()),
+                    [=] (bool locked) -> Result {
+            if (!locked) {
+                useCollectionKeyPreCheckWithEncryptionKey(
+                            callerPid,
+                            requestId,
+                            identifier,
+                            collectionMetadata,
+                            QByteArray());
+                return Result(Result::Pending);
+            }
 
-        if (collectionMetadata.usesDeviceLockKey) {
-            // Perform a "verify" UI flow (if the user interaction mode allows).
-            // If that succeeds, unlock the collection with the stored devicelock key and continue.
-            if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
-                return Result(Result::CollectionIsLockedError,
-                              QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                              .arg(identifier.collectionName()));
+            if (collectionMetadata.usesDeviceLockKey) {
+                // Perform a "verify" UI flow (if the user interaction mode allows).
+                // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                    return Result(Result::CollectionIsLockedError,
+                                  QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                  .arg(identifier.collectionName()));
+                }
+
+                // always use the system authentication plugin for device lock authentication requests.
+                const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                        m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                       : SecretManager::DefaultAuthenticationPluginName);
+                Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                            callerPid,
+                            requestId,
+                            promptText);
+                if (result.code() == Result::Failed) {
+                    return result;
+                }
+
+                // calls useCollectionKeyPreCheckWithEncryptionKey when finished
+                m_pendingRequests.insert(requestId,
+                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                             callerPid,
+                                             requestId,
+                                             Daemon::ApiImpl::UseCollectionKeyPreCheckRequest,
+                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                return result;
+            } else if (userInteractionMode == SecretManager::PreventInteraction) {
+                return Result(Result::OperationRequiresUserInteraction,
+                              QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                              .arg(authPluginName));
+            } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                return Result(Result::InvalidExtensionPluginError,
+                              QStringLiteral("Unknown collection authentication plugin: %1")
+                              .arg(authPluginName));
             }
 
-            // always use the system authentication plugin for device lock authentication requests.
-            const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
-                    m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                                   : SecretManager::DefaultAuthenticationPluginName);
-            Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+            // perform the user input flow required to get the input key data which will be used
+            // to unlock this collection.
+            InteractionParameters promptParams;
+            promptParams.setApplicationId(callerApplicationId);
+            promptParams.setPluginName(identifier.storagePluginName());
+            promptParams.setCollectionName(identifier.collectionName());
+            promptParams.setSecretName(identifier.name());
+            promptParams.setOperation(InteractionParameters::StoreKey);
+            promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+            promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+            promptParams.setPromptText(promptText);
+            Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
                         callerPid,
                         requestId,
-                        promptText);
-            if (result.code() == Result::Failed) {
-                return result;
+                        promptParams,
+                        QString());
+            if (interactionResult.code() == Result::Failed) {
+                return interactionResult;
             }
 
-            // calls useCollectionKeyPreCheckWithEncryptionKey when finished
+            // calls useCollectionKeyPreCheckWithAuthenticationCode when finished
             m_pendingRequests.insert(requestId,
                                      Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                          callerPid,
                                          requestId,
                                          Daemon::ApiImpl::UseCollectionKeyPreCheckRequest,
                                          QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                                        << QVariant::fromValue<Sailfish::Crypto::CryptoManager::Operation>(operation)
+                                                        << cryptoPluginName
+                                                        << userInteractionMode
                                                         << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-            return result;
-        } else if (userInteractionMode == SecretManager::PreventInteraction) {
-            return Result(Result::OperationRequiresUserInteraction,
-                          QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                          .arg(authPluginName));
-        } else if (!m_authenticationPlugins.contains(authPluginName)) {
-            return Result(Result::InvalidExtensionPluginError,
-                          QStringLiteral("Unknown collection authentication plugin: %1")
-                          .arg(authPluginName));
-        }
-
-        // perform the user input flow required to get the input key data which will be used
-        // to unlock this collection.
-        InteractionParameters promptParams;
-        promptParams.setApplicationId(callerApplicationId);
-        promptParams.setPluginName(identifier.storagePluginName());
-        promptParams.setCollectionName(identifier.collectionName());
-        promptParams.setSecretName(identifier.name());
-        promptParams.setOperation(InteractionParameters::StoreKey);
-        promptParams.setInputType(InteractionParameters::AlphaNumericInput);
-        promptParams.setEchoMode(InteractionParameters::PasswordEcho);
-        promptParams.setPromptText(promptText);
-        Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
-                    callerPid,
-                    requestId,
-                    promptParams,
-                    QString());
-        if (interactionResult.code() == Result::Failed) {
-            return interactionResult;
-        }
-
-        // calls useCollectionKeyPreCheckWithAuthenticationCode when finished
-        m_pendingRequests.insert(requestId,
-                                 Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                     callerPid,
-                                     requestId,
-                                     Daemon::ApiImpl::UseCollectionKeyPreCheckRequest,
-                                     QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
-                                                    << QVariant::fromValue<Sailfish::Crypto::CryptoManager::Operation>(operation)
-                                                    << cryptoPluginName
-                                                    << userInteractionMode
-                                                    << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-        return Result(Result::Pending);
+            return Result(Result::Pending);
+        });
     }
 
     const QString hashedCollectionName = calculateSecretNameHash(
@@ -5343,6 +6837,10 @@ Daemon::ApiImpl::RequestProcessor::useCollectionKeyPreCheckWithAuthenticationCod
         const CollectionMetadata &collectionMetadata,
         const QByteArray &authenticationCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     // TODO: we may need to automatically unlock the plugin if plugin is locked?
     Q_UNUSED(operation)
     Q_UNUSED(cryptoPluginName);
@@ -5363,29 +6861,7 @@ Daemon::ApiImpl::RequestProcessor::useCollectionKeyPreCheckWithAuthenticationCod
                       QStringLiteral("Unknown collection encryption plugin: %1").arg(collectionMetadata.encryptionPluginName));
     }
 
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
-            || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[collectionMetadata.encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    }
-
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
@@ -5398,8 +6874,25 @@ Daemon::ApiImpl::RequestProcessor::useCollectionKeyPreCheckWithAuthenticationCod
                         collectionMetadata,
                         dkr.key);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -5412,10 +6905,17 @@ Daemon::ApiImpl::RequestProcessor::useCollectionKeyPreCheckWithEncryptionKey(
         const CollectionMetadata &collectionMetadata,
         const QByteArray &collectionDecryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     Q_UNUSED(callerPid);
-    QFutureWatcher<Result> *watcher
-            = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
+    const auto completion = [=] (Result result) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(result);
+        outParams << QVariant::fromValue<QByteArray>(collectionDecryptionKey);
+        m_requestQueue->requestFinished(requestId, outParams);
+    };
     if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
         bool requiresRelock = !collectionDecryptionKey.isEmpty() &&
@@ -5423,34 +6923,26 @@ Daemon::ApiImpl::RequestProcessor::useCollectionKeyPreCheckWithEncryptionKey(
                   && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
                 || (collectionMetadata.usesDeviceLockKey
                   && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionSecretPreCheck,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    CollectionInfo(identifier.collectionName(),
-                                   collectionDecryptionKey,
-                                   requiresRelock),
-                    identifier.name(),
-                    false);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionSecretPreCheck,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              CollectionInfo(identifier.collectionName(),
+                                             collectionDecryptionKey,
+                                             requiresRelock),
+                              identifier.name(),
+                              false),
+                    completion);
     } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionSecretPreCheck,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    identifier.collectionName(),
-                    identifier.name(),
-                    false);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionSecretPreCheck,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier.collectionName(),
+                              identifier.name(),
+                              false),
+                    completion);
     }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result result = watcher->future().result();
-        QVariantList outParams;
-        outParams << QVariant::fromValue<Result>(result);
-        outParams << QVariant::fromValue<QByteArray>(collectionDecryptionKey);
-        m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
 }
 
 Result
@@ -5481,26 +6973,7 @@ Daemon::ApiImpl::RequestProcessor::setCollectionKeyPreCheck(
     }
 
     // Read the metadata about the target collection
-    QFutureWatcher<CollectionMetadataResult> *watcher
-            = new QFutureWatcher<CollectionMetadataResult>(this);
-    QFuture<CollectionMetadataResult> future;
-    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionMetadata,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    identifier.collectionName());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionMetadata,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    identifier.collectionName());
-    }
-
-    connect(watcher, &QFutureWatcher<CollectionMetadataResult>::finished, [=] {
-        watcher->deleteLater();
-        CollectionMetadataResult cmr = watcher->future().result();
+    const auto completion = [=] (CollectionMetadataResult cmr) {
         Result result = cmr.result.code() != Result::Succeeded
                 ? cmr.result
                 : setCollectionKeyPreCheckWithMetadata(
@@ -5515,8 +6988,22 @@ Daemon::ApiImpl::RequestProcessor::setCollectionKeyPreCheck(
             outParams << QVariant::fromValue<QByteArray>(QByteArray());
             m_requestQueue->requestFinished(requestId, outParams);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionMetadata,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionMetadata,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier.collectionName()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -5529,6 +7016,10 @@ Daemon::ApiImpl::RequestProcessor::setCollectionKeyPreCheckWithMetadata(
         SecretManager::UserInteractionMode userInteractionMode,
         const CollectionMetadata &collectionMetadata)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     const bool applicationIsPlatformApplication = m_appPermissions->applicationIsPlatformApplication(callerPid);
     const QString callerApplicationId = applicationIsPlatformApplication
                 ? m_appPermissions->platformApplicationId()
@@ -5567,99 +7058,92 @@ Daemon::ApiImpl::RequestProcessor::setCollectionKeyPreCheckWithMetadata(
     });
 
     if (m_encryptedStoragePlugins.contains(identifier.storagePluginName())) {
-        // TODO: make this asynchronous instead of blocking the main thread!
-        QFuture<LockedResult> future
-                = QtConcurrent::run(
-                        m_requestQueue->secretsThreadPool().data(),
-                        EncryptedStoragePluginFunctionWrapper::isCollectionLocked,
-                        m_encryptedStoragePlugins[identifier.storagePluginName()],
-                        identifier.collectionName());
-        future.waitForFinished();
-        LockedResult lr = future.result();
-        Result pluginResult = lr.result;
-        bool locked = lr.locked;
-        if (pluginResult.code() != Result::Succeeded) {
-            return pluginResult;
-        }
-        if (!locked) {
-            setCollectionKeyPreCheckWithEncryptionKey(
-                        callerPid,
-                        requestId,
-                        identifier,
-                        collectionMetadata,
-                        QByteArray());
-            return Result(Result::Pending);
-        }
+        return withCollectionLockState(
+                    requestId,
+                    identifier.storagePluginName(),
+                    identifier.collectionName(),
+                    QVariantList() << QVariant::fromValue<QByteArray>(QByteArray()),
+                    [=] (bool locked) -> Result {
+            if (!locked) {
+                setCollectionKeyPreCheckWithEncryptionKey(
+                            callerPid,
+                            requestId,
+                            identifier,
+                            collectionMetadata,
+                            QByteArray());
+                return Result(Result::Pending);
+            }
 
-        if (collectionMetadata.usesDeviceLockKey) {
-            // Perform a "verify" UI flow (if the user interaction mode allows).
-            // If that succeeds, unlock the collection with the stored devicelock key and continue.
-            if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
-                return Result(Result::CollectionIsLockedError,
-                              QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
-                              .arg(identifier.collectionName()));
+            if (collectionMetadata.usesDeviceLockKey) {
+                // Perform a "verify" UI flow (if the user interaction mode allows).
+                // If that succeeds, unlock the collection with the stored devicelock key and continue.
+                if (userInteractionMode == Sailfish::Secrets::SecretManager::PreventInteraction) {
+                    return Result(Result::CollectionIsLockedError,
+                                  QString::fromLatin1("Collection %1 is locked and requires device lock authentication")
+                                  .arg(identifier.collectionName()));
+                }
+
+                // always use the system authentication plugin for device lock authentication requests.
+                const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
+                        m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
+                                       : SecretManager::DefaultAuthenticationPluginName);
+                Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+                            callerPid,
+                            requestId,
+                            promptText);
+                if (result.code() == Result::Failed) {
+                    return result;
+                }
+
+                // calls setCollectionKeyPreCheckWithEncryptionKey when finished
+                m_pendingRequests.insert(requestId,
+                                         Daemon::ApiImpl::RequestProcessor::PendingRequest(
+                                             callerPid,
+                                             requestId,
+                                             Daemon::ApiImpl::SetCollectionKeyPreCheckRequest,
+                                             QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                                            << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
+                return result;
+            } else if (userInteractionMode == SecretManager::PreventInteraction) {
+                return Result(Result::OperationRequiresUserInteraction,
+                              QString::fromLatin1("Authentication plugin %1 requires user interaction")
+                              .arg(authPluginName));
+            } else if (!m_authenticationPlugins.contains(authPluginName)) {
+                return Result(Result::InvalidExtensionPluginError,
+                              QStringLiteral("Unknown collection authentication plugin: %1")
+                              .arg(authPluginName));
             }
 
-            // always use the system authentication plugin for device lock authentication requests.
-            const QString systemAuthenticationPlugin = m_requestQueue->controller()->mappedPluginName(
-                    m_autotestMode ? (SecretManager::DefaultAuthenticationPluginName + QLatin1String(".test"))
-                                   : SecretManager::DefaultAuthenticationPluginName);
-            Result result = m_authenticationPlugins[systemAuthenticationPlugin]->beginAuthentication(
+            // perform the user input flow required to get the input key data which will be used
+            // to unlock this collection.
+            InteractionParameters promptParams;
+            promptParams.setApplicationId(callerApplicationId);
+            promptParams.setPluginName(identifier.storagePluginName());
+            promptParams.setCollectionName(identifier.collectionName());
+            promptParams.setSecretName(identifier.name());
+            promptParams.setOperation(InteractionParameters::StoreKey);
+            promptParams.setInputType(InteractionParameters::AlphaNumericInput);
+            promptParams.setEchoMode(InteractionParameters::PasswordEcho);
+            promptParams.setPromptText(promptText);
+            Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
                         callerPid,
                         requestId,
-                        promptText);
-            if (result.code() == Result::Failed) {
-                return result;
+                        promptParams,
+                        QString());
+            if (interactionResult.code() == Result::Failed) {
+                return interactionResult;
             }
 
-            // calls setCollectionKeyPreCheckWithEncryptionKey when finished
             m_pendingRequests.insert(requestId,
                                      Daemon::ApiImpl::RequestProcessor::PendingRequest(
                                          callerPid,
                                          requestId,
                                          Daemon::ApiImpl::SetCollectionKeyPreCheckRequest,
                                          QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
+                                                        << userInteractionMode
                                                         << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-            return result;
-        } else if (userInteractionMode == SecretManager::PreventInteraction) {
-            return Result(Result::OperationRequiresUserInteraction,
-                          QString::fromLatin1("Authentication plugin %1 requires user interaction")
-                          .arg(authPluginName));
-        } else if (!m_authenticationPlugins.contains(authPluginName)) {
-            return Result(Result::InvalidExtensionPluginError,
-                          QStringLiteral("Unknown collection authentication plugin: %1")
-                          .arg(authPluginName));
-        }
-
-        // perform the user input flow required to get the input key data which will be used
-        // to unlock this collection.
-        InteractionParameters promptParams;
-        promptParams.setApplicationId(callerApplicationId);
-        promptParams.setPluginName(identifier.storagePluginName());
-        promptParams.setCollectionName(identifier.collectionName());
-        promptParams.setSecretName(identifier.name());
-        promptParams.setOperation(InteractionParameters::StoreKey);
-        promptParams.setInputType(InteractionParameters::AlphaNumericInput);
-        promptParams.setEchoMode(InteractionParameters::PasswordEcho);
-        promptParams.setPromptText(promptText);
-        Result interactionResult = m_authenticationPlugins[authPluginName]->beginUserInputInteraction(
-                    callerPid,
-                    requestId,
-                    promptParams,
-                    QString());
-        if (interactionResult.code() == Result::Failed) {
-            return interactionResult;
-        }
-
-        m_pendingRequests.insert(requestId,
-                                 Daemon::ApiImpl::RequestProcessor::PendingRequest(
-                                     callerPid,
-                                     requestId,
-                                     Daemon::ApiImpl::SetCollectionKeyPreCheckRequest,
-                                     QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
-                                                    << userInteractionMode
-                                                    << QVariant::fromValue<CollectionMetadata>(collectionMetadata)));
-        return Result(Result::Pending);
+            return Result(Result::Pending);
+        });
     }
 
     const QString hashedCollectionName = calculateSecretNameHash(
@@ -5755,6 +7239,10 @@ Daemon::ApiImpl::RequestProcessor::setCollectionKeyPreCheckWithAuthenticationCod
         const CollectionMetadata &collectionMetadata,
         const QByteArray &authenticationCode)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return Result(Result::Pending);
+    }
+
     Q_UNUSED(userInteractionMode); // TODO: we may need to automatically unlock the plugin if plugin is locked?
 
     // generate the encryption key from the authentication code
@@ -5772,29 +7260,7 @@ Daemon::ApiImpl::RequestProcessor::setCollectionKeyPreCheckWithAuthenticationCod
                       QStringLiteral("Unknown collection encryption plugin: %1").arg(collectionMetadata.encryptionPluginName));
     }
 
-    QFutureWatcher<DerivedKeyResult> *watcher
-            = new QFutureWatcher<DerivedKeyResult>(this);
-    QFuture<DerivedKeyResult> future;
-    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
-            || collectionMetadata.encryptionPluginName.isEmpty()) {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptionPluginFunctionWrapper::deriveKeyFromCode,
-                    m_encryptionPlugins[collectionMetadata.encryptionPluginName],
-                    authenticationCode,
-                    m_requestQueue->saltData());
-    }
-
-    connect(watcher, &QFutureWatcher<DerivedKeyResult>::finished, [=] {
-        watcher->deleteLater();
-        DerivedKeyResult dkr = watcher->future().result();
+    const auto completion = [=] (DerivedKeyResult dkr) {
         if (dkr.result.code() != Result::Succeeded) {
             QVariantList outParams;
             outParams << QVariant::fromValue<Result>(dkr.result);
@@ -5807,8 +7273,25 @@ Daemon::ApiImpl::RequestProcessor::setCollectionKeyPreCheckWithAuthenticationCod
                         collectionMetadata,
                         dkr.key);
         }
-    });
-    watcher->setFuture(future);
+    };
+    if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
+            || collectionMetadata.encryptionPluginName.isEmpty()) {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    } else {
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(collectionMetadata.encryptionPluginName).data(),
+                    std::bind(EncryptionPluginFunctionWrapper::deriveKeyFromCode,
+                              m_encryptionPlugins[collectionMetadata.encryptionPluginName],
+                              authenticationCode,
+                              m_requestQueue->saltData()),
+                    completion);
+    }
 
     return Result(Result::Pending);
 }
@@ -5821,10 +7304,17 @@ Daemon::ApiImpl::RequestProcessor::setCollectionKeyPreCheckWithEncryptionKey(
         const CollectionMetadata &collectionMetadata,
         const QByteArray &collectionDecryptionKey)
 {
+    if (m_requestQueue->expireInProgressRequest(requestId)) {
+        return;
+    }
+
     Q_UNUSED(callerPid);
-    QFutureWatcher<Result> *watcher
-            = new QFutureWatcher<Result>(this);
-    QFuture<Result> future;
+    const auto completion = [=] (Result result) {
+        QVariantList outParams;
+        outParams << QVariant::fromValue<Result>(result);
+        outParams << QVariant::fromValue<QByteArray>(collectionDecryptionKey);
+        m_requestQueue->requestFinished(requestId, outParams);
+    };
     if (identifier.storagePluginName() == collectionMetadata.encryptionPluginName
             || collectionMetadata.encryptionPluginName.isEmpty()) {
         bool requiresRelock = !collectionDecryptionKey.isEmpty() &&
@@ -5832,34 +7322,26 @@ Daemon::ApiImpl::RequestProcessor::setCollectionKeyPreCheckWithEncryptionKey(
                   && collectionMetadata.unlockSemantic != SecretManager::CustomLockKeepUnlocked)
                 || (collectionMetadata.usesDeviceLockKey
                   && collectionMetadata.unlockSemantic != SecretManager::DeviceLockKeepUnlocked));
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    EncryptedStoragePluginFunctionWrapper::collectionSecretPreCheck,
-                    m_encryptedStoragePlugins[identifier.storagePluginName()],
-                    CollectionInfo(identifier.collectionName(),
-                                   collectionDecryptionKey,
-                                   requiresRelock),
-                    identifier.name(),
-                    true);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(EncryptedStoragePluginFunctionWrapper::collectionSecretPreCheck,
+                              m_encryptedStoragePlugins[identifier.storagePluginName()],
+                              CollectionInfo(identifier.collectionName(),
+                                             collectionDecryptionKey,
+                                             requiresRelock),
+                              identifier.name(),
+                              true),
+                    completion);
     } else {
-        future = QtConcurrent::run(
-                    m_requestQueue->secretsThreadPool().data(),
-                    StoragePluginFunctionWrapper::collectionSecretPreCheck,
-                    m_storagePlugins[identifier.storagePluginName()],
-                    identifier.collectionName(),
-                    identifier.name(),
-                    true);
+        m_taskExecutor.run(
+                    m_requestQueue->pluginThreadPool(identifier.storagePluginName()).data(),
+                    std::bind(StoragePluginFunctionWrapper::collectionSecretPreCheck,
+                              m_storagePlugins[identifier.storagePluginName()],
+                              identifier.collectionName(),
+                              identifier.name(),
+                              true),
+                    completion);
     }
-
-    connect(watcher, &QFutureWatcher<Result>::finished, [=] {
-        watcher->deleteLater();
-        Result result = watcher->future().result();
-        QVariantList outParams;
-        outParams << QVariant::fromValue<Result>(result);
-        outParams << QVariant::fromValue<QByteArray>(collectionDecryptionKey);
-        m_requestQueue->requestFinished(requestId, outParams);
-    });
-    watcher->setFuture(future);
 }
 
 void
@@ -6001,6 +7483,38 @@ Daemon::ApiImpl::RequestProcessor::userInputInteractionCompleted(
                     }
                     break;
                 }
+                case GetCollectionSecretsRequest: {
+                    if (pr.parameters.size() != 4) {
+                        returnResult = Result(Result::UnknownError,
+                                              QLatin1String("Internal error: incorrect parameter count!"));
+                    } else {
+                        returnResult = getCollectionSecretsWithAuthenticationCode(
+                                    pr.callerPid,
+                                    pr.requestId,
+                                    pr.parameters.takeFirst().value<CollectionSecretsBatch>(),
+                                    static_cast<SecretManager::UserInteractionMode>(pr.parameters.takeFirst().value<int>()),
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<CollectionMetadata>(),
+                                    userInput);
+                    }
+                    break;
+                }
+                case SetCollectionSecretsRequest: {
+                    if (pr.parameters.size() != 4) {
+                        returnResult = Result(Result::UnknownError,
+                                              QLatin1String("Internal error: incorrect parameter count!"));
+                    } else {
+                        returnResult = setCollectionSecretsWithAuthenticationCode(
+                                    pr.callerPid,
+                                    pr.requestId,
+                                    pr.parameters.takeFirst().value<QVector<Secret> >(),
+                                    static_cast<SecretManager::UserInteractionMode>(pr.parameters.takeFirst().value<int>()),
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<CollectionMetadata>(),
+                                    userInput);
+                    }
+                    break;
+                }
                 case GetStandaloneSecretRequest: {
                     if (pr.parameters.size() != 4) {
                         returnResult = Result(Result::UnknownError,
@@ -6036,6 +7550,25 @@ Daemon::ApiImpl::RequestProcessor::userInputInteractionCompleted(
                     }
                     break;
                 }
+                case DeleteCollectionSecretsRequest: {
+                    if (pr.parameters.size() != 7) {
+                        returnResult = Result(Result::UnknownError,
+                                              QLatin1String("Internal error: incorrect parameter count!"));
+                    } else {
+                        returnResult = deleteCollectionSecretsWithAuthenticationCode(
+                                    pr.callerPid,
+                                    pr.requestId,
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<Secret::FilterData>(),
+                                    static_cast<SecretManager::FilterOperator>(pr.parameters.takeFirst().value<int>()),
+                                    static_cast<SecretManager::UserInteractionMode>(pr.parameters.takeFirst().value<int>()),
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<CollectionMetadata>(),
+                                    userInput);
+                    }
+                    break;
+                }
                 case DeleteCollectionRequest: {
                     if (pr.parameters.size() != 5) {
                         returnResult = Result(Result::UnknownError,
@@ -6290,6 +7823,40 @@ void Daemon::ApiImpl::RequestProcessor::authenticationCompleted(
                     }
                     break;
                 }
+                case GetCollectionSecretsRequest: {
+                    if (pr.parameters.size() != 4) {
+                        returnResult = Result(Result::UnknownError,
+                                              QLatin1String("Internal error: incorrect parameter count!"));
+                    } else {
+                        getCollectionSecretsWithEncryptionKey(
+                                    pr.callerPid,
+                                    pr.requestId,
+                                    pr.parameters.takeFirst().value<CollectionSecretsBatch>(),
+                                    static_cast<SecretManager::UserInteractionMode>(pr.parameters.takeFirst().value<int>()),
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<CollectionMetadata>(),
+                                    m_requestQueue->deviceLockKey());
+                        returnResult = Result(Result::Pending);
+                    }
+                    break;
+                }
+                case SetCollectionSecretsRequest: {
+                    if (pr.parameters.size() != 4) {
+                        returnResult = Result(Result::UnknownError,
+                                              QLatin1String("Internal error: incorrect parameter count!"));
+                    } else {
+                        setCollectionSecretsWithEncryptionKey(
+                                    pr.callerPid,
+                                    pr.requestId,
+                                    pr.parameters.takeFirst().value<QVector<Secret> >(),
+                                    static_cast<SecretManager::UserInteractionMode>(pr.parameters.takeFirst().value<int>()),
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<CollectionMetadata>(),
+                                    m_requestQueue->deviceLockKey());
+                        returnResult = Result(Result::Pending);
+                    }
+                    break;
+                }
                 case GetStandaloneSecretRequest: {
                     if (pr.parameters.size() != 4) {
                         returnResult = Result(Result::UnknownError,
@@ -6327,6 +7894,26 @@ void Daemon::ApiImpl::RequestProcessor::authenticationCompleted(
                     }
                     break;
                 }
+                case DeleteCollectionSecretsRequest: {
+                    if (pr.parameters.size() != 7) {
+                        returnResult = Result(Result::UnknownError,
+                                              QLatin1String("Internal error: incorrect parameter count!"));
+                    } else {
+                        deleteCollectionSecretsWithEncryptionKey(
+                                    pr.callerPid,
+                                    pr.requestId,
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<Secret::FilterData>(),
+                                    static_cast<SecretManager::FilterOperator>(pr.parameters.takeFirst().value<int>()),
+                                    static_cast<SecretManager::UserInteractionMode>(pr.parameters.takeFirst().value<int>()),
+                                    pr.parameters.takeFirst().value<QString>(),
+                                    pr.parameters.takeFirst().value<CollectionMetadata>(),
+                                    m_requestQueue->deviceLockKey());
+                        returnResult = Result(Result::Pending);
+                    }
+                    break;
+                }
                 case DeleteCollectionSecretRequest: {
                     if (pr.parameters.size() != 4) {
                         returnResult = Result(Result::UnknownError,
@@ -20,6 +20,10 @@
 #include <QtCore/QDateTime>
 #include <QtCore/QMultiMap>
 #include <QtCore/QTimer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QAtomicInt>
+
+#include <functional>
 
 #include <sys/types.h>
 
@@ -38,7 +42,9 @@
 #include "SecretsImpl/metadatadb_p.h"
 #include "SecretsImpl/applicationpermissions_p.h"
 
+#include "coalescedcalls_p.h"
 #include "requestqueue_p.h"
+#include "taskexecutor_p.h"
 
 #include "Crypto/cryptomanager.h"
 
@@ -60,6 +66,17 @@ namespace ApiImpl {
 
 class Controller;
 
+// The progress of a request for secrets from one or more collections.
+// Each collection is checked, unlocked and read from in turn, and the
+// batch is carried along with the asynchronous continuations.
+struct CollectionSecretsBatch {
+    CollectionSecretsBatch() : current(0) {}
+    QVector<QVector<Sailfish::Secrets::Secret::Identifier> > identifiers; // grouped by collection
+    QVector<QVector<int> > indexes; // of each identifier within the request
+    QVector<Sailfish::Secrets::Secret> secrets; // in request order
+    int current; // the collection being read
+};
+
 // The RequestProcessor implements the Secrets Daemon API.
 // It processes requests from clients which are forwarded
 // by the RequestQueue, by interacting with the database
@@ -74,7 +91,10 @@ public:
                      bool autotestMode,
                      Sailfish::Secrets::Daemon::ApiImpl::SecretsRequestQueue *parent = Q_NULLPTR);
 
-    bool initializePlugins();
+    void initializePlugins();
+
+    // forget a request which has been removed from the queue
+    void requestRemoved(quint64 requestId);
 
     // retrieve information about available plugins
     Sailfish::Secrets::Result getPluginInfo(
@@ -141,6 +161,15 @@ public:
             Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
             const QString &interactionServiceAddress);
 
+    // set multiple secrets in a collection
+    Sailfish::Secrets::Result setCollectionSecrets(
+            pid_t callerPid,
+            quint64 requestId,
+            const QVector<Sailfish::Secrets::Secret> &secrets,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            QVector<Sailfish::Secrets::Result> *results);
+
     // set a standalone DeviceLock-protected secret
     Sailfish::Secrets::Result setStandaloneDeviceLockSecret(
             pid_t callerPid,
@@ -175,6 +204,15 @@ public:
             const QString &interactionServiceAddress,
             Sailfish::Secrets::Secret *secret);
 
+    // get secrets from one or more collections
+    Sailfish::Secrets::Result getCollectionSecrets(
+            pid_t callerPid,
+            quint64 requestId,
+            const QVector<Sailfish::Secrets::Secret::Identifier> &identifiers,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            QVector<Sailfish::Secrets::Secret> *secrets);
+
     // get a standalone secret
     Sailfish::Secrets::Result getStandaloneSecret(
             pid_t callerPid,
@@ -215,6 +253,18 @@ public:
             Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
             const QString &interactionServiceAddress);
 
+    // delete the secrets in a collection which match a filter
+    Sailfish::Secrets::Result deleteCollectionSecrets(
+            pid_t callerPid,
+            quint64 requestId,
+            const QString &collectionName,
+            const QString &storagePluginName,
+            const Sailfish::Secrets::Secret::FilterData &filter,
+            Sailfish::Secrets::SecretManager::FilterOperator filterOperator,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            QVector<Sailfish::Secrets::Secret::Identifier> *identifiers);
+
     // delete a standalone secret
     Sailfish::Secrets::Result deleteStandaloneSecret(
             pid_t callerPid,
@@ -284,7 +334,7 @@ public: // helper methods for crypto API bridge (secretscryptohelpers)
     QStringList encryptedStoragePluginNames() const;
     QStringList storagePluginNames() const;
     QString displayNameForStoragePlugin(const QString &name) const;
-    QVector<Sailfish::Secrets::PluginInfo> storagePluginInfo() const;
+    void storagePluginInfo(const std::function<void (const QVector<Sailfish::Secrets::PluginInfo> &)> &callback) const;
     Sailfish::Secrets::Result storedKeyIdentifiers(
             pid_t callerPid,
             quint64 requestId,
@@ -403,6 +453,32 @@ private:
             const CollectionMetadata &collectionMetadata,
             const QByteArray &encryptionKey);
 
+    Sailfish::Secrets::Result setCollectionSecretsWithMetadata(
+            pid_t callerPid,
+            quint64 requestId,
+            const QVector<Sailfish::Secrets::Secret> &secrets,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const CollectionMetadata &collectionMetadata);
+
+    Sailfish::Secrets::Result setCollectionSecretsWithAuthenticationCode(
+            pid_t callerPid,
+            quint64 requestId,
+            const QVector<Sailfish::Secrets::Secret> &secrets,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const CollectionMetadata &collectionMetadata,
+            const QByteArray &authenticationCode);
+
+    void setCollectionSecretsWithEncryptionKey(
+            pid_t callerPid,
+            quint64 requestId,
+            const QVector<Sailfish::Secrets::Secret> &secrets,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const CollectionMetadata &collectionMetadata,
+            const QByteArray &encryptionKey);
+
     Sailfish::Secrets::Result setStandaloneDeviceLockSecretWithMetadata(
             pid_t callerPid,
             quint64 requestId,
@@ -474,6 +550,39 @@ private:
             const CollectionMetadata &collectionMetadata,
             const QByteArray &encryptionKey);
 
+    Sailfish::Secrets::Result getCollectionSecretsFromCollection(
+            pid_t callerPid,
+            quint64 requestId,
+            const Sailfish::Secrets::Daemon::ApiImpl::CollectionSecretsBatch &batch,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress);
+
+    Sailfish::Secrets::Result getCollectionSecretsWithMetadata(
+            pid_t callerPid,
+            quint64 requestId,
+            const Sailfish::Secrets::Daemon::ApiImpl::CollectionSecretsBatch &batch,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const CollectionMetadata &collectionMetadata);
+
+    Sailfish::Secrets::Result getCollectionSecretsWithAuthenticationCode(
+            pid_t callerPid,
+            quint64 requestId,
+            const Sailfish::Secrets::Daemon::ApiImpl::CollectionSecretsBatch &batch,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const CollectionMetadata &collectionMetadata,
+            const QByteArray &authenticationCode);
+
+    void getCollectionSecretsWithEncryptionKey(
+            pid_t callerPid,
+            quint64 requestId,
+            const Sailfish::Secrets::Daemon::ApiImpl::CollectionSecretsBatch &batch,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const CollectionMetadata &collectionMetadata,
+            const QByteArray &encryptionKey);
+
     Sailfish::Secrets::Result getStandaloneSecretWithMetadata(
             pid_t callerPid,
             quint64 requestId,
@@ -561,6 +670,41 @@ private:
             const CollectionMetadata &collectionMetadata,
             const QByteArray &encryptionKey);
 
+    Sailfish::Secrets::Result deleteCollectionSecretsWithMetadata(
+            pid_t callerPid,
+            quint64 requestId,
+            const QString &collectionName,
+            const QString &storagePluginName,
+            const Sailfish::Secrets::Secret::FilterData &filter,
+            Sailfish::Secrets::SecretManager::FilterOperator filterOperator,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const CollectionMetadata &collectionMetadata);
+
+    Sailfish::Secrets::Result deleteCollectionSecretsWithAuthenticationCode(
+            pid_t callerPid,
+            quint64 requestId,
+            const QString &collectionName,
+            const QString &storagePluginName,
+            const Sailfish::Secrets::Secret::FilterData &filter,
+            Sailfish::Secrets::SecretManager::FilterOperator filterOperator,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const CollectionMetadata &collectionMetadata,
+            const QByteArray &authenticationCode);
+
+    void deleteCollectionSecretsWithEncryptionKey(
+            pid_t callerPid,
+            quint64 requestId,
+            const QString &collectionName,
+            const QString &storagePluginName,
+            const Sailfish::Secrets::Secret::FilterData &filter,
+            Sailfish::Secrets::SecretManager::FilterOperator filterOperator,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode,
+            const QString &interactionServiceAddress,
+            const CollectionMetadata &collectionMetadata,
+            const QByteArray &encryptionKey);
+
     Sailfish::Secrets::Result deleteStandaloneSecretWithMetadata(
             pid_t callerPid,
             quint64 requestId,
@@ -694,6 +838,15 @@ private:
         QVariantList parameters;
     };
 
+    Sailfish::Secrets::Result withCollectionLockState(
+            quint64 requestId,
+            const QString &storagePluginName,
+            const QString &collectionName,
+            const QVariantList &outParams,
+            const std::function<Sailfish::Secrets::Result (bool)> &continuation);
+    void masterUnlockAllPlugins(quint64 requestId);
+    void reencryptMasterLockedPlugins(quint64 requestId, const QByteArray &oldLockCode, const QByteArray &oldBkdbLockKey, const QByteArray &oldDeviceLockKey);
+
     Sailfish::Secrets::Daemon::ApiImpl::SecretsRequestQueue *m_requestQueue;
     Sailfish::Secrets::Daemon::ApiImpl::ApplicationPermissions *m_appPermissions;
 
@@ -707,6 +860,8 @@ private:
     QMap<QString, QByteArray> m_collectionEncryptionKeys;
     QMap<QString, QByteArray> m_standaloneSecretEncryptionKeys;
     QMap<quint64, Sailfish::Secrets::Daemon::ApiImpl::RequestProcessor::PendingRequest> m_pendingRequests;
+    Sailfish::Secrets::Daemon::ApiImpl::CoalescedCalls m_coalescedCalls;
+    Sailfish::Secrets::Daemon::ApiImpl::TaskExecutor m_taskExecutor;
 
     bool m_autotestMode;
 };
@@ -719,4 +874,6 @@ private:
 
 } // namespace Sailfish
 
+Q_DECLARE_METATYPE(Sailfish::Secrets::Daemon::ApiImpl::CollectionSecretsBatch);
+
 #endif // SAILFISHSECRETS_APIIMPL_REQUESTPROCESSOR_P_H
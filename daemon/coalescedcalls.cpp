@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "coalescedcalls_p.h"
+#include "logging_p.h"
+
+using namespace Sailfish::Secrets;
+
+// Returns the not-yet-started invocation for the given key, with the given
+// request added to it.  If there is no such invocation, a new one is returned
+// and the caller must start it.
+QSharedPointer<Daemon::ApiImpl::CoalescedCalls::Call>
+Daemon::ApiImpl::CoalescedCalls::join(
+        const QString &key,
+        quint64 requestId,
+        bool *joined)
+{
+    QSharedPointer<Call> call = key.isEmpty()
+            ? QSharedPointer<Call>()
+            : m_calls.value(key);
+    if (call && !call->started.loadAcquire()) {
+        qCDebug(lcSailfishSecretsDaemon) << "Request" << requestId << "joining in-flight call:" << key;
+        call->requestIds.append(requestId);
+        m_requests.insert(requestId, call);
+        *joined = true;
+        return call;
+    }
+
+    call = QSharedPointer<Call>(new Call);
+    call->requestIds.append(requestId);
+    m_requests.insert(requestId, call);
+    if (!key.isEmpty()) {
+        m_calls.insert(key, call);
+    }
+    *joined = false;
+    return call;
+}
+
+// Returns the requests which are to be finished with the result of the
+// given invocation.
+QVector<quint64>
+Daemon::ApiImpl::CoalescedCalls::finish(
+        const QString &key,
+        const QSharedPointer<Call> &call)
+{
+    if (!key.isEmpty() && m_calls.value(key) == call) {
+        m_calls.remove(key);
+    }
+    for (quint64 requestId : call->requestIds) {
+        m_requests.remove(requestId);
+    }
+    return call->requestIds;
+}
+
+void Daemon::ApiImpl::CoalescedCalls::requestRemoved(quint64 requestId)
+{
+    const QSharedPointer<Call> call = m_requests.take(requestId);
+    if (call) {
+        call->requestIds.removeOne(requestId);
+    }
+}
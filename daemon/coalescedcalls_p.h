@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef SAILFISHSECRETS_DAEMON_COALESCEDCALLS_P_H
+#define SAILFISHSECRETS_DAEMON_COALESCEDCALLS_P_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QHash>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+namespace Daemon {
+
+namespace ApiImpl {
+
+// Tracks the plugin invocations whose result is shared by every request
+// which joined them.  Requests may only join an invocation until it starts
+// running in the plugin thread (which sets its started flag), so that the
+// shared result is never older than the joining request.  An empty key
+// means the request may not be coalesced with any other request.
+//
+// A request which is removed from the queue before the invocation it joined
+// has finished (e.g. because it was canceled or expired) is dropped from it,
+// so that it is not finished with the shared result.
+class CoalescedCalls
+{
+public:
+    struct Call {
+        Call() : started(0) {}
+        QAtomicInt started;
+        QVector<quint64> requestIds;
+    };
+
+    QSharedPointer<Call> join(const QString &key, quint64 requestId, bool *joined);
+    QVector<quint64> finish(const QString &key, const QSharedPointer<Call> &call);
+    void requestRemoved(quint64 requestId);
+
+    int count() const { return m_calls.size(); }
+
+private:
+    QHash<QString, QSharedPointer<Call> > m_calls;    // the latest invocation, per key.
+    QHash<quint64, QSharedPointer<Call> > m_requests; // the invocation awaited by each request.
+};
+
+} // ApiImpl
+
+} // Daemon
+
+} // Secrets
+
+} // Sailfish
+
+#endif // SAILFISHSECRETS_DAEMON_COALESCEDCALLS_P_H
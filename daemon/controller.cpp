@@ -18,9 +18,13 @@
 #include <QtCore/QDir>
 #include <QtCore/QStandardPaths>
 
-#include <QtConcurrent>
+#include <functional>
 
 namespace {
+    // how long (in milliseconds) the queried state of a plugin is reported
+    // without querying it again.
+    const qint64 PluginStateLifetime = 2000;
+
     QString p2pSocketAddress()
     {
         const QString path = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
@@ -46,7 +50,9 @@ Sailfish::Secrets::Daemon::Controller::Controller(bool autotestMode, QObject *pa
     : QObject(parent)
     , m_autotestMode(autotestMode)
     , m_isValid(false)
+    , m_pluginStateGeneration(0)
 {
+    m_pluginStateTimer.start();
     qRegisterMetaType<Sailfish::Secrets::Daemon::ApiImpl::CollectionMetadata>();
     qRegisterMetaType<Sailfish::Secrets::Daemon::ApiImpl::SecretMetadata>();
 
@@ -119,12 +125,16 @@ Sailfish::Secrets::Daemon::Controller::crypto() const
     return m_crypto;
 }
 
-QWeakPointer<QThreadPool> Sailfish::Secrets::Daemon::Controller::threadPoolForPlugin(const QString &pluginName) const
+QWeakPointer<QThreadPool> Sailfish::Secrets::Daemon::Controller::threadPoolForPlugin(
+        const QString &pluginName,
+        PluginOperationType operationType) const
 {
+    // crypto storage plugins share the pool of the storage plugin,
+    // so that operations on the stored keys are performed in order.
     if (m_secrets->potentialCryptoStoragePlugins().contains(pluginName)) {
-        return m_secrets->secretsThreadPool();
+        return m_secrets->pluginThreadPool(pluginName);
     } else if (m_crypto->plugins().contains(pluginName)) {
-        return m_crypto->cryptoThreadPool();
+        return m_crypto->pluginThreadPool(pluginName, operationType == StatelessPluginOperation);
     } else {
         return m_secrets->secretsThreadPool();
     }
@@ -218,49 +228,124 @@ QString Sailfish::Secrets::Daemon::Controller::mappedPluginName(const QString &p
     return pluginName;
 }
 
-QMap<QString, Sailfish::Secrets::PluginInfo>
+void
 Sailfish::Secrets::Daemon::Controller::pluginInfoForPlugins(
         QList<Sailfish::Secrets::PluginBase*> plugins,
-        bool masterLocked)
+        bool masterLocked,
+        const std::function<void (const QMap<QString, Sailfish::Secrets::PluginInfo> &)> &callback)
 {
-    QMap<QString, Sailfish::Secrets::PluginInfo> infos;
+    typedef QMap<QString, Sailfish::Secrets::PluginInfo> PluginInfoMap;
+
+    // the plugins whose state is already known are reported immediately.
+    const QSharedPointer<PluginInfoMap> infos(new PluginInfoMap);
+    QList<Sailfish::Secrets::PluginBase*> unknownPlugins;
     for (Sailfish::Secrets::PluginBase *plugin : plugins) {
-        // metadata reporting occurs in main thread
-        Sailfish::Secrets::PluginInfo::StatusFlags flags = Sailfish::Secrets::PluginInfo::Unknown;
-        if (plugin->supportsLocking()) {
-            flags |= Sailfish::Secrets::PluginInfo::PluginSupportsLocking;
-        }
-        if (plugin->supportsSetLockCode()) {
-            flags |= Sailfish::Secrets::PluginInfo::PluginSupportsSetLockCode;
-        }
-        if (!masterLocked) {
-            flags |= Sailfish::Secrets::PluginInfo::MasterUnlocked;
+        bool available = false;
+        bool locked = false;
+        if (cachedPluginState(plugin->name(), &available, &locked)) {
+            infos->insert(plugin->name(), pluginInfoForPlugin(plugin, masterLocked, available, locked));
+        } else {
+            unknownPlugins.append(plugin);
         }
+    }
 
-        // lock state and availability reporting occurs in plugin thread
-        // TODO: make this asynchronous instead of blocking the main thread!
-        QFuture<Sailfish::Secrets::Daemon::ApiImpl::PluginState> future
-                = QtConcurrent::run(
-                        threadPoolForPlugin(plugin->name()).data(),
-                        &Sailfish::Secrets::Daemon::ApiImpl::pluginState,
-                        plugin);
-        future.waitForFinished();
-        Sailfish::Secrets::Daemon::ApiImpl::PluginState ps = future.result();
-        if (ps.available) {
-            flags |= Sailfish::Secrets::PluginInfo::Available;
-        }
-        if (!ps.locked) {
-            flags |= Sailfish::Secrets::PluginInfo::PluginUnlocked;
-        }
+    if (unknownPlugins.isEmpty()) {
+        callback(*infos);
+        return;
+    }
+
+    // lock state and availability reporting occurs in the plugin threads,
+    // and the callback is invoked once every plugin has reported.
+    const quint64 generation = m_pluginStateGeneration;
+    const QSharedPointer<int> remaining(new int(unknownPlugins.size()));
+    for (Sailfish::Secrets::PluginBase *plugin : unknownPlugins) {
+        m_taskExecutor.run(
+                    threadPoolForPlugin(plugin->name()).data(),
+                    std::bind(&Sailfish::Secrets::Daemon::ApiImpl::pluginState,
+                              plugin),
+                    [=] (Sailfish::Secrets::Daemon::ApiImpl::PluginState ps) {
+            cachePluginState(plugin->name(), ps.available, ps.locked, generation);
+            infos->insert(plugin->name(), pluginInfoForPlugin(plugin, masterLocked, ps.available, ps.locked));
+            if (--(*remaining) == 0) {
+                callback(*infos);
+            }
+        });
+    }
+}
+
+bool
+Sailfish::Secrets::Daemon::Controller::cachedPluginState(
+        const QString &pluginName,
+        bool *available,
+        bool *locked) const
+{
+    QHash<QString, PluginStatus>::const_iterator it = m_pluginStates.constFind(pluginName);
+    if (it == m_pluginStates.constEnd()
+            || m_pluginStateTimer.elapsed() - it->cachedAt > PluginStateLifetime) {
+        return false;
+    }
 
-        infos.insert(plugin->name(),
-                     Sailfish::Secrets::PluginInfo(plugin->displayName(),
-                                                   plugin->name(),
-                                                   plugin->version(),
-                                                   flags));
+    *available = it->available;
+    *locked = it->locked;
+    return true;
+}
+
+void
+Sailfish::Secrets::Daemon::Controller::cachePluginState(
+        const QString &pluginName,
+        bool available,
+        bool locked,
+        quint64 generation)
+{
+    if (generation != m_pluginStateGeneration) {
+        // the state may have changed since it was queried.
+        return;
+    }
+
+    PluginStatus status;
+    status.available = available;
+    status.locked = locked;
+    status.cachedAt = m_pluginStateTimer.elapsed();
+    m_pluginStates.insert(pluginName, status);
+}
+
+void
+Sailfish::Secrets::Daemon::Controller::invalidatePluginStates()
+{
+    ++m_pluginStateGeneration;
+    m_pluginStates.clear();
+    emit pluginInfoChanged();
+}
+
+Sailfish::Secrets::PluginInfo
+Sailfish::Secrets::Daemon::Controller::pluginInfoForPlugin(
+        Sailfish::Secrets::PluginBase *plugin,
+        bool masterLocked,
+        bool available,
+        bool locked)
+{
+    // metadata reporting occurs in main thread
+    Sailfish::Secrets::PluginInfo::StatusFlags flags = Sailfish::Secrets::PluginInfo::Unknown;
+    if (plugin->supportsLocking()) {
+        flags |= Sailfish::Secrets::PluginInfo::PluginSupportsLocking;
+    }
+    if (plugin->supportsSetLockCode()) {
+        flags |= Sailfish::Secrets::PluginInfo::PluginSupportsSetLockCode;
+    }
+    if (!masterLocked) {
+        flags |= Sailfish::Secrets::PluginInfo::MasterUnlocked;
+    }
+    if (available) {
+        flags |= Sailfish::Secrets::PluginInfo::Available;
+    }
+    if (!locked) {
+        flags |= Sailfish::Secrets::PluginInfo::PluginUnlocked;
     }
 
-    return infos;
+    return Sailfish::Secrets::PluginInfo(plugin->displayName(),
+                                         plugin->name(),
+                                         plugin->version(),
+                                         flags);
 }
 
 void Sailfish::Secrets::Daemon::Controller::handleClientConnection(const QDBusConnection &connection)
@@ -18,10 +18,17 @@
 #include <QtCore/QString>
 #include <QtCore/QThreadPool>
 #include <QtCore/QSharedPointer>
+#include <QtCore/QMap>
+#include <QtCore/QHash>
+#include <QtCore/QElapsedTimer>
+
+#include <functional>
 
 #include <Secrets/Plugins/extensionplugins.h>
 #include <Secrets/plugininfo.h>
 
+#include "taskexecutor_p.h"
+
 // The environment variables which can be used to specify the name
 // of the default Crypto and Secrets plugins.
 // See Controller::mappedPluginName() for more information.
@@ -59,6 +66,12 @@ class Controller : public QObject
     Q_OBJECT
 
 public:
+    enum PluginOperationType {
+        StatefulPluginOperation = 0,    // must be performed in order with the other stateful operations.
+        StatelessPluginOperation        // may be performed concurrently, if the plugin is thread-safe,
+                                        // including with the stateful operations.
+    };
+
     Controller(bool autotest = false, QObject *parent = Q_NULLPTR);
     ~Controller();
 
@@ -67,23 +80,53 @@ public:
     Sailfish::Secrets::Daemon::ApiImpl::SecretsRequestQueue *secrets() const;
     Sailfish::Crypto::Daemon::ApiImpl::CryptoRequestQueue *crypto() const;
     QString mappedPluginName(const QString &pluginName) const;
-    QWeakPointer<QThreadPool> threadPoolForPlugin(const QString &pluginName) const;
+    QWeakPointer<QThreadPool> threadPoolForPlugin(
+            const QString &pluginName,
+            PluginOperationType operationType = StatefulPluginOperation) const;
     QString displayNameForPlugin(const QString &pluginName) const;
-    QMap<QString, Sailfish::Secrets::PluginInfo> pluginInfoForPlugins(
+    void pluginInfoForPlugins(
             QList<Sailfish::Secrets::PluginBase*> plugins,
-            bool masterLocked);
+            bool masterLocked,
+            const std::function<void (const QMap<QString, Sailfish::Secrets::PluginInfo> &)> &callback);
+    static Sailfish::Secrets::PluginInfo pluginInfoForPlugin(
+            Sailfish::Secrets::PluginBase *plugin,
+            bool masterLocked,
+            bool available,
+            bool locked);
+
+    // The availability and lock state of the plugins is remembered once
+    // it has been queried, for a short while or until the lock state of
+    // any plugin may have changed, as plugins can also be locked or become
+    // unavailable without a request being made to the daemon.
+    bool cachedPluginState(const QString &pluginName, bool *available, bool *locked) const;
+    void cachePluginState(const QString &pluginName, bool available, bool locked, quint64 generation);
+    quint64 pluginStateGeneration() const { return m_pluginStateGeneration; }
+    void invalidatePluginStates();
 
 public Q_SLOTS:
     void handleClientConnection(const QDBusConnection &connection);
 
+Q_SIGNALS:
+    void pluginInfoChanged();
+
 private:
+    struct PluginStatus {
+        bool available;
+        bool locked;
+        qint64 cachedAt;
+    };
+
     QDBusServer *m_dbusServer;
     Sailfish::Secrets::Daemon::DiscoveryObject *m_secretsDiscoveryObject;
     Sailfish::Crypto::Daemon::DiscoveryObject *m_cryptoDiscoveryObject;
     Sailfish::Secrets::Daemon::ApiImpl::SecretsRequestQueue *m_secrets;
     Sailfish::Crypto::Daemon::ApiImpl::CryptoRequestQueue *m_crypto;
+    Sailfish::Secrets::Daemon::ApiImpl::TaskExecutor m_taskExecutor;
     bool m_autotestMode;
     bool m_isValid;
+    QHash<QString, PluginStatus> m_pluginStates;
+    quint64 m_pluginStateGeneration;
+    QElapsedTimer m_pluginStateTimer;
 };
 
 } // namespace Daemon
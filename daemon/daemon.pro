@@ -27,16 +27,28 @@ packagesExist(nemonotifications-qt5) {
 }
 
 HEADERS += \
+    $$PWD/coalescedcalls_p.h \
     $$PWD/controller_p.h \
     $$PWD/discoveryobject_p.h \
+    $$PWD/latencyhistogram_p.h \
     $$PWD/logging_p.h \
     $$PWD/plugin_p.h \
-    $$PWD/requestqueue_p.h
+    $$PWD/pluginthreadpools_p.h \
+    $$PWD/requestqueue_p.h \
+    $$PWD/storedkeycache_p.h \
+    $$PWD/taskexecutor_p.h \
+    $$PWD/tracing_p.h
 
 SOURCES += \
+    $$PWD/coalescedcalls.cpp \
     $$PWD/controller.cpp \
+    $$PWD/latencyhistogram.cpp \
     $$PWD/plugin_p.cpp \
+    $$PWD/pluginthreadpools.cpp \
     $$PWD/requestqueue.cpp \
+    $$PWD/storedkeycache.cpp \
+    $$PWD/taskexecutor.cpp \
+    $$PWD/tracing.cpp \
     $$PWD/main.cpp
 
 include($$PWD/SecretsImpl/SecretsImpl.pri)
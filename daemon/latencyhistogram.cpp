@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "latencyhistogram_p.h"
+
+#include <QtCore/QtMath>
+
+using namespace Sailfish::Secrets;
+
+namespace {
+
+    // Each power of two is split into 2^SubBucketBits linear sub-buckets.
+    // Values smaller than 2 * SubBucketCount are recorded exactly.
+    const int SubBucketBits = 4;
+    const int SubBucketCount = 1 << SubBucketBits;
+
+    // Larger values (about 19 hours) are recorded as this value.
+    const qint64 MaximumTrackableValue = (Q_INT64_C(1) << 36) - 1;
+
+}
+
+Daemon::ApiImpl::LatencyHistogram::LatencyHistogram()
+    : m_count(0)
+    , m_minimum(0)
+    , m_maximum(0)
+    , m_sum(0)
+{
+}
+
+int Daemon::ApiImpl::LatencyHistogram::bucketIndex(qint64 value)
+{
+    if (value < 2 * SubBucketCount) {
+        return static_cast<int>(value);
+    }
+
+    int msb = 0;
+    while (value >> (msb + 1)) {
+        ++msb;
+    }
+    const int shift = msb - SubBucketBits;
+    return shift * SubBucketCount + static_cast<int>(value >> shift);
+}
+
+qint64 Daemon::ApiImpl::LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < 2 * SubBucketCount) {
+        return index;
+    }
+
+    const int shift = index / SubBucketCount - 1;
+    const qint64 subBucket = index - shift * SubBucketCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void Daemon::ApiImpl::LatencyHistogram::record(qint64 usecs)
+{
+    const qint64 value = qBound<qint64>(0, usecs, MaximumTrackableValue);
+    const int index = bucketIndex(value);
+    if (index >= m_buckets.size()) {
+        m_buckets.resize(index + 1);
+    }
+    m_buckets[index]++;
+
+    m_minimum = m_count ? qMin(m_minimum, value) : value;
+    m_maximum = qMax(m_maximum, value);
+    m_sum += value;
+    m_count++;
+}
+
+qint64 Daemon::ApiImpl::LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (!m_count) {
+        return 0;
+    }
+
+    // the value is reported as the upper bound of the bucket which holds it,
+    // as that never under-reports the latency of the requests it covers.
+    const qint64 rank = qMax<qint64>(1, qCeil(qBound(0.0, percentile, 100.0) / 100.0 * m_count));
+    qint64 seen = 0;
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        seen += m_buckets.at(i);
+        if (seen >= rank) {
+            return qBound(m_minimum, bucketUpperBound(i), m_maximum);
+        }
+    }
+    return m_maximum;
+}
+
+QVariantMap Daemon::ApiImpl::LatencyHistogram::toVariantMap() const
+{
+    QVariantMap map;
+    map.insert(QStringLiteral("count"), m_count);
+    map.insert(QStringLiteral("min"), minimum());
+    map.insert(QStringLiteral("max"), maximum());
+    map.insert(QStringLiteral("mean"), mean());
+    map.insert(QStringLiteral("p50"), valueAtPercentile(50.0));
+    map.insert(QStringLiteral("p90"), valueAtPercentile(90.0));
+    map.insert(QStringLiteral("p99"), valueAtPercentile(99.0));
+    map.insert(QStringLiteral("p999"), valueAtPercentile(99.9));
+    return map;
+}
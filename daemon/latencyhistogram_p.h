@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef SAILFISHSECRETS_DAEMON_LATENCYHISTOGRAM_P_H
+#define SAILFISHSECRETS_DAEMON_LATENCYHISTOGRAM_P_H
+
+#include <QtCore/QVector>
+#include <QtCore/QVariantMap>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+namespace Daemon {
+
+namespace ApiImpl {
+
+// Records a distribution of latencies (in microseconds) in log-linear
+// buckets, in the style of an HDR histogram: each power of two is split
+// into a fixed number of linear sub-buckets, so that the relative error of
+// any recorded value is bounded (by 1/16) regardless of its magnitude,
+// while the memory used grows only with the logarithm of the largest value.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(qint64 usecs);
+
+    qint64 count() const { return m_count; }
+    qint64 minimum() const { return m_count ? m_minimum : 0; }
+    qint64 maximum() const { return m_maximum; }
+    qint64 mean() const { return m_count ? m_sum / m_count : 0; }
+    qint64 valueAtPercentile(double percentile) const;
+
+    // count, min, max, mean, p50, p90, p99 and p999, in microseconds.
+    QVariantMap toVariantMap() const;
+
+private:
+    static int bucketIndex(qint64 value);
+    static qint64 bucketUpperBound(int index);
+
+    QVector<qint64> m_buckets; // grown on demand, up to the largest recorded bucket.
+    qint64 m_count;
+    qint64 m_minimum;
+    qint64 m_maximum;
+    qint64 m_sum;
+};
+
+} // ApiImpl
+
+} // Daemon
+
+} // Secrets
+
+} // Sailfish
+
+#endif // SAILFISHSECRETS_DAEMON_LATENCYHISTOGRAM_P_H
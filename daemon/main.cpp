@@ -13,6 +13,7 @@
 #include "controller_p.h"
 #include "logging_p.h"
 #include "plugin_p.h"
+#include "tracing_p.h"
 
 #include "Crypto/Plugins/extensionplugins.h"
 #include "Secrets/Plugins/extensionplugins.h"
@@ -54,9 +55,13 @@ Q_DECL_EXPORT int main(int argc, char *argv[])
                                                                                Sailfish::Secrets::EncryptionPlugin,
                                                                                Sailfish::Crypto::CryptoPlugin>();
 
+    Sailfish::Secrets::Daemon::ApiImpl::Tracer::startFromEnvironment();
+
+    int exitCode = 1;
     Sailfish::Secrets::Daemon::Controller controller(autotestMode);
     if (controller.isValid()) {
-        return app.exec();
+        exitCode = app.exec();
     }
-    return 1;
+    Sailfish::Secrets::Daemon::ApiImpl::Tracer::stop();
+    return exitCode;
 }
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "pluginthreadpools_p.h"
+
+#include <QtConcurrent>
+
+using namespace Sailfish::Secrets;
+
+void Daemon::ApiImpl::PluginThreadPools::addPlugin(const QString &pluginName)
+{
+    if (!m_pools.contains(pluginName)) {
+        QSharedPointer<QThreadPool> pool = QSharedPointer<QThreadPool>::create();
+        pool->setMaxThreadCount(1);
+        pool->setExpiryTimeout(-1);
+        m_pools.insert(pluginName, pool);
+    }
+}
+
+// Returns a null pointer for a plugin which was not added.
+QWeakPointer<QThreadPool> Daemon::ApiImpl::PluginThreadPools::pool(const QString &pluginName) const
+{
+    return m_pools.value(pluginName).toWeakRef();
+}
+
+QSharedPointer<Daemon::ApiImpl::PluginThreadPoolBarrier>
+Daemon::ApiImpl::PluginThreadPools::barrier() const
+{
+    QSharedPointer<Daemon::ApiImpl::PluginThreadPoolBarrier> barrier(
+            new Daemon::ApiImpl::PluginThreadPoolBarrier(m_pools.size()));
+    for (const QSharedPointer<QThreadPool> &pool : m_pools) {
+        QtConcurrent::run(pool.data(), [barrier] { barrier->block(); });
+    }
+    return barrier;
+}
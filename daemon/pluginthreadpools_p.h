@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef SAILFISHSECRETS_DAEMON_PLUGINTHREADPOOLS_P_H
+#define SAILFISHSECRETS_DAEMON_PLUGINTHREADPOOLS_P_H
+
+#include <QtCore/QHash>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWeakPointer>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+namespace Daemon {
+
+namespace ApiImpl {
+
+// Gives a task which operates on all plugins exclusive access to them.
+// The barrier is queued in every plugin thread pool, and holds each pool's
+// thread from when all previously queued operations have been performed
+// until the task has finished, so that operations queued afterwards
+// are performed after the task.
+class PluginThreadPoolBarrier
+{
+public:
+    class Scope
+    {
+    public:
+        Scope(const QSharedPointer<PluginThreadPoolBarrier> &barrier)
+            : m_barrier(barrier) { m_barrier->m_blocked.acquire(m_barrier->m_poolCount); }
+        ~Scope() { m_barrier->m_released.release(m_barrier->m_poolCount); }
+    private:
+        QSharedPointer<PluginThreadPoolBarrier> m_barrier;
+    };
+
+    PluginThreadPoolBarrier(int poolCount) : m_poolCount(poolCount) {}
+    void block() { m_blocked.release(); m_released.acquire(); }
+
+private:
+    int m_poolCount;
+    QSemaphore m_blocked;
+    QSemaphore m_released;
+};
+
+// Each plugin performs its operations in order, on a thread of its own,
+// so that the operations of different plugins are performed concurrently
+// while no plugin is used from more than one thread at a time.
+class PluginThreadPools
+{
+public:
+    void addPlugin(const QString &pluginName);
+    QWeakPointer<QThreadPool> pool(const QString &pluginName) const;
+    QSharedPointer<PluginThreadPoolBarrier> barrier() const;
+
+    int count() const { return m_pools.size(); }
+
+private:
+    QHash<QString, QSharedPointer<QThreadPool> > m_pools; // indexed by plugin name.
+};
+
+} // ApiImpl
+
+} // Daemon
+
+} // Secrets
+
+} // Sailfish
+
+#endif // SAILFISHSECRETS_DAEMON_PLUGINTHREADPOOLS_P_H
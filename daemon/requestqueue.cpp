@@ -6,32 +6,60 @@
  */
 
 #include "requestqueue_p.h"
+#include "tracing_p.h"
 #include "logging_p.h"
 
 #include "Secrets/secretsdaemonconnection_p.h"
 
 #include <QtCore/QElapsedTimer>
 
+#include <limits>
+
 #include <dbus/dbus.h>
 
 using namespace Sailfish::Secrets;
 
+namespace {
+
+    const int DefaultMaxClientRequests = 128;
+    const qint64 DefaultMaxClientQueuedBytes = 16 * 1024 * 1024;
+
+    // Bounds of the retry-after hint returned to busy clients, in msecs.
+    const int MinimumRetryAfter = 50;
+    const int MaximumRetryAfter = 5000;
+
+    qint64 limitFromEnvironment(const char *name, qint64 defaultValue)
+    {
+        bool ok = false;
+        const qint64 value = qgetenv(name).toLongLong(&ok);
+        return (ok && value > 0) ? value : defaultValue;
+    }
+
+}
+
 Daemon::ApiImpl::RequestQueue::RequestQueue(
         const QString &dbusObjectPath,
         const QString &dbusInterfaceName,
         Controller *parent,
         bool autotestMode)
     : QObject(parent)
+    , m_lastPipelineId(0)
+    , m_maxClientRequests(qMin<qint64>(limitFromEnvironment(ENV_MAX_CLIENT_REQUESTS, DefaultMaxClientRequests),
+                                       std::numeric_limits<int>::max()))
+    , m_maxClientQueuedBytes(limitFromEnvironment(ENV_MAX_CLIENT_QUEUED_BYTES, DefaultMaxClientQueuedBytes))
     , m_controller(parent)
     , m_dbusObjectPath(dbusObjectPath)
     , m_dbusInterfaceName(dbusInterfaceName)
+    , m_handleRequestsScheduled(false)
     , m_autotestMode(autotestMode)
 {
+    m_clock.start();
     qCDebug(lcSailfishSecretsDaemon) << "New API implementation request queue constructed:" << m_dbusObjectPath << "," << m_dbusInterfaceName;
 }
 
 Daemon::ApiImpl::RequestQueue::~RequestQueue()
 {
+    qDeleteAll(m_requests);
 }
 
 void Daemon::ApiImpl::RequestQueue::handleClientConnection(const QDBusConnection &connection)
@@ -47,6 +75,96 @@ void Daemon::ApiImpl::RequestQueue::handleClientConnection(const QDBusConnection
     } else {
         qCDebug(lcSailfishSecretsDaemon) << "Registered p2p object with the client connection!";
     }
+
+    // the client is forgotten as soon as its connection is closed, so that
+    // nothing is remembered about a process which has gone away.
+    if (!clientConnection.connect(QString(),
+                                  QStringLiteral("/org/freedesktop/DBus/Local"),
+                                  QStringLiteral("org.freedesktop.DBus.Local"),
+                                  QStringLiteral("Disconnected"),
+                                  this, SLOT(forgetClosedConnections()))) {
+        qCWarning(lcSailfishSecretsDaemon) << "Could not watch the p2p connection for disconnection!";
+    }
+
+    // in case a disconnection was not noticed.
+    forgetClosedConnections();
+}
+
+void Daemon::ApiImpl::RequestQueue::forgetClosedConnections()
+{
+    // forget the request numbering (and open pipelines) of connections which have been closed.
+    QHash<QString, Daemon::ApiImpl::RequestQueue::ClientConnection>::iterator it = m_clientConnections.begin();
+    while (it != m_clientConnections.end()) {
+        if (QDBusConnection(it.key()).isConnected()) {
+            ++it;
+        } else {
+            const QList<quint64> pipelineIds = it->pipelines.values();
+            const pid_t remotePid = it->remotePid;
+            it = m_clientConnections.erase(it);
+            for (quint64 pipelineId : pipelineIds) {
+                closePipeline(pipelineId);
+            }
+            if (remotePid) {
+                clientDisconnected(remotePid);
+            }
+        }
+    }
+}
+
+void Daemon::ApiImpl::RequestQueue::identifyClient(const QDBusConnection &connection, pid_t remotePid)
+{
+    // the identity of the client process is resolved once per connection,
+    // and forgotten when the connection is closed.
+    Daemon::ApiImpl::RequestQueue::ClientConnection &client(m_clientConnections[connection.name()]);
+    if (!client.remotePid) {
+        client.remotePid = remotePid;
+        clientConnected(remotePid);
+    }
+}
+
+quint64 Daemon::ApiImpl::RequestQueue::nextClientSequence(const QDBusConnection &connection)
+{
+    // Every method call received via the connection is numbered, whether or
+    // not it is enqueued, as the client numbers every call which it sends.
+    return ++m_clientConnections[connection.name()].sequence;
+}
+
+qint64 Daemon::ApiImpl::RequestQueue::nextClientDeadline(const QDBusConnection &connection)
+{
+    // The timeout set by the client applies to the request which follows
+    // it on the connection, and is measured from when that request arrives.
+    Daemon::ApiImpl::RequestQueue::ClientConnection &client(m_clientConnections[connection.name()]);
+    const int timeout = client.nextRequestTimeout;
+    client.nextRequestTimeout = 0;
+    return timeout > 0 ? m_clock.elapsed() + timeout : 0;
+}
+
+quint64 Daemon::ApiImpl::RequestQueue::nextClientPipeline(const QDBusConnection &connection)
+{
+    // The client tags each request of a pipeline with the id it chose for
+    // the pipeline, which is only meaningful on the client's connection.
+    // Requests which are not tagged never join a pipeline, even if they
+    // are sent via the same connection while a pipeline is open.
+    Daemon::ApiImpl::RequestQueue::ClientConnection &client(m_clientConnections[connection.name()]);
+    const quint64 clientPipelineId = client.nextRequestPipeline;
+    client.nextRequestPipeline = 0;
+    if (!clientPipelineId) {
+        return 0;
+    }
+
+    QHash<quint64, quint64>::const_iterator it = client.pipelines.constFind(clientPipelineId);
+    if (it != client.pipelines.constEnd()) {
+        return it.value();
+    }
+
+    quint64 pipelineId = ++m_lastPipelineId;
+    while (pipelineId == 0 || m_pipelines.contains(pipelineId)) {
+        pipelineId = ++m_lastPipelineId;
+    }
+    m_pipelines.insert(pipelineId, Daemon::ApiImpl::RequestQueue::Pipeline());
+    client.pipelines.insert(clientPipelineId, pipelineId);
+    qCDebug(lcSailfishSecretsDaemon) << "Beginning pipeline:" << pipelineId;
+    return pipelineId;
 }
 
 void Daemon::ApiImpl::RequestQueue::handleRequest(
@@ -57,14 +175,19 @@ void Daemon::ApiImpl::RequestQueue::handleRequest(
         Sailfish::Crypto::Result &returnResult)
 {
     // queue up a Sailfish Crypto API request
+    const quint64 sequence = nextClientSequence(connection);
+    const qint64 deadline = nextClientDeadline(connection);
+    const quint64 pipelineId = nextClientPipeline(connection);
     DBusConnection *internalConnection = static_cast<DBusConnection*>(connection.internalPointer());
     unsigned long dbusRemotePid = 0;
     dbus_bool_t gotPid = dbus_connection_get_unix_process_id(internalConnection, &dbusRemotePid);
     if (!gotPid) {
+        abortPipeline(pipelineId, 0);
         connection.send(message.createErrorReply(
                             QDBusError::Other,
                             QString::fromUtf8("Could not determine PID of caller to enforce access controls")));
     } else {
+        identifyClient(connection, (pid_t)dbusRemotePid);
         Daemon::ApiImpl::RequestQueue::RequestData *data = new Daemon::ApiImpl::RequestQueue::RequestData;
         data->connection = connection;
         data->remotePid = (pid_t)dbusRemotePid;
@@ -72,14 +195,20 @@ void Daemon::ApiImpl::RequestQueue::handleRequest(
         data->type = requestType;
         data->inParams = inParams;
         data->requestId = 0;
+        data->clientSequence = sequence;
+        data->deadline = deadline;
+        data->pipelineId = pipelineId;
         Result result = enqueueRequest(data);
         if (result.code() == Result::Succeeded) {
             data->message = message;
             message.setDelayedReply(true);
         } else {
             Sailfish::Crypto::Result transformedResult(Sailfish::Crypto::Result::Failed);
-            transformedResult.setErrorCode(Sailfish::Crypto::Result::DaemonError);
+            transformedResult.setErrorCode(result.errorCode() == Result::SecretsDaemonBusyError
+                                           ? Sailfish::Crypto::Result::DaemonBusyError
+                                           : Sailfish::Crypto::Result::DaemonError);
             transformedResult.setErrorMessage(result.errorMessage());
+            transformedResult.setRetryAfter(result.retryAfter());
             returnResult = transformedResult;
             delete data;
         }
@@ -94,14 +223,19 @@ void Daemon::ApiImpl::RequestQueue::handleRequest(
         Result &returnResult)
 {
     // queue up a Sailfish Secrets API request
+    const quint64 sequence = nextClientSequence(connection);
+    const qint64 deadline = nextClientDeadline(connection);
+    const quint64 pipelineId = nextClientPipeline(connection);
     DBusConnection *internalConnection = static_cast<DBusConnection*>(connection.internalPointer());
     unsigned long dbusRemotePid = 0;
     dbus_bool_t gotPid = dbus_connection_get_unix_process_id(internalConnection, &dbusRemotePid);
     if (!gotPid) {
+        abortPipeline(pipelineId, 0);
         connection.send(message.createErrorReply(
                             QDBusError::Other,
                             QString::fromUtf8("Could not determine PID of caller to enforce access controls")));
     } else {
+        identifyClient(connection, (pid_t)dbusRemotePid);
         Daemon::ApiImpl::RequestQueue::RequestData *data = new Daemon::ApiImpl::RequestQueue::RequestData;
         data->connection = connection;
         data->remotePid = (pid_t)dbusRemotePid;
@@ -109,6 +243,9 @@ void Daemon::ApiImpl::RequestQueue::handleRequest(
         data->type = requestType;
         data->inParams = inParams;
         data->requestId = 0;
+        data->clientSequence = sequence;
+        data->deadline = deadline;
+        data->pipelineId = pipelineId;
         Result result = enqueueRequest(data);
         if (result.code() == Result::Succeeded) {
             data->message = message;
@@ -144,41 +281,52 @@ void Daemon::ApiImpl::RequestQueue::handleRequest(
 
 Result Daemon::ApiImpl::RequestQueue::enqueueRequest(Daemon::ApiImpl::RequestQueue::RequestData *request)
 {
+    // Request ids are allocated monotonically, and are shared between
+    // the Secrets and Crypto request queues.  Zero is never a valid id.
     static quint64 requestId = 0;
 
-    // If no free request ids (i.e. queue is full) then return an error to the client.
-    quint64 prevId = requestId;
-    quint64 nextFreeId = ++requestId;
-    bool found = false;
-    for ( ; nextFreeId != prevId; ++nextFreeId) {
-        found = false;
-        if (m_enqueuingRequests.contains(nextFreeId)) {
-            // another enqueuing request is using this id.
-            found = true;
-        } else {
-            QList<Daemon::ApiImpl::RequestQueue::RequestData*>::const_iterator it = m_requests.constBegin();
-            while (it != m_requests.constEnd()) {
-                if ((*it)->requestId == nextFreeId) {
-                    // another current request is using this id.
-                    found = true;
-                    break;
-                }
-                it++;
-            }
-        }
-        if (!found) {
-            // no requests in the queue are using this id.  it is free to use.
-            break;
-        }
-    }
-
-    if (found) {
-        // all request ids are taken.  we cannot enqueue this request.
+    // If the request table is full then return an error to the client.
+    if (m_requests.size() == std::numeric_limits<int>::max()) {
         qCWarning(lcSailfishSecretsDaemon) << "Cannot enqueue request:" << requestTypeToString(request->type) << ": queue is full!";
+        abortPipeline(request->pipelineId, 0);
         return Result(Result::SecretsDaemonRequestQueueFullError,
                                          QString::fromUtf8("Request queue is full, try again later"));
     }
 
+    // Secrets requests performed as part of a Crypto request were
+    // admitted along with that Crypto request, so are not limited here.
+    request->payloadSize = 0;
+    for (const QVariant &parameter : request->inParams) {
+        request->payloadSize += parameterSize(parameter);
+    }
+    // the parameters may be consumed when the request is handled,
+    // so determine which plugin will perform the request up front.
+    request->pluginName = requestPluginName(request->type, request->inParams);
+    request->enqueueTime = elapsedUsecs();
+    const Daemon::ApiImpl::RequestQueue::ClientUsage usage = m_clientUsage.value(request->remotePid);
+    if (!request->isSecretsCryptoRequest && usage.requests > 0
+            && (usage.requests >= m_maxClientRequests
+                || usage.bytes + request->payloadSize > m_maxClientQueuedBytes)) {
+        // The client must wait for some of its requests to complete.
+        // Other clients are unaffected, as the limits are per-client.
+        qCWarning(lcSailfishSecretsDaemon) << "Cannot enqueue request:" << requestTypeToString(request->type)
+                                           << ": client" << request->remotePid << "is busy with"
+                                           << usage.requests << "requests," << usage.bytes << "bytes";
+        Result busyResult(Result::SecretsDaemonBusyError,
+                          QString::fromUtf8("Too many requests from this client are queued, try again later"));
+        busyResult.setRetryAfter(qBound(MinimumRetryAfter, usage.requests * 10, MaximumRetryAfter));
+        // the requests of the pipeline which have not been started cannot run without it.
+        abortPipeline(request->pipelineId, 0);
+        return busyResult;
+    }
+
+    // With a 64-bit id space the counter will not wrap in practice,
+    // but if it does, skip over any ids which are still in use.
+    quint64 nextFreeId = ++requestId;
+    while (nextFreeId == 0 || m_requests.contains(nextFreeId)) {
+        nextFreeId = ++requestId;
+    }
+
     if (request->isSecretsCryptoRequest) {
         qCDebug(lcSailfishSecretsDaemon) << "Enqueuing" << requestTypeToString(request->type)
                                          << "request with id:" << nextFreeId
@@ -189,7 +337,26 @@ Result Daemon::ApiImpl::RequestQueue::enqueueRequest(Daemon::ApiImpl::RequestQue
     }
 
     request->requestId = nextFreeId;
-    m_enqueuingRequests.insert(nextFreeId, request);
+    if (Daemon::ApiImpl::Tracer::isEnabled()) {
+        traceRequestEnqueued(request);
+    }
+    Daemon::ApiImpl::RequestQueue::ClientUsage &clientUsage(m_clientUsage[request->remotePid]);
+    clientUsage.requests++;
+    clientUsage.bytes += request->payloadSize;
+    // Secrets requests performed as part of a Crypto request are on the
+    // critical path of a request which has already been started, so
+    // they should not wait behind newly arrived requests.
+    request->priority = request->isSecretsCryptoRequest
+                      ? Daemon::ApiImpl::RequestQueue::InteractivePriority
+                      : requestPriority(request->type);
+    m_requests.insert(nextFreeId, request);
+    if (request->clientSequence) {
+        Daemon::ApiImpl::RequestQueue::ClientConnection &client(m_clientConnections[request->connection.name()]);
+        client.requests.insert(request->clientSequence, nextFreeId);
+    }
+    if (request->pipelineId) {
+        m_pipelines[request->pipelineId].liveStages++;
+    }
     // asynchronously append the request to the queue,
     // to avoid invalidating any iterators operating on it.
     QMetaObject::invokeMethod(this, "finishEnqueueRequest",
@@ -200,80 +367,649 @@ Result Daemon::ApiImpl::RequestQueue::enqueueRequest(Daemon::ApiImpl::RequestQue
 
 void Daemon::ApiImpl::RequestQueue::finishEnqueueRequest(quint64 requestId)
 {
-    if (!m_enqueuingRequests.contains(requestId)) {
-        // Should never happen, if it does it is always due to a bug in the request queue code.
-        qCWarning(lcSailfishSecretsDaemon) << "Unable to finish enqueuing request:" << requestId;
+    Daemon::ApiImpl::RequestQueue::RequestData *request = m_requests.value(requestId);
+    if (!request) {
+        // the client canceled the request before it was enqueued.
+        qCDebug(lcSailfishSecretsDaemon) << "Not enqueuing canceled request:" << requestId;
+        return;
+    }
+
+    if (request->pipelineId) {
+        // the requests of a pipeline are started one at a time.
+        admitPipelineStage(request);
         return;
     }
 
-    Daemon::ApiImpl::RequestQueue::RequestData *request = m_enqueuingRequests.take(requestId);
-    m_requests.append(request);
-    QMetaObject::invokeMethod(this, "handleRequests", Qt::QueuedConnection);
+    enqueuePendingRequest(request);
+    scheduleHandleRequests();
+}
+
+Daemon::ApiImpl::RequestQueue::RequestPriority
+Daemon::ApiImpl::RequestQueue::requestPriority(int type) const
+{
+    Q_UNUSED(type);
+    return Daemon::ApiImpl::RequestQueue::NormalPriority;
+}
+
+QVariant Daemon::ApiImpl::RequestQueue::timedOutResult() const
+{
+    return QVariant::fromValue<Result>(Result(Result::RequestTimedOutError,
+                                              QString::fromUtf8("The request could not be performed before its deadline")));
+}
+
+QString Daemon::ApiImpl::RequestQueue::requestPluginName(int type, const QVariantList &inParams) const
+{
+    Q_UNUSED(type);
+    Q_UNUSED(inParams);
+    return QString();
+}
+
+QVariant Daemon::ApiImpl::RequestQueue::pipelineAbortedResult() const
+{
+    return QVariant::fromValue<Result>(Result(Result::SecretsDaemonPipelineAbortedError,
+                                              QString::fromUtf8("A previous request of the pipeline failed")));
+}
+
+bool Daemon::ApiImpl::RequestQueue::isFailureResult(const QVariant &result) const
+{
+    return result.value<Result>().code() == Result::Failed;
+}
+
+void Daemon::ApiImpl::RequestQueue::clientConnected(pid_t pid)
+{
+    // nothing is remembered about the client process by default.
+    Q_UNUSED(pid);
+}
+
+void Daemon::ApiImpl::RequestQueue::clientDisconnected(pid_t pid)
+{
+    Q_UNUSED(pid);
+}
+
+void Daemon::ApiImpl::RequestQueue::requestRemoved(quint64 requestId)
+{
+    // called once the request has been replied to, canceled, expired
+    // or dropped, after which it can no longer be finished.
+    Q_UNUSED(requestId);
+}
+
+void Daemon::ApiImpl::RequestQueue::resultReplied(const QVariant &result)
+{
+    // called with the result of every request which is replied to.
+    Q_UNUSED(result);
+}
+
+void Daemon::ApiImpl::RequestQueue::sendReply(
+        Daemon::ApiImpl::RequestQueue::RequestData *request,
+        const QDBusMessage &reply)
+{
+    // The first argument of every reply is the result of the request,
+    // which determines whether the rest of its pipeline may be started.
+    request->succeeded = !isFailureResult(reply.arguments().value(0));
+    request->connection.send(reply);
+    resultReplied(reply.arguments().value(0));
+}
+
+qint64 Daemon::ApiImpl::RequestQueue::parameterSize(const QVariant &parameter) const
+{
+    switch (parameter.userType()) {
+        case QMetaType::QByteArray:  return parameter.toByteArray().size();
+        case QMetaType::QString:     return parameter.toString().size() * sizeof(QChar);
+        case QMetaType::QStringList: {
+            qint64 size = 0;
+            for (const QString &str : parameter.toStringList()) {
+                size += str.size() * sizeof(QChar);
+            }
+            return size;
+        }
+        default: break;
+    }
+    return 0;
+}
+
+void Daemon::ApiImpl::RequestQueue::recordStatistics(
+        const Daemon::ApiImpl::RequestQueue::RequestData *request,
+        qint64 finishTime)
+{
+    const qint64 inProgressTime = finishTime - request->startTime;
+    Daemon::ApiImpl::RequestQueue::RequestStatistics &stats(m_requestStatistics[request->type]);
+    stats.queued.record(request->startTime - request->enqueueTime);
+    stats.processing.record(request->processingTime);
+    stats.executing.record(inProgressTime - request->processingTime);
+    stats.total.record(finishTime - request->enqueueTime);
+    if (!request->pluginName.isEmpty()) {
+        m_pluginStatistics[request->pluginName].record(inProgressTime);
+    }
+}
+
+void Daemon::ApiImpl::RequestQueue::traceRequestEnqueued(
+        const Daemon::ApiImpl::RequestQueue::RequestData *request) const
+{
+    QVariantMap args;
+    args.insert(QStringLiteral("requestId"), request->requestId);
+    if (request->isSecretsCryptoRequest) {
+        args.insert(QStringLiteral("cryptoRequestId"), request->cryptoRequestId);
+    }
+    args.insert(QStringLiteral("queue"), m_dbusInterfaceName);
+    args.insert(QStringLiteral("pid"), static_cast<qint64>(request->remotePid));
+    args.insert(QStringLiteral("plugin"), request->pluginName);
+    const QString name = requestTypeToString(request->type);
+    Daemon::ApiImpl::Tracer::beginAsync("request", name, request->requestId, args);
+    if (request->isSecretsCryptoRequest) {
+        // link the handling of the Crypto request to this request.
+        Daemon::ApiImpl::Tracer::flowStart("request", name, request->requestId);
+    }
+}
+
+void Daemon::ApiImpl::RequestQueue::traceRequestHandled(
+        const Daemon::ApiImpl::RequestQueue::RequestData *request,
+        const char *stage,
+        qint64 traceStartTime) const
+{
+    const QString name = requestTypeToString(request->type);
+    if (request->isSecretsCryptoRequest && qstrcmp(stage, "start") == 0) {
+        Daemon::ApiImpl::Tracer::flowEnd("request", name, request->requestId);
+    }
+    Daemon::ApiImpl::Tracer::complete("request", name, traceStartTime,
+                                      QVariantMap { { QStringLiteral("stage"), QLatin1String(stage) } });
+}
+
+QVariantMap Daemon::ApiImpl::RequestQueue::statistics() const
+{
+    QVariantMap requests;
+    for (QHash<int, Daemon::ApiImpl::RequestQueue::RequestStatistics>::const_iterator it = m_requestStatistics.constBegin();
+            it != m_requestStatistics.constEnd(); ++it) {
+        QVariantMap stages;
+        stages.insert(QStringLiteral("queued"), it->queued.toVariantMap());
+        stages.insert(QStringLiteral("processing"), it->processing.toVariantMap());
+        stages.insert(QStringLiteral("executing"), it->executing.toVariantMap());
+        stages.insert(QStringLiteral("total"), it->total.toVariantMap());
+        requests.insert(requestTypeToString(it.key()), stages);
+    }
+
+    QVariantMap plugins;
+    for (QHash<QString, Daemon::ApiImpl::LatencyHistogram>::const_iterator it = m_pluginStatistics.constBegin();
+            it != m_pluginStatistics.constEnd(); ++it) {
+        plugins.insert(it.key(), it->toVariantMap());
+    }
+
+    QVariantMap queues;
+    queues.insert(QStringLiteral("interactive"), m_pendingRequests[InteractivePriority].count);
+    queues.insert(QStringLiteral("normal"), m_pendingRequests[NormalPriority].count);
+    queues.insert(QStringLiteral("bulk"), m_pendingRequests[BulkPriority].count);
+
+    QVariantMap statistics;
+    statistics.insert(QStringLiteral("requests"), requests);
+    statistics.insert(QStringLiteral("plugins"), plugins);
+    statistics.insert(QStringLiteral("queues"), queues);
+    return statistics;
+}
+
+void Daemon::ApiImpl::RequestQueue::setClientLimits(int maxRequests, qint64 maxQueuedBytes)
+{
+    m_maxClientRequests = qMax(1, maxRequests);
+    m_maxClientQueuedBytes = qMax<qint64>(1, maxQueuedBytes);
+}
+
+int Daemon::ApiImpl::RequestQueue::pendingRequestCount(
+        Daemon::ApiImpl::RequestQueue::RequestPriority priority) const
+{
+    if (priority < InteractivePriority || priority >= RequestPriorityCount) {
+        return 0;
+    }
+    return m_pendingRequests[priority].count;
+}
+
+void Daemon::ApiImpl::RequestQueue::enqueuePendingRequest(
+        const Daemon::ApiImpl::RequestQueue::RequestData *request)
+{
+    PendingRequests &pending(m_pendingRequests[request->priority]);
+    QQueue<quint64> &clientRequests(pending.requests[request->remotePid]);
+    if (clientRequests.isEmpty()) {
+        // the client had nothing pending in this class: it joins
+        // the back of the round-robin.
+        pending.clients.enqueue(request->remotePid);
+    }
+    clientRequests.enqueue(request->requestId);
+    pending.count++;
+}
+
+quint64 Daemon::ApiImpl::RequestQueue::dequeuePendingRequest()
+{
+    for (int priority = InteractivePriority; priority < RequestPriorityCount; ++priority) {
+        PendingRequests &pending(m_pendingRequests[priority]);
+        if (pending.clients.isEmpty()) {
+            continue;
+        }
+
+        // take the oldest request of the next client in the round-robin,
+        // and move that client to the back if it has more requests pending.
+        const pid_t clientPid = pending.clients.dequeue();
+        QHash<pid_t, QQueue<quint64> >::iterator it = pending.requests.find(clientPid);
+        const quint64 requestId = it->dequeue();
+        if (it->isEmpty()) {
+            pending.requests.erase(it);
+        } else {
+            pending.clients.enqueue(clientPid);
+        }
+        pending.count--;
+        return requestId;
+    }
+
+    return 0;
+}
+
+void Daemon::ApiImpl::RequestQueue::withdrawPendingRequest(
+        const Daemon::ApiImpl::RequestQueue::RequestData *request)
+{
+    PendingRequests &pending(m_pendingRequests[request->priority]);
+    QHash<pid_t, QQueue<quint64> >::iterator it = pending.requests.find(request->remotePid);
+    if (it == pending.requests.end() || !it->removeOne(request->requestId)) {
+        // not yet enqueued.
+        return;
+    }
+
+    pending.count--;
+    if (it->isEmpty()) {
+        pending.requests.erase(it);
+        pending.clients.removeOne(request->remotePid);
+    }
+}
+
+bool Daemon::ApiImpl::RequestQueue::hasPendingRequests() const
+{
+    for (int priority = InteractivePriority; priority < RequestPriorityCount; ++priority) {
+        if (m_pendingRequests[priority].count) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void Daemon::ApiImpl::RequestQueue::requestFinished(quint64 requestId, const QList<QVariant> &outParams)
 {
-    QList<Daemon::ApiImpl::RequestQueue::RequestData*>::iterator it = m_requests.begin();
-    while (it != m_requests.end()) {
-        if ((*it)->requestId == requestId) {
-            (*it)->status = Daemon::ApiImpl::RequestQueue::RequestFinished;
-            (*it)->outParams = outParams;
-            QMetaObject::invokeMethod(this, "handleRequests", Qt::QueuedConnection);
-            return;
+    Daemon::ApiImpl::RequestQueue::RequestData *request = m_requests.value(requestId);
+    if (request) {
+        if (request->status != Daemon::ApiImpl::RequestQueue::RequestFinished) {
+            request->status = Daemon::ApiImpl::RequestQueue::RequestFinished;
+            m_finishedRequests.enqueue(requestId);
         }
-        it++;
+        request->outParams = outParams;
+        scheduleHandleRequests();
+        return;
     }
 
     qCWarning(lcSailfishSecretsDaemon) << "Unable to finish unknown request:" << requestId;
 }
 
+Daemon::ApiImpl::RequestQueue::RequestData *
+Daemon::ApiImpl::RequestQueue::clientRequest(
+        const QDBusConnection &connection,
+        quint64 sequence,
+        const QString &method) const
+{
+    const quint64 requestId = m_clientConnections.value(connection.name()).requests.value(sequence);
+    Daemon::ApiImpl::RequestQueue::RequestData *request = m_requests.value(requestId);
+    // If the client's numbering of its requests does not match ours,
+    // it is safer to ignore the client than to act on another request.
+    return request && request->message.member() == method ? request : Q_NULLPTR;
+}
+
+void Daemon::ApiImpl::RequestQueue::cancelRequest(
+        const QDBusConnection &connection,
+        quint64 sequence,
+        const QString &method)
+{
+    Daemon::ApiImpl::RequestQueue::RequestData *request = clientRequest(connection, sequence, method);
+    if (!request) {
+        qCDebug(lcSailfishSecretsDaemon) << "Ignoring cancellation of unknown request:" << sequence << method;
+        return;
+    }
+
+    if (request->status == Daemon::ApiImpl::RequestQueue::RequestPending) {
+        // The request has not been started, so no work needs to be undone.
+        qCDebug(lcSailfishSecretsDaemon) << "Canceling pending request:" << request->requestId;
+        withdrawPendingRequest(request);
+        if (request->message.type() == QDBusMessage::MethodCallMessage && request->connection.isConnected()) {
+            request->connection.send(request->message.createErrorReply(
+                                         QDBusError::Other,
+                                         QString::fromUtf8("The request was canceled")));
+        }
+        removeRequest(request);
+    } else {
+        // The work need not be replied to, and is stopped early
+        // if it checks the cancellation flag of the request.
+        qCDebug(lcSailfishSecretsDaemon) << "Canceling in-progress request:" << request->requestId;
+        request->canceled = true;
+        if (request->cancellationFlag) {
+            request->cancellationFlag->storeRelease(1);
+        }
+    }
+}
+
+QSharedPointer<QAtomicInt> Daemon::ApiImpl::RequestQueue::cancellationFlag(quint64 requestId)
+{
+    Daemon::ApiImpl::RequestQueue::RequestData *request = m_requests.value(requestId);
+    if (!request) {
+        return QSharedPointer<QAtomicInt>::create(1);
+    }
+
+    if (!request->cancellationFlag) {
+        request->cancellationFlag = QSharedPointer<QAtomicInt>::create(request->canceled ? 1 : 0);
+    }
+    return request->cancellationFlag;
+}
+
+void Daemon::ApiImpl::RequestQueue::setNextRequestTimeout(
+        const QDBusConnection &connection,
+        int timeout)
+{
+    m_clientConnections[connection.name()].nextRequestTimeout = timeout;
+}
+
+bool Daemon::ApiImpl::RequestQueue::expireInProgressRequest(quint64 requestId)
+{
+    // A request whose deadline passes while it is in progress is failed
+    // before its next step is started, rather than once all of its steps
+    // have been performed.  The step which is under way is not interrupted.
+    Daemon::ApiImpl::RequestQueue::RequestData *request = m_requests.value(requestId);
+    if (!request || request->status != Daemon::ApiImpl::RequestQueue::RequestInProgress
+            || !request->deadline || m_clock.elapsed() < request->deadline) {
+        return false;
+    }
+
+    qCDebug(lcSailfishSecretsDaemon) << "Request" << request->requestId << "expired while in progress";
+    requestFinished(requestId, QList<QVariant>() << timedOutResult());
+    return true;
+}
+
+void Daemon::ApiImpl::RequestQueue::setNextRequestPipeline(
+        const QDBusConnection &connection,
+        quint64 clientPipelineId)
+{
+    m_clientConnections[connection.name()].nextRequestPipeline = clientPipelineId;
+}
+
+void Daemon::ApiImpl::RequestQueue::endPipeline(
+        const QDBusConnection &connection,
+        quint64 clientPipelineId)
+{
+    // The client has sent all of the requests of the pipeline.
+    QHash<QString, Daemon::ApiImpl::RequestQueue::ClientConnection>::iterator it
+            = m_clientConnections.find(connection.name());
+    const quint64 pipelineId = it != m_clientConnections.end() ? it->pipelines.take(clientPipelineId) : 0;
+    if (!pipelineId) {
+        qCDebug(lcSailfishSecretsDaemon) << "Ignoring end of unknown pipeline:" << clientPipelineId;
+        return;
+    }
+
+    closePipeline(pipelineId);
+}
+
+void Daemon::ApiImpl::RequestQueue::closePipeline(quint64 pipelineId)
+{
+    // The pipeline is forgotten once it has been closed and all of
+    // its requests have been replied to (or discarded).
+    QHash<quint64, Daemon::ApiImpl::RequestQueue::Pipeline>::iterator it = m_pipelines.find(pipelineId);
+    if (it != m_pipelines.end()) {
+        it->open = false;
+        if (it->liveStages <= 0) {
+            qCDebug(lcSailfishSecretsDaemon) << "Finished pipeline:" << pipelineId;
+            m_pipelines.erase(it);
+        }
+    }
+}
+
+void Daemon::ApiImpl::RequestQueue::admitPipelineStage(Daemon::ApiImpl::RequestQueue::RequestData *request)
+{
+    QHash<quint64, Daemon::ApiImpl::RequestQueue::Pipeline>::iterator it = m_pipelines.find(request->pipelineId);
+    if (it != m_pipelines.end() && it->aborted) {
+        failRequest(request, pipelineAbortedResult(), QDBusError::Other,
+                    QString::fromUtf8("A previous request of the pipeline failed"));
+    } else if (it != m_pipelines.end()) {
+        it->stages.enqueue(request->requestId);
+        releasePipelineStage(request->pipelineId);
+    }
+}
+
+void Daemon::ApiImpl::RequestQueue::releasePipelineStage(quint64 pipelineId)
+{
+    // Only the oldest request of the pipeline is ever in the pending queue,
+    // so the others cannot be started before it has finished.
+    QHash<quint64, Daemon::ApiImpl::RequestQueue::Pipeline>::iterator it = m_pipelines.find(pipelineId);
+    if (it == m_pipelines.end() || it->currentRequestId || it->stages.isEmpty()) {
+        return;
+    }
+
+    it->currentRequestId = it->stages.dequeue();
+    enqueuePendingRequest(m_requests.value(it->currentRequestId));
+    scheduleHandleRequests();
+}
+
+void Daemon::ApiImpl::RequestQueue::abortPipeline(quint64 pipelineId, quint64 failedRequestId)
+{
+    QHash<quint64, Daemon::ApiImpl::RequestQueue::Pipeline>::iterator it = m_pipelines.find(pipelineId);
+    if (it == m_pipelines.end()) {
+        return;
+    }
+
+    // The requests received before the failed one are unaffected, but the
+    // waiting requests received after it fail, as do any which join the
+    // pipeline later.  Request ids increase in the order of receipt, and
+    // a failed request id of zero means that it was never enqueued.
+    QQueue<quint64> stages;
+    QQueue<quint64>::iterator sit = it->stages.begin();
+    while (sit != it->stages.end()) {
+        if (*sit > failedRequestId) {
+            stages.enqueue(*sit);
+            sit = it->stages.erase(sit);
+        } else {
+            ++sit;
+        }
+    }
+    it->aborted = true;
+
+    // Failing a request may remove the pipeline, so it is not used again.
+    for (quint64 requestId : stages) {
+        Daemon::ApiImpl::RequestQueue::RequestData *request = m_requests.value(requestId);
+        if (request && !isClientConnected(request)) {
+            removeRequest(request);
+        } else if (request) {
+            qCDebug(lcSailfishSecretsDaemon) << "Failing request" << requestId << "of aborted pipeline:" << pipelineId;
+            failRequest(request, pipelineAbortedResult(), QDBusError::Other,
+                        QString::fromUtf8("A previous request of the pipeline failed"));
+        }
+    }
+}
+
+void Daemon::ApiImpl::RequestQueue::pipelineStageRemoved(quint64 pipelineId, quint64 requestId, bool succeeded)
+{
+    QHash<quint64, Daemon::ApiImpl::RequestQueue::Pipeline>::iterator it = m_pipelines.find(pipelineId);
+    if (it == m_pipelines.end()) {
+        return;
+    }
+
+    it->liveStages--;
+    it->stages.removeOne(requestId);
+    const bool wasCurrent = it->currentRequestId == requestId;
+    if (wasCurrent) {
+        it->currentRequestId = 0;
+    }
+
+    if (!succeeded) {
+        // the request failed, was canceled or expired, or its client went away.
+        abortPipeline(pipelineId, requestId);
+    } else if (wasCurrent) {
+        releasePipelineStage(pipelineId);
+    }
+
+    it = m_pipelines.find(pipelineId);
+    if (it != m_pipelines.end() && !it->open) {
+        closePipeline(pipelineId);
+    }
+}
+
+void Daemon::ApiImpl::RequestQueue::failRequest(
+        Daemon::ApiImpl::RequestQueue::RequestData *request,
+        const QVariant &result,
+        QDBusError::ErrorType errorType,
+        const QString &errorMessage)
+{
+    // Fail the request without starting it, using the normal reply
+    // path so that the client receives a well-formed reply.
+    bool completed = false;
+    request->status = Daemon::ApiImpl::RequestQueue::RequestFinished;
+    request->outParams = QList<QVariant>() << result;
+    handleFinishedRequest(request, &completed);
+    if (!completed && request->message.type() == QDBusMessage::MethodCallMessage) {
+        request->connection.send(request->message.createErrorReply(errorType, errorMessage));
+    }
+    removeRequest(request);
+}
+
+void Daemon::ApiImpl::RequestQueue::expireRequest(Daemon::ApiImpl::RequestQueue::RequestData *request)
+{
+    qCDebug(lcSailfishSecretsDaemon) << "Request" << request->requestId << "expired before it could be started";
+    failRequest(request, timedOutResult(), QDBusError::Timeout,
+                QString::fromUtf8("The request could not be started before its deadline"));
+}
+
+bool Daemon::ApiImpl::RequestQueue::isClientConnected(
+        const Daemon::ApiImpl::RequestQueue::RequestData *request) const
+{
+    // Only requests received via a client connection have a client to reply to.
+    return request->message.type() != QDBusMessage::MethodCallMessage
+            || request->connection.isConnected();
+}
+
+void Daemon::ApiImpl::RequestQueue::removeRequest(Daemon::ApiImpl::RequestQueue::RequestData *request)
+{
+    if (request->clientSequence) {
+        QHash<QString, Daemon::ApiImpl::RequestQueue::ClientConnection>::iterator cit
+                = m_clientConnections.find(request->connection.name());
+        if (cit != m_clientConnections.end()) {
+            cit->requests.remove(request->clientSequence);
+        }
+    }
+    QHash<pid_t, Daemon::ApiImpl::RequestQueue::ClientUsage>::iterator it = m_clientUsage.find(request->remotePid);
+    if (it != m_clientUsage.end()) {
+        it->bytes -= request->payloadSize;
+        if (--it->requests <= 0) {
+            m_clientUsage.erase(it);
+        }
+    }
+    if (Daemon::ApiImpl::Tracer::isEnabled()) {
+        Daemon::ApiImpl::Tracer::endAsync("request", requestTypeToString(request->type), request->requestId);
+    }
+    const quint64 requestId = request->requestId;
+    const quint64 pipelineId = request->pipelineId;
+    const bool succeeded = request->succeeded;
+    m_requests.remove(requestId);
+    delete request;
+    requestRemoved(requestId);
+
+    if (pipelineId) {
+        pipelineStageRemoved(pipelineId, requestId, succeeded);
+    }
+}
+
+void Daemon::ApiImpl::RequestQueue::scheduleHandleRequests()
+{
+    // Only one handleRequests() invocation needs to be outstanding at any
+    // time, as each pass handles every request which can make progress.
+    if (!m_handleRequestsScheduled) {
+        m_handleRequestsScheduled = true;
+        QMetaObject::invokeMethod(this, "handleRequests", Qt::QueuedConnection);
+    }
+}
+
 void Daemon::ApiImpl::RequestQueue::handleRequests()
 {
-    qCDebug(lcSailfishSecretsDaemon) << "have:" << m_requests.size() << "in queue.";
+    m_handleRequestsScheduled = false;
+    qCDebug(lcSailfishSecretsDaemon) << "have:" << m_requests.size() << "in queue,"
+                                     << m_pendingRequests[InteractivePriority].count << "interactive,"
+                                     << m_pendingRequests[NormalPriority].count << "normal,"
+                                     << m_pendingRequests[BulkPriority].count << "bulk pending,"
+                                     << m_finishedRequests.size() << "finished.";
     QElapsedTimer yieldTimer;
     yieldTimer.start();
-    bool completed = false;
-    QList<Daemon::ApiImpl::RequestQueue::RequestData*>::iterator it = m_requests.begin();
-    while (it != m_requests.end()) {
-        Daemon::ApiImpl::RequestQueue::RequestData *request = *it;
-        completed = false;
-        if (request->status == RequestPending) {
-            // This is a new request we haven't seen before.
-            // Track the peer connection (if we haven't already), and then handle the request.
-            //trackPeerConnection(request); // TODO: is this needed?
-            request->status = RequestInProgress;
-            handlePendingRequest(request, &completed);
-            if (completed) {
-                it = m_requests.erase(it);
-                delete request;
-            } else {
-                it++;
+
+    // Only the requests which can make progress are visited:
+    // requests which are in progress are not in either ready queue.
+    // Finished requests are replied to first, as doing so is cheap
+    // and releases the resources held by the request.  Pending requests
+    // are started in priority order, round-robin between clients.
+    while (!m_finishedRequests.isEmpty() || hasPendingRequests()) {
+        bool completed = false;
+        if (!m_finishedRequests.isEmpty()) {
+            Daemon::ApiImpl::RequestQueue::RequestData *request = m_requests.value(m_finishedRequests.dequeue());
+            if (request && request->status == RequestFinished
+                    && (request->canceled || !isClientConnected(request))) {
+                // Nobody is waiting for the response.
+                qCDebug(lcSailfishSecretsDaemon) << "Discarding the result of request:" << request->requestId;
+                removeRequest(request);
+            } else if (request && request->status == RequestFinished) {
+                // This (asynchronous) request is in Finished state.  We need to send the response.
+                const Daemon::ApiImpl::TraceContextScope traceContext(
+                        Daemon::ApiImpl::TraceContext(request->requestId, request->cryptoRequestId));
+                const qint64 traceStartTime = Daemon::ApiImpl::Tracer::isEnabled() ? Daemon::ApiImpl::Tracer::timestamp() : 0;
+                const qint64 handleTime = elapsedUsecs();
+                handleFinishedRequest(request, &completed);
+                const qint64 now = elapsedUsecs();
+                if (Daemon::ApiImpl::Tracer::isEnabled()) {
+                    traceRequestHandled(request, "finish", traceStartTime);
+                }
+                request->processingTime += now - handleTime;
+                if (completed) {
+                    recordStatistics(request, now);
+                    removeRequest(request);
+                } else {
+                    // wait for the request to be finished again.
+                    request->status = RequestInProgress;
+                }
             }
-        } else if (request->status == RequestFinished) {
-            // This (asynchronous) request is in Finished state.  We need to send the response.
-            handleFinishedRequest(request, &completed);
-            if (completed) {
-                it = m_requests.erase(it);
-                delete request;
-            } else {
-                it++;
+        } else {
+            Daemon::ApiImpl::RequestQueue::RequestData *request = m_requests.value(dequeuePendingRequest());
+            if (request && request->status == RequestPending && !isClientConnected(request)) {
+                // The client has gone away, so there is no point starting the request.
+                qCDebug(lcSailfishSecretsDaemon) << "Dropping request of disconnected client:" << request->requestId;
+                removeRequest(request);
+            } else if (request && request->status == RequestPending
+                    && request->deadline && m_clock.elapsed() >= request->deadline) {
+                // Nobody will be waiting for the result by the time it is available.
+                expireRequest(request);
+            } else if (request && request->status == RequestPending) {
+                // This is a new request we haven't seen before.
+                const Daemon::ApiImpl::TraceContextScope traceContext(
+                        Daemon::ApiImpl::TraceContext(request->requestId, request->cryptoRequestId));
+                const qint64 traceStartTime = Daemon::ApiImpl::Tracer::isEnabled() ? Daemon::ApiImpl::Tracer::timestamp() : 0;
+                request->status = RequestInProgress;
+                request->startTime = elapsedUsecs();
+                handlePendingRequest(request, &completed);
+                const qint64 now = elapsedUsecs();
+                if (Daemon::ApiImpl::Tracer::isEnabled()) {
+                    traceRequestHandled(request, "start", traceStartTime);
+                }
+                request->processingTime += now - request->startTime;
+                if (completed) {
+                    recordStatistics(request, now);
+                    removeRequest(request);
+                }
             }
-        } else if (request->status == RequestInProgress) {
-            // this request is already in progress.
-            it++;
         }
 
-        if (m_requests.size() && yieldTimer.elapsed() > 100) {
+        if (yieldTimer.elapsed() > 100
+                && (!m_finishedRequests.isEmpty() || hasPendingRequests())) {
             // If we've taken more than 100 msec to handle requests, then we should
             // yield to the event loop after queuing up another handleRequests event.
             // This ensures that we stay responsive to DBus requests even if we have
             // a large number of incoming client requests to handle.
-            QMetaObject::invokeMethod(this, "handleRequests", Qt::QueuedConnection);
+            scheduleHandleRequests();
             break;
         }
     }
 
-    // no more pending requests to handle, or yielding to event loop.
+    // no more ready requests to handle, or yielding to event loop.
     qint64 nsecs = yieldTimer.nsecsElapsed();
     qint64 msecs = ((nsecs / 1000000) % 1000);
     qint64 secs = ((nsecs / 1000000000) % 1000);
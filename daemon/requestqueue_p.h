@@ -10,15 +10,27 @@
 
 #include <QtDBus/QDBusConnection>
 #include <QtDBus/QDBusContext>
+#include <QtDBus/QDBusError>
 
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QQueue>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QAtomicInt>
 
 #include "controller_p.h"
+#include "latencyhistogram_p.h"
 
 #include "Secrets/result.h"
 #include "Crypto/result.h"
 
+// The environment variables which can be used to limit the amount of
+// work which a single client may have queued in the daemon at any time.
+#define ENV_MAX_CLIENT_REQUESTS "SAILFISH_SECRETSD_MAX_CLIENT_REQUESTS"
+#define ENV_MAX_CLIENT_QUEUED_BYTES "SAILFISH_SECRETSD_MAX_CLIENT_QUEUED_BYTES"
+
 // forward declare the QDBusConnection::internalPointer() return type.
 class DBusConnection;
 
@@ -44,23 +56,55 @@ public:
         RequestFinished
     };
 
+    // Requests are started in priority order: all pending interactive
+    // requests are started before any normal request, and all pending
+    // normal requests are started before any bulk request.
+    enum RequestPriority {
+        InteractivePriority = 0,
+        NormalPriority,
+        BulkPriority,
+        RequestPriorityCount
+    };
+
     struct RequestData {
         RequestData()
             : requestId(0)
             , remotePid(0)
             , type(0) // InvalidRequest
             , status(RequestPending)
+            , priority(NormalPriority)
+            , payloadSize(0)
+            , clientSequence(0)
+            , deadline(0)
+            , canceled(false)
+            , enqueueTime(0)
+            , startTime(0)
+            , processingTime(0)
             , connection(QString::fromUtf8("org.sailfishos.secrets.daemon.invalidConnection"))
+            , pipelineId(0)
+            , succeeded(false)
             , cryptoRequestId(0)
             , isSecretsCryptoRequest(false) {}
         quint64 requestId;
         pid_t remotePid;
         int type;
         RequestStatus status;
+        RequestPriority priority;
+        qint64 payloadSize;
+        quint64 clientSequence; // the number of the request on its client connection, or zero.
+        qint64 deadline;        // each step of the request must be started before this time on the queue's clock, if nonzero.
+        bool canceled;          // the client is no longer interested in the result.
+        QSharedPointer<QAtomicInt> cancellationFlag; // set on cancellation, for work which can stop early.
+        qint64 enqueueTime;     // when the request was enqueued, in usecs on the queue's clock.
+        qint64 startTime;       // when the request was started, in usecs on the queue's clock.
+        qint64 processingTime;  // the usecs spent handling the request on the main thread.
+        QString pluginName;     // the plugin which performs the request, if known.
         QList<QVariant> inParams;
         QList<QVariant> outParams;
         QDBusMessage message;
         QDBusConnection connection;
+        quint64 pipelineId;     // the pipeline of which the request is a stage, or zero.
+        bool succeeded;         // a reply reporting success has been sent to the client.
 
         // These are only set if the request is a Sailfish::Secrets request
         // which is being performed as part of a Sailfish::Crypto request.
@@ -96,10 +140,34 @@ public:
 
     Sailfish::Secrets::Result enqueueRequest(Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestData *request);
     void requestFinished(quint64 requestId, const QList<QVariant> &outParams);
+    void cancelRequest(const QDBusConnection &connection, quint64 sequence, const QString &method);
+    QSharedPointer<QAtomicInt> cancellationFlag(quint64 requestId);
+    void setNextRequestTimeout(const QDBusConnection &connection, int timeout);
+    bool expireInProgressRequest(quint64 requestId);
+    void setNextRequestPipeline(const QDBusConnection &connection, quint64 clientPipelineId);
+    void endPipeline(const QDBusConnection &connection, quint64 clientPipelineId);
+
+    QVariantMap statistics() const;
+
+    int pendingRequestCount(Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestPriority priority) const;
+
+    void setClientLimits(int maxRequests, qint64 maxQueuedBytes);
+    int maxClientRequests() const { return m_maxClientRequests; }
+    qint64 maxClientQueuedBytes() const { return m_maxClientQueuedBytes; }
 
     virtual void handlePendingRequest(Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestData *request, bool *completed) = 0;
     virtual void handleFinishedRequest(Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestData *request, bool *completed) = 0;
     virtual QString requestTypeToString(int type) const = 0;
+    virtual Sailfish::Secrets::Daemon::ApiImpl::RequestQueue::RequestPriority requestPriority(int type) const;
+    virtual qint64 parameterSize(const QVariant &parameter) const;
+    virtual QVariant timedOutResult() const;
+    virtual QString requestPluginName(int type, const QVariantList &inParams) const;
+    virtual QVariant pipelineAbortedResult() const;
+    virtual bool isFailureResult(const QVariant &result) const;
+    virtual void clientConnected(pid_t pid);
+    virtual void clientDisconnected(pid_t pid);
+    virtual void requestRemoved(quint64 requestId);
+    virtual void resultReplied(const QVariant &result);
 
 public Q_SLOTS:
     void handleRequests();
@@ -107,14 +175,111 @@ public Q_SLOTS:
 
 private Q_SLOTS:
     void finishEnqueueRequest(quint64 requestId);
+    void forgetClosedConnections();
+
+private:
+    // The pending requests of one priority class.  Each client (identified
+    // by its pid) has its own FIFO, and clients are served round-robin,
+    // so that one client cannot delay the requests of another client
+    // by enqueuing a large number of requests.
+    struct PendingRequests {
+        PendingRequests() : count(0) {}
+        QQueue<pid_t> clients;                // clients with pending requests, in service order.
+        QHash<pid_t, QQueue<quint64> > requests;
+        int count;
+    };
+
+    // The amount of work which one client has in the queue.
+    struct ClientUsage {
+        ClientUsage() : requests(0), bytes(0) {}
+        int requests;
+        qint64 bytes;
+    };
+
+    void scheduleHandleRequests();
+    void removeRequest(RequestData *request);
+    void enqueuePendingRequest(const RequestData *request);
+    quint64 dequeuePendingRequest();
+    bool hasPendingRequests() const;
+
+    // The requests received via one client connection.  Requests are
+    // numbered in the order in which they are received, which allows
+    // the client to refer to them (e.g. to cancel them) later.
+    struct ClientConnection {
+        ClientConnection() : sequence(0), nextRequestTimeout(0), nextRequestPipeline(0), remotePid(0) {}
+        quint64 sequence;                  // the number of the last request received.
+        int nextRequestTimeout;            // the timeout of the next request received, or zero.
+        quint64 nextRequestPipeline;       // the client's id of the pipeline of the next request received, or zero.
+        QHash<quint64, quint64> requests;  // live requests: number to request id.
+        QHash<quint64, quint64> pipelines; // open pipelines: client's pipeline id to pipeline id.
+        pid_t remotePid;                   // the process at the other end of the connection, once identified.
+    };
+
+    // The requests which a client tagged with the same pipeline id.  They
+    // are started one at a time, in the order in which they were received,
+    // each once the previous one has succeeded.  Once one of them fails,
+    // the remaining ones fail without being started.
+    struct Pipeline {
+        Pipeline() : currentRequestId(0), liveStages(0), open(true), aborted(false) {}
+        QQueue<quint64> stages;    // enqueued requests waiting for the current one, in order.
+        quint64 currentRequestId;  // the request which may be started or is in progress, or zero.
+        int liveStages;            // the requests of the pipeline which have not been removed.
+        bool open;                 // the client may still send requests which join the pipeline.
+        bool aborted;              // a request has failed, so the remaining ones must fail.
+    };
+
+    // The latencies of the requests of one type which have been replied to.
+    // Requests which are canceled, expire or whose client goes away are
+    // not recorded, as they were never (fully) performed.
+    struct RequestStatistics {
+        LatencyHistogram queued;     // from being enqueued until being started.
+        LatencyHistogram processing; // spent in handlePendingRequest() and handleFinishedRequest().
+        LatencyHistogram executing;  // in progress asynchronously, e.g. in a plugin or awaiting user input.
+        LatencyHistogram total;      // from being enqueued until being replied to.
+    };
+
+    qint64 elapsedUsecs() const { return m_clock.nsecsElapsed() / 1000; }
+    void recordStatistics(const RequestData *request, qint64 finishTime);
+    void traceRequestEnqueued(const RequestData *request) const;
+    void traceRequestHandled(const RequestData *request, const char *stage, qint64 traceStartTime) const;
+
+    void identifyClient(const QDBusConnection &connection, pid_t remotePid);
+    quint64 nextClientSequence(const QDBusConnection &connection);
+    RequestData *clientRequest(const QDBusConnection &connection, quint64 sequence, const QString &method) const;
+    void expireRequest(RequestData *request);
+    void failRequest(RequestData *request, const QVariant &result,
+                     QDBusError::ErrorType errorType, const QString &errorMessage);
+    void admitPipelineStage(RequestData *request);
+    void releasePipelineStage(quint64 pipelineId);
+    void abortPipeline(quint64 pipelineId, quint64 failedRequestId);
+    void pipelineStageRemoved(quint64 pipelineId, quint64 requestId, bool succeeded);
+    void closePipeline(quint64 pipelineId);
+    void withdrawPendingRequest(const RequestData *request);
+    bool isClientConnected(const RequestData *request) const;
+
+    PendingRequests m_pendingRequests[RequestPriorityCount]; // ready to be started, per priority class.
+    QHash<QString, ClientConnection> m_clientConnections;    // indexed by connection name.
+    QElapsedTimer m_clock;                                   // the clock against which deadlines and latencies are measured.
+    QHash<int, RequestStatistics> m_requestStatistics;       // indexed by request type.
+    QHash<QString, LatencyHistogram> m_pluginStatistics;     // from start to reply, indexed by plugin name.
+    QHash<pid_t, ClientUsage> m_clientUsage;
+    QHash<quint64, Pipeline> m_pipelines;                    // indexed by pipeline id.
+    quint64 m_lastPipelineId;
+    int m_maxClientRequests;
+    qint64 m_maxClientQueuedBytes;
 
 protected:
+    void sendReply(RequestData *request, const QDBusMessage &reply);
+    qint64 nextClientDeadline(const QDBusConnection &connection);
+    quint64 nextClientPipeline(const QDBusConnection &connection);
+
     Controller *m_controller;
     QObject *m_dbusObject;
     QString m_dbusObjectPath;
     QString m_dbusInterfaceName;
-    QList<RequestData*> m_requests;
-    QMap<quint64, RequestData*> m_enqueuingRequests;
+    QHash<quint64, RequestData*> m_requests;   // all live requests (enqueuing, queued or in progress), indexed by request id.
+    QQueue<quint64> m_finishedRequests;        // ready to be replied to, in completion order.
+    bool m_handleRequestsScheduled;
 
     bool m_autotestMode;
 };
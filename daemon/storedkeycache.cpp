@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "storedkeycache_p.h"
+#include "logging_p.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+using namespace Sailfish::Secrets;
+
+namespace {
+
+    // writes through a volatile pointer, so that the compiler cannot
+    // elide the zeroing of memory which is about to be freed.
+    void zeroMemory(char *data, int size)
+    {
+        volatile char *p = data;
+        for (int i = 0; i < size; ++i) {
+            p[i] = 0;
+        }
+    }
+
+    bool fieldMatches(const QString &pattern, const QString &value)
+    {
+        return pattern.isEmpty() || pattern == value;
+    }
+
+}
+
+Daemon::ApiImpl::StoredKeyCache::StoredKeyCache(int capacity)
+    : m_capacity(qMax(capacity, 1))
+    , m_generation(0)
+{
+}
+
+Daemon::ApiImpl::StoredKeyCache::~StoredKeyCache()
+{
+    clear();
+}
+
+bool Daemon::ApiImpl::StoredKeyCache::lookup(
+        const QString &applicationId,
+        const Secret::Identifier &identifier,
+        QByteArray *serializedKey,
+        Secret::FilterData *filterData)
+{
+    const CacheKey key(applicationId, identifier);
+    QMap<CacheKey, Entry>::const_iterator it = m_entries.constFind(key);
+    if (it == m_entries.constEnd()) {
+        return false;
+    }
+
+    m_recentlyUsed.removeOne(key);
+    m_recentlyUsed.append(key);
+    // a view of the locked memory, rather than an unlocked copy on the heap.
+    *serializedKey = QByteArray::fromRawData(it->data, it->size);
+    *filterData = it->filterData;
+    return true;
+}
+
+void Daemon::ApiImpl::StoredKeyCache::insert(
+        const QString &applicationId,
+        const Secret::Identifier &identifier,
+        const QByteArray &serializedKey,
+        const Secret::FilterData &filterData,
+        quint64 generation)
+{
+    if (generation != m_generation) {
+        // the key may have been modified or deleted since it was read.
+        return;
+    }
+
+    const CacheKey key(applicationId, identifier);
+    remove(key);
+    while (m_entries.size() >= m_capacity && !m_recentlyUsed.isEmpty()) {
+        remove(m_recentlyUsed.first());
+    }
+
+    Entry entry;
+    entry.size = serializedKey.size();
+    entry.data = static_cast<char*>(malloc(qMax(entry.size, 1)));
+    if (!entry.data) {
+        return;
+    }
+    if (mlock(entry.data, qMax(entry.size, 1)) < 0) {
+        qCWarning(lcSailfishSecretsDaemon) << "Warning: unable to mlock cached key memory!";
+    }
+    memcpy(entry.data, serializedKey.constData(), entry.size);
+    entry.filterData = filterData;
+
+    m_entries.insert(key, entry);
+    m_recentlyUsed.append(key);
+}
+
+void Daemon::ApiImpl::StoredKeyCache::invalidate(const Secret::Identifier &identifier)
+{
+    ++m_generation;
+
+    const QList<CacheKey> keys = m_entries.keys();
+    for (const CacheKey &key : keys) {
+        if (fieldMatches(identifier.storagePluginName(), key.second.storagePluginName())
+                && fieldMatches(identifier.collectionName(), key.second.collectionName())
+                && fieldMatches(identifier.name(), key.second.name())) {
+            remove(key);
+        }
+    }
+}
+
+void Daemon::ApiImpl::StoredKeyCache::clear()
+{
+    ++m_generation;
+
+    const QList<CacheKey> keys = m_entries.keys();
+    for (const CacheKey &key : keys) {
+        remove(key);
+    }
+}
+
+void Daemon::ApiImpl::StoredKeyCache::remove(const CacheKey &key)
+{
+    QMap<CacheKey, Entry>::iterator it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    zeroMemory(it->data, it->size);
+    munlock(it->data, qMax(it->size, 1));
+    free(it->data);
+    m_entries.erase(it);
+    m_recentlyUsed.removeOne(key);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef SAILFISHSECRETS_DAEMON_STOREDKEYCACHE_P_H
+#define SAILFISHSECRETS_DAEMON_STOREDKEYCACHE_P_H
+
+#include "Secrets/secret.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QPair>
+#include <QtCore/QString>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+namespace Daemon {
+
+namespace ApiImpl {
+
+// Caches the (serialized) keys which have been read from collections on
+// behalf of the Crypto API, so that an application which repeatedly uses
+// the same stored key need not have it read from storage every time.
+// Entries are held per application, in mlock()ed memory which is zeroed
+// when they are removed, and the least recently used entry is evicted
+// when the cache is full.  lookup() returns a view of that memory rather
+// than a copy, which is only valid until the cache is next modified, so
+// the key must be consumed (e.g. deserialized) immediately.
+//
+// An identifier with an empty name, collection name or storage plugin name
+// given to invalidate() matches any value of that field, so that every key
+// in a collection or a plugin (or every key) can be invalidated at once.
+// Every invalidation also advances the generation(), so that a key which
+// was read before an invalidation can be recognised and not be inserted.
+class StoredKeyCache
+{
+public:
+    enum { DefaultCapacity = 32 };
+
+    explicit StoredKeyCache(int capacity = DefaultCapacity);
+    ~StoredKeyCache();
+
+    bool lookup(const QString &applicationId,
+                const Sailfish::Secrets::Secret::Identifier &identifier,
+                QByteArray *serializedKey,
+                Sailfish::Secrets::Secret::FilterData *filterData);
+    void insert(const QString &applicationId,
+                const Sailfish::Secrets::Secret::Identifier &identifier,
+                const QByteArray &serializedKey,
+                const Sailfish::Secrets::Secret::FilterData &filterData,
+                quint64 generation);
+    void invalidate(const Sailfish::Secrets::Secret::Identifier &identifier);
+    void clear();
+
+    int count() const { return m_entries.size(); }
+    int capacity() const { return m_capacity; }
+    quint64 generation() const { return m_generation; }
+
+private:
+    typedef QPair<QString, Sailfish::Secrets::Secret::Identifier> CacheKey;
+    struct Entry {
+        char *data;
+        int size;
+        Sailfish::Secrets::Secret::FilterData filterData;
+    };
+
+    void remove(const CacheKey &key);
+
+    QMap<CacheKey, Entry> m_entries;
+    QList<CacheKey> m_recentlyUsed; // least recently used first.
+    int m_capacity;
+    quint64 m_generation;
+};
+
+} // ApiImpl
+
+} // Daemon
+
+} // Secrets
+
+} // Sailfish
+
+#endif // SAILFISHSECRETS_DAEMON_STOREDKEYCACHE_P_H
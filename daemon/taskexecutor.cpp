@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "taskexecutor_p.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEvent>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
+using namespace Sailfish::Secrets;
+
+namespace {
+
+    QEvent::Type completionEventType()
+    {
+        static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+        return type;
+    }
+
+}
+
+// The tasks whose functions have been performed, and which are waiting
+// for their completions to be invoked.  It is shared with the tasks, so
+// that a task which finishes after the executor was destroyed is deleted.
+struct Daemon::ApiImpl::TaskExecutor::CompletionQueue
+{
+    CompletionQueue(TaskExecutor *e)
+        : executor(e), first(Q_NULLPTR), last(Q_NULLPTR) {}
+
+    QMutex mutex;
+    TaskExecutor *executor;
+    Task *first;
+    Task *last;
+};
+
+void Daemon::ApiImpl::TaskExecutor::Task::run()
+{
+    {
+        const TraceContextScope traceContext(m_traceContext);
+        perform();
+    }
+
+    QMutexLocker locker(&m_completionQueue->mutex);
+    if (!m_completionQueue->executor) {
+        locker.unlock();
+        delete this;
+        return;
+    }
+
+    // only the first completed task needs to wake the executor,
+    // which completes every task queued by then.
+    m_next = Q_NULLPTR;
+    if (m_completionQueue->last) {
+        m_completionQueue->last->m_next = this;
+        m_completionQueue->last = this;
+    } else {
+        m_completionQueue->first = m_completionQueue->last = this;
+        QCoreApplication::postEvent(m_completionQueue->executor, new QEvent(completionEventType()));
+    }
+}
+
+Daemon::ApiImpl::TaskExecutor::TaskExecutor(QObject *parent)
+    : QObject(parent)
+    , m_completionQueue(new CompletionQueue(this))
+{
+}
+
+Daemon::ApiImpl::TaskExecutor::~TaskExecutor()
+{
+    QMutexLocker locker(&m_completionQueue->mutex);
+    m_completionQueue->executor = Q_NULLPTR;
+    Task *task = m_completionQueue->first;
+    m_completionQueue->first = m_completionQueue->last = Q_NULLPTR;
+    locker.unlock();
+
+    // the completions of these tasks will never be invoked, and any
+    // task which is still being performed is deleted once it has been.
+    while (task) {
+        Task *next = task->m_next;
+        delete task;
+        task = next;
+    }
+}
+
+void Daemon::ApiImpl::TaskExecutor::start(QThreadPool *pool, Task *task)
+{
+    if (task->m_completionQueue != m_completionQueue) {
+        task->m_completionQueue = m_completionQueue;
+    }
+    task->m_traceContext = Tracer::currentContext();
+    (pool ? pool : QThreadPool::globalInstance())->start(task);
+}
+
+void Daemon::ApiImpl::TaskExecutor::customEvent(QEvent *event)
+{
+    if (event->type() == completionEventType()) {
+        processCompletedTasks();
+    } else {
+        QObject::customEvent(event);
+    }
+}
+
+void Daemon::ApiImpl::TaskExecutor::processCompletedTasks()
+{
+    QMutexLocker locker(&m_completionQueue->mutex);
+    Task *task = m_completionQueue->first;
+    m_completionQueue->first = m_completionQueue->last = Q_NULLPTR;
+    locker.unlock();
+
+    while (task) {
+        Task *next = task->m_next;
+        // the task is recycled by complete(), so copy its context first.
+        const TraceContext context(task->m_traceContext);
+        const TraceContextScope traceContext(context);
+        task->complete();
+        task = next;
+    }
+}
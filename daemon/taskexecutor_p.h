@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef SAILFISHSECRETS_DAEMON_TASKEXECUTOR_P_H
+#define SAILFISHSECRETS_DAEMON_TASKEXECUTOR_P_H
+
+#include "tracing_p.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QRunnable>
+#include <QtCore/QThreadPool>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+#include <QtCore/QtAlgorithms>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+namespace Daemon {
+
+namespace ApiImpl {
+
+// Runs functions in a thread pool, and invokes a completion with the
+// result of each function in the thread of the executor.
+// Unlike QtConcurrent::run() with a QFutureWatcher, no QObject is
+// created per call: the function and the completion are moved into a
+// task which is recycled once the completion has been invoked, and
+// the tasks which finish in the meantime are handed back to the
+// thread of the executor together, by a single posted event.
+// Each task (and its recycling) belongs to the thread which calls run(),
+// which must be the thread of the executor.
+// The trace context current when run() is called is made current while
+// the function is performed and while the completion is invoked, so that
+// plugin calls are traced on behalf of the request which made them.
+class TaskExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TaskExecutor(QObject *parent = Q_NULLPTR);
+    ~TaskExecutor();
+
+    // Runs function() in the given pool, and then completion(result)
+    // in the thread of the executor.  The function must return a value.
+    template <typename Function, typename Completion>
+    void run(QThreadPool *pool, Function &&function, Completion &&completion);
+
+protected:
+    void customEvent(QEvent *event) Q_DECL_OVERRIDE;
+
+private:
+    struct CompletionQueue;
+
+    class Task : public QRunnable
+    {
+    public:
+        Task() : m_next(Q_NULLPTR) { setAutoDelete(false); }
+        virtual ~Task() {}
+
+        void run() Q_DECL_OVERRIDE;
+
+        virtual void perform() = 0;
+        virtual void complete() = 0; // invokes the completion, and recycles the task.
+
+        QSharedPointer<CompletionQueue> m_completionQueue;
+        TraceContext m_traceContext;
+        Task *m_next;
+    };
+
+    template <typename Function, typename Completion>
+    class FunctionTask : public Task
+    {
+    public:
+        typedef typename std::decay<decltype(std::declval<Function&>()())>::type ResultType;
+
+        FunctionTask() : m_functionSet(false), m_resultSet(false) {}
+        ~FunctionTask() { clear(); }
+
+        static FunctionTask *acquire()
+        {
+            QVector<FunctionTask*> &tasks = freeTasks().tasks;
+            return tasks.isEmpty() ? new FunctionTask : tasks.takeLast();
+        }
+
+        template <typename F, typename C>
+        void set(F &&function, C &&completion)
+        {
+            new (&m_function) Function(std::forward<F>(function));
+            new (&m_completion) Completion(std::forward<C>(completion));
+            m_functionSet = true;
+        }
+
+        void perform() Q_DECL_OVERRIDE
+        {
+            new (&m_result) ResultType(function()());
+            m_resultSet = true;
+        }
+
+        void complete() Q_DECL_OVERRIDE
+        {
+            completion()(std::move(result()));
+            clear();
+            QVector<FunctionTask*> &tasks = freeTasks().tasks;
+            if (tasks.size() < MaximumFreeTasks) {
+                tasks.append(this);
+            } else {
+                delete this;
+            }
+        }
+
+    private:
+        enum { MaximumFreeTasks = 16 };
+
+        struct FreeTasks {
+            ~FreeTasks() { qDeleteAll(tasks); }
+            QVector<FunctionTask*> tasks;
+        };
+
+        static FreeTasks &freeTasks()
+        {
+            static thread_local FreeTasks freeTasks;
+            return freeTasks;
+        }
+
+        Function &function() { return *reinterpret_cast<Function*>(&m_function); }
+        Completion &completion() { return *reinterpret_cast<Completion*>(&m_completion); }
+        ResultType &result() { return *reinterpret_cast<ResultType*>(&m_result); }
+
+        void clear()
+        {
+            if (m_resultSet) {
+                result().~ResultType();
+                m_resultSet = false;
+            }
+            if (m_functionSet) {
+                function().~Function();
+                completion().~Completion();
+                m_functionSet = false;
+            }
+        }
+
+        typename std::aligned_storage<sizeof(Function), alignof(Function)>::type m_function;
+        typename std::aligned_storage<sizeof(Completion), alignof(Completion)>::type m_completion;
+        typename std::aligned_storage<sizeof(ResultType), alignof(ResultType)>::type m_result;
+        bool m_functionSet;
+        bool m_resultSet;
+    };
+
+    void start(QThreadPool *pool, Task *task);
+    void processCompletedTasks();
+
+    QSharedPointer<CompletionQueue> m_completionQueue;
+};
+
+template <typename Function, typename Completion>
+void TaskExecutor::run(QThreadPool *pool, Function &&function, Completion &&completion)
+{
+    typedef FunctionTask<typename std::decay<Function>::type,
+                         typename std::decay<Completion>::type> TaskType;
+    TaskType *task = TaskType::acquire();
+    task->set(std::forward<Function>(function), std::forward<Completion>(completion));
+    start(pool, task);
+}
+
+} // ApiImpl
+
+} // Daemon
+
+} // Secrets
+
+} // Sailfish
+
+#endif // SAILFISHSECRETS_DAEMON_TASKEXECUTOR_P_H
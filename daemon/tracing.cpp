@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "tracing_p.h"
+#include "logging_p.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QTimer>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace Sailfish::Secrets;
+
+QAtomicInt Daemon::ApiImpl::Tracer::s_enabled;
+
+namespace {
+
+    // Events are appended to the buffer by the main thread and by the
+    // threads which call into plugins, and the buffer is written to the
+    // file periodically by the main thread, so that tracing does not add
+    // a write() to (and serialize) every traced operation.
+    const int TraceFlushInterval = 1000; // msecs
+
+    // Guards the buffer and the file pointer.
+    QMutex traceMutex;
+    QByteArray traceBuffer;
+    QFile *traceFile = Q_NULLPTR;
+    bool traceFileEmpty = true;
+    QTimer *traceFlushTimer = Q_NULLPTR;
+    QElapsedTimer traceClock;
+
+    thread_local Daemon::ApiImpl::TraceContext currentTraceContext;
+
+    QString traceId(quint64 id)
+    {
+        return QStringLiteral("0x") + QString::number(id, 16);
+    }
+
+    QVariantMap contextArgs(const Daemon::ApiImpl::TraceContext &context)
+    {
+        QVariantMap args;
+        if (context.requestId) {
+            args.insert(QStringLiteral("requestId"), context.requestId);
+        }
+        if (context.cryptoRequestId) {
+            args.insert(QStringLiteral("cryptoRequestId"), context.cryptoRequestId);
+        }
+        return args;
+    }
+
+    // Called on the main thread only, which owns the file.
+    void flushTraceBuffer()
+    {
+        QByteArray events;
+        QFile *file = Q_NULLPTR;
+        {
+            QMutexLocker locker(&traceMutex);
+            events.swap(traceBuffer);
+            file = traceFile;
+        }
+        if (file && !events.isEmpty()) {
+            file->write(events);
+            file->flush();
+        }
+    }
+
+}
+
+bool Daemon::ApiImpl::Tracer::start(const QString &fileName)
+{
+    QMutexLocker locker(&traceMutex);
+    if (traceFile) {
+        return false;
+    }
+
+    QFile *file = new QFile(fileName);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(lcSailfishSecretsDaemon) << "Unable to open trace file:" << fileName << ":" << file->errorString();
+        delete file;
+        return false;
+    }
+
+    // The closing bracket is optional in the trace event format, so the
+    // trace remains readable (up until the last flush) if the daemon is
+    // killed without stopping it.
+    file->write("[\n");
+    traceFile = file;
+    traceFileEmpty = true;
+    traceBuffer.clear();
+    traceClock.start();
+    s_enabled.store(1);
+    locker.unlock();
+
+    traceFlushTimer = new QTimer;
+    traceFlushTimer->setInterval(TraceFlushInterval);
+    QObject::connect(traceFlushTimer, &QTimer::timeout, flushTraceBuffer);
+    traceFlushTimer->start();
+
+    QVariantMap args;
+    args.insert(QStringLiteral("name"), QStringLiteral("main"));
+    writeEvent("M", "__metadata", QStringLiteral("thread_name"), 0,
+               QVariantMap { { QStringLiteral("args"), args } });
+    qCDebug(lcSailfishSecretsDaemon) << "Writing trace events to:" << fileName;
+    return true;
+}
+
+void Daemon::ApiImpl::Tracer::startFromEnvironment()
+{
+    const QString fileName = QString::fromLocal8Bit(qgetenv(ENV_TRACE_FILE));
+    if (!fileName.isEmpty()) {
+        start(fileName);
+    }
+}
+
+void Daemon::ApiImpl::Tracer::stop()
+{
+    s_enabled.store(0);
+    delete traceFlushTimer;
+    traceFlushTimer = Q_NULLPTR;
+
+    QByteArray events;
+    QFile *file = Q_NULLPTR;
+    {
+        QMutexLocker locker(&traceMutex);
+        events.swap(traceBuffer);
+        file = traceFile;
+        traceFile = Q_NULLPTR;
+    }
+    if (file) {
+        file->write(events);
+        file->write("\n]\n");
+        file->close();
+        delete file;
+    }
+}
+
+qint64 Daemon::ApiImpl::Tracer::timestamp()
+{
+    return traceClock.nsecsElapsed() / 1000;
+}
+
+Daemon::ApiImpl::TraceContext Daemon::ApiImpl::Tracer::currentContext()
+{
+    return currentTraceContext;
+}
+
+void Daemon::ApiImpl::Tracer::setCurrentContext(const Daemon::ApiImpl::TraceContext &context)
+{
+    currentTraceContext = context;
+}
+
+void Daemon::ApiImpl::Tracer::beginAsync(const char *category, const QString &name, quint64 id, const QVariantMap &args)
+{
+    if (isEnabled()) {
+        writeEvent("b", category, name, timestamp(),
+                   QVariantMap { { QStringLiteral("id"), traceId(id) },
+                                 { QStringLiteral("args"), args } });
+    }
+}
+
+void Daemon::ApiImpl::Tracer::instantAsync(const char *category, const QString &name, quint64 id, const QVariantMap &args)
+{
+    if (isEnabled()) {
+        writeEvent("n", category, name, timestamp(),
+                   QVariantMap { { QStringLiteral("id"), traceId(id) },
+                                 { QStringLiteral("args"), args } });
+    }
+}
+
+void Daemon::ApiImpl::Tracer::endAsync(const char *category, const QString &name, quint64 id, const QVariantMap &args)
+{
+    if (isEnabled()) {
+        writeEvent("e", category, name, timestamp(),
+                   QVariantMap { { QStringLiteral("id"), traceId(id) },
+                                 { QStringLiteral("args"), args } });
+    }
+}
+
+void Daemon::ApiImpl::Tracer::flowStart(const char *category, const QString &name, quint64 id)
+{
+    if (isEnabled()) {
+        writeEvent("s", category, name, timestamp(),
+                   QVariantMap { { QStringLiteral("id"), traceId(id) } });
+    }
+}
+
+void Daemon::ApiImpl::Tracer::flowEnd(const char *category, const QString &name, quint64 id)
+{
+    // bind to the enclosing slice, i.e. the handling of the request.
+    if (isEnabled()) {
+        writeEvent("f", category, name, timestamp(),
+                   QVariantMap { { QStringLiteral("id"), traceId(id) },
+                                 { QStringLiteral("bp"), QStringLiteral("e") } });
+    }
+}
+
+void Daemon::ApiImpl::Tracer::complete(const char *category, const QString &name, qint64 startTime, const QVariantMap &args)
+{
+    if (isEnabled()) {
+        QVariantMap allArgs(contextArgs(currentTraceContext));
+        for (QVariantMap::const_iterator it = args.constBegin(); it != args.constEnd(); ++it) {
+            allArgs.insert(it.key(), it.value());
+        }
+        writeEvent("X", category, name, startTime,
+                   QVariantMap { { QStringLiteral("dur"), timestamp() - startTime },
+                                 { QStringLiteral("args"), allArgs } });
+    }
+}
+
+void Daemon::ApiImpl::Tracer::writeEvent(
+        const char *phase,
+        const char *category,
+        const QString &name,
+        qint64 time,
+        const QVariantMap &event)
+{
+    QJsonObject object(QJsonObject::fromVariantMap(event));
+    object.insert(QStringLiteral("ph"), QLatin1String(phase));
+    object.insert(QStringLiteral("cat"), QLatin1String(category));
+    object.insert(QStringLiteral("name"), name);
+    object.insert(QStringLiteral("ts"), time);
+    object.insert(QStringLiteral("pid"), QCoreApplication::applicationPid());
+    object.insert(QStringLiteral("tid"), static_cast<qint64>(syscall(SYS_gettid)));
+    const QByteArray json = QJsonDocument(object).toJson(QJsonDocument::Compact);
+
+    QMutexLocker locker(&traceMutex);
+    if (traceFile) {
+        if (!traceFileEmpty) {
+            traceBuffer.append(",\n");
+        }
+        traceBuffer.append(json);
+        traceFileEmpty = false;
+    }
+}
+
+Daemon::ApiImpl::TraceSpan::~TraceSpan()
+{
+    if (m_function && Tracer::isEnabled()) {
+        Tracer::complete("plugin",
+                         m_pluginName.isEmpty()
+                                ? QString::fromLatin1(m_function)
+                                : m_pluginName + QLatin1String(": ") + QLatin1String(m_function),
+                         m_startTime,
+                         QVariantMap { { QStringLiteral("plugin"), m_pluginName } });
+    }
+}
+
+void Daemon::ApiImpl::TraceSpan::begin(const char *function, const QString &pluginName)
+{
+    m_function = function;
+    m_pluginName = pluginName;
+    m_startTime = Tracer::timestamp();
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef SAILFISHSECRETS_DAEMON_TRACING_P_H
+#define SAILFISHSECRETS_DAEMON_TRACING_P_H
+
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+#include <QtCore/QAtomicInt>
+
+// The environment variable which names the file to which trace events
+// are written.  Tracing is disabled unless it is set.
+#define ENV_TRACE_FILE "SAILFISH_SECRETSD_TRACE_FILE"
+
+namespace Sailfish {
+
+namespace Secrets {
+
+namespace Daemon {
+
+namespace ApiImpl {
+
+// The request on whose behalf the current thread is working.
+// Secrets requests performed as part of a Crypto request also
+// carry the id of that Crypto request.
+struct TraceContext {
+    TraceContext(quint64 r = 0, quint64 c = 0)
+        : requestId(r), cryptoRequestId(c) {}
+    quint64 requestId;
+    quint64 cryptoRequestId;
+};
+
+// Writes trace events in the Chrome trace event format (which can be
+// viewed with chrome://tracing or Perfetto) to a file.
+// Each request is an asynchronous span, identified by its request id,
+// from being enqueued until being replied to.  Its handling on the main
+// thread and the plugin calls made on its behalf are spans on the thread
+// which performed them, and carry the request id of the current context.
+// When tracing is disabled, every function returns after checking a flag.
+class Tracer
+{
+public:
+    static bool isEnabled() { return s_enabled.load(); }
+
+    static bool start(const QString &fileName);
+    static void startFromEnvironment();
+    static void stop();
+
+    static qint64 timestamp(); // in usecs since tracing was started.
+
+    static TraceContext currentContext();
+    static void setCurrentContext(const TraceContext &context);
+
+    static void beginAsync(const char *category, const QString &name, quint64 id, const QVariantMap &args = QVariantMap());
+    static void instantAsync(const char *category, const QString &name, quint64 id, const QVariantMap &args = QVariantMap());
+    static void endAsync(const char *category, const QString &name, quint64 id, const QVariantMap &args = QVariantMap());
+    static void flowStart(const char *category, const QString &name, quint64 id);
+    static void flowEnd(const char *category, const QString &name, quint64 id);
+    static void complete(const char *category, const QString &name, qint64 startTime, const QVariantMap &args = QVariantMap());
+
+private:
+    static void writeEvent(const char *phase, const char *category, const QString &name,
+                           qint64 time, const QVariantMap &event);
+
+    static QAtomicInt s_enabled;
+};
+
+// Makes the given context current on this thread for the lifetime of the scope.
+class TraceContextScope
+{
+public:
+    TraceContextScope(const TraceContext &context)
+        : m_enabled(Tracer::isEnabled())
+    {
+        if (m_enabled) {
+            m_previous = Tracer::currentContext();
+            Tracer::setCurrentContext(context);
+        }
+    }
+    ~TraceContextScope()
+    {
+        if (m_enabled) {
+            Tracer::setCurrentContext(m_previous);
+        }
+    }
+
+private:
+    bool m_enabled;
+    TraceContext m_previous;
+};
+
+// Records a call into a plugin, from entry until exit, on this thread.
+class TraceSpan
+{
+public:
+    template <typename Plugin>
+    TraceSpan(const char *function, const Plugin *plugin)
+        : m_function(Q_NULLPTR)
+        , m_startTime(0)
+    {
+        if (Tracer::isEnabled()) {
+            begin(function, plugin ? plugin->name() : QString());
+        }
+    }
+    ~TraceSpan();
+
+private:
+    void begin(const char *function, const QString &pluginName);
+
+    const char *m_function;
+    qint64 m_startTime;
+    QString m_pluginName;
+};
+
+} // ApiImpl
+
+} // Daemon
+
+} // Secrets
+
+} // Sailfish
+
+#endif // SAILFISHSECRETS_DAEMON_TRACING_P_H
@@ -54,6 +54,13 @@ static bool rollbackTransaction(QSqlDatabase &database)
     return execute(database, QString::fromLatin1("ROLLBACK TRANSACTION"));
 }
 
+static bool beginReadTransaction(QSqlDatabase &database)
+{
+    // A deferred transaction reads from the snapshot of the database
+    // which is current at its first read, until it ends.
+    return execute(database, QString::fromLatin1("BEGIN DEFERRED TRANSACTION"));
+}
+
 static bool finalizeTransaction(QSqlDatabase &database, bool success)
 {
     if (success) {
@@ -204,6 +211,15 @@ static bool configureDatabase(QSqlDatabase &database, const char *setupStatement
     return true;
 }
 
+static bool isInWalMode(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+    if (!query.exec(QLatin1String("PRAGMA journal_mode")) || !query.next()) {
+        return false;
+    }
+    return query.value(0).toString().compare(QLatin1String("wal"), Qt::CaseInsensitive) == 0;
+}
+
 static bool executeCreationStatements(QSqlDatabase &database, const char *createStatements[], int currentSchemaVersion)
 {
     for (int i = 0; i < lengthOf(createStatements); ++i) {
@@ -240,6 +256,31 @@ static bool prepareDatabase(
     return finalizeTransaction(database, success);
 }
 
+static bool prepareQuery(
+        const QSqlDatabase &database,
+        QHash<QString, QSqlQuery> *preparedQueries,
+        const QString &statement,
+        QSqlQuery *preparedQuery,
+        QString *errorText)
+{
+    QHash<QString, QSqlQuery>::const_iterator it = preparedQueries->constFind(statement);
+    if (it == preparedQueries->constEnd()) {
+        QSqlQuery query(database);
+        query.setForwardOnly(true);
+        if (!query.prepare(statement)) {
+            qCWarning(lcSailfishSecretsDaemonSqlite) << QString::fromLatin1("Failed to prepare query: %1\n%2")
+                    .arg(query.lastError().text())
+                    .arg(statement);
+            *errorText = query.lastError().text();
+            return false;
+        }
+        it = preparedQueries->insert(statement, query);
+    }
+
+    *preparedQuery = *it;
+    return true;
+}
+
 Database::Query::Query(const QSqlQuery &query)
     : m_query(query)
 {
@@ -259,11 +300,25 @@ void Database::Query::reportError(const char *text) const
 Database::Database()
     : m_mutex(QMutex::Recursive)
     , m_localeName(QLocale().name())
+    , m_readerCount(0)
+    , m_readerGeneration(0)
+    , m_readerSerial(0)
+    , m_walMode(false)
 {
 }
 
 Database::~Database()
 {
+    {
+        QMutexLocker locker(&m_readerMutex);
+        for (ReaderConnection *reader : m_idleReaders) {
+            closeReader(reader);
+        }
+        m_idleReaders.clear();
+    }
+
+    pruneThreadState(this);
+
     if (m_database.isValid() && m_database.isOpen()) {
         m_database.close();
     }
@@ -353,16 +408,61 @@ bool Database::open(
         }
     }
 
+    {
+        QMutexLocker readerLocker(&m_readerMutex);
+        m_walMode = isInWalMode(m_database);
+        m_databaseDriver = databaseDriver;
+        m_databaseFile = databaseFile;
+        m_connectionName = connectionName;
+        m_setupStatements.clear();
+        for (int i = 0; i < lengthOf(setupStatements); ++i) {
+            m_setupStatements.append(QByteArray(setupStatements[i]));
+        }
+    }
+
     qCDebug(lcSailfishSecretsDaemonSqlite) << "Opened secrets database:" << databaseFile << "Locale:" << m_localeName;
     return true;
 }
 
 void Database::close()
 {
+    {
+        // readers which are still in use are closed when they are released.
+        QMutexLocker locker(&m_readerMutex);
+        m_walMode = false;
+        ++m_readerGeneration;
+        for (ReaderConnection *reader : m_idleReaders) {
+            closeReader(reader);
+            --m_readerCount;
+        }
+        m_idleReaders.clear();
+    }
+
+    // the state of threads which are still using the database
+    // is discarded when they have finished.
+    pruneThreadState(this);
+
     m_preparedQueries.clear();
     m_database.close();
 }
 
+void Database::setSetupStatement(int index, const QByteArray &statement)
+{
+    QMutexLocker locker(&m_readerMutex);
+    if (index < 0 || index >= m_setupStatements.size()) {
+        qCWarning(lcSailfishSecretsDaemonSqlite) << "Invalid setup statement index:" << index;
+        return;
+    }
+
+    m_setupStatements[index] = statement;
+    ++m_readerGeneration;
+    for (ReaderConnection *reader : m_idleReaders) {
+        closeReader(reader);
+        --m_readerCount;
+    }
+    m_idleReaders.clear();
+}
+
 Database::operator QSqlDatabase &()
 {
     return m_database;
@@ -375,7 +475,8 @@ Database::operator QSqlDatabase const &() const
 
 QSqlError Database::lastError() const
 {
-    return m_database.lastError();
+    ReaderConnection *reader = currentReader();
+    return reader ? reader->database.lastError() : m_database.lastError();
 }
 
 bool Database::isOpen() const
@@ -392,10 +493,22 @@ bool Database::localized() const
 // should ever access the secrets database.
 bool Database::beginTransaction()
 {
+    if (currentReader()) {
+        // the reader connection cannot write, and writing through the writer
+        // connection while reading from a snapshot could deadlock.
+        qCWarning(lcSailfishSecretsDaemonSqlite) << "beginTransaction() called within a DatabaseReadLocker!";
+        return false;
+    }
+
+    beginWrite();
     int oldSemaphoreValue = m_transactionSemaphore.fetchAndAddAcquire(1);
     if (oldSemaphoreValue == 0) {
         // start a new "outer" transaction.
-        return ::beginTransaction(m_database);
+        if (!::beginTransaction(m_database)) {
+            endWrite();
+            return false;
+        }
+        return true;
     } else if (oldSemaphoreValue == 1) {
         // already in an "outer" transaction.  This is fine, and is
         // done within loadPlugins() code to minimize transactions on startup.
@@ -403,12 +516,19 @@ bool Database::beginTransaction()
     } else {
         // this is always an error, we don't allow recursive transactions.
         qCWarning(lcSailfishSecretsDaemonSqlite) << "Invalid semaphore value - beginTransaction() called too many times";
+        endWrite();
         return false;
     }
 }
 
 bool Database::commitTransaction()
 {
+    if (currentReader()) {
+        qCWarning(lcSailfishSecretsDaemonSqlite) << "commitTransaction() called within a DatabaseReadLocker!";
+        return false;
+    }
+
+    endWrite();
     int oldSemaphoreValue = m_transactionSemaphore.fetchAndAddAcquire(-1);
     if (oldSemaphoreValue == 1) {
         return ::commitTransaction(m_database);
@@ -424,6 +544,12 @@ bool Database::commitTransaction()
 
 bool Database::rollbackTransaction()
 {
+    if (currentReader()) {
+        qCWarning(lcSailfishSecretsDaemonSqlite) << "rollbackTransaction() called within a DatabaseReadLocker!";
+        return false;
+    }
+
+    endWrite();
     int oldSemaphoreValue = m_transactionSemaphore.fetchAndAddAcquire(-1);
     if (oldSemaphoreValue == 1) {
         return ::rollbackTransaction(m_database);
@@ -444,23 +570,187 @@ Database::Query Database::prepare(const char *statement, QString *errorText) con
 
 Database::Query Database::prepare(const QString &statement, QString *errorText) const
 {
-    QMutexLocker locker(accessMutex());
+    QSqlQuery query;
 
-    QHash<QString, QSqlQuery>::const_iterator it = m_preparedQueries.constFind(statement);
-    if (it == m_preparedQueries.constEnd()) {
-        QSqlQuery query(m_database);
-        query.setForwardOnly(true);
-        if (!query.prepare(statement)) {
-            qCWarning(lcSailfishSecretsDaemonSqlite) << QString::fromLatin1("Failed to prepare query: %1\n%2")
-                    .arg(query.lastError().text())
-                    .arg(statement);
-            *errorText = query.lastError().text();
+    // the reader connection is used by the current thread alone,
+    // and so are the queries which are prepared for it.
+    ReaderConnection *reader = currentReader();
+    if (reader) {
+        if (!prepareQuery(reader->database, &reader->preparedQueries, statement, &query, errorText)) {
             return Query(QSqlQuery());
         }
-        it = m_preparedQueries.insert(statement, query);
+        return Query(query);
+    }
+
+    QMutexLocker locker(accessMutex());
+    if (!prepareQuery(m_database, &m_preparedQueries, statement, &query, errorText)) {
+        return Query(QSqlQuery());
     }
 
-    return Query(*it);
+    return Query(query);
+}
+
+QVector<Database::ThreadState> &Database::threadStates()
+{
+    // a few databases at most are in use by any one thread at a time.
+    static thread_local QVector<ThreadState> states;
+    return states;
+}
+
+Database::ThreadState *Database::threadState(const Database *database, bool create)
+{
+    QVector<ThreadState> &states(threadStates());
+    for (ThreadState &state : states) {
+        if (state.database == database) {
+            return &state;
+        }
+    }
+
+    if (!create) {
+        return Q_NULLPTR;
+    }
+
+    const ThreadState state = { database, Q_NULLPTR, 0, 0 };
+    states.append(state);
+    return &states.last();
+}
+
+// The state is only kept while the current thread is reading or writing,
+// so that none is left behind for a database which is closed or destroyed
+// (whose address may be reused by another database).
+void Database::pruneThreadState(const Database *database)
+{
+    QVector<ThreadState> &states(threadStates());
+    for (int i = 0; i < states.size(); ++i) {
+        if (states[i].database == database) {
+            if (!states[i].reader && states[i].writeDepth == 0) {
+                states.remove(i);
+            }
+            return;
+        }
+    }
+}
+
+Database::ReaderConnection *Database::currentReader() const
+{
+    // once the current thread writes, it reads what it has written.
+    const ThreadState *state = threadState(this, false);
+    return state && state->writeDepth == 0 ? state->reader : Q_NULLPTR;
+}
+
+void Database::beginWrite()
+{
+    ++threadState(this, true)->writeDepth;
+}
+
+void Database::endWrite()
+{
+    ThreadState *state = threadState(this, false);
+    if (state && state->writeDepth > 0) {
+        --state->writeDepth;
+        pruneThreadState(this);
+    }
+}
+
+Database::ReaderConnection *Database::acquireReader()
+{
+    ThreadState *state = threadState(this, true);
+    if (state->reader) {
+        ++state->readDepth;
+        return state->reader;
+    } else if (state->writeDepth > 0) {
+        return Q_NULLPTR;
+    }
+    pruneThreadState(this);
+
+    QMutexLocker locker(&m_readerMutex);
+    if (!m_walMode) {
+        return Q_NULLPTR;
+    }
+
+    while (m_idleReaders.isEmpty() && m_readerCount >= MaximumReaderCount) {
+        m_readerReleased.wait(&m_readerMutex);
+        if (!m_walMode) {
+            return Q_NULLPTR;
+        }
+    }
+
+    ReaderConnection *reader = m_idleReaders.isEmpty() ? openReader() : m_idleReaders.takeLast();
+    if (!reader) {
+        return Q_NULLPTR;
+    }
+    locker.unlock();
+
+    if (!beginReadTransaction(reader->database)) {
+        locker.relock();
+        closeReader(reader);
+        --m_readerCount;
+        m_readerReleased.wakeOne();
+        return Q_NULLPTR;
+    }
+
+    state = threadState(this, true);
+    state->reader = reader;
+    state->readDepth = 1;
+    return reader;
+}
+
+void Database::releaseReader(ReaderConnection *reader)
+{
+    ThreadState *state = threadState(this, false);
+    if (!state || state->reader != reader || --state->readDepth > 0) {
+        return;
+    }
+
+    state->reader = Q_NULLPTR;
+    pruneThreadState(this);
+    ::commitTransaction(reader->database);
+
+    QMutexLocker locker(&m_readerMutex);
+    if (reader->generation == m_readerGeneration) {
+        m_idleReaders.append(reader);
+    } else {
+        closeReader(reader);
+        --m_readerCount;
+    }
+    m_readerReleased.wakeOne();
+}
+
+// Called with the reader mutex locked.
+Database::ReaderConnection *Database::openReader()
+{
+    ReaderConnection *reader = new ReaderConnection;
+    reader->connectionName = QString::fromLatin1("%1-reader-%2").arg(m_connectionName).arg(++m_readerSerial);
+    reader->generation = m_readerGeneration;
+    reader->database = QSqlDatabase::addDatabase(m_databaseDriver, reader->connectionName);
+    reader->database.setDatabaseName(m_databaseFile);
+
+    QVector<const char *> setupStatements;
+    for (const QByteArray &statement : m_setupStatements) {
+        setupStatements.append(statement.constData());
+    }
+    setupStatements.append(Q_NULLPTR);
+
+    QString localeName(m_localeName);
+    if (!reader->database.open()
+            || !configureDatabase(reader->database, setupStatements.data(), localeName)) {
+        qCWarning(lcSailfishSecretsDaemonSqlite) << "Failed to open reader connection:" << reader->connectionName
+                                                 << reader->database.lastError().text();
+        closeReader(reader);
+        return Q_NULLPTR;
+    }
+
+    ++m_readerCount;
+    return reader;
+}
+
+void Database::closeReader(ReaderConnection *reader)
+{
+    const QString connectionName = reader->connectionName;
+    reader->preparedQueries.clear();
+    reader->database.close();
+    delete reader;
+    QSqlDatabase::removeDatabase(connectionName);
 }
 
 bool Database::execute(QSqlQuery &query, QString *errorText)
@@ -568,6 +858,8 @@ QString Database::expandQuery(const QSqlQuery &query)
 
 DatabaseLocker::~DatabaseLocker()
 {
+    m_db->endWrite();
+
     if (mutex()) {
         // The database was not already within a transaction when we were constructed
         // and thus should not be in a transaction when we destruct.
@@ -586,3 +878,17 @@ DatabaseLocker::~DatabaseLocker()
         }
     }
 }
+
+DatabaseReadLocker::DatabaseReadLocker(Database *db)
+    : m_db(db)
+    , m_reader(db->acquireReader())
+    , m_locker((m_reader || db->withinTransaction()) ? Q_NULLPTR : db->accessMutex())
+{
+}
+
+DatabaseReadLocker::~DatabaseReadLocker()
+{
+    if (m_reader) {
+        m_db->releaseReader(m_reader);
+    }
+}
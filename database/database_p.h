@@ -17,8 +17,11 @@
 #include <QtCore/QVariant>
 #include <QtCore/QString>
 #include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <QtCore/QByteArray>
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QWaitCondition>
 #include <QtCore/QAtomicInt>
 #include <QtCore/QScopedPointer>
 #include <QtCore/QLoggingCategory>
@@ -39,8 +42,20 @@ struct UpgradeOperation {
     const char **statements;
 };
 
+class DatabaseLocker;
+class DatabaseReadLocker;
+
+// A database which is in WAL mode is read through a small pool of
+// reader connections, in addition to the connection which writes.
+// Within the scope of a DatabaseReadLocker, the calling thread has one
+// reader connection to itself, and its queries read from a snapshot of
+// the database, without serializing against the writer or other readers.
+// Everywhere else the queries use the writer connection, as before.
 class Database
 {
+    friend class DatabaseLocker;
+    friend class DatabaseReadLocker;
+
 public:
     // This class is required to finish() each query at destruction
     class Query
@@ -82,6 +97,9 @@ public:
         QString executedQuery() const { return m_query.executedQuery(); }
     };
 
+    // The maximum number of reader connections, which are opened when needed.
+    enum { MaximumReaderCount = 3 };
+
     Database();
     ~Database();
 
@@ -98,6 +116,11 @@ public:
               bool autoTest);
     void close();
 
+    // Replaces one of the setup statements given to open(), e.g. the key
+    // of an encrypted database which was rekeyed, so that the reader
+    // connections are configured with it from now on.
+    void setSetupStatement(int index, const QByteArray &statement);
+
     operator QSqlDatabase &();
     operator QSqlDatabase const &() const;
 
@@ -121,11 +144,50 @@ public:
     static QString expandQuery(const QSqlQuery &query);
 
 private:
+    struct ReaderConnection {
+        QSqlDatabase database;
+        QString connectionName;
+        QHash<QString, QSqlQuery> preparedQueries;
+        int generation;
+    };
+
+    // The use of the database by the current thread.
+    struct ThreadState {
+        const Database *database;
+        ReaderConnection *reader;
+        int readDepth;
+        int writeDepth;
+    };
+
+    static QVector<ThreadState> &threadStates();
+    static ThreadState *threadState(const Database *database, bool create);
+    static void pruneThreadState(const Database *database);
+    ReaderConnection *currentReader() const;
+    ReaderConnection *acquireReader();
+    void releaseReader(ReaderConnection *reader);
+    ReaderConnection *openReader();
+    void closeReader(ReaderConnection *reader);
+    void beginWrite();
+    void endWrite();
+
     QSqlDatabase m_database;
     QMutex m_mutex;
     QString m_localeName;
     mutable QHash<QString, QSqlQuery> m_preparedQueries;
     QAtomicInt m_transactionSemaphore;
+
+    // guards the reader connections, and the configuration from which they are opened.
+    QMutex m_readerMutex;
+    QWaitCondition m_readerReleased;
+    QVector<ReaderConnection*> m_idleReaders;
+    int m_readerCount;
+    int m_readerGeneration;
+    int m_readerSerial;
+    bool m_walMode;
+    QString m_databaseDriver;
+    QString m_databaseFile;
+    QString m_connectionName;
+    QVector<QByteArray> m_setupStatements;
 };
 
 class DatabaseLocker : public QMutexLocker
@@ -133,12 +195,28 @@ class DatabaseLocker : public QMutexLocker
 public:
     DatabaseLocker(Sailfish::Secrets::Daemon::Sqlite::Database *db)
         : QMutexLocker(db->withinTransaction() ? Q_NULLPTR : db->accessMutex())
-        , m_db(db) {}
+        , m_db(db) { m_db->beginWrite(); }
     ~DatabaseLocker();
 private:
     Sailfish::Secrets::Daemon::Sqlite::Database *m_db;
 };
 
+// Must only be used around queries which do not modify the database.
+// If no reader connection can be used (e.g. the database is not in WAL
+// mode, or the current thread is writing to it) this locks the database
+// as a DatabaseLocker does.
+class DatabaseReadLocker
+{
+public:
+    DatabaseReadLocker(Sailfish::Secrets::Daemon::Sqlite::Database *db);
+    ~DatabaseReadLocker();
+private:
+    Q_DISABLE_COPY(DatabaseReadLocker)
+    Sailfish::Secrets::Daemon::Sqlite::Database *m_db;
+    Sailfish::Secrets::Daemon::Sqlite::Database::ReaderConnection *m_reader;
+    QMutexLocker m_locker;
+};
+
 } // namespace Sqlite
 
 } // namespace Daemon
@@ -29,3 +29,49 @@ Sailfish::Secrets::Daemon::Util::transformSecretsResult(
     }
     return retn;
 }
+
+// Returns the names of the secrets whose filter data matches the given filter.
+// Fields and values are compared case-insensitively using Unicode case folding,
+// so that every storage plugin finds (and removes) the same secrets.
+QStringList
+Sailfish::Secrets::Daemon::Util::matchingSecretNames(
+        const QMap<QString, Sailfish::Secrets::Secret::FilterData> &secretNameToFilterData,
+        const Sailfish::Secrets::Secret::FilterData &filter,
+        Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator)
+{
+    QStringList matchingSecretNames;
+    for (QMap<QString, Sailfish::Secrets::Secret::FilterData>::const_iterator it = secretNameToFilterData.constBegin(); it != secretNameToFilterData.constEnd(); it++) {
+        const Sailfish::Secrets::Secret::FilterData &currFilterData(it.value());
+        bool matches = filterOperator == Sailfish::Secrets::StoragePlugin::OperatorOr ? false : true;
+        for (Sailfish::Secrets::Secret::FilterData::const_iterator fit = filter.constBegin(); fit != filter.constEnd(); fit++) {
+            bool found = false;
+            for (Sailfish::Secrets::Secret::FilterData::const_iterator mit = currFilterData.constBegin(); mit != currFilterData.constEnd(); mit++) {
+                if (fit.key().compare(mit.key(), Qt::CaseInsensitive) == 0) {
+                    found = true; // found a matching metadata field for this filter field
+                    if (fit.value().compare(mit.value(), Qt::CaseInsensitive) == 0) {
+                        // the metadata value matches the filter value
+                        if (filterOperator == Sailfish::Secrets::StoragePlugin::OperatorOr) {
+                            // we have a match!
+                            matches = true;
+                        }
+                    } else {
+                        if (filterOperator == Sailfish::Secrets::StoragePlugin::OperatorAnd) {
+                            // we know that this one doesn't match.
+                            matches = false;
+                        }
+                    }
+                    break; // mit
+                }
+            }
+            if (!found && filterOperator == Sailfish::Secrets::StoragePlugin::OperatorAnd) {
+                // the metadata is missing a required filter field.
+                matches = false;
+                break; // fit
+            }
+        }
+        if (matches) {
+            matchingSecretNames.append(it.key());
+        }
+    }
+    return matchingSecretNames;
+}
@@ -9,8 +9,12 @@
 #define SAILFISHSECRETS_COMMON_DAEMON_UTIL_P_H
 
 #include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QMap>
 
 #include "Secrets/result.h"
+#include "Secrets/secret.h"
+#include "Secrets/Plugins/extensionplugins.h"
 #include "Crypto/result.h"
 
 namespace Sailfish {
@@ -23,6 +27,10 @@ namespace Util {
 
 Sailfish::Crypto::Result transformSecretsResult(const Sailfish::Secrets::Result &result);
 
+QStringList matchingSecretNames(const QMap<QString, Sailfish::Secrets::Secret::FilterData> &secretNameToFilterData,
+                                const Sailfish::Secrets::Secret::FilterData &filter,
+                                Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator);
+
 } // namespace Util
 
 } // namespace Daemon
@@ -17,8 +17,10 @@ PUBLIC_HEADERS += \
     $$PWD/cipherrequest.h \
     $$PWD/cryptoglobal.h \
     $$PWD/cryptomanager.h \
+    $$PWD/decryptbatchrequest.h \
     $$PWD/decryptrequest.h \
     $$PWD/deletestoredkeyrequest.h \
+    $$PWD/encryptbatchrequest.h \
     $$PWD/encryptrequest.h \
     $$PWD/generateinitializationvectorrequest.h \
     $$PWD/generatekeyrequest.h \
@@ -34,11 +36,14 @@ PUBLIC_HEADERS += \
     $$PWD/plugininfo.h \
     $$PWD/plugininforequest.h \
     $$PWD/request.h \
+    $$PWD/requestpipeline.h \
     $$PWD/result.h \
     $$PWD/seedrandomdatageneratorrequest.h \
     $$PWD/signrequest.h \
+    $$PWD/statisticsrequest.h \
     $$PWD/storedkeyidentifiersrequest.h \
     $$PWD/storedkeyrequest.h \
+    $$PWD/verifybatchrequest.h \
     $$PWD/verifyrequest.h
 
 INTERNAL_PUBLIC_HEADERS += \
@@ -50,8 +55,10 @@ PRIVATE_HEADERS += \
     $$PWD/cipherrequest_p.h \
     $$PWD/cryptodaemonconnection_p_p.h \
     $$PWD/cryptomanager_p.h \
+    $$PWD/decryptbatchrequest_p.h \
     $$PWD/decryptrequest_p.h \
     $$PWD/deletestoredkeyrequest_p.h \
+    $$PWD/encryptbatchrequest_p.h \
     $$PWD/encryptrequest_p.h \
     $$PWD/generateinitializationvectorrequest_p.h \
     $$PWD/generatekeyrequest_p.h \
@@ -66,11 +73,14 @@ PRIVATE_HEADERS += \
     $$PWD/lockcoderequest_p.h \
     $$PWD/plugininfo_p.h \
     $$PWD/plugininforequest_p.h \
+    $$PWD/requestpipeline_p.h \
     $$PWD/result_p.h \
     $$PWD/seedrandomdatageneratorrequest_p.h \
     $$PWD/signrequest_p.h \
+    $$PWD/statisticsrequest_p.h \
     $$PWD/storedkeyidentifiersrequest_p.h \
     $$PWD/storedkeyrequest_p.h \
+    $$PWD/verifybatchrequest_p.h \
     $$PWD/verifyrequest_p.h
 
 HEADERS += \
@@ -83,8 +93,10 @@ SOURCES += \
     $$PWD/cipherrequest.cpp \
     $$PWD/cryptodaemonconnection.cpp \
     $$PWD/cryptomanager.cpp \
+    $$PWD/decryptbatchrequest.cpp \
     $$PWD/decryptrequest.cpp \
     $$PWD/deletestoredkeyrequest.cpp \
+    $$PWD/encryptbatchrequest.cpp \
     $$PWD/encryptrequest.cpp \
     $$PWD/generateinitializationvectorrequest.cpp \
     $$PWD/generatekeyrequest.cpp \
@@ -100,12 +112,15 @@ SOURCES += \
     $$PWD/plugininfo.cpp \
     $$PWD/plugininforequest.cpp \
     $$PWD/request.cpp \
+    $$PWD/requestpipeline.cpp \
     $$PWD/result.cpp \
     $$PWD/seedrandomdatageneratorrequest.cpp \
     $$PWD/serialization.cpp \
     $$PWD/signrequest.cpp \
+    $$PWD/statisticsrequest.cpp \
     $$PWD/storedkeyidentifiersrequest.cpp \
     $$PWD/storedkeyrequest.cpp \
+    $$PWD/verifybatchrequest.cpp \
     $$PWD/verifyrequest.cpp
 
 develheaders.path = /usr/include/Sailfish/
@@ -616,6 +616,169 @@ CryptoPlugin::~CryptoPlugin()
  * and used to perform the operation.
  */
 
+/*!
+ * \brief Attempts to verify that each of the given \a signatures was
+ *        generated from the input \a data at the same position, after
+ *        being padded according to the \a padding, using the specified
+ *        \a digestFunction and the signing key at the same position in
+ *        \a keys, and writes the verification state of each signature to
+ *        the out-parameter \a verificationStatuses.
+ *
+ * The \a data and \a keys contain one element for each element of the
+ * \a signatures, and each signature is verified as described for verify().
+ * The same key will often be given for many of the signatures.
+ *
+ * The signatures are usually untrusted input, so a signature which is
+ * malformed should be reported as VerificationFailed rather than failing
+ * the whole batch.  Only if the batch cannot be verified at all (for
+ * example, due to an invalid key, an unsupported digest or invalid
+ * parameters) should the plugin return an error result, in which case the
+ * out-parameter will be ignored.
+ *
+ * The default implementation calls verify() for each signature, and stops
+ * at the first signature which cannot be verified.
+ * This method should be overridden by a specific plugin implementation
+ * if it is able to verify the signatures more efficiently together (for
+ * example, by parsing each distinct key only once).
+ */
+Result CryptoPlugin::verifyBatch(
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Key> &keys,
+        CryptoManager::SignaturePadding padding,
+        CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        QVector<CryptoManager::VerificationStatus> *verificationStatuses)
+{
+    verificationStatuses->clear();
+    verificationStatuses->reserve(signatures.size());
+    for (int i = 0; i < signatures.size(); ++i) {
+        CryptoManager::VerificationStatus verificationStatus = CryptoManager::VerificationStatusUnknown;
+        const Result result = verify(signatures.at(i), data.value(i), keys.value(i),
+                                     padding, digestFunction,
+                                     customParameters,
+                                     &verificationStatus);
+        if (result.code() != Result::Succeeded) {
+            return result;
+        }
+        verificationStatuses->append(verificationStatus);
+    }
+    return Result(Result::Succeeded);
+}
+
+/*!
+ * \brief Encrypt each of the input \a data given the initialization vector
+ *        at the same position in \a ivs using the specified \a key and (if
+ *        applicable) \a blockMode and \a padding, and write the encrypted
+ *        data to the out-parameter \a encrypted.
+ *
+ * The \a ivs and \a authenticationData contain one element for each
+ * element of the \a data, and each element is encrypted as described for
+ * encrypt().  If the specified \a blockMode is an authenticated mode, the
+ * plugin should also write the authentication tag generated for each
+ * element to the out-parameter \a authenticationTags.
+ *
+ * The elements should be encrypted all together or not at all: if any
+ * element cannot be encrypted, the plugin should return the result for
+ * that element, and the out-parameters will be ignored.
+ *
+ * The default implementation calls encrypt() for each element, and stops
+ * at the first element which cannot be encrypted.
+ * This method should be overridden by a specific plugin implementation
+ * if it is able to encrypt the elements more efficiently together (for
+ * example, by retrieving the full key identified by a key reference
+ * \a key from storage only once).
+ */
+Result CryptoPlugin::encryptBatch(
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Key &key,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVariantMap &customParameters,
+        QVector<QByteArray> *encrypted,
+        QVector<QByteArray> *authenticationTags)
+{
+    encrypted->clear();
+    authenticationTags->clear();
+    encrypted->reserve(data.size());
+    authenticationTags->reserve(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        QByteArray ciphertext;
+        QByteArray authenticationTag;
+        const Result result = encrypt(data.at(i), ivs.value(i), key,
+                                      blockMode, padding,
+                                      authenticationData.value(i),
+                                      customParameters,
+                                      &ciphertext, &authenticationTag);
+        if (result.code() != Result::Succeeded) {
+            return result;
+        }
+        encrypted->append(ciphertext);
+        authenticationTags->append(authenticationTag);
+    }
+    return Result(Result::Succeeded);
+}
+
+/*!
+ * \brief Decrypt each of the input \a data given the initialization vector
+ *        at the same position in \a ivs using the specified \a key and (if
+ *        applicable) \a blockMode and \a padding, and write the decrypted
+ *        data to the out-parameter \a decrypted.
+ *
+ * The \a ivs, \a authenticationData and \a authenticationTags contain one
+ * element for each element of the \a data, and each element is decrypted
+ * as described for decrypt().  The plugin should write the verification
+ * status of each element to the out-parameter \a verificationStatuses;
+ * as for decrypt(), an authentication tag which does not match does not
+ * cause the operation to fail.
+ *
+ * The elements should be decrypted all together or not at all: if any
+ * element cannot be decrypted, the plugin should return the result for
+ * that element, and the out-parameters will be ignored.
+ *
+ * The default implementation calls decrypt() for each element, and stops
+ * at the first element which cannot be decrypted.
+ * This method should be overridden by a specific plugin implementation
+ * if it is able to decrypt the elements more efficiently together (for
+ * example, by retrieving the full key identified by a key reference
+ * \a key from storage only once).
+ */
+Result CryptoPlugin::decryptBatch(
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Key &key,
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVector<QByteArray> &authenticationTags,
+        const QVariantMap &customParameters,
+        QVector<QByteArray> *decrypted,
+        QVector<CryptoManager::VerificationStatus> *verificationStatuses)
+{
+    decrypted->clear();
+    verificationStatuses->clear();
+    decrypted->reserve(data.size());
+    verificationStatuses->reserve(data.size());
+    for (int i = 0; i < data.size(); ++i) {
+        QByteArray plaintext;
+        CryptoManager::VerificationStatus verificationStatus = CryptoManager::VerificationStatusUnknown;
+        const Result result = decrypt(data.at(i), ivs.value(i), key,
+                                      blockMode, padding,
+                                      authenticationData.value(i),
+                                      authenticationTags.value(i),
+                                      customParameters,
+                                      &plaintext, &verificationStatus);
+        if (result.code() != Result::Succeeded) {
+            return result;
+        }
+        decrypted->append(plaintext);
+        verificationStatuses->append(verificationStatus);
+    }
+    return Result(Result::Succeeded);
+}
+
 /*!
  * \fn CryptoPlugin::initializeCipherSession(quint64 clientId, const QByteArray &iv, const Sailfish::Crypto::Key &key, Sailfish::Crypto::CryptoManager::Operation operation, Sailfish::Crypto::CryptoManager::BlockMode blockMode, Sailfish::Crypto::CryptoManager::EncryptionPadding encryptionPadding, Sailfish::Crypto::CryptoManager::SignaturePadding signaturePadding, Sailfish::Crypto::CryptoManager::DigestFunction digestFunction, const QVariantMap &customParameters, quint32 *cipherSessionToken)
  * \brief Initialize a new cipher session for the client identified by the
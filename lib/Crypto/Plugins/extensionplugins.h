@@ -26,7 +26,7 @@
 #include <QtCore/QSharedDataPointer>
 #include <QtCore/QLoggingCategory>
 
-#define Sailfish_Crypto_CryptoPlugin_IID "org.sailfishos.crypto.CryptoPlugin/1.0"
+#define Sailfish_Crypto_CryptoPlugin_IID "org.sailfishos.crypto.CryptoPlugin/1.1"
 
 SAILFISH_CRYPTO_API Q_DECLARE_LOGGING_CATEGORY(lcSailfishCryptoPlugin)
 
@@ -195,6 +195,39 @@ public:
             quint32 cipherSessionToken,
             QByteArray *generatedData,
             Sailfish::Crypto::CryptoManager::VerificationStatus *verificationStatus) = 0;
+
+    // batch operations.
+    virtual Sailfish::Crypto::Result encryptBatch(
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVariantMap &customParameters,
+            QVector<QByteArray> *encrypted,
+            QVector<QByteArray> *authenticationTags);
+
+    virtual Sailfish::Crypto::Result decryptBatch(
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key, // or keyreference, i.e. Key(keyName)
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVector<QByteArray> &authenticationTags,
+            const QVariantMap &customParameters,
+            QVector<QByteArray> *decrypted,
+            QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses);
+
+    virtual Sailfish::Crypto::Result verifyBatch(
+            const QVector<QByteArray> &signatures,
+            const QVector<QByteArray> &data,
+            const QVector<Sailfish::Crypto::Key> &keys,
+            Sailfish::Crypto::CryptoManager::SignaturePadding padding,
+            Sailfish::Crypto::CryptoManager::DigestFunction digestFunction,
+            const QVariantMap &customParameters,
+            QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses);
 };
 
 } // namespace Crypto
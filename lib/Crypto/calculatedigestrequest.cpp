@@ -18,7 +18,8 @@
 using namespace Sailfish::Crypto;
 
 CalculateDigestRequestPrivate::CalculateDigestRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -173,6 +174,25 @@ Result CalculateDigestRequest::result() const
     return d->m_result;
 }
 
+int CalculateDigestRequest::timeout() const
+{
+    Q_D(const CalculateDigestRequest);
+    return d->m_timeout;
+}
+
+void CalculateDigestRequest::setTimeout(int timeout)
+{
+    Q_D(CalculateDigestRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap CalculateDigestRequest::customParameters() const
 {
     Q_D(const CalculateDigestRequest);
@@ -218,6 +238,7 @@ void CalculateDigestRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QByteArray> reply =
                 d->m_manager->d_ptr->calculateDigest(d->m_data,
                                                      d->m_padding,
@@ -264,3 +285,20 @@ void CalculateDigestRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void CalculateDigestRequest::cancel()
+{
+    Q_D(CalculateDigestRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
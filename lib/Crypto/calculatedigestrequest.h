@@ -54,6 +54,9 @@ public:
     Sailfish::Crypto::Request::Status status() const Q_DECL_OVERRIDE;
     Sailfish::Crypto::Result result() const Q_DECL_OVERRIDE;
 
+    int timeout() const Q_DECL_OVERRIDE;
+    void setTimeout(int timeout) Q_DECL_OVERRIDE;
+
     QVariantMap customParameters() const Q_DECL_OVERRIDE;
     void setCustomParameters(const QVariantMap &params) Q_DECL_OVERRIDE;
 
@@ -62,6 +65,7 @@ public:
 
     void startRequest() Q_DECL_OVERRIDE;
     void waitForFinished() Q_DECL_OVERRIDE;
+    void cancel() Q_DECL_OVERRIDE;
 
 Q_SIGNALS:
     void dataChanged();
@@ -37,6 +37,7 @@ public:
     QString m_cryptoPluginName;
     QByteArray m_digest;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
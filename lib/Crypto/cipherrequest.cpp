@@ -25,6 +25,7 @@ CipherRequestPrivate::CipherRequestPrivate()
     , m_digestFunction(CryptoManager::DigestSha256)
     , m_cipherSessionToken(0)
     , m_verificationStatus(Sailfish::Crypto::CryptoManager::VerificationStatusUnknown)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -467,6 +468,25 @@ Result CipherRequest::result() const
     return d->m_result;
 }
 
+int CipherRequest::timeout() const
+{
+    Q_D(const CipherRequest);
+    return d->m_timeout;
+}
+
+void CipherRequest::setTimeout(int timeout)
+{
+    Q_D(CipherRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap CipherRequest::customParameters() const
 {
     Q_D(const CipherRequest);
@@ -520,6 +540,7 @@ void CipherRequest::startRequest()
             }
             d->m_watcherQueue.clear();
             d->m_cipherSessionToken = 0;
+            d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
             QDBusPendingReply<Result, quint32> reply =
                     d->m_manager->d_ptr->initializeCipherSession(
                         d->m_initializationVector,
@@ -575,6 +596,7 @@ void CipherRequest::startRequest()
             if (d->m_cipherSessionToken == 0) {
                 qWarning() << "Ignoring attempt to update authentication for uninitialized cipher session!";
             } else {
+                d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
                 QDBusPendingReply<Result> reply =
                         d->m_manager->d_ptr->updateCipherSessionAuthentication(
                                 d->m_data,
@@ -619,6 +641,7 @@ void CipherRequest::startRequest()
             if (d->m_cipherSessionToken == 0) {
                 qWarning() << "Ignoring attempt to update data for uninitialized cipher session!";
             } else {
+                d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
                 QDBusPendingReply<Result, QByteArray> reply =
                         d->m_manager->d_ptr->updateCipherSession(
                                 d->m_data,
@@ -683,6 +706,7 @@ void CipherRequest::startRequest()
             if (d->m_cipherSessionToken == 0) {
                 qWarning() << "Ignoring attempt to finalize uninitialized cipher session!";
             } else {
+                d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
                 QDBusPendingReply<Result, QByteArray, CryptoManager::VerificationStatus> reply =
                         d->m_manager->d_ptr->finalizeCipherSession(
                                 d->m_data,
@@ -764,3 +788,36 @@ void CipherRequest::waitForFinished()
         watcher->waitForFinished();
     }
 }
+
+void CipherRequest::cancel()
+{
+    Q_D(CipherRequest);
+    if (d->m_status == Request::Active) {
+        for (QDBusPendingCallWatcher *watcher : d->m_watcherQueue) {
+            if (!d->m_manager.isNull()) {
+                d->m_manager->d_ptr->cancelRequest(*watcher);
+            }
+            // destroying the watcher ensures that a late reply is ignored.
+            delete watcher;
+        }
+        d->m_watcherQueue.clear();
+        d->m_completedHash.clear();
+
+        // Finalize the session without waiting for the result, so that
+        // the plugin releases it now rather than when it times out.
+        if (d->m_cipherSessionToken != 0 && !d->m_manager.isNull()) {
+            d->m_manager->d_ptr->finalizeCipherSession(
+                        QByteArray(),
+                        d->m_customParameters,
+                        d->m_cryptoPluginName,
+                        d->m_cipherSessionToken);
+        }
+        d->m_cipherSessionToken = 0;
+
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -46,6 +46,7 @@ public:
     QByteArray m_generatedData;
     Sailfish::Crypto::CryptoManager::VerificationStatus m_verificationStatus;
 
+    int m_timeout;
     QQueue<QDBusPendingCallWatcher*> m_watcherQueue;
     QHash<QDBusPendingCallWatcher*, bool> m_completedHash;
     Sailfish::Crypto::Request::Status m_status;
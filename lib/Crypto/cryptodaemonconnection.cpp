@@ -24,11 +24,14 @@
 #include <QtDBus/QDBusArgument>
 #include <QtDBus/QDBusMetaType>
 
+#include <QtCore/QMutexLocker>
+
 Q_LOGGING_CATEGORY(lcSailfishCryptoDaemonConnection, "org.sailfishos.crypto.daemon.connection", QtWarningMsg)
 
 Sailfish::Crypto::CryptoDaemonConnectionPrivate::CryptoDaemonConnectionPrivate(CryptoDaemonConnection *parent)
     : QObject(parent)
     , m_connection(QLatin1String("org.sailfishos.crypto.daemon.invalidConnection"))
+    , m_lastPipelineId(0)
     , m_parent(parent)
 {
 }
@@ -70,7 +73,10 @@ bool Sailfish::Crypto::CryptoDaemonConnectionPrivate::connect()
         return false;
     }
 
+    QMutexLocker locker(&m_sendMutex);
     m_connection = p2pc;
+    m_sentRequestCounts.clear();
+    locker.unlock();
     m_connection.connect(QString(), // any service
                          QLatin1String("/org/freedesktop/DBus/Local"),
                          QLatin1String("org.freedesktop.DBus.Local"),
@@ -155,6 +161,37 @@ QDBusInterface *Sailfish::Crypto::CryptoDaemonConnection::createInterface(const
     return retn;
 }
 
+// The daemon numbers the method calls it receives for each object on each
+// connection, starting from one.  Calls are numbered here in the same way,
+// and numbering and sending a call is serialized, so that the \a sequence
+// returned is the number which the daemon assigns to the call.
+// A nonzero \a timeout and \a pipelineId are sent immediately before the
+// call, which the daemon does not number, so that they apply to the call
+// and no other.
+QDBusPendingCall Sailfish::Crypto::CryptoDaemonConnection::sendRequest(QDBusInterface *interface, const QString &method, const QVariantList &arguments, int timeout, quint64 pipelineId, quint64 *sequence)
+{
+    QMutexLocker locker(&m_data->m_sendMutex);
+    if (timeout > 0) {
+        interface->asyncCallWithArgumentList(QStringLiteral("setNextRequestTimeout"),
+                                             QVariantList() << QVariant::fromValue<int>(timeout));
+    }
+    if (pipelineId) {
+        interface->asyncCallWithArgumentList(QStringLiteral("setNextRequestPipeline"),
+                                             QVariantList() << QVariant::fromValue<quint64>(pipelineId));
+    }
+    *sequence = ++m_data->m_sentRequestCounts[interface->path()];
+    return interface->asyncCallWithArgumentList(method, arguments);
+}
+
+// Pipeline ids are allocated here rather than by each manager, as all of
+// the managers in the process share the connection, and the daemon tells
+// the pipelines on a connection apart by their ids alone.
+quint64 Sailfish::Crypto::CryptoDaemonConnection::allocatePipelineId()
+{
+    QMutexLocker locker(&m_data->m_sendMutex);
+    return ++m_data->m_lastPipelineId;
+}
+
 void Sailfish::Crypto::CryptoDaemonConnection::registerDBusTypes()
 {
     qRegisterMetaType<Sailfish::Crypto::Key::Origin>("Sailfish::Crypto::Key::Origin");
@@ -171,10 +208,13 @@ void Sailfish::Crypto::CryptoDaemonConnection::registerDBusTypes()
     qRegisterMetaType<QVector<Sailfish::Crypto::CryptoManager::DigestFunction> >("QVector<Sailfish::Crypto::CryptoManager::DigestFunction>");
     qRegisterMetaType<Sailfish::Crypto::CryptoManager::Operations>("Sailfish::Crypto::CryptoManager::Operations");
     qRegisterMetaType<Sailfish::Crypto::CryptoManager::VerificationStatus>("Sailfish::Crypto::CryptoManager::VerificationStatus");
+    qRegisterMetaType<QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> >("QVector<Sailfish::Crypto::CryptoManager::VerificationStatus>");
+    qRegisterMetaType<QVector<QByteArray> >("QVector<QByteArray>");
     qRegisterMetaType<Sailfish::Crypto::Key::Identifier>("Sailfish::Crypto::Key::Identifier");
     qRegisterMetaType<QVector<Sailfish::Crypto::Key::Identifier> >("QVector<Sailfish::Crypto::Key::Identifier>");
     qRegisterMetaType<Sailfish::Crypto::Key::FilterData>("Sailfish::Crypto::Key::FilterData");
     qRegisterMetaType<Sailfish::Crypto::Key>("Sailfish::Crypto::Key");
+    qRegisterMetaType<QVector<Sailfish::Crypto::Key> >("QVector<Sailfish::Crypto::Key>");
     qRegisterMetaType<Sailfish::Crypto::Result>("Sailfish::Crypto::Result");
     qRegisterMetaType<Sailfish::Crypto::Key::Component>("Sailfish::Crypto::Key::Component");
     qRegisterMetaType<Sailfish::Crypto::Key::Components>("Sailfish::Crypto::Key::Components");
@@ -203,9 +243,12 @@ void Sailfish::Crypto::CryptoDaemonConnection::registerDBusTypes()
     qDBusRegisterMetaType<QVector<Sailfish::Crypto::CryptoManager::DigestFunction> >();
     qDBusRegisterMetaType<Sailfish::Crypto::CryptoManager::Operations>();
     qDBusRegisterMetaType<Sailfish::Crypto::CryptoManager::VerificationStatus>();
+    qDBusRegisterMetaType<QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> >();
+    qDBusRegisterMetaType<QVector<QByteArray> >();
     qDBusRegisterMetaType<Sailfish::Crypto::Key::Identifier>();
     qDBusRegisterMetaType<QVector<Sailfish::Crypto::Key::Identifier> >();
     qDBusRegisterMetaType<Sailfish::Crypto::Key>();
+    qDBusRegisterMetaType<QVector<Sailfish::Crypto::Key> >();
     qDBusRegisterMetaType<Sailfish::Crypto::Result>();
     qDBusRegisterMetaType<Sailfish::Crypto::Key::Component>();
     qDBusRegisterMetaType<Sailfish::Crypto::Key::Components>();
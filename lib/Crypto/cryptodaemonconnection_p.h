@@ -17,6 +17,7 @@
 
 #include <QtDBus/QDBusConnection>
 #include <QtDBus/QDBusInterface>
+#include <QtDBus/QDBusPendingCall>
 
 #include <QtCore/QObject>
 #include <QtCore/QString>
@@ -45,6 +46,13 @@ public:
     QDBusInterface *createInterface(const QString &objectPath,
                                     const QString &interface,
                                     QObject *parent = Q_NULLPTR);
+    QDBusPendingCall sendRequest(QDBusInterface *interface,
+                                 const QString &method,
+                                 const QVariantList &arguments,
+                                 int timeout,
+                                 quint64 pipelineId,
+                                 quint64 *sequence);
+    quint64 allocatePipelineId();
 
     static void registerDBusTypes();
 
@@ -15,6 +15,8 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
+#include <QtCore/QMutex>
+#include <QtCore/QHash>
 
 namespace Sailfish {
 
@@ -37,6 +39,9 @@ public Q_SLOTS:
 private:
     friend class CryptoDaemonConnection;
     QDBusConnection m_connection;
+    QMutex m_sendMutex;
+    QHash<QString, quint64> m_sentRequestCounts; // per object path, on the current connection.
+    quint64 m_lastPipelineId; // shared by every manager using the connection.
     QPointer<CryptoDaemonConnection> m_parent;
 };
 
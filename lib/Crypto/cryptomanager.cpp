@@ -32,6 +32,17 @@ Q_LOGGING_CATEGORY(lcSailfishCrypto, "org.sailfishos.crypto", QtWarningMsg)
 
 using namespace Sailfish::Crypto;
 
+namespace {
+    // Copies of a QDBusPendingCall share the state of the call,
+    // which therefore identifies the call.
+    class PendingCallIdentity : public QDBusPendingCall
+    {
+    public:
+        PendingCallIdentity(const QDBusPendingCall &call) : QDBusPendingCall(call) {}
+        bool isSameCall(const QDBusPendingCall &other) const { return d == PendingCallIdentity(other).d; }
+    };
+}
+
 const QString CryptoManager::DefaultCryptoPluginName = QStringLiteral("plugin.crypto.default");
 const QString CryptoManager::DefaultCryptoStoragePluginName = QStringLiteral("plugin.cryptostorage.default");
 
@@ -49,6 +60,8 @@ CryptoManagerPrivate::CryptoManagerPrivate(CryptoManager *parent)
     , m_interface(m_crypto->connect()
                   ? m_crypto->createInterface(QLatin1String("/Sailfish/Crypto"), QLatin1String("org.sailfishos.crypto"), parent)
                   : Q_NULLPTR)
+    , m_nextRequestTimeout(0)
+    , m_pipelineId(0)
 {
 }
 
@@ -61,6 +74,113 @@ CryptoManagerPrivate::~CryptoManagerPrivate()
     m_interface = Q_NULLPTR;
 }
 
+/*!
+ * \internal
+ * \brief Sends the \a method call with the given \a arguments to the daemon
+ *
+ * The daemon identifies the requests of a client by the order in which
+ * they were sent, so every request must be sent via this method for
+ * cancelRequest() to be able to identify it.
+ */
+QDBusPendingCall CryptoManagerPrivate::sendRequest(
+        const QString &method,
+        const QVariantList &arguments)
+{
+    // forget the requests which the daemon has already replied to.
+    for (int i = m_sentRequests.size() - 1; i >= 0; --i) {
+        if (m_sentRequests.at(i).call.isFinished()) {
+            m_sentRequests.removeAt(i);
+        }
+    }
+
+    // the timeout applies to this request only.
+    const int timeout = m_nextRequestTimeout;
+    m_nextRequestTimeout = 0;
+
+    quint64 sequence = 0;
+    QDBusPendingCall call = m_crypto->sendRequest(m_interface, method, arguments, timeout, m_pipelineId, &sequence);
+    m_sentRequests.append(SentRequest(call, sequence, method));
+    return call;
+}
+
+/*!
+ * \internal
+ * \brief Asks the daemon to cancel the request associated with the given pending \a call
+ *
+ * The daemon will not start the request if it has not already done so,
+ * and will not reply to it.  It is up to the caller to stop watching the
+ * \a call.
+ */
+void CryptoManagerPrivate::cancelRequest(const QDBusPendingCall &call)
+{
+    const int index = sentRequestIndex(call);
+    if (index >= 0) {
+        const SentRequest request = m_sentRequests.takeAt(index);
+        if (m_interface && !request.call.isFinished()) {
+            // the reply carries no information, so don't wait for it.
+            m_interface->asyncCallWithArgumentList(
+                        QStringLiteral("cancelRequest"),
+                        QVariantList() << QVariant::fromValue<quint64>(request.sequence)
+                                       << QVariant::fromValue<QString>(request.method));
+        }
+    }
+}
+
+/*!
+ * \internal
+ * \brief Sets the deadline of the next request sent via this manager to \a timeout milliseconds
+ *
+ * The deadline is sent along with the request, and the daemon measures it
+ * from when it receives the request.  A \a timeout of zero means that the
+ * request has no deadline.
+ */
+void CryptoManagerPrivate::setNextRequestTimeout(int timeout)
+{
+    m_nextRequestTimeout = timeout;
+}
+
+/*!
+ * \internal
+ * \brief Makes the requests sent via this manager until endPipeline() is called form a pipeline
+ *
+ * Each of those requests is tagged with the id of the pipeline.  The daemon
+ * starts each request of the pipeline once the previous one has succeeded,
+ * and fails the remaining requests of the pipeline without starting them
+ * once one of them has failed.  As the order is enforced by the daemon, the
+ * requests may be sent without waiting for any replies.  Requests which are
+ * not tagged, including those sent via other managers sharing the daemon
+ * connection, are not part of the pipeline.
+ */
+void CryptoManagerPrivate::beginPipeline()
+{
+    m_pipelineId = m_crypto->allocatePipelineId();
+}
+
+/*!
+ * \internal
+ * \brief Tells the daemon that the pipeline begun by beginPipeline() has no further requests
+ */
+void CryptoManagerPrivate::endPipeline()
+{
+    if (m_interface && m_pipelineId) {
+        // the call is not itself a request, so it is not numbered.
+        m_interface->asyncCallWithArgumentList(QStringLiteral("endPipeline"),
+                                               QVariantList() << QVariant::fromValue<quint64>(m_pipelineId));
+    }
+    m_pipelineId = 0;
+}
+
+int CryptoManagerPrivate::sentRequestIndex(const QDBusPendingCall &call) const
+{
+    const PendingCallIdentity identity(call);
+    for (int i = 0; i < m_sentRequests.size(); ++i) {
+        if (identity.isSameCall(m_sentRequests.at(i).call)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 /*!
  * \internal
  * \brief Returns the names of available crypto plugins as well as the names of available (Secrets) storage plugins
@@ -78,7 +198,22 @@ CryptoManagerPrivate::getPluginInfo()
     }
 
     QDBusPendingReply<Result, QVector<PluginInfo>, QVector<PluginInfo> > reply
-            = m_interface->asyncCall("getPluginInfo");
+            = sendRequest(QStringLiteral("getPluginInfo"));
+
+    return reply;
+}
+
+QDBusPendingReply<Sailfish::Crypto::Result, QVariantMap>
+CryptoManagerPrivate::getStatistics()
+{
+    if (!m_interface) {
+        return QDBusPendingReply<Result, QVariantMap>(
+                    QDBusMessage::createError(QDBusError::Other,
+                                              QStringLiteral("Not connected to daemon")));
+    }
+
+    QDBusPendingReply<Result, QVariantMap> reply
+            = sendRequest(QStringLiteral("getStatistics"));
 
     return reply;
 }
@@ -97,7 +232,7 @@ CryptoManagerPrivate::generateRandomData(
     }
 
     QDBusPendingReply<Result, QByteArray> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("generateRandomData"),
                 QVariantList() << QVariant::fromValue<quint64>(numberBytes)
                                << QVariant::fromValue<QString>(csprngEngineName)
@@ -121,7 +256,7 @@ CryptoManagerPrivate::seedRandomDataGenerator(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("seedRandomDataGenerator"),
                 QVariantList() << QVariant::fromValue<QByteArray>(seedData)
                                << QVariant::fromValue<double>(entropyEstimate)
@@ -146,7 +281,7 @@ CryptoManagerPrivate::generateInitializationVector(
     }
 
     QDBusPendingReply<Result, QByteArray> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("generateInitializationVector"),
                 QVariantList() << QVariant::fromValue<CryptoManager::Algorithm>(algorithm)
                                << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
@@ -171,7 +306,7 @@ CryptoManagerPrivate::generateKey(
     }
 
     QDBusPendingReply<Result, Key> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("generateKey"),
                 QVariantList() << QVariant::fromValue<Key>(keyTemplate)
                                << QVariant::fromValue<KeyPairGenerationParameters>(kpgParams)
@@ -197,7 +332,7 @@ CryptoManagerPrivate::generateStoredKey(
     }
 
     QDBusPendingReply<Result, Key> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("generateStoredKey"),
                 QVariantList() << QVariant::fromValue<Key>(keyTemplate)
                                << QVariant::fromValue<KeyPairGenerationParameters>(kpgParams)
@@ -222,7 +357,7 @@ CryptoManagerPrivate::importKey(
     }
 
     QDBusPendingReply<Result, Key> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("importKey"),
                 QVariantList() << QVariant::fromValue<QByteArray>(data)
                                << QVariant::fromValue<InteractionParameters>(uiParams)
@@ -246,7 +381,7 @@ CryptoManagerPrivate::importStoredKey(
     }
 
     QDBusPendingReply<Result, Key> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("importStoredKey"),
                 QVariantList() << QVariant::fromValue<QByteArray>(data)
                                << QVariant::fromValue<Key>(keyTemplate)
@@ -269,7 +404,7 @@ CryptoManagerPrivate::storedKey(
     }
 
     QDBusPendingReply<Result, Key> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("storedKey"),
                 QVariantList() << QVariant::fromValue<Key::Identifier>(identifier)
                                << QVariant::fromValue<Key::Components>(keyComponents)
@@ -288,7 +423,7 @@ CryptoManagerPrivate::deleteStoredKey(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("deleteStoredKey"),
                 QVariantList() << QVariant::fromValue<Key::Identifier>(identifier));
     return reply;
@@ -307,7 +442,7 @@ CryptoManagerPrivate::storedKeyIdentifiers(
     }
 
     QDBusPendingReply<Result, QVector<Key::Identifier> > reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("storedKeyIdentifiers"),
                 QVariantList() << QVariant::fromValue<QString>(storagePluginName)
                                << QVariant::fromValue<QString>(collectionName)
@@ -330,7 +465,7 @@ CryptoManagerPrivate::calculateDigest(
     }
 
     QDBusPendingReply<Result, QByteArray> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("calculateDigest"),
                 QVariantList() << QVariant::fromValue<QByteArray>(data)
                                << QVariant::fromValue<CryptoManager::SignaturePadding>(padding)
@@ -356,7 +491,7 @@ CryptoManagerPrivate::sign(
     }
 
     QDBusPendingReply<Result, QByteArray> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("sign"),
                 QVariantList() << QVariant::fromValue<QByteArray>(data)
                                << QVariant::fromValue<Key>(key)
@@ -383,7 +518,7 @@ QDBusPendingReply<Result, CryptoManager::VerificationStatus> CryptoManagerPrivat
     }
 
     QDBusPendingReply<Result, Sailfish::Crypto::CryptoManager::VerificationStatus> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("verify"),
                 QVariantList() << QVariant::fromValue<QByteArray>(signature)
                                << QVariant::fromValue<QByteArray>(data)
@@ -413,7 +548,7 @@ CryptoManagerPrivate::encrypt(
     }
 
     QDBusPendingReply<Result, QByteArray, QByteArray> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("encrypt"),
                 QVariantList() << QVariant::fromValue<QByteArray>(data)
                                << QVariant::fromValue<QByteArray>(iv)
@@ -444,7 +579,7 @@ QDBusPendingReply<Result, QByteArray, Sailfish::Crypto::CryptoManager::Verificat
     }
 
     QDBusPendingReply<Result, QByteArray, Sailfish::Crypto::CryptoManager::VerificationStatus> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("decrypt"),
                 QVariantList() << QVariant::fromValue<QByteArray>(data)
                                << QVariant::fromValue<QByteArray>(iv)
@@ -458,6 +593,99 @@ QDBusPendingReply<Result, QByteArray, Sailfish::Crypto::CryptoManager::Verificat
     return reply;
 }
 
+QDBusPendingReply<Result, QVector<QByteArray>, QVector<QByteArray> >
+CryptoManagerPrivate::encryptBatch(
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Key &key, // or keyreference, i.e. Key(keyName)
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName)
+{
+    if (!m_interface) {
+        return QDBusPendingReply<Result, QVector<QByteArray>, QVector<QByteArray> >(
+                    QDBusMessage::createError(QDBusError::Other,
+                                              QStringLiteral("Not connected to daemon")));
+    }
+
+    QDBusPendingReply<Result, QVector<QByteArray>, QVector<QByteArray> > reply
+            = sendRequest(
+                QStringLiteral("encryptBatch"),
+                QVariantList() << QVariant::fromValue<QVector<QByteArray> >(data)
+                               << QVariant::fromValue<QVector<QByteArray> >(ivs)
+                               << QVariant::fromValue<Key>(key)
+                               << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
+                               << QVariant::fromValue<CryptoManager::EncryptionPadding>(padding)
+                               << QVariant::fromValue<QVector<QByteArray> >(authenticationData)
+                               << QVariant::fromValue<QVariantMap>(customParameters)
+                               << QVariant::fromValue<QString>(cryptosystemProviderName));
+    return reply;
+}
+
+QDBusPendingReply<Result, QVector<QByteArray>, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> >
+CryptoManagerPrivate::decryptBatch(
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Key &key, // or keyreference, i.e. Key(keyName)
+        CryptoManager::BlockMode blockMode,
+        CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVector<QByteArray> &authenticationTags,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName)
+{
+    if (!m_interface) {
+        return QDBusPendingReply<Result, QVector<QByteArray>, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> >(
+                    QDBusMessage::createError(QDBusError::Other,
+                                              QStringLiteral("Not connected to daemon")));
+    }
+
+    QDBusPendingReply<Result, QVector<QByteArray>, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> > reply
+            = sendRequest(
+                QStringLiteral("decryptBatch"),
+                QVariantList() << QVariant::fromValue<QVector<QByteArray> >(data)
+                               << QVariant::fromValue<QVector<QByteArray> >(ivs)
+                               << QVariant::fromValue<Key>(key)
+                               << QVariant::fromValue<CryptoManager::BlockMode>(blockMode)
+                               << QVariant::fromValue<CryptoManager::EncryptionPadding>(padding)
+                               << QVariant::fromValue<QVector<QByteArray> >(authenticationData)
+                               << QVariant::fromValue<QVector<QByteArray> >(authenticationTags)
+                               << QVariant::fromValue<QVariantMap>(customParameters)
+                               << QVariant::fromValue<QString>(cryptosystemProviderName));
+    return reply;
+}
+
+QDBusPendingReply<Result, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> >
+CryptoManagerPrivate::verifyBatch(
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Key> &keys, // or keyreferences, i.e. Key(keyName)
+        CryptoManager::SignaturePadding padding,
+        CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        const QString &cryptosystemProviderName)
+{
+    if (!m_interface) {
+        return QDBusPendingReply<Result, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> >(
+                    QDBusMessage::createError(QDBusError::Other,
+                                              QStringLiteral("Not connected to daemon")));
+    }
+
+    QDBusPendingReply<Result, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> > reply
+            = sendRequest(
+                QStringLiteral("verifyBatch"),
+                QVariantList() << QVariant::fromValue<QVector<QByteArray> >(signatures)
+                               << QVariant::fromValue<QVector<QByteArray> >(data)
+                               << QVariant::fromValue<QVector<Key> >(keys)
+                               << QVariant::fromValue<CryptoManager::SignaturePadding>(padding)
+                               << QVariant::fromValue<CryptoManager::DigestFunction>(digestFunction)
+                               << QVariant::fromValue<QVariantMap>(customParameters)
+                               << QVariant::fromValue<QString>(cryptosystemProviderName));
+    return reply;
+}
+
 QDBusPendingReply<Sailfish::Crypto::Result, quint32>
 CryptoManagerPrivate::initializeCipherSession(
         const QByteArray &initializationVector,
@@ -477,7 +705,7 @@ CryptoManagerPrivate::initializeCipherSession(
     }
 
     QDBusPendingReply<Result, quint32> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 "initializeCipherSession",
                 QVariantList() << QVariant::fromValue<QByteArray>(initializationVector)
                                << QVariant::fromValue<Key>(key)
@@ -505,7 +733,7 @@ CryptoManagerPrivate::updateCipherSessionAuthentication(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 "updateCipherSessionAuthentication",
                 QVariantList() << QVariant::fromValue<QByteArray>(authenticationData)
                                << QVariant::fromValue<QVariantMap>(customParameters)
@@ -528,7 +756,7 @@ CryptoManagerPrivate::updateCipherSession(
     }
 
     QDBusPendingReply<Result, QByteArray> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 "updateCipherSession",
                 QVariantList() << QVariant::fromValue<QByteArray>(data)
                                << QVariant::fromValue<QVariantMap>(customParameters)
@@ -551,7 +779,7 @@ CryptoManagerPrivate::finalizeCipherSession(
     }
 
     QDBusPendingReply<Result, QByteArray, Sailfish::Crypto::CryptoManager::VerificationStatus> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 "finalizeCipherSession",
                 QVariantList() << QVariant::fromValue<QByteArray>(data)
                                << QVariant::fromValue<QVariantMap>(customParameters)
@@ -572,7 +800,7 @@ CryptoManagerPrivate::queryLockStatus(
     }
 
     QDBusPendingReply<Result, LockCodeRequest::LockStatus> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 "queryLockStatus",
                 QVariantList() << QVariant::fromValue<LockCodeRequest::LockCodeTargetType>(lockCodeTargetType)
                                << QVariant::fromValue<QString>(lockCodeTarget));
@@ -592,7 +820,7 @@ CryptoManagerPrivate::modifyLockCode(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 "modifyLockCode",
                 QVariantList() << QVariant::fromValue<LockCodeRequest::LockCodeTargetType>(lockCodeTargetType)
                                << QVariant::fromValue<QString>(lockCodeTarget)
@@ -613,7 +841,7 @@ CryptoManagerPrivate::provideLockCode(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 "provideLockCode",
                 QVariantList() << QVariant::fromValue<LockCodeRequest::LockCodeTargetType>(lockCodeTargetType)
                                << QVariant::fromValue<QString>(lockCodeTarget)
@@ -634,7 +862,7 @@ CryptoManagerPrivate::forgetLockCode(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 "forgetLockCode",
                 QVariantList() << QVariant::fromValue<LockCodeRequest::LockCodeTargetType>(lockCodeTargetType)
                                << QVariant::fromValue<QString>(lockCodeTarget)
@@ -664,10 +892,14 @@ CryptoManagerPrivate::forgetLockCode(
   \li \l{DeleteStoredKeyRequest} to delete a securely-stored \l{Key}
   \li \l{EncryptRequest} to encrypt data with a given \l{Key}
   \li \l{DecryptRequest} to decrypt data with a given \l{Key}
+  \li \l{EncryptBatchRequest} to encrypt many items of data with a given \l{Key}
+  \li \l{DecryptBatchRequest} to decrypt many items of data with a given \l{Key}
   \li \l{CalculateDigestRequest} to calculate a digest (non-keyed hash) of some data
   \li \l{SignRequest} to generate a signature for some data with a given \l{Key}
   \li \l{VerifyRequest} to verify if a signature was generated with a given \l{Key}
+  \li \l{VerifyBatchRequest} to verify if many signatures were generated with given \l{Key}{Keys}
   \li \l{CipherRequest} to start a cipher session with which to encrypt, decrypt, sign or verify a stream of data
+  \li \l{RequestPipeline} to perform a sequence of dependent requests in a single round trip
   \endlist
  */
 
@@ -682,6 +914,12 @@ CryptoManager::CryptoManager(QObject *parent)
         qCWarning(lcSailfishCrypto) << "Unable to connect to the crypto daemon!  No functionality will be available!";
         return;
     }
+
+    d_ptr->m_crypto->connection()->connect(QString(), // any service
+                                           QLatin1String("/Sailfish/Crypto"),
+                                           QLatin1String("org.sailfishos.crypto"),
+                                           QLatin1String("pluginInfoChanged"),
+                                           this, SIGNAL(pluginInfoChanged()));
 }
 
 /*!
@@ -691,6 +929,14 @@ CryptoManager::~CryptoManager()
 {
 }
 
+/*!
+  \fn CryptoManager::pluginInfoChanged()
+  \brief Emitted when the availability or lock state of a plugin may have changed
+
+  Clients which display information about the plugins should perform a
+  new PluginInfoRequest when this signal is emitted, rather than polling.
+ */
+
 /*!
   \brief Returns true if the manager is initialized and can be used to perform requests.
  */
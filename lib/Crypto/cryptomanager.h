@@ -334,13 +334,18 @@ public:
 
     bool isInitialized() const;
 
+Q_SIGNALS:
+    void pluginInfoChanged();
+
 private:
     QScopedPointer<CryptoManagerPrivate> const d_ptr;
     Q_DECLARE_PRIVATE(CryptoManager)
     friend class CalculateDigestRequest;
     friend class CipherRequest;
+    friend class DecryptBatchRequest;
     friend class DecryptRequest;
     friend class DeleteStoredKeyRequest;
+    friend class EncryptBatchRequest;
     friend class EncryptRequest;
     friend class GenerateKeyRequest;
     friend class GenerateRandomDataRequest;
@@ -350,10 +355,13 @@ private:
     friend class GenerateInitializationVectorRequest;
     friend class LockCodeRequest;
     friend class PluginInfoRequest;
+    friend class RequestPipeline;
     friend class SeedRandomDataGeneratorRequest;
     friend class SignRequest;
+    friend class StatisticsRequest;
     friend class StoredKeyIdentifiersRequest;
     friend class StoredKeyRequest;
+    friend class VerifyBatchRequest;
     friend class VerifyRequest;
 };
 
@@ -28,6 +28,7 @@
 #include <QtCore/QByteArray>
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
+#include <QtCore/QList>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QVector>
@@ -49,6 +50,8 @@ public:
                       QVector<Sailfish::Crypto::PluginInfo>,
                       QVector<Sailfish::Crypto::PluginInfo> > getPluginInfo();
 
+    QDBusPendingReply<Sailfish::Crypto::Result, QVariantMap> getStatistics();
+
     QDBusPendingReply<Sailfish::Crypto::Result> seedRandomDataGenerator(
             const QByteArray &seedData,
             double entropyEstimate,
@@ -158,6 +161,36 @@ public:
             const QVariantMap &customParameters,
             const QString &cryptosystemProviderName);
 
+    QDBusPendingReply<Result, QVector<QByteArray>, QVector<QByteArray> > encryptBatch(
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Key &key, // or keyreference, i.e. Key(keyName)
+            CryptoManager::BlockMode blockMode,
+            CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVariantMap &customParameters,
+            const QString &cryptosystemProviderName);
+
+    QDBusPendingReply<Result, QVector<QByteArray>, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> > decryptBatch(
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Key &key, // or keyreference, i.e. Key(keyName)
+            CryptoManager::BlockMode blockMode,
+            CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVector<QByteArray> &authenticationTags,
+            const QVariantMap &customParameters,
+            const QString &cryptosystemProviderName);
+
+    QDBusPendingReply<Result, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> > verifyBatch(
+            const QVector<QByteArray> &signatures,
+            const QVector<QByteArray> &data,
+            const QVector<Key> &keys, // or keyreferences, i.e. Key(keyName)
+            CryptoManager::SignaturePadding padding,
+            CryptoManager::DigestFunction digestFunction,
+            const QVariantMap &customParameters,
+            const QString &cryptosystemProviderName);
+
     QDBusPendingReply<Result, quint32> initializeCipherSession(
             const QByteArray &initializationVector,
             const Sailfish::Crypto::Key &key, // or keyreference
@@ -206,10 +239,36 @@ public:
             const QString &lockCodeTarget,
             const Sailfish::Crypto::InteractionParameters &interactionParameters);
 
+    // cancel a request which was sent via this manager and may still be in progress.
+    void cancelRequest(const QDBusPendingCall &call);
+
+    // set the deadline of the next request sent via this manager.
+    void setNextRequestTimeout(int timeout);
+
+    // have the daemon run the requests sent via this manager between these calls in order, stopping at the first failure.
+    void beginPipeline();
+    void endPipeline();
+
 private:
+    // send a request to the daemon, and remember it so that it may be cancelled.
+    QDBusPendingCall sendRequest(const QString &method, const QVariantList &arguments = QVariantList());
+
+    int sentRequestIndex(const QDBusPendingCall &call) const;
+
+    struct SentRequest {
+        SentRequest(const QDBusPendingCall &c, quint64 s, const QString &m)
+            : call(c), sequence(s), method(m) {}
+        QDBusPendingCall call;
+        quint64 sequence;   // the number of the call on the daemon connection.
+        QString method;
+    };
+
     friend class CryptoManager;
     QPointer<Sailfish::Crypto::CryptoDaemonConnection> m_crypto;
     QDBusInterface *m_interface;
+    QList<SentRequest> m_sentRequests;
+    int m_nextRequestTimeout;
+    quint64 m_pipelineId; // the pipeline which requests are tagged with, if any.
 };
 
 } // namespace Crypto
@@ -0,0 +1,447 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "Crypto/decryptbatchrequest.h"
+#include "Crypto/decryptbatchrequest_p.h"
+
+#include "Crypto/cryptomanager.h"
+#include "Crypto/cryptomanager_p.h"
+#include "Crypto/serialization_p.h"
+
+#include <QtDBus/QDBusPendingReply>
+#include <QtDBus/QDBusPendingCallWatcher>
+
+using namespace Sailfish::Crypto;
+
+DecryptBatchRequestPrivate::DecryptBatchRequestPrivate()
+    : m_blockMode(Sailfish::Crypto::CryptoManager::BlockModeUnknown)
+    , m_padding(Sailfish::Crypto::CryptoManager::EncryptionPaddingUnknown)
+    , m_timeout(0)
+    , m_status(Request::Inactive)
+{
+}
+
+/*!
+ * \class DecryptBatchRequest
+ * \brief Allows a client request that the system crypto service decrypt many items of data with a specific key.
+ *
+ * This class allows clients to decrypt a batch of (typically small) items of
+ * data with the same key in a single request.  Unlike performing a
+ * \l DecryptRequest for each item, the key is resolved only once for the
+ * whole batch: if the key is a reference to a stored key, it is read from
+ * storage (and its collection unlocked, if required) once, and every item
+ * is then decrypted by the crypto plugin in a single operation.
+ *
+ * The initializationVectors(), authenticationData() and authenticationTags()
+ * may either be empty, or contain one element for each element of the data(),
+ * in the same order.
+ *
+ * The batch is decrypted all together or not at all: if any item cannot be
+ * decrypted, the request fails and no plaintexts() are reported.  If an
+ * authenticated decryption was performed, the verificationStatuses() report
+ * whether each item was verified, and should be checked by the client.
+ */
+
+/*!
+ * \brief Constructs a new DecryptBatchRequest object with the given \a parent.
+ */
+DecryptBatchRequest::DecryptBatchRequest(QObject *parent)
+    : Request(parent)
+    , d_ptr(new DecryptBatchRequestPrivate)
+{
+}
+
+/*!
+ * \brief Destroys the DecryptBatchRequest
+ */
+DecryptBatchRequest::~DecryptBatchRequest()
+{
+}
+
+/*!
+ * \brief Returns the items of data which the client wishes the system service to decrypt
+ */
+QVector<QByteArray> DecryptBatchRequest::data() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_data;
+}
+
+/*!
+ * \brief Sets the items of data which the client wishes the system service to decrypt to \a data
+ */
+void DecryptBatchRequest::setData(const QVector<QByteArray> &data)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_data != data) {
+        d->m_data = data;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit dataChanged();
+    }
+}
+
+/*!
+ * \brief Returns the initialization vectors which the client wishes to use when decrypting the data
+ */
+QVector<QByteArray> DecryptBatchRequest::initializationVectors() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_initializationVectors;
+}
+
+/*!
+ * \brief Sets the initialization vectors which the client wishes to use when decrypting the data to \a ivs
+ *
+ * The vector must either be empty, or contain one initialization vector
+ * for each item of data, in the same order.  Each must be the same
+ * initialization vector which was used when encrypting that item.
+ */
+void DecryptBatchRequest::setInitializationVectors(const QVector<QByteArray> &ivs)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_initializationVectors != ivs) {
+        d->m_initializationVectors = ivs;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit initializationVectorsChanged();
+    }
+}
+
+/*!
+ * \brief Returns the key which the client wishes the system service to use to decrypt the data
+ */
+Key DecryptBatchRequest::key() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_key;
+}
+
+/*!
+ * \brief Sets the key which the client wishes the system service to use to decrypt the data to \a key
+ */
+void DecryptBatchRequest::setKey(const Key &key)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_key != key) {
+        d->m_key = key;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit keyChanged();
+    }
+}
+
+/*!
+ * \brief Returns the block mode which should be used when decrypting the data
+ */
+Sailfish::Crypto::CryptoManager::BlockMode DecryptBatchRequest::blockMode() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_blockMode;
+}
+
+/*!
+ * \brief Sets the block mode which should be used when decrypting the data to \a mode
+ */
+void DecryptBatchRequest::setBlockMode(Sailfish::Crypto::CryptoManager::BlockMode mode)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_blockMode != mode) {
+        d->m_blockMode = mode;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit blockModeChanged();
+    }
+}
+
+/*!
+ * \brief Returns the encryption padding mode which should be used when decrypting the data
+ */
+Sailfish::Crypto::CryptoManager::EncryptionPadding DecryptBatchRequest::padding() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_padding;
+}
+
+/*!
+ * \brief Sets the encryption padding mode which should be used when decrypting the data to \a padding
+ */
+void DecryptBatchRequest::setPadding(Sailfish::Crypto::CryptoManager::EncryptionPadding padding)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_padding != padding) {
+        d->m_padding = padding;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit paddingChanged();
+    }
+}
+
+/*!
+ * \brief Returns the authentication data for the decrypt operation
+ */
+QVector<QByteArray> DecryptBatchRequest::authenticationData() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_authenticationData;
+}
+
+/*!
+ * \brief Sets the authentication data for the decrypt operation to \a data
+ *
+ * This is only required if performing an authenticated decryption, in which
+ * case the vector must contain the authentication data for each item of
+ * data, in the same order.
+ */
+void DecryptBatchRequest::setAuthenticationData(const QVector<QByteArray> &data)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_authenticationData != data) {
+        d->m_authenticationData = data;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit authenticationDataChanged();
+    }
+}
+
+/*!
+ * \brief Returns the name of the crypto plugin which the client wishes to perform the decryption operation
+ */
+QString DecryptBatchRequest::cryptoPluginName() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_cryptoPluginName;
+}
+
+/*!
+ * \brief Sets the name of the crypto plugin which the client wishes to perform the decryption operation to \a pluginName
+ */
+void DecryptBatchRequest::setCryptoPluginName(const QString &pluginName)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_cryptoPluginName != pluginName) {
+        d->m_cryptoPluginName = pluginName;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit cryptoPluginNameChanged();
+    }
+}
+
+/*!
+ * \brief Returns the authentication tags for the decrypt operation
+ */
+QVector<QByteArray> DecryptBatchRequest::authenticationTags() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_authenticationTags;
+}
+
+/*!
+ * \brief Sets the authentication tags for the decrypt operation to \a tags
+ *
+ * This is only required if performing an authenticated decryption, in which
+ * case the vector must contain the authentication tag which was reported
+ * when encrypting each item of data, in the same order.
+ */
+void DecryptBatchRequest::setAuthenticationTags(const QVector<QByteArray> &tags)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_authenticationTags != tags) {
+        d->m_authenticationTags = tags;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit authenticationTagsChanged();
+    }
+}
+
+/*!
+ * \brief Returns the plaintext of each item of data, in the same order as the data.
+ *
+ * Note: this value is only valid if the status of the request is Request::Finished.
+ */
+QVector<QByteArray> DecryptBatchRequest::plaintexts() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_plaintexts;
+}
+
+/*!
+ * \brief Returns the verification status of each item of data, in the same order as the data.
+ *
+ * Note: this value is only valid if an authenticated decryption was performed and
+ * the status of the request is Request::Finished.
+ */
+QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> DecryptBatchRequest::verificationStatuses() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_verificationStatuses;
+}
+
+Request::Status DecryptBatchRequest::status() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_status;
+}
+
+Result DecryptBatchRequest::result() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_result;
+}
+
+int DecryptBatchRequest::timeout() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_timeout;
+}
+
+void DecryptBatchRequest::setTimeout(int timeout)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
+QVariantMap DecryptBatchRequest::customParameters() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_customParameters;
+}
+
+void DecryptBatchRequest::setCustomParameters(const QVariantMap &params)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_customParameters != params) {
+        d->m_customParameters = params;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit customParametersChanged();
+    }
+}
+
+CryptoManager *DecryptBatchRequest::manager() const
+{
+    Q_D(const DecryptBatchRequest);
+    return d->m_manager.data();
+}
+
+void DecryptBatchRequest::setManager(CryptoManager *manager)
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_manager.data() != manager) {
+        d->m_manager = manager;
+        emit managerChanged();
+    }
+}
+
+void DecryptBatchRequest::startRequest()
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status != Request::Active && !d->m_manager.isNull()) {
+        d->m_status = Request::Active;
+        emit statusChanged();
+        if (d->m_result.code() != Result::Pending) {
+            d->m_result = Result(Result::Pending);
+            emit resultChanged();
+        }
+
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
+        QDBusPendingReply<Result, QVector<QByteArray>, QVector<CryptoManager::VerificationStatus> > reply =
+                d->m_manager->d_ptr->decryptBatch(d->m_data,
+                                                  d->m_initializationVectors,
+                                                  d->m_key,
+                                                  d->m_blockMode,
+                                                  d->m_padding,
+                                                  d->m_authenticationData,
+                                                  d->m_authenticationTags,
+                                                  d->m_customParameters,
+                                                  d->m_cryptoPluginName);
+        if (!reply.isValid() && !reply.error().message().isEmpty()) {
+            d->m_status = Request::Finished;
+            d->m_result = Result(Result::CryptoManagerNotInitializedError,
+                                 reply.error().message());
+            emit statusChanged();
+            emit resultChanged();
+        } else if (reply.isFinished()
+                // work around a bug in QDBusAbstractInterface / QDBusConnection...
+                && reply.argumentAt<0>().code() != Sailfish::Crypto::Result::Succeeded) {
+            d->m_status = Request::Finished;
+            d->m_result = reply.argumentAt<0>();
+            d->m_plaintexts = reply.argumentAt<1>();
+            d->m_verificationStatuses = reply.argumentAt<2>();
+            emit statusChanged();
+            emit resultChanged();
+            emit plaintextsChanged();
+            emit verificationStatusesChanged();
+        } else {
+            d->m_watcher.reset(new QDBusPendingCallWatcher(reply));
+            connect(d->m_watcher.data(), &QDBusPendingCallWatcher::finished,
+                    [this] {
+                QDBusPendingCallWatcher *watcher = this->d_ptr->m_watcher.take();
+                QDBusPendingReply<Result, QVector<QByteArray>, QVector<CryptoManager::VerificationStatus> > reply = *watcher;
+                this->d_ptr->m_status = Request::Finished;
+                this->d_ptr->m_result = reply.argumentAt<0>();
+                this->d_ptr->m_plaintexts = reply.argumentAt<1>();
+                this->d_ptr->m_verificationStatuses = reply.argumentAt<2>();
+                watcher->deleteLater();
+                emit this->statusChanged();
+                emit this->resultChanged();
+                emit this->plaintextsChanged();
+                emit this->verificationStatusesChanged();
+            });
+        }
+    }
+}
+
+void DecryptBatchRequest::waitForFinished()
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        d->m_watcher->waitForFinished();
+    }
+}
+
+void DecryptBatchRequest::cancel()
+{
+    Q_D(DecryptBatchRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
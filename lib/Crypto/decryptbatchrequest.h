@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHCRYPTO_DECRYPTBATCHREQUEST_H
+#define LIBSAILFISHCRYPTO_DECRYPTBATCHREQUEST_H
+
+#include "Crypto/cryptoglobal.h"
+#include "Crypto/request.h"
+#include "Crypto/key.h"
+#include "Crypto/cryptomanager.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+namespace Sailfish {
+
+namespace Crypto {
+
+class DecryptBatchRequestPrivate;
+class SAILFISH_CRYPTO_API DecryptBatchRequest : public Sailfish::Crypto::Request
+{
+    Q_OBJECT
+    Q_PROPERTY(QVector<QByteArray> data READ data WRITE setData NOTIFY dataChanged)
+    Q_PROPERTY(QVector<QByteArray> initializationVectors READ initializationVectors WRITE setInitializationVectors NOTIFY initializationVectorsChanged)
+    Q_PROPERTY(Sailfish::Crypto::Key key READ key WRITE setKey NOTIFY keyChanged)
+    Q_PROPERTY(Sailfish::Crypto::CryptoManager::BlockMode blockMode READ blockMode WRITE setBlockMode NOTIFY blockModeChanged)
+    Q_PROPERTY(Sailfish::Crypto::CryptoManager::EncryptionPadding padding READ padding WRITE setPadding NOTIFY paddingChanged)
+    Q_PROPERTY(QVector<QByteArray> authenticationData READ authenticationData WRITE setAuthenticationData NOTIFY authenticationDataChanged)
+    Q_PROPERTY(QVector<QByteArray> authenticationTags READ authenticationTags WRITE setAuthenticationTags NOTIFY authenticationTagsChanged)
+    Q_PROPERTY(QString cryptoPluginName READ cryptoPluginName WRITE setCryptoPluginName NOTIFY cryptoPluginNameChanged)
+    Q_PROPERTY(QVector<QByteArray> plaintexts READ plaintexts NOTIFY plaintextsChanged)
+    Q_PROPERTY(QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> verificationStatuses READ verificationStatuses NOTIFY verificationStatusesChanged)
+
+public:
+    DecryptBatchRequest(QObject *parent = Q_NULLPTR);
+    ~DecryptBatchRequest();
+
+    QVector<QByteArray> data() const;
+    void setData(const QVector<QByteArray> &data);
+
+    QVector<QByteArray> initializationVectors() const;
+    void setInitializationVectors(const QVector<QByteArray> &ivs);
+
+    Sailfish::Crypto::Key key() const;
+    void setKey(const Sailfish::Crypto::Key &key);
+
+    Sailfish::Crypto::CryptoManager::BlockMode blockMode() const;
+    void setBlockMode(Sailfish::Crypto::CryptoManager::BlockMode mode);
+
+    Sailfish::Crypto::CryptoManager::EncryptionPadding padding() const;
+    void setPadding(Sailfish::Crypto::CryptoManager::EncryptionPadding padding);
+
+    QVector<QByteArray> authenticationData() const;
+    void setAuthenticationData(const QVector<QByteArray> &data);
+
+    QVector<QByteArray> authenticationTags() const;
+    void setAuthenticationTags(const QVector<QByteArray> &tags);
+
+    QString cryptoPluginName() const;
+    void setCryptoPluginName(const QString &pluginName);
+
+    QVector<QByteArray> plaintexts() const;
+
+    QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> verificationStatuses() const;
+
+    Sailfish::Crypto::Request::Status status() const Q_DECL_OVERRIDE;
+    Sailfish::Crypto::Result result() const Q_DECL_OVERRIDE;
+
+    int timeout() const Q_DECL_OVERRIDE;
+    void setTimeout(int timeout) Q_DECL_OVERRIDE;
+
+    QVariantMap customParameters() const Q_DECL_OVERRIDE;
+    void setCustomParameters(const QVariantMap &params) Q_DECL_OVERRIDE;
+
+    Sailfish::Crypto::CryptoManager *manager() const Q_DECL_OVERRIDE;
+    void setManager(Sailfish::Crypto::CryptoManager *manager) Q_DECL_OVERRIDE;
+
+    void startRequest() Q_DECL_OVERRIDE;
+    void waitForFinished() Q_DECL_OVERRIDE;
+    void cancel() Q_DECL_OVERRIDE;
+
+Q_SIGNALS:
+    void dataChanged();
+    void initializationVectorsChanged();
+    void keyChanged();
+    void blockModeChanged();
+    void paddingChanged();
+    void authenticationDataChanged();
+    void authenticationTagsChanged();
+    void cryptoPluginNameChanged();
+    void plaintextsChanged();
+    void verificationStatusesChanged();
+
+private:
+    QScopedPointer<DecryptBatchRequestPrivate> const d_ptr;
+    Q_DECLARE_PRIVATE(DecryptBatchRequest)
+};
+
+} // namespace Crypto
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHCRYPTO_DECRYPTBATCHREQUEST_H
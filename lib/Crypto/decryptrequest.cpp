@@ -19,6 +19,7 @@ using namespace Sailfish::Crypto;
 
 DecryptRequestPrivate::DecryptRequestPrivate()
     : m_verificationStatus(Sailfish::Crypto::CryptoManager::VerificationStatusUnknown),
+      m_timeout(0),
       m_status(Request::Inactive)
 {
 }
@@ -292,6 +293,25 @@ Result DecryptRequest::result() const
     return d->m_result;
 }
 
+int DecryptRequest::timeout() const
+{
+    Q_D(const DecryptRequest);
+    return d->m_timeout;
+}
+
+void DecryptRequest::setTimeout(int timeout)
+{
+    Q_D(DecryptRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap DecryptRequest::customParameters() const
 {
     Q_D(const DecryptRequest);
@@ -343,6 +363,7 @@ void DecryptRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QByteArray, CryptoManager::VerificationStatus> reply = d->m_manager->d_ptr->decrypt(
                     d->m_data,
                     d->m_initializationVector,
@@ -397,3 +418,20 @@ void DecryptRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void DecryptRequest::cancel()
+{
+    Q_D(DecryptRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
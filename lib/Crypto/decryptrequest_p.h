@@ -42,6 +42,7 @@ public:
     QByteArray m_plaintext;
     Sailfish::Crypto::CryptoManager::VerificationStatus m_verificationStatus;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
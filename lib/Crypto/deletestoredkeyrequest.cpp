@@ -18,7 +18,8 @@
 using namespace Sailfish::Crypto;
 
 DeleteStoredKeyRequestPrivate::DeleteStoredKeyRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -80,6 +81,25 @@ Result DeleteStoredKeyRequest::result() const
     return d->m_result;
 }
 
+int DeleteStoredKeyRequest::timeout() const
+{
+    Q_D(const DeleteStoredKeyRequest);
+    return d->m_timeout;
+}
+
+void DeleteStoredKeyRequest::setTimeout(int timeout)
+{
+    Q_D(DeleteStoredKeyRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap DeleteStoredKeyRequest::customParameters() const
 {
     Q_D(const DeleteStoredKeyRequest);
@@ -127,6 +147,7 @@ void DeleteStoredKeyRequest::startRequest()
 
         // should we pass customParameters in this case, or not?
         // there's no "specific plugin" which is the target of the request..
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result> reply =
                 d->m_manager->d_ptr->deleteStoredKey(d->m_identifier);
         if (!reply.isValid() && !reply.error().message().isEmpty()) {
@@ -165,3 +186,20 @@ void DeleteStoredKeyRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void DeleteStoredKeyRequest::cancel()
+{
+    Q_D(DeleteStoredKeyRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
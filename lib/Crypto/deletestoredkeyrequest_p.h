@@ -33,6 +33,7 @@ public:
     QVariantMap m_customParameters;
     Sailfish::Crypto::Key::Identifier m_identifier;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
@@ -0,0 +1,430 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "Crypto/encryptbatchrequest.h"
+#include "Crypto/encryptbatchrequest_p.h"
+
+#include "Crypto/cryptomanager.h"
+#include "Crypto/cryptomanager_p.h"
+#include "Crypto/serialization_p.h"
+
+#include <QtDBus/QDBusPendingReply>
+#include <QtDBus/QDBusPendingCallWatcher>
+
+using namespace Sailfish::Crypto;
+
+EncryptBatchRequestPrivate::EncryptBatchRequestPrivate()
+    : m_blockMode(Sailfish::Crypto::CryptoManager::BlockModeUnknown)
+    , m_padding(Sailfish::Crypto::CryptoManager::EncryptionPaddingUnknown)
+    , m_timeout(0)
+    , m_status(Request::Inactive)
+{
+}
+
+/*!
+ * \class EncryptBatchRequest
+ * \brief Allows a client request that the system crypto service encrypt many items of data with a specific key.
+ *
+ * This class allows clients to encrypt a batch of (typically small) items of
+ * data with the same key in a single request.  Unlike performing an
+ * \l EncryptRequest for each item, the key is resolved only once for the
+ * whole batch: if the key is a reference to a stored key, it is read from
+ * storage (and its collection unlocked, if required) once, and every item
+ * is then encrypted by the crypto plugin in a single operation.
+ *
+ * The initializationVectors() and authenticationData() may either be empty,
+ * or contain one element for each element of the data(), in the same order.
+ *
+ * The batch is encrypted all together or not at all: if any item cannot be
+ * encrypted, the request fails and no ciphertexts() are reported.
+ *
+ * An example of encrypting some items of data with a stored key follows:
+ *
+ * \code
+ * Sailfish::Crypto::CryptoManager cm;
+ * Sailfish::Crypto::EncryptBatchRequest ebr;
+ * ebr.setManager(&cm);
+ * ebr.setData(QVector<QByteArray>() << "first" << "second" << "third");
+ * ebr.setInitializationVectors(ivs); // one randomly generated IV per item.
+ * ebr.setKey(Sailfish::Crypto::Key(keyName, collectionName, storagePluginName));
+ * ebr.setBlockMode(Sailfish::Crypto::CryptoManager::BlockModeCbc);
+ * ebr.setPadding(Sailfish::Crypto::CryptoManager::EncryptionPaddingNone);
+ * ebr.setCryptoPluginName(Sailfish::Crypto::CryptoManager::DefaultCryptoStoragePluginName);
+ * ebr.startRequest(); // status() will change to Finished when complete
+ * \endcode
+ */
+
+/*!
+ * \brief Constructs a new EncryptBatchRequest object with the given \a parent.
+ */
+EncryptBatchRequest::EncryptBatchRequest(QObject *parent)
+    : Request(parent)
+    , d_ptr(new EncryptBatchRequestPrivate)
+{
+}
+
+/*!
+ * \brief Destroys the EncryptBatchRequest
+ */
+EncryptBatchRequest::~EncryptBatchRequest()
+{
+}
+
+/*!
+ * \brief Returns the items of data which the client wishes the system service to encrypt
+ */
+QVector<QByteArray> EncryptBatchRequest::data() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_data;
+}
+
+/*!
+ * \brief Sets the items of data which the client wishes the system service to encrypt to \a data
+ */
+void EncryptBatchRequest::setData(const QVector<QByteArray> &data)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_data != data) {
+        d->m_data = data;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit dataChanged();
+    }
+}
+
+/*!
+ * \brief Returns the initialization vectors which the client wishes to use when encrypting the data
+ */
+QVector<QByteArray> EncryptBatchRequest::initializationVectors() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_initializationVectors;
+}
+
+/*!
+ * \brief Sets the initialization vectors which the client wishes to use when encrypting the data to \a ivs
+ *
+ * The vector must either be empty, or contain one initialization vector
+ * for each item of data, in the same order.  An initialization vector
+ * should never be reused with the same key; see
+ * \l EncryptRequest::setInitializationVector() for more information.
+ */
+void EncryptBatchRequest::setInitializationVectors(const QVector<QByteArray> &ivs)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_initializationVectors != ivs) {
+        d->m_initializationVectors = ivs;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit initializationVectorsChanged();
+    }
+}
+
+/*!
+ * \brief Returns the key which the client wishes the system service to use to encrypt the data
+ */
+Key EncryptBatchRequest::key() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_key;
+}
+
+/*!
+ * \brief Sets the key which the client wishes the system service to use to encrypt the data to \a key
+ */
+void EncryptBatchRequest::setKey(const Key &key)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_key != key) {
+        d->m_key = key;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit keyChanged();
+    }
+}
+
+/*!
+ * \brief Returns the block mode which should be used when encrypting the data
+ */
+Sailfish::Crypto::CryptoManager::BlockMode EncryptBatchRequest::blockMode() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_blockMode;
+}
+
+/*!
+ * \brief Sets the block mode which should be used when encrypting the data to \a mode
+ */
+void EncryptBatchRequest::setBlockMode(Sailfish::Crypto::CryptoManager::BlockMode mode)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_blockMode != mode) {
+        d->m_blockMode = mode;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit blockModeChanged();
+    }
+}
+
+/*!
+ * \brief Returns the encryption padding mode which should be used when encrypting the data
+ */
+Sailfish::Crypto::CryptoManager::EncryptionPadding EncryptBatchRequest::padding() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_padding;
+}
+
+/*!
+ * \brief Sets the encryption padding mode which should be used when encrypting the data to \a padding
+ */
+void EncryptBatchRequest::setPadding(Sailfish::Crypto::CryptoManager::EncryptionPadding padding)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_padding != padding) {
+        d->m_padding = padding;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit paddingChanged();
+    }
+}
+
+/*!
+ * \brief Returns the authentication data for the encrypt operation
+ */
+QVector<QByteArray> EncryptBatchRequest::authenticationData() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_authenticationData;
+}
+
+/*!
+ * \brief Sets the authentication data for the encrypt operation to \a data
+ *
+ * This is only required if performing an authenticated encryption, in which
+ * case the vector must contain the authentication data for each item of
+ * data, in the same order.
+ */
+void EncryptBatchRequest::setAuthenticationData(const QVector<QByteArray> &data)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_authenticationData != data) {
+        d->m_authenticationData = data;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit authenticationDataChanged();
+    }
+}
+
+/*!
+ * \brief Returns the name of the crypto plugin which the client wishes to perform the encryption operation
+ */
+QString EncryptBatchRequest::cryptoPluginName() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_cryptoPluginName;
+}
+
+/*!
+ * \brief Sets the name of the crypto plugin which the client wishes to perform the encryption operation to \a pluginName
+ */
+void EncryptBatchRequest::setCryptoPluginName(const QString &pluginName)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_cryptoPluginName != pluginName) {
+        d->m_cryptoPluginName = pluginName;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit cryptoPluginNameChanged();
+    }
+}
+
+/*!
+ * \brief Returns the ciphertext of each item of data, in the same order as the data.
+ *
+ * Note: this value is only valid if the status of the request is Request::Finished.
+ */
+QVector<QByteArray> EncryptBatchRequest::ciphertexts() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_ciphertexts;
+}
+
+/*!
+ * \brief Returns the authentication tag of each item of data, in the same order as the data.
+ *
+ * Note: this value is only valid if an authenticated encryption was performed and
+ * the status of the request is Request::Finished.
+ */
+QVector<QByteArray> EncryptBatchRequest::authenticationTags() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_authenticationTags;
+}
+
+Request::Status EncryptBatchRequest::status() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_status;
+}
+
+Result EncryptBatchRequest::result() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_result;
+}
+
+int EncryptBatchRequest::timeout() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_timeout;
+}
+
+void EncryptBatchRequest::setTimeout(int timeout)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
+QVariantMap EncryptBatchRequest::customParameters() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_customParameters;
+}
+
+void EncryptBatchRequest::setCustomParameters(const QVariantMap &params)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_customParameters != params) {
+        d->m_customParameters = params;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit customParametersChanged();
+    }
+}
+
+CryptoManager *EncryptBatchRequest::manager() const
+{
+    Q_D(const EncryptBatchRequest);
+    return d->m_manager.data();
+}
+
+void EncryptBatchRequest::setManager(CryptoManager *manager)
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_manager.data() != manager) {
+        d->m_manager = manager;
+        emit managerChanged();
+    }
+}
+
+void EncryptBatchRequest::startRequest()
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status != Request::Active && !d->m_manager.isNull()) {
+        d->m_status = Request::Active;
+        emit statusChanged();
+        if (d->m_result.code() != Result::Pending) {
+            d->m_result = Result(Result::Pending);
+            emit resultChanged();
+        }
+
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
+        QDBusPendingReply<Result, QVector<QByteArray>, QVector<QByteArray> > reply =
+                d->m_manager->d_ptr->encryptBatch(d->m_data,
+                                                  d->m_initializationVectors,
+                                                  d->m_key,
+                                                  d->m_blockMode,
+                                                  d->m_padding,
+                                                  d->m_authenticationData,
+                                                  d->m_customParameters,
+                                                  d->m_cryptoPluginName);
+        if (!reply.isValid() && !reply.error().message().isEmpty()) {
+            d->m_status = Request::Finished;
+            d->m_result = Result(Result::CryptoManagerNotInitializedError,
+                                 reply.error().message());
+            emit statusChanged();
+            emit resultChanged();
+        } else if (reply.isFinished()
+                // work around a bug in QDBusAbstractInterface / QDBusConnection...
+                && reply.argumentAt<0>().code() != Sailfish::Crypto::Result::Succeeded) {
+            d->m_status = Request::Finished;
+            d->m_result = reply.argumentAt<0>();
+            d->m_ciphertexts = reply.argumentAt<1>();
+            d->m_authenticationTags = reply.argumentAt<2>();
+            emit statusChanged();
+            emit resultChanged();
+            emit ciphertextsChanged();
+            emit authenticationTagsChanged();
+        } else {
+            d->m_watcher.reset(new QDBusPendingCallWatcher(reply));
+            connect(d->m_watcher.data(), &QDBusPendingCallWatcher::finished,
+                    [this] {
+                QDBusPendingCallWatcher *watcher = this->d_ptr->m_watcher.take();
+                QDBusPendingReply<Result, QVector<QByteArray>, QVector<QByteArray> > reply = *watcher;
+                this->d_ptr->m_status = Request::Finished;
+                this->d_ptr->m_result = reply.argumentAt<0>();
+                this->d_ptr->m_ciphertexts = reply.argumentAt<1>();
+                this->d_ptr->m_authenticationTags = reply.argumentAt<2>();
+                watcher->deleteLater();
+                emit this->statusChanged();
+                emit this->resultChanged();
+                emit this->ciphertextsChanged();
+                emit this->authenticationTagsChanged();
+            });
+        }
+    }
+}
+
+void EncryptBatchRequest::waitForFinished()
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        d->m_watcher->waitForFinished();
+    }
+}
+
+void EncryptBatchRequest::cancel()
+{
+    Q_D(EncryptBatchRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHCRYPTO_ENCRYPTBATCHREQUEST_P_H
+#define LIBSAILFISHCRYPTO_ENCRYPTBATCHREQUEST_P_H
+
+#include "Crypto/cryptoglobal.h"
+#include "Crypto/encryptbatchrequest.h"
+#include "Crypto/cryptomanager.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <QtDBus/QDBusPendingCallWatcher>
+
+namespace Sailfish {
+
+namespace Crypto {
+
+class EncryptBatchRequestPrivate
+{
+    Q_DISABLE_COPY(EncryptBatchRequestPrivate)
+
+public:
+    explicit EncryptBatchRequestPrivate();
+
+    QPointer<Sailfish::Crypto::CryptoManager> m_manager;
+    QVariantMap m_customParameters;
+    QVector<QByteArray> m_data;
+    QVector<QByteArray> m_initializationVectors;
+    Sailfish::Crypto::Key m_key;
+    Sailfish::Crypto::CryptoManager::BlockMode m_blockMode;
+    Sailfish::Crypto::CryptoManager::EncryptionPadding m_padding;
+    QString m_cryptoPluginName;
+    QVector<QByteArray> m_ciphertexts;
+    QVector<QByteArray> m_authenticationData;
+    QVector<QByteArray> m_authenticationTags;
+
+    int m_timeout;
+    QScopedPointer<QDBusPendingCallWatcher> m_watcher;
+    Sailfish::Crypto::Request::Status m_status;
+    Sailfish::Crypto::Result m_result;
+};
+
+} // namespace Crypto
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHCRYPTO_ENCRYPTBATCHREQUEST_P_H
@@ -18,7 +18,8 @@
 using namespace Sailfish::Crypto;
 
 EncryptRequestPrivate::EncryptRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -266,6 +267,25 @@ Result EncryptRequest::result() const
     return d->m_result;
 }
 
+int EncryptRequest::timeout() const
+{
+    Q_D(const EncryptRequest);
+    return d->m_timeout;
+}
+
+void EncryptRequest::setTimeout(int timeout)
+{
+    Q_D(EncryptRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap EncryptRequest::customParameters() const
 {
     Q_D(const EncryptRequest);
@@ -317,6 +337,7 @@ void EncryptRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QByteArray, QByteArray> reply =
                 d->m_manager->d_ptr->encrypt(d->m_data,
                                              d->m_initializationVector,
@@ -370,3 +391,20 @@ void EncryptRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void EncryptRequest::cancel()
+{
+    Q_D(EncryptRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
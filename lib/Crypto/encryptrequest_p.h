@@ -41,6 +41,7 @@ public:
     QByteArray m_authenticationData;
     QByteArray m_authenticationTag;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
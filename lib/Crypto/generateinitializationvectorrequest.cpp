@@ -20,6 +20,7 @@ GenerateInitializationVectorRequestPrivate::GenerateInitializationVectorRequestP
     : m_algorithm(CryptoManager::AlgorithmUnknown)
     , m_blockMode(CryptoManager::BlockModeCbc)
     , m_keySize(-1)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -163,6 +164,25 @@ Result GenerateInitializationVectorRequest::result() const
     return d->m_result;
 }
 
+int GenerateInitializationVectorRequest::timeout() const
+{
+    Q_D(const GenerateInitializationVectorRequest);
+    return d->m_timeout;
+}
+
+void GenerateInitializationVectorRequest::setTimeout(int timeout)
+{
+    Q_D(GenerateInitializationVectorRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap GenerateInitializationVectorRequest::customParameters() const
 {
     Q_D(const GenerateInitializationVectorRequest);
@@ -208,6 +228,7 @@ void GenerateInitializationVectorRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QByteArray> reply =
                 d->m_manager->d_ptr->generateInitializationVector(d->m_algorithm,
                                                                   d->m_blockMode,
@@ -254,3 +275,20 @@ void GenerateInitializationVectorRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void GenerateInitializationVectorRequest::cancel()
+{
+    Q_D(GenerateInitializationVectorRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
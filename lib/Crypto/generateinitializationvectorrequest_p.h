@@ -40,6 +40,7 @@ public:
     Sailfish::Crypto::CryptoManager::BlockMode m_blockMode;
     int m_keySize;
 
+    int m_timeout;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
 };
@@ -18,7 +18,8 @@
 using namespace Sailfish::Crypto;
 
 GenerateKeyRequestPrivate::GenerateKeyRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -181,6 +182,25 @@ Result GenerateKeyRequest::result() const
     return d->m_result;
 }
 
+int GenerateKeyRequest::timeout() const
+{
+    Q_D(const GenerateKeyRequest);
+    return d->m_timeout;
+}
+
+void GenerateKeyRequest::setTimeout(int timeout)
+{
+    Q_D(GenerateKeyRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap GenerateKeyRequest::customParameters() const
 {
     Q_D(const GenerateKeyRequest);
@@ -226,6 +246,7 @@ void GenerateKeyRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, Key> reply =
                 d->m_manager->d_ptr->generateKey(d->m_keyTemplate,
                                                  d->m_kpgParams,
@@ -272,3 +293,20 @@ void GenerateKeyRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void GenerateKeyRequest::cancel()
+{
+    Q_D(GenerateKeyRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -22,6 +22,7 @@ const QString GenerateRandomDataRequest::DefaultCsprngEngineName = QStringLitera
 GenerateRandomDataRequestPrivate::GenerateRandomDataRequestPrivate()
     : m_csprngEngineName(GenerateRandomDataRequest::DefaultCsprngEngineName)
     , m_numberBytes(0)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -177,6 +178,25 @@ Result GenerateRandomDataRequest::result() const
     return d->m_result;
 }
 
+int GenerateRandomDataRequest::timeout() const
+{
+    Q_D(const GenerateRandomDataRequest);
+    return d->m_timeout;
+}
+
+void GenerateRandomDataRequest::setTimeout(int timeout)
+{
+    Q_D(GenerateRandomDataRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap GenerateRandomDataRequest::customParameters() const
 {
     Q_D(const GenerateRandomDataRequest);
@@ -222,6 +242,7 @@ void GenerateRandomDataRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QByteArray> reply =
                 d->m_manager->d_ptr->generateRandomData(d->m_numberBytes,
                                                         d->m_csprngEngineName,
@@ -267,3 +288,20 @@ void GenerateRandomDataRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void GenerateRandomDataRequest::cancel()
+{
+    Q_D(GenerateRandomDataRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
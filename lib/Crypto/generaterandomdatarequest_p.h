@@ -37,6 +37,7 @@ public:
     quint64 m_numberBytes;
     QByteArray m_generatedData;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
@@ -18,7 +18,8 @@
 using namespace Sailfish::Crypto;
 
 GenerateStoredKeyRequestPrivate::GenerateStoredKeyRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -325,6 +326,25 @@ Result GenerateStoredKeyRequest::result() const
     return d->m_result;
 }
 
+int GenerateStoredKeyRequest::timeout() const
+{
+    Q_D(const GenerateStoredKeyRequest);
+    return d->m_timeout;
+}
+
+void GenerateStoredKeyRequest::setTimeout(int timeout)
+{
+    Q_D(GenerateStoredKeyRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap GenerateStoredKeyRequest::customParameters() const
 {
     Q_D(const GenerateStoredKeyRequest);
@@ -370,6 +390,7 @@ void GenerateStoredKeyRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, Key> reply =
                 d->m_manager->d_ptr->generateStoredKey(d->m_keyTemplate,
                                                        d->m_kpgParams,
@@ -417,3 +438,20 @@ void GenerateStoredKeyRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void GenerateStoredKeyRequest::cancel()
+{
+    Q_D(GenerateStoredKeyRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
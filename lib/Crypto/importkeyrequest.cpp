@@ -17,7 +17,8 @@
 using namespace Sailfish::Crypto;
 
 ImportKeyRequestPrivate::ImportKeyRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -148,6 +149,25 @@ Result ImportKeyRequest::result() const
     return d->m_result;
 }
 
+int ImportKeyRequest::timeout() const
+{
+    Q_D(const ImportKeyRequest);
+    return d->m_timeout;
+}
+
+void ImportKeyRequest::setTimeout(int timeout)
+{
+    Q_D(ImportKeyRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap ImportKeyRequest::customParameters() const
 {
     Q_D(const ImportKeyRequest);
@@ -193,6 +213,7 @@ void ImportKeyRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, Key> reply =
                 d->m_manager->d_ptr->importKey(d->m_data,
                                                d->m_uiParams,
@@ -244,3 +265,20 @@ void ImportKeyRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void ImportKeyRequest::cancel()
+{
+    Q_D(ImportKeyRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
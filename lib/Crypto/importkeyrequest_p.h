@@ -36,6 +36,7 @@ public:
     QByteArray m_data;
     Sailfish::Crypto::Key m_importedKey;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
@@ -17,7 +17,8 @@
 using namespace Sailfish::Crypto;
 
 ImportStoredKeyRequestPrivate::ImportStoredKeyRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -232,6 +233,25 @@ Result ImportStoredKeyRequest::result() const
     return d->m_result;
 }
 
+int ImportStoredKeyRequest::timeout() const
+{
+    Q_D(const ImportStoredKeyRequest);
+    return d->m_timeout;
+}
+
+void ImportStoredKeyRequest::setTimeout(int timeout)
+{
+    Q_D(ImportStoredKeyRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap ImportStoredKeyRequest::customParameters() const
 {
     Q_D(const ImportStoredKeyRequest);
@@ -277,6 +297,7 @@ void ImportStoredKeyRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, Key> reply =
                 d->m_manager->d_ptr->importStoredKey(d->m_data,
                                                      d->m_keyTemplate,
@@ -329,3 +350,20 @@ void ImportStoredKeyRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void ImportStoredKeyRequest::cancel()
+{
+    Q_D(ImportStoredKeyRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -39,6 +39,7 @@ public:
     Sailfish::Crypto::Key m_keyTemplate;
     Sailfish::Crypto::Key m_importedKeyReference;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
@@ -37,6 +37,7 @@ public:
     Sailfish::Crypto::InteractionParameters m_interactionParameters;
     QString m_lockCodeTarget;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
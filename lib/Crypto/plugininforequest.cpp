@@ -19,13 +19,18 @@
 using namespace Sailfish::Crypto;
 
 PluginInfoRequestPrivate::PluginInfoRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
 /*!
  * \class PluginInfoRequest
  * \brief Allows a client request information about available crypto and storage plugins
+ *
+ * The CryptoManager emits \c{pluginInfoChanged()} when the availability or
+ * lock state of a plugin may have changed, after which the request may be
+ * performed again.
  */
 
 /*!
@@ -81,6 +86,25 @@ Result PluginInfoRequest::result() const
     return d->m_result;
 }
 
+int PluginInfoRequest::timeout() const
+{
+    Q_D(const PluginInfoRequest);
+    return d->m_timeout;
+}
+
+void PluginInfoRequest::setTimeout(int timeout)
+{
+    Q_D(PluginInfoRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap PluginInfoRequest::customParameters() const
 {
     Q_D(const PluginInfoRequest);
@@ -128,6 +152,7 @@ void PluginInfoRequest::startRequest()
 
         // should we pass customParameters in this case, or not?
         // there's no "specific plugin" which is the target of the request..
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QVector<PluginInfo>, QVector<PluginInfo> > reply =
                 d->m_manager->d_ptr->getPluginInfo();
         if (!reply.isValid() && !reply.error().message().isEmpty()) {
@@ -174,3 +199,20 @@ void PluginInfoRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void PluginInfoRequest::cancel()
+{
+    Q_D(PluginInfoRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
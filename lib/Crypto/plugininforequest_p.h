@@ -34,6 +34,7 @@ public:
     QVector<Sailfish::Crypto::PluginInfo> m_cryptoPlugins;
     QVector<Sailfish::Crypto::PluginInfo> m_storagePlugins;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
@@ -26,6 +26,7 @@ class SAILFISH_CRYPTO_API Request : public QObject
     Q_PROPERTY(QVariantMap customParameters READ customParameters WRITE setCustomParameters NOTIFY customParametersChanged)
     Q_PROPERTY(Sailfish::Crypto::Request::Status status READ status NOTIFY statusChanged)
     Q_PROPERTY(Sailfish::Crypto::Result result READ result NOTIFY resultChanged)
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
 
 public:
     enum Status {
@@ -45,12 +46,16 @@ public:
     virtual Sailfish::Crypto::Result result() const = 0;
     Q_INVOKABLE virtual void startRequest() = 0;
     Q_INVOKABLE virtual void waitForFinished() = 0;
+    virtual int timeout() const;
+    virtual void setTimeout(int timeout);
+    Q_INVOKABLE virtual void cancel();
 
 Q_SIGNALS:
     void managerChanged();
     void customParametersChanged();
     void statusChanged();
     void resultChanged();
+    void timeoutChanged();
 };
 
 } // namespace Crypto
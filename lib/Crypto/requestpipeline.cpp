@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "Crypto/requestpipeline.h"
+#include "Crypto/requestpipeline_p.h"
+
+#include "Crypto/cryptomanager.h"
+#include "Crypto/cryptomanager_p.h"
+
+using namespace Sailfish::Crypto;
+
+RequestPipelinePrivate::RequestPipelinePrivate()
+    : m_starting(false)
+    , m_timeout(0)
+    , m_status(Request::Inactive)
+{
+}
+
+/*!
+ * \class RequestPipeline
+ * \brief Allows a client to perform a sequence of dependent requests without
+ *        waiting for the reply to each of them before sending the next one
+ *
+ * The requests() of the pipeline are sent to the Crypto service all at once
+ * when the pipeline is started, and the service performs them in the order in
+ * which they were given, starting each request only once the previous one has
+ * succeeded.  If one of the requests fails, the remaining requests fail with
+ * the error code \c{Result::PipelineAbortedError} without being performed.
+ * A workflow of N requests therefore costs a single round trip to the service
+ * rather than N, while still stopping at the first failure.
+ *
+ * Each of the requests reports its own status and result as usual.  The
+ * pipeline is finished once all of its requests are finished, and its result
+ * is the result of the first request which failed, if any.  All of the
+ * requests are performed via the manager() of the pipeline, with their own
+ * custom parameters.  A pipeline may not itself be one of the requests of
+ * another pipeline.
+ *
+ * An example of generating a stored key and then signing some data with it
+ * follows:
+ *
+ * \code
+ * Sailfish::Crypto::Key keyTemplate;
+ * keyTemplate.setAlgorithm(Sailfish::Crypto::CryptoManager::AlgorithmEc);
+ * keyTemplate.setOrigin(Sailfish::Crypto::Key::OriginDevice);
+ * keyTemplate.setOperations(Sailfish::Crypto::CryptoManager::OperationSign | Sailfish::Crypto::CryptoManager::OperationVerify);
+ * keyTemplate.setIdentifier(
+ *         Sailfish::Crypto::Key::Identifier(
+ *             QLatin1String("ExampleKey"),
+ *             QLatin1String("ExampleCollection"),
+ *             Sailfish::Crypto::CryptoManager::DefaultCryptoStoragePluginName));
+ *
+ * Sailfish::Crypto::CryptoManager cm;
+ * Sailfish::Crypto::GenerateStoredKeyRequest gskr;
+ * gskr.setCryptoPluginName(Sailfish::Crypto::CryptoManager::DefaultCryptoStoragePluginName);
+ * gskr.setKeyPairGenerationParameters(Sailfish::Crypto::EcKeyPairGenerationParameters());
+ * gskr.setKeyTemplate(keyTemplate);
+ *
+ * // the key is referred to by its identifier, as it does not exist yet.
+ * Sailfish::Crypto::SignRequest sr;
+ * sr.setCryptoPluginName(Sailfish::Crypto::CryptoManager::DefaultCryptoStoragePluginName);
+ * sr.setKey(Sailfish::Crypto::Key(keyTemplate.identifier().name(),
+ *                                 keyTemplate.identifier().collectionName(),
+ *                                 keyTemplate.identifier().storagePluginName()));
+ * sr.setData("Some data to sign");
+ * sr.setDigestFunction(Sailfish::Crypto::CryptoManager::DigestSha256);
+ *
+ * Sailfish::Crypto::RequestPipeline pipeline;
+ * pipeline.setManager(&cm);
+ * pipeline.setRequests(QList<Sailfish::Crypto::Request*>() << &gskr << &sr);
+ * pipeline.startRequest(); // status() will change to Finished when all requests are complete
+ * \endcode
+ */
+
+/*!
+ * \brief Constructs a new RequestPipeline object with the given \a parent.
+ */
+RequestPipeline::RequestPipeline(QObject *parent)
+    : Request(parent)
+    , d_ptr(new RequestPipelinePrivate)
+{
+}
+
+/*!
+ * \brief Destroys the RequestPipeline
+ *
+ * The requests of the pipeline are not destroyed.
+ */
+RequestPipeline::~RequestPipeline()
+{
+    Q_D(RequestPipeline);
+    for (const QMetaObject::Connection &connection : d->m_connections) {
+        disconnect(connection);
+    }
+}
+
+/*!
+ * \brief Returns the requests which will be performed, in order, by the pipeline
+ */
+QList<Request*> RequestPipeline::requests() const
+{
+    Q_D(const RequestPipeline);
+    QList<Request*> requests;
+    for (const QPointer<Request> &request : d->m_requests) {
+        if (!request.isNull()) {
+            requests.append(request.data());
+        }
+    }
+    return requests;
+}
+
+/*!
+ * \brief Sets the requests which will be performed, in order, by the pipeline to \a requests
+ *
+ * The pipeline does not take ownership of the requests.
+ */
+void RequestPipeline::setRequests(const QList<Request*> &requests)
+{
+    Q_D(RequestPipeline);
+    if (d->m_status != Request::Active && this->requests() != requests) {
+        d->m_requests.clear();
+        for (Request *request : requests) {
+            d->m_requests.append(QPointer<Request>(request));
+        }
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit requestsChanged();
+    }
+}
+
+Request::Status RequestPipeline::status() const
+{
+    Q_D(const RequestPipeline);
+    return d->m_status;
+}
+
+/*!
+ * \brief Returns the result of the first request of the pipeline which failed,
+ *        or a successful result if all of the requests succeeded
+ */
+Result RequestPipeline::result() const
+{
+    Q_D(const RequestPipeline);
+    return d->m_result;
+}
+
+/*!
+ * \brief Returns the custom parameters of the pipeline
+ *
+ * The custom parameters of the pipeline are not passed to its requests,
+ * each of which is performed with its own custom parameters.
+ */
+QVariantMap RequestPipeline::customParameters() const
+{
+    Q_D(const RequestPipeline);
+    return d->m_customParameters;
+}
+
+/*!
+ * \brief Sets the custom parameters of the pipeline to \a params
+ */
+void RequestPipeline::setCustomParameters(const QVariantMap &params)
+{
+    Q_D(RequestPipeline);
+    if (d->m_customParameters != params) {
+        d->m_customParameters = params;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit customParametersChanged();
+    }
+}
+
+int RequestPipeline::timeout() const
+{
+    Q_D(const RequestPipeline);
+    return d->m_timeout;
+}
+
+/*!
+ * \brief Sets the deadline of the requests of the pipeline to \a timeout milliseconds
+ *
+ * When the pipeline is started, the deadline is set on each of its requests
+ * which does not have a deadline of its own.
+ */
+void RequestPipeline::setTimeout(int timeout)
+{
+    Q_D(RequestPipeline);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
+CryptoManager *RequestPipeline::manager() const
+{
+    Q_D(const RequestPipeline);
+    return d->m_manager.data();
+}
+
+void RequestPipeline::setManager(CryptoManager *manager)
+{
+    Q_D(RequestPipeline);
+    if (d->m_manager.data() != manager) {
+        d->m_manager = manager;
+        emit managerChanged();
+    }
+}
+
+void RequestPipeline::startRequest()
+{
+    Q_D(RequestPipeline);
+    if (d->m_status != Request::Active && !d->m_manager.isNull()) {
+        d->m_status = Request::Active;
+        emit statusChanged();
+        if (d->m_result.code() != Result::Pending) {
+            d->m_result = Result(Result::Pending);
+            emit resultChanged();
+        }
+
+        // The daemon orders the requests tagged with the pipeline's id, which
+        // the manager does between beginning and ending the pipeline, so they
+        // are all sent without waiting for replies.
+        // Requests may finish while they are being started (e.g. if the
+        // daemon rejects them), so completion is only checked afterwards.
+        d->m_starting = true;
+        d->m_manager->d_ptr->beginPipeline();
+        for (const QPointer<Request> &request : d->m_requests) {
+            if (request.isNull()) {
+                continue;
+            }
+            d->m_connections.append(connect(request.data(), &Request::statusChanged,
+                                            this, [this] { this->finishIfComplete(); }));
+            d->m_connections.append(connect(request.data(), &QObject::destroyed,
+                                            this, [this] { this->finishIfComplete(); }));
+            request->setManager(d->m_manager.data());
+            if (d->m_timeout > 0 && request->timeout() == 0) {
+                request->setTimeout(d->m_timeout);
+            }
+            request->startRequest();
+        }
+        d->m_manager->d_ptr->endPipeline();
+        d->m_starting = false;
+        finishIfComplete();
+    }
+}
+
+void RequestPipeline::waitForFinished()
+{
+    Q_D(RequestPipeline);
+    // the requests are performed in order, so they are waited for in order.
+    for (int i = 0; i < d->m_requests.size() && d->m_status == Request::Active; ++i) {
+        const QPointer<Request> request = d->m_requests.at(i);
+        if (!request.isNull() && request->status() == Request::Active) {
+            request->waitForFinished();
+        }
+    }
+}
+
+void RequestPipeline::cancel()
+{
+    Q_D(RequestPipeline);
+    if (d->m_status == Request::Active) {
+        for (const QMetaObject::Connection &connection : d->m_connections) {
+            disconnect(connection);
+        }
+        d->m_connections.clear();
+        // cancel the later requests first, so that the daemon does not
+        // fail them on account of the cancellation of an earlier request.
+        for (int i = d->m_requests.size() - 1; i >= 0; --i) {
+            const QPointer<Request> request = d->m_requests.at(i);
+            if (!request.isNull()) {
+                request->cancel();
+            }
+        }
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
+
+void RequestPipeline::finishIfComplete()
+{
+    Q_D(RequestPipeline);
+    if (d->m_status != Request::Active || d->m_starting) {
+        return;
+    }
+
+    Result result(Result::Succeeded);
+    for (const QPointer<Request> &request : d->m_requests) {
+        if (request.isNull()) {
+            continue;
+        } else if (request->status() != Request::Finished) {
+            return;
+        } else if (result.code() == Result::Succeeded && request->result().code() == Result::Failed) {
+            result = request->result();
+        }
+    }
+
+    for (const QMetaObject::Connection &connection : d->m_connections) {
+        disconnect(connection);
+    }
+    d->m_connections.clear();
+    d->m_status = Request::Finished;
+    d->m_result = result;
+    emit statusChanged();
+    emit resultChanged();
+}
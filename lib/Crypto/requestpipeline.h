@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHCRYPTO_REQUESTPIPELINE_H
+#define LIBSAILFISHCRYPTO_REQUESTPIPELINE_H
+
+#include "Crypto/cryptoglobal.h"
+#include "Crypto/request.h"
+#include "Crypto/result.h"
+#include "Crypto/cryptomanager.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QList>
+#include <QtCore/QVariantMap>
+
+namespace Sailfish {
+
+namespace Crypto {
+
+class RequestPipelinePrivate;
+class SAILFISH_CRYPTO_API RequestPipeline : public Sailfish::Crypto::Request
+{
+    Q_OBJECT
+
+public:
+    RequestPipeline(QObject *parent = Q_NULLPTR);
+    ~RequestPipeline();
+
+    QList<Sailfish::Crypto::Request*> requests() const;
+    void setRequests(const QList<Sailfish::Crypto::Request*> &requests);
+
+    QVariantMap customParameters() const Q_DECL_OVERRIDE;
+    void setCustomParameters(const QVariantMap &params) Q_DECL_OVERRIDE;
+
+    Sailfish::Crypto::Request::Status status() const Q_DECL_OVERRIDE;
+    Sailfish::Crypto::Result result() const Q_DECL_OVERRIDE;
+
+    int timeout() const Q_DECL_OVERRIDE;
+    void setTimeout(int timeout) Q_DECL_OVERRIDE;
+
+    Sailfish::Crypto::CryptoManager *manager() const Q_DECL_OVERRIDE;
+    void setManager(Sailfish::Crypto::CryptoManager *manager) Q_DECL_OVERRIDE;
+
+    void startRequest() Q_DECL_OVERRIDE;
+    void waitForFinished() Q_DECL_OVERRIDE;
+    void cancel() Q_DECL_OVERRIDE;
+
+Q_SIGNALS:
+    void requestsChanged();
+
+private:
+    void finishIfComplete();
+
+    QScopedPointer<RequestPipelinePrivate> const d_ptr;
+    Q_DECLARE_PRIVATE(RequestPipeline)
+};
+
+} // namespace Crypto
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHCRYPTO_REQUESTPIPELINE_H
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHCRYPTO_REQUESTPIPELINE_P_H
+#define LIBSAILFISHCRYPTO_REQUESTPIPELINE_P_H
+
+#include "Crypto/cryptoglobal.h"
+#include "Crypto/cryptomanager.h"
+#include "Crypto/request.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QList>
+#include <QtCore/QMetaObject>
+#include <QtCore/QVariantMap>
+
+namespace Sailfish {
+
+namespace Crypto {
+
+class RequestPipelinePrivate
+{
+    Q_DISABLE_COPY(RequestPipelinePrivate)
+
+public:
+    explicit RequestPipelinePrivate();
+
+    QPointer<Sailfish::Crypto::CryptoManager> m_manager;
+    QList<QPointer<Sailfish::Crypto::Request> > m_requests;
+    QList<QMetaObject::Connection> m_connections; // to the requests, while the pipeline is active.
+    QVariantMap m_customParameters;
+    bool m_starting;
+
+    int m_timeout;
+    Sailfish::Crypto::Request::Status m_status;
+    Sailfish::Crypto::Result m_result;
+};
+
+} // namespace Crypto
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHCRYPTO_REQUESTPIPELINE_P_H
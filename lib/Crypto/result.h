@@ -26,6 +26,7 @@ class SAILFISH_CRYPTO_API Result
     Q_PROPERTY(int storageErrorCode READ storageErrorCode WRITE setStorageErrorCode)
     Q_PROPERTY(Sailfish::Crypto::Result::ErrorCode errorCode READ errorCode WRITE setErrorCode)
     Q_PROPERTY(Sailfish::Crypto::Result::ResultCode code READ code WRITE setCode)
+    Q_PROPERTY(int retryAfter READ retryAfter WRITE setRetryAfter)
 
 public:
     enum ResultCode {
@@ -41,6 +42,10 @@ public:
         SerializationError = 3,
         StorageError = 4,
         DaemonError = 5,
+        DaemonBusyError = 6,
+        OperationCanceledError = 7,
+        RequestTimedOutError = 8,
+        PipelineAbortedError = 9,
 
         InvalidCryptographicServiceProvider = 10,
         InvalidStorageProvider,
@@ -156,6 +161,9 @@ public:
     void setCode(Sailfish::Crypto::Result::ResultCode c);
     Sailfish::Crypto::Result::ResultCode code() const;
 
+    void setRetryAfter(int msecs);
+    int retryAfter() const;
+
 private:
     QSharedDataPointer<ResultPrivate> d_ptr;
     friend class ResultPrivate;
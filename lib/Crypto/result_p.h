@@ -28,6 +28,7 @@ public:
     int m_storageErrorCode;
     Sailfish::Crypto::Result::ErrorCode m_errorCode;
     Sailfish::Crypto::Result::ResultCode m_code;
+    int m_retryAfter;
 };
 
 } // namespace Crypto
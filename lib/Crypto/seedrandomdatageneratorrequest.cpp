@@ -22,6 +22,7 @@ const QString SeedRandomDataGeneratorRequest::DefaultCsprngEngineName = QStringL
 SeedRandomDataGeneratorRequestPrivate::SeedRandomDataGeneratorRequestPrivate()
     : m_csprngEngineName(SeedRandomDataGeneratorRequest::DefaultCsprngEngineName)
     , m_entropyEstimate(1.0)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -177,6 +178,25 @@ Result SeedRandomDataGeneratorRequest::result() const
     return d->m_result;
 }
 
+int SeedRandomDataGeneratorRequest::timeout() const
+{
+    Q_D(const SeedRandomDataGeneratorRequest);
+    return d->m_timeout;
+}
+
+void SeedRandomDataGeneratorRequest::setTimeout(int timeout)
+{
+    Q_D(SeedRandomDataGeneratorRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap SeedRandomDataGeneratorRequest::customParameters() const
 {
     Q_D(const SeedRandomDataGeneratorRequest);
@@ -222,6 +242,7 @@ void SeedRandomDataGeneratorRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result> reply =
                 d->m_manager->d_ptr->seedRandomDataGenerator(
                         d->m_seedData,
@@ -265,3 +286,20 @@ void SeedRandomDataGeneratorRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void SeedRandomDataGeneratorRequest::cancel()
+{
+    Q_D(SeedRandomDataGeneratorRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
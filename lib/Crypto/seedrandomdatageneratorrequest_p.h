@@ -37,6 +37,7 @@ public:
     double m_entropyEstimate;
     QByteArray m_seedData;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
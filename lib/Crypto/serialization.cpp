@@ -620,7 +620,7 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, Key::Components &
 QDBusArgument &operator<<(QDBusArgument &argument, const Result &result)
 {
     argument.beginStructure();
-    argument << static_cast<int>(result.code()) << result.errorCode() << result.storageErrorCode() << result.errorMessage();
+    argument << static_cast<int>(result.code()) << result.errorCode() << result.storageErrorCode() << result.errorMessage() << result.retryAfter();
     argument.endStructure();
     return argument;
 }
@@ -631,15 +631,17 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, Result &result)
     int errorCode = 0;
     int storageErrorCode = 0;
     QString message;
+    int retryAfter = 0;
 
     argument.beginStructure();
-    argument >> code >> errorCode >> storageErrorCode >> message;
+    argument >> code >> errorCode >> storageErrorCode >> message >> retryAfter;
     argument.endStructure();
 
     result.setCode(static_cast<Result::ResultCode>(code));
     result.setErrorCode(static_cast<Result::ErrorCode>(errorCode));
     result.setStorageErrorCode(storageErrorCode);
     result.setErrorMessage(message);
+    result.setRetryAfter(retryAfter);
     return argument;
 }
 
@@ -20,6 +20,7 @@ using namespace Sailfish::Crypto;
 SignRequestPrivate::SignRequestPrivate()
     : m_padding(CryptoManager::SignaturePaddingUnknown)
     , m_digestFunction(CryptoManager::DigestUnknown)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -204,6 +205,25 @@ Result SignRequest::result() const
     return d->m_result;
 }
 
+int SignRequest::timeout() const
+{
+    Q_D(const SignRequest);
+    return d->m_timeout;
+}
+
+void SignRequest::setTimeout(int timeout)
+{
+    Q_D(SignRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap SignRequest::customParameters() const
 {
     Q_D(const SignRequest);
@@ -249,6 +269,7 @@ void SignRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QByteArray> reply =
                 d->m_manager->d_ptr->sign(d->m_data,
                                           d->m_key,
@@ -296,3 +317,20 @@ void SignRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void SignRequest::cancel()
+{
+    Q_D(SignRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "Crypto/statisticsrequest.h"
+#include "Crypto/statisticsrequest_p.h"
+
+#include "Crypto/cryptomanager.h"
+#include "Crypto/cryptomanager_p.h"
+#include "Crypto/serialization_p.h"
+
+#include <QtDBus/QDBusArgument>
+#include <QtDBus/QDBusPendingReply>
+#include <QtDBus/QDBusPendingCallWatcher>
+
+using namespace Sailfish::Crypto;
+
+namespace {
+
+    // Maps nested within the reply are received as QDBusArguments.
+    QVariantMap demarshallStatistics(const QVariantMap &statistics)
+    {
+        QVariantMap demarshalled;
+        for (QVariantMap::const_iterator it = statistics.constBegin(); it != statistics.constEnd(); ++it) {
+            if (it.value().userType() == qMetaTypeId<QDBusArgument>()) {
+                demarshalled.insert(it.key(), demarshallStatistics(
+                        qdbus_cast<QVariantMap>(it.value().value<QDBusArgument>())));
+            } else {
+                demarshalled.insert(it.key(), it.value());
+            }
+        }
+        return demarshalled;
+    }
+
+}
+
+StatisticsRequestPrivate::StatisticsRequestPrivate()
+    : m_timeout(0)
+    , m_status(Request::Inactive)
+{
+}
+
+/*!
+ * \class StatisticsRequest
+ * \brief Allows a client request the request latency statistics of the secrets daemon's crypto API.
+ *
+ * The statistics are intended for diagnosing the performance of the
+ * secrets daemon and its plugins, and are collected from the time
+ * at which the daemon was started.
+ *
+ * \code
+ * Sailfish::Crypto::CryptoManager man;
+ * Sailfish::Crypto::StatisticsRequest req;
+ * req.setManager(&man);
+ * req.startRequest(); // status() will change to Finished when complete
+ *
+ * // real clients should not use waitForFinished() because it blocks
+ * req.waitForFinished();
+ * qDebug() << "statistics:" << req.statistics();
+ * \endcode
+ */
+
+/*!
+ * \brief Constructs a new StatisticsRequest object with the given \a parent.
+ */
+StatisticsRequest::StatisticsRequest(QObject *parent)
+    : Request(parent)
+    , d_ptr(new StatisticsRequestPrivate)
+{
+}
+
+/*!
+ * \brief Destroys the StatisticsRequest
+ */
+StatisticsRequest::~StatisticsRequest()
+{
+}
+
+/*!
+ * \brief Returns the request latency statistics of the secrets daemon's crypto API
+ *
+ * The "requests" entry maps the name of each type of request which has
+ * been performed to the latencies of its "queued", "processing",
+ * "executing" and "total" stages, and the "plugins" entry maps the name
+ * of each plugin to the latencies of the requests which it performed.
+ * Each latency distribution is described by its "count", "min", "max",
+ * "mean", "p50", "p90", "p99" and "p999" values, in microseconds.
+ * The "queues" entry maps each request priority class ("interactive",
+ * "normal" and "bulk") to the number of requests currently waiting
+ * in it to be started.
+ *
+ * Note: this value is only valid if the status of the request is Request::Finished.
+ */
+QVariantMap StatisticsRequest::statistics() const
+{
+    Q_D(const StatisticsRequest);
+    return d->m_statistics;
+}
+
+Request::Status StatisticsRequest::status() const
+{
+    Q_D(const StatisticsRequest);
+    return d->m_status;
+}
+
+Result StatisticsRequest::result() const
+{
+    Q_D(const StatisticsRequest);
+    return d->m_result;
+}
+
+int StatisticsRequest::timeout() const
+{
+    Q_D(const StatisticsRequest);
+    return d->m_timeout;
+}
+
+void StatisticsRequest::setTimeout(int timeout)
+{
+    Q_D(StatisticsRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
+QVariantMap StatisticsRequest::customParameters() const
+{
+    Q_D(const StatisticsRequest);
+    return d->m_customParameters;
+}
+
+void StatisticsRequest::setCustomParameters(const QVariantMap &params)
+{
+    Q_D(StatisticsRequest);
+    if (d->m_customParameters != params) {
+        d->m_customParameters = params;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit customParametersChanged();
+    }
+}
+
+CryptoManager *StatisticsRequest::manager() const
+{
+    Q_D(const StatisticsRequest);
+    return d->m_manager.data();
+}
+
+void StatisticsRequest::setManager(CryptoManager *manager)
+{
+    Q_D(StatisticsRequest);
+    if (d->m_manager.data() != manager) {
+        d->m_manager = manager;
+        emit managerChanged();
+    }
+}
+
+void StatisticsRequest::startRequest()
+{
+    Q_D(StatisticsRequest);
+    if (d->m_status != Request::Active && !d->m_manager.isNull()) {
+        d->m_status = Request::Active;
+        emit statusChanged();
+        if (d->m_result.code() != Result::Pending) {
+            d->m_result = Result(Result::Pending);
+            emit resultChanged();
+        }
+
+        // the statistics are not specific to any plugin, so the
+        // custom parameters are not passed to the daemon.
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
+        QDBusPendingReply<Result, QVariantMap> reply = d->m_manager->d_ptr->getStatistics();
+        if (!reply.isValid() && !reply.error().message().isEmpty()) {
+            d->m_status = Request::Finished;
+            d->m_result = Result(Result::CryptoManagerNotInitializedError,
+                                 reply.error().message());
+            d->m_statistics.clear();
+            emit statisticsChanged();
+            emit statusChanged();
+            emit resultChanged();
+        } else if (reply.isFinished()
+                // work around a bug in QDBusAbstractInterface / QDBusConnection...
+                && reply.argumentAt<0>().code() != Sailfish::Crypto::Result::Succeeded) {
+            d->m_status = Request::Finished;
+            d->m_result = reply.argumentAt<0>();
+            d->m_statistics = demarshallStatistics(reply.argumentAt<1>());
+            emit statisticsChanged();
+            emit statusChanged();
+            emit resultChanged();
+        } else {
+            d->m_watcher.reset(new QDBusPendingCallWatcher(reply));
+            connect(d->m_watcher.data(), &QDBusPendingCallWatcher::finished, [this] {
+                QDBusPendingCallWatcher *watcher = this->d_ptr->m_watcher.take();
+                QDBusPendingReply<Result, QVariantMap> reply = *watcher;
+                this->d_ptr->m_status = Request::Finished;
+                this->d_ptr->m_result = reply.argumentAt<0>();
+                this->d_ptr->m_statistics = demarshallStatistics(reply.argumentAt<1>());
+                watcher->deleteLater();
+                emit this->statisticsChanged();
+                emit this->statusChanged();
+                emit this->resultChanged();
+            });
+        }
+    }
+}
+
+void StatisticsRequest::waitForFinished()
+{
+    Q_D(StatisticsRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        d->m_watcher->waitForFinished();
+    }
+}
+
+void StatisticsRequest::cancel()
+{
+    Q_D(StatisticsRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHCRYPTO_STATISTICSREQUEST_H
+#define LIBSAILFISHCRYPTO_STATISTICSREQUEST_H
+
+#include "Crypto/cryptoglobal.h"
+#include "Crypto/request.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QVariantMap>
+
+namespace Sailfish {
+
+namespace Crypto {
+
+class CryptoManager;
+
+class StatisticsRequestPrivate;
+class SAILFISH_CRYPTO_API StatisticsRequest : public Sailfish::Crypto::Request
+{
+    Q_OBJECT
+    Q_PROPERTY(QVariantMap statistics READ statistics NOTIFY statisticsChanged)
+
+public:
+    StatisticsRequest(QObject *parent = Q_NULLPTR);
+    ~StatisticsRequest();
+
+    QVariantMap statistics() const;
+
+    Sailfish::Crypto::Request::Status status() const Q_DECL_OVERRIDE;
+    Sailfish::Crypto::Result result() const Q_DECL_OVERRIDE;
+
+    int timeout() const Q_DECL_OVERRIDE;
+    void setTimeout(int timeout) Q_DECL_OVERRIDE;
+
+    QVariantMap customParameters() const Q_DECL_OVERRIDE;
+    void setCustomParameters(const QVariantMap &params) Q_DECL_OVERRIDE;
+
+    Sailfish::Crypto::CryptoManager *manager() const Q_DECL_OVERRIDE;
+    void setManager(Sailfish::Crypto::CryptoManager *manager) Q_DECL_OVERRIDE;
+
+    void startRequest() Q_DECL_OVERRIDE;
+    void waitForFinished() Q_DECL_OVERRIDE;
+    void cancel() Q_DECL_OVERRIDE;
+
+Q_SIGNALS:
+    void statisticsChanged();
+
+private:
+    QScopedPointer<StatisticsRequestPrivate> const d_ptr;
+    Q_DECLARE_PRIVATE(StatisticsRequest)
+};
+
+} // namespace Crypto
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHCRYPTO_STATISTICSREQUEST_H
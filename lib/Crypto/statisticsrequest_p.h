@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHCRYPTO_STATISTICSREQUEST_P_H
+#define LIBSAILFISHCRYPTO_STATISTICSREQUEST_P_H
+
+#include "Crypto/cryptoglobal.h"
+#include "Crypto/cryptomanager.h"
+#include "Crypto/statisticsrequest.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QVariantMap>
+
+#include <QtDBus/QDBusPendingCallWatcher>
+
+namespace Sailfish {
+
+namespace Crypto {
+
+class StatisticsRequestPrivate
+{
+    Q_DISABLE_COPY(StatisticsRequestPrivate)
+
+public:
+    explicit StatisticsRequestPrivate();
+
+    QPointer<Sailfish::Crypto::CryptoManager> m_manager;
+    QVariantMap m_customParameters;
+    QVariantMap m_statistics;
+
+    int m_timeout;
+    QScopedPointer<QDBusPendingCallWatcher> m_watcher;
+    Sailfish::Crypto::Request::Status m_status;
+    Sailfish::Crypto::Result m_result;
+};
+
+} // namespace Crypto
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHCRYPTO_STATISTICSREQUEST_P_H
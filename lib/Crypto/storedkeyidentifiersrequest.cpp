@@ -18,7 +18,8 @@
 using namespace Sailfish::Crypto;
 
 StoredKeyIdentifiersRequestPrivate::StoredKeyIdentifiersRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -128,6 +129,25 @@ Result StoredKeyIdentifiersRequest::result() const
     return d->m_result;
 }
 
+int StoredKeyIdentifiersRequest::timeout() const
+{
+    Q_D(const StoredKeyIdentifiersRequest);
+    return d->m_timeout;
+}
+
+void StoredKeyIdentifiersRequest::setTimeout(int timeout)
+{
+    Q_D(StoredKeyIdentifiersRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap StoredKeyIdentifiersRequest::customParameters() const
 {
     Q_D(const StoredKeyIdentifiersRequest);
@@ -173,6 +193,7 @@ void StoredKeyIdentifiersRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QVector<Key::Identifier> > reply =
                 d->m_manager->d_ptr->storedKeyIdentifiers(d->m_storagePluginName,
                                                           d->m_collectionName,
@@ -217,3 +238,20 @@ void StoredKeyIdentifiersRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void StoredKeyIdentifiersRequest::cancel()
+{
+    Q_D(StoredKeyIdentifiersRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
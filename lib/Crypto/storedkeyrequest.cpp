@@ -19,6 +19,7 @@ using namespace Sailfish::Crypto;
 
 StoredKeyRequestPrivate::StoredKeyRequestPrivate()
     : m_keyComponents(Key::MetaData | Key::PublicKeyData)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -133,6 +134,25 @@ Result StoredKeyRequest::result() const
     return d->m_result;
 }
 
+int StoredKeyRequest::timeout() const
+{
+    Q_D(const StoredKeyRequest);
+    return d->m_timeout;
+}
+
+void StoredKeyRequest::setTimeout(int timeout)
+{
+    Q_D(StoredKeyRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap StoredKeyRequest::customParameters() const
 {
     Q_D(const StoredKeyRequest);
@@ -178,6 +198,7 @@ void StoredKeyRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, Key> reply =
                 d->m_manager->d_ptr->storedKey(d->m_identifier,
                                                d->m_keyComponents,
@@ -222,3 +243,20 @@ void StoredKeyRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void StoredKeyRequest::cancel()
+{
+    Q_D(StoredKeyRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -35,6 +35,7 @@ public:
     Key::Components m_keyComponents;
     Sailfish::Crypto::Key m_storedKey;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
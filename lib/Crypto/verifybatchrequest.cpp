@@ -0,0 +1,375 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "Crypto/verifybatchrequest.h"
+#include "Crypto/verifybatchrequest_p.h"
+
+#include "Crypto/cryptomanager.h"
+#include "Crypto/cryptomanager_p.h"
+#include "Crypto/serialization_p.h"
+
+#include <QtDBus/QDBusPendingReply>
+#include <QtDBus/QDBusPendingCallWatcher>
+
+using namespace Sailfish::Crypto;
+
+VerifyBatchRequestPrivate::VerifyBatchRequestPrivate()
+    : m_padding(CryptoManager::SignaturePaddingUnknown)
+    , m_digestFunction(CryptoManager::DigestUnknown)
+    , m_timeout(0)
+    , m_status(Request::Inactive)
+{
+}
+
+/*!
+ * \class VerifyBatchRequest
+ * \brief Allows a client request the system crypto service to verify that many items of data were signed with specific keys
+ *
+ * This class allows clients to verify a batch of signatures in a single
+ * request.  The data() and keys() are given in the same order as the
+ * signatures(): each signature is verified against the item of data and
+ * the key at the same position.  If a single key is given, it is used to
+ * verify every signature.
+ *
+ * Unlike performing a \l VerifyRequest for each signature, each distinct
+ * key is resolved only once for the whole batch: if a key is a reference
+ * to a stored key, its public key is read from storage once, and is then
+ * used for every signature which refers to it.  The signatures are then
+ * verified by the crypto plugin, which may verify them in parallel.
+ *
+ * The batch is verified all together or not at all: if any signature cannot
+ * be verified (for example, because its key could not be read), the request
+ * fails and no verificationStatuses() are reported.  Otherwise, the
+ * verificationStatuses() report whether each signature matched its data,
+ * and should be checked by the client.
+ */
+
+/*!
+ * \brief Constructs a new VerifyBatchRequest object with the given \a parent
+ */
+VerifyBatchRequest::VerifyBatchRequest(QObject *parent)
+    : Request(parent)
+    , d_ptr(new VerifyBatchRequestPrivate)
+{
+}
+
+/*!
+ * \brief Destroys the VerifyBatchRequest
+ */
+VerifyBatchRequest::~VerifyBatchRequest()
+{
+}
+
+/*!
+ * \brief Returns the signatures which the client wishes the system service to verify
+ */
+QVector<QByteArray> VerifyBatchRequest::signatures() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_signatures;
+}
+
+/*!
+ * \brief Sets the signatures which the client wishes the system service to verify to \a signatures
+ */
+void VerifyBatchRequest::setSignatures(const QVector<QByteArray> &signatures)
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status != Request::Active && d->m_signatures != signatures) {
+        d->m_signatures = signatures;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit signaturesChanged();
+    }
+}
+
+/*!
+ * \brief Returns the items of data which were signed by the remote parties
+ */
+QVector<QByteArray> VerifyBatchRequest::data() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_data;
+}
+
+/*!
+ * \brief Sets the items of data which were signed by the remote parties to \a data
+ *
+ * The data must contain one item for each of the signatures(), in the same order.
+ */
+void VerifyBatchRequest::setData(const QVector<QByteArray> &data)
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status != Request::Active && d->m_data != data) {
+        d->m_data = data;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit dataChanged();
+    }
+}
+
+/*!
+ * \brief Returns the keys which the client wishes the system service to use to verify the data
+ */
+QVector<Key> VerifyBatchRequest::keys() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_keys;
+}
+
+/*!
+ * \brief Sets the keys which the client wishes the system service to use to verify the data to \a keys
+ *
+ * The keys must either contain a single key, which is used to verify every
+ * signature, or one key for each of the signatures(), in the same order.
+ * Each key may be a reference to a stored key.
+ */
+void VerifyBatchRequest::setKeys(const QVector<Key> &keys)
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status != Request::Active && d->m_keys != keys) {
+        d->m_keys = keys;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit keysChanged();
+    }
+}
+
+/*!
+ * \brief Returns the signature padding mode which was used when signing the data
+ */
+Sailfish::Crypto::CryptoManager::SignaturePadding VerifyBatchRequest::padding() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_padding;
+}
+
+/*!
+ * \brief Sets the signature padding mode which was used when signing the data to \a padding
+ */
+void VerifyBatchRequest::setPadding(Sailfish::Crypto::CryptoManager::SignaturePadding padding)
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status != Request::Active && d->m_padding != padding) {
+        d->m_padding = padding;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit paddingChanged();
+    }
+}
+
+/*!
+ * \brief Returns the digest which was used to generate the signatures
+ */
+Sailfish::Crypto::CryptoManager::DigestFunction VerifyBatchRequest::digestFunction() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_digestFunction;
+}
+
+/*!
+ * \brief Sets the digest which was used to generate the signatures to \a digestFn
+ */
+void VerifyBatchRequest::setDigestFunction(Sailfish::Crypto::CryptoManager::DigestFunction digestFn)
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status != Request::Active && d->m_digestFunction != digestFn) {
+        d->m_digestFunction = digestFn;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit digestFunctionChanged();
+    }
+}
+
+/*!
+ * \brief Returns the name of the crypto plugin which the client wishes to perform the verification operation
+ */
+QString VerifyBatchRequest::cryptoPluginName() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_cryptoPluginName;
+}
+
+/*!
+ * \brief Sets the name of the crypto plugin which the client wishes to perform the verification operation to \a pluginName
+ */
+void VerifyBatchRequest::setCryptoPluginName(const QString &pluginName)
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status != Request::Active && d->m_cryptoPluginName != pluginName) {
+        d->m_cryptoPluginName = pluginName;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit cryptoPluginNameChanged();
+    }
+}
+
+/*!
+ * \brief Returns the verification status of each of the signatures(), in the same order
+ *
+ * Note: this value is only valid if the status of the request is Request::Finished.
+ */
+QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> VerifyBatchRequest::verificationStatuses() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_verificationStatuses;
+}
+
+Request::Status VerifyBatchRequest::status() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_status;
+}
+
+Result VerifyBatchRequest::result() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_result;
+}
+
+int VerifyBatchRequest::timeout() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_timeout;
+}
+
+void VerifyBatchRequest::setTimeout(int timeout)
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
+QVariantMap VerifyBatchRequest::customParameters() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_customParameters;
+}
+
+void VerifyBatchRequest::setCustomParameters(const QVariantMap &params)
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_customParameters != params) {
+        d->m_customParameters = params;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit customParametersChanged();
+    }
+}
+
+CryptoManager *VerifyBatchRequest::manager() const
+{
+    Q_D(const VerifyBatchRequest);
+    return d->m_manager.data();
+}
+
+void VerifyBatchRequest::setManager(CryptoManager *manager)
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_manager.data() != manager) {
+        d->m_manager = manager;
+        emit managerChanged();
+    }
+}
+
+void VerifyBatchRequest::startRequest()
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status != Request::Active && !d->m_manager.isNull()) {
+        d->m_status = Request::Active;
+        emit statusChanged();
+        if (d->m_result.code() != Result::Pending) {
+            d->m_result = Result(Result::Pending);
+            emit resultChanged();
+        }
+
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
+        QDBusPendingReply<Result, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> > reply =
+                d->m_manager->d_ptr->verifyBatch(d->m_signatures,
+                                                 d->m_data,
+                                                 d->m_keys,
+                                                 d->m_padding,
+                                                 d->m_digestFunction,
+                                                 d->m_customParameters,
+                                                 d->m_cryptoPluginName);
+        if (!reply.isValid() && !reply.error().message().isEmpty()) {
+            d->m_status = Request::Finished;
+            d->m_result = Result(Result::CryptoManagerNotInitializedError,
+                                 reply.error().message());
+            emit statusChanged();
+            emit resultChanged();
+        } else if (reply.isFinished()
+                // work around a bug in QDBusAbstractInterface / QDBusConnection...
+                && reply.argumentAt<0>().code() != Sailfish::Crypto::Result::Succeeded) {
+            d->m_status = Request::Finished;
+            d->m_result = reply.argumentAt<0>();
+            d->m_verificationStatuses = reply.argumentAt<1>();
+            emit statusChanged();
+            emit resultChanged();
+            emit verificationStatusesChanged();
+        } else {
+            d->m_watcher.reset(new QDBusPendingCallWatcher(reply));
+            connect(d->m_watcher.data(), &QDBusPendingCallWatcher::finished,
+                    [this] {
+                QDBusPendingCallWatcher *watcher = this->d_ptr->m_watcher.take();
+                QDBusPendingReply<Result, QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> > reply = *watcher;
+                this->d_ptr->m_status = Request::Finished;
+                this->d_ptr->m_result = reply.argumentAt<0>();
+                this->d_ptr->m_verificationStatuses = reply.argumentAt<1>();
+                watcher->deleteLater();
+                emit this->statusChanged();
+                emit this->resultChanged();
+                emit this->verificationStatusesChanged();
+            });
+        }
+    }
+}
+
+void VerifyBatchRequest::waitForFinished()
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        d->m_watcher->waitForFinished();
+    }
+}
+
+void VerifyBatchRequest::cancel()
+{
+    Q_D(VerifyBatchRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHCRYPTO_VERIFYBATCHREQUEST_H
+#define LIBSAILFISHCRYPTO_VERIFYBATCHREQUEST_H
+
+#include "Crypto/cryptoglobal.h"
+#include "Crypto/request.h"
+#include "Crypto/key.h"
+#include "Crypto/cryptomanager.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+
+namespace Sailfish {
+
+namespace Crypto {
+
+class VerifyBatchRequestPrivate;
+class SAILFISH_CRYPTO_API VerifyBatchRequest : public Sailfish::Crypto::Request
+{
+    Q_OBJECT
+    Q_PROPERTY(QVector<QByteArray> signatures READ signatures WRITE setSignatures NOTIFY signaturesChanged)
+    Q_PROPERTY(QVector<QByteArray> data READ data WRITE setData NOTIFY dataChanged)
+    Q_PROPERTY(QVector<Sailfish::Crypto::Key> keys READ keys WRITE setKeys NOTIFY keysChanged)
+    Q_PROPERTY(Sailfish::Crypto::CryptoManager::SignaturePadding padding READ padding WRITE setPadding NOTIFY paddingChanged)
+    Q_PROPERTY(Sailfish::Crypto::CryptoManager::DigestFunction digestFunction READ digestFunction WRITE setDigestFunction NOTIFY digestFunctionChanged)
+    Q_PROPERTY(QString cryptoPluginName READ cryptoPluginName WRITE setCryptoPluginName NOTIFY cryptoPluginNameChanged)
+    Q_PROPERTY(QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> verificationStatuses READ verificationStatuses NOTIFY verificationStatusesChanged)
+
+public:
+    VerifyBatchRequest(QObject *parent = Q_NULLPTR);
+    ~VerifyBatchRequest();
+
+    QVector<QByteArray> signatures() const;
+    void setSignatures(const QVector<QByteArray> &signatures);
+
+    QVector<QByteArray> data() const;
+    void setData(const QVector<QByteArray> &data);
+
+    QVector<Sailfish::Crypto::Key> keys() const;
+    void setKeys(const QVector<Sailfish::Crypto::Key> &keys);
+
+    Sailfish::Crypto::CryptoManager::SignaturePadding padding() const;
+    void setPadding(Sailfish::Crypto::CryptoManager::SignaturePadding padding);
+
+    Sailfish::Crypto::CryptoManager::DigestFunction digestFunction() const;
+    void setDigestFunction(Sailfish::Crypto::CryptoManager::DigestFunction digest);
+
+    QString cryptoPluginName() const;
+    void setCryptoPluginName(const QString &pluginName);
+
+    QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> verificationStatuses() const;
+
+    Sailfish::Crypto::Request::Status status() const Q_DECL_OVERRIDE;
+    Sailfish::Crypto::Result result() const Q_DECL_OVERRIDE;
+
+    int timeout() const Q_DECL_OVERRIDE;
+    void setTimeout(int timeout) Q_DECL_OVERRIDE;
+
+    QVariantMap customParameters() const Q_DECL_OVERRIDE;
+    void setCustomParameters(const QVariantMap &params) Q_DECL_OVERRIDE;
+
+    Sailfish::Crypto::CryptoManager *manager() const Q_DECL_OVERRIDE;
+    void setManager(Sailfish::Crypto::CryptoManager *manager) Q_DECL_OVERRIDE;
+
+    void startRequest() Q_DECL_OVERRIDE;
+    void waitForFinished() Q_DECL_OVERRIDE;
+    void cancel() Q_DECL_OVERRIDE;
+
+Q_SIGNALS:
+    void signaturesChanged();
+    void dataChanged();
+    void keysChanged();
+    void paddingChanged();
+    void digestFunctionChanged();
+    void cryptoPluginNameChanged();
+    void verificationStatusesChanged();
+
+private:
+    QScopedPointer<VerifyBatchRequestPrivate> const d_ptr;
+    Q_DECLARE_PRIVATE(VerifyBatchRequest)
+};
+
+} // namespace Crypto
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHCRYPTO_VERIFYBATCHREQUEST_H
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHCRYPTO_VERIFYBATCHREQUEST_P_H
+#define LIBSAILFISHCRYPTO_VERIFYBATCHREQUEST_P_H
+
+#include "Crypto/cryptoglobal.h"
+#include "Crypto/verifybatchrequest.h"
+#include "Crypto/cryptomanager.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <QtDBus/QDBusPendingCallWatcher>
+
+namespace Sailfish {
+
+namespace Crypto {
+
+class VerifyBatchRequestPrivate
+{
+    Q_DISABLE_COPY(VerifyBatchRequestPrivate)
+
+public:
+    explicit VerifyBatchRequestPrivate();
+
+    QPointer<Sailfish::Crypto::CryptoManager> m_manager;
+    QVariantMap m_customParameters;
+    QVector<QByteArray> m_signatures;
+    QVector<QByteArray> m_data;
+    QVector<Sailfish::Crypto::Key> m_keys;
+    Sailfish::Crypto::CryptoManager::SignaturePadding m_padding;
+    Sailfish::Crypto::CryptoManager::DigestFunction m_digestFunction;
+    QString m_cryptoPluginName;
+    QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> m_verificationStatuses;
+
+    int m_timeout;
+    QScopedPointer<QDBusPendingCallWatcher> m_watcher;
+    Sailfish::Crypto::Request::Status m_status;
+    Sailfish::Crypto::Result m_result;
+};
+
+} // namespace Crypto
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHCRYPTO_VERIFYBATCHREQUEST_P_H
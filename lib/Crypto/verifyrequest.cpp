@@ -21,6 +21,7 @@ VerifyRequestPrivate::VerifyRequestPrivate()
     : m_padding(CryptoManager::SignaturePaddingUnknown)
     , m_digestFunction(CryptoManager::DigestUnknown)
     , m_verificationStatus(Sailfish::Crypto::CryptoManager::VerificationStatusUnknown)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -243,6 +244,25 @@ Result VerifyRequest::result() const
     return d->m_result;
 }
 
+int VerifyRequest::timeout() const
+{
+    Q_D(const VerifyRequest);
+    return d->m_timeout;
+}
+
+void VerifyRequest::setTimeout(int timeout)
+{
+    Q_D(VerifyRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 QVariantMap VerifyRequest::customParameters() const
 {
     Q_D(const VerifyRequest);
@@ -288,6 +308,7 @@ void VerifyRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, Sailfish::Crypto::CryptoManager::VerificationStatus> reply =
                 d->m_manager->d_ptr->verify(d->m_signature,
                                             d->m_data,
@@ -336,3 +357,20 @@ void VerifyRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void VerifyRequest::cancel()
+{
+    Q_D(VerifyRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -39,6 +39,7 @@ public:
     QString m_cryptoPluginName;
     Sailfish::Crypto::CryptoManager::VerificationStatus m_verificationStatus;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Crypto::Request::Status m_status;
     Sailfish::Crypto::Result m_result;
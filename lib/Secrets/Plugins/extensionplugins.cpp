@@ -156,6 +156,32 @@ bool PluginBase::supportsSetLockCode() const
     return supportsLocking();
 }
 
+/*!
+ * \brief Returns the number of operations which may be performed by the plugin concurrently.
+ *
+ * The default implementation returns 1, in which case every operation
+ * is performed by a single thread, in the order in which the operations
+ * were requested.  This method should be overridden by a specific plugin
+ * implementation if it is thread-safe, in order to allow operations
+ * which do not depend on state held by the plugin between calls (for
+ * example, generating random data, or encrypting data with a key which
+ * is provided in full) to be performed by up to the returned number of
+ * threads concurrently.  Operations which do depend on such state (for
+ * example, locking, key storage and cipher sessions) are still performed
+ * by a single thread, in order.
+ *
+ * Note that the two kinds of operation are not performed exclusively of
+ * each other: a stateless operation may be performed while a stateful
+ * operation such as lock(), unlock() or a step of a cipher session is being
+ * performed by another thread.  A plugin which returns a value greater than
+ * 1 must therefore guard any state which is read by its stateless operations
+ * (for example, whether it is locked) against concurrent modification.
+ */
+int PluginBase::maxConcurrency() const
+{
+    return 1;
+}
+
 /*!
  * \brief Returns true if the plugin is available for use.
  *
@@ -521,6 +547,37 @@ StoragePlugin::~StoragePlugin()
  * Sailfish::Secrets::Result::DatabaseError.
  */
 
+/*!
+ * \brief Store the given \a secrets data and associated \a filterData into
+ *        the collection identified by the given \a collectionName, as the
+ *        secrets identified by the given \a secretNames respectively.
+ *
+ * The same results should be returned as by setSecret().  The secrets
+ * must be stored all together or not at all: if any of the secrets cannot
+ * be stored, the result for that secret should be returned and none of
+ * the secrets should be stored.
+ *
+ * The default implementation calls setSecret() for each of the secrets,
+ * and attempts to remove the secrets which were already stored if one
+ * of them cannot be stored.
+ * This method should be overridden by a specific plugin implementation
+ * if it is able to store the secrets more efficiently together (for
+ * example, by writing them within a single database transaction).
+ */
+Result StoragePlugin::setSecrets(const QString &collectionName, const QStringList &secretNames, const QVector<QByteArray> &secrets, const QVector<Secret::FilterData> &filterData)
+{
+    for (int i = 0; i < secretNames.size(); ++i) {
+        Result result = setSecret(collectionName, secretNames.at(i), secrets.value(i), filterData.value(i));
+        if (result.code() != Result::Succeeded) {
+            while (--i >= 0) {
+                removeSecret(collectionName, secretNames.at(i));
+            }
+            return result;
+        }
+    }
+    return Result(Result::Succeeded);
+}
+
 /*!
  * \fn StoragePlugin::getSecret(const QString &collectionName, const QString &secretName, QByteArray *secret, Sailfish::Secrets::Secret::FilterData *filterData)
  * \brief Write the secret data and filter data associated with the secret
@@ -553,6 +610,40 @@ StoragePlugin::~StoragePlugin()
  * Sailfish::Secrets::Result::DatabaseError.
  */
 
+/*!
+ * \brief Write the secret data and filter data associated with each of the
+ *        secrets identified by the given \a secretNames in the collection
+ *        identified by the given \a collectionName into the \a secrets and
+ *        \a filterData out-parameters respectively, in the same order.
+ *
+ * The same results should be returned as by getSecret(), and if any of the
+ * secrets cannot be retrieved, the result for that secret should be returned
+ * and the out-parameters need not be set.
+ *
+ * The default implementation calls getSecret() for each of the secrets.
+ * This method should be overridden by a specific plugin implementation
+ * if it is able to retrieve the secrets more efficiently together (for
+ * example, by reading them within a single database transaction).
+ */
+Result StoragePlugin::getSecrets(const QString &collectionName, const QStringList &secretNames, QVector<QByteArray> *secrets, QVector<Secret::FilterData> *filterData)
+{
+    secrets->clear();
+    filterData->clear();
+    secrets->reserve(secretNames.size());
+    filterData->reserve(secretNames.size());
+    for (const QString &secretName : secretNames) {
+        QByteArray secret;
+        Secret::FilterData secretFilterData;
+        Result result = getSecret(collectionName, secretName, &secret, &secretFilterData);
+        if (result.code() != Result::Succeeded) {
+            return result;
+        }
+        secrets->append(secret);
+        filterData->append(secretFilterData);
+    }
+    return Result(Result::Succeeded);
+}
+
 /*!
  * \fn StoragePlugin::secretNames(const QString &collectionName, QStringList *secretNames)
  * \brief Write the names of secrets which are stored by the plugin in the
@@ -659,6 +750,47 @@ StoragePlugin::~StoragePlugin()
  * Sailfish::Secrets::Result::DatabaseError.
  */
 
+/*!
+ * \brief Remove each secret in the collection identified by the given
+ *        \a collectionName which has filter data matching the given
+ *        \a filter according to the specified \a filterOperator, and write
+ *        the names of the removed secrets into the \a secretNames
+ *        out-parameter.
+ *
+ * The secrets are matched as described for findSecrets(), and the same
+ * results should be returned as by findSecrets() and removeSecret().
+ * The secrets should be removed all together or not at all: if any of
+ * the matching secrets cannot be removed, the plugin should return the
+ * result for that secret and set the \a secretNames out-parameter to the
+ * names of any secrets which were nonetheless removed (that is, an empty
+ * list, if the removal was rolled back).
+ *
+ * The default implementation calls findSecrets() and then removeSecret()
+ * for each of the matching secrets, and stops at the first secret which
+ * cannot be removed.
+ * This method should be overridden by a specific plugin implementation
+ * if it is able to remove the secrets more efficiently together (for
+ * example, by filtering and removing them within a single database
+ * transaction).
+ */
+Result StoragePlugin::removeSecrets(const QString &collectionName, const Secret::FilterData &filter, StoragePlugin::FilterOperator filterOperator, QStringList *secretNames)
+{
+    secretNames->clear();
+    QStringList matchingNames;
+    Result result = findSecrets(collectionName, filter, filterOperator, &matchingNames);
+    if (result.code() != Result::Succeeded) {
+        return result;
+    }
+    for (const QString &secretName : matchingNames) {
+        result = removeSecret(collectionName, secretName);
+        if (result.code() != Result::Succeeded) {
+            return result;
+        }
+        secretNames->append(secretName);
+    }
+    return Result(Result::Succeeded);
+}
+
 /*!
  * \fn StoragePlugin::reencrypt(const QString &collectionName, const QString &secretName, const QByteArray &oldkey, const QByteArray &newkey, Sailfish::Secrets::EncryptionPlugin *plugin)
  * \brief Transactionally re-encrypt secret data stored by the storage plugin
@@ -992,6 +1124,38 @@ EncryptedStoragePlugin::~EncryptedStoragePlugin()
  * Sailfish::Secrets::Result::DatabaseError.
  */
 
+/*!
+ * \brief Store the given \a secrets data and associated \a filterData into
+ *        the collection identified by the given \a collectionName, as the
+ *        secrets identified by the given \a secretNames respectively.
+ *
+ * The collection must be unlocked.
+ * The same results should be returned as by setSecret().  The secrets
+ * must be stored all together or not at all: if any of the secrets cannot
+ * be stored, the result for that secret should be returned and none of
+ * the secrets should be stored.
+ *
+ * The default implementation calls setSecret() for each of the secrets,
+ * and attempts to remove the secrets which were already stored if one
+ * of them cannot be stored.
+ * This method should be overridden by a specific plugin implementation
+ * if it is able to store the secrets more efficiently together (for
+ * example, by writing them within a single database transaction).
+ */
+Result EncryptedStoragePlugin::setSecrets(const QString &collectionName, const QStringList &secretNames, const QVector<QByteArray> &secrets, const QVector<Secret::FilterData> &filterData)
+{
+    for (int i = 0; i < secretNames.size(); ++i) {
+        Result result = setSecret(collectionName, secretNames.at(i), secrets.value(i), filterData.value(i));
+        if (result.code() != Result::Succeeded) {
+            while (--i >= 0) {
+                removeSecret(collectionName, secretNames.at(i));
+            }
+            return result;
+        }
+    }
+    return Result(Result::Succeeded);
+}
+
 /*!
  * \fn EncryptedStoragePlugin::getSecret(const QString &collectionName, const QString &secretName, QByteArray *secret, Sailfish::Secrets::Secret::FilterData *filterData)
  * \brief Retrieve the secret data and filter data for the secret identified
@@ -1031,6 +1195,41 @@ EncryptedStoragePlugin::~EncryptedStoragePlugin()
  * Sailfish::Secrets::Result::DatabaseError.
  */
 
+/*!
+ * \brief Write the secret data and filter data associated with each of the
+ *        secrets identified by the given \a secretNames in the collection
+ *        identified by the given \a collectionName into the \a secrets and
+ *        \a filterData out-parameters respectively, in the same order.
+ *
+ * The collection must be unlocked.  The same results should be returned
+ * as by getSecret(), and if any of the
+ * secrets cannot be retrieved, the result for that secret should be returned
+ * and the out-parameters need not be set.
+ *
+ * The default implementation calls getSecret() for each of the secrets.
+ * This method should be overridden by a specific plugin implementation
+ * if it is able to retrieve the secrets more efficiently together (for
+ * example, by reading them within a single database transaction).
+ */
+Result EncryptedStoragePlugin::getSecrets(const QString &collectionName, const QStringList &secretNames, QVector<QByteArray> *secrets, QVector<Secret::FilterData> *filterData)
+{
+    secrets->clear();
+    filterData->clear();
+    secrets->reserve(secretNames.size());
+    filterData->reserve(secretNames.size());
+    for (const QString &secretName : secretNames) {
+        QByteArray secret;
+        Secret::FilterData secretFilterData;
+        Result result = getSecret(collectionName, secretName, &secret, &secretFilterData);
+        if (result.code() != Result::Succeeded) {
+            return result;
+        }
+        secrets->append(secret);
+        filterData->append(secretFilterData);
+    }
+    return Result(Result::Succeeded);
+}
+
 /*!
  * \fn EncryptedStoragePlugin::secretNames(const QString &collectionName, QStringList *secretNames)
  * \brief Retrive the names of secrets stored in the collection identified
@@ -1132,6 +1331,47 @@ EncryptedStoragePlugin::~EncryptedStoragePlugin()
  * Sailfish::Secrets::Result::DatabaseError.
  */
 
+/*!
+ * \brief Remove each secret in the collection identified by the given
+ *        \a collectionName which has filter data matching the given
+ *        \a filter according to the specified \a filterOperator, and write
+ *        the names of the removed secrets into the \a secretNames
+ *        out-parameter.
+ *
+ * The secrets are matched as described for findSecrets(), and the same
+ * results should be returned as by findSecrets() and removeSecret().
+ * The secrets should be removed all together or not at all: if any of
+ * the matching secrets cannot be removed, the plugin should return the
+ * result for that secret and set the \a secretNames out-parameter to the
+ * names of any secrets which were nonetheless removed (that is, an empty
+ * list, if the removal was rolled back).
+ *
+ * The default implementation calls findSecrets() and then removeSecret()
+ * for each of the matching secrets, and stops at the first secret which
+ * cannot be removed.
+ * This method should be overridden by a specific plugin implementation
+ * if it is able to remove the secrets more efficiently together (for
+ * example, by filtering and removing them within a single database
+ * transaction).
+ */
+Result EncryptedStoragePlugin::removeSecrets(const QString &collectionName, const Secret::FilterData &filter, StoragePlugin::FilterOperator filterOperator, QStringList *secretNames)
+{
+    secretNames->clear();
+    QVector<Secret::Identifier> identifiers;
+    Result result = findSecrets(collectionName, filter, filterOperator, &identifiers);
+    if (result.code() != Result::Succeeded) {
+        return result;
+    }
+    for (const Secret::Identifier &identifier : identifiers) {
+        result = removeSecret(collectionName, identifier.name());
+        if (result.code() != Result::Succeeded) {
+            return result;
+        }
+        secretNames->append(identifier.name());
+    }
+    return Result(Result::Succeeded);
+}
+
 /*!
  * \fn EncryptedStoragePlugin::setSecret(const QString &secretName, const QByteArray &secret, const Sailfish::Secrets::Secret::FilterData &filterData, const QByteArray &key)
  * \brief Store a standalone secret identified by the given \a secretName
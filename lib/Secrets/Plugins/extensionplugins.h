@@ -21,10 +21,10 @@
 #include <QtCore/QVector>
 #include <QtCore/QLoggingCategory>
 
-#define Sailfish_Secrets_StoragePlugin_IID "org.sailfishos.secrets.StoragePlugin/1.0"
-#define Sailfish_Secrets_EncryptionPlugin_IID "org.sailfishos.secrets.EncryptionPlugin/1.0"
-#define Sailfish_Secrets_EncryptedStoragePlugin_IID "org.sailfishos.secrets.EncryptedStoragePlugin/1.0"
-#define Sailfish_Secrets_AuthenticationPlugin_IID "org.sailfishos.secrets.AuthenticationPlugin/1.0"
+#define Sailfish_Secrets_StoragePlugin_IID "org.sailfishos.secrets.StoragePlugin/1.1"
+#define Sailfish_Secrets_EncryptionPlugin_IID "org.sailfishos.secrets.EncryptionPlugin/1.1"
+#define Sailfish_Secrets_EncryptedStoragePlugin_IID "org.sailfishos.secrets.EncryptedStoragePlugin/1.1"
+#define Sailfish_Secrets_AuthenticationPlugin_IID "org.sailfishos.secrets.AuthenticationPlugin/1.1"
 
 SAILFISH_SECRETS_API Q_DECLARE_LOGGING_CATEGORY(lcSailfishSecretsPlugin)
 
@@ -51,6 +51,8 @@ public:
     virtual bool lock();
     virtual bool unlock(const QByteArray &lockCode);
     virtual bool setLockCode(const QByteArray &oldLockCode, const QByteArray &newLockCode);
+
+    virtual int maxConcurrency() const;
 };
 
 class SAILFISH_SECRETS_API EncryptionPlugin : public virtual Sailfish::Secrets::PluginBase
@@ -116,6 +118,11 @@ public:
             const QByteArray &oldkey,
             const QByteArray &newkey,
             Sailfish::Secrets::EncryptionPlugin *plugin) = 0;
+
+    // batch secret operations.
+    virtual Sailfish::Secrets::Result getSecrets(const QString &collectionName, const QStringList &secretNames, QVector<QByteArray> *secrets, QVector<Sailfish::Secrets::Secret::FilterData> *filterData);
+    virtual Sailfish::Secrets::Result setSecrets(const QString &collectionName, const QStringList &secretNames, const QVector<QByteArray> &secrets, const QVector<Sailfish::Secrets::Secret::FilterData> &filterData);
+    virtual Sailfish::Secrets::Result removeSecrets(const QString &collectionName, const Sailfish::Secrets::Secret::FilterData &filter, Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator, QStringList *secretNames);
 };
 
 class SAILFISH_SECRETS_API EncryptedStoragePlugin : public virtual Sailfish::Secrets::PluginBase
@@ -148,6 +155,11 @@ public:
     virtual Sailfish::Secrets::Result accessSecret(const QString &secretName, const QByteArray &key, QByteArray *secret, Sailfish::Secrets::Secret::FilterData *filterData) = 0;
     virtual Sailfish::Secrets::Result removeSecret(const QString &secretName) = 0;
     virtual Sailfish::Secrets::Result reencryptSecret(const QString &secretName, const QByteArray &oldkey, const QByteArray &newkey) = 0;
+
+    // batch secret operations.
+    virtual Sailfish::Secrets::Result getSecrets(const QString &collectionName, const QStringList &secretNames, QVector<QByteArray> *secrets, QVector<Sailfish::Secrets::Secret::FilterData> *filterData);
+    virtual Sailfish::Secrets::Result setSecrets(const QString &collectionName, const QStringList &secretNames, const QVector<QByteArray> &secrets, const QVector<Sailfish::Secrets::Secret::FilterData> &filterData);
+    virtual Sailfish::Secrets::Result removeSecrets(const QString &collectionName, const Sailfish::Secrets::Secret::FilterData &filter, Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator, QStringList *secretNames);
 };
 
 class SAILFISH_SECRETS_API AuthenticationPlugin : public QObject, public virtual PluginBase
@@ -17,6 +17,7 @@ PUBLIC_HEADERS += \
     $$PWD/createcollectionrequest.h \
     $$PWD/deletecollectionrequest.h \
     $$PWD/deletesecretrequest.h \
+    $$PWD/deletesecretsrequest.h \
     $$PWD/findsecretsrequest.h \
     $$PWD/interactionparameters.h \
     $$PWD/interactionrequest.h \
@@ -25,12 +26,16 @@ PUBLIC_HEADERS += \
     $$PWD/plugininforequest.h \
     $$PWD/healthcheckrequest.h \
     $$PWD/request.h \
+    $$PWD/requestpipeline.h \
     $$PWD/result.h \
     $$PWD/secret.h \
     $$PWD/secretmanager.h \
     $$PWD/secretsglobal.h \
+    $$PWD/statisticsrequest.h \
     $$PWD/storedsecretrequest.h \
+    $$PWD/storedsecretsrequest.h \
     $$PWD/storesecretrequest.h \
+    $$PWD/storesecretsrequest.h \
     $$PWD/interactionrequestwatcher.h \
     $$PWD/interactionresponse.h \
     $$PWD/interactionview.h
@@ -44,6 +49,7 @@ PRIVATE_HEADERS += \
     $$PWD/createcollectionrequest_p.h \
     $$PWD/deletecollectionrequest_p.h \
     $$PWD/deletesecretrequest_p.h \
+    $$PWD/deletesecretsrequest_p.h \
     $$PWD/findsecretsrequest_p.h \
     $$PWD/interactionparameters_p.h \
     $$PWD/interactionrequest_p.h \
@@ -51,12 +57,16 @@ PRIVATE_HEADERS += \
     $$PWD/plugininfo_p.h \
     $$PWD/plugininforequest_p.h \
     $$PWD/healthcheckrequest_p.h \
+    $$PWD/requestpipeline_p.h \
     $$PWD/result_p.h \
     $$PWD/secret_p.h \
     $$PWD/secretsdaemonconnection_p_p.h \
     $$PWD/secretmanager_p.h \
+    $$PWD/statisticsrequest_p.h \
     $$PWD/storedsecretrequest_p.h \
+    $$PWD/storedsecretsrequest_p.h \
     $$PWD/storesecretrequest_p.h \
+    $$PWD/storesecretsrequest_p.h \
     $$PWD/interactionresponse_p.h \
     $$PWD/interactionservice_p.h
 
@@ -70,6 +80,7 @@ SOURCES += \
     $$PWD/createcollectionrequest.cpp \
     $$PWD/deletecollectionrequest.cpp \
     $$PWD/deletesecretrequest.cpp \
+    $$PWD/deletesecretsrequest.cpp \
     $$PWD/findsecretsrequest.cpp \
     $$PWD/interactionparameters.cpp \
     $$PWD/interactionrequest.cpp \
@@ -78,13 +89,17 @@ SOURCES += \
     $$PWD/plugininforequest.cpp \
     $$PWD/healthcheckrequest.cpp \
     $$PWD/request.cpp \
+    $$PWD/requestpipeline.cpp \
     $$PWD/result.cpp \
     $$PWD/secret.cpp \
     $$PWD/secretsdaemonconnection.cpp \
     $$PWD/secretmanager.cpp \
     $$PWD/serialization.cpp \
+    $$PWD/statisticsrequest.cpp \
     $$PWD/storedsecretrequest.cpp \
+    $$PWD/storedsecretsrequest.cpp \
     $$PWD/storesecretrequest.cpp \
+    $$PWD/storesecretsrequest.cpp \
     $$PWD/interactionrequestwatcher.cpp \
     $$PWD/interactionresponse.cpp \
     $$PWD/interactionservice.cpp
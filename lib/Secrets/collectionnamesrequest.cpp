@@ -18,7 +18,8 @@
 using namespace Sailfish::Secrets;
 
 CollectionNamesRequestPrivate::CollectionNamesRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -122,6 +123,25 @@ Result CollectionNamesRequest::result() const
     return d->m_result;
 }
 
+int CollectionNamesRequest::timeout() const
+{
+    Q_D(const CollectionNamesRequest);
+    return d->m_timeout;
+}
+
+void CollectionNamesRequest::setTimeout(int timeout)
+{
+    Q_D(CollectionNamesRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *CollectionNamesRequest::manager() const
 {
     Q_D(const CollectionNamesRequest);
@@ -148,6 +168,7 @@ void CollectionNamesRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QVariantMap> reply = d->m_manager->d_ptr->collectionNames(
                     d->m_storagePluginName);
         if (!reply.isValid() && !reply.error().message().isEmpty()) {
@@ -192,3 +213,20 @@ void CollectionNamesRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void CollectionNamesRequest::cancel()
+{
+    Q_D(CollectionNamesRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -32,6 +32,7 @@ public:
     QString m_storagePluginName;
     QMap<QString, bool> m_collectionNames; // name,isLocked
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
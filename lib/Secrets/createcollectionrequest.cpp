@@ -23,6 +23,7 @@ CreateCollectionRequestPrivate::CreateCollectionRequestPrivate()
     , m_customLockUnlockSemantic(SecretManager::CustomLockKeepUnlocked)
     , m_accessControlMode(SecretManager::OwnerOnlyMode)
     , m_userInteractionMode(SecretManager::PreventInteraction)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -337,6 +338,25 @@ Result CreateCollectionRequest::result() const
     return d->m_result;
 }
 
+int CreateCollectionRequest::timeout() const
+{
+    Q_D(const CreateCollectionRequest);
+    return d->m_timeout;
+}
+
+void CreateCollectionRequest::setTimeout(int timeout)
+{
+    Q_D(CreateCollectionRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *CreateCollectionRequest::manager() const
 {
     Q_D(const CreateCollectionRequest);
@@ -363,6 +383,7 @@ void CreateCollectionRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result> reply;
         if (d->m_collectionLockType == CreateCollectionRequest::CustomLock) {
             reply = d->m_manager->d_ptr->createCollection(d->m_collectionName,
@@ -416,3 +437,20 @@ void CreateCollectionRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void CreateCollectionRequest::cancel()
+{
+    Q_D(CreateCollectionRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -40,6 +40,7 @@ public:
     Sailfish::Secrets::SecretManager::AccessControlMode m_accessControlMode;
     Sailfish::Secrets::SecretManager::UserInteractionMode m_userInteractionMode;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
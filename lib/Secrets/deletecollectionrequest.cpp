@@ -19,6 +19,7 @@ using namespace Sailfish::Secrets;
 
 DeleteCollectionRequestPrivate::DeleteCollectionRequestPrivate()
     : m_userInteractionMode(SecretManager::PreventInteraction)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -160,6 +161,25 @@ Result DeleteCollectionRequest::result() const
     return d->m_result;
 }
 
+int DeleteCollectionRequest::timeout() const
+{
+    Q_D(const DeleteCollectionRequest);
+    return d->m_timeout;
+}
+
+void DeleteCollectionRequest::setTimeout(int timeout)
+{
+    Q_D(DeleteCollectionRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *DeleteCollectionRequest::manager() const
 {
     Q_D(const DeleteCollectionRequest);
@@ -186,6 +206,7 @@ void DeleteCollectionRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result> reply = d->m_manager->d_ptr->deleteCollection(
                                                     d->m_collectionName,
                                                     d->m_storagePluginName,
@@ -226,3 +247,20 @@ void DeleteCollectionRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void DeleteCollectionRequest::cancel()
+{
+    Q_D(DeleteCollectionRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -34,6 +34,7 @@ public:
     QString m_storagePluginName;
     Sailfish::Secrets::SecretManager::UserInteractionMode m_userInteractionMode;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
@@ -19,6 +19,7 @@ using namespace Sailfish::Secrets;
 
 DeleteSecretRequestPrivate::DeleteSecretRequestPrivate()
     : m_userInteractionMode(SecretManager::PreventInteraction)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -127,6 +128,25 @@ Result DeleteSecretRequest::result() const
     return d->m_result;
 }
 
+int DeleteSecretRequest::timeout() const
+{
+    Q_D(const DeleteSecretRequest);
+    return d->m_timeout;
+}
+
+void DeleteSecretRequest::setTimeout(int timeout)
+{
+    Q_D(DeleteSecretRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *DeleteSecretRequest::manager() const
 {
     Q_D(const DeleteSecretRequest);
@@ -153,6 +173,7 @@ void DeleteSecretRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result> reply = d->m_manager->d_ptr->deleteSecret(
                                                         d->m_identifier,
                                                         d->m_userInteractionMode);
@@ -186,3 +207,20 @@ void DeleteSecretRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void DeleteSecretRequest::cancel()
+{
+    Q_D(DeleteSecretRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
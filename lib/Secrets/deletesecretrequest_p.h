@@ -33,6 +33,7 @@ public:
     Sailfish::Secrets::Secret::Identifier m_identifier;
     Sailfish::Secrets::SecretManager::UserInteractionMode m_userInteractionMode;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "Secrets/deletesecretsrequest.h"
+#include "Secrets/deletesecretsrequest_p.h"
+
+#include "Secrets/secretmanager.h"
+#include "Secrets/secretmanager_p.h"
+#include "Secrets/serialization_p.h"
+
+#include <QtDBus/QDBusPendingReply>
+#include <QtDBus/QDBusPendingCallWatcher>
+
+using namespace Sailfish::Secrets;
+
+DeleteSecretsRequestPrivate::DeleteSecretsRequestPrivate()
+    : m_filterOperator(SecretManager::OperatorOr)
+    , m_userInteractionMode(SecretManager::PreventInteraction)
+    , m_timeout(0)
+    , m_status(Request::Inactive)
+{
+}
+
+/*!
+ * \class DeleteSecretsRequest
+ * \brief Allows a client to request that the secrets which match a specific filter
+ *        be deleted from the system's secure secret storage service
+ *
+ * The filter specifies metadata field/value pairs, and will be matched against
+ * the secrets in the collection identified by the specified collectionName()
+ * in the storage plugin identified by the specified storagePluginName(),
+ * according to the given filterOperator(), in the same way as for
+ * \l FindSecretsRequest.  Every matching secret is then deleted.
+ *
+ * Unlike performing a \l FindSecretsRequest followed by a \l DeleteSecretRequest
+ * for each of the matching secrets, the matching secrets are found and deleted
+ * by the storage plugin in a single request, and are deleted all together or
+ * not at all.  The identifiers() of the deleted secrets are reported once the
+ * request has finished.
+ *
+ * If the calling application is the creator of the collection, or alternatively
+ * if the user has granted the application permission to modify the collection,
+ * then the Secrets service will instruct the storage plugin to delete the
+ * matching secrets.  Otherwise, the same access control and authentication
+ * flows as described for \l DeleteSecretRequest may be triggered, subject to
+ * the given userInteractionMode().
+ *
+ * Deleting standalone secrets by filter is not supported; a collectionName()
+ * must be specified.
+ *
+ * An example of deleting the secrets in a collection which match a filter follows:
+ *
+ * \code
+ * Secret::FilterData filter;
+ * filter.insert(QLatin1String("domain"), QLatin1String("sailfishos.org"));
+ *
+ * Sailfish::Secrets::SecretManager sm;
+ * Sailfish::Secrets::DeleteSecretsRequest dsr;
+ * dsr.setManager(&sm);
+ * dsr.setCollectionName(QLatin1String("ExampleCollection"));
+ * dsr.setStoragePluginName(Sailfish::Secrets::SecretManager::DefaultEncryptedStoragePluginName);
+ * dsr.setFilter(filter);
+ * dsr.setFilterOperator(Sailfish::Secrets::SecretManager::OperatorOr);
+ * dsr.setUserInteractionMode(Sailfish::Secrets::SecretManager::SystemInteraction);
+ * dsr.startRequest(); // status() will change to Finished when complete
+ * \endcode
+ */
+
+/*!
+ * \brief Constructs a new DeleteSecretsRequest object with the given \a parent.
+ */
+DeleteSecretsRequest::DeleteSecretsRequest(QObject *parent)
+    : Request(parent)
+    , d_ptr(new DeleteSecretsRequestPrivate)
+{
+}
+
+/*!
+ * \brief Destroys the DeleteSecretsRequest
+ */
+DeleteSecretsRequest::~DeleteSecretsRequest()
+{
+}
+
+/*!
+ * \brief Returns the name of the collection from which the client wishes to delete the secrets matching some filter
+ */
+QString DeleteSecretsRequest::collectionName() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_collectionName;
+}
+
+/*!
+ * \brief Sets the name of the collection from which the client wishes to delete the secrets matching some filter to \a name
+ */
+void DeleteSecretsRequest::setCollectionName(const QString &name)
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_status != Request::Active && d->m_collectionName != name) {
+        d->m_collectionName = name;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit collectionNameChanged();
+    }
+}
+
+/*!
+ * \brief Returns the name of the storage plugin from which the client wishes to delete secrets
+ */
+QString DeleteSecretsRequest::storagePluginName() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_storagePluginName;
+}
+
+/*!
+ * \brief Sets the name of the storage plugin from which the client wishes to delete secrets to \a pluginName
+ */
+void DeleteSecretsRequest::setStoragePluginName(const QString &pluginName)
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_status != Request::Active && d->m_storagePluginName != pluginName) {
+        d->m_storagePluginName = pluginName;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit storagePluginNameChanged();
+    }
+}
+
+/*!
+ * \brief Returns the filter which will be used to select the secrets to delete
+ */
+Sailfish::Secrets::Secret::FilterData DeleteSecretsRequest::filter() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_filter;
+}
+
+/*!
+ * \brief Sets the filter which will be used to select the secrets to delete to \a filter
+ *
+ * The filter consists of key/value pairs which will be matched according to the
+ * specified filterOperator(), as described for \l FindSecretsRequest::setFilter().
+ */
+void DeleteSecretsRequest::setFilter(const Sailfish::Secrets::Secret::FilterData &filter)
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_status != Request::Active && d->m_filter != filter) {
+        d->m_filter = filter;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit filterChanged();
+    }
+}
+
+/*!
+ * \brief Returns the filter operator which will be used to select the secrets to delete
+ */
+Sailfish::Secrets::SecretManager::FilterOperator DeleteSecretsRequest::filterOperator() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_filterOperator;
+}
+
+/*!
+ * \brief Sets the filter operator which will be used to select the secrets to delete to \a op
+ *
+ * If the filter operator is AND then all keys must exist in the filter data stored for the secret,
+ * and all values for those keys must match the values specified in the input filter.
+ *
+ * If the filter operator is OR then at least one of the keys must exist in the filter data stored
+ * for the secret, where that key's value must match the value specified for that key in the
+ * input filter.
+ */
+void DeleteSecretsRequest::setFilterOperator(Sailfish::Secrets::SecretManager::FilterOperator op)
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_status != Request::Active && d->m_filterOperator != op) {
+        d->m_filterOperator = op;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit filterOperatorChanged();
+    }
+}
+
+/*!
+ * \brief Returns the user interaction mode required when deleting the secrets (e.g. if a custom lock code must be requested from the user)
+ */
+SecretManager::UserInteractionMode DeleteSecretsRequest::userInteractionMode() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_userInteractionMode;
+}
+
+/*!
+ * \brief Sets the user interaction mode required when deleting the secrets (e.g. if a custom lock code must be requested from the user) to \a mode
+ */
+void DeleteSecretsRequest::setUserInteractionMode(SecretManager::UserInteractionMode mode)
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_status != Request::Active && d->m_userInteractionMode != mode) {
+        d->m_userInteractionMode = mode;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit userInteractionModeChanged();
+    }
+}
+
+/*!
+ * \brief Returns the identifiers of the secrets which matched the filter and were deleted.
+ */
+QVector<Secret::Identifier> DeleteSecretsRequest::identifiers() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_identifiers;
+}
+
+Request::Status DeleteSecretsRequest::status() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_status;
+}
+
+Result DeleteSecretsRequest::result() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_result;
+}
+
+int DeleteSecretsRequest::timeout() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_timeout;
+}
+
+void DeleteSecretsRequest::setTimeout(int timeout)
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
+SecretManager *DeleteSecretsRequest::manager() const
+{
+    Q_D(const DeleteSecretsRequest);
+    return d->m_manager.data();
+}
+
+void DeleteSecretsRequest::setManager(SecretManager *manager)
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_manager.data() != manager) {
+        d->m_manager = manager;
+        emit managerChanged();
+    }
+}
+
+void DeleteSecretsRequest::startRequest()
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_status != Request::Active && !d->m_manager.isNull()) {
+        d->m_status = Request::Active;
+        emit statusChanged();
+        if (d->m_result.code() != Result::Pending) {
+            d->m_result = Result(Result::Pending);
+            emit resultChanged();
+        }
+
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
+        QDBusPendingReply<Result, QVector<Secret::Identifier> > reply = d->m_manager->d_ptr->deleteSecrets(
+                                                                        d->m_collectionName,
+                                                                        d->m_storagePluginName,
+                                                                        d->m_filter,
+                                                                        d->m_filterOperator,
+                                                                        d->m_userInteractionMode);
+        if (!reply.isValid() && !reply.error().message().isEmpty()) {
+            d->m_status = Request::Finished;
+            d->m_result = Result(Result::SecretManagerNotInitializedError,
+                                 reply.error().message());
+            emit statusChanged();
+            emit resultChanged();
+        } else if (reply.isFinished()
+                // work around a bug in QDBusAbstractInterface / QDBusConnection...
+                && reply.argumentAt<0>().code() != Sailfish::Secrets::Result::Succeeded) {
+            d->m_status = Request::Finished;
+            d->m_result = reply.argumentAt<0>();
+            d->m_identifiers = reply.argumentAt<1>();
+            emit statusChanged();
+            emit resultChanged();
+            emit identifiersChanged();
+        } else {
+            d->m_watcher.reset(new QDBusPendingCallWatcher(reply));
+            connect(d->m_watcher.data(), &QDBusPendingCallWatcher::finished,
+                    [this] {
+                QDBusPendingCallWatcher *watcher = this->d_ptr->m_watcher.take();
+                QDBusPendingReply<Result, QVector<Secret::Identifier> > reply = *watcher;
+                this->d_ptr->m_status = Request::Finished;
+                this->d_ptr->m_result = reply.argumentAt<0>();
+                this->d_ptr->m_identifiers = reply.argumentAt<1>();
+                watcher->deleteLater();
+                emit this->statusChanged();
+                emit this->resultChanged();
+                emit this->identifiersChanged();
+            });
+        }
+    }
+}
+
+void DeleteSecretsRequest::waitForFinished()
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        d->m_watcher->waitForFinished();
+    }
+}
+
+void DeleteSecretsRequest::cancel()
+{
+    Q_D(DeleteSecretsRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHSECRETS_DELETESECRETSREQUEST_P_H
+#define LIBSAILFISHSECRETS_DELETESECRETSREQUEST_P_H
+
+#include "Secrets/secretsglobal.h"
+#include "Secrets/secretmanager.h"
+#include "Secrets/secret.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <QtDBus/QDBusPendingCallWatcher>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+class DeleteSecretsRequestPrivate
+{
+    Q_DISABLE_COPY(DeleteSecretsRequestPrivate)
+
+public:
+    explicit DeleteSecretsRequestPrivate();
+
+    QPointer<Sailfish::Secrets::SecretManager> m_manager;
+    QString m_collectionName;
+    QString m_storagePluginName;
+    Sailfish::Secrets::Secret::FilterData m_filter;
+    Sailfish::Secrets::SecretManager::FilterOperator m_filterOperator;
+    Sailfish::Secrets::SecretManager::UserInteractionMode m_userInteractionMode;
+    QVector<Sailfish::Secrets::Secret::Identifier> m_identifiers;
+
+    int m_timeout;
+    QScopedPointer<QDBusPendingCallWatcher> m_watcher;
+    Sailfish::Secrets::Request::Status m_status;
+    Sailfish::Secrets::Result m_result;
+};
+
+} // namespace Secrets
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHSECRETS_DELETESECRETSREQUEST_P_H
@@ -19,6 +19,7 @@ using namespace Sailfish::Secrets;
 
 FindSecretsRequestPrivate::FindSecretsRequestPrivate()
     : m_userInteractionMode(SecretManager::PreventInteraction)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -256,6 +257,25 @@ Result FindSecretsRequest::result() const
     return d->m_result;
 }
 
+int FindSecretsRequest::timeout() const
+{
+    Q_D(const FindSecretsRequest);
+    return d->m_timeout;
+}
+
+void FindSecretsRequest::setTimeout(int timeout)
+{
+    Q_D(FindSecretsRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *FindSecretsRequest::manager() const
 {
     Q_D(const FindSecretsRequest);
@@ -282,6 +302,7 @@ void FindSecretsRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QVector<Secret::Identifier> > reply;
         if (d->m_collectionName.isEmpty()) {
             reply = d->m_manager->d_ptr->findSecrets(d->m_storagePluginName,
@@ -336,3 +357,20 @@ void FindSecretsRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void FindSecretsRequest::cancel()
+{
+    Q_D(FindSecretsRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -38,6 +38,7 @@ public:
     Sailfish::Secrets::SecretManager::UserInteractionMode m_userInteractionMode;
     QVector<Sailfish::Secrets::Secret::Identifier> m_identifiers;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
@@ -18,7 +18,8 @@
 using namespace Sailfish::Secrets;
 
 HealthCheckRequestPrivate::HealthCheckRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
     , m_saltDataHealth(HealthCheckRequest::HealthUnknown)
     , m_masterlockHealth(HealthCheckRequest::HealthUnknown)
 {
@@ -113,6 +114,25 @@ Result HealthCheckRequest::result() const
     return d->m_result;
 }
 
+int HealthCheckRequest::timeout() const
+{
+    Q_D(const HealthCheckRequest);
+    return d->m_timeout;
+}
+
+void HealthCheckRequest::setTimeout(int timeout)
+{
+    Q_D(HealthCheckRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *HealthCheckRequest::manager() const
 {
     Q_D(const HealthCheckRequest);
@@ -139,6 +159,7 @@ void HealthCheckRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result,
                           HealthCheckRequest::Health,
                           HealthCheckRequest::Health> reply
@@ -195,3 +216,20 @@ void HealthCheckRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void HealthCheckRequest::cancel()
+{
+    Q_D(HealthCheckRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -30,6 +30,7 @@ class HealthCheckRequestPrivate
 public:
     explicit HealthCheckRequestPrivate();
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
@@ -18,7 +18,8 @@
 using namespace Sailfish::Secrets;
 
 InteractionRequestPrivate::InteractionRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -123,6 +124,25 @@ Result InteractionRequest::result() const
     return d->m_result;
 }
 
+int InteractionRequest::timeout() const
+{
+    Q_D(const InteractionRequest);
+    return d->m_timeout;
+}
+
+void InteractionRequest::setTimeout(int timeout)
+{
+    Q_D(InteractionRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *InteractionRequest::manager() const
 {
     Q_D(const InteractionRequest);
@@ -149,6 +169,7 @@ void InteractionRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, QByteArray> reply = d->m_manager->d_ptr->userInput(
                                                                 d->m_interactionParameters);
         if (!reply.isValid() && !reply.error().message().isEmpty()) {
@@ -191,3 +212,20 @@ void InteractionRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void InteractionRequest::cancel()
+{
+    Q_D(InteractionRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
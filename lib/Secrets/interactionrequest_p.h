@@ -33,6 +33,7 @@ public:
     Sailfish::Secrets::InteractionParameters m_interactionParameters;
     QByteArray m_userInput;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
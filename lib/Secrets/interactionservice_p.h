@@ -45,7 +45,7 @@ class SAILFISH_SECRETS_API InteractionService : public QObject, protected QDBusC
     "  <interface name=\"org.sailfishos.secrets.interaction\">\n"
     "      <method name=\"performInteractionRequest\" />\n"
     "          <arg name=\"request\" type=\"(sss(i)sss(i)(i))\" direction=\"in\" />\n"
-    "          <arg name=\"response\" type=\"((iis)ay)\" direction=\"out\" />\n"
+    "          <arg name=\"response\" type=\"((iisi)ay)\" direction=\"out\" />\n"
     "          <arg name=\"requestId\" type=\"s\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In0\" value=\"Sailfish::Secrets::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::InteractionResponse\" />\n"
@@ -53,18 +53,18 @@ class SAILFISH_SECRETS_API InteractionService : public QObject, protected QDBusC
     "      <method name=\"continueInteractionRequest\" />\n"
     "          <arg name=\"requestId\" type=\"s\" direction=\"in\" />\n"
     "          <arg name=\"request\" type=\"(sss(i)sss(i)(i))\" direction=\"in\" />\n"
-    "          <arg name=\"response\" type=\"((iis)ay)\" direction=\"out\" />\n"
+    "          <arg name=\"response\" type=\"((iisi)ay)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.In1\" value=\"Sailfish::Secrets::InteractionParameters\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::InteractionResponse\" />\n"
     "      </method>\n"
     "      <method name=\"cancelInteractionRequest\" />\n"
     "          <arg name=\"requestId\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
     "      </method>\n"
     "      <method name=\"finishInteractionRequest\" />\n"
     "          <arg name=\"requestId\" type=\"s\" direction=\"in\" />\n"
-    "          <arg name=\"result\" type=\"(iis)\" direction=\"out\" />\n"
+    "          <arg name=\"result\" type=\"(iisi)\" direction=\"out\" />\n"
     "          <annotation name=\"org.qtproject.QtDBus.QtTypeName.Out0\" value=\"Sailfish::Secrets::Result\" />\n"
     "      </method>\n"
     "  </interface>\n"
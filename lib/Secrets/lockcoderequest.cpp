@@ -22,6 +22,7 @@ LockCodeRequestPrivate::LockCodeRequestPrivate()
     , m_lockCodeRequestType(LockCodeRequest::ModifyLockCode)
     , m_lockCodeTargetType(LockCodeRequest::MetadataDatabase)
     , m_userInteractionMode(SecretManager::SystemInteraction)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -286,6 +287,25 @@ Result LockCodeRequest::result() const
     return d->m_result;
 }
 
+int LockCodeRequest::timeout() const
+{
+    Q_D(const LockCodeRequest);
+    return d->m_timeout;
+}
+
+void LockCodeRequest::setTimeout(int timeout)
+{
+    Q_D(LockCodeRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *LockCodeRequest::manager() const
 {
     Q_D(const LockCodeRequest);
@@ -313,6 +333,7 @@ void LockCodeRequest::startRequest()
         }
 
         if (d->m_lockCodeRequestType == LockCodeRequest::QueryLockStatus) {
+            d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
             QDBusPendingReply<Result, LockCodeRequest::LockStatus> reply;
             reply = d->m_manager->d_ptr->queryLockStatus(d->m_lockCodeTargetType,
                                                          d->m_lockCodeTarget);
@@ -349,6 +370,7 @@ void LockCodeRequest::startRequest()
                 });
             }
         } else {
+            d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
             QDBusPendingReply<Result> reply;
             if (d->m_lockCodeRequestType == LockCodeRequest::ModifyLockCode) {
                 reply = d->m_manager->d_ptr->modifyLockCode(d->m_lockCodeTargetType,
@@ -404,3 +426,20 @@ void LockCodeRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void LockCodeRequest::cancel()
+{
+    Q_D(LockCodeRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -38,6 +38,7 @@ public:
     Sailfish::Secrets::InteractionParameters m_interactionParameters;
     QString m_lockCodeTarget;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
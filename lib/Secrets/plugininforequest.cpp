@@ -18,7 +18,8 @@
 using namespace Sailfish::Secrets;
 
 PluginInfoRequestPrivate::PluginInfoRequestPrivate()
-    : m_status(Request::Inactive)
+    : m_timeout(0)
+    , m_status(Request::Inactive)
 {
 }
 
@@ -41,6 +42,11 @@ PluginInfoRequestPrivate::PluginInfoRequestPrivate()
  *              << "with version:" << plugin.version();
  * }
  * \endcode
+ *
+ * The daemon reports the state of the plugins from memory, so the request
+ * is inexpensive.  The SecretManager emits \c{pluginInfoChanged()} when the
+ * availability or lock state of a plugin may have changed, after which the
+ * request may be performed again.
  */
 
 /*!
@@ -153,6 +159,25 @@ Result PluginInfoRequest::result() const
     return d->m_result;
 }
 
+int PluginInfoRequest::timeout() const
+{
+    Q_D(const PluginInfoRequest);
+    return d->m_timeout;
+}
+
+void PluginInfoRequest::setTimeout(int timeout)
+{
+    Q_D(PluginInfoRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *PluginInfoRequest::manager() const
 {
     Q_D(const PluginInfoRequest);
@@ -179,6 +204,7 @@ void PluginInfoRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result,
                           QVector<PluginInfo>,
                           QVector<PluginInfo>,
@@ -241,3 +267,20 @@ void PluginInfoRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void PluginInfoRequest::cancel()
+{
+    Q_D(PluginInfoRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
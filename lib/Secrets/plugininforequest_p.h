@@ -36,6 +36,7 @@ public:
     QVector<Sailfish::Secrets::PluginInfo> m_encryptedStoragePlugins;
     QVector<Sailfish::Secrets::PluginInfo> m_authenticationPlugins;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
@@ -65,6 +65,54 @@ Request::~Request()
  * Note: this method is generally unsafe and should be avoided.
  */
 
+/*!
+ * \brief Returns the deadline of the request, in milliseconds
+ *
+ * If the secrets service is not able to start processing the request within
+ * this many milliseconds of receiving it, the request fails with the error
+ * code \c{Result::RequestTimedOutError} without being performed.  The
+ * deadline is checked again before each further step of the request (for
+ * example, after the user has been asked to unlock a collection), so a
+ * request which runs out of time part way through fails with the same error
+ * code instead of starting the next step.  A step which is already under
+ * way is allowed to complete.
+ *
+ * A value of zero (the default) means that the request has no deadline.
+ *
+ * The default implementation returns zero.
+ */
+int Request::timeout() const
+{
+    return 0;
+}
+
+/*!
+ * \brief Sets the deadline of the request to \a timeout milliseconds
+ *
+ * The deadline applies to requests started after it is set.
+ *
+ * The default implementation ignores the deadline.
+ */
+void Request::setTimeout(int timeout)
+{
+    Q_UNUSED(timeout);
+}
+
+/*!
+ * \brief Cancels the request if it is active
+ *
+ * The status of the request changes to Request::Finished and its result to
+ * a failure with the error code \c{Result::OperationCanceledError}.
+ * If the secrets service has not yet started to process the request, it will
+ * not do so.  Otherwise the service may still complete the operation, but
+ * will not reply to the client.
+ *
+ * The default implementation does nothing.
+ */
+void Request::cancel()
+{
+}
+
 /*!
  * \signal Request::statusChanged()
  * \brief This signal is emitted whenever the status of the request is changed
@@ -74,3 +122,8 @@ Request::~Request()
  * \signal Request::resultChanged()
  * \brief This signal is emitted whenever the result of the request is changed
  */
+
+/*!
+ * \signal Request::timeoutChanged()
+ * \brief This signal is emitted whenever the deadline of the request is changed
+ */
@@ -24,6 +24,7 @@ class SAILFISH_SECRETS_API Request : public QObject
     Q_PROPERTY(Sailfish::Secrets::SecretManager* manager READ manager WRITE setManager NOTIFY managerChanged)
     Q_PROPERTY(Sailfish::Secrets::Request::Status status READ status NOTIFY statusChanged)
     Q_PROPERTY(Sailfish::Secrets::Result result READ result NOTIFY resultChanged)
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
 
 public:
     enum Status {
@@ -41,11 +42,15 @@ public:
     virtual Sailfish::Secrets::Result result() const = 0;
     Q_INVOKABLE virtual void startRequest() = 0;
     Q_INVOKABLE virtual void waitForFinished() = 0;
+    virtual int timeout() const;
+    virtual void setTimeout(int timeout);
+    Q_INVOKABLE virtual void cancel();
 
 Q_SIGNALS:
     void managerChanged();
     void statusChanged();
     void resultChanged();
+    void timeoutChanged();
 };
 
 } // namespace Secrets
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHSECRETS_REQUESTPIPELINE_H
+#define LIBSAILFISHSECRETS_REQUESTPIPELINE_H
+
+#include "Secrets/secretsglobal.h"
+#include "Secrets/request.h"
+#include "Secrets/result.h"
+#include "Secrets/secretmanager.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QList>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+class RequestPipelinePrivate;
+class SAILFISH_SECRETS_API RequestPipeline : public Sailfish::Secrets::Request
+{
+    Q_OBJECT
+
+public:
+    RequestPipeline(QObject *parent = Q_NULLPTR);
+    ~RequestPipeline();
+
+    QList<Sailfish::Secrets::Request*> requests() const;
+    void setRequests(const QList<Sailfish::Secrets::Request*> &requests);
+
+    Sailfish::Secrets::Request::Status status() const Q_DECL_OVERRIDE;
+    Sailfish::Secrets::Result result() const Q_DECL_OVERRIDE;
+
+    int timeout() const Q_DECL_OVERRIDE;
+    void setTimeout(int timeout) Q_DECL_OVERRIDE;
+
+    Sailfish::Secrets::SecretManager *manager() const Q_DECL_OVERRIDE;
+    void setManager(Sailfish::Secrets::SecretManager *manager) Q_DECL_OVERRIDE;
+
+    void startRequest() Q_DECL_OVERRIDE;
+    void waitForFinished() Q_DECL_OVERRIDE;
+    void cancel() Q_DECL_OVERRIDE;
+
+Q_SIGNALS:
+    void requestsChanged();
+
+private:
+    void finishIfComplete();
+
+    QScopedPointer<RequestPipelinePrivate> const d_ptr;
+    Q_DECLARE_PRIVATE(RequestPipeline)
+};
+
+} // namespace Secrets
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHSECRETS_REQUESTPIPELINE_H
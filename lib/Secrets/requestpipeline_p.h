@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHSECRETS_REQUESTPIPELINE_P_H
+#define LIBSAILFISHSECRETS_REQUESTPIPELINE_P_H
+
+#include "Secrets/secretsglobal.h"
+#include "Secrets/secretmanager.h"
+#include "Secrets/request.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QList>
+#include <QtCore/QMetaObject>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+class RequestPipelinePrivate
+{
+    Q_DISABLE_COPY(RequestPipelinePrivate)
+
+public:
+    explicit RequestPipelinePrivate();
+
+    QPointer<Sailfish::Secrets::SecretManager> m_manager;
+    QList<QPointer<Sailfish::Secrets::Request> > m_requests;
+    QList<QMetaObject::Connection> m_connections; // to the requests, while the pipeline is active.
+    bool m_starting;
+
+    int m_timeout;
+    Sailfish::Secrets::Request::Status m_status;
+    Sailfish::Secrets::Result m_result;
+};
+
+} // namespace Secrets
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHSECRETS_REQUESTPIPELINE_P_H
@@ -16,6 +16,7 @@ ResultPrivate::ResultPrivate()
     : QSharedData()
     , m_errorCode(Result::NoError)
     , m_code(Result::Succeeded)
+    , m_retryAfter(0)
 {
 }
 
@@ -24,6 +25,7 @@ ResultPrivate::ResultPrivate(const ResultPrivate &other)
     , m_errorMessage(other.m_errorMessage)
     , m_errorCode(other.m_errorCode)
     , m_code(other.m_code)
+    , m_retryAfter(other.m_retryAfter)
 {
 }
 
@@ -166,6 +168,28 @@ Result::ResultCode Result::code() const
     return d_ptr->m_code;
 }
 
+/*!
+ * \brief Sets the retry-after hint associated with the result to \a msecs
+ */
+void Result::setRetryAfter(int msecs)
+{
+    d_ptr->m_retryAfter = msecs;
+}
+
+/*!
+ * \brief Returns the retry-after hint associated with the result, in milliseconds
+ *
+ * If the secrets daemon rejected the operation because the client already
+ * has too much work queued (that is, the error code is
+ * \c{SecretsDaemonBusyError}), the operation may be retried later.
+ * The returned value is the daemon's estimate of how long the client should
+ * wait before retrying.  A value of zero means that no hint is available.
+ */
+int Result::retryAfter() const
+{
+    return d_ptr->m_retryAfter;
+}
+
 /*!
  * \brief Returns true if the \a lhs result is equal to the \a rhs result
  */
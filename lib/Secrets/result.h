@@ -25,6 +25,7 @@ class SAILFISH_SECRETS_API Result
     Q_PROPERTY(QString errorMessage READ errorMessage WRITE setErrorMessage)
     Q_PROPERTY(Sailfish::Secrets::Result::ErrorCode errorCode READ errorCode WRITE setErrorCode)
     Q_PROPERTY(Sailfish::Secrets::Result::ResultCode code READ code WRITE setCode)
+    Q_PROPERTY(int retryAfter READ retryAfter WRITE setRetryAfter)
 
 public:
     enum ResultCode {
@@ -47,11 +48,15 @@ public:
         OperationRequiresApplicationUserInteraction,
         OperationRequiresSystemUserInteraction,
         SecretManagerNotInitializedError,
+        OperationCanceledError,
+        RequestTimedOutError,
 
         SecretsDaemonRequestPidError = 20,
         SecretsDaemonRequestQueueFullError,
         SecretsDaemonLockedError,
         SecretsDaemonNotLockedError,
+        SecretsDaemonBusyError,
+        SecretsDaemonPipelineAbortedError,
 
         SecretsPluginEncryptionError = 30,
         SecretsPluginDecryptionError,
@@ -164,6 +169,9 @@ public:
     void setCode(Sailfish::Secrets::Result::ResultCode c);
     Sailfish::Secrets::Result::ResultCode code() const;
 
+    void setRetryAfter(int msecs);
+    int retryAfter() const;
+
 private:
     QSharedDataPointer<ResultPrivate> d_ptr;
     friend class ResultPrivate;
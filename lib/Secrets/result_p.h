@@ -27,6 +27,7 @@ public:
     QString m_errorMessage;
     Sailfish::Secrets::Result::ErrorCode m_errorCode;
     Sailfish::Secrets::Result::ResultCode m_code;
+    int m_retryAfter;
 };
 
 } // namespace Secrets
@@ -28,6 +28,17 @@ Q_LOGGING_CATEGORY(lcSailfishSecrets, "org.sailfishos.secrets", QtWarningMsg)
 
 using namespace Sailfish::Secrets;
 
+namespace {
+    // Copies of a QDBusPendingCall share the state of the call,
+    // which therefore identifies the call.
+    class PendingCallIdentity : public QDBusPendingCall
+    {
+    public:
+        PendingCallIdentity(const QDBusPendingCall &call) : QDBusPendingCall(call) {}
+        bool isSameCall(const QDBusPendingCall &other) const { return d == PendingCallIdentity(other).d; }
+    };
+}
+
 const QString Secret::FilterDataFieldType = QStringLiteral("Type");
 const QString Secret::TypeUnknown = QStringLiteral("Unknown");
 const QString Secret::TypeBlob = QStringLiteral("Blob");
@@ -58,6 +69,8 @@ SecretManagerPrivate::SecretManagerPrivate(SecretManager *parent)
     , m_interface(m_secrets->connect()
                   ? m_secrets->createInterface(QLatin1String("/Sailfish/Secrets"), QLatin1String("org.sailfishos.secrets"), this)
                   : Q_NULLPTR)
+    , m_nextRequestTimeout(0)
+    , m_pipelineId(0)
 {
 }
 
@@ -67,6 +80,113 @@ SecretManagerPrivate::~SecretManagerPrivate()
     m_interface = Q_NULLPTR;
 }
 
+/*!
+ * \internal
+ * \brief Sends the \a method call with the given \a arguments to the daemon
+ *
+ * The daemon identifies the requests of a client by the order in which
+ * they were sent, so every request must be sent via this method for
+ * cancelRequest() to be able to identify it.
+ */
+QDBusPendingCall SecretManagerPrivate::sendRequest(
+        const QString &method,
+        const QVariantList &arguments)
+{
+    // forget the requests which the daemon has already replied to.
+    for (int i = m_sentRequests.size() - 1; i >= 0; --i) {
+        if (m_sentRequests.at(i).call.isFinished()) {
+            m_sentRequests.removeAt(i);
+        }
+    }
+
+    // the timeout applies to this request only.
+    const int timeout = m_nextRequestTimeout;
+    m_nextRequestTimeout = 0;
+
+    quint64 sequence = 0;
+    QDBusPendingCall call = m_secrets->sendRequest(m_interface, method, arguments, timeout, m_pipelineId, &sequence);
+    m_sentRequests.append(SentRequest(call, sequence, method));
+    return call;
+}
+
+/*!
+ * \internal
+ * \brief Asks the daemon to cancel the request associated with the given pending \a call
+ *
+ * The daemon will not start the request if it has not already done so,
+ * and will not reply to it.  It is up to the caller to stop watching the
+ * \a call.
+ */
+void SecretManagerPrivate::cancelRequest(const QDBusPendingCall &call)
+{
+    const int index = sentRequestIndex(call);
+    if (index >= 0) {
+        const SentRequest request = m_sentRequests.takeAt(index);
+        if (m_interface && !request.call.isFinished()) {
+            // the reply carries no information, so don't wait for it.
+            m_interface->asyncCallWithArgumentList(
+                        QStringLiteral("cancelRequest"),
+                        QVariantList() << QVariant::fromValue<quint64>(request.sequence)
+                                       << QVariant::fromValue<QString>(request.method));
+        }
+    }
+}
+
+/*!
+ * \internal
+ * \brief Sets the deadline of the next request sent via this manager to \a timeout milliseconds
+ *
+ * The deadline is sent along with the request, and the daemon measures it
+ * from when it receives the request.  A \a timeout of zero means that the
+ * request has no deadline.
+ */
+void SecretManagerPrivate::setNextRequestTimeout(int timeout)
+{
+    m_nextRequestTimeout = timeout;
+}
+
+/*!
+ * \internal
+ * \brief Makes the requests sent via this manager until endPipeline() is called form a pipeline
+ *
+ * Each of those requests is tagged with the id of the pipeline.  The daemon
+ * starts each request of the pipeline once the previous one has succeeded,
+ * and fails the remaining requests of the pipeline without starting them
+ * once one of them has failed.  As the order is enforced by the daemon, the
+ * requests may be sent without waiting for any replies.  Requests which are
+ * not tagged, including those sent via other managers sharing the daemon
+ * connection, are not part of the pipeline.
+ */
+void SecretManagerPrivate::beginPipeline()
+{
+    m_pipelineId = m_secrets->allocatePipelineId();
+}
+
+/*!
+ * \internal
+ * \brief Tells the daemon that the pipeline begun by beginPipeline() has no further requests
+ */
+void SecretManagerPrivate::endPipeline()
+{
+    if (m_interface && m_pipelineId) {
+        // the call is not itself a request, so it is not numbered.
+        m_interface->asyncCallWithArgumentList(QStringLiteral("endPipeline"),
+                                               QVariantList() << QVariant::fromValue<quint64>(m_pipelineId));
+    }
+    m_pipelineId = 0;
+}
+
+int SecretManagerPrivate::sentRequestIndex(const QDBusPendingCall &call) const
+{
+    const PendingCallIdentity identity(call);
+    for (int i = 0; i < m_sentRequests.size(); ++i) {
+        if (identity.isSameCall(m_sentRequests.at(i).call)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 Result
 SecretManagerPrivate::registerInteractionService(
         SecretManager::UserInteractionMode mode,
@@ -110,7 +230,7 @@ SecretManagerPrivate::getPluginInfo()
                       QVector<PluginInfo>,
                       QVector<PluginInfo>,
                       QVector<PluginInfo> > reply
-            = m_interface->asyncCall(QStringLiteral("getPluginInfo"));
+            = sendRequest(QStringLiteral("getPluginInfo"));
     return reply;
 }
 
@@ -131,7 +251,21 @@ SecretManagerPrivate::getHealthInfo()
     QDBusPendingReply<Sailfish::Secrets::Result,
                       HealthCheckRequest::Health,
                       HealthCheckRequest::Health> reply
-            = m_interface->asyncCall(QStringLiteral("getHealthInfo"));
+            = sendRequest(QStringLiteral("getHealthInfo"));
+    return reply;
+}
+
+QDBusPendingReply<Sailfish::Secrets::Result, QVariantMap>
+SecretManagerPrivate::getStatistics()
+{
+    if (!m_interface) {
+        return QDBusPendingReply<Sailfish::Secrets::Result, QVariantMap>(
+                    QDBusMessage::createError(QDBusError::Other,
+                                              QStringLiteral("Not connected to daemon")));
+    }
+
+    QDBusPendingReply<Sailfish::Secrets::Result, QVariantMap> reply
+            = sendRequest(QStringLiteral("getStatistics"));
     return reply;
 }
 
@@ -146,7 +280,7 @@ SecretManagerPrivate::userInput(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("userInput"),
                 QVariantList() << QVariant::fromValue<InteractionParameters>(uiParams));
     return reply;
@@ -164,7 +298,7 @@ SecretManagerPrivate::collectionNames(
     }
 
     QDBusPendingReply<Result, QVariantMap> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("collectionNames"),
                 QVariantList() << QVariant::fromValue<QString>(storagePluginName));
     return reply;
@@ -185,7 +319,7 @@ SecretManagerPrivate::createCollection(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("createCollection"),
                 QVariantList() << QVariant::fromValue<QString>(collectionName)
                                << QVariant::fromValue<QString>(storagePluginName)
@@ -220,7 +354,7 @@ SecretManagerPrivate::createCollection(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("createCollection"),
                 QVariantList() << QVariant::fromValue<QString>(collectionName)
                                << QVariant::fromValue<QString>(storagePluginName)
@@ -254,7 +388,7 @@ SecretManagerPrivate::deleteCollection(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("deleteCollection"),
                 QVariantList() << QVariant::fromValue<QString>(collectionName)
                                << QVariant::fromValue<QString>(storagePluginName)
@@ -292,7 +426,7 @@ SecretManagerPrivate::setSecret(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("setSecret"),
                 QVariantList() << QVariant::fromValue<Secret>(secret)
                                << QVariant::fromValue<InteractionParameters>(uiParams)
@@ -333,7 +467,7 @@ SecretManagerPrivate::setSecret(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("setSecret"),
                 QVariantList() << QVariant::fromValue<Secret>(secret)
                                << QVariant::fromValue<QString>(encryptionPluginName)
@@ -378,7 +512,7 @@ SecretManagerPrivate::setSecret(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("setSecret"),
                 QVariantList() << QVariant::fromValue<Secret>(secret)
                                << QVariant::fromValue<QString>(encryptionPluginName)
@@ -391,6 +525,60 @@ SecretManagerPrivate::setSecret(
     return reply;
 }
 
+QDBusPendingReply<Result, QVector<Result> >
+SecretManagerPrivate::setSecrets(
+        const QVector<Secret> &secrets,
+        SecretManager::UserInteractionMode userInteractionMode)
+{
+    if (!m_interface) {
+        return QDBusPendingReply<Result>(
+                    QDBusMessage::createError(QDBusError::Other,
+                                              QStringLiteral("Not connected to daemon")));
+    }
+
+    if (secrets.isEmpty()) {
+        Result identifierError(Result::InvalidSecretIdentifierError,
+                               QLatin1String("No secrets were given"));
+        return QDBusPendingReply<Result>(
+                QDBusMessage().createReply(
+                        QVariantList() << QVariant::fromValue<Result>(identifierError)));
+    }
+
+    const Secret::Identifier &first(secrets.first().identifier());
+    for (const Secret &secret : secrets) {
+        if (!secret.identifier().isValid() || secret.identifier().identifiesStandaloneSecret()) {
+            Result identifierError(Result::InvalidSecretIdentifierError,
+                                   QLatin1String("This method cannot be invoked with a standalone secret"));
+            return QDBusPendingReply<Result>(
+                    QDBusMessage().createReply(
+                            QVariantList() << QVariant::fromValue<Result>(identifierError)));
+        } else if (secret.identifier().collectionName() != first.collectionName()
+                   || secret.identifier().storagePluginName() != first.storagePluginName()) {
+            Result identifierError(Result::InvalidSecretIdentifierError,
+                                   QLatin1String("The given secrets must all be stored in the same collection"));
+            return QDBusPendingReply<Result>(
+                    QDBusMessage().createReply(
+                            QVariantList() << QVariant::fromValue<Result>(identifierError)));
+        }
+    }
+
+    QString interactionServiceAddress;
+    Result uiServiceResult = registerInteractionService(userInteractionMode, &interactionServiceAddress);
+    if (uiServiceResult.code() == Result::Failed) {
+        return QDBusPendingReply<Result>(
+                QDBusMessage().createReply(
+                        QVariantList() << QVariant::fromValue<Result>(uiServiceResult)));
+    }
+
+    QDBusPendingReply<Result, QVector<Result> > reply
+            = sendRequest(
+                QStringLiteral("setSecrets"),
+                QVariantList() << QVariant::fromValue<QVector<Secret> >(secrets)
+                               << QVariant::fromValue<SecretManager::UserInteractionMode>(userInteractionMode)
+                               << QVariant::fromValue<QString>(interactionServiceAddress));
+    return reply;
+}
+
 QDBusPendingReply<Result, Secret>
 SecretManagerPrivate::getSecret(
         const Secret::Identifier &identifier,
@@ -419,7 +607,7 @@ SecretManagerPrivate::getSecret(
     }
 
     QDBusPendingReply<Result, Secret> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("getSecret"),
                 QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
                                << QVariant::fromValue<SecretManager::UserInteractionMode>(userInteractionMode)
@@ -427,6 +615,52 @@ SecretManagerPrivate::getSecret(
     return reply;
 }
 
+QDBusPendingReply<Result, QVector<Secret> >
+SecretManagerPrivate::getSecrets(
+        const QVector<Secret::Identifier> &identifiers,
+        SecretManager::UserInteractionMode userInteractionMode)
+{
+    if (!m_interface) {
+        return QDBusPendingReply<Result>(
+                    QDBusMessage::createError(QDBusError::Other,
+                                              QStringLiteral("Not connected to daemon")));
+    }
+
+    if (identifiers.isEmpty()) {
+        Result identifierError(Result::InvalidSecretIdentifierError,
+                               QLatin1String("No identifiers were given"));
+        return QDBusPendingReply<Result>(
+                QDBusMessage().createReply(
+                        QVariantList() << QVariant::fromValue<Result>(identifierError)));
+    }
+
+    for (const Secret::Identifier &identifier : identifiers) {
+        if (!identifier.isValid() || identifier.identifiesStandaloneSecret()) {
+            Result identifierError(Result::InvalidSecretIdentifierError,
+                                   QLatin1String("The given identifiers must be valid collection secret identifiers"));
+            return QDBusPendingReply<Result>(
+                    QDBusMessage().createReply(
+                            QVariantList() << QVariant::fromValue<Result>(identifierError)));
+        }
+    }
+
+    QString interactionServiceAddress;
+    Result uiServiceResult = registerInteractionService(userInteractionMode, &interactionServiceAddress);
+    if (uiServiceResult.code() == Result::Failed) {
+        return QDBusPendingReply<Result>(
+                QDBusMessage().createReply(
+                        QVariantList() << QVariant::fromValue<Result>(uiServiceResult)));
+    }
+
+    QDBusPendingReply<Result, QVector<Secret> > reply
+            = sendRequest(
+                QStringLiteral("getSecrets"),
+                QVariantList() << QVariant::fromValue<QVector<Secret::Identifier> >(identifiers)
+                               << QVariant::fromValue<SecretManager::UserInteractionMode>(userInteractionMode)
+                               << QVariant::fromValue<QString>(interactionServiceAddress));
+    return reply;
+}
+
 QDBusPendingReply<Result, QVector<Secret::Identifier> >
 SecretManagerPrivate::findSecrets(
         const QString &collectionName,
@@ -460,7 +694,7 @@ SecretManagerPrivate::findSecrets(
     }
 
     QDBusPendingReply<Result, QVector<Secret::Identifier> > reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("findSecrets"),
                 QVariantList() << QVariant::fromValue<QString>(collectionName)
                                << QVariant::fromValue<QString>(storagePluginName)
@@ -493,7 +727,7 @@ SecretManagerPrivate::findSecrets(
     }
 
     QDBusPendingReply<Result, Secret> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("findSecrets"),
                 QVariantList() << QVariant::fromValue<QString>(QString())
                                << QVariant::fromValue<QString>(storagePluginName)
@@ -532,7 +766,7 @@ SecretManagerPrivate::deleteSecret(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("deleteSecret"),
                 QVariantList() << QVariant::fromValue<Secret::Identifier>(identifier)
                                << QVariant::fromValue<SecretManager::UserInteractionMode>(userInteractionMode)
@@ -540,6 +774,50 @@ SecretManagerPrivate::deleteSecret(
     return reply;
 }
 
+QDBusPendingReply<Result, QVector<Secret::Identifier> >
+SecretManagerPrivate::deleteSecrets(
+        const QString &collectionName,
+        const QString &storagePluginName,
+        const Secret::FilterData &filter,
+        SecretManager::FilterOperator filterOperator,
+        SecretManager::UserInteractionMode userInteractionMode)
+{
+    if (!m_interface) {
+        return QDBusPendingReply<Result, QVector<Secret::Identifier> >(
+                    QDBusMessage::createError(QDBusError::Other,
+                                              QStringLiteral("Not connected to daemon")));
+    }
+
+    if (collectionName.isEmpty()) {
+        Result collectionError(Result::InvalidCollectionError,
+                               QLatin1String("The given collection name is invalid"));
+        return QDBusPendingReply<Result, QVector<Secret::Identifier> >(
+                QDBusMessage().createReply(
+                        QVariantList() << QVariant::fromValue<Result>(collectionError)
+                                       << QVariant::fromValue<QVector<Secret::Identifier> >(QVector<Secret::Identifier>())));
+    }
+
+    QString interactionServiceAddress;
+    Result uiServiceResult = registerInteractionService(userInteractionMode, &interactionServiceAddress);
+    if (uiServiceResult.code() == Result::Failed) {
+        return QDBusPendingReply<Result, QVector<Secret::Identifier> >(
+                QDBusMessage().createReply(
+                        QVariantList() << QVariant::fromValue<Result>(uiServiceResult)
+                                       << QVariant::fromValue<QVector<Secret::Identifier> >(QVector<Secret::Identifier>())));
+    }
+
+    QDBusPendingReply<Result, QVector<Secret::Identifier> > reply
+            = sendRequest(
+                QStringLiteral("deleteSecrets"),
+                QVariantList() << QVariant::fromValue<QString>(collectionName)
+                               << QVariant::fromValue<QString>(storagePluginName)
+                               << QVariant::fromValue<Secret::FilterData>(filter)
+                               << QVariant::fromValue<SecretManager::FilterOperator>(filterOperator)
+                               << QVariant::fromValue<SecretManager::UserInteractionMode>(userInteractionMode)
+                               << QVariant::fromValue<QString>(interactionServiceAddress));
+    return reply;
+}
+
 QDBusPendingReply<Result, LockCodeRequest::LockStatus>
 SecretManagerPrivate::queryLockStatus(
         LockCodeRequest::LockCodeTargetType lockCodeTargetType,
@@ -552,7 +830,7 @@ SecretManagerPrivate::queryLockStatus(
     }
 
     QDBusPendingReply<Result, LockCodeRequest::LockStatus> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 "queryLockStatus",
                 QVariantList() << QVariant::fromValue<LockCodeRequest::LockCodeTargetType>(lockCodeTargetType)
                                << QVariant::fromValue<QString>(lockCodeTarget));
@@ -581,7 +859,7 @@ SecretManagerPrivate::modifyLockCode(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("modifyLockCode"),
                 QVariantList() << QVariant::fromValue<LockCodeRequest::LockCodeTargetType>(lockCodeTargetType)
                                << QVariant::fromValue<QString>(lockCodeTarget)
@@ -613,7 +891,7 @@ SecretManagerPrivate::provideLockCode(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("provideLockCode"),
                 QVariantList() << QVariant::fromValue<LockCodeRequest::LockCodeTargetType>(lockCodeTargetType)
                                << QVariant::fromValue<QString>(lockCodeTarget)
@@ -645,7 +923,7 @@ SecretManagerPrivate::forgetLockCode(
     }
 
     QDBusPendingReply<Result> reply
-            = m_interface->asyncCallWithArgumentList(
+            = sendRequest(
                 QStringLiteral("forgetLockCode"),
                 QVariantList() << QVariant::fromValue<LockCodeRequest::LockCodeTargetType>(lockCodeTargetType)
                                << QVariant::fromValue<QString>(lockCodeTarget)
@@ -679,10 +957,14 @@ SecretManagerPrivate *SecretManager::pimpl() const
   \li \l{Sailfish::Secrets::CreateCollectionRequest} to create a collection in which to store secrets
   \li \l{Sailfish::Secrets::DeleteCollectionRequest} to delete a collection of secrets
   \li \l{Sailfish::Secrets::StoreSecretRequest} to store a secret either in a collection or standalone
+  \li \l{Sailfish::Secrets::StoreSecretsRequest} to store multiple secrets into a collection at once
   \li \l{Sailfish::Secrets::StoredSecretRequest} to retrieve a secret
+  \li \l{Sailfish::Secrets::StoredSecretsRequest} to retrieve multiple collection-stored secrets at once
   \li \l{Sailfish::Secrets::FindSecretsRequest} to search a collection for secrets matching a filter
   \li \l{Sailfish::Secrets::DeleteSecretRequest} to delete a secret
+  \li \l{Sailfish::Secrets::DeleteSecretsRequest} to delete the secrets in a collection matching a filter
   \li \l{Sailfish::Secrets::InteractionRequest} to request the system mediate a user-interaction flow on behalf of the application
+  \li \l{Sailfish::Secrets::RequestPipeline} to perform a sequence of dependent requests in a single round trip
   \endlist
  */
 
@@ -698,6 +980,12 @@ SecretManager::SecretManager(QObject *parent)
         qCWarning(lcSailfishSecrets) << "Unable to connect to the secrets daemon!  No functionality will be available!";
         return;
     }
+
+    d_ptr->m_secrets->connection()->connect(QString(), // any service
+                                            QLatin1String("/Sailfish/Secrets"),
+                                            QLatin1String("org.sailfishos.secrets"),
+                                            QLatin1String("pluginInfoChanged"),
+                                            this, SIGNAL(pluginInfoChanged()));
 }
 
 /*!
@@ -707,6 +995,14 @@ SecretManager::~SecretManager()
 {
 }
 
+/*!
+  \fn SecretManager::pluginInfoChanged()
+  \brief Emitted when the availability or lock state of a plugin may have changed
+
+  Clients which display information about the plugins should perform a
+  new PluginInfoRequest when this signal is emitted, rather than polling.
+ */
+
 /*!
   \brief Returns true if the DBus connection has been established
  */
@@ -26,11 +26,14 @@ namespace Secrets {
 class CreateCollectionRequest;
 class DeleteCollectionRequest;
 class DeleteSecretRequest;
+class DeleteSecretsRequest;
 class FindSecretsRequest;
 class InteractionRequest;
 class PluginInfoRequest;
 class StoredSecretRequest;
+class StoredSecretsRequest;
 class StoreSecretRequest;
+class StoreSecretsRequest;
 class InteractionView;
 class SecretManagerPrivate;
 class SAILFISH_SECRETS_API SecretManager : public QObject
@@ -89,6 +92,7 @@ public:
 
 Q_SIGNALS:
     void isInitializedChanged();
+    void pluginInfoChanged();
 
 protected:
     SecretManagerPrivate *pimpl() const; // for unit tests
@@ -100,13 +104,18 @@ private:
     friend class CreateCollectionRequest;
     friend class DeleteCollectionRequest;
     friend class DeleteSecretRequest;
+    friend class DeleteSecretsRequest;
     friend class FindSecretsRequest;
     friend class InteractionRequest;
     friend class LockCodeRequest;
     friend class PluginInfoRequest;
     friend class HealthCheckRequest;
+    friend class RequestPipeline;
+    friend class StatisticsRequest;
     friend class StoredSecretRequest;
+    friend class StoredSecretsRequest;
     friend class StoreSecretRequest;
+    friend class StoreSecretsRequest;
 };
 
 } // namespace Secrets
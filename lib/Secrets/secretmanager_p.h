@@ -26,6 +26,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QPointer>
+#include <QtCore/QList>
 
 namespace Sailfish {
 
@@ -60,6 +61,9 @@ public:
                       HealthCheckRequest::Health,
                       HealthCheckRequest::Health> getHealthInfo();
 
+    // retrieve the request latency statistics of the daemon
+    QDBusPendingReply<Sailfish::Secrets::Result, QVariantMap> getStatistics();
+
     // retrieve user input data
     QDBusPendingReply<Sailfish::Secrets::Result, QByteArray> userInput(
             const Sailfish::Secrets::InteractionParameters &uiParams);
@@ -117,11 +121,21 @@ public:
             Sailfish::Secrets::SecretManager::AccessControlMode accessControlMode,
             Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode);
 
+    // set multiple secrets in a single collection.  Will immediately fail if any identifier is standalone.
+    QDBusPendingReply<Sailfish::Secrets::Result, QVector<Sailfish::Secrets::Result> > setSecrets(
+            const QVector<Sailfish::Secrets::Secret> &secrets,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode);
+
     // get a secret (either from a collection or standalone, depending on the identifier)
     QDBusPendingReply<Sailfish::Secrets::Result, Sailfish::Secrets::Secret> getSecret(
             const Sailfish::Secrets::Secret::Identifier &identifier,
             Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode);
 
+    // get multiple secrets from one or more collections
+    QDBusPendingReply<Sailfish::Secrets::Result, QVector<Sailfish::Secrets::Secret> > getSecrets(
+            const QVector<Sailfish::Secrets::Secret::Identifier> &identifiers,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode);
+
     // find secrets from a collection via filter
     QDBusPendingReply<Sailfish::Secrets::Result, QVector<Sailfish::Secrets::Secret::Identifier> > findSecrets(
             const QString &collectionName,
@@ -142,6 +156,14 @@ public:
             const Sailfish::Secrets::Secret::Identifier &identifier,
             Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode);
 
+    // delete the secrets in a collection which match a filter
+    QDBusPendingReply<Sailfish::Secrets::Result, QVector<Sailfish::Secrets::Secret::Identifier> > deleteSecrets(
+            const QString &collectionName,
+            const QString &storagePluginName,
+            const Sailfish::Secrets::Secret::FilterData &filter,
+            Sailfish::Secrets::SecretManager::FilterOperator filterOperator,
+            Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode);
+
     // query the lock status of a plugin or the metadata db
     QDBusPendingReply<Sailfish::Secrets::Result, Sailfish::Secrets::LockCodeRequest::LockStatus> queryLockStatus(
             Sailfish::Secrets::LockCodeRequest::LockCodeTargetType lockCodeTargetType,
@@ -168,13 +190,39 @@ public:
             const Sailfish::Secrets::InteractionParameters &interactionParameters,
             Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode);
 
+    // cancel a request which was sent via this manager and may still be in progress.
+    void cancelRequest(const QDBusPendingCall &call);
+
+    // set the deadline of the next request sent via this manager.
+    void setNextRequestTimeout(int timeout);
+
+    // have the daemon run the requests sent via this manager between these calls in order, stopping at the first failure.
+    void beginPipeline();
+    void endPipeline();
+
 private:
+    // send a request to the daemon, and remember it so that it may be cancelled.
+    QDBusPendingCall sendRequest(const QString &method, const QVariantList &arguments = QVariantList());
+
+    int sentRequestIndex(const QDBusPendingCall &call) const;
+
+    struct SentRequest {
+        SentRequest(const QDBusPendingCall &c, quint64 s, const QString &m)
+            : call(c), sequence(s), method(m) {}
+        QDBusPendingCall call;
+        quint64 sequence;   // the number of the call on the daemon connection.
+        QString method;
+    };
+
     friend class SecretManager;
     friend class InteractionService;
     InteractionService *m_uiService;
     InteractionView *m_interactionView;
     QPointer<Sailfish::Secrets::SecretsDaemonConnection> m_secrets;
     QDBusInterface *m_interface;
+    QList<SentRequest> m_sentRequests;
+    int m_nextRequestTimeout;
+    quint64 m_pipelineId; // the pipeline which requests are tagged with, if any.
 };
 
 } // namespace Secrets
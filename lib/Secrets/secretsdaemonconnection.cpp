@@ -25,11 +25,14 @@
 #include <QtDBus/QDBusArgument>
 #include <QtDBus/QDBusMetaType>
 
+#include <QtCore/QMutexLocker>
+
 Q_LOGGING_CATEGORY(lcSailfishSecretsDaemonConnection, "org.sailfishos.secrets.daemon.connection", QtWarningMsg)
 
 Sailfish::Secrets::SecretsDaemonConnectionPrivate::SecretsDaemonConnectionPrivate(SecretsDaemonConnection *parent)
     : QObject(parent)
     , m_connection(QLatin1String("org.sailfishos.secrets.daemon.invalidConnection"))
+    , m_lastPipelineId(0)
     , m_parent(parent)
 {
 }
@@ -71,7 +74,10 @@ bool Sailfish::Secrets::SecretsDaemonConnectionPrivate::connect()
         return false;
     }
 
+    QMutexLocker locker(&m_sendMutex);
     m_connection = p2pc;
+    m_sentRequestCounts.clear();
+    locker.unlock();
     m_connection.connect(QString(), // any service
                          QLatin1String("/org/freedesktop/DBus/Local"),
                          QLatin1String("org.freedesktop.DBus.Local"),
@@ -156,6 +162,37 @@ QDBusInterface *Sailfish::Secrets::SecretsDaemonConnection::createInterface(cons
     return retn;
 }
 
+// The daemon numbers the method calls it receives for each object on each
+// connection, starting from one.  Calls are numbered here in the same way,
+// and numbering and sending a call is serialized, so that the \a sequence
+// returned is the number which the daemon assigns to the call.
+// A nonzero \a timeout and \a pipelineId are sent immediately before the
+// call, which the daemon does not number, so that they apply to the call
+// and no other.
+QDBusPendingCall Sailfish::Secrets::SecretsDaemonConnection::sendRequest(QDBusInterface *interface, const QString &method, const QVariantList &arguments, int timeout, quint64 pipelineId, quint64 *sequence)
+{
+    QMutexLocker locker(&m_data->m_sendMutex);
+    if (timeout > 0) {
+        interface->asyncCallWithArgumentList(QStringLiteral("setNextRequestTimeout"),
+                                             QVariantList() << QVariant::fromValue<int>(timeout));
+    }
+    if (pipelineId) {
+        interface->asyncCallWithArgumentList(QStringLiteral("setNextRequestPipeline"),
+                                             QVariantList() << QVariant::fromValue<quint64>(pipelineId));
+    }
+    *sequence = ++m_data->m_sentRequestCounts[interface->path()];
+    return interface->asyncCallWithArgumentList(method, arguments);
+}
+
+// Pipeline ids are allocated here rather than by each manager, as all of
+// the managers in the process share the connection, and the daemon tells
+// the pipelines on a connection apart by their ids alone.
+quint64 Sailfish::Secrets::SecretsDaemonConnection::allocatePipelineId()
+{
+    QMutexLocker locker(&m_data->m_sendMutex);
+    return ++m_data->m_lastPipelineId;
+}
+
 void Sailfish::Secrets::SecretsDaemonConnection::registerDBusTypes()
 {
     qRegisterMetaType<Sailfish::Secrets::SecretManager::UserInteractionMode>("Sailfish::Secrets::SecretManager::UserInteractionMode");
@@ -187,7 +224,9 @@ void Sailfish::Secrets::SecretsDaemonConnection::registerDBusTypes()
     qDBusRegisterMetaType<Sailfish::Secrets::PluginInfo>();
     qDBusRegisterMetaType<QVector<Sailfish::Secrets::PluginInfo> >();
     qDBusRegisterMetaType<Sailfish::Secrets::Result>();
+    qDBusRegisterMetaType<QVector<Sailfish::Secrets::Result> >();
     qDBusRegisterMetaType<Sailfish::Secrets::Secret>();
+    qDBusRegisterMetaType<QVector<Sailfish::Secrets::Secret> >();
     qDBusRegisterMetaType<Sailfish::Secrets::Secret::Identifier>();
     qDBusRegisterMetaType<QVector<Sailfish::Secrets::Secret::Identifier> >();
     qDBusRegisterMetaType<Sailfish::Secrets::Secret::FilterData>();
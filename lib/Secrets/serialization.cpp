@@ -26,7 +26,7 @@ namespace Secrets {
 QDBusArgument &operator<<(QDBusArgument &argument, const Result &result)
 {
     argument.beginStructure();
-    argument << static_cast<int>(result.code()) << result.errorCode() << result.errorMessage();
+    argument << static_cast<int>(result.code()) << result.errorCode() << result.errorMessage() << result.retryAfter();
     argument.endStructure();
     return argument;
 }
@@ -36,14 +36,16 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, Result &result)
     int code;
     int errorCode;
     QString message;
+    int retryAfter = 0;
 
     argument.beginStructure();
-    argument >> code >> errorCode >> message;
+    argument >> code >> errorCode >> message >> retryAfter;
     argument.endStructure();
 
     result.setCode(static_cast<Result::ResultCode>(code));
     result.setErrorCode(static_cast<Result::ErrorCode>(errorCode));
     result.setErrorMessage(message);
+    result.setRetryAfter(retryAfter);
     return argument;
 }
 
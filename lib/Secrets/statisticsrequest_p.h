@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHSECRETS_STATISTICSREQUEST_P_H
+#define LIBSAILFISHSECRETS_STATISTICSREQUEST_P_H
+
+#include "Secrets/secretsglobal.h"
+#include "Secrets/secretmanager.h"
+#include "Secrets/statisticsrequest.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QVariantMap>
+
+#include <QtDBus/QDBusPendingCallWatcher>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+class StatisticsRequestPrivate
+{
+    Q_DISABLE_COPY(StatisticsRequestPrivate)
+
+public:
+    explicit StatisticsRequestPrivate();
+
+    int m_timeout;
+    QScopedPointer<QDBusPendingCallWatcher> m_watcher;
+    Sailfish::Secrets::Request::Status m_status;
+    Sailfish::Secrets::Result m_result;
+
+    QPointer<Sailfish::Secrets::SecretManager> m_manager;
+    QVariantMap m_statistics;
+};
+
+} // namespace Secrets
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHSECRETS_STATISTICSREQUEST_P_H
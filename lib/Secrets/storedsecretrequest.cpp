@@ -19,6 +19,7 @@ using namespace Sailfish::Secrets;
 
 StoredSecretRequestPrivate::StoredSecretRequestPrivate()
     : m_userInteractionMode(SecretManager::PreventInteraction)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -155,6 +156,25 @@ Result StoredSecretRequest::result() const
     return d->m_result;
 }
 
+int StoredSecretRequest::timeout() const
+{
+    Q_D(const StoredSecretRequest);
+    return d->m_timeout;
+}
+
+void StoredSecretRequest::setTimeout(int timeout)
+{
+    Q_D(StoredSecretRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *StoredSecretRequest::manager() const
 {
     Q_D(const StoredSecretRequest);
@@ -181,6 +201,7 @@ void StoredSecretRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result, Secret> reply = d->m_manager->d_ptr->getSecret(
                                                         d->m_identifier,
                                                         d->m_userInteractionMode);
@@ -224,3 +245,20 @@ void StoredSecretRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void StoredSecretRequest::cancel()
+{
+    Q_D(StoredSecretRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -34,6 +34,7 @@ public:
     Sailfish::Secrets::SecretManager::UserInteractionMode m_userInteractionMode;
     Sailfish::Secrets::Secret m_secret;
 
+    int m_timeout;
     QScopedPointer<QDBusPendingCallWatcher> m_watcher;
     Sailfish::Secrets::Request::Status m_status;
     Sailfish::Secrets::Result m_result;
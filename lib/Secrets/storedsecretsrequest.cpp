@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "Secrets/storedsecretsrequest.h"
+#include "Secrets/storedsecretsrequest_p.h"
+
+#include "Secrets/secretmanager.h"
+#include "Secrets/secretmanager_p.h"
+#include "Secrets/serialization_p.h"
+
+#include <QtDBus/QDBusPendingReply>
+#include <QtDBus/QDBusPendingCallWatcher>
+
+using namespace Sailfish::Secrets;
+
+StoredSecretsRequestPrivate::StoredSecretsRequestPrivate()
+    : m_userInteractionMode(SecretManager::PreventInteraction)
+    , m_timeout(0)
+    , m_status(Request::Inactive)
+{
+}
+
+/*!
+ * \class StoredSecretsRequest
+ * \brief Allows a client request multiple secrets from the system's secure secret storage service
+ *
+ * This class allows clients to request the Secrets service to retrieve the secrets
+ * identified by the given identifiers() in a single request.  Each identifier must
+ * identify a collection-stored secret; standalone secrets must be retrieved via
+ * \l StoredSecretRequest instead.
+ *
+ * The secrets may be stored in different collections, and in different storage plugins.
+ * The Secrets service checks the calling application's access to each collection,
+ * and unlocks each collection, only once, and then instructs the storage plugin to
+ * retrieve all of the secrets requested from that collection at once.  The same
+ * access control and authentication flows as described for \l StoredSecretRequest
+ * may be triggered for each collection, subject to the given \a userInteractionMode.
+ *
+ * If any of the secrets cannot be retrieved, the request fails and no secrets are
+ * returned.  Otherwise, the secrets() are returned in the same order as the
+ * identifiers() which were specified.
+ *
+ * An example of retrieving some collection-stored secrets follows:
+ *
+ * \code
+ * Sailfish::Secrets::SecretManager sm;
+ * Sailfish::Secrets::StoredSecretsRequest ssr;
+ * ssr.setManager(&sm);
+ * ssr.setIdentifiers(QVector<Sailfish::Secrets::Secret::Identifier>()
+ *         << Sailfish::Secrets::Secret::Identifier("ExampleSecret", "ExampleCollection")
+ *         << Sailfish::Secrets::Secret::Identifier("OtherSecret", "ExampleCollection"));
+ * ssr.setUserInteractionMode(Sailfish::Secrets::SecretManager::SystemInteraction);
+ * ssr.startRequest(); // status() will change to Finished when complete
+ * \endcode
+ */
+
+/*!
+ * \brief Constructs a new StoredSecretsRequest object with the given \a parent.
+ */
+StoredSecretsRequest::StoredSecretsRequest(QObject *parent)
+    : Request(parent)
+    , d_ptr(new StoredSecretsRequestPrivate)
+{
+}
+
+/*!
+ * \brief Destroys the StoredSecretsRequest
+ */
+StoredSecretsRequest::~StoredSecretsRequest()
+{
+}
+
+/*!
+ * \brief Returns the identifiers of the secrets which the client wishes to retrieve
+ */
+QVector<Secret::Identifier> StoredSecretsRequest::identifiers() const
+{
+    Q_D(const StoredSecretsRequest);
+    return d->m_identifiers;
+}
+
+/*!
+ * \brief Sets the identifiers of the secrets which the client wishes to retrieve to \a idents
+ */
+void StoredSecretsRequest::setIdentifiers(const QVector<Secret::Identifier> &idents)
+{
+    Q_D(StoredSecretsRequest);
+    if (d->m_status != Request::Active && d->m_identifiers != idents) {
+        d->m_identifiers = idents;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit identifiersChanged();
+    }
+}
+
+/*!
+ * \brief Returns the secrets which were retrieved for the client, in the order of the identifiers()
+ */
+QVector<Secret> StoredSecretsRequest::secrets() const
+{
+    Q_D(const StoredSecretsRequest);
+    return d->m_secrets;
+}
+
+/*!
+ * \brief Returns the user interaction mode required when retrieving the secrets (e.g. if a custom lock code must be requested from the user)
+ */
+SecretManager::UserInteractionMode StoredSecretsRequest::userInteractionMode() const
+{
+    Q_D(const StoredSecretsRequest);
+    return d->m_userInteractionMode;
+}
+
+/*!
+ * \brief Sets the user interaction mode required when retrieving the secrets (e.g. if a custom lock code must be requested from the user) to \a mode
+ */
+void StoredSecretsRequest::setUserInteractionMode(SecretManager::UserInteractionMode mode)
+{
+    Q_D(StoredSecretsRequest);
+    if (d->m_status != Request::Active && d->m_userInteractionMode != mode) {
+        d->m_userInteractionMode = mode;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit userInteractionModeChanged();
+    }
+}
+
+Request::Status StoredSecretsRequest::status() const
+{
+    Q_D(const StoredSecretsRequest);
+    return d->m_status;
+}
+
+Result StoredSecretsRequest::result() const
+{
+    Q_D(const StoredSecretsRequest);
+    return d->m_result;
+}
+
+int StoredSecretsRequest::timeout() const
+{
+    Q_D(const StoredSecretsRequest);
+    return d->m_timeout;
+}
+
+void StoredSecretsRequest::setTimeout(int timeout)
+{
+    Q_D(StoredSecretsRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
+SecretManager *StoredSecretsRequest::manager() const
+{
+    Q_D(const StoredSecretsRequest);
+    return d->m_manager.data();
+}
+
+void StoredSecretsRequest::setManager(SecretManager *manager)
+{
+    Q_D(StoredSecretsRequest);
+    if (d->m_manager.data() != manager) {
+        d->m_manager = manager;
+        emit managerChanged();
+    }
+}
+
+void StoredSecretsRequest::startRequest()
+{
+    Q_D(StoredSecretsRequest);
+    if (d->m_status != Request::Active && !d->m_manager.isNull()) {
+        d->m_status = Request::Active;
+        emit statusChanged();
+        if (d->m_result.code() != Result::Pending) {
+            d->m_result = Result(Result::Pending);
+            emit resultChanged();
+        }
+
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
+        QDBusPendingReply<Result, QVector<Secret> > reply = d->m_manager->d_ptr->getSecrets(
+                                                        d->m_identifiers,
+                                                        d->m_userInteractionMode);
+        if (!reply.isValid() && !reply.error().message().isEmpty()) {
+            d->m_status = Request::Finished;
+            d->m_result = Result(Result::SecretManagerNotInitializedError,
+                                 reply.error().message());
+            emit statusChanged();
+            emit resultChanged();
+        } else if (reply.isFinished()
+                // work around a bug in QDBusAbstractInterface / QDBusConnection...
+                && reply.argumentAt<0>().code() != Sailfish::Secrets::Result::Succeeded) {
+            d->m_status = Request::Finished;
+            d->m_result = reply.argumentAt<0>();
+            d->m_secrets = reply.argumentAt<1>();
+            emit statusChanged();
+            emit resultChanged();
+            emit secretsChanged();
+        } else {
+            d->m_watcher.reset(new QDBusPendingCallWatcher(reply));
+            connect(d->m_watcher.data(), &QDBusPendingCallWatcher::finished,
+                    [this] {
+                QDBusPendingCallWatcher *watcher = this->d_ptr->m_watcher.take();
+                QDBusPendingReply<Result, QVector<Secret> > reply = *watcher;
+                this->d_ptr->m_status = Request::Finished;
+                this->d_ptr->m_result = reply.argumentAt<0>();
+                this->d_ptr->m_secrets = reply.argumentAt<1>();
+                watcher->deleteLater();
+                emit this->statusChanged();
+                emit this->resultChanged();
+                emit this->secretsChanged();
+            });
+        }
+    }
+}
+
+void StoredSecretsRequest::waitForFinished()
+{
+    Q_D(StoredSecretsRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        d->m_watcher->waitForFinished();
+    }
+}
+
+void StoredSecretsRequest::cancel()
+{
+    Q_D(StoredSecretsRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
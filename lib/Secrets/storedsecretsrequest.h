@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHSECRETS_STOREDSECRETSREQUEST_H
+#define LIBSAILFISHSECRETS_STOREDSECRETSREQUEST_H
+
+#include "Secrets/secretsglobal.h"
+#include "Secrets/request.h"
+#include "Secrets/secret.h"
+#include "Secrets/secretmanager.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+class StoredSecretsRequestPrivate;
+class SAILFISH_SECRETS_API StoredSecretsRequest : public Sailfish::Secrets::Request
+{
+    Q_OBJECT
+    Q_PROPERTY(QVector<Sailfish::Secrets::Secret::Identifier> identifiers READ identifiers WRITE setIdentifiers NOTIFY identifiersChanged)
+    Q_PROPERTY(Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode READ userInteractionMode WRITE setUserInteractionMode NOTIFY userInteractionModeChanged)
+    Q_PROPERTY(QVector<Sailfish::Secrets::Secret> secrets READ secrets NOTIFY secretsChanged)
+
+public:
+    StoredSecretsRequest(QObject *parent = Q_NULLPTR);
+    ~StoredSecretsRequest();
+
+    QVector<Sailfish::Secrets::Secret::Identifier> identifiers() const;
+    void setIdentifiers(const QVector<Sailfish::Secrets::Secret::Identifier> &idents);
+
+    Sailfish::Secrets::SecretManager::UserInteractionMode userInteractionMode() const;
+    void setUserInteractionMode(Sailfish::Secrets::SecretManager::UserInteractionMode mode);
+
+    QVector<Sailfish::Secrets::Secret> secrets() const;
+
+    Sailfish::Secrets::Request::Status status() const Q_DECL_OVERRIDE;
+    Sailfish::Secrets::Result result() const Q_DECL_OVERRIDE;
+
+    int timeout() const Q_DECL_OVERRIDE;
+    void setTimeout(int timeout) Q_DECL_OVERRIDE;
+
+    Sailfish::Secrets::SecretManager *manager() const Q_DECL_OVERRIDE;
+    void setManager(Sailfish::Secrets::SecretManager *manager) Q_DECL_OVERRIDE;
+
+    void startRequest() Q_DECL_OVERRIDE;
+    void waitForFinished() Q_DECL_OVERRIDE;
+    void cancel() Q_DECL_OVERRIDE;
+
+Q_SIGNALS:
+    void identifiersChanged();
+    void userInteractionModeChanged();
+    void secretsChanged();
+
+private:
+    QScopedPointer<StoredSecretsRequestPrivate> const d_ptr;
+    Q_DECLARE_PRIVATE(StoredSecretsRequest)
+};
+
+} // namespace Secrets
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHSECRETS_STOREDSECRETSREQUEST_H
@@ -23,6 +23,7 @@ StoreSecretRequestPrivate::StoreSecretRequestPrivate()
     , m_customLockUnlockSemantic(SecretManager::CustomLockKeepUnlocked)
     , m_accessControlMode(SecretManager::OwnerOnlyMode)
     , m_userInteractionMode(SecretManager::PreventInteraction)
+    , m_timeout(0)
     , m_status(Request::Inactive)
 {
 }
@@ -471,6 +472,25 @@ Result StoreSecretRequest::result() const
     return d->m_result;
 }
 
+int StoreSecretRequest::timeout() const
+{
+    Q_D(const StoreSecretRequest);
+    return d->m_timeout;
+}
+
+void StoreSecretRequest::setTimeout(int timeout)
+{
+    Q_D(StoreSecretRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
 SecretManager *StoreSecretRequest::manager() const
 {
     Q_D(const StoreSecretRequest);
@@ -497,6 +517,7 @@ void StoreSecretRequest::startRequest()
             emit resultChanged();
         }
 
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
         QDBusPendingReply<Result> reply;
         if (d->m_secretStorageType == StoreSecretRequest::CollectionSecret) {
             reply = d->m_manager->d_ptr->setSecret(d->m_secret,
@@ -555,3 +576,20 @@ void StoreSecretRequest::waitForFinished()
         d->m_watcher->waitForFinished();
     }
 }
+
+void StoreSecretRequest::cancel()
+{
+    Q_D(StoreSecretRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include "Secrets/storesecretsrequest.h"
+#include "Secrets/storesecretsrequest_p.h"
+
+#include "Secrets/secretmanager.h"
+#include "Secrets/secretmanager_p.h"
+#include "Secrets/serialization_p.h"
+
+#include <QtDBus/QDBusPendingReply>
+#include <QtDBus/QDBusPendingCallWatcher>
+
+using namespace Sailfish::Secrets;
+
+StoreSecretsRequestPrivate::StoreSecretsRequestPrivate()
+    : m_userInteractionMode(SecretManager::PreventInteraction)
+    , m_timeout(0)
+    , m_status(Request::Inactive)
+{
+}
+
+/*!
+ * \class StoreSecretsRequest
+ * \brief Allows a client request that multiple secrets be stored by the system's secure secret storage service
+ *
+ * This class allows clients to request the Secrets service to store the
+ * given secrets() into a collection in a single request, for example when
+ * importing many secrets from a backup.  Every secret must be identified
+ * by a collection secret identifier, and all of the secrets must be stored
+ * in the same collection of the same storage plugin.  Standalone secrets
+ * must be stored via \l StoreSecretRequest instead.
+ *
+ * The Secrets service checks the calling application's access to the
+ * collection, and unlocks it, only once.  The same access control and
+ * authentication flows as described for \l StoreSecretRequest may be
+ * triggered, subject to the given \a userInteractionMode.  Secret data
+ * cannot be requested from the user; the data of each secret must be set.
+ *
+ * The secrets are stored all together or not at all: none of the secrets
+ * will already exist in the collection, and if any of them cannot be stored,
+ * the request fails and none of them are stored.
+ *
+ * If the request fails because of particular secrets (for example, because
+ * a secret with the same name already exists in the collection), the
+ * results() will contain a result for each of the secrets, in the order in
+ * which they were given.  The result of each secret which caused the request
+ * to fail will describe the error, and the result of every other secret will
+ * be \c{Result::Succeeded} even though it was not stored.  If the request
+ * fails for any other reason (for example, because the collection could
+ * not be unlocked) the results() will be empty.  If the request succeeds,
+ * the result of every secret will be \c{Result::Succeeded}.
+ *
+ * An example of storing some secrets into a collection follows:
+ *
+ * \code
+ * Sailfish::Secrets::SecretManager sm;
+ * Sailfish::Secrets::Secret first(Sailfish::Secrets::Secret::Identifier(
+ *         "ExampleSecret", "ExampleCollection",
+ *         Sailfish::Secrets::SecretManager::DefaultEncryptedStoragePluginName));
+ * first.setData("Some secret data");
+ * Sailfish::Secrets::Secret second(Sailfish::Secrets::Secret::Identifier(
+ *         "OtherSecret", "ExampleCollection",
+ *         Sailfish::Secrets::SecretManager::DefaultEncryptedStoragePluginName));
+ * second.setData("Some other secret data");
+ * Sailfish::Secrets::StoreSecretsRequest ssr;
+ * ssr.setManager(&sm);
+ * ssr.setSecrets(QVector<Sailfish::Secrets::Secret>() << first << second);
+ * ssr.setUserInteractionMode(Sailfish::Secrets::SecretManager::SystemInteraction);
+ * ssr.startRequest(); // status() will change to Finished when complete
+ * \endcode
+ */
+
+/*!
+ * \brief Constructs a new StoreSecretsRequest object with the given \a parent.
+ */
+StoreSecretsRequest::StoreSecretsRequest(QObject *parent)
+    : Request(parent)
+    , d_ptr(new StoreSecretsRequestPrivate)
+{
+}
+
+/*!
+ * \brief Destroys the StoreSecretsRequest
+ */
+StoreSecretsRequest::~StoreSecretsRequest()
+{
+}
+
+/*!
+ * \brief Returns the secrets which the client wishes to store
+ */
+QVector<Secret> StoreSecretsRequest::secrets() const
+{
+    Q_D(const StoreSecretsRequest);
+    return d->m_secrets;
+}
+
+/*!
+ * \brief Sets the secrets which the client wishes to store to \a secrets
+ *
+ * All of the secrets must be stored in the same collection.
+ */
+void StoreSecretsRequest::setSecrets(const QVector<Secret> &secrets)
+{
+    Q_D(StoreSecretsRequest);
+    if (d->m_status != Request::Active && d->m_secrets != secrets) {
+        d->m_secrets = secrets;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit secretsChanged();
+    }
+}
+
+/*!
+ * \brief Returns the user interaction mode required when storing the secrets (e.g. if a custom lock code must be requested from the user)
+ */
+SecretManager::UserInteractionMode StoreSecretsRequest::userInteractionMode() const
+{
+    Q_D(const StoreSecretsRequest);
+    return d->m_userInteractionMode;
+}
+
+/*!
+ * \brief Sets the user interaction mode required when storing the secrets (e.g. if a custom lock code must be requested from the user) to \a mode
+ */
+void StoreSecretsRequest::setUserInteractionMode(SecretManager::UserInteractionMode mode)
+{
+    Q_D(StoreSecretsRequest);
+    if (d->m_status != Request::Active && d->m_userInteractionMode != mode) {
+        d->m_userInteractionMode = mode;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit userInteractionModeChanged();
+    }
+}
+
+/*!
+ * \brief Returns the result for each of the secrets(), in the same order
+ *
+ * See the class documentation for the cases in which these are reported.
+ */
+QVector<Result> StoreSecretsRequest::results() const
+{
+    Q_D(const StoreSecretsRequest);
+    return d->m_results;
+}
+
+Request::Status StoreSecretsRequest::status() const
+{
+    Q_D(const StoreSecretsRequest);
+    return d->m_status;
+}
+
+Result StoreSecretsRequest::result() const
+{
+    Q_D(const StoreSecretsRequest);
+    return d->m_result;
+}
+
+int StoreSecretsRequest::timeout() const
+{
+    Q_D(const StoreSecretsRequest);
+    return d->m_timeout;
+}
+
+void StoreSecretsRequest::setTimeout(int timeout)
+{
+    Q_D(StoreSecretsRequest);
+    if (d->m_status != Request::Active && d->m_timeout != timeout) {
+        d->m_timeout = timeout;
+        if (d->m_status == Request::Finished) {
+            d->m_status = Request::Inactive;
+            emit statusChanged();
+        }
+        emit timeoutChanged();
+    }
+}
+
+SecretManager *StoreSecretsRequest::manager() const
+{
+    Q_D(const StoreSecretsRequest);
+    return d->m_manager.data();
+}
+
+void StoreSecretsRequest::setManager(SecretManager *manager)
+{
+    Q_D(StoreSecretsRequest);
+    if (d->m_manager.data() != manager) {
+        d->m_manager = manager;
+        emit managerChanged();
+    }
+}
+
+void StoreSecretsRequest::startRequest()
+{
+    Q_D(StoreSecretsRequest);
+    if (d->m_status != Request::Active && !d->m_manager.isNull()) {
+        d->m_status = Request::Active;
+        emit statusChanged();
+        if (d->m_result.code() != Result::Pending) {
+            d->m_result = Result(Result::Pending);
+            emit resultChanged();
+        }
+
+        d->m_manager->d_ptr->setNextRequestTimeout(d->m_timeout);
+        QDBusPendingReply<Result, QVector<Result> > reply = d->m_manager->d_ptr->setSecrets(
+                                                        d->m_secrets,
+                                                        d->m_userInteractionMode);
+        if (!reply.isValid() && !reply.error().message().isEmpty()) {
+            d->m_status = Request::Finished;
+            d->m_result = Result(Result::SecretManagerNotInitializedError,
+                                 reply.error().message());
+            emit statusChanged();
+            emit resultChanged();
+        } else if (reply.isFinished()
+                // work around a bug in QDBusAbstractInterface / QDBusConnection...
+                && reply.argumentAt<0>().code() != Sailfish::Secrets::Result::Succeeded) {
+            d->m_status = Request::Finished;
+            d->m_result = reply.argumentAt<0>();
+            d->m_results = reply.argumentAt<1>();
+            emit statusChanged();
+            emit resultChanged();
+            emit resultsChanged();
+        } else {
+            d->m_watcher.reset(new QDBusPendingCallWatcher(reply));
+            connect(d->m_watcher.data(), &QDBusPendingCallWatcher::finished,
+                    [this] {
+                QDBusPendingCallWatcher *watcher = this->d_ptr->m_watcher.take();
+                QDBusPendingReply<Result, QVector<Result> > reply = *watcher;
+                this->d_ptr->m_status = Request::Finished;
+                this->d_ptr->m_result = reply.argumentAt<0>();
+                this->d_ptr->m_results = reply.argumentAt<1>();
+                watcher->deleteLater();
+                emit this->statusChanged();
+                emit this->resultChanged();
+                emit this->resultsChanged();
+            });
+        }
+    }
+}
+
+void StoreSecretsRequest::waitForFinished()
+{
+    Q_D(StoreSecretsRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        d->m_watcher->waitForFinished();
+    }
+}
+
+void StoreSecretsRequest::cancel()
+{
+    Q_D(StoreSecretsRequest);
+    if (d->m_status == Request::Active && !d->m_watcher.isNull()) {
+        if (!d->m_manager.isNull()) {
+            d->m_manager->d_ptr->cancelRequest(*d->m_watcher);
+        }
+        // destroying the watcher ensures that a late reply is ignored.
+        d->m_watcher.reset();
+        d->m_status = Request::Finished;
+        d->m_result = Result(Result::OperationCanceledError,
+                             QStringLiteral("The request was canceled"));
+        emit statusChanged();
+        emit resultChanged();
+    }
+}
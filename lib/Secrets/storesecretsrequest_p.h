@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#ifndef LIBSAILFISHSECRETS_STORESECRETSREQUEST_P_H
+#define LIBSAILFISHSECRETS_STORESECRETSREQUEST_P_H
+
+#include "Secrets/secretsglobal.h"
+#include "Secrets/secretmanager.h"
+#include "Secrets/secret.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <QtDBus/QDBusPendingCallWatcher>
+
+namespace Sailfish {
+
+namespace Secrets {
+
+class StoreSecretsRequestPrivate
+{
+    Q_DISABLE_COPY(StoreSecretsRequestPrivate)
+
+public:
+    explicit StoreSecretsRequestPrivate();
+
+    QPointer<Sailfish::Secrets::SecretManager> m_manager;
+    QVector<Sailfish::Secrets::Secret> m_secrets;
+    Sailfish::Secrets::SecretManager::UserInteractionMode m_userInteractionMode;
+    QVector<Sailfish::Secrets::Result> m_results;
+
+    int m_timeout;
+    QScopedPointer<QDBusPendingCallWatcher> m_watcher;
+    Sailfish::Secrets::Request::Status m_status;
+    Sailfish::Secrets::Result m_result;
+};
+
+} // namespace Secrets
+
+} // namespace Sailfish
+
+#endif // LIBSAILFISHSECRETS_STORESECRETSREQUEST_P_H
@@ -12,9 +12,12 @@
 #include <openssl/crypto.h>
 
 #include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QVector>
 #include <QtCore/QThread>
 #include <QtCore/QHash>
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
 
 #define OSSLEVP_PRINT_ERR(message) \
     fprintf(stderr, "%s#%d, %s: %s\n", __FILE__, __LINE__, __FUNCTION__, message);
@@ -125,6 +128,9 @@ int OpenSslEvp::init()
  */
 void OpenSslEvp::cleanup()
 {
+    // the cached keys are freed while OpenSSL is still usable.
+    pkey_cache_clear();
+
     // s_mutexes will be deleted when coming out of scope,
     // see https://stackoverflow.com/questions/2204608/does-c-call-destructors-for-global-and-class-static-variables
 }
@@ -1317,3 +1323,157 @@ bool OpenSslEvp::key_is_rsa(EVP_PKEY *pkey)
     return pkey->type == EVP_PKEY_RSA;
 #endif
 }
+
+// Parsed public keys, keyed by the SHA-256 digest of their PEM data.
+// Private keys are never cached: the cache is shared by every plugin built
+// with this file, and a decoded private key must not outlive the lock of
+// the collection or plugin it was read from.
+// The cache holds one reference to each key, and the least recently used
+// key is released when the cache is full.  The keys are not freed by the
+// destructor, as OpenSSL may already have been cleaned up by then; instead
+// OpenSslEvp::cleanup() clears the cache.
+struct PkeyCache
+{
+    PkeyCache() : capacity(16) {}
+    QMutex mutex;
+    QHash<QByteArray, EVP_PKEY*> keys;
+    QList<QByteArray> recentlyUsed; // least recently used first.
+    int capacity;
+};
+static PkeyCache s_pkeyCache;
+
+static void pkey_up_ref(EVP_PKEY *pkey)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    EVP_PKEY_up_ref(pkey);
+#else
+    CRYPTO_add(&pkey->references, 1, CRYPTO_LOCK_EVP_PKEY);
+#endif
+}
+
+// Must be called with the cache mutex held.
+static void pkey_cache_trim(int capacity)
+{
+    while (s_pkeyCache.keys.size() > capacity && !s_pkeyCache.recentlyUsed.isEmpty()) {
+        EVP_PKEY_free(s_pkeyCache.keys.take(s_pkeyCache.recentlyUsed.takeFirst()));
+    }
+}
+
+/*
+    EVP_PKEY *OpenSslEvp::pkey_cache_read(const char *keyData,
+                                          int keyDataLength,
+                                          int privateKey)
+
+    Reads a PEM encoded private or public key into an EVP_PKEY.
+    A public key reuses the EVP_PKEY which was previously read from
+    the same key data if it is still cached.  This avoids decoding
+    the same key on every operation which uses it.  Only a digest of
+    the key data is retained, and a key is freed once it is released
+    by the cache and by every caller which uses it.  A private key is
+    decoded on every call and is never cached, so that it is freed
+    (and its private components cleared by OpenSSL) as soon as the
+    caller releases it.  The cache may be used concurrently from
+    multiple threads.
+
+    Arguments:
+    * keyData: the PEM encoded key data
+    * keyDataLength: the byte count of the key data
+    * privateKey: 1 if the key data contains a private key, 0 for a public key
+
+    Return value:
+    * the key, which the caller must release with EVP_PKEY_free
+    * NULL if the key data could not be read
+ */
+EVP_PKEY *OpenSslEvp::pkey_cache_read(const char *keyData,
+                                      int keyDataLength,
+                                      int privateKey)
+{
+    if (keyData == NULL || keyDataLength <= 0) {
+        return NULL;
+    }
+
+    if (privateKey) {
+        BIO *bio = BIO_new_mem_buf(const_cast<char *>(keyData), keyDataLength);
+        if (bio == NULL) {
+            return NULL;
+        }
+        EVP_PKEY *pkey = PEM_read_bio_PrivateKey(bio, NULL, NULL, NULL);
+        BIO_free(bio);
+        return pkey;
+    }
+
+    unsigned char keyDigest[EVP_MAX_MD_SIZE];
+    unsigned int keyDigestLength = 0;
+    if (EVP_Digest(keyData, keyDataLength, keyDigest, &keyDigestLength, EVP_sha256(), NULL) != 1) {
+        return NULL;
+    }
+    const QByteArray cacheKey(reinterpret_cast<const char*>(keyDigest), keyDigestLength);
+
+    {
+        QMutexLocker locker(&s_pkeyCache.mutex);
+        EVP_PKEY *cached = s_pkeyCache.keys.value(cacheKey);
+        if (cached != NULL) {
+            s_pkeyCache.recentlyUsed.removeOne(cacheKey);
+            s_pkeyCache.recentlyUsed.append(cacheKey);
+            pkey_up_ref(cached);
+            return cached;
+        }
+    }
+
+    // Decode the key without holding the lock, so that other keys
+    // can be used meanwhile.
+    BIO *bio = BIO_new_mem_buf(const_cast<char *>(keyData), keyDataLength);
+    if (bio == NULL) {
+        return NULL;
+    }
+    EVP_PKEY *pkey = PEM_read_bio_PUBKEY(bio, NULL, NULL, NULL);
+    BIO_free(bio);
+    if (pkey == NULL) {
+        return NULL;
+    }
+
+    QMutexLocker locker(&s_pkeyCache.mutex);
+    if (s_pkeyCache.capacity > 0 && !s_pkeyCache.keys.contains(cacheKey)) {
+        pkey_cache_trim(s_pkeyCache.capacity - 1);
+        pkey_up_ref(pkey);
+        s_pkeyCache.keys.insert(cacheKey, pkey);
+        s_pkeyCache.recentlyUsed.append(cacheKey);
+    }
+    return pkey;
+}
+
+/*
+    void OpenSslEvp::pkey_cache_set_capacity(int capacity)
+
+    Sets the maximum number of keys held by the key cache,
+    releasing the least recently used keys if necessary.
+    A capacity of zero disables the cache.
+ */
+void OpenSslEvp::pkey_cache_set_capacity(int capacity)
+{
+    QMutexLocker locker(&s_pkeyCache.mutex);
+    s_pkeyCache.capacity = capacity > 0 ? capacity : 0;
+    pkey_cache_trim(s_pkeyCache.capacity);
+}
+
+/*
+    int OpenSslEvp::pkey_cache_count()
+
+    Returns the number of keys held by the key cache.
+ */
+int OpenSslEvp::pkey_cache_count()
+{
+    QMutexLocker locker(&s_pkeyCache.mutex);
+    return s_pkeyCache.keys.size();
+}
+
+/*
+    void OpenSslEvp::pkey_cache_clear()
+
+    Releases every key held by the key cache.
+ */
+void OpenSslEvp::pkey_cache_clear()
+{
+    QMutexLocker locker(&s_pkeyCache.mutex);
+    pkey_cache_trim(0);
+}
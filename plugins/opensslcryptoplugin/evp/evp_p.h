@@ -139,6 +139,16 @@ int generate_ec_key(int curveNid,
 
 bool key_is_rsa(EVP_PKEY *pkey);
 
+EVP_PKEY *pkey_cache_read(const char *keyData,
+                          int keyDataLength,
+                          int privateKey);
+
+void pkey_cache_set_capacity(int capacity);
+
+int pkey_cache_count();
+
+void pkey_cache_clear();
+
 } // OpenSslEvp
 
 #endif // SAILFISHCRYPTO_PLUGIN_CRYPTO_OPENSSL_EVP_P_H
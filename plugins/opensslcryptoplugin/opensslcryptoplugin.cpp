@@ -746,6 +746,95 @@ Daemon::Plugins::OpenSslCryptoPlugin::verify(
     }
 }
 
+Sailfish::Crypto::Result
+Daemon::Plugins::OpenSslCryptoPlugin::verifyBatch(
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Sailfish::Crypto::Key> &keys,
+        Sailfish::Crypto::CryptoManager::SignaturePadding padding,
+        Sailfish::Crypto::CryptoManager::DigestFunction digestFunction,
+        const QVariantMap & /* customParameters */,
+        QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses)
+{
+    if (verificationStatuses == Q_NULLPTR) {
+        return Sailfish::Crypto::Result(Sailfish::Crypto::Result::CryptoPluginVerificationError,
+                                        QLatin1String("Given output argument 'verificationStatuses' was nullptr."));
+    }
+
+    if (data.size() != signatures.size() || keys.size() != signatures.size()) {
+        return Sailfish::Crypto::Result(Sailfish::Crypto::Result::CryptoPluginVerificationError,
+                                        QLatin1String("Each signature must be given with its data and key."));
+    }
+
+    if (padding != Sailfish::Crypto::CryptoManager::SignaturePaddingNone) {
+        return Sailfish::Crypto::Result(Sailfish::Crypto::Result::OperationNotSupportedError,
+                                        QLatin1String("TODO: signature padding other than None"));
+    }
+
+    // Get the EVP digest function
+    const EVP_MD *evpDigestFunc = getEvpDigestFunction(digestFunction);
+    if (!evpDigestFunc) {
+        return Sailfish::Crypto::Result(Sailfish::Crypto::Result::DigestNotSupportedError,
+                                        QLatin1String("Unsupported digest function chosen."));
+    }
+
+    // Many of the signatures will usually have been made with the same key,
+    // so read the public key data of each distinct key into an EVP_PKEY only once.
+    QMap<QByteArray, EVP_PKEY*> pkeys;
+    Sailfish::Crypto::Result result(Sailfish::Crypto::Result::Succeeded);
+    QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> statuses;
+    statuses.reserve(signatures.size());
+    for (int i = 0; i < signatures.size(); ++i) {
+        const QByteArray &signature(signatures.at(i));
+        const QByteArray &publicKey(keys.at(i).publicKey());
+        if (signature.length() == 0) {
+            result = Sailfish::Crypto::Result(Sailfish::Crypto::Result::EmptySignatureError,
+                                              QLatin1String("Can't verify without signature."));
+            break;
+        }
+
+        if (publicKey.length() == 0) {
+            result = Sailfish::Crypto::Result(Sailfish::Crypto::Result::EmptyPublicKeyError,
+                                              QLatin1String("Can't verify without public key."));
+            break;
+        }
+
+        EVP_PKEY *pkey = pkeys.value(publicKey);
+        if (pkey == Q_NULLPTR) {
+            pkey = readEvpPubKey(publicKey);
+            if (pkey == Q_NULLPTR) {
+                result = Sailfish::Crypto::Result(Sailfish::Crypto::Result::CryptoPluginVerificationError,
+                                                  QLatin1String("Failed to read public key from PEM format."));
+                break;
+            }
+            pkeys.insert(publicKey, pkey);
+        }
+
+        // Verify the signature
+        const QByteArray &item(data.at(i));
+        int r = OpenSslEvp::verify(evpDigestFunc, pkey, item.data(), item.length(), (const uint8_t*) signature.data(), (size_t) signature.length());
+        if (r == 1) {
+            // Verification performed without error, signature matched.
+            statuses.append(Sailfish::Crypto::CryptoManager::VerificationSucceeded);
+        } else {
+            // Either the signature didn't match, or it could not be
+            // verified at all (e.g. a malformed DER encoded signature).
+            // The signatures are untrusted input, so one bad signature
+            // must not invalidate the results of the rest of the batch.
+            statuses.append(Sailfish::Crypto::CryptoManager::VerificationFailed);
+        }
+    }
+
+    for (EVP_PKEY *pkey : pkeys) {
+        EVP_PKEY_free(pkey);
+    }
+
+    if (result.code() == Sailfish::Crypto::Result::Succeeded) {
+        *verificationStatuses = statuses;
+    }
+    return result;
+}
+
 Sailfish::Crypto::Result
 Daemon::Plugins::OpenSslCryptoPlugin::encrypt(
         const QByteArray &data,
@@ -810,34 +899,22 @@ Daemon::Plugins::OpenSslCryptoPlugin::encryptAsymmetric(
                                         QLatin1String("The given padding type is not supported for the given algorithm."));
     }
 
-    QScopedPointer<BIO, LibCrypto_BIO_Deleter> bio(BIO_new(BIO_s_mem()));
-
-    // Use BIO to write public key data
-    int r = BIO_write(bio.data(), key.publicKey().data(), key.publicKey().length());
-    if (r == 0 || r != key.publicKey().length()) {
-        return Sailfish::Crypto::Result(Sailfish::Crypto::Result::CryptoPluginEncryptionError,
-                                        QLatin1String("Failed to read public key data."));
-    }
-
     // Read the public key data into an EVP_PKEY, which SHOULD handle different formats transparently.
-    EVP_PKEY *pkeyPtr = Q_NULLPTR;
-    PEM_read_bio_PUBKEY(bio.data(), &pkeyPtr, Q_NULLPTR, Q_NULLPTR);
-    if (pkeyPtr == Q_NULLPTR) {
+    QScopedPointer<EVP_PKEY, LibCrypto_EVP_PKEY_Deleter> pkey(readEvpPubKey(key.publicKey()));
+    if (pkey.data() == Q_NULLPTR) {
         return Sailfish::Crypto::Result(Sailfish::Crypto::Result::CryptoPluginEncryptionError,
                                         QLatin1String("Failed to read public key from PEM format."));
     }
 
-    QScopedPointer<EVP_PKEY, LibCrypto_EVP_PKEY_Deleter> pkey(pkeyPtr);
-
     uint8_t *encryptedBytes = Q_NULLPTR;
     size_t encryptedBytesLength = 0;
 
-    r = OpenSslEvp::pkey_encrypt_plaintext(pkeyPtr,
-                                       opensslPadding,
-                                       reinterpret_cast<const uint8_t*>(data.data()),
-                                       data.length(),
-                                       &encryptedBytes,
-                                       &encryptedBytesLength);
+    int r = OpenSslEvp::pkey_encrypt_plaintext(pkey.data(),
+                                               opensslPadding,
+                                               reinterpret_cast<const uint8_t*>(data.data()),
+                                               data.length(),
+                                               &encryptedBytes,
+                                               &encryptedBytesLength);
 
     if (r != 1) {
         return Sailfish::Crypto::Result(Sailfish::Crypto::Result::CryptoPluginEncryptionError,
@@ -998,34 +1075,22 @@ Daemon::Plugins::OpenSslCryptoPlugin::decryptAsymmetric(
                                         QLatin1String("The given padding type is not supported for the given algorithm."));
     }
 
-    QScopedPointer<BIO, LibCrypto_BIO_Deleter> bio(BIO_new(BIO_s_mem()));
-
-    // Use BIO to write private key data
-    int r = BIO_write(bio.data(), key.privateKey().data(), key.privateKey().length());
-    if (r == 0 || r != key.privateKey().length()) {
-        return Sailfish::Crypto::Result(Sailfish::Crypto::Result::CryptoPluginDecryptionError,
-                                        QLatin1String("Failed to read private key data."));
-    }
-
     // Read the private key data into an EVP_PKEY, which SHOULD handle different formats transparently.
-    EVP_PKEY *pkeyPtr = Q_NULLPTR;
-    PEM_read_bio_PrivateKey(bio.data(), &pkeyPtr, Q_NULLPTR, Q_NULLPTR);
-    if (pkeyPtr == Q_NULLPTR) {
+    QScopedPointer<EVP_PKEY, LibCrypto_EVP_PKEY_Deleter> pkey(readEvpPrivKey(key.privateKey()));
+    if (pkey.data() == Q_NULLPTR) {
         return Sailfish::Crypto::Result(Sailfish::Crypto::Result::CryptoPluginDecryptionError,
                                         QLatin1String("Failed to read private key from PEM format."));
     }
 
-    QScopedPointer<EVP_PKEY, LibCrypto_EVP_PKEY_Deleter> pkey(pkeyPtr);
-
     uint8_t *decryptedBytes = Q_NULLPTR;
     size_t decryptedBytesLength = 0;
 
-    r = OpenSslEvp::pkey_decrypt_ciphertext(pkeyPtr,
-                                        opensslPadding,
-                                        reinterpret_cast<const uint8_t*>(data.data()),
-                                        data.length(),
-                                        &decryptedBytes,
-                                        &decryptedBytesLength);
+    int r = OpenSslEvp::pkey_decrypt_ciphertext(pkey.data(),
+                                                opensslPadding,
+                                                reinterpret_cast<const uint8_t*>(data.data()),
+                                                data.length(),
+                                                &decryptedBytes,
+                                                &decryptedBytesLength);
 
     if (r != 1) {
         return Sailfish::Crypto::Result(Sailfish::Crypto::Result::CryptoPluginEncryptionError,
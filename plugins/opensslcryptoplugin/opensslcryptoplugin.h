@@ -14,6 +14,7 @@
 #include <QByteArray>
 #include <QCryptographicHash>
 #include <QMap>
+#include <QThread>
 
 // When building the actual plugin, export it.
 // When just compiling into another plugin, don't.
@@ -59,6 +60,9 @@ public:
     int version() const Q_DECL_OVERRIDE {
         return 1;
     }
+    int maxConcurrency() const Q_DECL_OVERRIDE {
+        return QThread::idealThreadCount();
+    }
 
     bool canStoreKeys() const Q_DECL_OVERRIDE { return false; }
     Sailfish::Crypto::CryptoPlugin::EncryptionType encryptionType() const Q_DECL_OVERRIDE { return Sailfish::Crypto::CryptoPlugin::SoftwareEncryption; }
@@ -146,6 +150,15 @@ public:
             const QVariantMap &customParameters,
             Sailfish::Crypto::CryptoManager::VerificationStatus *verificationStatus) Q_DECL_OVERRIDE;
 
+    Sailfish::Crypto::Result verifyBatch(
+            const QVector<QByteArray> &signatures,
+            const QVector<QByteArray> &data,
+            const QVector<Sailfish::Crypto::Key> &keys,
+            Sailfish::Crypto::CryptoManager::SignaturePadding padding,
+            Sailfish::Crypto::CryptoManager::DigestFunction digestFunction,
+            const QVariantMap &customParameters,
+            QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses) Q_DECL_OVERRIDE;
+
     Sailfish::Crypto::Result encrypt(
             const QByteArray &data,
             const QByteArray &iv,
@@ -429,6 +429,84 @@ Sailfish::Secrets::Daemon::Plugins::SqlCipherPlugin::decrypt(
     return m_opensslCryptoPlugin.decrypt(data, iv, fullKey, blockMode, padding, authenticationData, authenticationTag, customParameters, decrypted, verificationStatus);
 }
 
+Sailfish::Crypto::Result
+Sailfish::Secrets::Daemon::Plugins::SqlCipherPlugin::verifyBatch(
+        const QVector<QByteArray> &signatures,
+        const QVector<QByteArray> &data,
+        const QVector<Sailfish::Crypto::Key> &keys,
+        Sailfish::Crypto::CryptoManager::SignaturePadding padding,
+        Sailfish::Crypto::CryptoManager::DigestFunction digestFunction,
+        const QVariantMap &customParameters,
+        QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses)
+{
+    // read each distinct stored key once, rather than once per element.
+    QMap<Sailfish::Crypto::Key::Identifier, Sailfish::Crypto::Key> storedKeys;
+    QVector<Sailfish::Crypto::Key> fullKeys;
+    fullKeys.reserve(keys.size());
+    for (const Sailfish::Crypto::Key &key : keys) {
+        if (!key.publicKey().isEmpty()) {
+            fullKeys.append(key);
+        } else if (storedKeys.contains(key.identifier())) {
+            fullKeys.append(storedKeys.value(key.identifier()));
+        } else {
+            Sailfish::Crypto::Key fullKey;
+            Sailfish::Crypto::Result keyResult = getFullKey(key, &fullKey);
+            if (keyResult.code() != Sailfish::Crypto::Result::Succeeded) {
+                return keyResult;
+            }
+            storedKeys.insert(key.identifier(), fullKey);
+            fullKeys.append(fullKey);
+        }
+    }
+
+    return m_opensslCryptoPlugin.verifyBatch(signatures, data, fullKeys, padding, digestFunction, customParameters, verificationStatuses);
+}
+
+Sailfish::Crypto::Result
+Sailfish::Secrets::Daemon::Plugins::SqlCipherPlugin::encryptBatch(
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Sailfish::Crypto::Key &key,
+        Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+        Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVariantMap &customParameters,
+        QVector<QByteArray> *encrypted,
+        QVector<QByteArray> *authenticationTags)
+{
+    // read the stored key once, rather than once per element.
+    Sailfish::Crypto::Key fullKey;
+    Sailfish::Crypto::Result keyResult = getFullKey(key, &fullKey);
+    if (keyResult.code() != Sailfish::Crypto::Result::Succeeded) {
+        return keyResult;
+    }
+
+    return m_opensslCryptoPlugin.encryptBatch(data, ivs, fullKey, blockMode, padding, authenticationData, customParameters, encrypted, authenticationTags);
+}
+
+Sailfish::Crypto::Result
+Sailfish::Secrets::Daemon::Plugins::SqlCipherPlugin::decryptBatch(
+        const QVector<QByteArray> &data,
+        const QVector<QByteArray> &ivs,
+        const Sailfish::Crypto::Key &key,
+        Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+        Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+        const QVector<QByteArray> &authenticationData,
+        const QVector<QByteArray> &authenticationTags,
+        const QVariantMap &customParameters,
+        QVector<QByteArray> *decrypted,
+        QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses)
+{
+    // read the stored key once, rather than once per element.
+    Sailfish::Crypto::Key fullKey;
+    Sailfish::Crypto::Result keyResult = getFullKey(key, &fullKey);
+    if (keyResult.code() != Sailfish::Crypto::Result::Succeeded) {
+        return keyResult;
+    }
+
+    return m_opensslCryptoPlugin.decryptBatch(data, ivs, fullKey, blockMode, padding, authenticationData, authenticationTags, customParameters, decrypted, verificationStatuses);
+}
+
 Sailfish::Crypto::Result
 Sailfish::Secrets::Daemon::Plugins::SqlCipherPlugin::initializeCipherSession(
         quint64 clientId,
@@ -7,6 +7,7 @@
 
 #include "sqlcipherplugin.h"
 #include "evp_p.h"
+#include "util_p.h"
 
 #include <QDir>
 #include <QFile>
@@ -337,12 +338,28 @@ Daemon::Plugins::SqlCipherPlugin::setSecret(
         const QString &secretName,
         const QByteArray &secret,
         const Secret::FilterData &filterData)
+{
+    return setSecrets(collectionName,
+                      QStringList() << secretName,
+                      QVector<QByteArray>() << secret,
+                      QVector<Secret::FilterData>() << filterData);
+}
+
+Result
+Daemon::Plugins::SqlCipherPlugin::setSecrets(
+        const QString &collectionName,
+        const QStringList &secretNames,
+        const QVector<QByteArray> &secrets,
+        const QVector<Secret::FilterData> &filterData)
 {
     // Note: don't disallow collectionName=standalone, since that's how we store standalone secrets.
-    if (secretName.isEmpty()) {
-        return Result(Result::InvalidSecretError,
-                      QString::fromUtf8("Empty secret name given"));
-    } else if (collectionName.isEmpty()) {
+    for (const QString &secretName : secretNames) {
+        if (secretName.isEmpty()) {
+            return Result(Result::InvalidSecretError,
+                          QString::fromUtf8("Empty secret name given"));
+        }
+    }
+    if (collectionName.isEmpty()) {
         return Result(Result::InvalidCollectionError,
                       QString::fromUtf8("Empty collection name given"));
     }
@@ -373,32 +390,19 @@ Daemon::Plugins::SqlCipherPlugin::setSecret(
                       QString::fromUtf8("SQLCipher plugin unable to prepare select secrets query: %1").arg(errorText));
     }
 
-    QVariantList values;
-    values << QVariant::fromValue<QString>(secretName);
-    sq.bindValues(values);
-
-    if (!db->beginTransaction()) {
-        return Result(Result::DatabaseTransactionError,
-                      QString::fromUtf8("SQLCipher plugin unable to begin transaction"));
-    }
-
-    if (!db->execute(sq, &errorText)) {
-        db->rollbackTransaction();
-        return Result(Result::DatabaseQueryError,
-                      QString::fromUtf8("SQLCipher plugin unable to execute select secrets query: %1").arg(errorText));
-    }
-
-    bool found = false;
-    if (sq.next()) {
-        found = sq.value(0).value<int>() > 0;
-    }
-
     const QString updateSecretQuery = QStringLiteral(
                  "UPDATE Secrets"
                  " SET Secret = ?"
                  "   , Timestamp = date('now')"
                  " WHERE SecretName = ?;"
              );
+
+    Daemon::Sqlite::Database::Query uq = db->prepare(updateSecretQuery, &errorText);
+    if (!errorText.isEmpty()) {
+        return Result(Result::DatabaseQueryError,
+                      QString::fromUtf8("SQLCipher plugin unable to prepare update secret query: %1").arg(errorText));
+    }
+
     const QString insertSecretQuery = QStringLiteral(
                 "INSERT INTO Secrets ("
                   "SecretName,"
@@ -409,29 +413,12 @@ Daemon::Plugins::SqlCipherPlugin::setSecret(
                   "?,?,date('now')"
                 ");");
 
-    Daemon::Sqlite::Database::Query iq = db->prepare(found ? updateSecretQuery : insertSecretQuery, &errorText);
+    Daemon::Sqlite::Database::Query iq = db->prepare(insertSecretQuery, &errorText);
     if (!errorText.isEmpty()) {
-        db->rollbackTransaction();
         return Result(Result::DatabaseQueryError,
                       QString::fromUtf8("SQLCipher plugin unable to prepare insert secret query: %1").arg(errorText));
     }
 
-    QVariantList ivalues;
-    if (found) {
-        ivalues << QVariant::fromValue<QByteArray>(secret);
-        ivalues << QVariant::fromValue<QString>(secretName);
-    } else {
-        ivalues << QVariant::fromValue<QString>(secretName);
-        ivalues << QVariant::fromValue<QByteArray>(secret);
-    }
-    iq.bindValues(ivalues);
-
-    if (!db->execute(iq, &errorText)) {
-        db->rollbackTransaction();
-        return Result(Result::DatabaseQueryError,
-                      QString::fromUtf8("SQLCipher plugin unable to execute insert secret query: %1").arg(errorText));
-    }
-
     const QString deleteSecretsFilterDataQuery = QStringLiteral(
                  "DELETE FROM SecretsFilterData"
                  " WHERE SecretName = ?;"
@@ -439,21 +426,10 @@ Daemon::Plugins::SqlCipherPlugin::setSecret(
 
     Daemon::Sqlite::Database::Query dq = db->prepare(deleteSecretsFilterDataQuery, &errorText);
     if (!errorText.isEmpty()) {
-        db->rollbackTransaction();
         return Result(Result::DatabaseQueryError,
                       QString::fromUtf8("SQLCipher plugin unable to prepare delete secrets filter data query: %1").arg(errorText));
     }
 
-    QVariantList dvalues;
-    dvalues << QVariant::fromValue<QString>(secretName);
-    dq.bindValues(dvalues);
-
-    if (!db->execute(dq, &errorText)) {
-        db->rollbackTransaction();
-        return Result(Result::DatabaseQueryError,
-                      QString::fromUtf8("SQLCipher plugin unable to execute delete secrets filter data query: %1").arg(errorText));
-    }
-
     const QString insertSecretsFilterDataQuery = QStringLiteral(
                 "INSERT INTO SecretsFilterData ("
                   "SecretName,"
@@ -466,21 +442,71 @@ Daemon::Plugins::SqlCipherPlugin::setSecret(
 
     Daemon::Sqlite::Database::Query ifdq = db->prepare(insertSecretsFilterDataQuery, &errorText);
     if (!errorText.isEmpty()) {
-        db->rollbackTransaction();
         return Result(Result::DatabaseQueryError,
                       QString::fromUtf8("SQLCipher plugin unable to prepare insert secrets filter data query: %1").arg(errorText));
     }
 
-    for (Secret::FilterData::const_iterator it = filterData.constBegin(); it != filterData.constEnd(); it++) {
-        ivalues.clear();
-        ivalues << QVariant::fromValue<QString>(secretName);
-        ivalues << QVariant::fromValue<QString>(it.key());
-        ivalues << QVariant::fromValue<QString>(it.value());
-        ifdq.bindValues(ivalues);
-        if (!db->execute(ifdq, &errorText)) {
+    // write every secret within the same transaction, re-using the prepared queries.
+    if (!db->beginTransaction()) {
+        return Result(Result::DatabaseTransactionError,
+                      QString::fromUtf8("SQLCipher plugin unable to begin transaction"));
+    }
+
+    for (int i = 0; i < secretNames.size(); ++i) {
+        const QString &secretName(secretNames.at(i));
+        QVariantList values;
+        values << QVariant::fromValue<QString>(secretName);
+        sq.bindValues(values);
+
+        if (!db->execute(sq, &errorText)) {
+            db->rollbackTransaction();
+            return Result(Result::DatabaseQueryError,
+                          QString::fromUtf8("SQLCipher plugin unable to execute select secrets query: %1").arg(errorText));
+        }
+
+        bool found = false;
+        if (sq.next()) {
+            found = sq.value(0).value<int>() > 0;
+        }
+        sq.finish();
+
+        QVariantList ivalues;
+        if (found) {
+            ivalues << QVariant::fromValue<QByteArray>(secrets.value(i));
+            ivalues << QVariant::fromValue<QString>(secretName);
+        } else {
+            ivalues << QVariant::fromValue<QString>(secretName);
+            ivalues << QVariant::fromValue<QByteArray>(secrets.value(i));
+        }
+        Daemon::Sqlite::Database::Query &wq(found ? uq : iq);
+        wq.bindValues(ivalues);
+
+        if (!db->execute(wq, &errorText)) {
             db->rollbackTransaction();
             return Result(Result::DatabaseQueryError,
-                          QString::fromUtf8("SQLCipher plugin unable to execute insert secrets filter data query: %1").arg(errorText));
+                          QString::fromUtf8("SQLCipher plugin unable to execute insert secret query: %1").arg(errorText));
+        }
+
+        dq.bindValues(values);
+
+        if (!db->execute(dq, &errorText)) {
+            db->rollbackTransaction();
+            return Result(Result::DatabaseQueryError,
+                          QString::fromUtf8("SQLCipher plugin unable to execute delete secrets filter data query: %1").arg(errorText));
+        }
+
+        const Secret::FilterData secretFilterData = filterData.value(i);
+        for (Secret::FilterData::const_iterator it = secretFilterData.constBegin(); it != secretFilterData.constEnd(); it++) {
+            ivalues.clear();
+            ivalues << QVariant::fromValue<QString>(secretName);
+            ivalues << QVariant::fromValue<QString>(it.key());
+            ivalues << QVariant::fromValue<QString>(it.value());
+            ifdq.bindValues(ivalues);
+            if (!db->execute(ifdq, &errorText)) {
+                db->rollbackTransaction();
+                return Result(Result::DatabaseQueryError,
+                              QString::fromUtf8("SQLCipher plugin unable to execute insert secrets filter data query: %1").arg(errorText));
+            }
         }
     }
 
@@ -499,12 +525,32 @@ Daemon::Plugins::SqlCipherPlugin::getSecret(
         const QString &secretName,
         QByteArray *secret,
         Secret::FilterData *filterData)
+{
+    QVector<QByteArray> secrets;
+    QVector<Secret::FilterData> secretsFilterData;
+    Result result = getSecrets(collectionName, QStringList() << secretName, &secrets, &secretsFilterData);
+    if (result.code() == Result::Succeeded) {
+        *secret = secrets.first();
+        *filterData = secretsFilterData.first();
+    }
+    return result;
+}
+
+Result
+Daemon::Plugins::SqlCipherPlugin::getSecrets(
+        const QString &collectionName,
+        const QStringList &secretNames,
+        QVector<QByteArray> *secrets,
+        QVector<Secret::FilterData> *filterData)
 {
     // Note: don't disallow collectionName=standalone, since that's how we store standalone secrets.
-    if (secretName.isEmpty()) {
-        return Result(Result::InvalidSecretError,
-                      QString::fromUtf8("Empty secret name given"));
-    } else if (collectionName.isEmpty()) {
+    for (const QString &secretName : secretNames) {
+        if (secretName.isEmpty()) {
+            return Result(Result::InvalidSecretError,
+                          QString::fromUtf8("Empty secret name given"));
+        }
+    }
+    if (collectionName.isEmpty()) {
         return Result(Result::InvalidCollectionError,
                       QString::fromUtf8("Empty collection name given"));
     }
@@ -535,43 +581,49 @@ Daemon::Plugins::SqlCipherPlugin::getSecret(
                       QString::fromUtf8("SQLCipher plugin unable to prepare select secret query: %1").arg(errorText));
     }
 
-    QVariantList values;
-    values << QVariant::fromValue<QString>(secretName);
-    sq.bindValues(values);
-
-    if (!db->beginTransaction()) {
-        return Result(Result::DatabaseTransactionError,
-                      QString::fromUtf8("SQLCipher plugin unable to begin transaction"));
-    }
+    const QString selectSecretFilterDataQuery = QStringLiteral(
+                 "SELECT"
+                    " Field,"
+                    " Value"
+                  " FROM SecretsFilterData"
+                  " WHERE SecretName = ?;"
+             );
 
-    if (!db->execute(sq, &errorText)) {
-        db->rollbackTransaction();
+    Daemon::Sqlite::Database::Query sfdq = db->prepare(selectSecretFilterDataQuery, &errorText);
+    if (!errorText.isEmpty()) {
         return Result(Result::DatabaseQueryError,
-                      QString::fromUtf8("SQLCipher plugin unable to execute select secret query: %1").arg(errorText));
+                      QString::fromUtf8("SQLCipher plugin unable to prepare select secret filter data query: %1").arg(errorText));
     }
 
-    bool found = false;
-    QByteArray secretData;
-    if (sq.next()) {
-        found = true;
-        secretData = sq.value(0).value<QByteArray>();
+    // read every secret within the same transaction, re-using the prepared queries.
+    if (!db->beginTransaction()) {
+        return Result(Result::DatabaseTransactionError,
+                      QString::fromUtf8("SQLCipher plugin unable to begin transaction"));
     }
 
-    Secret::FilterData secretFilterData;
-    if (found) {
-        const QString selectSecretFilterDataQuery = QStringLiteral(
-                     "SELECT"
-                        " Field,"
-                        " Value"
-                      " FROM SecretsFilterData"
-                      " WHERE SecretName = ?;"
-                 );
+    QVector<QByteArray> secretsData;
+    QVector<Secret::FilterData> secretsFilterData;
+    secretsData.reserve(secretNames.size());
+    secretsFilterData.reserve(secretNames.size());
+    for (const QString &secretName : secretNames) {
+        QVariantList values;
+        values << QVariant::fromValue<QString>(secretName);
+        sq.bindValues(values);
 
-        Daemon::Sqlite::Database::Query sfdq = db->prepare(selectSecretFilterDataQuery, &errorText);
-        if (!errorText.isEmpty()) {
+        if (!db->execute(sq, &errorText)) {
+            db->rollbackTransaction();
             return Result(Result::DatabaseQueryError,
-                          QString::fromUtf8("SQLCipher plugin unable to prepare select secret filter data query: %1").arg(errorText));
+                          QString::fromUtf8("SQLCipher plugin unable to execute select secret query: %1").arg(errorText));
+        }
+
+        if (!sq.next()) {
+            db->rollbackTransaction();
+            return Result(Result::InvalidSecretError,
+                          QString::fromUtf8("No such secret stored"));
         }
+        secretsData.append(sq.value(0).value<QByteArray>());
+        sq.finish();
+
         sfdq.bindValues(values);
 
         if (!db->execute(sfdq, &errorText)) {
@@ -580,9 +632,12 @@ Daemon::Plugins::SqlCipherPlugin::getSecret(
                           QString::fromUtf8("SQLCipher plugin unable to execute select secret filter data query: %1").arg(errorText));
         }
 
+        Secret::FilterData secretFilterData;
         while (sfdq.next()) {
             secretFilterData.insert(sfdq.value(0).value<QString>(), sfdq.value(1).value<QString>());
         }
+        sfdq.finish();
+        secretsFilterData.append(secretFilterData);
     }
 
     if (!db->commitTransaction()) {
@@ -591,13 +646,8 @@ Daemon::Plugins::SqlCipherPlugin::getSecret(
                       QString::fromUtf8("SQLCipher plugin unable to commit select secret transaction"));
     }
 
-    if (!found) {
-        return Result(Result::InvalidSecretError,
-                      QString::fromUtf8("No such secret stored"));
-    }
-
-    *secret = secretData;
-    *filterData = secretFilterData;
+    *secrets = secretsData;
+    *filterData = secretsFilterData;
     return Result(Result::Succeeded);
 }
 
@@ -715,40 +765,8 @@ Daemon::Plugins::SqlCipherPlugin::findSecrets(
     }
 
     // perform in-memory filtering.
-    QSet<QString> matchingSecretNames;
-    for (QMap<QString, Secret::FilterData >::const_iterator it = secretNameToFilterData.constBegin(); it != secretNameToFilterData.constEnd(); it++) {
-        const Secret::FilterData &currFilterData(it.value());
-        bool matches = filterOperator == StoragePlugin::OperatorOr ? false : true;
-        for (Secret::FilterData::const_iterator fit = filter.constBegin(); fit != filter.constEnd(); fit++) {
-            bool found = false;
-            for (Secret::FilterData::const_iterator mit = currFilterData.constBegin(); mit != currFilterData.constEnd(); mit++) {
-                if (fit.key().compare(mit.key(), Qt::CaseInsensitive) == 0) {
-                    found = true; // found a matching metadata field for this filter field
-                    if (fit.value().compare(mit.value(), Qt::CaseInsensitive) == 0) {
-                        // the metadata value matches the filter value
-                        if (filterOperator == StoragePlugin::OperatorOr) {
-                            // we have a match!
-                            matches = true;
-                        }
-                    } else {
-                        if (filterOperator == StoragePlugin::OperatorAnd) {
-                            // we know that this one doesn't match.
-                            matches = false;
-                        }
-                    }
-                    break; // mit
-                }
-            }
-            if (!found && filterOperator == StoragePlugin::OperatorAnd) {
-                // the metadata is missing a required filter field.
-                matches = false;
-                break; // fit
-            }
-        }
-        if (matches) {
-            matchingSecretNames.insert(it.key());
-        }
-    }
+    const QStringList matchingSecretNames = Daemon::Util::matchingSecretNames(
+                secretNameToFilterData, filter, filterOperator);
 
     QVector<Secret::Identifier> retn;
     for (const QString &secretName : matchingSecretNames) {
@@ -826,6 +844,105 @@ Daemon::Plugins::SqlCipherPlugin::removeSecret(
     return Result(Result::Succeeded);
 }
 
+Result
+Daemon::Plugins::SqlCipherPlugin::removeSecrets(
+        const QString &collectionName,
+        const Secret::FilterData &filter,
+        StoragePlugin::FilterOperator filterOperator,
+        QStringList *secretNames)
+{
+    secretNames->clear();
+
+    // Note: don't disallow collectionName=standalone, since that's how we store standalone secrets.
+    if (collectionName.isEmpty()) {
+        return Result(Result::InvalidCollectionError,
+                      QString::fromUtf8("Empty collection name given"));
+    } else if (filter.isEmpty()) {
+        return Result(Result::InvalidFilterError,
+                      QString::fromUtf8("Empty filter given"));
+    }
+
+    Daemon::Sqlite::Database *db = m_collectionDatabases.value(collectionName);
+    if (!db) {
+        const QString collectionPath = m_databaseDirPath + collectionName + QLatin1String(".db");
+        return QFile::exists(collectionPath)
+                ? Result(Result::CollectionIsLockedError,
+                         QLatin1String("That collection is locked"))
+                : Result(Result::InvalidCollectionError,
+                         QLatin1String("No collection with that name exists"));
+    }
+
+    Daemon::Sqlite::DatabaseLocker locker(db);
+
+    // the filter data is matched in-memory, as in findSecrets(), since
+    // COLLATE NOCASE would only fold the case of ASCII characters.
+    const QString selectSecretsFilterDataQuery = QStringLiteral(
+                 "SELECT"
+                    " SecretName,"
+                    " Field,"
+                    " Value"
+                 " FROM SecretsFilterData;"
+             );
+    const QString deleteSecretQuery = QStringLiteral(
+                "DELETE FROM Secrets"
+                " WHERE SecretName = ?;");
+
+    QString errorText;
+    Daemon::Sqlite::Database::Query sq = db->prepare(selectSecretsFilterDataQuery, &errorText);
+    if (!errorText.isEmpty()) {
+        return Result(Result::DatabaseQueryError,
+                      QString::fromUtf8("SQLCipher plugin unable to prepare select secrets filter data query: %1").arg(errorText));
+    }
+
+    Daemon::Sqlite::Database::Query dq = db->prepare(deleteSecretQuery, &errorText);
+    if (!errorText.isEmpty()) {
+        return Result(Result::DatabaseQueryError,
+                      QString::fromUtf8("SQLCipher plugin unable to prepare delete secret query: %1").arg(errorText));
+    }
+
+    if (!db->beginTransaction()) {
+        return Result(Result::DatabaseTransactionError,
+                      QString::fromUtf8("SQLCipher plugin unable to begin remove secrets transaction"));
+    }
+
+    if (!db->execute(sq, &errorText)) {
+        db->rollbackTransaction();
+        return Result(Result::DatabaseQueryError,
+                      QString::fromUtf8("SQLCipher plugin unable to execute select secrets filter data query: %1").arg(errorText));
+    }
+
+    QMap<QString, Secret::FilterData> secretNameToFilterData;
+    while (sq.next()) {
+        secretNameToFilterData[sq.value(0).value<QString>()].insert(sq.value(1).value<QString>(), sq.value(2).value<QString>());
+    }
+    sq.finish();
+
+    const QStringList matchingSecretNames = Daemon::Util::matchingSecretNames(
+                secretNameToFilterData, filter, filterOperator);
+    if (!matchingSecretNames.isEmpty()) {
+        QVariantList vsecretNames;
+        for (const QString &secretName : matchingSecretNames) {
+            vsecretNames.append(QVariant::fromValue<QString>(secretName));
+        }
+        dq.addBindValue(vsecretNames);
+
+        if (!db->executeBatch(dq, &errorText)) {
+            db->rollbackTransaction();
+            return Result(Result::DatabaseQueryError,
+                          QString::fromUtf8("SQLCipher plugin unable to execute delete secret query: %1").arg(errorText));
+        }
+    }
+
+    if (!db->commitTransaction()) {
+        db->rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QString::fromUtf8("SQLCipher plugin unable to commit remove secrets transaction"));
+    }
+
+    *secretNames = matchingSecretNames;
+    return Result(Result::Succeeded);
+}
+
 
 Result
 Daemon::Plugins::SqlCipherPlugin::setSecret(
@@ -100,9 +100,12 @@ public:
 
     Sailfish::Secrets::Result setSecret(const QString &collectionName, const QString &secretName, const QByteArray &secret, const Sailfish::Secrets::Secret::FilterData &filterData) Q_DECL_OVERRIDE;
     Sailfish::Secrets::Result getSecret(const QString &collectionName, const QString &secretName, QByteArray *secret, Sailfish::Secrets::Secret::FilterData *filterData) Q_DECL_OVERRIDE;
+    Sailfish::Secrets::Result setSecrets(const QString &collectionName, const QStringList &secretNames, const QVector<QByteArray> &secrets, const QVector<Sailfish::Secrets::Secret::FilterData> &filterData) Q_DECL_OVERRIDE;
+    Sailfish::Secrets::Result getSecrets(const QString &collectionName, const QStringList &secretNames, QVector<QByteArray> *secrets, QVector<Sailfish::Secrets::Secret::FilterData> *filterData) Q_DECL_OVERRIDE;
     Sailfish::Secrets::Result secretNames(const QString &collectionName, QStringList *secretNames) Q_DECL_OVERRIDE;
     Sailfish::Secrets::Result findSecrets(const QString &collectionName, const Sailfish::Secrets::Secret::FilterData &filter, Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator, QVector<Sailfish::Secrets::Secret::Identifier> *identifiers) Q_DECL_OVERRIDE;
     Sailfish::Secrets::Result removeSecret(const QString &collectionName, const QString &secretName) Q_DECL_OVERRIDE;
+    Sailfish::Secrets::Result removeSecrets(const QString &collectionName, const Sailfish::Secrets::Secret::FilterData &filter, Sailfish::Secrets::StoragePlugin::FilterOperator filterOperator, QStringList *secretNames) Q_DECL_OVERRIDE;
 
     Sailfish::Secrets::Result setSecret(const QString &secretName, const QByteArray &secret, const Sailfish::Secrets::Secret::FilterData &filterData, const QByteArray &key) Q_DECL_OVERRIDE;
     Sailfish::Secrets::Result accessSecret(const QString &secretName, const QByteArray &key, QByteArray *secret, Sailfish::Secrets::Secret::FilterData *filterData) Q_DECL_OVERRIDE;
@@ -219,6 +222,38 @@ public:
             QByteArray *decrypted,
             Sailfish::Crypto::CryptoManager::VerificationStatus *verificationStatus);
 
+    Sailfish::Crypto::Result verifyBatch(
+            const QVector<QByteArray> &signatures,
+            const QVector<QByteArray> &data,
+            const QVector<Sailfish::Crypto::Key> &keys,
+            Sailfish::Crypto::CryptoManager::SignaturePadding padding,
+            Sailfish::Crypto::CryptoManager::DigestFunction digestFunction,
+            const QVariantMap &customParameters,
+            QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses) Q_DECL_OVERRIDE;
+
+    Sailfish::Crypto::Result encryptBatch(
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVariantMap &customParameters,
+            QVector<QByteArray> *encrypted,
+            QVector<QByteArray> *authenticationTags) Q_DECL_OVERRIDE;
+
+    Sailfish::Crypto::Result decryptBatch(
+            const QVector<QByteArray> &data,
+            const QVector<QByteArray> &ivs,
+            const Sailfish::Crypto::Key &key,
+            Sailfish::Crypto::CryptoManager::BlockMode blockMode,
+            Sailfish::Crypto::CryptoManager::EncryptionPadding padding,
+            const QVector<QByteArray> &authenticationData,
+            const QVector<QByteArray> &authenticationTags,
+            const QVariantMap &customParameters,
+            QVector<QByteArray> *decrypted,
+            QVector<Sailfish::Crypto::CryptoManager::VerificationStatus> *verificationStatuses) Q_DECL_OVERRIDE;
+
     Sailfish::Crypto::Result initializeCipherSession(
             quint64 clientId,
             const QByteArray &iv,
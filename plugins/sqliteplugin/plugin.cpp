@@ -7,6 +7,7 @@
 
 #include "plugin.h"
 #include "sqlitedatabase_p.h"
+#include "util_p.h"
 
 Q_PLUGIN_METADATA(IID Sailfish_Secrets_StoragePlugin_IID)
 
@@ -78,7 +79,7 @@ Result
 Daemon::Plugins::SqlitePlugin::collectionNames(QStringList *names)
 {
     openDatabaseIfNecessary();
-    Daemon::Sqlite::DatabaseLocker locker(&m_db);
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
 
     const QString selectCollectionNamesQuery = QStringLiteral(
                  "SELECT"
@@ -255,15 +256,31 @@ Daemon::Plugins::SqlitePlugin::setSecret(
         const QString &secretName,
         const QByteArray &secret,
         const Secret::FilterData &filterData)
+{
+    return setSecrets(collectionName,
+                      QStringList() << secretName,
+                      QVector<QByteArray>() << secret,
+                      QVector<Secret::FilterData>() << filterData);
+}
+
+Result
+Daemon::Plugins::SqlitePlugin::setSecrets(
+        const QString &collectionName,
+        const QStringList &secretNames,
+        const QVector<QByteArray> &secrets,
+        const QVector<Secret::FilterData> &filterData)
 {
     openDatabaseIfNecessary();
     Daemon::Sqlite::DatabaseLocker locker(&m_db);
 
     // Note: don't disallow collectionName=standalone, since that's how we store standalone secrets.
-    if (secretName.isEmpty()) {
-        return Result(Result::InvalidSecretError,
-                      QString::fromUtf8("Empty secret name given"));
-    } else if (collectionName.isEmpty()) {
+    for (const QString &secretName : secretNames) {
+        if (secretName.isEmpty()) {
+            return Result(Result::InvalidSecretError,
+                          QString::fromUtf8("Empty secret name given"));
+        }
+    }
+    if (collectionName.isEmpty()) {
         return Result(Result::InvalidCollectionError,
                       QString::fromUtf8("Empty collection name given"));
     }
@@ -283,27 +300,6 @@ Daemon::Plugins::SqlitePlugin::setSecret(
                       QString::fromUtf8("Sqlite plugin unable to prepare select secrets query: %1").arg(errorText));
     }
 
-    QVariantList values;
-    values << QVariant::fromValue<QString>(collectionName);
-    values << QVariant::fromValue<QString>(secretName);
-    sq.bindValues(values);
-
-    if (!m_db.beginTransaction()) {
-        return Result(Result::DatabaseTransactionError,
-                      QString::fromUtf8("Sqlite plugin unable to begin transaction"));
-    }
-
-    if (!m_db.execute(sq, &errorText)) {
-        m_db.rollbackTransaction();
-        return Result(Result::DatabaseQueryError,
-                      QString::fromUtf8("Sqlite plugin unable to execute select secrets query: %1").arg(errorText));
-    }
-
-    bool found = false;
-    if (sq.next()) {
-        found = sq.value(0).value<int>() > 0;
-    }
-
     const QString updateSecretQuery = QStringLiteral(
                  "UPDATE Secrets"
                  " SET Secret = ?"
@@ -311,6 +307,13 @@ Daemon::Plugins::SqlitePlugin::setSecret(
                  " WHERE CollectionName = ?"
                  " AND SecretName = ?;"
              );
+
+    Daemon::Sqlite::Database::Query uq = m_db.prepare(updateSecretQuery, &errorText);
+    if (!errorText.isEmpty()) {
+        return Result(Result::DatabaseQueryError,
+                      QString::fromUtf8("Sqlite plugin unable to prepare update secret query: %1").arg(errorText));
+    }
+
     const QString insertSecretQuery = QStringLiteral(
                 "INSERT INTO Secrets ("
                   "CollectionName,"
@@ -322,31 +325,12 @@ Daemon::Plugins::SqlitePlugin::setSecret(
                   "?,?,?,date('now')"
                 ");");
 
-    Daemon::Sqlite::Database::Query iq = m_db.prepare(found ? updateSecretQuery : insertSecretQuery, &errorText);
+    Daemon::Sqlite::Database::Query iq = m_db.prepare(insertSecretQuery, &errorText);
     if (!errorText.isEmpty()) {
-        m_db.rollbackTransaction();
         return Result(Result::DatabaseQueryError,
                       QString::fromUtf8("Sqlite plugin unable to prepare insert secret query: %1").arg(errorText));
     }
 
-    QVariantList ivalues;
-    if (found) {
-        ivalues << QVariant::fromValue<QByteArray>(secret);
-        ivalues << QVariant::fromValue<QString>(collectionName);
-        ivalues << QVariant::fromValue<QString>(secretName);
-    } else {
-        ivalues << QVariant::fromValue<QString>(collectionName);
-        ivalues << QVariant::fromValue<QString>(secretName);
-        ivalues << QVariant::fromValue<QByteArray>(secret);
-    }
-    iq.bindValues(ivalues);
-
-    if (!m_db.execute(iq, &errorText)) {
-        m_db.rollbackTransaction();
-        return Result(Result::DatabaseQueryError,
-                      QString::fromUtf8("Sqlite plugin unable to execute insert secret query: %1").arg(errorText));
-    }
-
     const QString deleteSecretsFilterDataQuery = QStringLiteral(
                  "DELETE FROM SecretsFilterData"
                  " WHERE CollectionName = ?"
@@ -355,22 +339,10 @@ Daemon::Plugins::SqlitePlugin::setSecret(
 
     Daemon::Sqlite::Database::Query dq = m_db.prepare(deleteSecretsFilterDataQuery, &errorText);
     if (!errorText.isEmpty()) {
-        m_db.rollbackTransaction();
         return Result(Result::DatabaseQueryError,
                       QString::fromUtf8("Sqlite plugin unable to prepare delete secrets filter data query: %1").arg(errorText));
     }
 
-    QVariantList dvalues;
-    dvalues << QVariant::fromValue<QString>(collectionName);
-    dvalues << QVariant::fromValue<QString>(secretName);
-    dq.bindValues(dvalues);
-
-    if (!m_db.execute(dq, &errorText)) {
-        m_db.rollbackTransaction();
-        return Result(Result::DatabaseQueryError,
-                      QString::fromUtf8("Sqlite plugin unable to execute delete secrets filter data query: %1").arg(errorText));
-    }
-
     const QString insertSecretsFilterDataQuery = QStringLiteral(
                 "INSERT INTO SecretsFilterData ("
                   "CollectionName,"
@@ -384,22 +356,75 @@ Daemon::Plugins::SqlitePlugin::setSecret(
 
     Daemon::Sqlite::Database::Query ifdq = m_db.prepare(insertSecretsFilterDataQuery, &errorText);
     if (!errorText.isEmpty()) {
-        m_db.rollbackTransaction();
         return Result(Result::DatabaseQueryError,
                       QString::fromUtf8("Sqlite plugin unable to prepare insert secrets filter data query: %1").arg(errorText));
     }
 
-    for (Secret::FilterData::const_iterator it = filterData.constBegin(); it != filterData.constEnd(); it++) {
-        ivalues.clear();
-        ivalues << QVariant::fromValue<QString>(collectionName);
-        ivalues << QVariant::fromValue<QString>(secretName);
-        ivalues << QVariant::fromValue<QString>(it.key());
-        ivalues << QVariant::fromValue<QString>(it.value());
-        ifdq.bindValues(ivalues);
-        if (!m_db.execute(ifdq, &errorText)) {
+    // write every secret within the same transaction, re-using the prepared queries.
+    if (!m_db.beginTransaction()) {
+        return Result(Result::DatabaseTransactionError,
+                      QString::fromUtf8("Sqlite plugin unable to begin transaction"));
+    }
+
+    for (int i = 0; i < secretNames.size(); ++i) {
+        const QString &secretName(secretNames.at(i));
+        QVariantList values;
+        values << QVariant::fromValue<QString>(collectionName);
+        values << QVariant::fromValue<QString>(secretName);
+        sq.bindValues(values);
+
+        if (!m_db.execute(sq, &errorText)) {
+            m_db.rollbackTransaction();
+            return Result(Result::DatabaseQueryError,
+                          QString::fromUtf8("Sqlite plugin unable to execute select secrets query: %1").arg(errorText));
+        }
+
+        bool found = false;
+        if (sq.next()) {
+            found = sq.value(0).value<int>() > 0;
+        }
+        sq.finish();
+
+        QVariantList ivalues;
+        if (found) {
+            ivalues << QVariant::fromValue<QByteArray>(secrets.value(i));
+            ivalues << QVariant::fromValue<QString>(collectionName);
+            ivalues << QVariant::fromValue<QString>(secretName);
+        } else {
+            ivalues << QVariant::fromValue<QString>(collectionName);
+            ivalues << QVariant::fromValue<QString>(secretName);
+            ivalues << QVariant::fromValue<QByteArray>(secrets.value(i));
+        }
+        Daemon::Sqlite::Database::Query &wq(found ? uq : iq);
+        wq.bindValues(ivalues);
+
+        if (!m_db.execute(wq, &errorText)) {
             m_db.rollbackTransaction();
             return Result(Result::DatabaseQueryError,
-                          QString::fromUtf8("Sqlite plugin unable to execute insert secrets filter data query: %1").arg(errorText));
+                          QString::fromUtf8("Sqlite plugin unable to execute insert secret query: %1").arg(errorText));
+        }
+
+        dq.bindValues(values);
+
+        if (!m_db.execute(dq, &errorText)) {
+            m_db.rollbackTransaction();
+            return Result(Result::DatabaseQueryError,
+                          QString::fromUtf8("Sqlite plugin unable to execute delete secrets filter data query: %1").arg(errorText));
+        }
+
+        const Secret::FilterData secretFilterData = filterData.value(i);
+        for (Secret::FilterData::const_iterator it = secretFilterData.constBegin(); it != secretFilterData.constEnd(); it++) {
+            ivalues.clear();
+            ivalues << QVariant::fromValue<QString>(collectionName);
+            ivalues << QVariant::fromValue<QString>(secretName);
+            ivalues << QVariant::fromValue<QString>(it.key());
+            ivalues << QVariant::fromValue<QString>(it.value());
+            ifdq.bindValues(ivalues);
+            if (!m_db.execute(ifdq, &errorText)) {
+                m_db.rollbackTransaction();
+                return Result(Result::DatabaseQueryError,
+                              QString::fromUtf8("Sqlite plugin unable to execute insert secrets filter data query: %1").arg(errorText));
+            }
         }
     }
 
@@ -418,15 +443,35 @@ Daemon::Plugins::SqlitePlugin::getSecret(
         const QString &secretName,
         QByteArray *secret,
         Secret::FilterData *filterData)
+{
+    QVector<QByteArray> secrets;
+    QVector<Secret::FilterData> secretsFilterData;
+    Result result = getSecrets(collectionName, QStringList() << secretName, &secrets, &secretsFilterData);
+    if (result.code() == Result::Succeeded) {
+        *secret = secrets.first();
+        *filterData = secretsFilterData.first();
+    }
+    return result;
+}
+
+Result
+Daemon::Plugins::SqlitePlugin::getSecrets(
+        const QString &collectionName,
+        const QStringList &secretNames,
+        QVector<QByteArray> *secrets,
+        QVector<Secret::FilterData> *filterData)
 {
     openDatabaseIfNecessary();
-    Daemon::Sqlite::DatabaseLocker locker(&m_db);
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
 
     // Note: don't disallow collectionName=standalone, since that's how we store standalone secrets.
-    if (secretName.isEmpty()) {
-        return Result(Result::InvalidSecretError,
-                      QString::fromUtf8("Empty secret name given"));
-    } else if (collectionName.isEmpty()) {
+    for (const QString &secretName : secretNames) {
+        if (secretName.isEmpty()) {
+            return Result(Result::InvalidSecretError,
+                          QString::fromUtf8("Empty secret name given"));
+        }
+    }
+    if (collectionName.isEmpty()) {
         return Result(Result::InvalidCollectionError,
                       QString::fromUtf8("Empty collection name given"));
     }
@@ -446,71 +491,62 @@ Daemon::Plugins::SqlitePlugin::getSecret(
                       QString::fromUtf8("Sqlite plugin unable to prepare select secret query: %1").arg(errorText));
     }
 
-    QVariantList values;
-    values << QVariant::fromValue<QString>(collectionName);
-    values << QVariant::fromValue<QString>(secretName);
-    sq.bindValues(values);
-
-    if (!m_db.beginTransaction()) {
-        return Result(Result::DatabaseTransactionError,
-                      QString::fromUtf8("Sqlite plugin unable to begin transaction"));
-    }
+    const QString selectSecretFilterDataQuery = QStringLiteral(
+                 "SELECT"
+                    " Field,"
+                    " Value"
+                  " FROM SecretsFilterData"
+                  " WHERE CollectionName = ?"
+                  " AND SecretName = ?;"
+             );
 
-    if (!m_db.execute(sq, &errorText)) {
-        m_db.rollbackTransaction();
+    Daemon::Sqlite::Database::Query sfdq = m_db.prepare(selectSecretFilterDataQuery, &errorText);
+    if (!errorText.isEmpty()) {
         return Result(Result::DatabaseQueryError,
-                      QString::fromUtf8("Sqlite plugin unable to execute select secret query: %1").arg(errorText));
-    }
-
-    bool found = false;
-    QByteArray secretData;
-    if (sq.next()) {
-        found = true;
-        secretData = sq.value(0).value<QByteArray>();
-    }
-
-    Secret::FilterData secretFilterData;
-    if (found) {
-        const QString selectSecretFilterDataQuery = QStringLiteral(
-                     "SELECT"
-                        " Field,"
-                        " Value"
-                      " FROM SecretsFilterData"
-                      " WHERE CollectionName = ?"
-                      " AND SecretName = ?;"
-                 );
-
-        Daemon::Sqlite::Database::Query sfdq = m_db.prepare(selectSecretFilterDataQuery, &errorText);
-        if (!errorText.isEmpty()) {
+                      QString::fromUtf8("Sqlite plugin unable to prepare select secret filter data query: %1").arg(errorText));
+    }
+
+    // every secret is read from the same snapshot of the database, which is
+    // held by the read locker, re-using the prepared queries.
+    QVector<QByteArray> secretsData;
+    QVector<Secret::FilterData> secretsFilterData;
+    secretsData.reserve(secretNames.size());
+    secretsFilterData.reserve(secretNames.size());
+    for (const QString &secretName : secretNames) {
+        QVariantList values;
+        values << QVariant::fromValue<QString>(collectionName);
+        values << QVariant::fromValue<QString>(secretName);
+        sq.bindValues(values);
+
+        if (!m_db.execute(sq, &errorText)) {
             return Result(Result::DatabaseQueryError,
-                          QString::fromUtf8("Sqlite plugin unable to prepare select secret filter data query: %1").arg(errorText));
+                          QString::fromUtf8("Sqlite plugin unable to execute select secret query: %1").arg(errorText));
+        }
+
+        if (!sq.next()) {
+            return Result(Result::InvalidSecretError,
+                          QString::fromUtf8("No such secret stored"));
         }
+        secretsData.append(sq.value(0).value<QByteArray>());
+        sq.finish();
+
         sfdq.bindValues(values);
 
         if (!m_db.execute(sfdq, &errorText)) {
-            m_db.rollbackTransaction();
             return Result(Result::DatabaseQueryError,
                           QString::fromUtf8("Sqlite plugin unable to execute select secret filter data query: %1").arg(errorText));
         }
 
+        Secret::FilterData secretFilterData;
         while (sfdq.next()) {
             secretFilterData.insert(sfdq.value(0).value<QString>(), sfdq.value(1).value<QString>());
         }
+        sfdq.finish();
+        secretsFilterData.append(secretFilterData);
     }
 
-    if (!m_db.commitTransaction()) {
-        m_db.rollbackTransaction();
-        return Result(Result::DatabaseTransactionError,
-                      QString::fromUtf8("Sqlite plugin unable to commit select secret transaction"));
-    }
-
-    if (!found) {
-        return Result(Result::InvalidSecretError,
-                      QString::fromUtf8("No such secret stored"));
-    }
-
-    *secret = secretData;
-    *filterData = secretFilterData;
+    *secrets = secretsData;
+    *filterData = secretsFilterData;
     return Result(Result::Succeeded);
 }
 
@@ -519,7 +555,7 @@ Daemon::Plugins::SqlitePlugin::secretNames(const QString &collectionName,
                                            QStringList *names)
 {
     openDatabaseIfNecessary();
-    Daemon::Sqlite::DatabaseLocker locker(&m_db);
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
 
     const QString selectSecretNamesQuery = QStringLiteral(
                  "SELECT"
@@ -560,7 +596,7 @@ Daemon::Plugins::SqlitePlugin::findSecrets(
         QStringList *secretNames)
 {
     openDatabaseIfNecessary();
-    Daemon::Sqlite::DatabaseLocker locker(&m_db);
+    Daemon::Sqlite::DatabaseReadLocker locker(&m_db);
 
     // Note: don't disallow collectionName=standalone, since that's how we store standalone secrets.
     if (collectionName.isEmpty()) {
@@ -595,13 +631,7 @@ Daemon::Plugins::SqlitePlugin::findSecrets(
     values << QVariant::fromValue<QString>(collectionName);
     sq.bindValues(values);
 
-    if (!m_db.beginTransaction()) {
-        return Result(Result::DatabaseTransactionError,
-                      QString::fromUtf8("Sqlite plugin unable to begin find secrets transaction"));
-    }
-
     if (!m_db.execute(sq, &errorText)) {
-        m_db.rollbackTransaction();
         return Result(Result::DatabaseQueryError,
                       QString::fromUtf8("Sqlite plugin unable to execute select secrets filter data query: %1").arg(errorText));
     }
@@ -612,47 +642,7 @@ Daemon::Plugins::SqlitePlugin::findSecrets(
     }
 
     // perform in-memory filtering.
-    QSet<QString> matchingSecretNames;
-    for (QMap<QString, Secret::FilterData >::const_iterator it = secretNameToFilterData.constBegin(); it != secretNameToFilterData.constEnd(); it++) {
-        const Secret::FilterData &currFilterData(it.value());
-        bool matches = filterOperator == StoragePlugin::OperatorOr ? false : true;
-        for (Secret::FilterData::const_iterator fit = filter.constBegin(); fit != filter.constEnd(); fit++) {
-            bool found = false;
-            for (Secret::FilterData::const_iterator mit = currFilterData.constBegin(); mit != currFilterData.constEnd(); mit++) {
-                if (fit.key().compare(mit.key(), Qt::CaseInsensitive) == 0) {
-                    found = true; // found a matching metadata field for this filter field
-                    if (fit.value().compare(mit.value(), Qt::CaseInsensitive) == 0) {
-                        // the metadata value matches the filter value
-                        if (filterOperator == StoragePlugin::OperatorOr) {
-                            // we have a match!
-                            matches = true;
-                        }
-                    } else {
-                        if (filterOperator == StoragePlugin::OperatorAnd) {
-                            // we know that this one doesn't match.
-                            matches = false;
-                        }
-                    }
-                    break; // mit
-                }
-            }
-            if (!found && filterOperator == StoragePlugin::OperatorAnd) {
-                // the metadata is missing a required filter field.
-                matches = false;
-                break; // fit
-            }
-        }
-        if (matches && !matchingSecretNames.contains(it.key())) {
-            matchingSecretNames.insert(it.key());
-            secretNames->append(it.key());
-        }
-    }
-
-    if (!m_db.commitTransaction()) {
-        m_db.rollbackTransaction();
-        return Result(Result::DatabaseTransactionError,
-                      QString::fromUtf8("Sqlite plugin unable to commit find secrets transaction"));
-    }
+    *secretNames = Daemon::Util::matchingSecretNames(secretNameToFilterData, filter, filterOperator);
 
     return Result(Result::Succeeded);
 }
@@ -711,6 +701,102 @@ Daemon::Plugins::SqlitePlugin::removeSecret(
     return Result(Result::Succeeded);
 }
 
+Result
+Daemon::Plugins::SqlitePlugin::removeSecrets(
+        const QString &collectionName,
+        const Secret::FilterData &filter,
+        StoragePlugin::FilterOperator filterOperator,
+        QStringList *secretNames)
+{
+    openDatabaseIfNecessary();
+    Daemon::Sqlite::DatabaseLocker locker(&m_db);
+
+    secretNames->clear();
+
+    // Note: don't disallow collectionName=standalone, since that's how we store standalone secrets.
+    if (collectionName.isEmpty()) {
+        return Result(Result::InvalidCollectionError,
+                      QString::fromUtf8("Empty collection name given"));
+    } else if (filter.isEmpty()) {
+        return Result(Result::InvalidFilterError,
+                      QString::fromUtf8("Empty filter given"));
+    }
+
+    // the filter data is matched in-memory, as in findSecrets(), since
+    // COLLATE NOCASE would only fold the case of ASCII characters.
+    const QString selectSecretsFilterDataQuery = QStringLiteral(
+                 "SELECT"
+                    " SecretName,"
+                    " Field,"
+                    " Value"
+                 " FROM SecretsFilterData"
+                 " WHERE CollectionName = ?;"
+             );
+    const QString deleteSecretQuery = QStringLiteral(
+                "DELETE FROM Secrets"
+                " WHERE CollectionName = ?"
+                " AND SecretName = ?;");
+
+    QString errorText;
+    Daemon::Sqlite::Database::Query sq = m_db.prepare(selectSecretsFilterDataQuery, &errorText);
+    if (!errorText.isEmpty()) {
+        return Result(Result::DatabaseQueryError,
+                      QString::fromUtf8("Sqlite plugin unable to prepare select secrets filter data query: %1").arg(errorText));
+    }
+
+    Daemon::Sqlite::Database::Query dq = m_db.prepare(deleteSecretQuery, &errorText);
+    if (!errorText.isEmpty()) {
+        return Result(Result::DatabaseQueryError,
+                      QString::fromUtf8("Sqlite plugin unable to prepare delete secret query: %1").arg(errorText));
+    }
+
+    sq.bindValues(QVariantList() << QVariant::fromValue<QString>(collectionName));
+
+    if (!m_db.beginTransaction()) {
+        return Result(Result::DatabaseTransactionError,
+                      QString::fromUtf8("Sqlite plugin unable to begin remove secrets transaction"));
+    }
+
+    if (!m_db.execute(sq, &errorText)) {
+        m_db.rollbackTransaction();
+        return Result(Result::DatabaseQueryError,
+                      QString::fromUtf8("Sqlite plugin unable to execute select secrets filter data query: %1").arg(errorText));
+    }
+
+    QMap<QString, Secret::FilterData> secretNameToFilterData;
+    while (sq.next()) {
+        secretNameToFilterData[sq.value(0).value<QString>()].insert(sq.value(1).value<QString>(), sq.value(2).value<QString>());
+    }
+    sq.finish();
+
+    const QStringList matchingSecretNames = Daemon::Util::matchingSecretNames(
+                secretNameToFilterData, filter, filterOperator);
+    if (!matchingSecretNames.isEmpty()) {
+        QVariantList vcollectionNames, vsecretNames;
+        for (const QString &secretName : matchingSecretNames) {
+            vcollectionNames.append(QVariant::fromValue<QString>(collectionName));
+            vsecretNames.append(QVariant::fromValue<QString>(secretName));
+        }
+        dq.addBindValue(vcollectionNames);
+        dq.addBindValue(vsecretNames);
+
+        if (!m_db.executeBatch(dq, &errorText)) {
+            m_db.rollbackTransaction();
+            return Result(Result::DatabaseQueryError,
+                          QString::fromUtf8("Sqlite plugin unable to execute delete secret query: %1").arg(errorText));
+        }
+    }
+
+    if (!m_db.commitTransaction()) {
+        m_db.rollbackTransaction();
+        return Result(Result::DatabaseTransactionError,
+                      QString::fromUtf8("Sqlite plugin unable to commit remove secrets transaction"));
+    }
+
+    *secretNames = matchingSecretNames;
+    return Result(Result::Succeeded);
+}
+
 Result
 Daemon::Plugins::SqlitePlugin::reencrypt(
         const QString &collectionName, // non-empty, all secrets in this collection will be re-encrypted
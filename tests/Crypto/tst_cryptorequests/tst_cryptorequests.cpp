@@ -17,8 +17,10 @@
 
 #include "Crypto/calculatedigestrequest.h"
 #include "Crypto/cipherrequest.h"
+#include "Crypto/decryptbatchrequest.h"
 #include "Crypto/decryptrequest.h"
 #include "Crypto/deletestoredkeyrequest.h"
+#include "Crypto/encryptbatchrequest.h"
 #include "Crypto/encryptrequest.h"
 #include "Crypto/generatekeyrequest.h"
 #include "Crypto/generaterandomdatarequest.h"
@@ -32,6 +34,7 @@
 #include "Crypto/signrequest.h"
 #include "Crypto/storedkeyidentifiersrequest.h"
 #include "Crypto/storedkeyrequest.h"
+#include "Crypto/verifybatchrequest.h"
 #include "Crypto/verifyrequest.h"
 
 #include "Crypto/cryptomanager.h"
@@ -156,8 +159,10 @@ private slots:
     void generateInitializationVectorRequest();
     void generateKeyEncryptDecrypt_data();
     void generateKeyEncryptDecrypt();
+    void encryptDecryptBatch();
     void signVerify();
     void signVerify_data();
+    void verifyBatch();
     void calculateDigest();
     void calculateDigest_data();
     void storedKeyRequests_data();
@@ -167,6 +172,7 @@ private slots:
     void storedDerivedKeyRequests_data();
     void storedDerivedKeyRequests();
     void storedGeneratedKeyRequests();
+    void storedKeyCache();
     void cipherSignVerify();
     void cipherEncryptDecrypt_data();
     void cipherEncryptDecrypt();
@@ -175,6 +181,7 @@ private slots:
     void cipherTimeout();
     void lockCode();
     void pluginThreading();
+    void concurrentSignVerifyAndLockCode();
     void requestInterleaving();
     void importKey_data();
     void importKey();
@@ -612,6 +619,134 @@ void tst_cryptorequests::generateKeyEncryptDecrypt()
     QCOMPARE(dr.verificationStatus() == CryptoManager::VerificationSucceeded, !dr.authenticationData().isEmpty());
 }
 
+void tst_cryptorequests::encryptDecryptBatch()
+{
+    // generate an AES key with which to encrypt the batch
+    Key keyTemplate;
+    keyTemplate.setSize(256);
+    keyTemplate.setAlgorithm(CryptoManager::AlgorithmAes);
+    keyTemplate.setOrigin(Key::OriginDevice);
+    keyTemplate.setOperations(CryptoManager::OperationEncrypt | CryptoManager::OperationDecrypt);
+
+    GenerateKeyRequest gkr;
+    gkr.setManager(&cm);
+    gkr.setKeyTemplate(keyTemplate);
+    gkr.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    gkr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gkr);
+    QCOMPARE(gkr.result().code(), Result::Succeeded);
+    Key fullKey = gkr.generatedKey();
+    QVERIFY(!fullKey.secretKey().isEmpty());
+
+    QVector<QByteArray> plaintexts;
+    QVector<QByteArray> initVectors;
+    QVector<QByteArray> authData;
+    for (int i = 0; i < 5; ++i) {
+        plaintexts.append(createRandomTestData(16 + i));
+        initVectors.append(generateInitializationVector(CryptoManager::AlgorithmAes, CryptoManager::BlockModeGcm));
+        authData.append(QByteArray("fedcba9876543210") + QByteArray::number(i));
+    }
+
+    // a mismatched number of initialization vectors should be rejected.
+    EncryptBatchRequest ebr;
+    ebr.setManager(&cm);
+    QSignalSpy ebrss(&ebr, &EncryptBatchRequest::statusChanged);
+    QSignalSpy ebrcs(&ebr, &EncryptBatchRequest::ciphertextsChanged);
+    ebr.setData(plaintexts);
+    QCOMPARE(ebr.data(), plaintexts);
+    ebr.setInitializationVectors(initVectors.mid(1));
+    ebr.setKey(fullKey);
+    QCOMPARE(ebr.key(), fullKey);
+    ebr.setBlockMode(CryptoManager::BlockModeGcm);
+    QCOMPARE(ebr.blockMode(), CryptoManager::BlockModeGcm);
+    ebr.setPadding(CryptoManager::EncryptionPaddingNone);
+    QCOMPARE(ebr.padding(), CryptoManager::EncryptionPaddingNone);
+    ebr.setAuthenticationData(authData);
+    QCOMPARE(ebr.authenticationData(), authData);
+    ebr.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    QCOMPARE(ebr.cryptoPluginName(), DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    QCOMPARE(ebr.status(), Request::Inactive);
+    ebr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ebr);
+    QCOMPARE(ebr.status(), Request::Finished);
+    QCOMPARE(ebr.result().code(), Result::Failed);
+    QCOMPARE(ebr.result().errorCode(), Result::InvalidInitializationVectorError);
+    QVERIFY(ebr.ciphertexts().isEmpty());
+
+    // encrypt every item in a single request.
+    ebr.setInitializationVectors(initVectors);
+    QCOMPARE(ebr.initializationVectors(), initVectors);
+    QCOMPARE(ebr.status(), Request::Inactive);
+    ebrss.clear();
+    ebrcs.clear();
+    ebr.startRequest();
+    QCOMPARE(ebrss.count(), 1);
+    QCOMPARE(ebr.status(), Request::Active);
+    QCOMPARE(ebr.result().code(), Result::Pending);
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ebr);
+    QCOMPARE(ebrss.count(), 2);
+    QCOMPARE(ebr.status(), Request::Finished);
+    QCOMPARE(ebr.result().errorMessage(), QString());
+    QCOMPARE(ebr.result().code(), Result::Succeeded);
+    QCOMPARE(ebrcs.count(), 1);
+    const QVector<QByteArray> ciphertexts = ebr.ciphertexts();
+    const QVector<QByteArray> authenticationTags = ebr.authenticationTags();
+    QCOMPARE(ciphertexts.size(), plaintexts.size());
+    QCOMPARE(authenticationTags.size(), plaintexts.size());
+    for (int i = 0; i < plaintexts.size(); ++i) {
+        QVERIFY(!ciphertexts.at(i).isEmpty());
+        QVERIFY(ciphertexts.at(i) != plaintexts.at(i));
+        QVERIFY(!authenticationTags.at(i).isEmpty());
+    }
+
+    // each item should be the same as if it had been encrypted individually.
+    EncryptRequest er;
+    er.setManager(&cm);
+    er.setData(plaintexts.at(2));
+    er.setInitializationVector(initVectors.at(2));
+    er.setKey(fullKey);
+    er.setBlockMode(CryptoManager::BlockModeGcm);
+    er.setPadding(CryptoManager::EncryptionPaddingNone);
+    er.setAuthenticationData(authData.at(2));
+    er.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    er.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(er);
+    QCOMPARE(er.result().code(), Result::Succeeded);
+    QCOMPARE(er.ciphertext(), ciphertexts.at(2));
+    QCOMPARE(er.authenticationTag(), authenticationTags.at(2));
+
+    // decrypt every item in a single request, and ensure that the roundtrip works.
+    DecryptBatchRequest dbr;
+    dbr.setManager(&cm);
+    QSignalSpy dbrps(&dbr, &DecryptBatchRequest::plaintextsChanged);
+    QSignalSpy dbrvs(&dbr, &DecryptBatchRequest::verificationStatusesChanged);
+    dbr.setData(ciphertexts);
+    QCOMPARE(dbr.data(), ciphertexts);
+    dbr.setInitializationVectors(initVectors);
+    QCOMPARE(dbr.initializationVectors(), initVectors);
+    dbr.setKey(fullKey);
+    dbr.setBlockMode(CryptoManager::BlockModeGcm);
+    dbr.setPadding(CryptoManager::EncryptionPaddingNone);
+    dbr.setAuthenticationData(authData);
+    QCOMPARE(dbr.authenticationData(), authData);
+    dbr.setAuthenticationTags(authenticationTags);
+    QCOMPARE(dbr.authenticationTags(), authenticationTags);
+    dbr.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    dbr.startRequest();
+    QCOMPARE(dbr.status(), Request::Active);
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dbr);
+    QCOMPARE(dbr.status(), Request::Finished);
+    QCOMPARE(dbr.result().errorMessage(), QString());
+    QCOMPARE(dbr.result().code(), Result::Succeeded);
+    QCOMPARE(dbrps.count(), 1);
+    QCOMPARE(dbrvs.count(), 1);
+    QCOMPARE(dbr.plaintexts(), plaintexts);
+    QCOMPARE(dbr.verificationStatuses().size(), plaintexts.size());
+    for (CryptoManager::VerificationStatus status : dbr.verificationStatuses()) {
+        QCOMPARE(status, CryptoManager::VerificationSucceeded);
+    }
+}
+
 void tst_cryptorequests::signVerify_data()
 {
     QTest::addColumn<CryptoManager::Algorithm>("algorithm");
@@ -732,6 +867,102 @@ void tst_cryptorequests::signVerify()
     QCOMPARE(vr.verificationStatus(), CryptoManager::VerificationSucceeded);
 }
 
+void tst_cryptorequests::verifyBatch()
+{
+    KeyPairGenerationParameters keyPairGenParams = getKeyPairGenerationParameters(CryptoManager::AlgorithmEc, 256);
+
+    Key keyTemplate;
+    keyTemplate.setAlgorithm(CryptoManager::AlgorithmEc);
+    keyTemplate.setOrigin(Key::OriginDevice);
+    keyTemplate.setOperations(CryptoManager::OperationSign | CryptoManager::OperationVerify);
+    keyTemplate.setFilterData(QLatin1String("test"), QLatin1String("true"));
+
+    GenerateKeyRequest gkr;
+    gkr.setManager(&cm);
+    gkr.setKeyPairGenerationParameters(keyPairGenParams);
+    gkr.setKeyTemplate(keyTemplate);
+    gkr.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    gkr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gkr);
+    QCOMPARE(gkr.result().code(), Result::Succeeded);
+    Key fullKey = gkr.generatedKey();
+    QVERIFY(!fullKey.publicKey().isEmpty());
+
+    // sign enough items that the batch may be divided between threads.
+    const int count = 40;
+    QVector<QByteArray> data;
+    QVector<QByteArray> signatures;
+    for (int i = 0; i < count; ++i) {
+        data.append(QByteArray("Test plaintext data ") + QByteArray::number(i));
+
+        SignRequest sr;
+        sr.setManager(&cm);
+        sr.setKey(fullKey);
+        sr.setPadding(CryptoManager::SignaturePaddingNone);
+        sr.setDigestFunction(CryptoManager::DigestSha256);
+        sr.setData(data.last());
+        sr.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+        sr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(sr);
+        QCOMPARE(sr.result().code(), Result::Succeeded);
+        signatures.append(sr.signature());
+    }
+
+    // a signature must be given for each item of data.
+    VerifyBatchRequest vbr;
+    vbr.setManager(&cm);
+    QSignalSpy vbrss(&vbr, &VerifyBatchRequest::statusChanged);
+    QSignalSpy vbrvs(&vbr, &VerifyBatchRequest::verificationStatusesChanged);
+    vbr.setSignatures(signatures.mid(1));
+    QCOMPARE(vbr.signatures(), signatures.mid(1));
+    vbr.setData(data);
+    QCOMPARE(vbr.data(), data);
+    vbr.setKeys(QVector<Key>() << fullKey);
+    QCOMPARE(vbr.keys(), QVector<Key>() << fullKey);
+    vbr.setPadding(CryptoManager::SignaturePaddingNone);
+    QCOMPARE(vbr.padding(), CryptoManager::SignaturePaddingNone);
+    vbr.setDigestFunction(CryptoManager::DigestSha256);
+    QCOMPARE(vbr.digestFunction(), CryptoManager::DigestSha256);
+    vbr.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    QCOMPARE(vbr.cryptoPluginName(), DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    QCOMPARE(vbr.status(), Request::Inactive);
+    vbr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(vbr);
+    QCOMPARE(vbr.status(), Request::Finished);
+    QCOMPARE(vbr.result().code(), Result::Failed);
+    QCOMPARE(vbr.result().errorCode(), Result::EmptySignatureError);
+    QVERIFY(vbr.verificationStatuses().isEmpty());
+
+    // tamper with one item of data, whose signature should then fail to verify,
+    // and replace another signature with one which is not even valid DER.
+    // Neither should affect the results for the other items.
+    QVector<QByteArray> tamperedData(data);
+    tamperedData[count / 2] = QByteArray("Tampered plaintext data");
+    QVector<QByteArray> tamperedSignatures(signatures);
+    tamperedSignatures[count / 4] = QByteArray("Malformed signature");
+    vbr.setSignatures(tamperedSignatures);
+    vbr.setData(tamperedData);
+    QCOMPARE(vbr.status(), Request::Inactive);
+    vbrss.clear();
+    vbrvs.clear();
+    vbr.startRequest();
+    QCOMPARE(vbrss.count(), 1);
+    QCOMPARE(vbr.status(), Request::Active);
+    QCOMPARE(vbr.result().code(), Result::Pending);
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(vbr);
+    QCOMPARE(vbrss.count(), 2);
+    QCOMPARE(vbr.status(), Request::Finished);
+    QCOMPARE(vbr.result().errorMessage(), QString());
+    QCOMPARE(vbr.result().code(), Result::Succeeded);
+    QCOMPARE(vbrvs.count(), 1);
+    QCOMPARE(vbr.verificationStatuses().size(), count);
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(vbr.verificationStatuses().at(i),
+                 (i == count / 2 || i == count / 4) ? CryptoManager::VerificationFailed
+                                                     : CryptoManager::VerificationSucceeded);
+    }
+}
+
 void tst_cryptorequests::calculateDigest_data()
 {
     QTest::addColumn<CryptoManager::DigestFunction>("digestFunction");
@@ -1735,6 +1966,123 @@ void tst_cryptorequests::storedGeneratedKeyRequests()
     QCOMPARE(dcr.result().code(), Sailfish::Secrets::Result::Succeeded);
 }
 
+void tst_cryptorequests::storedKeyCache()
+{
+    // test that a stored key which is read from another storage plugin
+    // for repeated operations gives consistent results, and that it
+    // cannot be used once it has been deleted.
+    Sailfish::Secrets::CreateCollectionRequest ccr;
+    ccr.setManager(&sm);
+    ccr.setCollectionLockType(Sailfish::Secrets::CreateCollectionRequest::DeviceLock);
+    ccr.setCollectionName(QLatin1String("tstcryptostoredkeycache"));
+    ccr.setStoragePluginName(DEFAULT_TEST_STORAGE_PLUGIN);
+    ccr.setEncryptionPluginName(DEFAULT_TEST_ENCRYPTION_PLUGIN);
+    ccr.setAuthenticationPluginName(IN_APP_TEST_AUTHENTICATION_PLUGIN);
+    ccr.setDeviceLockUnlockSemantic(Sailfish::Secrets::SecretManager::DeviceLockKeepUnlocked);
+    ccr.setAccessControlMode(Sailfish::Secrets::SecretManager::OwnerOnlyMode);
+    ccr.setUserInteractionMode(Sailfish::Secrets::SecretManager::ApplicationInteraction);
+    ccr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ccr);
+    QCOMPARE(ccr.status(), Sailfish::Secrets::Request::Finished);
+    QCOMPARE(ccr.result().errorMessage(), QString());
+    QCOMPARE(ccr.result().code(), Sailfish::Secrets::Result::Succeeded);
+
+    Sailfish::Crypto::Key keyTemplate;
+    keyTemplate.setSize(256);
+    keyTemplate.setAlgorithm(Sailfish::Crypto::CryptoManager::AlgorithmAes);
+    keyTemplate.setOrigin(Sailfish::Crypto::Key::OriginDevice);
+    keyTemplate.setOperations(Sailfish::Crypto::CryptoManager::OperationEncrypt | Sailfish::Crypto::CryptoManager::OperationDecrypt);
+    keyTemplate.setIdentifier(Sailfish::Crypto::Key::Identifier(QLatin1String("storedkey"),
+                                                                QLatin1String("tstcryptostoredkeycache"),
+                                                                DEFAULT_TEST_STORAGE_PLUGIN));
+
+    GenerateStoredKeyRequest gskr;
+    gskr.setManager(&cm);
+    gskr.setKeyTemplate(keyTemplate);
+    gskr.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    gskr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gskr);
+    QCOMPARE(gskr.result().errorMessage(), QString());
+    QCOMPARE(gskr.result().code(), Result::Succeeded);
+    Sailfish::Crypto::Key keyReference = gskr.generatedKeyReference();
+
+    // encrypt the same plaintext with the same key and IV repeatedly.
+    const QByteArray plaintext = "Test plaintext data";
+    const QByteArray initVector = generateInitializationVector(keyTemplate.algorithm(), CryptoManager::BlockModeCbc);
+    EncryptRequest er;
+    er.setManager(&cm);
+    er.setData(plaintext);
+    er.setInitializationVector(initVector);
+    er.setKey(keyReference);
+    er.setBlockMode(CryptoManager::BlockModeCbc);
+    er.setPadding(CryptoManager::EncryptionPaddingNone);
+    er.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    er.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(er);
+    QCOMPARE(er.result().errorMessage(), QString());
+    QCOMPARE(er.result().code(), Result::Succeeded);
+    const QByteArray ciphertext = er.ciphertext();
+    QVERIFY(!ciphertext.isEmpty());
+
+    for (int i = 0; i < 3; ++i) {
+        er.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(er);
+        QCOMPARE(er.result().code(), Result::Succeeded);
+        QCOMPARE(er.ciphertext(), ciphertext);
+    }
+
+    DecryptRequest dr;
+    dr.setManager(&cm);
+    dr.setData(ciphertext);
+    dr.setInitializationVector(initVector);
+    dr.setKey(keyReference);
+    dr.setBlockMode(CryptoManager::BlockModeCbc);
+    dr.setPadding(CryptoManager::EncryptionPaddingNone);
+    dr.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    dr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dr);
+    QCOMPARE(dr.result().code(), Result::Succeeded);
+    QCOMPARE(dr.plaintext(), plaintext);
+
+    // once the key has been deleted, it can no longer be used.
+    DeleteStoredKeyRequest dskr;
+    dskr.setManager(&cm);
+    dskr.setIdentifier(keyTemplate.identifier());
+    dskr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dskr);
+    QCOMPARE(dskr.result().code(), Result::Succeeded);
+
+    er.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(er);
+    QCOMPARE(er.result().code(), Result::Failed);
+
+    // and a new key stored with the same identifier is used instead.
+    gskr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gskr);
+    QCOMPARE(gskr.result().code(), Result::Succeeded);
+
+    er.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(er);
+    QCOMPARE(er.result().code(), Result::Succeeded);
+    QVERIFY(er.ciphertext() != ciphertext);
+
+    // clean up by deleting the collection in which the key is stored.
+    Sailfish::Secrets::DeleteCollectionRequest dcr;
+    dcr.setManager(&sm);
+    dcr.setCollectionName(QLatin1String("tstcryptostoredkeycache"));
+    dcr.setStoragePluginName(DEFAULT_TEST_STORAGE_PLUGIN);
+    dcr.setUserInteractionMode(Sailfish::Secrets::SecretManager::PreventInteraction);
+    dcr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dcr);
+    QCOMPARE(dcr.status(), Sailfish::Secrets::Request::Finished);
+    QCOMPARE(dcr.result().code(), Sailfish::Secrets::Result::Succeeded);
+
+    // and the key cannot be used once its collection has been deleted.
+    er.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(er);
+    QCOMPARE(er.result().code(), Result::Failed);
+}
+
 void tst_cryptorequests::cipherSignVerify()
 {
     // test generating an asymmetric cipher key pair
@@ -2779,6 +3127,122 @@ void tst_cryptorequests::pluginThreading()
     }
 }
 
+void tst_cryptorequests::concurrentSignVerifyAndLockCode()
+{
+    // The OpenSSL crypto plugin is thread-safe, so its stateless operations
+    // (e.g. sign and verify) are performed concurrently, while the operations
+    // which depend on its state (e.g. lock and unlock) are performed in order
+    // in its serial thread.  Both kinds of operation may be in progress at
+    // the same time, and neither may affect the result of the other.
+    KeyPairGenerationParameters keyPairGenParams = getKeyPairGenerationParameters(CryptoManager::AlgorithmRsa, 2048);
+    Key keyTemplate;
+    keyTemplate.setAlgorithm(CryptoManager::AlgorithmRsa);
+    keyTemplate.setOrigin(Key::OriginDevice);
+    keyTemplate.setOperations(CryptoManager::OperationSign | CryptoManager::OperationVerify);
+    keyTemplate.setFilterData(QLatin1String("test"), QLatin1String("true"));
+
+    GenerateKeyRequest gkr;
+    gkr.setManager(&cm);
+    gkr.setKeyPairGenerationParameters(keyPairGenParams);
+    gkr.setKeyTemplate(keyTemplate);
+    gkr.setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+    gkr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gkr);
+    QCOMPARE(gkr.status(), Request::Finished);
+    QCOMPARE(gkr.result().code(), Result::Succeeded);
+    const Key fullKey = gkr.generatedKey();
+    QVERIFY(!fullKey.privateKey().isEmpty());
+
+    Sailfish::Crypto::InteractionParameters uiParams;
+    uiParams.setAuthenticationPluginName(IN_APP_TEST_AUTHENTICATION_PLUGIN);
+    uiParams.setInputType(Sailfish::Crypto::InteractionParameters::AlphaNumericInput);
+    uiParams.setEchoMode(Sailfish::Crypto::InteractionParameters::NormalEcho);
+    uiParams.setPromptText(QLatin1String("Provide the lock code for the crypto plugin"));
+
+    const int requestCount = 16;
+    const QList<Sailfish::Crypto::LockCodeRequest::LockCodeRequestType> lockCodeRequestTypes {
+        Sailfish::Crypto::LockCodeRequest::QueryLockStatus,
+        Sailfish::Crypto::LockCodeRequest::ForgetLockCode,
+        Sailfish::Crypto::LockCodeRequest::ProvideLockCode
+    };
+    QVector<QSharedPointer<Sailfish::Crypto::LockCodeRequest> > lockCodeRequests;
+    const auto startLockCodeRequest = [&] (int i) {
+        QSharedPointer<Sailfish::Crypto::LockCodeRequest> lcr(new Sailfish::Crypto::LockCodeRequest);
+        lcr->setManager(&cm);
+        lcr->setLockCodeRequestType(lockCodeRequestTypes.at(i % lockCodeRequestTypes.size()));
+        lcr->setLockCodeTargetType(Sailfish::Crypto::LockCodeRequest::ExtensionPlugin);
+        lcr->setLockCodeTarget(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+        lcr->setInteractionParameters(uiParams);
+        lcr->startRequest();
+        lockCodeRequests.append(lcr);
+    };
+
+    // sign different data concurrently, while locking and unlocking the plugin.
+    QVector<QByteArray> plaintexts;
+    QVector<QSharedPointer<SignRequest> > signRequests;
+    for (int i = 0; i < requestCount; ++i) {
+        plaintexts.append(QByteArray("Test plaintext data ") + QByteArray::number(i));
+        QSharedPointer<SignRequest> sr(new SignRequest);
+        sr->setManager(&cm);
+        sr->setKey(fullKey);
+        sr->setPadding(CryptoManager::SignaturePaddingNone);
+        sr->setDigestFunction(CryptoManager::DigestSha256);
+        sr->setData(plaintexts.last());
+        sr->setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+        sr->startRequest();
+        signRequests.append(sr);
+        startLockCodeRequest(i);
+    }
+
+    QVector<QByteArray> signatures;
+    for (const QSharedPointer<SignRequest> &sr : signRequests) {
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING((*sr));
+        QCOMPARE(sr->status(), Request::Finished);
+        QCOMPARE(sr->result().code(), Result::Succeeded);
+        QVERIFY(!sr->signature().isEmpty());
+        signatures.append(sr->signature());
+    }
+
+    // verify each signature concurrently, while locking and unlocking the plugin.
+    // Each signature must match the data it was made for, and no other.
+    QVector<QSharedPointer<VerifyRequest> > verifyRequests;
+    for (int i = 0; i < requestCount; ++i) {
+        QSharedPointer<VerifyRequest> vr(new VerifyRequest);
+        vr->setManager(&cm);
+        vr->setKey(fullKey);
+        vr->setPadding(CryptoManager::SignaturePaddingNone);
+        vr->setDigestFunction(CryptoManager::DigestSha256);
+        vr->setData(plaintexts.at(i));
+        vr->setSignature(signatures.at(i % 2 ? i : (i + 1) % requestCount));
+        vr->setCryptoPluginName(DEFAULT_TEST_CRYPTO_PLUGIN_NAME);
+        vr->startRequest();
+        verifyRequests.append(vr);
+        startLockCodeRequest(i);
+    }
+
+    for (int i = 0; i < requestCount; ++i) {
+        const QSharedPointer<VerifyRequest> &vr(verifyRequests.at(i));
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING((*vr));
+        QCOMPARE(vr->status(), Request::Finished);
+        QCOMPARE(vr->result().code(), Result::Succeeded);
+        QCOMPARE(vr->verificationStatus(), i % 2 ? CryptoManager::VerificationSucceeded
+                                                 : CryptoManager::VerificationFailed);
+    }
+
+    // the plugin does not support locking, which is reported consistently.
+    for (const QSharedPointer<Sailfish::Crypto::LockCodeRequest> &lcr : lockCodeRequests) {
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING((*lcr));
+        QCOMPARE(lcr->status(), Request::Finished);
+        if (lcr->lockCodeRequestType() == Sailfish::Crypto::LockCodeRequest::QueryLockStatus) {
+            QCOMPARE(lcr->result().code(), Result::Succeeded);
+            QCOMPARE(lcr->lockStatus(), Sailfish::Crypto::LockCodeRequest::Unsupported);
+        } else {
+            QCOMPARE(lcr->result().code(), Result::Failed);
+            QVERIFY(lcr->result().errorMessage().endsWith(QStringLiteral("does not support locking")));
+        }
+    }
+}
+
 void tst_cryptorequests::requestInterleaving()
 {
     // Repeatedly create and delete a collection, while performing
@@ -3627,6 +4091,22 @@ void tst_cryptorequests::exampleUsbTokenPlugin()
     QCOMPARE(lcr.result().code(), Sailfish::Crypto::Result::Succeeded);
     QCOMPARE(lcr.lockStatus(), Sailfish::Crypto::LockCodeRequest::Locked);
 
+    // the plugin info reports the current lock state of the plugin,
+    // even if it was reported differently before.
+    auto usbTokenPluginUnlocked = [this] () -> bool {
+        Sailfish::Crypto::PluginInfoRequest pir;
+        pir.setManager(&cm);
+        pir.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(pir);
+        for (const Sailfish::Crypto::PluginInfo &pi : pir.cryptoPlugins()) {
+            if (pi.name() == TEST_USB_TOKEN_PLUGIN_NAME) {
+                return pi.statusFlags().testFlag(Sailfish::Crypto::PluginInfo::PluginUnlocked);
+            }
+        }
+        return false;
+    };
+    QCOMPARE(usbTokenPluginUnlocked(), false);
+
     lcr.setLockCodeRequestType(Sailfish::Crypto::LockCodeRequest::ProvideLockCode);
     lcr.startRequest();
     WAIT_FOR_FINISHED_WITHOUT_BLOCKING(lcr);
@@ -3639,6 +4119,7 @@ void tst_cryptorequests::exampleUsbTokenPlugin()
     QCOMPARE(lcr.result().errorMessage(), QString());
     QCOMPARE(lcr.result().code(), Sailfish::Crypto::Result::Succeeded);
     QCOMPARE(lcr.lockStatus(), Sailfish::Crypto::LockCodeRequest::Unlocked);
+    QCOMPARE(usbTokenPluginUnlocked(), true);
 
     // third, attempt to retrieve the identifiers of keys stored by the plugin.
     // check that it reports the "Default" key in the "Default" collection.
@@ -3707,6 +4188,7 @@ void tst_cryptorequests::exampleUsbTokenPlugin()
     WAIT_FOR_FINISHED_WITHOUT_BLOCKING(lcr);
     QCOMPARE(lcr.result().errorMessage(), QString());
     QCOMPARE(lcr.result().code(), Sailfish::Crypto::Result::Succeeded);
+    QCOMPARE(usbTokenPluginUnlocked(), false);
 }
 
 #include "tst_cryptorequests.moc"
@@ -187,6 +187,123 @@ void tst_evp::testVerifyIncorrect()
     QCOMPARE(ok2, ok1);
 }
 
+/*!
+ * Tests that the key cache returns the same key for the same public key data,
+ * and that it releases keys when it is cleared or its capacity is reduced.
+ */
+void tst_evp::testKeyCache()
+{
+    OpenSslEvp::pkey_cache_clear();
+    QCOMPARE(OpenSslEvp::pkey_cache_count(), 0);
+
+    EVP_PKEY *pkey1 = OpenSslEvp::pkey_cache_read(publicKey.constData(), publicKey.length(), 0);
+    EVP_PKEY *pkey2 = OpenSslEvp::pkey_cache_read(publicKey.constData(), publicKey.length(), 0);
+    QVERIFY(pkey1 != nullptr);
+    QVERIFY(pkey1 == pkey2);
+    QCOMPARE(OpenSslEvp::pkey_cache_count(), 1);
+
+    // The private key data is not a public key.
+    QVERIFY(OpenSslEvp::pkey_cache_read(privateKey.constData(), privateKey.length(), 0) == nullptr);
+    QCOMPARE(OpenSslEvp::pkey_cache_count(), 1);
+
+    // Keys which are still in use remain usable once released by the cache.
+    OpenSslEvp::pkey_cache_set_capacity(0);
+    QCOMPARE(OpenSslEvp::pkey_cache_count(), 0);
+    OpenSslEvp::pkey_cache_set_capacity(16);
+
+    EVP_PKEY *privKey = OpenSslEvp::pkey_cache_read(privateKey.constData(), privateKey.length(), 1);
+    QVERIFY(privKey != nullptr);
+    QByteArray testData = generateTestData(512);
+    uint8_t *signature;
+    size_t signatureLength;
+    int r = OpenSslEvp::sign(EVP_sha256(), privKey, testData.data(), testData.length(), &signature, &signatureLength);
+    QCOMPARE(r, 1);
+    r = OpenSslEvp::verify(EVP_sha256(), pkey1, testData.data(), testData.length(), signature, signatureLength);
+    QCOMPARE(r, 1);
+    OPENSSL_free(signature);
+
+    EVP_PKEY_free(privKey);
+    EVP_PKEY_free(pkey1);
+    EVP_PKEY_free(pkey2);
+}
+
+/*!
+ * Tests that private keys are never kept by the key cache, so that
+ * none remains in memory once the callers have released them.
+ */
+void tst_evp::testKeyCachePrivateKeys()
+{
+    OpenSslEvp::pkey_cache_clear();
+
+    EVP_PKEY *pkey1 = OpenSslEvp::pkey_cache_read(privateKey.constData(), privateKey.length(), 1);
+    EVP_PKEY *pkey2 = OpenSslEvp::pkey_cache_read(privateKey.constData(), privateKey.length(), 1);
+    QVERIFY(pkey1 != nullptr);
+    QVERIFY(pkey2 != nullptr);
+    QVERIFY(pkey1 != pkey2);
+    QCOMPARE(OpenSslEvp::pkey_cache_count(), 0);
+
+    // Clearing the cache releases the public keys, and no private key remains.
+    EVP_PKEY *pubKey = OpenSslEvp::pkey_cache_read(publicKey.constData(), publicKey.length(), 0);
+    QVERIFY(pubKey != nullptr);
+    QCOMPARE(OpenSslEvp::pkey_cache_count(), 1);
+    OpenSslEvp::pkey_cache_clear();
+    QCOMPARE(OpenSslEvp::pkey_cache_count(), 0);
+
+    // Each private key is freed by its caller alone.
+    EVP_PKEY_free(pkey1);
+    EVP_PKEY_free(pkey2);
+    EVP_PKEY_free(pubKey);
+    QCOMPARE(OpenSslEvp::pkey_cache_count(), 0);
+}
+
+void tst_evp::benchmarkSignVerify_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("cold") << false;
+    QTest::newRow("warm") << true;
+}
+
+/*!
+ * Measures signing and verifying with keys which are read from PEM data
+ * for every operation (cold), or with the public key reused from the key
+ * cache (warm).  The private key is read from its PEM data in both cases.
+ */
+void tst_evp::benchmarkSignVerify()
+{
+    QFETCH(bool, cached);
+
+    QByteArray testData = generateTestData(512);
+    OpenSslEvp::pkey_cache_clear();
+
+    QBENCHMARK {
+        if (!cached) {
+            OpenSslEvp::pkey_cache_clear();
+        }
+
+        EVP_PKEY *privKey = OpenSslEvp::pkey_cache_read(privateKey.constData(), privateKey.length(), 1);
+        EVP_PKEY *pubKey = OpenSslEvp::pkey_cache_read(publicKey.constData(), publicKey.length(), 0);
+        QVERIFY(privKey != nullptr);
+        QVERIFY(pubKey != nullptr);
+
+        uint8_t *signature;
+        size_t signatureLength;
+        int r1 = OpenSslEvp::sign(EVP_sha256(), privKey, testData.data(), testData.length(), &signature, &signatureLength);
+        int r2 = r1 == 1
+                ? OpenSslEvp::verify(EVP_sha256(), pubKey, testData.data(), testData.length(), signature, signatureLength)
+                : -1;
+        if (r1 == 1) {
+            OPENSSL_free(signature);
+        }
+        EVP_PKEY_free(privKey);
+        EVP_PKEY_free(pubKey);
+        QCOMPARE(r1, 1);
+        QCOMPARE(r2, 1);
+    }
+
+    OpenSslEvp::pkey_cache_clear();
+}
+
 /*!
  * \brief Creates an SHA-256 signature using the OpenSSL command line.
  * \param data The data which needs to be signed.
@@ -32,6 +32,10 @@ private slots:
     void testSign();
     void testVerifyCorrect();
     void testVerifyIncorrect();
+    void testKeyCache();
+    void testKeyCachePrivateKeys();
+    void benchmarkSignVerify_data();
+    void benchmarkSignVerify();
 
 private:
     QByteArray generateTestData(size_t size);
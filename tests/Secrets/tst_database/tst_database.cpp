@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include <QtTest>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtCore/QDir>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QThreadPool>
+#include <QtCore/QSemaphore>
+#include <QtCore/QFuture>
+
+#include <QtConcurrent>
+
+#include "database_p.h"
+#include "SecretsImpl/metadatadb_p.h"
+
+using namespace Sailfish::Secrets;
+
+namespace {
+
+    const char *setupStatements[] = {
+        "\n PRAGMA journal_mode = WAL;",
+        NULL
+    };
+
+    const char *createStatements[] = {
+        "\n CREATE TABLE Items ("
+        "   ItemId INTEGER PRIMARY KEY,"
+        "   Name TEXT NOT NULL);",
+        NULL
+    };
+
+    Daemon::Sqlite::UpgradeOperation upgradeVersions[] = {
+        { 0, 0 },
+    };
+
+    const int currentSchemaVersion = 1;
+
+    bool insertItems(Daemon::Sqlite::Database *db, int first, int count)
+    {
+        Daemon::Sqlite::DatabaseLocker locker(db);
+
+        QString errorText;
+        Daemon::Sqlite::Database::Query iq = db->prepare(
+                    "INSERT INTO Items (ItemId, Name) VALUES (?, ?);", &errorText);
+        if (!errorText.isEmpty() || !db->beginTransaction()) {
+            return false;
+        }
+
+        for (int i = first; i < first + count; ++i) {
+            iq.bindValues(QVariantList() << i << QStringLiteral("item%1").arg(i));
+            if (!db->execute(iq, &errorText)) {
+                db->rollbackTransaction();
+                return false;
+            }
+        }
+
+        return db->commitTransaction();
+    }
+
+    // the caller determines which connection is read, by its locker.
+    int countItems(Daemon::Sqlite::Database *db)
+    {
+        QString errorText;
+        Daemon::Sqlite::Database::Query cq = db->prepare("SELECT Count(*) FROM Items;", &errorText);
+        if (!errorText.isEmpty() || !db->execute(cq, &errorText) || !cq.next()) {
+            return -1;
+        }
+        return cq.value(0).toInt();
+    }
+
+    // reads the collection names of the metadata database from several threads at once.
+    QVector<QStringList> readCollectionNamesConcurrently(Daemon::ApiImpl::MetadataDatabase *mdb)
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(Daemon::Sqlite::Database::MaximumReaderCount);
+
+        QVector<QFuture<QStringList> > futures;
+        for (int i = 0; i < Daemon::Sqlite::Database::MaximumReaderCount; ++i) {
+            futures.append(QtConcurrent::run(&pool, [mdb] {
+                QStringList names;
+                const Result result = mdb->collectionNames(&names, false);
+                return result.code() == Result::Succeeded ? names : QStringList();
+            }));
+        }
+
+        QVector<QStringList> results;
+        for (QFuture<QStringList> &future : futures) {
+            future.waitForFinished();
+            results.append(future.result());
+        }
+        return results;
+    }
+
+}
+
+class tst_database : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void concurrentReaders();
+    void readerSeesSnapshot();
+    void readersRekeyedAfterReencrypt();
+    void lockedDatabaseNotReadable();
+    void transactionWithinReadLocker();
+    void reopenedDatabaseReadsSnapshot();
+
+private:
+    bool openDatabase(Daemon::Sqlite::Database *db, const QString &connectionName);
+};
+
+void tst_database::initTestCase()
+{
+    // the databases are created within the test data location.
+    QStandardPaths::setTestModeEnabled(true);
+    cleanup();
+}
+
+void tst_database::cleanup()
+{
+    QDir(QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation)
+         + QLatin1String("/system/privileged/Secrets")).removeRecursively();
+}
+
+bool tst_database::openDatabase(Daemon::Sqlite::Database *db, const QString &connectionName)
+{
+    return db->open(QStringLiteral("QSQLITE"),
+                    connectionName,
+                    QStringLiteral("items.db"),
+                    setupStatements,
+                    createStatements,
+                    upgradeVersions,
+                    currentSchemaVersion,
+                    connectionName,
+                    true);
+}
+
+void tst_database::concurrentReaders()
+{
+    Daemon::Sqlite::Database db;
+    QVERIFY(openDatabase(&db, QStringLiteral("concurrentreaders")));
+    QVERIFY(insertItems(&db, 0, 10));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(Daemon::Sqlite::Database::MaximumReaderCount);
+
+    QSemaphore acquired;
+    QSemaphore proceed;
+    QVector<QFuture<int> > futures;
+    for (int i = 0; i < Daemon::Sqlite::Database::MaximumReaderCount; ++i) {
+        futures.append(QtConcurrent::run(&pool, [&db, &acquired, &proceed] {
+            Daemon::Sqlite::DatabaseReadLocker locker(&db);
+            acquired.release();
+            if (!proceed.tryAcquire(1, 5000)) {
+                return -1;
+            }
+            return countItems(&db);
+        }));
+    }
+
+    // every thread holds a reader at the same time: they are not serialized.
+    QVERIFY(acquired.tryAcquire(Daemon::Sqlite::Database::MaximumReaderCount, 5000));
+    proceed.release(Daemon::Sqlite::Database::MaximumReaderCount);
+
+    for (QFuture<int> &future : futures) {
+        future.waitForFinished();
+        QCOMPARE(future.result(), 10);
+    }
+}
+
+void tst_database::readerSeesSnapshot()
+{
+    Daemon::Sqlite::Database db;
+    QVERIFY(openDatabase(&db, QStringLiteral("readersnapshot")));
+    QVERIFY(insertItems(&db, 0, 10));
+
+    {
+        Daemon::Sqlite::DatabaseReadLocker locker(&db);
+        QCOMPARE(countItems(&db), 10);
+
+        // the writer is not blocked by the reader.
+        QFuture<bool> writer = QtConcurrent::run([&db] {
+            return insertItems(&db, 10, 5);
+        });
+        writer.waitForFinished();
+        QVERIFY(writer.result());
+
+        // the reader still sees the snapshot of its first read.
+        QCOMPARE(countItems(&db), 10);
+    }
+
+    // a new reader sees the committed rows.
+    Daemon::Sqlite::DatabaseReadLocker locker(&db);
+    QCOMPARE(countItems(&db), 15);
+}
+
+void tst_database::readersRekeyedAfterReencrypt()
+{
+    const QByteArray oldKey = QByteArray(32, '\x01').toHex();
+    const QByteArray newKey = QByteArray(32, '\x02').toHex();
+
+    Daemon::ApiImpl::MetadataDatabase mdb(QString(), QString(),
+                                          QStringLiteral("org.sailfishos.secrets.test.reencrypt"),
+                                          false, true);
+    QCOMPARE(mdb.unlock(oldKey).code(), Result::Succeeded);
+
+    // open the readers of the pool with the old key.
+    for (const QStringList &names : readCollectionNamesConcurrently(&mdb)) {
+        QCOMPARE(names, QStringList() << QStringLiteral("standalone"));
+    }
+
+    QCOMPARE(mdb.reencrypt(oldKey, newKey).code(), Result::Succeeded);
+
+    // the readers must have been reopened with the new key.
+    for (const QStringList &names : readCollectionNamesConcurrently(&mdb)) {
+        QCOMPARE(names, QStringList() << QStringLiteral("standalone"));
+    }
+
+    // and the database must now be opened with the new key.
+    QCOMPARE(mdb.lock().code(), Result::Succeeded);
+    QCOMPARE(mdb.unlock(newKey).code(), Result::Succeeded);
+    for (const QStringList &names : readCollectionNamesConcurrently(&mdb)) {
+        QCOMPARE(names, QStringList() << QStringLiteral("standalone"));
+    }
+}
+
+void tst_database::lockedDatabaseNotReadable()
+{
+    const QByteArray key = QByteArray(32, '\x03').toHex();
+
+    Daemon::ApiImpl::MetadataDatabase mdb(QString(), QString(),
+                                          QStringLiteral("org.sailfishos.secrets.test.locked"),
+                                          false, true);
+    QCOMPARE(mdb.unlock(key).code(), Result::Succeeded);
+
+    // leave unlocked readers idle in the pool.
+    for (const QStringList &names : readCollectionNamesConcurrently(&mdb)) {
+        QCOMPARE(names, QStringList() << QStringLiteral("standalone"));
+    }
+
+    QCOMPARE(mdb.lock().code(), Result::Succeeded);
+    bool locked = false;
+    QCOMPARE(mdb.isLocked(&locked).code(), Result::Succeeded);
+    QVERIFY(locked);
+
+    // none of the pooled readers may be used to read the locked database.
+    QStringList names;
+    QVERIFY(mdb.collectionNames(&names, false).code() != Result::Succeeded);
+    QVERIFY(names.isEmpty());
+    for (const QStringList &threadNames : readCollectionNamesConcurrently(&mdb)) {
+        QVERIFY(threadNames.isEmpty());
+    }
+}
+
+void tst_database::transactionWithinReadLocker()
+{
+    Daemon::Sqlite::Database db;
+    QVERIFY(openDatabase(&db, QStringLiteral("readlockertransaction")));
+    QVERIFY(insertItems(&db, 0, 10));
+
+    {
+        // the snapshot of a reader cannot be written to.
+        Daemon::Sqlite::DatabaseReadLocker locker(&db);
+        QVERIFY(!db.beginTransaction());
+        QVERIFY(!db.withinTransaction());
+        QCOMPARE(countItems(&db), 10);
+    }
+
+    // the thread can still write, and then read from a snapshot again.
+    QVERIFY(insertItems(&db, 10, 5));
+    Daemon::Sqlite::DatabaseReadLocker locker(&db);
+    QCOMPARE(countItems(&db), 15);
+    QFuture<bool> writer = QtConcurrent::run([&db] {
+        return insertItems(&db, 15, 5);
+    });
+    writer.waitForFinished();
+    QVERIFY(writer.result());
+    QCOMPARE(countItems(&db), 15);
+}
+
+void tst_database::reopenedDatabaseReadsSnapshot()
+{
+    Daemon::Sqlite::Database db;
+    QVERIFY(openDatabase(&db, QStringLiteral("reopened")));
+    QVERIFY(insertItems(&db, 0, 10));
+
+    {
+        // the database is closed while this thread is using it.
+        Daemon::Sqlite::DatabaseLocker locker(&db);
+        db.close();
+    }
+
+    // nothing of its previous use is remembered once it is reopened.
+    QVERIFY(openDatabase(&db, QStringLiteral("reopened")));
+    Daemon::Sqlite::DatabaseReadLocker locker(&db);
+    QCOMPARE(countItems(&db), 10);
+    QFuture<bool> writer = QtConcurrent::run([&db] {
+        return insertItems(&db, 10, 5);
+    });
+    writer.waitForFinished();
+    QVERIFY(writer.result());
+    QCOMPARE(countItems(&db), 10);
+}
+
+#include "tst_database.moc"
+QTEST_GUILESS_MAIN(tst_database)
@@ -0,0 +1,18 @@
+TEMPLATE = app
+TARGET = tst_database
+target.path = /opt/tests/Sailfish/Secrets/
+include($$PWD/../../../lib/libsailfishsecretspluginapi.pri)
+include($$PWD/../../../lib/libsailfishcrypto.pri)
+include($$PWD/../../../database/database.pri)
+QT += testlib sql dbus concurrent
+INSTALLS += target
+
+INCLUDEPATH += $$PWD/../../../daemon
+DEPENDPATH += $$PWD/../../../daemon
+
+HEADERS += \
+    $$PWD/../../../daemon/SecretsImpl/metadatadb_p.h
+
+SOURCES += \
+    $$PWD/../../../daemon/SecretsImpl/metadatadb.cpp \
+    $$PWD/tst_database.cpp
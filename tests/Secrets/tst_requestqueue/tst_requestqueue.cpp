@@ -0,0 +1,1104 @@
+/*
+ * Copyright (C) 2018 Jolla Ltd.
+ * Contact: Chris Adams <chris.adams@jollamobile.com>
+ * All rights reserved.
+ * BSD 3-Clause License, see LICENSE.
+ */
+
+#include <QtTest>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThreadPool>
+#include <QtCore/QSemaphore>
+#include <QtCore/QTimer>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QEventLoop>
+#include <QtCore/QProcess>
+#include <QtDBus/QDBusServer>
+#include <QtDBus/QDBusConnection>
+
+#include <QtConcurrent>
+
+#include <limits>
+#include <functional>
+
+#include "coalescedcalls_p.h"
+#include "pluginthreadpools_p.h"
+#include "requestqueue_p.h"
+#include "SecretsImpl/applicationpermissions_p.h"
+#include "storedkeycache_p.h"
+#include "taskexecutor_p.h"
+#include "tracing_p.h"
+
+Q_LOGGING_CATEGORY(lcSailfishSecretsDaemon, "org.sailfishos.secrets.daemon", QtWarningMsg)
+
+using namespace Sailfish::Secrets;
+
+namespace {
+
+    // a plugin call whose cost is negligible, as for a small digest.
+    QByteArray trivialPluginCall(const QByteArray &data)
+    {
+        return data;
+    }
+
+}
+
+// A request queue whose requests are all "asynchronous":
+// they remain in progress until the test finishes them.
+class TestRequestQueue : public Daemon::ApiImpl::RequestQueue
+{
+    Q_OBJECT
+
+public:
+    TestRequestQueue()
+        : Daemon::ApiImpl::RequestQueue(QStringLiteral("/Sailfish/Test"),
+                                        QStringLiteral("org.sailfishos.test"),
+                                        Q_NULLPTR,
+                                        true)
+        , finishedCount(0) { m_dbusObject = &dbusObject; }
+
+    enum TestRequestType {
+        NormalRequest = 1,
+        InteractiveRequest,
+        BulkRequest
+    };
+
+    void handlePendingRequest(Daemon::ApiImpl::RequestQueue::RequestData *request, bool *completed) Q_DECL_OVERRIDE
+    {
+        if (inProgress.isEmpty()) {
+            for (int priority = 0; priority < Daemon::ApiImpl::RequestQueue::RequestPriorityCount; ++priority) {
+                firstPendingCounts.append(pendingRequestCount(
+                        static_cast<Daemon::ApiImpl::RequestQueue::RequestPriority>(priority)));
+            }
+            firstQueueDepths = statistics().value(QStringLiteral("queues")).toMap();
+        }
+        inProgress.append(request->requestId);
+        startedClients.append(request->remotePid);
+        tracedRequestIds.append(Daemon::ApiImpl::Tracer::currentContext().requestId);
+        *completed = false;
+    }
+
+    void handleFinishedRequest(Daemon::ApiImpl::RequestQueue::RequestData *request, bool *completed) Q_DECL_OVERRIDE
+    {
+        lastResult = request->outParams.size() ? request->outParams.first().value<Result>() : Result();
+        ++finishedCount;
+        sendReply(request, request->message.createReply() << QVariant::fromValue<Result>(lastResult));
+        *completed = true;
+    }
+
+    QString requestTypeToString(int type) const Q_DECL_OVERRIDE
+    {
+        Q_UNUSED(type);
+        return QStringLiteral("TestRequest");
+    }
+
+    Daemon::ApiImpl::RequestQueue::RequestPriority requestPriority(int type) const Q_DECL_OVERRIDE
+    {
+        switch (type) {
+            case InteractiveRequest: return Daemon::ApiImpl::RequestQueue::InteractivePriority;
+            case BulkRequest:        return Daemon::ApiImpl::RequestQueue::BulkPriority;
+            default: break;
+        }
+        return Daemon::ApiImpl::RequestQueue::NormalPriority;
+    }
+
+    QString requestPluginName(int type, const QVariantList &inParams) const Q_DECL_OVERRIDE
+    {
+        Q_UNUSED(type);
+        return inParams.value(0).userType() == QMetaType::QString ? inParams.value(0).toString() : QString();
+    }
+
+    void requestRemoved(quint64 requestId) Q_DECL_OVERRIDE
+    {
+        coalescedCalls.requestRemoved(requestId);
+    }
+
+    void clientConnected(pid_t pid) Q_DECL_OVERRIDE
+    {
+        connectedClients.append(pid);
+    }
+
+    void clientDisconnected(pid_t pid) Q_DECL_OVERRIDE
+    {
+        disconnectedClients.append(pid);
+    }
+
+    int requestCount() const { return m_requests.size(); }
+
+    Result enqueueTestRequest(pid_t remotePid = 1, int type = NormalRequest, const QVariantList &inParams = QVariantList(),
+                              quint64 clientSequence = 0)
+    {
+        Daemon::ApiImpl::RequestQueue::RequestData *data = new Daemon::ApiImpl::RequestQueue::RequestData;
+        data->remotePid = remotePid;
+        data->type = type;
+        data->inParams = inParams;
+        data->clientSequence = clientSequence;
+        if (clientSequence) {
+            // as if received via the client connection.
+            data->deadline = nextClientDeadline(data->connection);
+            data->pipelineId = nextClientPipeline(data->connection);
+        }
+        Result result = enqueueRequest(data);
+        if (result.code() == Result::Failed) {
+            delete data;
+        }
+        return result;
+    }
+
+    void finishInProgressRequests()
+    {
+        for (quint64 requestId : inProgress) {
+            requestFinished(requestId, QVariantList());
+        }
+        inProgress.clear();
+    }
+
+    QVector<quint64> inProgress;
+    QVector<pid_t> startedClients;
+    QVector<quint64> tracedRequestIds;
+    QVector<int> firstPendingCounts;
+    QVariantMap firstQueueDepths;
+    Result lastResult;
+    int finishedCount;
+    Daemon::ApiImpl::CoalescedCalls coalescedCalls;
+    QVector<pid_t> connectedClients;
+    QVector<pid_t> disconnectedClients;
+    QObject dbusObject;
+};
+
+class tst_requestqueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void requestIdsAreUnique();
+    void finishUnknownRequest();
+    void finishOutOfOrder();
+    void priorityAndFairness();
+    void clientRequestLimit();
+    void clientQueuedBytesLimit();
+    void cancelPendingRequest();
+    void cancelInProgressRequest();
+    void expireRequest();
+    void pipelineRunsInOrder();
+    void pipelineCancelRequest();
+    void latencyHistogram();
+    void storedKeyCache();
+    void applicationIdCache();
+    void clientForgottenOnDisconnection();
+    void statistics();
+    void tracing();
+    void responsiveDuringPluginCall();
+    void pluginThreadPools();
+    void taskExecutor();
+    void coalescedPluginCall();
+    void enqueueAndComplete_data();
+    void enqueueAndComplete();
+    void pluginCallOverhead_data();
+    void pluginCallOverhead();
+
+private:
+    void processQueue(TestRequestQueue *queue, int expectedInProgress);
+};
+
+void tst_requestqueue::processQueue(TestRequestQueue *queue, int expectedInProgress)
+{
+    int maxIterations = 1000;
+    while (queue->inProgress.size() < expectedInProgress && maxIterations-- > 0) {
+        QCoreApplication::processEvents();
+    }
+}
+
+void tst_requestqueue::requestIdsAreUnique()
+{
+    TestRequestQueue queue;
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(queue.enqueueTestRequest().code(), Result::Succeeded);
+    }
+    QCOMPARE(queue.requestCount(), 3);
+
+    processQueue(&queue, 3);
+    QCOMPARE(queue.inProgress.size(), 3);
+    QVERIFY(queue.inProgress.at(0) != 0);
+    QVERIFY(queue.inProgress.at(0) < queue.inProgress.at(1));
+    QVERIFY(queue.inProgress.at(1) < queue.inProgress.at(2));
+
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.finishedCount, 3);
+}
+
+void tst_requestqueue::finishUnknownRequest()
+{
+    TestRequestQueue queue;
+    QTest::ignoreMessage(QtWarningMsg, "Unable to finish unknown request: 12345");
+    queue.requestFinished(12345, QVariantList());
+    QCOMPARE(queue.requestCount(), 0);
+}
+
+void tst_requestqueue::finishOutOfOrder()
+{
+    TestRequestQueue queue;
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(queue.enqueueTestRequest().code(), Result::Succeeded);
+    }
+    processQueue(&queue, 3);
+    QCOMPARE(queue.inProgress.size(), 3);
+
+    // finishing the last request must not wait for the others.
+    const quint64 lastRequestId = queue.inProgress.takeLast();
+    queue.requestFinished(lastRequestId, QVariantList());
+    QTRY_COMPARE(queue.finishedCount, 1);
+    QCOMPARE(queue.requestCount(), 2);
+
+    // finishing a request twice only replies once.
+    const quint64 firstRequestId = queue.inProgress.takeFirst();
+    queue.requestFinished(firstRequestId, QVariantList());
+    queue.requestFinished(firstRequestId, QVariantList());
+    QTRY_COMPARE(queue.finishedCount, 2);
+    QCOMPARE(queue.requestCount(), 1);
+
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.finishedCount, 3);
+}
+
+void tst_requestqueue::priorityAndFairness()
+{
+    TestRequestQueue queue;
+    // client 1 floods the queue, then the other clients enqueue a request each.
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(queue.enqueueTestRequest(1).code(), Result::Succeeded);
+    }
+    QCOMPARE(queue.enqueueTestRequest(2).code(), Result::Succeeded);
+    QCOMPARE(queue.enqueueTestRequest(3, TestRequestQueue::BulkRequest).code(), Result::Succeeded);
+    QCOMPARE(queue.enqueueTestRequest(4, TestRequestQueue::InteractiveRequest).code(), Result::Succeeded);
+    processQueue(&queue, 6);
+    QCOMPARE(queue.inProgress.size(), 6);
+
+    // the interactive request is started first, then the normal requests
+    // round-robin between clients, then the bulk request.
+    QCOMPARE(queue.startedClients, QVector<pid_t>() << 4 << 1 << 2 << 1 << 1 << 3);
+    QCOMPARE(queue.firstPendingCounts, QVector<int>() << 0 << 4 << 1);
+    for (int priority = 0; priority < Daemon::ApiImpl::RequestQueue::RequestPriorityCount; ++priority) {
+        QCOMPARE(queue.pendingRequestCount(static_cast<Daemon::ApiImpl::RequestQueue::RequestPriority>(priority)), 0);
+    }
+
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.finishedCount, 6);
+}
+
+void tst_requestqueue::clientRequestLimit()
+{
+    TestRequestQueue queue;
+    queue.setClientLimits(2, 1024);
+    QCOMPARE(queue.enqueueTestRequest(1).code(), Result::Succeeded);
+    QCOMPARE(queue.enqueueTestRequest(1).code(), Result::Succeeded);
+
+    // the third request from the same client is rejected with a hint.
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("is busy with")));
+    Result busy = queue.enqueueTestRequest(1);
+    QCOMPARE(busy.code(), Result::Failed);
+    QCOMPARE(busy.errorCode(), Result::SecretsDaemonBusyError);
+    QVERIFY(busy.retryAfter() > 0);
+
+    // other clients are unaffected.
+    QCOMPARE(queue.enqueueTestRequest(2).code(), Result::Succeeded);
+    processQueue(&queue, 3);
+    QCOMPARE(queue.inProgress.size(), 3);
+
+    // once the client's requests complete, it may enqueue again.
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.enqueueTestRequest(1).code(), Result::Succeeded);
+    processQueue(&queue, 1);
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+}
+
+void tst_requestqueue::clientQueuedBytesLimit()
+{
+    TestRequestQueue queue;
+    queue.setClientLimits(100, 10);
+    const QVariantList payload = QVariantList() << QVariant::fromValue<QByteArray>(QByteArray(8, 'a'));
+
+    // a single request larger than the limit is always accepted.
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest,
+                                      QVariantList() << QVariant::fromValue<QByteArray>(QByteArray(64, 'a'))).code(),
+             Result::Succeeded);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(QStringLiteral("is busy with")));
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, payload).errorCode(),
+             Result::SecretsDaemonBusyError);
+    QCOMPARE(queue.enqueueTestRequest(2, TestRequestQueue::NormalRequest, payload).code(), Result::Succeeded);
+
+    processQueue(&queue, 2);
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+}
+
+void tst_requestqueue::cancelPendingRequest()
+{
+    TestRequestQueue queue;
+    const QDBusConnection connection(QStringLiteral("org.sailfishos.secrets.daemon.invalidConnection"));
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), 1).code(), Result::Succeeded);
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), 2).code(), Result::Succeeded);
+
+    // a cancellation which names the wrong method is ignored.
+    queue.cancelRequest(connection, 1, QStringLiteral("getSecret"));
+    QCOMPARE(queue.requestCount(), 2);
+
+    // the canceled request is never started.
+    queue.cancelRequest(connection, 1, QString());
+    QCOMPARE(queue.requestCount(), 1);
+    processQueue(&queue, 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(queue.inProgress.size(), 1);
+
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.finishedCount, 1);
+}
+
+void tst_requestqueue::cancelInProgressRequest()
+{
+    TestRequestQueue queue;
+    const QDBusConnection connection(QStringLiteral("org.sailfishos.secrets.daemon.invalidConnection"));
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), 1).code(), Result::Succeeded);
+    processQueue(&queue, 1);
+    QCOMPARE(queue.inProgress.size(), 1);
+
+    // the work is allowed to complete, but is not replied to.
+    queue.cancelRequest(connection, 1, QString());
+    QCOMPARE(queue.requestCount(), 1);
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.finishedCount, 0);
+
+    // cancelling a request which no longer exists has no effect.
+    queue.cancelRequest(connection, 1, QString());
+    QCOMPARE(queue.requestCount(), 0);
+}
+
+void tst_requestqueue::expireRequest()
+{
+    TestRequestQueue queue;
+    const QDBusConnection connection(QStringLiteral("org.sailfishos.secrets.daemon.invalidConnection"));
+    queue.setNextRequestTimeout(connection, 1);
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), 1).code(), Result::Succeeded);
+    // the timeout applies to the next request only.
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), 2).code(), Result::Succeeded);
+    queue.setNextRequestTimeout(connection, 200);
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), 3).code(), Result::Succeeded);
+    QThread::msleep(10);
+
+    // the expired request is failed without being started.
+    processQueue(&queue, 2);
+    QTRY_COMPARE(queue.finishedCount, 1);
+    QCOMPARE(queue.lastResult.errorCode(), Result::RequestTimedOutError);
+    QCOMPARE(queue.inProgress.size(), 2);
+    QCOMPARE(queue.requestCount(), 2);
+    const quint64 secondRequestId = queue.inProgress.takeFirst();
+    const quint64 thirdRequestId = queue.inProgress.takeFirst();
+
+    // a request without a deadline may always take its next step.
+    QVERIFY(!queue.expireInProgressRequest(secondRequestId));
+
+    // once the deadline has passed, the next step of the request is not taken.
+    QVERIFY(!queue.expireInProgressRequest(thirdRequestId));
+    QThread::msleep(250);
+    QVERIFY(queue.expireInProgressRequest(thirdRequestId));
+    QTRY_COMPARE(queue.finishedCount, 2);
+    QCOMPARE(queue.lastResult.errorCode(), Result::RequestTimedOutError);
+    QCOMPARE(queue.requestCount(), 1);
+
+    queue.requestFinished(secondRequestId, QVariantList());
+    QTRY_COMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.finishedCount, 3);
+    QCOMPARE(queue.lastResult.code(), Result::Succeeded);
+}
+
+void tst_requestqueue::pipelineRunsInOrder()
+{
+    TestRequestQueue queue;
+    const QDBusConnection connection(QStringLiteral("org.sailfishos.secrets.daemon.invalidConnection"));
+    queue.setNextRequestPipeline(connection, 7);
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), 1).code(), Result::Succeeded);
+    // requests which are not tagged are not part of the pipeline, even while it is open.
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), 2).code(), Result::Succeeded);
+    for (int i = 3; i <= 4; ++i) {
+        queue.setNextRequestPipeline(connection, 7);
+        QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), i).code(), Result::Succeeded);
+    }
+    queue.endPipeline(connection, 7);
+
+    // only the first request of the pipeline is started.
+    processQueue(&queue, 2);
+    QCoreApplication::processEvents();
+    QCOMPARE(queue.inProgress.size(), 2);
+    const quint64 firstRequestId = queue.inProgress.takeFirst();
+    const quint64 otherRequestId = queue.inProgress.takeFirst();
+
+    // once it succeeds, the next one is started.
+    queue.requestFinished(firstRequestId, QVariantList());
+    processQueue(&queue, 1);
+    QCOMPARE(queue.inProgress.size(), 1);
+    QCOMPARE(queue.finishedCount, 1);
+    const quint64 secondRequestId = queue.inProgress.takeFirst();
+    QVERIFY(secondRequestId > firstRequestId);
+
+    // once it fails, the last one fails without being started.
+    queue.requestFinished(secondRequestId, QVariantList()
+                          << QVariant::fromValue<Result>(Result(Result::PermissionsError, QStringLiteral("denied"))));
+    QTRY_COMPARE(queue.finishedCount, 3);
+    QCOMPARE(queue.lastResult.errorCode(), Result::SecretsDaemonPipelineAbortedError);
+    QCoreApplication::processEvents();
+    QCOMPARE(queue.inProgress.size(), 0);
+    QCOMPARE(queue.requestCount(), 1);
+
+    // the request which is not part of the pipeline is unaffected.
+    queue.requestFinished(otherRequestId, QVariantList());
+    QTRY_COMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.finishedCount, 4);
+    QCOMPARE(queue.lastResult.code(), Result::Succeeded);
+}
+
+void tst_requestqueue::pipelineCancelRequest()
+{
+    TestRequestQueue queue;
+    const QDBusConnection connection(QStringLiteral("org.sailfishos.secrets.daemon.invalidConnection"));
+    for (int i = 1; i <= 3; ++i) {
+        queue.setNextRequestPipeline(connection, 7);
+        QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), i).code(), Result::Succeeded);
+    }
+    queue.endPipeline(connection, 7);
+    processQueue(&queue, 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(queue.inProgress.size(), 1);
+
+    // canceling a waiting request fails the requests after it, but not those before it.
+    queue.cancelRequest(connection, 2, QString());
+    QCOMPARE(queue.finishedCount, 1);
+    QCOMPARE(queue.lastResult.errorCode(), Result::SecretsDaemonPipelineAbortedError);
+    QCOMPARE(queue.requestCount(), 1);
+
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.finishedCount, 2);
+    QCOMPARE(queue.lastResult.code(), Result::Succeeded);
+    QCoreApplication::processEvents();
+    QCOMPARE(queue.inProgress.size(), 0);
+}
+
+void tst_requestqueue::latencyHistogram()
+{
+    Daemon::ApiImpl::LatencyHistogram histogram;
+    QCOMPARE(histogram.count(), Q_INT64_C(0));
+    QCOMPARE(histogram.valueAtPercentile(50.0), Q_INT64_C(0));
+
+    for (qint64 value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    QCOMPARE(histogram.count(), Q_INT64_C(1000));
+    QCOMPARE(histogram.minimum(), Q_INT64_C(1));
+    QCOMPARE(histogram.maximum(), Q_INT64_C(1000));
+    QCOMPARE(histogram.mean(), Q_INT64_C(500));
+
+    // small values are exact, larger values are within the bucket precision.
+    QCOMPARE(histogram.valueAtPercentile(1.0), Q_INT64_C(10));
+    const qint64 median = histogram.valueAtPercentile(50.0);
+    QVERIFY(median >= 500 && median <= 500 + 500 / 16);
+    const qint64 p99 = histogram.valueAtPercentile(99.0);
+    QVERIFY(p99 >= 990 && p99 <= 1000);
+    QCOMPARE(histogram.valueAtPercentile(100.0), Q_INT64_C(1000));
+
+    // negative and huge values are clamped rather than lost.
+    histogram.record(-5);
+    histogram.record(std::numeric_limits<qint64>::max());
+    QCOMPARE(histogram.count(), Q_INT64_C(1002));
+    QCOMPARE(histogram.minimum(), Q_INT64_C(0));
+    QVERIFY(histogram.maximum() > 1000);
+}
+
+void tst_requestqueue::storedKeyCache()
+{
+    typedef Sailfish::Secrets::Secret::Identifier Identifier;
+    const Identifier first(QStringLiteral("first"), QStringLiteral("collection"), QStringLiteral("plugin"));
+    const Identifier second(QStringLiteral("second"), QStringLiteral("collection"), QStringLiteral("plugin"));
+    const Identifier third(QStringLiteral("third"), QStringLiteral("other"), QStringLiteral("plugin"));
+    Sailfish::Secrets::Secret::FilterData filterData;
+    filterData.insert(QStringLiteral("test"), QStringLiteral("true"));
+
+    Daemon::ApiImpl::StoredKeyCache cache(2);
+    QCOMPARE(cache.capacity(), 2);
+
+    QByteArray key;
+    Sailfish::Secrets::Secret::FilterData data;
+    QVERIFY(!cache.lookup(QStringLiteral("app"), first, &key, &data));
+    cache.insert(QStringLiteral("app"), first, QByteArray("firstkey"), filterData, cache.generation());
+    QVERIFY(cache.lookup(QStringLiteral("app"), first, &key, &data));
+    QCOMPARE(key, QByteArray("firstkey"));
+    QCOMPARE(data, filterData);
+
+    // entries are not shared between applications.
+    QVERIFY(!cache.lookup(QStringLiteral("otherapp"), first, &key, &data));
+
+    // the least recently used entry is evicted when the cache is full.
+    cache.insert(QStringLiteral("app"), second, QByteArray("secondkey"), filterData, cache.generation());
+    QVERIFY(cache.lookup(QStringLiteral("app"), first, &key, &data));
+    cache.insert(QStringLiteral("app"), third, QByteArray("thirdkey"), filterData, cache.generation());
+    QCOMPARE(cache.count(), 2);
+    QVERIFY(!cache.lookup(QStringLiteral("app"), second, &key, &data));
+    QVERIFY(cache.lookup(QStringLiteral("app"), first, &key, &data));
+    QVERIFY(cache.lookup(QStringLiteral("app"), third, &key, &data));
+    QCOMPARE(key, QByteArray("thirdkey"));
+
+    // invalidating a collection leaves the keys of other collections.
+    cache.invalidate(Identifier(QString(), QStringLiteral("collection"), QStringLiteral("plugin")));
+    QVERIFY(!cache.lookup(QStringLiteral("app"), first, &key, &data));
+    QVERIFY(cache.lookup(QStringLiteral("app"), third, &key, &data));
+
+    // invalidating a plugin removes all of its keys.
+    cache.invalidate(Identifier(QString(), QString(), QStringLiteral("plugin")));
+    QCOMPARE(cache.count(), 0);
+
+    // a key read before an invalidation is not inserted.
+    const quint64 generation = cache.generation();
+    cache.invalidate(first);
+    cache.insert(QStringLiteral("app"), first, QByteArray("firstkey"), filterData, generation);
+    QCOMPARE(cache.count(), 0);
+
+    cache.insert(QStringLiteral("app"), first, QByteArray("firstkey"), filterData, cache.generation());
+    cache.insert(QStringLiteral("otherapp"), first, QByteArray("firstkey"), filterData, cache.generation());
+    QCOMPARE(cache.count(), 2);
+    cache.clear();
+    QCOMPARE(cache.count(), 0);
+    QVERIFY(!cache.lookup(QStringLiteral("app"), first, &key, &data));
+}
+
+void tst_requestqueue::applicationIdCache()
+{
+    Daemon::ApiImpl::ApplicationPermissions permissions;
+    QCOMPARE(permissions.applicationId(0), permissions.platformApplicationId());
+
+    QProcess process;
+    process.start(QStringLiteral("sleep"), QStringList() << QStringLiteral("30"));
+    QVERIFY(process.waitForStarted());
+    const pid_t pid = static_cast<pid_t>(process.processId());
+
+    // the identity of a process is resolved when its connection is remembered.
+    const QString applicationId = permissions.applicationId(pid);
+    const bool isPlatformApplication = permissions.applicationIsPlatformApplication(pid);
+    QVERIFY(!applicationId.isEmpty());
+    permissions.rememberApplication(pid);
+    permissions.rememberApplication(pid); // a second connection from the same process.
+    QCOMPARE(permissions.applicationId(pid), applicationId);
+
+    // and is then served without reading procfs, until every connection is forgotten.
+    process.kill();
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(permissions.applicationId(pid), applicationId);
+    QCOMPARE(permissions.applicationIsPlatformApplication(pid), isPlatformApplication);
+    permissions.forgetApplication(pid);
+    QCOMPARE(permissions.applicationId(pid), applicationId);
+    permissions.forgetApplication(pid);
+    QVERIFY(permissions.applicationId(pid).isEmpty());
+}
+
+void tst_requestqueue::clientForgottenOnDisconnection()
+{
+    TestRequestQueue queue;
+    QTemporaryDir socketDir;
+    QVERIFY(socketDir.isValid());
+    QDBusServer server(QStringLiteral("unix:tmpdir=%1").arg(socketDir.path()));
+    QVERIFY(server.isConnected());
+    QList<QDBusConnection> serverConnections;
+    connect(&server, &QDBusServer::newConnection, [&] (const QDBusConnection &connection) {
+        serverConnections.append(connection);
+        queue.handleClientConnection(connection);
+    });
+
+    const QString clientName = QStringLiteral("tst_requestqueue_client");
+    QVERIFY(QDBusConnection::connectToPeer(server.address(), clientName).isConnected());
+    QTRY_COMPARE(serverConnections.size(), 1);
+
+    // the client is identified by its first request.
+    const pid_t pid = static_cast<pid_t>(QCoreApplication::applicationPid());
+    Result result(Result::Succeeded);
+    queue.handleRequest(TestRequestQueue::NormalRequest, QVariantList(),
+                        serverConnections.first(), QDBusMessage(), result);
+    QCOMPARE(result.code(), Result::Succeeded);
+    queue.handleRequest(TestRequestQueue::NormalRequest, QVariantList(),
+                        serverConnections.first(), QDBusMessage(), result);
+    QCOMPARE(queue.connectedClients, QVector<pid_t>() << pid);
+
+    // and is forgotten when its connection is closed, without waiting
+    // for another client to connect.
+    QDBusConnection::disconnectFromPeer(clientName);
+    QTRY_COMPARE(queue.disconnectedClients, QVector<pid_t>() << pid);
+}
+
+void tst_requestqueue::statistics()
+{
+    TestRequestQueue queue;
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest,
+                                      QVariantList() << QStringLiteral("org.sailfishos.test.plugin")).code(),
+             Result::Succeeded);
+    QCOMPARE(queue.enqueueTestRequest(2).code(), Result::Succeeded);
+    processQueue(&queue, 2);
+    QThread::msleep(5);
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+
+    const QVariantMap statistics = queue.statistics();
+    const QVariantMap stages = statistics.value(QStringLiteral("requests")).toMap()
+                                         .value(QStringLiteral("TestRequest")).toMap();
+    QCOMPARE(stages.value(QStringLiteral("total")).toMap().value(QStringLiteral("count")).toLongLong(), Q_INT64_C(2));
+    QCOMPARE(stages.value(QStringLiteral("queued")).toMap().value(QStringLiteral("count")).toLongLong(), Q_INT64_C(2));
+    // the requests were in progress (asynchronously) for at least 5 msecs.
+    QVERIFY(stages.value(QStringLiteral("executing")).toMap().value(QStringLiteral("min")).toLongLong() >= 5000);
+
+    // only the request which names a plugin is attributed to one.
+    const QVariantMap plugins = statistics.value(QStringLiteral("plugins")).toMap();
+    QCOMPARE(plugins.size(), 1);
+    QCOMPARE(plugins.value(QStringLiteral("org.sailfishos.test.plugin")).toMap()
+                    .value(QStringLiteral("count")).toLongLong(), Q_INT64_C(1));
+
+    // the second request was still waiting when the first was started.
+    QCOMPARE(queue.firstQueueDepths.value(QStringLiteral("interactive")).toInt(), 0);
+    QCOMPARE(queue.firstQueueDepths.value(QStringLiteral("normal")).toInt(), 1);
+    QCOMPARE(queue.firstQueueDepths.value(QStringLiteral("bulk")).toInt(), 0);
+    QCOMPARE(statistics.value(QStringLiteral("queues")).toMap()
+                       .value(QStringLiteral("normal")).toInt(), 0);
+}
+
+namespace {
+    struct TestPlugin {
+        QString name() const { return QStringLiteral("org.sailfishos.test.plugin"); }
+    };
+}
+
+void tst_requestqueue::tracing()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.path() + QStringLiteral("/trace.json");
+    QVERIFY(Daemon::ApiImpl::Tracer::start(fileName));
+
+    TestRequestQueue queue;
+    QCOMPARE(queue.enqueueTestRequest().code(), Result::Succeeded);
+    processQueue(&queue, 1);
+    QCOMPARE(queue.inProgress.size(), 1);
+    const quint64 requestId = queue.inProgress.first();
+    // the request is the current context while it is handled.
+    QCOMPARE(queue.tracedRequestIds, QVector<quint64>() << requestId);
+    QCOMPARE(Daemon::ApiImpl::Tracer::currentContext().requestId, Q_UINT64_C(0));
+
+    {
+        // a plugin call made on behalf of the request, e.g. by a worker thread.
+        const Daemon::ApiImpl::TraceContextScope context(Daemon::ApiImpl::TraceContext(requestId, 42));
+        TestPlugin plugin;
+        const Daemon::ApiImpl::TraceSpan span("getSecret", &plugin);
+    }
+
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.requestCount(), 0);
+    Daemon::ApiImpl::Tracer::stop();
+    QVERIFY(!Daemon::ApiImpl::Tracer::isEnabled());
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    const QJsonArray events = QJsonDocument::fromJson(file.readAll(), &error).array();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    const QString id = QStringLiteral("0x") + QString::number(requestId, 16);
+    QStringList requestPhases;
+    QStringList handledStages;
+    bool sawPluginCall = false;
+    for (const QJsonValue &value : events) {
+        const QJsonObject event = value.toObject();
+        const QJsonObject args = event.value(QStringLiteral("args")).toObject();
+        const QString phase = event.value(QStringLiteral("ph")).toString();
+        if (event.value(QStringLiteral("id")).toString() == id) {
+            requestPhases.append(phase);
+        } else if (phase == QStringLiteral("X")
+                && args.value(QStringLiteral("requestId")).toDouble() == requestId) {
+            if (event.value(QStringLiteral("cat")).toString() == QStringLiteral("plugin")) {
+                QCOMPARE(event.value(QStringLiteral("name")).toString(),
+                         QStringLiteral("org.sailfishos.test.plugin: getSecret"));
+                QCOMPARE(args.value(QStringLiteral("cryptoRequestId")).toInt(), 42);
+                sawPluginCall = true;
+            } else {
+                handledStages.append(args.value(QStringLiteral("stage")).toString());
+            }
+        }
+    }
+    QCOMPARE(requestPhases, QStringList() << QStringLiteral("b") << QStringLiteral("e"));
+    QCOMPARE(handledStages, QStringList() << QStringLiteral("start") << QStringLiteral("finish"));
+    QVERIFY(sawPluginCall);
+}
+
+void tst_requestqueue::responsiveDuringPluginCall()
+{
+    // a plugin call is performed in a plugin thread and finishes its request
+    // via a future watcher, as the request processors do, so that the main loop
+    // keeps handling timers and other requests while the plugin call is in progress.
+    TestRequestQueue queue;
+    QThreadPool pluginThreadPool;
+    pluginThreadPool.setMaxThreadCount(1);
+    QSemaphore pluginCallStarted;
+    QSemaphore pluginCallReleased;
+
+    QCOMPARE(queue.enqueueTestRequest(1).code(), Result::Succeeded);
+    processQueue(&queue, 1);
+    QCOMPARE(queue.inProgress.size(), 1);
+    const quint64 slowRequestId = queue.inProgress.takeFirst();
+
+    QFutureWatcher<Result> watcher;
+    connect(&watcher, &QFutureWatcher<Result>::finished, [&queue, &watcher, slowRequestId] {
+        queue.requestFinished(slowRequestId, QVariantList() << QVariant::fromValue<Result>(watcher.future().result()));
+    });
+    watcher.setFuture(QtConcurrent::run(&pluginThreadPool, [&pluginCallStarted, &pluginCallReleased] () -> Result {
+        pluginCallStarted.release();
+        pluginCallReleased.acquire();
+        return Result(Result::Succeeded);
+    }));
+    pluginCallStarted.acquire();
+
+    bool timerFired = false;
+    QTimer::singleShot(0, [&timerFired] { timerFired = true; });
+    QCOMPARE(queue.enqueueTestRequest(2).code(), Result::Succeeded);
+    processQueue(&queue, 1);
+    QCOMPARE(queue.inProgress.size(), 1);
+    queue.finishInProgressRequests();
+    QTRY_COMPARE(queue.finishedCount, 1);
+    QTRY_VERIFY(timerFired);
+    QCOMPARE(queue.requestCount(), 1);
+
+    pluginCallReleased.release();
+    QTRY_COMPARE(queue.finishedCount, 2);
+    QCOMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.lastResult.code(), Result::Succeeded);
+}
+
+void tst_requestqueue::pluginThreadPools()
+{
+    // the calls to one plugin are performed one at a time, while calls to
+    // different plugins are performed in parallel.  An operation which spans
+    // all plugins (e.g. re-encryption) holds the barrier, and excludes both.
+    Daemon::ApiImpl::PluginThreadPools pools;
+    pools.addPlugin(QStringLiteral("first"));
+    pools.addPlugin(QStringLiteral("second"));
+    pools.addPlugin(QStringLiteral("first"));
+    QCOMPARE(pools.count(), 2);
+    QVERIFY(!pools.pool(QStringLiteral("unknown")));
+    QThreadPool *firstPool = pools.pool(QStringLiteral("first")).data();
+    QThreadPool *secondPool = pools.pool(QStringLiteral("second")).data();
+    QVERIFY(firstPool && secondPool && firstPool != secondPool);
+
+    // serialized: no two calls to the same plugin overlap.
+    QAtomicInt running;
+    QAtomicInt maxRunning;
+    QVector<QFuture<void> > futures;
+    for (int i = 0; i < 20; ++i) {
+        futures.append(QtConcurrent::run(firstPool, [&running, &maxRunning] {
+            const int nowRunning = running.fetchAndAddOrdered(1) + 1;
+            int previousMax = maxRunning.loadAcquire();
+            while (nowRunning > previousMax && !maxRunning.testAndSetOrdered(previousMax, nowRunning)) {
+                previousMax = maxRunning.loadAcquire();
+            }
+            QThread::msleep(1);
+            running.fetchAndAddOrdered(-1);
+        }));
+    }
+    for (QFuture<void> &future : futures) {
+        future.waitForFinished();
+    }
+    QCOMPARE(maxRunning.loadAcquire(), 1);
+
+    // parallel: a call to one plugin can only finish once a call to the
+    // other plugin has started, which would dead-lock if they were serialized.
+    QSemaphore firstStarted, secondStarted;
+    QFuture<bool> firstCall = QtConcurrent::run(firstPool, [&firstStarted, &secondStarted] () -> bool {
+        firstStarted.release();
+        return secondStarted.tryAcquire(1, 5000);
+    });
+    QFuture<bool> secondCall = QtConcurrent::run(secondPool, [&firstStarted, &secondStarted] () -> bool {
+        secondStarted.release();
+        return firstStarted.tryAcquire(1, 5000);
+    });
+    QVERIFY(firstCall.result());
+    QVERIFY(secondCall.result());
+
+    // barrier: calls queued before it are performed before the exclusive
+    // operation, and calls queued after it are performed after it.
+    QSemaphore earlierCallReleased;
+    QAtomicInt earlierCallsFinished;
+    QAtomicInt laterCallsStarted;
+    QtConcurrent::run(firstPool, [&earlierCallReleased, &earlierCallsFinished] {
+        earlierCallReleased.acquire();
+        earlierCallsFinished.fetchAndAddOrdered(1);
+    });
+    QtConcurrent::run(secondPool, [&earlierCallsFinished] {
+        earlierCallsFinished.fetchAndAddOrdered(1);
+    });
+    const QSharedPointer<Daemon::ApiImpl::PluginThreadPoolBarrier> barrier = pools.barrier();
+    QFuture<void> laterFirst = QtConcurrent::run(firstPool, [&laterCallsStarted] {
+        laterCallsStarted.fetchAndAddOrdered(1);
+    });
+    QFuture<void> laterSecond = QtConcurrent::run(secondPool, [&laterCallsStarted] {
+        laterCallsStarted.fetchAndAddOrdered(1);
+    });
+
+    QThreadPool exclusivePool;
+    QAtomicInt earlierCallsFinishedBeforeExclusive(-1);
+    QAtomicInt laterCallsStartedDuringExclusive(-1);
+    QSemaphore exclusiveReleased;
+    QFuture<void> exclusive = QtConcurrent::run(&exclusivePool, [&] {
+        const Daemon::ApiImpl::PluginThreadPoolBarrier::Scope scope(barrier);
+        earlierCallsFinishedBeforeExclusive.storeRelease(earlierCallsFinished.loadAcquire());
+        exclusiveReleased.acquire();
+        laterCallsStartedDuringExclusive.storeRelease(laterCallsStarted.loadAcquire());
+    });
+
+    // the exclusive operation waits for the call which is still in progress.
+    QThread::msleep(50);
+    QCOMPARE(earlierCallsFinishedBeforeExclusive.loadAcquire(), -1);
+    earlierCallReleased.release();
+    QTRY_COMPARE(earlierCallsFinishedBeforeExclusive.loadAcquire(), 2);
+
+    // the calls queued after the barrier wait for the exclusive operation.
+    QThread::msleep(50);
+    QCOMPARE(laterCallsStarted.loadAcquire(), 0);
+    exclusiveReleased.release();
+    exclusive.waitForFinished();
+    QCOMPARE(laterCallsStartedDuringExclusive.loadAcquire(), 0);
+    laterFirst.waitForFinished();
+    laterSecond.waitForFinished();
+    QCOMPARE(laterCallsStarted.loadAcquire(), 2);
+}
+
+void tst_requestqueue::taskExecutor()
+{
+    // the completions are invoked in the thread of the executor, in the order
+    // in which the serial pool performed the functions.  The tasks are recycled,
+    // and must not carry the state of one call over to the next.
+    Daemon::ApiImpl::TaskExecutor executor;
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    QStringList results;
+    int completedInExecutorThread = 0;
+    for (int i = 0; i < 100; ++i) {
+        const QString value = QString::number(i);
+        executor.run(&pool,
+                     [value] () -> QString { return value + value; },
+                     [&results, &completedInExecutorThread, &executor] (QString result) {
+            results.append(result);
+            if (QThread::currentThread() == executor.thread()) {
+                ++completedInExecutorThread;
+            }
+        });
+    }
+
+    QTRY_COMPARE(results.size(), 100);
+    QCOMPARE(completedInExecutorThread, 100);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(results.at(i), QString::number(i) + QString::number(i));
+    }
+
+    // a task which is performed after the executor is destroyed is discarded.
+    QSemaphore released;
+    bool completed = false;
+    {
+        Daemon::ApiImpl::TaskExecutor shortLivedExecutor;
+        shortLivedExecutor.run(&pool,
+                               [&released] () -> int { released.acquire(); return 1; },
+                               [&completed] (int) { completed = true; });
+    }
+    released.release();
+    pool.waitForDone();
+    QCoreApplication::processEvents();
+    QVERIFY(!completed);
+}
+
+void tst_requestqueue::coalescedPluginCall()
+{
+    // identical requests (e.g. for the collection names, plugin info or stored
+    // key identifiers) which arrive before the plugin is invoked share a single
+    // invocation, as in the request processor, and each is finished with its result.
+    TestRequestQueue queue;
+    Daemon::ApiImpl::TaskExecutor executor;
+    QThreadPool pluginThreadPool;
+    pluginThreadPool.setMaxThreadCount(1);
+    QAtomicInt invocations;
+    QSemaphore pluginThreadReleased;
+    QSemaphore pluginCallStarted;
+    QSemaphore pluginCallReleased;
+    const QString key(QStringLiteral("CollectionNames:org.sailfishos.secrets.plugin.storage.test"));
+
+    QSharedPointer<Daemon::ApiImpl::CoalescedCalls::Call> sharedCall;
+    const auto invokePlugin = [&] (quint64 requestId) {
+        bool joined = false;
+        const QSharedPointer<Daemon::ApiImpl::CoalescedCalls::Call> call = queue.coalescedCalls.join(key, requestId, &joined);
+        if (joined) {
+            return;
+        }
+        sharedCall = call;
+        executor.run(&pluginThreadPool, [call, &invocations, &pluginCallStarted, &pluginCallReleased] () -> Result {
+            call->started.storeRelease(1);
+            invocations.fetchAndAddOrdered(1);
+            pluginCallStarted.release();
+            pluginCallReleased.acquire();
+            return Result(Result::Succeeded);
+        }, [&queue, key, call] (Result result) {
+            for (quint64 requestId : queue.coalescedCalls.finish(key, call)) {
+                queue.requestFinished(requestId, QVariantList() << QVariant::fromValue<Result>(result));
+            }
+        });
+    };
+
+    // keep the plugin thread busy, so that the invocation cannot start yet.
+    executor.run(&pluginThreadPool,
+                 [&pluginThreadReleased] () -> int { pluginThreadReleased.acquire(); return 0; },
+                 [] (int) {});
+
+    const QDBusConnection connection(QStringLiteral("org.sailfishos.secrets.daemon.invalidConnection"));
+    QCOMPARE(queue.enqueueTestRequest(1, TestRequestQueue::NormalRequest, QVariantList(), 1).code(), Result::Succeeded);
+    QCOMPARE(queue.enqueueTestRequest(2, TestRequestQueue::NormalRequest, QVariantList(), 2).code(), Result::Succeeded);
+    queue.setNextRequestTimeout(connection, 50);
+    QCOMPARE(queue.enqueueTestRequest(3, TestRequestQueue::NormalRequest, QVariantList(), 3).code(), Result::Succeeded);
+    processQueue(&queue, 3);
+    QCOMPARE(queue.inProgress.size(), 3);
+    for (quint64 requestId : queue.inProgress) {
+        invokePlugin(requestId);
+    }
+    const quint64 expiringRequestId = queue.inProgress.last();
+    queue.inProgress.clear();
+    QVERIFY(sharedCall);
+    QCOMPARE(sharedCall->requestIds.size(), 3);
+    QCOMPARE(queue.coalescedCalls.count(), 1);
+
+    // a request which expires is dropped from the invocation it joined,
+    // so that it is not finished again once the invocation completes.
+    QThread::msleep(100);
+    QVERIFY(queue.expireInProgressRequest(expiringRequestId));
+    QTRY_COMPARE(queue.finishedCount, 1);
+    QCOMPARE(queue.lastResult.errorCode(), Result::RequestTimedOutError);
+    QCOMPARE(sharedCall->requestIds.size(), 2);
+    QVERIFY(!sharedCall->requestIds.contains(expiringRequestId));
+
+    // a request which arrives once the invocation has started is not
+    // given its (possibly stale) result, but causes another invocation.
+    pluginThreadReleased.release();
+    pluginCallStarted.acquire();
+    QCOMPARE(queue.enqueueTestRequest(4).code(), Result::Succeeded);
+    processQueue(&queue, 1);
+    QCOMPARE(queue.inProgress.size(), 1);
+    invokePlugin(queue.inProgress.takeFirst());
+    QCOMPARE(queue.coalescedCalls.count(), 1);
+
+    pluginCallReleased.release(2);
+    QTRY_COMPARE(queue.finishedCount, 4);
+    QCOMPARE(invocations.loadAcquire(), 2);
+    QCOMPARE(queue.lastResult.code(), Result::Succeeded);
+    QCOMPARE(queue.requestCount(), 0);
+    QCOMPARE(queue.coalescedCalls.count(), 0);
+}
+
+void tst_requestqueue::enqueueAndComplete_data()
+{
+    QTest::addColumn<int>("requestCount");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("100000") << 100000;
+}
+
+void tst_requestqueue::enqueueAndComplete()
+{
+    QFETCH(int, requestCount);
+
+    TestRequestQueue queue;
+    queue.setClientLimits(std::numeric_limits<int>::max(), std::numeric_limits<qint64>::max());
+    QBENCHMARK {
+        queue.finishedCount = 0;
+        for (int i = 0; i < requestCount; ++i) {
+            queue.enqueueTestRequest();
+        }
+        processQueue(&queue, requestCount);
+        queue.finishInProgressRequests();
+        while (queue.requestCount() > 0) {
+            QCoreApplication::processEvents();
+        }
+    }
+
+    QCOMPARE(queue.finishedCount, requestCount);
+}
+
+void tst_requestqueue::pluginCallOverhead_data()
+{
+    QTest::addColumn<bool>("useTaskExecutor");
+
+    QTest::newRow("QtConcurrent and QFutureWatcher") << false;
+    QTest::newRow("TaskExecutor") << true;
+}
+
+void tst_requestqueue::pluginCallOverhead()
+{
+    // the round trip of a trivial plugin call from the main thread,
+    // to the plugin thread, and back to the main thread.
+    QFETCH(bool, useTaskExecutor);
+
+    const int callCount = 1000;
+    const QByteArray data("data");
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+    pool.setExpiryTimeout(-1);
+    Daemon::ApiImpl::TaskExecutor executor;
+    QObject context;
+    int completedCount = 0;
+    QBENCHMARK {
+        QEventLoop loop;
+        int completed = 0;
+        for (int i = 0; i < callCount; ++i) {
+            if (useTaskExecutor) {
+                executor.run(&pool,
+                             std::bind(&trivialPluginCall, data),
+                             [&completed, &loop, callCount] (QByteArray result) {
+                    Q_UNUSED(result);
+                    if (++completed == callCount) {
+                        loop.quit();
+                    }
+                });
+            } else {
+                QFutureWatcher<QByteArray> *watcher = new QFutureWatcher<QByteArray>(&context);
+                QFuture<QByteArray> future = QtConcurrent::run(&pool, &trivialPluginCall, data);
+                connect(watcher, &QFutureWatcher<QByteArray>::finished, [&completed, &loop, callCount, watcher] {
+                    watcher->deleteLater();
+                    QByteArray result = watcher->future().result();
+                    Q_UNUSED(result);
+                    if (++completed == callCount) {
+                        loop.quit();
+                    }
+                });
+                watcher->setFuture(future);
+            }
+        }
+        loop.exec();
+        completedCount = completed;
+    }
+
+    QCOMPARE(completedCount, callCount);
+}
+
+#include "tst_requestqueue.moc"
+QTEST_GUILESS_MAIN(tst_requestqueue)
@@ -0,0 +1,33 @@
+TEMPLATE = app
+TARGET = tst_requestqueue
+target.path = /opt/tests/Sailfish/Secrets/
+include($$PWD/../../../lib/libsailfishsecretspluginapi.pri)
+include($$PWD/../../../lib/libsailfishcrypto.pri)
+QT += testlib dbus concurrent
+CONFIG += link_pkgconfig
+PKGCONFIG += dbus-1
+INSTALLS += target
+
+INCLUDEPATH += $$PWD/../../../daemon
+DEPENDPATH += $$PWD/../../../daemon
+
+HEADERS += \
+    $$PWD/../../../daemon/coalescedcalls_p.h \
+    $$PWD/../../../daemon/latencyhistogram_p.h \
+    $$PWD/../../../daemon/pluginthreadpools_p.h \
+    $$PWD/../../../daemon/requestqueue_p.h \
+    $$PWD/../../../daemon/SecretsImpl/applicationpermissions_p.h \
+    $$PWD/../../../daemon/storedkeycache_p.h \
+    $$PWD/../../../daemon/taskexecutor_p.h \
+    $$PWD/../../../daemon/tracing_p.h
+
+SOURCES += \
+    $$PWD/../../../daemon/coalescedcalls.cpp \
+    $$PWD/../../../daemon/latencyhistogram.cpp \
+    $$PWD/../../../daemon/pluginthreadpools.cpp \
+    $$PWD/../../../daemon/requestqueue.cpp \
+    $$PWD/../../../daemon/SecretsImpl/applicationpermissions.cpp \
+    $$PWD/../../../daemon/storedkeycache.cpp \
+    $$PWD/../../../daemon/taskexecutor.cpp \
+    $$PWD/../../../daemon/tracing.cpp \
+    $$PWD/tst_requestqueue.cpp
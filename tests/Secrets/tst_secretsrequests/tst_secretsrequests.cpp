@@ -19,12 +19,16 @@
 #include "Secrets/createcollectionrequest.h"
 #include "Secrets/deletecollectionrequest.h"
 #include "Secrets/deletesecretrequest.h"
+#include "Secrets/deletesecretsrequest.h"
 #include "Secrets/findsecretsrequest.h"
 #include "Secrets/interactionrequest.h"
 #include "Secrets/lockcoderequest.h"
 #include "Secrets/plugininforequest.h"
+#include "Secrets/requestpipeline.h"
 #include "Secrets/storedsecretrequest.h"
+#include "Secrets/storedsecretsrequest.h"
 #include "Secrets/storesecretrequest.h"
+#include "Secrets/storesecretsrequest.h"
 
 using namespace Sailfish::Secrets;
 
@@ -56,6 +60,11 @@ private slots:
 
     void devicelockCollection();
     void devicelockCollectionSecret();
+    void devicelockCollectionSecrets();
+    void devicelockStoreCollectionSecrets();
+    void devicelockDeleteCollectionSecrets();
+    void devicelockRequestPipeline();
+    void devicelockMetadataConsistency();
     void devicelockStandaloneSecret();
 
     void customlockCollection();
@@ -392,6 +401,614 @@ void tst_secretsrequests::devicelockCollectionSecret()
 }
 
 
+void tst_secretsrequests::devicelockCollectionSecrets()
+{
+    // create a collection in the storage plugin, and one in the encrypted storage plugin
+    const QStringList storagePluginNames { DEFAULT_TEST_STORAGE_PLUGIN, DEFAULT_TEST_ENCRYPTEDSTORAGE_PLUGIN };
+    const QStringList encryptionPluginNames { DEFAULT_TEST_ENCRYPTION_PLUGIN, DEFAULT_TEST_ENCRYPTEDSTORAGE_PLUGIN };
+    for (int i = 0; i < storagePluginNames.size(); ++i) {
+        CreateCollectionRequest ccr;
+        ccr.setManager(&sm);
+        ccr.setCollectionLockType(CreateCollectionRequest::DeviceLock);
+        ccr.setCollectionName(QLatin1String("testcollection"));
+        ccr.setStoragePluginName(storagePluginNames.at(i));
+        ccr.setEncryptionPluginName(encryptionPluginNames.at(i));
+        ccr.setDeviceLockUnlockSemantic(SecretManager::DeviceLockKeepUnlocked);
+        ccr.setAccessControlMode(SecretManager::OwnerOnlyMode);
+        ccr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ccr);
+        QCOMPARE(ccr.status(), Request::Finished);
+        QCOMPARE(ccr.result().code(), Result::Succeeded);
+    }
+
+    // store two secrets into each collection
+    QVector<Secret> testSecrets;
+    for (int i = 0; i < 4; ++i) {
+        Secret testSecret(Secret::Identifier(
+                            QStringLiteral("testsecretname%1").arg(i),
+                            QLatin1String("testcollection"),
+                            storagePluginNames.at(i % 2)));
+        testSecret.setData(QStringLiteral("testsecretvalue%1").arg(i).toUtf8());
+        testSecret.setType(Secret::TypeBlob);
+        testSecret.setFilterData(QLatin1String("test"), QString::number(i));
+
+        StoreSecretRequest ssr;
+        ssr.setManager(&sm);
+        ssr.setSecretStorageType(StoreSecretRequest::CollectionSecret);
+        ssr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        ssr.setSecret(testSecret);
+        ssr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+        QCOMPARE(ssr.status(), Request::Finished);
+        QCOMPARE(ssr.result().code(), Result::Succeeded);
+        testSecrets.append(testSecret);
+    }
+
+    // retrieve the secrets in a different order to that in which they were
+    // stored, ensure that they are returned in the requested order
+    QVector<Secret::Identifier> identifiers;
+    identifiers << testSecrets.at(3).identifier()
+                << testSecrets.at(0).identifier()
+                << testSecrets.at(1).identifier()
+                << testSecrets.at(2).identifier();
+
+    StoredSecretsRequest gsr;
+    gsr.setManager(&sm);
+    QSignalSpy gsrss(&gsr, &StoredSecretsRequest::statusChanged);
+    gsr.setIdentifiers(identifiers);
+    QCOMPARE(gsr.identifiers(), identifiers);
+    gsr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+    QCOMPARE(gsr.userInteractionMode(), SecretManager::ApplicationInteraction);
+    QCOMPARE(gsr.status(), Request::Inactive);
+    gsr.startRequest();
+    QCOMPARE(gsrss.count(), 1);
+    QCOMPARE(gsr.status(), Request::Active);
+    QCOMPARE(gsr.result().code(), Result::Pending);
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+    QCOMPARE(gsrss.count(), 2);
+    QCOMPARE(gsr.status(), Request::Finished);
+    QCOMPARE(gsr.result().code(), Result::Succeeded);
+    QCOMPARE(gsr.secrets().size(), identifiers.size());
+    for (int i = 0; i < identifiers.size(); ++i) {
+        const Secret &secret(gsr.secrets().at(i));
+        const Secret &testSecret(*std::find_if(testSecrets.constBegin(), testSecrets.constEnd(),
+                                               [&] (const Secret &s) { return s.identifier() == identifiers.at(i); }));
+        QCOMPARE(secret.identifier(), identifiers.at(i));
+        QCOMPARE(secret.data(), testSecret.data());
+        QCOMPARE(secret.type(), testSecret.type());
+        QCOMPARE(secret.filterData(), testSecret.filterData());
+    }
+
+    // the whole request fails if any of the secrets does not exist
+    identifiers << Secret::Identifier(QLatin1String("missingsecretname"),
+                                      QLatin1String("testcollection"),
+                                      DEFAULT_TEST_STORAGE_PLUGIN);
+    gsr.setIdentifiers(identifiers);
+    gsr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+    QCOMPARE(gsr.status(), Request::Finished);
+    QCOMPARE(gsr.result().code(), Result::Failed);
+    QVERIFY(gsr.secrets().isEmpty());
+
+    // standalone secrets cannot be retrieved in a batch
+    gsr.setIdentifiers(QVector<Secret::Identifier>()
+                       << Secret::Identifier(QLatin1String("testsecretname0"),
+                                             QString(),
+                                             DEFAULT_TEST_STORAGE_PLUGIN));
+    gsr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+    QCOMPARE(gsr.status(), Request::Finished);
+    QCOMPARE(gsr.result().code(), Result::Failed);
+    QCOMPARE(gsr.result().errorCode(), Result::InvalidSecretIdentifierError);
+
+    // finally, clean up the collections
+    for (const QString &storagePluginName : storagePluginNames) {
+        DeleteCollectionRequest dcr;
+        dcr.setManager(&sm);
+        dcr.setCollectionName(QLatin1String("testcollection"));
+        dcr.setStoragePluginName(storagePluginName);
+        dcr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        dcr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dcr);
+        QCOMPARE(dcr.status(), Request::Finished);
+        QCOMPARE(dcr.result().code(), Result::Succeeded);
+    }
+}
+
+void tst_secretsrequests::devicelockStoreCollectionSecrets()
+{
+    const QStringList storagePluginNames { DEFAULT_TEST_STORAGE_PLUGIN, DEFAULT_TEST_ENCRYPTEDSTORAGE_PLUGIN };
+    const QStringList encryptionPluginNames { DEFAULT_TEST_ENCRYPTION_PLUGIN, DEFAULT_TEST_ENCRYPTEDSTORAGE_PLUGIN };
+    for (int i = 0; i < storagePluginNames.size(); ++i) {
+        // create a collection
+        CreateCollectionRequest ccr;
+        ccr.setManager(&sm);
+        ccr.setCollectionLockType(CreateCollectionRequest::DeviceLock);
+        ccr.setCollectionName(QLatin1String("testcollection"));
+        ccr.setStoragePluginName(storagePluginNames.at(i));
+        ccr.setEncryptionPluginName(encryptionPluginNames.at(i));
+        ccr.setDeviceLockUnlockSemantic(SecretManager::DeviceLockKeepUnlocked);
+        ccr.setAccessControlMode(SecretManager::OwnerOnlyMode);
+        ccr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ccr);
+        QCOMPARE(ccr.status(), Request::Finished);
+        QCOMPARE(ccr.result().code(), Result::Succeeded);
+
+        // store some secrets into the collection in one request
+        QVector<Secret> testSecrets;
+        for (int j = 0; j < 3; ++j) {
+            Secret testSecret(Secret::Identifier(
+                                QStringLiteral("testsecretname%1").arg(j),
+                                QLatin1String("testcollection"),
+                                storagePluginNames.at(i)));
+            testSecret.setData(QStringLiteral("testsecretvalue%1").arg(j).toUtf8());
+            testSecret.setType(Secret::TypeBlob);
+            testSecret.setFilterData(QLatin1String("test"), QString::number(j));
+            testSecrets.append(testSecret);
+        }
+
+        StoreSecretsRequest ssr;
+        ssr.setManager(&sm);
+        QSignalSpy ssrss(&ssr, &StoreSecretsRequest::statusChanged);
+        ssr.setSecrets(testSecrets);
+        QCOMPARE(ssr.secrets(), testSecrets);
+        ssr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        QCOMPARE(ssr.userInteractionMode(), SecretManager::ApplicationInteraction);
+        QCOMPARE(ssr.status(), Request::Inactive);
+        ssr.startRequest();
+        QCOMPARE(ssrss.count(), 1);
+        QCOMPARE(ssr.status(), Request::Active);
+        QCOMPARE(ssr.result().code(), Result::Pending);
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+        QCOMPARE(ssrss.count(), 2);
+        QCOMPARE(ssr.status(), Request::Finished);
+        QCOMPARE(ssr.result().code(), Result::Succeeded);
+        QCOMPARE(ssr.results().size(), testSecrets.size());
+        for (const Result &result : ssr.results()) {
+            QCOMPARE(result.code(), Result::Succeeded);
+        }
+
+        // ensure that the secrets were stored
+        QVector<Secret::Identifier> identifiers;
+        for (const Secret &testSecret : testSecrets) {
+            identifiers.append(testSecret.identifier());
+        }
+        StoredSecretsRequest gsr;
+        gsr.setManager(&sm);
+        gsr.setIdentifiers(identifiers);
+        gsr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        gsr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+        QCOMPARE(gsr.status(), Request::Finished);
+        QCOMPARE(gsr.result().code(), Result::Succeeded);
+        QCOMPARE(gsr.secrets().size(), testSecrets.size());
+        for (int j = 0; j < testSecrets.size(); ++j) {
+            QCOMPARE(gsr.secrets().at(j).identifier(), testSecrets.at(j).identifier());
+            QCOMPARE(gsr.secrets().at(j).data(), testSecrets.at(j).data());
+            QCOMPARE(gsr.secrets().at(j).filterData(), testSecrets.at(j).filterData());
+        }
+
+        // storing a secret which already exists fails the whole request,
+        // and the result of that secret reports the error.
+        Secret newSecret(Secret::Identifier(
+                            QLatin1String("newsecretname"),
+                            QLatin1String("testcollection"),
+                            storagePluginNames.at(i)));
+        newSecret.setData(QByteArrayLiteral("newsecretvalue"));
+        ssr.setSecrets(QVector<Secret>() << newSecret << testSecrets.at(1));
+        ssr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+        QCOMPARE(ssr.status(), Request::Finished);
+        QCOMPARE(ssr.result().code(), Result::Failed);
+        QCOMPARE(ssr.result().errorCode(), Result::SecretAlreadyExistsError);
+        QCOMPARE(ssr.results().size(), 2);
+        QCOMPARE(ssr.results().at(0).code(), Result::Succeeded);
+        QCOMPARE(ssr.results().at(1).code(), Result::Failed);
+        QCOMPARE(ssr.results().at(1).errorCode(), Result::SecretAlreadyExistsError);
+
+        // the new secret must not have been stored
+        StoredSecretRequest gsr2;
+        gsr2.setManager(&sm);
+        gsr2.setIdentifier(newSecret.identifier());
+        gsr2.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        gsr2.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr2);
+        QCOMPARE(gsr2.status(), Request::Finished);
+        QCOMPARE(gsr2.result().code(), Result::Failed);
+
+        // a secret may not be given more than once
+        ssr.setSecrets(QVector<Secret>() << newSecret << newSecret);
+        ssr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+        QCOMPARE(ssr.status(), Request::Finished);
+        QCOMPARE(ssr.result().code(), Result::Failed);
+        QCOMPARE(ssr.results().size(), 2);
+        QCOMPARE(ssr.results().at(0).code(), Result::Succeeded);
+        QCOMPARE(ssr.results().at(1).errorCode(), Result::SecretAlreadyExistsError);
+
+        // clean up the collection
+        DeleteCollectionRequest dcr;
+        dcr.setManager(&sm);
+        dcr.setCollectionName(QLatin1String("testcollection"));
+        dcr.setStoragePluginName(storagePluginNames.at(i));
+        dcr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        dcr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dcr);
+        QCOMPARE(dcr.status(), Request::Finished);
+        QCOMPARE(dcr.result().code(), Result::Succeeded);
+    }
+}
+
+void tst_secretsrequests::devicelockDeleteCollectionSecrets()
+{
+    const QStringList storagePluginNames { DEFAULT_TEST_STORAGE_PLUGIN, DEFAULT_TEST_ENCRYPTEDSTORAGE_PLUGIN };
+    const QStringList encryptionPluginNames { DEFAULT_TEST_ENCRYPTION_PLUGIN, DEFAULT_TEST_ENCRYPTEDSTORAGE_PLUGIN };
+    for (int i = 0; i < storagePluginNames.size(); ++i) {
+        // create a collection
+        CreateCollectionRequest ccr;
+        ccr.setManager(&sm);
+        ccr.setCollectionLockType(CreateCollectionRequest::DeviceLock);
+        ccr.setCollectionName(QLatin1String("testcollection"));
+        ccr.setStoragePluginName(storagePluginNames.at(i));
+        ccr.setEncryptionPluginName(encryptionPluginNames.at(i));
+        ccr.setDeviceLockUnlockSemantic(SecretManager::DeviceLockKeepUnlocked);
+        ccr.setAccessControlMode(SecretManager::OwnerOnlyMode);
+        ccr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ccr);
+        QCOMPARE(ccr.status(), Request::Finished);
+        QCOMPARE(ccr.result().code(), Result::Succeeded);
+
+        // store some secrets into the collection
+        QVector<Secret> testSecrets;
+        for (int j = 0; j < 4; ++j) {
+            Secret testSecret(Secret::Identifier(
+                                QStringLiteral("testsecretname%1").arg(j),
+                                QLatin1String("testcollection"),
+                                storagePluginNames.at(i)));
+            testSecret.setData(QStringLiteral("testsecretvalue%1").arg(j).toUtf8());
+            testSecret.setType(Secret::TypeBlob);
+            testSecret.setFilterData(QLatin1String("group"), QString::number(j % 2));
+            testSecret.setFilterData(QLatin1String("test"), QString::number(j));
+            testSecrets.append(testSecret);
+        }
+
+        StoreSecretsRequest ssr;
+        ssr.setManager(&sm);
+        ssr.setSecrets(testSecrets);
+        ssr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        ssr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+        QCOMPARE(ssr.status(), Request::Finished);
+        QCOMPARE(ssr.result().code(), Result::Succeeded);
+
+        // delete the secrets which match either of two values, with OR
+        Secret::FilterData filter;
+        filter.insert(QLatin1String("test"), QLatin1String("0"));
+        filter.insert(QLatin1String("group"), QLatin1String("1"));
+
+        DeleteSecretsRequest dsr;
+        dsr.setManager(&sm);
+        QSignalSpy dsrss(&dsr, &DeleteSecretsRequest::statusChanged);
+        dsr.setCollectionName(QLatin1String("testcollection"));
+        QCOMPARE(dsr.collectionName(), QLatin1String("testcollection"));
+        dsr.setStoragePluginName(storagePluginNames.at(i));
+        QCOMPARE(dsr.storagePluginName(), storagePluginNames.at(i));
+        dsr.setFilter(filter);
+        QCOMPARE(dsr.filter(), filter);
+        dsr.setFilterOperator(SecretManager::OperatorOr);
+        QCOMPARE(dsr.filterOperator(), SecretManager::OperatorOr);
+        dsr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        QCOMPARE(dsr.userInteractionMode(), SecretManager::ApplicationInteraction);
+        QCOMPARE(dsr.status(), Request::Inactive);
+        dsr.startRequest();
+        QCOMPARE(dsrss.count(), 1);
+        QCOMPARE(dsr.status(), Request::Active);
+        QCOMPARE(dsr.result().code(), Result::Pending);
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dsr);
+        QCOMPARE(dsrss.count(), 2);
+        QCOMPARE(dsr.status(), Request::Finished);
+        QCOMPARE(dsr.result().code(), Result::Succeeded);
+        QCOMPARE(dsr.identifiers().size(), 3);
+        QVERIFY(dsr.identifiers().contains(testSecrets.at(0).identifier()));
+        QVERIFY(dsr.identifiers().contains(testSecrets.at(1).identifier()));
+        QVERIFY(dsr.identifiers().contains(testSecrets.at(3).identifier()));
+
+        // ensure that only the matching secrets were deleted
+        StoredSecretRequest gsr;
+        gsr.setManager(&sm);
+        gsr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        for (int j = 0; j < testSecrets.size(); ++j) {
+            gsr.setIdentifier(testSecrets.at(j).identifier());
+            gsr.startRequest();
+            WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+            QCOMPARE(gsr.status(), Request::Finished);
+            if (j == 2) {
+                QCOMPARE(gsr.result().code(), Result::Succeeded);
+                QCOMPARE(gsr.secret().data(), testSecrets.at(j).data());
+            } else {
+                QCOMPARE(gsr.result().code(), Result::Failed);
+            }
+        }
+
+        // deleting with AND requires every value to match, so nothing matches
+        filter.clear();
+        filter.insert(QLatin1String("test"), QLatin1String("2"));
+        filter.insert(QLatin1String("group"), QLatin1String("1"));
+        dsr.setFilter(filter);
+        dsr.setFilterOperator(SecretManager::OperatorAnd);
+        dsr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dsr);
+        QCOMPARE(dsr.status(), Request::Finished);
+        QCOMPARE(dsr.result().code(), Result::Succeeded);
+        QCOMPARE(dsr.identifiers().size(), 0);
+
+        // and with the correct values, the remaining secret is deleted
+        filter.insert(QLatin1String("group"), QLatin1String("0"));
+        dsr.setFilter(filter);
+        dsr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dsr);
+        QCOMPARE(dsr.status(), Request::Finished);
+        QCOMPARE(dsr.result().code(), Result::Succeeded);
+        QCOMPARE(dsr.identifiers().size(), 1);
+        QCOMPARE(dsr.identifiers().at(0), testSecrets.at(2).identifier());
+
+        gsr.setIdentifier(testSecrets.at(2).identifier());
+        gsr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+        QCOMPARE(gsr.status(), Request::Finished);
+        QCOMPARE(gsr.result().code(), Result::Failed);
+
+        // non-ASCII values are matched case-insensitively, as by FindSecretsRequest
+        Secret unicodeSecret(Secret::Identifier(
+                                QLatin1String("unicodesecretname"),
+                                QLatin1String("testcollection"),
+                                storagePluginNames.at(i)));
+        unicodeSecret.setData(QByteArrayLiteral("unicodesecretvalue"));
+        unicodeSecret.setType(Secret::TypeBlob);
+        unicodeSecret.setFilterData(QLatin1String("owner"), QString::fromUtf8("\xc3\x84RGER")); // "ÄRGER"
+        ssr.setSecrets(QVector<Secret>() << unicodeSecret);
+        ssr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+        QCOMPARE(ssr.status(), Request::Finished);
+        QCOMPARE(ssr.result().code(), Result::Succeeded);
+
+        filter.clear();
+        filter.insert(QLatin1String("OWNER"), QString::fromUtf8("\xc3\xa4rger")); // "ärger"
+
+        FindSecretsRequest fsr;
+        fsr.setManager(&sm);
+        fsr.setCollectionName(QLatin1String("testcollection"));
+        fsr.setStoragePluginName(storagePluginNames.at(i));
+        fsr.setFilter(filter);
+        fsr.setFilterOperator(SecretManager::OperatorAnd);
+        fsr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        fsr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(fsr);
+        QCOMPARE(fsr.status(), Request::Finished);
+        QCOMPARE(fsr.result().code(), Result::Succeeded);
+        QCOMPARE(fsr.identifiers().size(), 1);
+        QCOMPARE(fsr.identifiers().at(0), unicodeSecret.identifier());
+
+        dsr.setFilter(filter);
+        dsr.setFilterOperator(SecretManager::OperatorAnd);
+        dsr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dsr);
+        QCOMPARE(dsr.status(), Request::Finished);
+        QCOMPARE(dsr.result().code(), Result::Succeeded);
+        QCOMPARE(dsr.identifiers().size(), 1);
+        QCOMPARE(dsr.identifiers().at(0), unicodeSecret.identifier());
+
+        gsr.setIdentifier(unicodeSecret.identifier());
+        gsr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+        QCOMPARE(gsr.status(), Request::Finished);
+        QCOMPARE(gsr.result().code(), Result::Failed);
+
+        // clean up the collection
+        DeleteCollectionRequest dcr;
+        dcr.setManager(&sm);
+        dcr.setCollectionName(QLatin1String("testcollection"));
+        dcr.setStoragePluginName(storagePluginNames.at(i));
+        dcr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+        dcr.startRequest();
+        WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dcr);
+        QCOMPARE(dcr.status(), Request::Finished);
+        QCOMPARE(dcr.result().code(), Result::Succeeded);
+    }
+}
+
+void tst_secretsrequests::devicelockRequestPipeline()
+{
+    // create a collection, store a secret into it and read it back,
+    // without waiting for the reply to any of the requests.
+    CreateCollectionRequest ccr;
+    ccr.setCollectionLockType(CreateCollectionRequest::DeviceLock);
+    ccr.setCollectionName(QLatin1String("testcollection"));
+    ccr.setStoragePluginName(DEFAULT_TEST_STORAGE_PLUGIN);
+    ccr.setEncryptionPluginName(DEFAULT_TEST_ENCRYPTION_PLUGIN);
+    ccr.setDeviceLockUnlockSemantic(SecretManager::DeviceLockKeepUnlocked);
+    ccr.setAccessControlMode(SecretManager::OwnerOnlyMode);
+
+    Secret testSecret(Secret::Identifier(
+                          QLatin1String("testsecretname"),
+                          QLatin1String("testcollection"),
+                          DEFAULT_TEST_STORAGE_PLUGIN));
+    testSecret.setData("testsecretvalue");
+    testSecret.setType(Secret::TypeBlob);
+    StoreSecretRequest ssr;
+    ssr.setSecretStorageType(StoreSecretRequest::CollectionSecret);
+    ssr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+    ssr.setSecret(testSecret);
+
+    StoredSecretRequest gsr;
+    gsr.setIdentifier(testSecret.identifier());
+    gsr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+
+    RequestPipeline pipeline;
+    pipeline.setManager(&sm);
+    QSignalSpy pss(&pipeline, &RequestPipeline::statusChanged);
+    pipeline.setRequests(QList<Request*>() << &ccr << &ssr << &gsr);
+    QCOMPARE(pipeline.requests().size(), 3);
+    QCOMPARE(pipeline.status(), Request::Inactive);
+    pipeline.startRequest();
+    QCOMPARE(pss.count(), 1);
+    QCOMPARE(pipeline.status(), Request::Active);
+    QCOMPARE(pipeline.result().code(), Result::Pending);
+    QCOMPARE(ccr.status(), Request::Active);
+    QCOMPARE(ssr.status(), Request::Active);
+    QCOMPARE(gsr.status(), Request::Active);
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(pipeline);
+    QCOMPARE(pss.count(), 2);
+    QCOMPARE(pipeline.status(), Request::Finished);
+    QCOMPARE(pipeline.result().code(), Result::Succeeded);
+    QCOMPARE(ccr.result().code(), Result::Succeeded);
+    QCOMPARE(ssr.result().code(), Result::Succeeded);
+    QCOMPARE(gsr.result().code(), Result::Succeeded);
+    QCOMPARE(gsr.secret().data(), testSecret.data());
+
+    // the collection now exists, so creating it fails,
+    // and the requests after it are not performed.
+    DeleteCollectionRequest dcr;
+    dcr.setCollectionName(QLatin1String("testcollection"));
+    dcr.setStoragePluginName(DEFAULT_TEST_STORAGE_PLUGIN);
+    dcr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+    pipeline.setRequests(QList<Request*>() << &ccr << &dcr);
+    pipeline.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(pipeline);
+    QCOMPARE(pipeline.status(), Request::Finished);
+    QCOMPARE(pipeline.result().code(), Result::Failed);
+    QCOMPARE(pipeline.result().errorCode(), Result::CollectionAlreadyExistsError);
+    QCOMPARE(ccr.result().errorCode(), Result::CollectionAlreadyExistsError);
+    QCOMPARE(dcr.status(), Request::Finished);
+    QCOMPARE(dcr.result().errorCode(), Result::SecretsDaemonPipelineAbortedError);
+
+    // the secret was not deleted along with the collection
+    gsr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+    QCOMPARE(gsr.result().code(), Result::Succeeded);
+    QCOMPARE(gsr.secret().data(), testSecret.data());
+
+    // clean up the collection
+    dcr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dcr);
+    QCOMPARE(dcr.status(), Request::Finished);
+    QCOMPARE(dcr.result().code(), Result::Succeeded);
+}
+
+void tst_secretsrequests::devicelockMetadataConsistency()
+{
+    // the metadata of collections and secrets is cached by the daemon,
+    // ensure that it reflects every create and delete operation.
+    CreateCollectionRequest ccr;
+    ccr.setManager(&sm);
+    ccr.setCollectionLockType(CreateCollectionRequest::DeviceLock);
+    ccr.setCollectionName(QLatin1String("testcollection"));
+    ccr.setStoragePluginName(DEFAULT_TEST_STORAGE_PLUGIN);
+    ccr.setEncryptionPluginName(DEFAULT_TEST_ENCRYPTION_PLUGIN);
+    ccr.setDeviceLockUnlockSemantic(SecretManager::DeviceLockKeepUnlocked);
+    ccr.setAccessControlMode(SecretManager::OwnerOnlyMode);
+    ccr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ccr);
+    QCOMPARE(ccr.result().code(), Result::Succeeded);
+
+    // the collection cannot be created again while it exists.
+    ccr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ccr);
+    QCOMPARE(ccr.result().code(), Result::Failed);
+    QCOMPARE(ccr.result().errorCode(), Result::CollectionAlreadyExistsError);
+
+    Secret testSecret(Secret::Identifier(
+                        QLatin1String("testsecretname"),
+                        QLatin1String("testcollection"),
+                        DEFAULT_TEST_STORAGE_PLUGIN));
+    testSecret.setData("testsecretvalue");
+    testSecret.setType(Secret::TypeBlob);
+
+    StoreSecretRequest ssr;
+    ssr.setManager(&sm);
+    ssr.setSecretStorageType(StoreSecretRequest::CollectionSecret);
+    ssr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+    ssr.setSecret(testSecret);
+    ssr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+    QCOMPARE(ssr.result().code(), Result::Succeeded);
+
+    StoredSecretRequest gsr;
+    gsr.setManager(&sm);
+    gsr.setIdentifier(testSecret.identifier());
+    gsr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+    gsr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+    QCOMPARE(gsr.result().code(), Result::Succeeded);
+    QCOMPARE(gsr.secret().data(), testSecret.data());
+
+    // the secret cannot be overwritten while it exists.
+    ssr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+    QCOMPARE(ssr.result().code(), Result::Failed);
+    QCOMPARE(ssr.result().errorCode(), Result::SecretAlreadyExistsError);
+
+    // once deleted, the secret can no longer be read, but can be stored again.
+    DeleteSecretRequest dsr;
+    dsr.setManager(&sm);
+    dsr.setIdentifier(testSecret.identifier());
+    dsr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+    dsr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dsr);
+    QCOMPARE(dsr.result().code(), Result::Succeeded);
+
+    gsr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+    QCOMPARE(gsr.result().code(), Result::Failed);
+
+    testSecret.setData("othersecretvalue");
+    ssr.setSecret(testSecret);
+    ssr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+    QCOMPARE(ssr.result().code(), Result::Succeeded);
+
+    gsr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+    QCOMPARE(gsr.result().code(), Result::Succeeded);
+    QCOMPARE(gsr.secret().data(), testSecret.data());
+
+    // once the collection is deleted, neither it nor its secrets exist.
+    DeleteCollectionRequest dcr;
+    dcr.setManager(&sm);
+    dcr.setCollectionName(QLatin1String("testcollection"));
+    dcr.setStoragePluginName(DEFAULT_TEST_STORAGE_PLUGIN);
+    dcr.setUserInteractionMode(SecretManager::ApplicationInteraction);
+    dcr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dcr);
+    QCOMPARE(dcr.result().code(), Result::Succeeded);
+
+    gsr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+    QCOMPARE(gsr.result().code(), Result::Failed);
+
+    ssr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+    QCOMPARE(ssr.result().code(), Result::Failed);
+    QCOMPARE(ssr.result().errorCode(), Result::InvalidCollectionError);
+
+    // and the collection can be created again, without the deleted secret.
+    ccr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ccr);
+    QCOMPARE(ccr.result().code(), Result::Succeeded);
+
+    gsr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(gsr);
+    QCOMPARE(gsr.result().code(), Result::Failed);
+
+    ssr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(ssr);
+    QCOMPARE(ssr.result().code(), Result::Succeeded);
+
+    dcr.startRequest();
+    WAIT_FOR_FINISHED_WITHOUT_BLOCKING(dcr);
+    QCOMPARE(dcr.result().code(), Result::Succeeded);
+}
+
 void tst_secretsrequests::devicelockStandaloneSecret()
 {
     // write the secret
@@ -1660,11 +2277,14 @@ void tst_secretsrequests::lockCode()
     QCOMPARE(gsr.secret().data(), testSecret.data());
 
     // Tell the service to forget the lock code.
+    // Clients are told that the plugin info may have changed.
+    QSignalSpy pics(&sm, &SecretManager::pluginInfoChanged);
     lcr.setLockCodeRequestType(LockCodeRequest::ForgetLockCode);
     lcr.startRequest();
     WAIT_FOR_FINISHED_WITHOUT_BLOCKING(lcr);
     QCOMPARE(lcr.status(), Request::Finished);
     QCOMPARE(lcr.result().code(), Result::Succeeded);
+    QTRY_VERIFY(pics.count() > 0);
 
     lcr.setLockCodeRequestType(LockCodeRequest::QueryLockStatus);
     lcr.startRequest();
@@ -17,6 +17,7 @@
 #include <Secrets/deletesecretrequest.h>
 #include <Secrets/interactionrequest.h>
 #include <Secrets/healthcheckrequest.h>
+#include <Secrets/statisticsrequest.h>
 
 #include <Crypto/interactionparameters.h>
 #include <Crypto/keypairgenerationparameters.h>
@@ -31,6 +32,7 @@
 #include <Crypto/encryptrequest.h>
 #include <Crypto/decryptrequest.h>
 #include <Crypto/generateinitializationvectorrequest.h>
+#include <Crypto/statisticsrequest.h>
 
 #include <QtCore/QFile>
 #include <QtCore/QByteArray>
@@ -71,6 +73,50 @@ static Sailfish::Crypto::CryptoManager::DigestFunction digestEnum(const QString
     return Sailfish::Crypto::CryptoManager::DigestSha512;
 }
 
+static void printLatencies(const QString &name, const QVariantMap &latencies)
+{
+    qInfo().noquote() << QStringLiteral("    %1 count: %2, mean: %3, p50: %4, p90: %5, p99: %6, p999: %7, max: %8 (usec)")
+                         .arg(name, -12)
+                         .arg(latencies.value(QStringLiteral("count")).toLongLong())
+                         .arg(latencies.value(QStringLiteral("mean")).toLongLong())
+                         .arg(latencies.value(QStringLiteral("p50")).toLongLong())
+                         .arg(latencies.value(QStringLiteral("p90")).toLongLong())
+                         .arg(latencies.value(QStringLiteral("p99")).toLongLong())
+                         .arg(latencies.value(QStringLiteral("p999")).toLongLong())
+                         .arg(latencies.value(QStringLiteral("max")).toLongLong());
+}
+
+static void printStatistics(const QString &api, const QVariantMap &statistics)
+{
+    const QStringList stages { QStringLiteral("queued"), QStringLiteral("processing"),
+                               QStringLiteral("executing"), QStringLiteral("total") };
+    qInfo().noquote() << api << "request latencies:";
+    const QVariantMap requests = statistics.value(QStringLiteral("requests")).toMap();
+    for (QVariantMap::const_iterator it = requests.constBegin(); it != requests.constEnd(); ++it) {
+        qInfo().noquote() << "  " << it.key();
+        const QVariantMap requestStages = it.value().toMap();
+        for (const QString &stage : stages) {
+            printLatencies(stage, requestStages.value(stage).toMap());
+        }
+    }
+
+    qInfo().noquote() << api << "plugin latencies:";
+    const QVariantMap plugins = statistics.value(QStringLiteral("plugins")).toMap();
+    for (QVariantMap::const_iterator it = plugins.constBegin(); it != plugins.constEnd(); ++it) {
+        qInfo().noquote() << "  " << it.key();
+        printLatencies(QStringLiteral("total"), it.value().toMap());
+    }
+
+    qInfo().noquote() << api << "pending requests:";
+    const QVariantMap queues = statistics.value(QStringLiteral("queues")).toMap();
+    const QStringList priorities { QStringLiteral("interactive"), QStringLiteral("normal"), QStringLiteral("bulk") };
+    for (const QString &priority : priorities) {
+        qInfo().noquote() << QStringLiteral("    %1 %2")
+                             .arg(priority, -12)
+                             .arg(queues.value(priority).toInt());
+    }
+}
+
 static QVariantMap toCustomParameters(const QStringList &options)
 {
     QVariantMap customs;
@@ -861,6 +907,14 @@ void CommandHelper::start(const QString &command, const QStringList &args, const
         connect(m_secretsRequest.data(), &Sailfish::Secrets::Request::statusChanged,
                 this, &CommandHelper::secretsRequestStatusChanged);
         m_secretsRequest->startRequest();
+    } else if (command == QStringLiteral("--stats")) {
+        // the Secrets statistics are retrieved first, then the Crypto statistics.
+        Sailfish::Secrets::StatisticsRequest *r = new Sailfish::Secrets::StatisticsRequest;
+        m_secretsRequest.reset(r);
+        m_secretsRequest->setManager(&m_secretManager);
+        connect(m_secretsRequest.data(), &Sailfish::Secrets::Request::statusChanged,
+                this, &CommandHelper::secretsRequestStatusChanged);
+        m_secretsRequest->startRequest();
     } else {
         qInfo() << "Unknown command:" << command;
         emitFinished(EXITCODE_FAILED);
@@ -899,6 +953,15 @@ void CommandHelper::secretsRequestStatusChanged()
         Sailfish::Secrets::HealthCheckRequest *r = qobject_cast<Sailfish::Secrets::HealthCheckRequest*>(m_secretsRequest.data());
         qInfo() << "Salt data health:" << r->saltDataHealth();
         qInfo() << "Masterlock health:" << r->masterlockHealth();
+    } else if (m_command == QStringLiteral("--stats")) {
+        Sailfish::Secrets::StatisticsRequest *r = qobject_cast<Sailfish::Secrets::StatisticsRequest*>(m_secretsRequest.data());
+        printStatistics(QStringLiteral("Secrets"), r->statistics());
+        m_cryptoRequest.reset(new Sailfish::Crypto::StatisticsRequest);
+        m_cryptoRequest->setManager(&m_cryptoManager);
+        connect(m_cryptoRequest.data(), &Sailfish::Crypto::Request::statusChanged,
+                this, &CommandHelper::cryptoRequestStatusChanged);
+        m_cryptoRequest->startRequest();
+        return;
     }
 
     emitFinished(EXITCODE_SUCCESS);
@@ -954,6 +1017,9 @@ void CommandHelper::cryptoRequestStatusChanged()
         QFile stdoutFile;
         stdoutFile.open(stdout, QIODevice::WriteOnly, QFile::AutoCloseHandle);
         stdoutFile.write(r->plaintext());
+    } else if (m_command == QStringLiteral("--stats")) {
+        Sailfish::Crypto::StatisticsRequest *r = qobject_cast<Sailfish::Crypto::StatisticsRequest*>(m_cryptoRequest.data());
+        printStatistics(QStringLiteral("Crypto"), r->statistics());
     }
 
     emitFinished(EXITCODE_SUCCESS);
@@ -74,6 +74,7 @@ Q_DECL_EXPORT int main(int argc, char *argv[])
         {"--decrypt", "Decrypt a particular file with the specified key, output to stdout" },
         {"--get-user-input", "Request user input via system dialog" },
         {"--health-check", "Check the health of secrets daemon data" },
+        {"--stats", "Print the request latency statistics and queue depths of the secrets daemon" },
     };
 
     const QMap<QString, QString> paramOptions {
@@ -98,6 +99,7 @@ Q_DECL_EXPORT int main(int argc, char *argv[])
         {"--decrypt", "<cryptoPlugin> <storagePlugin> <collectionName> <keyName> <fileName>" },
         {"--get-user-input", "" },
         {"--health-check", "" },
+        {"--stats", "" },
     };
 
     const QMap<QString, int> paramOptionsMin {
@@ -125,6 +127,7 @@ Q_DECL_EXPORT int main(int argc, char *argv[])
         {"--decrypt", 5 },
         {"--get-user-input", 0 },
         {"--health-check", 0 },
+        {"--stats", 0 },
     };
 
     const QMap<QString, int> paramOptionsMax {
@@ -152,6 +155,7 @@ Q_DECL_EXPORT int main(int argc, char *argv[])
         {"--decrypt", 5 },
         {"--get-user-input", 0 },
         {"--health-check", 0 },
+        {"--stats", 0 },
     };
 
     const QMap<QString, QString> paramExamples {
@@ -179,6 +183,7 @@ Q_DECL_EXPORT int main(int argc, char *argv[])
         {"--decrypt", "org.sailfishos.secrets.plugin.encryptedstorage.sqlcipher org.sailfishos.secrets.plugin.encryptedstorage.sqlcipher MyCollection MyAesKey document.txt.enc > document.txt.dec" },
         {"--get-user-input", "" },
         {"--health-check", "" },
+        {"--stats", "" },
     };
 
     bool autotestMode = false;